@@ -663,7 +663,8 @@ td::actor::ActorOwn<CatChainReceiverInterface> CatChainReceiverInterface::create
     const std::vector<CatChainNode> &ids, const PublicKeyHash &local_id, const CatChainSessionId &unique_hash,
     std::string db_root, std::string db_suffix, bool allow_unsafe_self_blocks_resync) {
   auto A = td::actor::create_actor<CatChainReceiverImpl>(
-      "catchainreceiver", std::move(callback), opts, std::move(keyring), std::move(adnl), std::move(overlay_manager),
+      td::actor::ActorOptions().with_name("catchainreceiver").with_priority(td::actor::ActorPriority::Realtime),
+      std::move(callback), opts, std::move(keyring), std::move(adnl), std::move(overlay_manager),
       ids, local_id, unique_hash, std::move(db_root), std::move(db_suffix), allow_unsafe_self_blocks_resync);
   return std::move(A);
 }
@@ -32,6 +32,7 @@
 #include "common/bitstring.h"
 #include "vm/dict.h"
 #include "td/utils/bits.h"
+#include "td/utils/ScopeGuard.h"
 #include "td/utils/uint128.h"
 #include "ton/ton-types.h"
 #include "ton/ton-shard.h"
@@ -180,6 +181,9 @@ td::Status ConfigInfo::unpack() {
   if ((mode & needShardHashes) && !ShardConfig::unpack(extra_info.shard_hashes)) {
     return td::Status::Error("cannot unpack Shard configuration");
   }
+  if ((mode & needShardHashes) && (mode & needShardTable) && !build_shard_table()) {
+    LOG(WARNING) << "cannot build flattened shard table, falling back to shard configuration dictionary lookups";
+  }
   is_key_state_ = extra_info.r1.after_key_block;
   if (extra_info.r1.last_key_block->size() > 1) {
     auto& cs = extra_info.r1.last_key_block.write();
@@ -1076,6 +1080,75 @@ void ConfigInfo::reset_mc_hash() {
   }
 }
 
+std::shared_ptr<const ShardTable> ShardTable::build(Ref<vm::Cell> shard_hashes) {
+  auto table = std::make_shared<ShardTable>();
+  table->root = shard_hashes;
+  try {
+    vm::Dictionary dict{std::move(shard_hashes), 32};
+    bool ok = dict.check_for_each(
+        [&table](Ref<vm::CellSlice> cs_ref, td::ConstBitPtr key, int n) -> bool {
+          ton::WorkchainId workchain = (int)key.get_int(n);
+          table->workchains.push_back(workchain);
+          return cs_ref->size_ext() == 0x10000 && table->add_nodes(cs_ref->prefetch_ref(), ton::ShardIdFull{workchain});
+        },
+        true);
+    if (!ok) {
+      return nullptr;
+    }
+  } catch (vm::VmError&) {
+    return nullptr;
+  } catch (vm::VmVirtError&) {
+    return nullptr;
+  }
+  return table;
+}
+
+bool ShardTable::add_nodes(Ref<vm::Cell> branch, ton::ShardIdFull shard) {
+  vm::CellSlice cs{vm::NoVmOrd(), std::move(branch)};
+  int t = (int)cs.fetch_ulong(1);
+  std::size_t idx = nodes.size();
+  nodes.push_back(Node{shard, 0, {}});
+  if (!t) {
+    auto descr = McShardHash::unpack(cs, shard);
+    if (descr.is_null()) {
+      return false;
+    }
+    leaves.push_back(descr);
+    nodes[idx].descr = std::move(descr);
+  } else if (t == 1) {
+    if ((shard.shard & 1) || cs.size_ext() != 0x20000 ||
+        !add_nodes(cs.prefetch_ref(0), ton::shard_child(shard, true)) ||
+        !add_nodes(cs.prefetch_ref(1), ton::shard_child(shard, false))) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  nodes[idx].next = (unsigned)nodes.size();
+  return true;
+}
+
+Ref<McShardHash> ShardTable::lookup(ton::ShardIdFull id, bool exact) const {
+  if (id.is_masterchain() || !id.is_valid()) {
+    return {};
+  }
+  // leaves do not intersect, so the leaf containing id.shard is the first one ending at or after it
+  auto it = std::lower_bound(leaves.begin(), leaves.end(), id,
+                             [](const Ref<McShardHash>& leaf, const ton::ShardIdFull& x) {
+                               auto shard = leaf->shard();
+                               return shard.workchain < x.workchain ||
+                                      (shard.workchain == x.workchain && (shard.shard | (shard.shard - 1)) < x.shard);
+                             });
+  if (it == leaves.end() || !ton::shard_contains((*it)->shard(), id)) {
+    return {};
+  }
+  auto shard = (*it)->shard();
+  if (exact ? shard != id : !ton::shard_is_ancestor(shard, id)) {
+    return {};
+  }
+  return *it;
+}
+
 Ref<vm::CellSlice> ShardConfig::get_root_csr() const {
   if (!shard_hashes_dict_) {
     return {};
@@ -1097,6 +1170,7 @@ bool ShardConfig::unpack(Ref<vm::CellSlice> shard_hashes, Ref<McShardHash> mc_sh
 
 bool ShardConfig::init() {
   shard_hashes_dict_ = std::make_unique<vm::Dictionary>(shard_hashes_, 32);
+  shard_table_.reset();
   valid_ = true;
   return true;
 }
@@ -1104,6 +1178,28 @@ bool ShardConfig::init() {
 ShardConfig::ShardConfig(const ShardConfig& other)
     : shard_hashes_(other.shard_hashes_), mc_shard_hash_(other.mc_shard_hash_) {
   init();
+  if (other.shard_table_) {
+    // the copy starts from the original shard_hashes_, so the table of an updated ShardConfig cannot be shared
+    if (other.shard_table_->root.get() == shard_hashes_.get()) {
+      shard_table_ = other.shard_table_;
+    } else {
+      build_shard_table();
+    }
+  }
+}
+
+bool ShardConfig::build_shard_table() {
+  if (!shard_hashes_dict_) {
+    return false;
+  }
+  shard_table_ = ShardTable::build(shard_hashes_dict_->get_root_cell());
+  return shard_table_ != nullptr;
+}
+
+void ShardConfig::update_shard_table() {
+  if (shard_table_) {
+    build_shard_table();
+  }
 }
 
 bool ShardConfig::get_shard_hash_raw_from(vm::Dictionary& dict, vm::CellSlice& cs, ton::ShardIdFull id,
@@ -1151,6 +1247,9 @@ Ref<McShardHash> ShardConfig::get_shard_hash(ton::ShardIdFull id, bool exact) co
   if (id.is_masterchain()) {
     return (!exact || id.shard == ton::shardIdAll) ? get_mc_hash() : Ref<McShardHash>{};
   }
+  if (shard_table_) {
+    return shard_table_->lookup(id, exact);
+  }
   ton::ShardIdFull true_id;
   vm::CellSlice cs;
   if (get_shard_hash_raw(cs, id, true_id, exact)) {
@@ -1183,6 +1282,21 @@ ton::CatchainSeqno ShardConfig::get_shard_cc_seqno(ton::ShardIdFull shard) const
   if (shard.is_masterchain() || !shard.is_valid()) {
     return std::numeric_limits<ton::CatchainSeqno>::max();
   }
+  if (shard_table_) {
+    auto left = shard_table_->lookup(shard - 1, false);
+    if (left.is_null() ||
+        !(ton::shard_is_ancestor(left->shard(), shard) || ton::shard_is_parent(shard, left->shard()))) {
+      return std::numeric_limits<ton::CatchainSeqno>::max();
+    }
+    if (ton::shard_is_ancestor(left->shard(), shard)) {
+      return left->next_catchain_seqno_;
+    }
+    auto right = shard_table_->lookup(shard + 1, false);
+    if (right.is_null() || !ton::shard_is_parent(shard, right->shard())) {
+      return std::numeric_limits<ton::CatchainSeqno>::max();
+    }
+    return std::max(left->next_catchain_seqno_, right->next_catchain_seqno_) + 1;
+  }
   ton::ShardIdFull true_id;
   ton::CatchainSeqno cc_seqno, cc_seqno2;
   vm::CellSlice cs;
@@ -1211,6 +1325,14 @@ ton::LogicalTime ShardConfig::get_shard_end_lt_ext(ton::AccountIdPrefixFull acc,
     CHECK(mc_shard_hash_.not_null());
     return mc_shard_hash_->end_lt_;
   }
+  if (shard_table_) {
+    auto descr = shard_table_->lookup(acc.as_leaf_shard(), false);
+    if (descr.is_null()) {
+      return 0;
+    }
+    actual_shard = descr->shard();
+    return descr->end_lt_;
+  }
   vm::CellSlice cs;
   unsigned long long end_lt;
   return get_shard_hash_raw(cs, acc.as_leaf_shard(), actual_shard, false)  // lookup ShardDescr containing acc
@@ -1281,6 +1403,7 @@ bool ShardConfig::process_shard_hashes(std::function<int(McShardHash&)> func) {
              cb.store_ref_bool(std::move(root));
         return true;
       });
+  update_shard_table();
   return ok;
 }
 
@@ -1348,6 +1471,7 @@ bool ShardConfig::process_sibling_shard_hashes(std::function<int(McShardHash&, c
     ok &= f;
     return f;
   });
+  update_shard_table();
   return ok;
 }
 
@@ -1358,6 +1482,31 @@ std::vector<ton::BlockId> ShardConfig::get_shard_hash_ids(
   }
   std::vector<ton::BlockId> res;
   bool mcout = mc_shard_hash_.is_null() || !mc_shard_hash_->seqno();  // include masterchain as a shard if seqno > 0
+  if (shard_table_) {
+    // same traversal as below: subtrees rejected by filter are skipped
+    const auto& nodes = shard_table_->nodes;
+    for (std::size_t i = 0; i < nodes.size();) {
+      const auto& node = nodes[i];
+      if (node.shard.workchain >= 0 && !mcout) {
+        if (filter(ton::ShardIdFull{ton::masterchainId}, true)) {
+          res.emplace_back(mc_shard_hash_->blk_.id);
+        }
+        mcout = true;
+      }
+      if (!filter(node.shard, node.descr.not_null())) {
+        i = node.next;
+        continue;
+      }
+      if (node.descr.not_null()) {
+        res.emplace_back(node.descr->blk_.id);
+      }
+      ++i;
+    }
+    if (!mcout && filter(ton::ShardIdFull{ton::masterchainId}, true)) {
+      res.emplace_back(mc_shard_hash_->blk_.id);
+    }
+    return res;
+  }
   bool ok = shard_hashes_dict_->check_for_each(
       [&res, &mcout, mc_shard_hash_ = mc_shard_hash_, &filter](Ref<vm::CellSlice> cs_ref, td::ConstBitPtr key,
                                                                int n) -> bool {
@@ -1449,10 +1598,19 @@ bool ShardConfig::is_neighbor(ton::ShardIdFull x, ton::ShardIdFull y) {
 }
 
 bool ShardConfig::has_workchain(ton::WorkchainId workchain) const {
+  if (shard_table_) {
+    return shard_table_->has_workchain(workchain);
+  }
   return shard_hashes_dict_ && shard_hashes_dict_->key_exists(td::BitArray<32>{workchain});
 }
 
 std::vector<ton::WorkchainId> ShardConfig::get_workchains() const {
+  if (shard_table_) {
+    // keep the order of the dictionary, where keys are compared as unsigned
+    std::vector<ton::WorkchainId> res = shard_table_->workchains;
+    std::rotate(res.begin(), std::lower_bound(res.begin(), res.end(), 0), res.end());
+    return res;
+  }
   if (!shard_hashes_dict_) {
     return {};
   }
@@ -1473,6 +1631,9 @@ bool ShardConfig::new_workchain(ton::WorkchainId workchain, ton::BlockSeqno reg_
   if (!shard_hashes_dict_ || has_workchain(workchain)) {
     return false;
   }
+  SCOPE_EXIT {
+    update_shard_table();
+  };
   vm::CellBuilder cb;
   Ref<vm::Cell> cell;
   return cb.store_long_bool(11, 1 + 4)               // bt_leaf$0 ; shard_descr#b
@@ -1744,6 +1905,7 @@ bool ShardConfig::set_shard_info(ton::ShardIdFull shard, Ref<vm::Cell> value) {
   }
   auto ins = shards_updated_.insert(shard);
   CHECK(ins.second);
+  update_shard_table();
   return true;
 }
 
@@ -26,6 +26,8 @@
 #include "block.h"
 
 #include <vector>
+#include <algorithm>
+#include <memory>
 #include <limits>
 #include <map>
 #include <set>
@@ -453,10 +455,35 @@ struct WorkchainInfo : public td::CntObject {
 
 using WorkchainSet = std::map<td::int32, Ref<WorkchainInfo>>;
 
+// Immutable flattened copy of (ShardHashes), so that shard lookups need no cell access
+struct ShardTable {
+  struct Node {
+    ton::ShardIdFull shard;
+    unsigned next;           // index of the first node after the subtree of this one
+    Ref<McShardHash> descr;  // null for bt_fork$1 nodes
+  };
+  Ref<vm::Cell> root;                        // (ShardHashes) the table was built from
+  std::vector<Node> nodes;                   // all BinTree nodes in pre-order, workchains in ascending order
+  std::vector<Ref<McShardHash>> leaves;      // sorted by (workchain, shard)
+  std::vector<ton::WorkchainId> workchains;  // in ascending order
+
+  // returns nullptr if the shard configuration is invalid or incomplete (e.g. contains pruned branches)
+  static std::shared_ptr<const ShardTable> build(Ref<vm::Cell> shard_hashes);
+  // same semantics as ShardConfig::get_shard_hash_raw_from()
+  Ref<McShardHash> lookup(ton::ShardIdFull id, bool exact = true) const;
+  bool has_workchain(ton::WorkchainId workchain) const {
+    return std::binary_search(workchains.begin(), workchains.end(), workchain);
+  }
+
+ private:
+  bool add_nodes(Ref<vm::Cell> branch, ton::ShardIdFull shard);
+};
+
 class ShardConfig {
   Ref<vm::Cell> shard_hashes_;
   Ref<McShardHash> mc_shard_hash_;
   std::unique_ptr<vm::Dictionary> shard_hashes_dict_;
+  std::shared_ptr<const ShardTable> shard_table_;
   std::set<ton::ShardIdFull> shards_updated_;
   bool valid_{false};
 
@@ -494,6 +521,12 @@ class ShardConfig {
   bool process_sibling_shard_hashes(std::function<int(McShardHash&, const McShardHash*)> func);
   // may become non-static const in the future
   static bool is_neighbor(ton::ShardIdFull x, ton::ShardIdFull y);
+  // builds a flattened copy of the shard configuration used by lookups instead of the dictionary;
+  // the table is shared by copies of this ShardConfig and rebuilt after updates
+  bool build_shard_table();
+  bool has_shard_table() const {
+    return shard_table_ != nullptr;
+  }
   Ref<McShardHash> get_mc_hash() const {
     return mc_shard_hash_;
   }
@@ -519,6 +552,7 @@ class ShardConfig {
   bool do_update_shard_info(Ref<McShardHash> new_info);
   bool do_update_shard_info2(Ref<McShardHash> new_info1, Ref<McShardHash> new_info2);
   bool set_shard_info(ton::ShardIdFull shard, Ref<vm::Cell> value);
+  void update_shard_table();
 };
 
 struct BurningConfig {
@@ -705,6 +739,7 @@ class ConfigInfo : public Config, public ShardConfig {
   static constexpr int needShardHashes = 8;
   static constexpr int needAccountsRoot = 64;
   static constexpr int needPrevBlocks = 128;
+  static constexpr int needShardTable = 1024;
   ton::BlockSeqno vert_seqno{~0U};
   int global_id_{0};
   ton::UnixTime utime{0};
@@ -15,13 +15,39 @@
     along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "common.h"
+#include "Wallets.h"
 #include <memory>
 #include "vm/memo.h"
+#include "Ed25519.h"
 
 namespace block::precompiled {
 
 using namespace vm;
 
+namespace {
+
+// Charges cell loads and creations the same way as VmState
+class GasCountingVmState : public DummyVmState {
+ public:
+  GasCountingVmState(std::vector<Ref<Cell>> libraries, int global_version, GasLimits &gas,
+                     td::HashSet<CellHash> &loaded_cells)
+      : DummyVmState(std::move(libraries), global_version), gas_(gas), loaded_cells_(loaded_cells) {
+  }
+  void register_cell_load(const CellHash &cell_hash) override {
+    gas_.consume(loaded_cells_.insert(cell_hash).second ? VmState::cell_load_gas_price
+                                                        : VmState::cell_reload_gas_price);
+  }
+  void register_cell_create() override {
+    gas_.consume(VmState::cell_create_gas_price);
+  }
+
+ private:
+  GasLimits &gas_;
+  td::HashSet<CellHash> &loaded_cells_;
+};
+
+}  // namespace
+
 Result PrecompiledSmartContract::run(td::Ref<vm::CellSlice> my_address, ton::UnixTime now, ton::LogicalTime cur_lt,
                                      CurrencyCollection balance, td::Ref<vm::Cell> c4, vm::CellSlice msg_body,
                                      td::Ref<vm::Cell> msg, CurrencyCollection msg_balance, bool is_external,
@@ -29,6 +55,10 @@ Result PrecompiledSmartContract::run(td::Ref<vm::CellSlice> my_address, ton::Uni
                                      td::uint16 max_data_depth, td::Ref<vm::Cell> my_code,
                                      td::Ref<vm::Tuple> unpacked_config, td::RefInt256 due_payment,
                                      td::uint64 precompiled_gas_usage) {
+  if (c4.is_null() && is_gas_equivalent()) {
+    // TVM fails to commit null data
+    return Result::run_vm();
+  }
   my_address_ = std::move(my_address);
   now_ = now;
   cur_lt_ = cur_lt;
@@ -43,17 +73,38 @@ Result PrecompiledSmartContract::run(td::Ref<vm::CellSlice> my_address, ton::Uni
   due_payment_ = std::move(due_payment);
   precompiled_gas_usage_ = precompiled_gas_usage;
 
-  vm::DummyVmState vm_state{std::move(libraries), global_version};
+  GasCountingVmState vm_state{std::move(libraries), global_version, gas_, loaded_cells_};
   vm::VmStateInterface::Guard guard{&vm_state};
 
   Result result;
   try {
     result = do_run();
   } catch (vm::VmError &e) {
-    result = Result::error(e.get_errno(), e.get_arg());
+    // the gas consumed by TVM up to an exception is not known here
+    result = is_gas_equivalent() ? Result::run_vm() : Result::error(e.get_errno(), e.get_arg());
+  } catch (vm::CellBuilder::CellWriteError) {
+    result = is_gas_equivalent() ? Result::run_vm() : Result::error(Excno::cell_ov);
+  } catch (vm::CellSlice::CellReadError) {
+    result = is_gas_equivalent() ? Result::run_vm() : Result::error(Excno::cell_und);
   } catch (Result &r) {
     result = std::move(r);
   }
+  if (result.fallback) {
+    return result;
+  }
+  if (gas_.gas_remaining < 0) {
+    // TVM would run out of gas
+    return Result::run_vm();
+  }
+  if (is_gas_equivalent()) {
+    // see Transaction::prepare_compute_phase()
+    result.accepted = (gas_.gas_credit == 0);
+    if (result.exit_code == 0 && (c4_->get_depth() > max_data_depth || c5_->get_depth() > max_data_depth)) {
+      // TVM fails to commit, the gas of the implicit exception is not accounted here
+      return Result::run_vm();
+    }
+    return result;
+  }
 
   if (result.exit_code != 0 && result.exit_code != 1) {
     // see VmState::try_commit()
@@ -65,6 +116,19 @@ Result PrecompiledSmartContract::run(td::Ref<vm::CellSlice> my_address, ton::Uni
   return result;
 }
 
+void PrecompiledSmartContract::accept_message() {
+  if (gas_.gas_remaining < 0) {
+    throw Result::run_vm();
+  }
+  gas_.change_limit(GasLimits::infty);
+}
+
+bool PrecompiledSmartContract::check_signature(td::Slice data, td::Slice signature,
+                                               const td::Bits256 &public_key) const {
+  td::Ed25519::PublicKey pub_key{td::SecureString(public_key.as_slice())};
+  return pub_key.verify_signature(data, signature).is_ok() || chksig_always_succeed_;
+}
+
 void PrecompiledSmartContract::send_raw_message(const td::Ref<Cell> &msg, int mode) {
   CellBuilder cb;
   if (!(cb.store_ref_bool(c5_)                 // out_list$_ {n:#} prev:^(OutList n)
@@ -73,7 +137,7 @@ void PrecompiledSmartContract::send_raw_message(const td::Ref<Cell> &msg, int mo
         && cb.store_ref_bool(msg))) {
     throw VmError{Excno::cell_ov, "cannot serialize raw output message into an output action cell"};
   }
-  c5_ = cb.finalize_novm();
+  c5_ = cb.finalize();
 }
 
 void PrecompiledSmartContract::raw_reserve(const td::RefInt256 &amount, int mode) {
@@ -88,7 +152,7 @@ void PrecompiledSmartContract::raw_reserve(const td::RefInt256 &amount, int mode
         && cb.store_maybe_ref({}))) {
     throw VmError{Excno::cell_ov, "cannot serialize raw reserved currency amount into an output action cell"};
   }
-  c5_ = cb.finalize_novm();
+  c5_ = cb.finalize();
 }
 
 td::RefInt256 PrecompiledSmartContract::get_compute_fee(ton::WorkchainId wc, td::uint64 gas_used) {
@@ -143,10 +207,7 @@ td::RefInt256 PrecompiledSmartContract::get_original_fwd_fee(ton::WorkchainId wc
 
 static std::atomic_bool precompiled_execution_enabled{false};
 
-std::unique_ptr<PrecompiledSmartContract> get_implementation(td::Bits256 code_hash) {
-  if (!precompiled_execution_enabled) {
-    return nullptr;
-  }
+static std::unique_ptr<PrecompiledSmartContract> create_implementation(const td::Bits256 &code_hash) {
   static std::map<td::Bits256, std::unique_ptr<PrecompiledSmartContract> (*)()> map = []() {
     auto from_hex = [](td::Slice s) -> td::Bits256 {
       td::Bits256 x;
@@ -157,12 +218,31 @@ std::unique_ptr<PrecompiledSmartContract> get_implementation(td::Bits256 code_ha
 #define CONTRACT(hash, cls) \
   map[from_hex(hash)] = []() -> std::unique_ptr<PrecompiledSmartContract> { return std::make_unique<cls>(); };
     // CONTRACT("CODE_HASH_HEX", ClassName);
+    CONTRACT("84DAFA449F98A6987789BA232358072BC0F76DC4524002A5D0918B9A75D2D599", WalletV3R2);
+    CONTRACT("FEB5FF6820E2FF0D9483E7E0D62C817D846789FB4AE580C878866D959DABD5C0", WalletV4R2);
+    CONTRACT("0B3A887AEACD2A7D40BB5550BC9253156A029065AEFB6D6B583735D58DA9D5BE", HighloadWalletV2R2);
+#undef CONTRACT
     return map;
   }();
   auto it = map.find(code_hash);
   return it == map.end() ? nullptr : it->second();
 }
 
+std::unique_ptr<PrecompiledSmartContract> get_implementation(td::Bits256 code_hash) {
+  if (!precompiled_execution_enabled) {
+    return nullptr;
+  }
+  return create_implementation(code_hash);
+}
+
+std::unique_ptr<PrecompiledSmartContract> get_native_implementation(td::Bits256 code_hash) {
+  auto impl = create_implementation(code_hash);
+  if (impl == nullptr || !impl->is_gas_equivalent()) {
+    return nullptr;
+  }
+  return impl;
+}
+
 void set_precompiled_execution_enabled(bool value) {
   precompiled_execution_enabled = value;
 }
@@ -21,6 +21,7 @@
 #include "vm/cellslice.h"
 #include "vm/dict.h"
 #include "vm/boc.h"
+#include "vm/vm.h"
 #include <ostream>
 #include "tl/tlblib.hpp"
 #include "td/utils/bits.h"
@@ -35,6 +36,7 @@ struct Result {
   td::optional<long long> exit_arg;
   bool accepted = true;
   bool committed = false;
+  bool fallback = false;  // the implementation does not reproduce TVM for this input, the contract must be run in TVM
 
   static Result error(int code, long long arg = 0) {
     Result res;
@@ -62,6 +64,12 @@ struct Result {
     res.committed = true;
     return res;
   }
+
+  static Result run_vm() {
+    Result res;
+    res.fallback = true;
+    return res;
+  }
 };
 
 class PrecompiledSmartContract {
@@ -74,6 +82,14 @@ class PrecompiledSmartContract {
     return 6;
   }
 
+  // Gas-equivalent implementations consume exactly as much gas and as many steps as TVM running the original code,
+  // producing the same exit code, data and actions. They may replace TVM even for contracts that are not marked
+  // as precompiled in the config (see ComputePhaseConfig::run_native_contracts).
+  // Inputs which are not handled exactly (e.g. malformed messages) return Result::run_vm().
+  virtual bool is_gas_equivalent() const {
+    return false;
+  }
+
   Result run(td::Ref<vm::CellSlice> my_address, ton::UnixTime now, ton::LogicalTime cur_lt, CurrencyCollection balance,
              td::Ref<vm::Cell> c4, vm::CellSlice msg_body, td::Ref<vm::Cell> msg, CurrencyCollection msg_balance,
              bool is_external, std::vector<td::Ref<vm::Cell>> libraries, int global_version, td::uint16 max_data_depth,
@@ -86,6 +102,23 @@ class PrecompiledSmartContract {
     return c5_;
   }
 
+  // gas limits, chksig flag and counters below are used by gas-equivalent implementations only
+  void set_gas_limits(const vm::GasLimits& gas) {
+    gas_ = gas;
+  }
+  void set_chksig_always_succeed(bool flag) {
+    chksig_always_succeed_ = flag;
+  }
+  const vm::GasLimits& get_gas_limits() const {
+    return gas_;
+  }
+  long long get_steps_count() const {
+    return steps_;
+  }
+  td::HashSet<vm::CellHash> extract_loaded_cells() {
+    return std::move(loaded_cells_);
+  }
+
  protected:
   td::Ref<vm::CellSlice> my_address_;
   ton::UnixTime now_;
@@ -103,6 +136,21 @@ class PrecompiledSmartContract {
   td::Ref<vm::Cell> c4_;
   td::Ref<vm::Cell> c5_ = vm::CellBuilder().finalize_novm();
 
+  vm::GasLimits gas_;
+  long long steps_ = 0;
+  bool chksig_always_succeed_ = false;
+  td::HashSet<vm::CellHash> loaded_cells_;
+
+  // Accounts for `steps` TVM steps of the original code costing `gas` in total, not including cell loads and
+  // creations: these are charged as they happen, like in VmState
+  void charge(int steps, long long gas) {
+    steps_ += steps;
+    gas_.consume(gas);
+  }
+  // ACCEPT, the gas of the instruction itself is charged separately
+  void accept_message();
+  bool check_signature(td::Slice data, td::Slice signature, const td::Bits256& public_key) const;
+
   void send_raw_message(const td::Ref<vm::Cell>& msg, int mode);
   void raw_reserve(const td::RefInt256& amount, int mode);
 
@@ -119,4 +167,7 @@ class PrecompiledSmartContract {
 std::unique_ptr<PrecompiledSmartContract> get_implementation(td::Bits256 code_hash);
 void set_precompiled_execution_enabled(bool value);  // disabled by default
 
+// returns a gas-equivalent implementation regardless of set_precompiled_execution_enabled()
+std::unique_ptr<PrecompiledSmartContract> get_native_implementation(td::Bits256 code_hash);
+
 }  // namespace block::precompiled
\ No newline at end of file
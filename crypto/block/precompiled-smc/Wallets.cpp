@@ -0,0 +1,370 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Wallets.h"
+#include "common.h"
+
+namespace block::precompiled {
+
+using namespace vm;
+
+namespace {
+
+// an exception thrown by THROWIF and similar instructions
+constexpr long long exception_gas = VmState::exception_gas_price;
+
+// Common part of external messages of all wallets: signature:bits512 followed by the signed data
+struct SignedMessage {
+  unsigned char signature[64];
+  CellSlice signed_data;
+
+  bool unpack(CellSlice body) {
+    if (!body.prefetch_bytes(signature, 64) || !body.advance(512)) {
+      return false;
+    }
+    signed_data = std::move(body);
+    return true;
+  }
+
+  // HASHSU
+  td::Bits256 hash() const {
+    CellBuilder cb;
+    CHECK(cb.append_cellslice_bool(signed_data));
+    return cb.finalize()->get_hash().bits();
+  }
+};
+
+}  // namespace
+
+// wallet-code.fc (revision 2)
+Result WalletV3R2::do_run() {
+  if (!is_external_) {
+    // SETCP 0; DUP; IFNOTRET
+    charge(3, 62);
+    return Result::success();
+  }
+  // SETCP 0 .. PUSHPOW2 9
+  charge(15, 304);
+  SignedMessage msg;
+  CellSlice cs;
+  td::uint32 subwallet_id, valid_until, msg_seqno;
+  if (!msg.unpack(in_msg_body_)) {
+    return Result::run_vm();
+  }
+  cs = msg.signed_data;
+  if (!(cs.fetch_uint_to(32, subwallet_id) && cs.fetch_uint_to(32, valid_until) && cs.fetch_uint_to(32, msg_seqno))) {
+    return Result::run_vm();
+  }
+  // LDSLICEX .. THROWIF 35
+  charge(9, 210);
+  if (valid_until <= now_) {
+    charge(1, exception_gas);
+    return Result::error(35);
+  }
+  // PUSH c4; CTOS .. ENDS
+  charge(6, 140);
+  CellSlice data = load_cell_slice(c4_);
+  td::uint32 stored_seqno, stored_subwallet;
+  td::Bits256 public_key;
+  if (!(data.fetch_uint_to(32, stored_seqno) && data.fetch_uint_to(32, stored_subwallet) &&
+        data.fetch_bits_to(public_key) && data.empty_ext())) {
+    return Result::run_vm();
+  }
+  // XCPU s3, s2; EQUAL; THROWIFNOT 33
+  charge(3, 70);
+  if (msg_seqno != stored_seqno) {
+    charge(1, exception_gas);
+    return Result::error(33);
+  }
+  // XCPU s4, s4; EQUAL; THROWIFNOT 34
+  charge(3, 70);
+  if (subwallet_id != stored_subwallet) {
+    charge(1, exception_gas);
+    return Result::error(34);
+  }
+  // XCHG s4; HASHSU; XC2PU s0, s5, s5; CHKSIGNU; THROWIFNOT 35
+  charge(5, 130);
+  if (!check_signature(msg.hash().as_slice(), td::Slice(msg.signature, 64), public_key)) {
+    charge(1, exception_gas);
+    return Result::error(35);
+  }
+  // ACCEPT
+  charge(1, 26);
+  accept_message();
+  // PUSHCONT; PUSHCONT; WHILE; DUP; SREFS; RET
+  charge(6, 103);
+  while (cs.size_refs()) {
+    td::uint32 mode;
+    if (!cs.fetch_uint_to(8, mode)) {
+      return Result::run_vm();
+    }
+    send_raw_message(cs.fetch_ref(), mode);
+    // LDU 8; LDREF; XCHG s2; SENDRAWMSG; RET; DUP; SREFS; RET
+    charge(8, 142);
+  }
+  if (!cs.empty_ext() || stored_seqno == 0xffffffff) {
+    return Result::run_vm();
+  }
+  // ENDS; SWAP; INC; NEWC; STU 32; STU 32; STU 256; ENDC; POP c4; RET
+  charge(10, 199);
+  CellBuilder cb;
+  cb.store_long(stored_seqno + 1, 32).store_long(stored_subwallet, 32).store_bits(public_key.cbits(), 256);
+  c4_ = cb.finalize();
+  return Result::success();
+}
+
+// wallet-v4-code.fc (revision 2)
+Result WalletV4R2::do_run() {
+  if (!is_external_) {
+    // SETCP 0; DICTPUSHCONST; DICTIGETJMPZ; SWAP; CTOS; LDU 4; OVER; PUSHINT 1; AND; PUSHCONT; IFJMP
+    charge(11, 538);
+    CellSlice cs = load_cell_slice(in_msg_);
+    td::uint32 flags;
+    if (!cs.fetch_uint_to(4, flags)) {
+      return Result::run_vm();
+    }
+    if (flags & 1) {
+      // ignore bounced messages: BLKDROP 4; RET
+      charge(2, 31);
+      return Result::success();
+    }
+    // PUSH s2; SBITS; LESSINT 32; PUSHCONT; IFJMP
+    charge(5, 106);
+    if (in_msg_body_.size() < 32) {
+      charge(2, 31);
+      return Result::success();
+    }
+    // XCHG s2; LDU 32; OVER; PUSHINT; NEQ; PUSH s2; PUSHINT; NEQ; AND; PUSHCONT; IFJMP
+    charge(11, 216);
+    td::uint32 op = (td::uint32)in_msg_body_.prefetch_ulong(32);
+    if (op == 0x706c7567 || op == 0x64737472) {
+      // requests from plugins
+      return Result::run_vm();
+    }
+    // BLKDROP 5; RET
+    charge(2, 31);
+    return Result::success();
+  }
+  // SETCP 0; DICTPUSHCONST; DICTIGETJMPZ; PUSHPOW2 9
+  charge(4, 312);
+  SignedMessage msg;
+  CellSlice cs;
+  td::uint32 subwallet_id, valid_until, msg_seqno;
+  if (!msg.unpack(in_msg_body_)) {
+    return Result::run_vm();
+  }
+  cs = msg.signed_data;
+  if (!(cs.fetch_uint_to(32, subwallet_id) && cs.fetch_uint_to(32, valid_until) && cs.fetch_uint_to(32, msg_seqno))) {
+    return Result::run_vm();
+  }
+  // LDSLICEX .. THROWIF 36
+  charge(9, 210);
+  if (valid_until <= now_) {
+    charge(1, exception_gas);
+    return Result::error(36);
+  }
+  // PUSH c4; CTOS; LDU 32; LDU 32; LDU 256; LDDICT; ENDS
+  charge(7, 166);
+  CellSlice data = load_cell_slice(c4_);
+  td::uint32 stored_seqno, stored_subwallet;
+  td::Bits256 public_key;
+  Ref<Cell> plugins;
+  if (!(data.fetch_uint_to(32, stored_seqno) && data.fetch_uint_to(32, stored_subwallet) &&
+        data.fetch_bits_to(public_key) && data.fetch_maybe_ref(plugins) && data.empty_ext())) {
+    return Result::run_vm();
+  }
+  // XCPU s4, s3; EQUAL; THROWIFNOT 33
+  charge(3, 70);
+  if (msg_seqno != stored_seqno) {
+    charge(1, exception_gas);
+    return Result::error(33);
+  }
+  // XCPU s5, s1; EQUAL; THROWIFNOT 34
+  charge(3, 70);
+  if (subwallet_id != stored_subwallet) {
+    charge(1, exception_gas);
+    return Result::error(34);
+  }
+  // XCHG s5; HASHSU; XC2PU s0, s6, s4; CHKSIGNU; THROWIFNOT 35
+  charge(5, 130);
+  if (!check_signature(msg.hash().as_slice(), td::Slice(msg.signature, 64), public_key)) {
+    charge(1, exception_gas);
+    return Result::error(35);
+  }
+  // ACCEPT
+  charge(1, 26);
+  accept_message();
+  if (stored_seqno == 0xffffffff) {
+    return Result::run_vm();
+  }
+  // PUSH s4; INC; NEWC; STU 32 .. STDICT; ENDC; POP c4; COMMIT
+  charge(13, 306);
+  CellBuilder cb;
+  cb.store_long(stored_seqno + 1, 32).store_long(stored_subwallet, 32).store_bits(public_key.cbits(), 256);
+  CHECK(cb.store_maybe_ref(plugins));
+  c4_ = cb.finalize();
+  // SWAP; LDU 8; OVER; EQINT 0; PUSHCONT; IFJMP
+  charge(6, 124);
+  td::uint32 op;
+  if (!cs.fetch_uint_to(8, op) || op != 0) {
+    // plugin management
+    return Result::run_vm();
+  }
+  // BLKDROP2 5, 1; PUSHCONT; PUSHCONT; WHILE; DUP; SREFS; RET
+  charge(7, 129);
+  while (cs.size_refs()) {
+    td::uint32 mode;
+    if (!cs.fetch_uint_to(8, mode)) {
+      return Result::run_vm();
+    }
+    send_raw_message(cs.fetch_ref(), mode);
+    // LDU 8; LDREF; XCHG s2; SENDRAWMSG; RET; DUP; SREFS; RET
+    charge(8, 142);
+  }
+  // DROP; RET
+  charge(2, 23);
+  return Result::success();
+}
+
+// highload-wallet-v2-code.fc (revision 2)
+Result HighloadWalletV2R2::do_run() {
+  if (!is_external_) {
+    // SETCP 0; DICTPUSHCONST; DICTIGETJMPZ; DROP; RET
+    charge(5, 409);
+    return Result::success();
+  }
+  // SETCP 0; DICTPUSHCONST; DICTIGETJMPZ; PUSHPOW2 9
+  charge(4, 312);
+  SignedMessage msg;
+  CellSlice cs;
+  td::uint32 subwallet_id;
+  td::uint64 query_id;
+  if (!msg.unpack(in_msg_body_) || now_ < 64) {
+    return Result::run_vm();
+  }
+  cs = msg.signed_data;
+  if (!(cs.fetch_uint_to(32, subwallet_id) && cs.fetch_uint_to(64, query_id))) {
+    return Result::run_vm();
+  }
+  // LDSLICEX; DUP; LDU 32; LDU 64; NOW; LSHIFT 32; PUSH2 s2, s0; LESS; THROWIF 35
+  charge(9, 218);
+  td::uint64 now_query_id = (td::uint64)now_ << 32;
+  if (query_id < now_query_id) {
+    charge(1, exception_gas);
+    return Result::error(35);
+  }
+  // PUSH c4; CTOS; LDU 32; LDU 64; LDU 256; LDDICT; ENDS
+  charge(7, 166);
+  CellSlice data = load_cell_slice(c4_);
+  td::uint32 stored_subwallet;
+  td::uint64 last_cleaned;
+  td::Bits256 public_key;
+  Ref<Cell> old_queries;
+  if (!(data.fetch_uint_to(32, stored_subwallet) && data.fetch_uint_to(64, last_cleaned) &&
+        data.fetch_bits_to(public_key) && data.fetch_maybe_ref(old_queries) && data.empty_ext())) {
+    return Result::run_vm();
+  }
+  // PUSH2 s6, s0; PUSHINT 64; DICTUGET; NULLSWAPIFNOT; NIP; THROWIF 32
+  charge(6, 148);
+  td::BitArray<64> key;
+  key.store_ulong(query_id);
+  if (Dictionary{old_queries, 64}.lookup(key.bits(), 64).not_null()) {
+    charge(1, exception_gas);
+    return Result::error(32);
+  }
+  // XCPU s7, s3; EQUAL; THROWIFNOT 34
+  charge(3, 70);
+  if (subwallet_id != stored_subwallet) {
+    charge(1, exception_gas);
+    return Result::error(34);
+  }
+  // XCHG s7; HASHSU; XC2PU s0, s8, s7; CHKSIGNU; THROWIFNOT 35
+  charge(5, 130);
+  if (!check_signature(msg.hash().as_slice(), td::Slice(msg.signature, 64), public_key)) {
+    charge(1, exception_gas);
+    return Result::error(35);
+  }
+  // XCHG s2; LDDICT; ENDS
+  charge(3, 62);
+  Ref<Cell> msgs;
+  if (!cs.fetch_maybe_ref(msgs)) {
+    return Result::run_vm();
+  }
+  if (!cs.empty_ext()) {
+    charge(1, exception_gas);
+    return Result::error(Excno::cell_und);
+  }
+  // ACCEPT
+  charge(1, 26);
+  accept_message();
+  // PUSHINT -1; PUSHCONT; UNTIL
+  charge(3, 62);
+  td::BitArray<16> msg_key;
+  msg_key.store_long(-1);
+  while (true) {
+    auto value = Dictionary{msgs, 16}.lookup_nearest_key(msg_key.bits(), 16, true, false, true);
+    if (value.is_null()) {
+      // OVER; PUSHINT 16; DICTIGETNEXT; NULLSWAPIFNOT2; DUP; PUSHCONT; PUSHCONT; IFELSE; POP s2; RET; SWAP; NOT; RET
+      charge(13, 232);
+      break;
+    }
+    td::uint32 mode;
+    Ref<Cell> out_msg;
+    if (!(value.write().fetch_uint_to(8, mode) && value.write().fetch_ref_to(out_msg))) {
+      return Result::run_vm();
+    }
+    send_raw_message(out_msg, mode);
+    // OVER; PUSHINT 16; DICTIGETNEXT .. XCHG s2; LDU 8; LDREF; DROP; SWAP; SENDRAWMSG; RET; SWAP; NOT; RET
+    charge(18, 338);
+  }
+  // 2DROP; PUSHPOW2 38; SUB; NEWC; XCHG3 s0, s3, s4; PUSHINT 64; DICTUSETB
+  charge(7, 158);
+  td::uint64 bound = now_query_id - (1ULL << 38);
+  Dictionary dict{old_queries, 64};
+  if (!dict.set_builder(key.bits(), 64, CellBuilder(), Dictionary::SetMode::Set)) {
+    return Result::run_vm();
+  }
+  old_queries = dict.get_root_cell();
+  // PUSHREFCONT; UNTIL (the continuation is in a separate cell)
+  charge(2, 18 + VmState::cell_load_gas_price + 18);
+  while (true) {
+    td::BitArray<64> min_key;
+    Dictionary cleaned{old_queries, 64};
+    auto value = cleaned.extract_minmax_key(min_key.bits(), 64, false, false);
+    if (value.is_null()) {
+      return Result::run_vm();
+    }
+    if (min_key.to_ulong() >= bound) {
+      // DUP; PUSHINT 64; DICTUREMMIN; NULLSWAPIFNOT2; POP s2; XCPU s1, s0; PUSHCONT; IF; DROP; PUSH2 s0, s3; LESS;
+      // RET; DUP; PUSHCONT; PUSHCONT; IFELSE; POP s2; DROP; RET; NOT; RET
+      charge(21, 379);
+      break;
+    }
+    old_queries = cleaned.get_root_cell();
+    last_cleaned = min_key.to_ulong();
+    // the same, but POP s3; POP s6; SWAP instead of POP s2; DROP
+    charge(22, 397);
+  }
+  // NIP; NEWC; XCHG s1, s2; STU 32; XCHG s1, s3; STU 64; STU 256; STDICT; ENDC; POP c4; RET
+  charge(11, 225);
+  CellBuilder cb;
+  cb.store_long(stored_subwallet, 32).store_long(last_cleaned, 64).store_bits(public_key.cbits(), 256);
+  CHECK(cb.store_maybe_ref(old_queries));
+  c4_ = cb.finalize();
+  return Result::success();
+}
+
+}  // namespace block::precompiled
@@ -0,0 +1,74 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "PrecompiledSmartContract.h"
+
+namespace block::precompiled {
+
+// Gas-equivalent implementations of standard wallets (see crypto/smartcont).
+// Gas and step costs of straight-line code are taken from the compiled code of each contract; cell loads and
+// creations are charged as they happen. Rare paths (malformed messages, plugins of wallet v4) fall back to TVM.
+
+class WalletV3R2 : public PrecompiledSmartContract {
+ public:
+  std::string get_name() const override {
+    return "wallet-v3-r2";
+  }
+  int required_version() const override {
+    return 4;
+  }
+  bool is_gas_equivalent() const override {
+    return true;
+  }
+
+ protected:
+  Result do_run() override;
+};
+
+class WalletV4R2 : public PrecompiledSmartContract {
+ public:
+  std::string get_name() const override {
+    return "wallet-v4-r2";
+  }
+  int required_version() const override {
+    return 4;
+  }
+  bool is_gas_equivalent() const override {
+    return true;
+  }
+
+ protected:
+  Result do_run() override;
+};
+
+class HighloadWalletV2R2 : public PrecompiledSmartContract {
+ public:
+  std::string get_name() const override {
+    return "highload-wallet-v2-r2";
+  }
+  int required_version() const override {
+    return 4;
+  }
+  bool is_gas_equivalent() const override {
+    return true;
+  }
+
+ protected:
+  Result do_run() override;
+};
+
+}  // namespace block::precompiled
@@ -1701,26 +1701,46 @@ bool Transaction::check_in_msg_state_hash(const ComputePhaseConfig& cfg) {
 /**
  * Runs the precompiled smart contract and prepares the compute phase.
  *
+ * If the contract is marked as precompiled in the config, it uses the fixed amount of gas from the config.
+ * Otherwise the implementation must be gas-equivalent, and the compute phase gets gas usage and steps as in TVM.
+ *
  * @param cfg The configuration for the compute phase.
  * @param impl Implementation of the smart contract
+ * @param gas Gas limits of the compute phase.
  *
- * @returns True if the contract was successfully executed, false otherwise.
+ * @returns True if the contract was executed, false if it has to be run in TVM instead.
  */
-bool Transaction::run_precompiled_contract(const ComputePhaseConfig& cfg, precompiled::PrecompiledSmartContract& impl) {
+bool Transaction::run_precompiled_contract(const ComputePhaseConfig& cfg, precompiled::PrecompiledSmartContract& impl,
+                                           const vm::GasLimits& gas) {
   ComputePhase& cp = *compute_phase;
-  CHECK(cp.precompiled_gas_usage);
-  td::uint64 gas_usage = cp.precompiled_gas_usage.value();
+  bool fixed_gas = (bool)cp.precompiled_gas_usage;
+  CHECK(fixed_gas || impl.is_gas_equivalent());
+  impl.set_gas_limits(gas);
+  impl.set_chksig_always_succeed(cfg.ignore_chksig);
   td::Timer timer;
-  auto result =
-      impl.run(my_addr, now, start_lt, balance, new_data, *in_msg_body, in_msg, msg_balance_remaining, in_msg_extern,
-               compute_vm_libraries(cfg), cfg.global_version, cfg.max_vm_data_depth, new_code,
-               cfg.unpacked_config_tuple, due_payment.not_null() ? due_payment : td::zero_refint(), gas_usage);
+  auto result = impl.run(my_addr, now, start_lt, balance, new_data, *in_msg_body, in_msg, msg_balance_remaining,
+                         in_msg_extern, compute_vm_libraries(cfg), cfg.global_version, cfg.max_vm_data_depth, new_code,
+                         cfg.unpacked_config_tuple, due_payment.not_null() ? due_payment : td::zero_refint(),
+                         fixed_gas ? cp.precompiled_gas_usage.value() : 0);
   double elapsed = timer.elapsed();
+  if (result.fallback) {
+    LOG(INFO) << "Precompiled smart contract " << impl.get_name() << " cannot handle the message, running VM";
+    return false;
+  }
+  td::uint64 gas_usage;
   cp.vm_init_state_hash = td::Bits256::zero();
   cp.exit_code = result.exit_code;
   cp.out_of_gas = false;
   cp.vm_final_state_hash = td::Bits256::zero();
-  cp.vm_steps = 0;
+  if (fixed_gas) {
+    gas_usage = cp.precompiled_gas_usage.value();
+    cp.vm_steps = 0;
+  } else {
+    auto native_gas = impl.get_gas_limits();
+    gas_usage = std::min<long long>(native_gas.gas_consumed(), native_gas.gas_limit);
+    cp.vm_steps = (int)impl.get_steps_count();
+    cp.vm_loaded_cells = impl.extract_loaded_cells();
+  }
   cp.gas_used = gas_usage;
   cp.accepted = result.accepted;
   cp.success = (cp.accepted && result.committed);
@@ -1886,8 +1906,9 @@ bool Transaction::prepare_compute_phase(const ComputePhaseConfig& cfg) {
       return true;
     }
     auto impl = precompiled::get_implementation(new_code->get_hash().bits());
-    if (impl != nullptr && !cfg.dont_run_precompiled_ && impl->required_version() <= cfg.global_version) {
-      return run_precompiled_contract(cfg, *impl);
+    if (impl != nullptr && !cfg.dont_run_precompiled_ && impl->required_version() <= cfg.global_version &&
+        run_precompiled_contract(cfg, *impl, gas)) {
+      return true;
     }
 
     // Contract is marked as precompiled in global config, but implementation is not available
@@ -1896,6 +1917,12 @@ bool Transaction::prepare_compute_phase(const ComputePhaseConfig& cfg) {
               << ", gas_usage=" << gas_usage << "), running VM";
     long long limit = account.is_special ? cfg.special_gas_limit : cfg.gas_limit;
     gas = vm::GasLimits{limit, limit, gas.gas_credit ? limit : 0};
+  } else if (cfg.run_native_contracts && !cfg.stop_on_accept_message && new_code.not_null() && trans_type == tr_ord) {
+    auto impl = precompiled::get_native_implementation(new_code->get_hash().bits());
+    if (impl != nullptr && impl->required_version() <= cfg.global_version &&
+        run_precompiled_contract(cfg, *impl, gas)) {
+      return true;
+    }
   }
 
   // initialize VM
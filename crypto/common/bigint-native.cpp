@@ -0,0 +1,479 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "common/bigint-native.h"
+
+#include "td/utils/bits.h"
+#include "td/utils/uint128.h"
+
+#if defined(__BMI2__) && defined(__ADX__)
+#include <immintrin.h>
+#define TD_BIGINT_NATIVE_ADX 1
+#endif
+
+namespace td {
+namespace bigint_native {
+namespace {
+
+// enough for a product of two 256-bit magnitudes; all limb arrays below have this size unless stated otherwise
+constexpr int LIMBS = 8;
+
+// sign and magnitude, least significant limb first
+struct Num {
+  uint64 limbs[LIMBS];
+  bool negative;
+};
+
+// returns the low half of x * y and stores the high one to hi
+inline uint64 mul_wide(uint64 x, uint64 y, uint64& hi) {
+#if TD_BIGINT_NATIVE_ADX
+  unsigned long long h;
+  uint64 lo = _mulx_u64(x, y, &h);
+  hi = h;
+  return lo;
+#elif TD_HAVE_INT128
+  auto z = static_cast<unsigned __int128>(x) * y;
+  hi = static_cast<uint64>(z >> 64);
+  return static_cast<uint64>(z);
+#else
+  auto z = uint128::from_unsigned(x).mult(y);
+  hi = z.hi();
+  return z.lo();
+#endif
+}
+
+// returns x + y + carry and updates carry, which is either 0 or 1
+inline uint64 add_carry(uint64 x, uint64 y, uint64& carry) {
+#if TD_BIGINT_NATIVE_ADX
+  unsigned long long res;
+  carry = _addcarryx_u64(static_cast<unsigned char>(carry), x, y, &res);
+  return res;
+#else
+  uint64 res = x + y;
+  uint64 c = res < x;
+  res += carry;
+  carry = c | (res < carry);
+  return res;
+#endif
+}
+
+// returns x - y - borrow and updates borrow, which is either 0 or 1
+inline uint64 sub_borrow(uint64 x, uint64 y, uint64& borrow) {
+#if TD_BIGINT_NATIVE_ADX
+  unsigned long long res;
+  borrow = _subborrow_u64(static_cast<unsigned char>(borrow), x, y, &res);
+  return res;
+#else
+  uint64 res = x - y;
+  uint64 b = x < y;
+  b |= res < borrow;
+  res -= borrow;
+  borrow = b;
+  return res;
+#endif
+}
+
+// returns (hi * 2^64 + lo) / d and stores the remainder to rem; requires hi < d
+inline uint64 div_wide(uint64 hi, uint64 lo, uint64 d, uint64& rem) {
+#if TD_HAVE_INT128
+  auto x = (static_cast<unsigned __int128>(hi) << 64) | lo;
+  rem = static_cast<uint64>(x % d);
+  return static_cast<uint64>(x / d);
+#else
+  uint128 quot, r;
+  uint128(hi, lo).divmod(uint128::from_unsigned(d), &quot, &r);
+  rem = r.lo();
+  return quot.lo();
+#endif
+}
+
+// Division by a word with the highest bit set, using a precomputed reciprocal instead of a hardware division
+// (N. Moller, T. Granlund, "Improved division by invariant integers")
+class WordDivisor {
+ public:
+  explicit WordDivisor(uint64 d) : d_(d) {
+    uint64 rem;
+    inv_ = div_wide(~d, ~uint64{0}, d, rem);
+  }
+  uint64 get() const {
+    return d_;
+  }
+  // returns (hi * 2^64 + lo) / d and stores the remainder to rem; requires hi < d
+  uint64 divide(uint64 hi, uint64 lo, uint64& rem) const {
+    uint64 q_hi, carry = 0;
+    uint64 q_lo = add_carry(mul_wide(inv_, hi, q_hi), lo, carry);
+    q_hi = add_carry(q_hi, hi + 1, carry);
+    uint64 r = lo - q_hi * d_;
+    if (r > q_lo) {
+      q_hi--;
+      r += d_;
+    }
+    if (r >= d_) {
+      q_hi++;
+      r -= d_;
+    }
+    rem = r;
+    return q_hi;
+  }
+
+ private:
+  uint64 d_;
+  uint64 inv_;
+};
+
+int limb_count(const uint64* x, int n) {
+  while (n > 0 && !x[n - 1]) {
+    n--;
+  }
+  return n;
+}
+
+int cmp_limbs(const uint64* x, const uint64* y) {
+  for (int i = LIMBS - 1; i >= 0; i--) {
+    if (x[i] != y[i]) {
+      return x[i] < y[i] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+// res = x - y, requires x >= y; res may coincide with x or y
+void sub_limbs(const uint64* x, const uint64* y, uint64* res) {
+  uint64 borrow = 0;
+  for (int i = 0; i < LIMBS; i++) {
+    res[i] = sub_borrow(x[i], y[i], borrow);
+  }
+}
+
+// x += 1, returns false on overflow
+bool inc_limbs(uint64* x) {
+  for (int i = 0; i < LIMBS; i++) {
+    if (++x[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool fits_256(const uint64* x) {
+  return !(x[4] | x[5] | x[6] | x[7]);
+}
+
+// stores |x| to the first 4 limbs of res and zeroes the others; fails unless x is valid and |x| < 2^256
+bool import_int(const BigInt256& x, Num& res) {
+  auto xa = x.as_any_int();
+  int n = xa.size();
+  if (n <= 0) {
+    return false;
+  }
+  std::fill(res.limbs + 5, res.limbs + LIMBS, 0);
+  if (n == 1) {
+    std::fill(res.limbs + 1, res.limbs + 5, 0);
+    auto digit = xa.digits[0];
+    res.negative = digit < 0;
+    res.limbs[0] = res.negative ? 0 - static_cast<uint64>(digit) : static_cast<uint64>(digit);
+    return true;
+  }
+  // collect the two's complement of x in 5 limbs; the digits are signed and not necessarily normalized
+  uint64* limbs = res.limbs;
+#if TD_HAVE_INT128
+  static_assert(BigInt256::word_shift == 52 && BigInt256::word_cnt == 5, "");
+  int64 digits[5];
+  for (int i = 0; i < 5; i++) {
+    digits[i] = i < n ? xa.digits[i] : 0;
+  }
+  auto acc = static_cast<__int128>(digits[0]) + (static_cast<__int128>(digits[1]) << 52);
+  limbs[0] = static_cast<uint64>(acc);
+  acc = (acc >> 64) + (static_cast<__int128>(digits[2]) << 40);
+  limbs[1] = static_cast<uint64>(acc);
+  acc = (acc >> 64) + (static_cast<__int128>(digits[3]) << 28);
+  limbs[2] = static_cast<uint64>(acc);
+  acc = (acc >> 64) + (static_cast<__int128>(digits[4]) << 16);
+  limbs[3] = static_cast<uint64>(acc);
+  limbs[4] = static_cast<uint64>(acc >> 64);
+#else
+  auto acc = uint128::from_unsigned(0);
+  int bits = 0, j = 0;
+  auto flush = [&] {
+    limbs[j++] = acc.lo();
+    acc = uint128(static_cast<int64>(acc.hi()) < 0 ? ~uint64{0} : 0, acc.hi());
+  };
+  for (int i = 0; i < n; i++) {
+    acc = acc.add(uint128::from_signed(xa.digits[i]).shl(bits));
+    bits += BigInt256::word_shift;
+    if (bits >= 64) {
+      flush();
+      bits -= 64;
+    }
+  }
+  while (j < 5) {
+    flush();
+  }
+#endif
+  // negate without branches, as signs are hardly predictable
+  uint64 mask = static_cast<uint64>(static_cast<int64>(limbs[4]) >> 63), carry = mask & 1;
+  for (int i = 0; i < 5; i++) {
+    limbs[i] = add_carry(limbs[i] ^ mask, 0, carry);
+  }
+  res.negative = mask != 0;
+  return !limbs[4];
+}
+
+// res = (-1)^negative * x, requires x < 2^256
+void export_int(const uint64* x, bool negative, BigInt256& res) {
+  auto ra = res.as_any_int();
+  if (!(x[1] | x[2] | x[3]) && x[0] < static_cast<uint64>(BigIntInfo::Half)) {
+    ra.set_size(1);
+    ra.digits[0] = negative ? -static_cast<int64>(x[0]) : static_cast<int64>(x[0]);
+    return;
+  }
+  // adding Half to every digit position turns the balanced digits into plain 52-bit chunks
+  static_assert(BigInt256::word_shift == 52 && BigInt256::word_cnt == 5, "");
+  static constexpr uint64 halves[5] = {uint64{1} << 51, uint64{1} << 39, uint64{1} << 27, uint64{1} << 15,
+                                       uint64{1} << 3};
+  uint64 t[5] = {x[0], x[1], x[2], x[3], 0};
+  uint64 sign = negative ? ~uint64{0} : 0, negate_carry = sign & 1, carry = 0;
+  for (int i = 0; i < 5; i++) {
+    t[i] = add_carry(add_carry(t[i] ^ sign, 0, negate_carry), halves[i], carry);
+  }
+  constexpr uint64 mask = (uint64{1} << 52) - 1;
+  constexpr int64 half = BigIntInfo::Half;
+  auto digits = ra.digits.data();
+  digits[0] = static_cast<int64>(t[0] & mask) - half;
+  digits[1] = static_cast<int64>(((t[0] >> 52) | (t[1] << 12)) & mask) - half;
+  digits[2] = static_cast<int64>(((t[1] >> 40) | (t[2] << 24)) & mask) - half;
+  digits[3] = static_cast<int64>(((t[2] >> 28) | (t[3] << 36)) & mask) - half;
+  digits[4] = static_cast<int64>(((t[3] >> 16) | (t[4] << 48)) & mask) - half;
+  int n = 5;
+  while (n > 1 && !digits[n - 1]) {
+    n--;
+  }
+  ra.set_size(n);
+}
+
+// res = x * y for 4-limb x and y
+void mul_limbs(const uint64* x, const uint64* y, uint64* res) {
+  std::fill(res, res + LIMBS, 0);
+  int xn = limb_count(x, 4), yn = limb_count(y, 4);
+  for (int i = 0; i < xn; i++) {
+    uint64 carry = 0;
+    for (int j = 0; j < yn; j++) {
+      uint64 hi, c1 = 0, c2 = 0;
+      uint64 lo = add_carry(mul_wide(x[i], y[j], hi), carry, c1);
+      res[i + j] = add_carry(res[i + j], lo, c2);
+      carry = hi + c1 + c2;
+    }
+    res[i + yn] = carry;
+  }
+}
+
+// res = x << shift for 4-limb x, 0 <= shift <= 256
+void shl_limbs(const uint64* x, int shift, uint64* res) {
+  std::fill(res, res + LIMBS, 0);
+  int q = shift / 64, r = shift % 64;
+  for (int i = 0; i < 4; i++) {
+    res[i + q] |= x[i] << r;
+    if (r) {
+      res[i + q + 1] |= x[i] >> (64 - r);
+    }
+  }
+}
+
+// quot = x / y and rem = x % y for y of yn > 0 limbs with y[yn - 1] != 0, by Knuth's algorithm D
+void divmod_limbs(const uint64* x, const uint64* y, int yn, uint64* quot, uint64* rem) {
+  std::fill(quot, quot + LIMBS, 0);
+  std::fill(rem, rem + LIMBS, 0);
+  int xn = limb_count(x, LIMBS);
+  if (xn < yn) {
+    std::copy(x, x + xn, rem);
+    return;
+  }
+  // normalize so that the top limb of the divisor has its highest bit set
+  int s = count_leading_zeroes64(y[yn - 1]);
+  uint64 v[LIMBS], u[LIMBS + 1];
+  for (int i = yn - 1; i > 0; i--) {
+    v[i] = s ? (y[i] << s) | (y[i - 1] >> (64 - s)) : y[i];
+  }
+  v[0] = y[0] << s;
+  u[xn] = s ? x[xn - 1] >> (64 - s) : 0;
+  for (int i = xn - 1; i > 0; i--) {
+    u[i] = s ? (x[i] << s) | (x[i - 1] >> (64 - s)) : x[i];
+  }
+  u[0] = x[0] << s;
+
+  WordDivisor v_top{v[yn - 1]};
+  if (yn == 1) {
+    uint64 r = u[xn];
+    for (int j = xn - 1; j >= 0; j--) {
+      quot[j] = v_top.divide(r, u[j], r);
+    }
+    rem[0] = r >> s;
+    return;
+  }
+  uint64 v_next = v[yn - 2];
+  for (int j = xn - yn; j >= 0; j--) {
+    uint64 q_hat, r_hat;
+    bool r_hat_overflow = false;
+    if (u[j + yn] >= v_top.get()) {
+      q_hat = ~uint64{0};
+      r_hat = u[j + yn - 1] + v_top.get();
+      r_hat_overflow = r_hat < v_top.get();
+    } else {
+      q_hat = v_top.divide(u[j + yn], u[j + yn - 1], r_hat);
+    }
+    while (!r_hat_overflow) {
+      uint64 p_hi;
+      uint64 p_lo = mul_wide(q_hat, v_next, p_hi);
+      if (p_hi < r_hat || (p_hi == r_hat && p_lo <= u[j + yn - 2])) {
+        break;
+      }
+      q_hat--;
+      r_hat += v_top.get();
+      r_hat_overflow = r_hat < v_top.get();
+    }
+
+    uint64 carry = 0, borrow = 0;
+    for (int i = 0; i < yn; i++) {
+      uint64 p_hi, c = 0;
+      uint64 p_lo = add_carry(mul_wide(q_hat, v[i], p_hi), carry, c);
+      carry = p_hi + c;
+      u[i + j] = sub_borrow(u[i + j], p_lo, borrow);
+    }
+    u[j + yn] = sub_borrow(u[j + yn], carry, borrow);
+    if (borrow) {
+      // q_hat was one too large
+      q_hat--;
+      uint64 c = 0;
+      for (int i = 0; i < yn; i++) {
+        u[i + j] = add_carry(u[i + j], v[i], c);
+      }
+      u[j + yn] += c;
+    }
+    quot[j] = q_hat;
+  }
+  for (int i = 0; i < yn; i++) {
+    rem[i] = s ? (u[i] >> s) | (u[i + 1] << (64 - s)) : u[i];
+  }
+}
+
+// x += y, fails if the magnitude overflows
+bool add_num(Num& x, const Num& y) {
+  if (x.negative == y.negative) {
+    uint64 carry = 0;
+    for (int i = 0; i < LIMBS; i++) {
+      x.limbs[i] = add_carry(x.limbs[i], y.limbs[i], carry);
+    }
+    return !carry;
+  }
+  if (cmp_limbs(x.limbs, y.limbs) >= 0) {
+    sub_limbs(x.limbs, y.limbs, x.limbs);
+  } else {
+    sub_limbs(y.limbs, x.limbs, x.limbs);
+    x.negative = y.negative;
+  }
+  return true;
+}
+
+bool add_int(Num& x, const BigInt256* w) {
+  if (!w) {
+    return true;
+  }
+  Num y;
+  return import_int(*w, y) && add_num(x, y);
+}
+
+// turns the truncated division of magnitudes |x| = quot * |y| + rem into the rounded division of signed numbers
+// (see AnyIntView::mod_div_any) and stores the requested results
+bool finish_division(bool x_negative, bool y_negative, const uint64* y, int round_mode, uint64* quot, uint64* rem,
+                     BigInt256* quot_res, BigInt256* rem_res) {
+  bool quot_negative = x_negative != y_negative, rem_negative = x_negative;
+  if (limb_count(rem, LIMBS)) {
+    uint64 rem_up[LIMBS];
+    sub_limbs(y, rem, rem_up);
+    bool up;
+    if (round_mode < 0) {
+      up = quot_negative;
+    } else if (round_mode > 0) {
+      up = !quot_negative;
+    } else {
+      int c = cmp_limbs(rem, rem_up);
+      up = quot_negative ? c > 0 : c >= 0;
+    }
+    if (up) {
+      if (!inc_limbs(quot) && quot_res) {
+        return false;
+      }
+      std::copy(rem_up, rem_up + LIMBS, rem);
+      rem_negative = !x_negative;
+    }
+  }
+  if (quot_res && !fits_256(quot)) {
+    return false;
+  }
+  if (quot_res) {
+    export_int(quot, quot_negative, *quot_res);
+  }
+  if (rem_res) {
+    export_int(rem, rem_negative, *rem_res);
+  }
+  return true;
+}
+
+bool divide(const Num& x, const BigInt256& z, int round_mode, BigInt256* quot, BigInt256* rem) {
+  Num y;
+  if (!import_int(z, y)) {
+    return false;
+  }
+  int yn = limb_count(y.limbs, 4);
+  if (!yn) {
+    return false;
+  }
+  uint64 q[LIMBS], r[LIMBS];
+  divmod_limbs(x.limbs, y.limbs, yn, q, r);
+  return finish_division(x.negative, y.negative, y.limbs, round_mode, q, r, quot, rem);
+}
+
+bool multiply(const BigInt256& x, const BigInt256& y, Num& res) {
+  Num xv, yv;
+  if (!import_int(x, xv) || !import_int(y, yv)) {
+    return false;
+  }
+  mul_limbs(xv.limbs, yv.limbs, res.limbs);
+  res.negative = xv.negative != yv.negative;
+  return true;
+}
+
+}  // namespace
+
+bool muldivmod(const BigInt256& x, const BigInt256& y, const BigInt256* w, const BigInt256& z, int round_mode,
+               BigInt256* quot, BigInt256* rem) {
+  Num p;
+  return multiply(x, y, p) && add_int(p, w) && divide(p, z, round_mode, quot, rem);
+}
+
+bool shldivmod(const BigInt256& x, int shift, const BigInt256* w, const BigInt256& z, int round_mode, BigInt256* quot,
+               BigInt256* rem) {
+  Num xv, p;
+  if (shift < 0 || shift > 256 || !import_int(x, xv)) {
+    return false;
+  }
+  shl_limbs(xv.limbs, shift, p.limbs);
+  p.negative = xv.negative;
+  return add_int(p, w) && divide(p, z, round_mode, quot, rem);
+}
+
+}  // namespace bigint_native
+}  // namespace td
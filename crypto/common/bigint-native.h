@@ -0,0 +1,43 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "common/bigint.hpp"
+
+namespace td {
+
+/*
+ * Fixed-width kernels for the hottest BigInt256 operations, computing on 64-bit limbs instead of 52-bit digits.
+ *
+ * Operands must be valid and less than 2^256 in absolute value. The same applies to the results. If either
+ * condition fails, or on division by zero, the kernels return false and leave the results untouched, so
+ * the caller falls back to the generic BigInt256 code. Any results that are produced are normalized and
+ * identical to those of the generic code. round_mode has the meaning of BigInt256::mod_div: -1 is floor,
+ * 0 is nearest (ties go up) and 1 is ceil. Any of w, quot and rem may be null.
+ */
+namespace bigint_native {
+
+// quot = round((x * y + w) / z), rem = x * y + w - quot * z
+bool muldivmod(const BigInt256& x, const BigInt256& y, const BigInt256* w, const BigInt256& z, int round_mode,
+               BigInt256* quot, BigInt256* rem);
+
+// the same as muldivmod with x * 2^shift instead of x * y, 0 <= shift <= 256
+bool shldivmod(const BigInt256& x, int shift, const BigInt256* w, const BigInt256& z, int round_mode, BigInt256* quot,
+               BigInt256* rem);
+
+}  // namespace bigint_native
+}  // namespace td
@@ -17,6 +17,7 @@
     Copyright 2017-2020 Telegram Systems LLP
 */
 #include "common/refint.h"
+#include "common/bigint-native.h"
 #include <utility>
 #include <iostream>
 
@@ -119,15 +120,22 @@ std::pair<RefInt256, RefInt256> divmod(RefInt256 x, RefInt256 y, int round_mode)
 }
 
 RefInt256 muldiv(RefInt256 x, RefInt256 y, RefInt256 z, int round_mode) {
+  RefInt256 quot{true};
+  if (bigint_native::muldivmod(*x, *y, nullptr, *z, round_mode, &quot.unique_write(), nullptr)) {
+    return quot;
+  }
   typename td::BigInt256::DoubleInt tmp{0};
   tmp.add_mul(*x, *y);
-  RefInt256 quot{true};
   tmp.mod_div(*z, quot.unique_write(), round_mode);
   quot.write().normalize();
   return quot;
 }
 
 std::pair<RefInt256, RefInt256> muldivmod(RefInt256 x, RefInt256 y, RefInt256 z, int round_mode) {
+  RefInt256 q{true}, r{true};
+  if (bigint_native::muldivmod(*x, *y, nullptr, *z, round_mode, &q.unique_write(), &r.unique_write())) {
+    return std::make_pair(std::move(q), std::move(r));
+  }
   typename td::BigInt256::DoubleInt tmp{0}, quot;
   tmp.add_mul(*x, *y);
   tmp.mod_div(*z, quot, round_mode);
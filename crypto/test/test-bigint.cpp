@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <string.h>
 #include <array>
+#include <functional>
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -25,8 +26,10 @@
 #include "common/refcnt.hpp"
 #include "common/bigint.hpp"
 #include "common/refint.h"
+#include "common/bigint-native.h"
 #include "modbigint.cpp"
 
+#include "td/utils/benchmark.h"
 #include "td/utils/tests.h"
 
 int mkint_chk_mode = -1, res_chk_mode = 0;
@@ -798,6 +801,132 @@ void check_lshift_div_on(td::RefInt256 x, const BInt& xv, td::RefInt256 y, const
                          td::make_refint(tmp), rmode);
 }
 
+// the native kernels must either give results identical to those of the generic code (including the representation),
+// or refuse operands and results outside of (-2^256, 2^256)
+using DInt = typename td::BigInt256::DoubleInt;
+
+template <typename T>
+bool in_native_range(const T& x) {
+  if (!x.is_valid() || !x.signed_fits_bits(257)) {
+    return false;
+  }
+  T y{x};
+  y.negate().normalize();
+  return y.signed_fits_bits(257);
+}
+
+template <typename T>
+bool same_repr(const td::BigInt256& x, const T& y) {
+  auto xa = x.as_any_int();
+  auto ya = y.as_any_int();
+  if (xa.size() != ya.size()) {
+    return false;
+  }
+  for (int i = 0; i < xa.size(); i++) {
+    if (xa.digits[i] != ya.digits[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void check_native_division(bool args_ok, const DInt& quot, const DInt& rem,
+                           const std::function<bool(td::BigInt256*, td::BigInt256*)>& run) {
+  td::BigInt256 q, r;
+  bool ok = run(&q, &r);
+  CHECK(ok == (args_ok && in_native_range(quot)));
+  if (ok) {
+    CHECK(same_repr(q, quot));
+    CHECK(same_repr(r, rem));
+  }
+  // the remainder alone does not depend on the range of the quotient
+  td::BigInt256 r2;
+  ok = run(nullptr, &r2);
+  CHECK(ok == args_ok);
+  if (ok) {
+    CHECK(same_repr(r2, rem));
+  }
+}
+
+void check_native_muldivmod_on(const td::BigInt256& x, const td::BigInt256& y, const td::BigInt256* w,
+                               const td::BigInt256& z, int rmode) {
+  DInt tmp{0}, quot;
+  if (w) {
+    tmp = *w;
+  }
+  tmp.add_mul(x, y);
+  tmp.mod_div(z, quot, rmode);
+  quot.normalize();
+  bool args_ok = in_native_range(x) && in_native_range(y) && (!w || in_native_range(*w)) && in_native_range(z) &&
+                 z.sgn() != 0;
+  check_native_division(args_ok, quot, tmp, [&](td::BigInt256* q, td::BigInt256* r) {
+    return td::bigint_native::muldivmod(x, y, w, z, rmode, q, r);
+  });
+}
+
+void check_native_shldivmod_on(const td::BigInt256& x, int shift, const td::BigInt256* w, const td::BigInt256& z,
+                               int rmode) {
+  DInt tmp{x}, quot;
+  tmp <<= shift;
+  if (w) {
+    tmp += *w;
+  }
+  tmp.mod_div(z, quot, rmode);
+  quot.normalize();
+  bool args_ok = in_native_range(x) && (!w || in_native_range(*w)) && in_native_range(z) && z.sgn() != 0;
+  check_native_division(args_ok, quot, tmp, [&](td::BigInt256* q, td::BigInt256* r) {
+    return td::bigint_native::shldivmod(x, shift, w, z, rmode, q, r);
+  });
+}
+
+void check_native_on(td::RefInt256 x, td::RefInt256 y, td::RefInt256 z, td::RefInt256 w, int shift) {
+  int rmode = rand_int(-1, 1);
+  check_native_muldivmod_on(*x, *y, nullptr, *z, rmode);
+  check_native_muldivmod_on(*x, *y, &*w, *z, rmode);
+  check_native_shldivmod_on(*x, shift, coin() ? &*w : nullptr, *z, rmode);
+}
+
+// all combinations of values around powers of two where limbs or digits overflow
+void check_native_special() {
+  std::cerr << "check native kernels on special values" << std::endl;
+  std::vector<td::BigInt256> values{td::BigInt256{0}};
+  for (int k : {0, 1, 51, 52, 63, 64, 127, 128, 192, 255, 256}) {
+    for (int d = -1; d <= 1; d++) {
+      for (int sgn : {1, -1}) {
+        td::BigInt256 x;
+        x.set_pow2(k).add_tiny(d).normalize();
+        if (sgn < 0) {
+          x.negate().normalize();
+        }
+        if (x.is_valid() && x.signed_fits_bits(257)) {
+          values.push_back(x);
+        }
+      }
+    }
+  }
+  std::vector<int> shifts{0, 1, 51, 52, 63, 64, 65, 128, 255, 256};
+  size_t n = values.size(), cnt = 0;
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < n; j++) {
+      auto& x = values[i];
+      auto& y = values[j];
+      auto& w = values[(i * 7 + j) % n];
+      for (int rmode = -1; rmode <= 1; rmode++) {
+        for (int shift : shifts) {
+          check_native_shldivmod_on(x, shift, nullptr, y, rmode);
+          check_native_shldivmod_on(x, shift, &w, y, rmode);
+        }
+        for (size_t k = 0; k < n; k++) {
+          check_native_muldivmod_on(x, y, nullptr, values[k], rmode);
+          check_native_muldivmod_on(x, y, &w, values[k], rmode);
+          cnt++;
+        }
+      }
+    }
+  }
+  std::cerr << "checked " << cnt << " combinations of " << n << " values" << std::endl;
+}
+
 void check_random_ops() {
   constexpr long long chk_it = 100000;
   std::cerr << "check random ops (" << iterations << " iterations)" << std::endl;
@@ -830,6 +959,7 @@ void check_random_ops() {
       auto z = make_random_int(zv, zbin);
       //std::cerr << "  */ z = " << z << " = " << zv << " = " << ShowBin(zbin) << " = " << z->as_any_int() << std::endl;
       check_muldivmod_on(x, xv, y, yv, z, zv);
+      check_native_on(x, y, z, make_random_int0(zv, zbin), shift);
     }
   }
 }
@@ -840,11 +970,133 @@ void check_special() {
                BInt::pow2(207) - 1, ll_min);
 }
 
+// random integer of exactly the given bit size, negative if sgn < 0
+td::BigInt256 random_bigint(int bits, int sgn = 1) {
+  td::BigInt256 x{1};
+  for (int i = 1; i < bits; i += 32) {
+    x <<= std::min(32, bits - i);
+    x.add_tiny((long long)(Random() >> (64 - std::min(32, bits - i))));
+    x.normalize();
+  }
+  if (sgn < 0) {
+    x.negate().normalize();
+  }
+  return x;
+}
+
+// the hottest arithmetic opcodes, computed by the generic code as in vm/arithops.cpp and by the native kernels
+class BigIntOpBench : public td::Benchmark {
+ public:
+  enum Op { MulDiv, MulDivMod, LShiftDiv };
+  static constexpr int SHIFT = 128;
+  BigIntOpBench(Op op, bool native, int x_bits, int y_bits, int z_bits)
+      : op_(op), native_(native), x_bits_(x_bits), y_bits_(y_bits), z_bits_(z_bits) {
+    for (int i = 0; i < N; i++) {
+      x_[i] = random_bigint(x_bits, coin() ? 1 : -1);
+      y_[i] = random_bigint(y_bits);
+      z_[i] = random_bigint(z_bits, coin() ? 1 : -1);
+    }
+  }
+  std::string get_description() const override {
+    static const char* names[] = {"MULDIV", "MULDIVMOD", "LSHIFTDIV"};
+    return PSTRING() << names[op_] << " " << x_bits_ << "x" << y_bits_ << "/" << z_bits_
+                     << (native_ ? " native" : " generic");
+  }
+  void run(int n) override {
+    long long sum = 0;
+    for (int i = 0; i < n; i++) {
+      int j = i % N;
+      td::BigInt256 q{0}, r{0};
+      if (native_) {
+        run_native(x_[j], y_[j], z_[j], q, r);
+      } else {
+        run_generic(x_[j], y_[j], z_[j], q, r);
+      }
+      sum += q.as_any_int().digits[0] + r.as_any_int().digits[0];
+    }
+    td::do_not_optimize_away(sum);
+  }
+
+ private:
+  static constexpr int N = 256;
+  Op op_;
+  bool native_;
+  int x_bits_, y_bits_, z_bits_;
+  td::BigInt256 x_[N], y_[N], z_[N];
+
+  void run_native(const td::BigInt256& x, const td::BigInt256& y, const td::BigInt256& z, td::BigInt256& q,
+                  td::BigInt256& r) {
+    bool ok = false;
+    switch (op_) {
+      case MulDiv:
+        ok = td::bigint_native::muldivmod(x, y, nullptr, z, -1, &q, nullptr);
+        r = 0;
+        break;
+      case MulDivMod:
+        ok = td::bigint_native::muldivmod(x, y, nullptr, z, -1, &q, &r);
+        break;
+      case LShiftDiv:
+        ok = td::bigint_native::shldivmod(x, SHIFT, nullptr, z, -1, &q, nullptr);
+        r = 0;
+        break;
+    }
+    CHECK(ok);
+  }
+
+  void run_generic(const td::BigInt256& x, const td::BigInt256& y, const td::BigInt256& z, td::BigInt256& q,
+                   td::BigInt256& r) {
+    DInt tmp{0}, quot;
+    switch (op_) {
+      case MulDiv:
+      case MulDivMod:
+        tmp.add_mul(x, y);
+        tmp.mod_div(z, quot, -1);
+        q = quot.normalize();
+        r = tmp;
+        break;
+      case LShiftDiv:
+        tmp = x;
+        tmp <<= SHIFT;
+        tmp.mod_div(z, quot, -1);
+        q = quot.normalize();
+        r = 0;
+        break;
+    }
+  }
+};
+
+void run_benchmarks() {
+  struct Sizes {
+    int x, y, z;
+  };
+  // 64-bit "small" numbers, 128-bit token amounts and prices, and nearly full width operands
+  for (auto sizes : {Sizes{60, 60, 60}, Sizes{120, 120, 100}, Sizes{250, 250, 250}}) {
+    for (auto op : {BigIntOpBench::MulDiv, BigIntOpBench::MulDivMod, BigIntOpBench::LShiftDiv}) {
+      // keep the quotients within 256 bits
+      int x_bits = sizes.x, y_bits = sizes.y, z_bits = sizes.z;
+      switch (op) {
+        case BigIntOpBench::MulDiv:
+        case BigIntOpBench::MulDivMod:
+          z_bits = std::max(z_bits, x_bits + y_bits - 254);
+          break;
+        case BigIntOpBench::LShiftDiv:
+          x_bits = std::min(x_bits, 254 - BigIntOpBench::SHIFT);
+          break;
+      }
+      bench(BigIntOpBench(op, false, x_bits, y_bits, z_bits));
+      bench(BigIntOpBench(op, true, x_bits, y_bits, z_bits));
+    }
+  }
+}
+
 int main(int argc, char* const argv[]) {
-  bool do_check_shift_ops = false;
+  bool do_check_shift_ops = false, do_run_benchmarks = false;
   int i;
-  while ((i = getopt(argc, argv, "hSs:i:")) != -1) {
+  while ((i = getopt(argc, argv, "hBSs:i:")) != -1) {
     switch (i) {
+      case 'B':
+        do_run_benchmarks = true;
+        break;
       case 'S':
         do_check_shift_ops = true;
         break;
@@ -858,10 +1110,14 @@ int main(int argc, char* const argv[]) {
         std::cerr << "unknown option: " << (char)i << std::endl;
         // fall through
       case 'h':
-        std::cerr << "usage:\t" << argv[0] << " [-S] [-i<random-op-iterations>] [-s<random-seed>]" << std::endl;
+        std::cerr << "usage:\t" << argv[0] << " [-B] [-S] [-i<random-op-iterations>] [-s<random-seed>]" << std::endl;
         return 2;
     }
   }
+  if (do_run_benchmarks) {
+    run_benchmarks();
+    return 0;
+  }
   modint::init();
   init_aux();
   init_check_special_ints();
@@ -871,6 +1127,7 @@ int main(int argc, char* const argv[]) {
     check_shift_ops();
   }
   check_special();
+  check_native_special();
   check_random_ops();
   return 0;
 }
@@ -0,0 +1,168 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "block/mc-config.h"
+#include "vm/dict.h"
+
+#include "td/utils/Random.h"
+#include "td/utils/tests.h"
+
+namespace {
+
+const ton::WorkchainId workchains[] = {-5, -2, 0, 1, 7};
+
+// (BinTree ShardDescr) with random splits up to depth 8
+td::Ref<vm::Cell> gen_shard_tree(ton::ShardIdFull shard, td::Random::Xorshift128plus &rnd, int depth) {
+  vm::CellBuilder cb;
+  if (depth < 8 && rnd.fast(0, 2) == 0) {
+    CHECK(cb.store_bool_bool(true) &&
+          cb.store_ref_bool(gen_shard_tree(ton::shard_child(shard, true), rnd, depth + 1)) &&
+          cb.store_ref_bool(gen_shard_tree(ton::shard_child(shard, false), rnd, depth + 1)));
+    return cb.finalize();
+  }
+  td::Bits256 root_hash, file_hash;
+  rnd.bytes(root_hash.as_slice());
+  rnd.bytes(file_hash.as_slice());
+  auto start_lt = static_cast<ton::LogicalTime>(rnd.fast(1, 1000000));
+  block::McShardHash descr{ton::BlockId{shard, static_cast<ton::BlockSeqno>(rnd.fast(1, 1000000))},
+                           start_lt,
+                           start_lt + rnd.fast(1, 100000),
+                           static_cast<ton::UnixTime>(rnd.fast(1, 1000000)),
+                           root_hash,
+                           file_hash,
+                           {},
+                           {},
+                           1,
+                           1,
+                           static_cast<ton::CatchainSeqno>(rnd.fast(1, 1000))};
+  CHECK(cb.store_bool_bool(false) && descr.pack(cb));
+  return cb.finalize();
+}
+
+td::Ref<vm::Cell> gen_shard_hashes(td::Random::Xorshift128plus &rnd) {
+  vm::Dictionary dict{32};
+  for (auto workchain : workchains) {
+    if (rnd.fast(0, 1)) {
+      vm::CellBuilder cb;
+      CHECK(cb.store_ref_bool(gen_shard_tree(ton::ShardIdFull{workchain}, rnd, 0)));
+      CHECK(dict.set_builder(td::BitArray<32>{workchain}, cb));
+    }
+  }
+  return dict.get_root_cell();
+}
+
+td::Ref<block::McShardHash> gen_mc_hash(td::Random::Xorshift128plus &rnd) {
+  if (rnd.fast(0, 2) == 0) {
+    return {};
+  }
+  // a masterchain block with seqno 0 is not reported by get_shard_hash_ids
+  auto seqno = static_cast<ton::BlockSeqno>(rnd.fast(0, 1) ? rnd.fast(1, 1000000) : 0);
+  return td::Ref<block::McShardHash>(true, ton::BlockId{ton::masterchainId, ton::shardIdAll, seqno}, 1, 2, 3,
+                                     td::Bits256::zero(), td::Bits256::zero());
+}
+
+// both existing shards of a random tree and deeper or shallower shards around them
+ton::ShardIdFull gen_shard(td::Random::Xorshift128plus &rnd) {
+  if (rnd.fast(0, 20) == 0) {
+    return ton::ShardIdFull{ton::masterchainId, rnd.fast(0, 1) ? ton::shardIdAll : rnd() | 1};
+  }
+  ton::WorkchainId workchain = rnd.fast(0, 10) == 0 ? 3 : workchains[rnd.fast(0, 4)];
+  int len = rnd.fast(0, 10);
+  auto low = 1ULL << (63 - len);
+  return ton::ShardIdFull{workchain, (rnd() & ~(2 * low - 1)) | low};
+}
+
+std::string to_str(const std::vector<ton::BlockId> &ids) {
+  td::StringBuilder sb;
+  for (auto &id : ids) {
+    sb << id.to_str() << " ";
+  }
+  return sb.as_cslice().str();
+}
+
+std::string to_str(td::Ref<block::McShardHash> descr) {
+  return descr.is_null() ? "null" : PSTRING() << descr->top_block_id().to_str() << " " << descr->end_lt();
+}
+
+}  // namespace
+
+TEST(ShardTable, Differential) {
+  td::Random::Xorshift128plus rnd{123};
+  for (int t = 0; t < 200; t++) {
+    auto shard_hashes = gen_shard_hashes(rnd);
+    auto mc_hash = gen_mc_hash(rnd);
+    block::ShardConfig dict{shard_hashes, mc_hash};
+    block::ShardConfig table{shard_hashes, mc_hash};
+    ASSERT_TRUE(table.build_shard_table());
+    ASSERT_TRUE(!dict.has_shard_table());
+
+    ASSERT_TRUE(dict.get_workchains() == table.get_workchains());
+    for (ton::WorkchainId workchain = -6; workchain <= 8; workchain++) {
+      ASSERT_EQ(dict.has_workchain(workchain), table.has_workchain(workchain));
+    }
+    ASSERT_EQ(to_str(dict.get_shard_hash_ids()), to_str(table.get_shard_hash_ids()));
+    ASSERT_EQ(to_str(dict.get_shard_hash_ids(true)), to_str(table.get_shard_hash_ids(true)));
+
+    for (int i = 0; i < 500; i++) {
+      auto shard = gen_shard(rnd);
+      ASSERT_EQ(to_str(dict.get_shard_hash(shard, true)), to_str(table.get_shard_hash(shard, true)));
+      ASSERT_EQ(to_str(dict.get_shard_hash(shard, false)), to_str(table.get_shard_hash(shard, false)));
+      ASSERT_EQ(dict.get_shard_cc_seqno(shard), table.get_shard_cc_seqno(shard));
+
+      if (!shard.is_masterchain() || mc_hash.not_null()) {
+        ton::AccountIdPrefixFull account{shard.workchain, rnd()};
+        ton::ShardIdFull dict_shard, table_shard;
+        auto end_lt = dict.get_shard_end_lt_ext(account, dict_shard);
+        ASSERT_EQ(end_lt, table.get_shard_end_lt_ext(account, table_shard));
+        // the actual shard is set only when it is found
+        if (end_lt != 0) {
+          ASSERT_EQ(dict_shard.to_str(), table_shard.to_str());
+        }
+      }
+
+      // the filter must see the same nodes in the same order and prune the same subtrees
+      std::vector<std::pair<ton::ShardIdFull, bool>> dict_calls, table_calls;
+      auto seed = rnd();
+      auto filter = [seed](std::vector<std::pair<ton::ShardIdFull, bool>> &calls) {
+        return [seed, &calls](ton::ShardIdFull shard, bool leaf) {
+          calls.emplace_back(shard, leaf);
+          return (td::uint64(shard.workchain) * 0x9E3779B97F4A7C15ULL ^ shard.shard ^ seed) % 5 != 0;
+        };
+      };
+      ASSERT_EQ(to_str(dict.get_shard_hash_ids(filter(dict_calls))),
+                to_str(table.get_shard_hash_ids(filter(table_calls))));
+      ASSERT_TRUE(dict_calls == table_calls);
+
+      ASSERT_EQ(to_str(dict.get_neighbor_shard_hash_ids(shard)), to_str(table.get_neighbor_shard_hash_ids(shard)));
+      ASSERT_EQ(to_str(dict.get_proper_neighbor_shard_hash_ids(shard)),
+                to_str(table.get_proper_neighbor_shard_hash_ids(shard)));
+      ASSERT_EQ(to_str(dict.get_intersecting_shard_hash_ids(shard)),
+                to_str(table.get_intersecting_shard_hash_ids(shard)));
+    }
+
+    // copies share the table, updates rebuild it
+    block::ShardConfig copy{table};
+    ASSERT_TRUE(copy.has_shard_table());
+    if (dict.new_workchain(3, 1, td::Bits256::zero(), td::Bits256::zero())) {
+      ASSERT_TRUE(copy.new_workchain(3, 1, td::Bits256::zero(), td::Bits256::zero()));
+      ASSERT_TRUE(copy.has_shard_table());
+      ASSERT_TRUE(dict.get_workchains() == copy.get_workchains());
+      ASSERT_EQ(to_str(dict.get_shard_hash_ids()), to_str(copy.get_shard_hash_ids()));
+      ASSERT_EQ(to_str(dict.get_shard_hash(ton::ShardIdFull{3}, true)),
+                to_str(copy.get_shard_hash(ton::ShardIdFull{3}, true)));
+    }
+  }
+}
@@ -196,6 +196,67 @@ void test_bitstring_fill(unsigned n, unsigned p, unsigned k) {
   ASSERT_EQ(td::to_binary(bs), s);
 }
 
+TEST(Cells, transient_arena) {
+  td::Ref<vm::Cell> survivor;
+  {
+    vm::TransientCellArena arena;
+    vm::TransientCellArena::Scope scope{&arena};
+    for (int i = 0; i < 10000; i++) {
+      vm::CellBuilder cb;
+      cb.store_long(i, 32).store_long(i * 3, 64);
+      auto cell = cb.finalize_copy();
+      if (i == 5000) {
+        survivor = cell;
+      }
+    }
+    ASSERT_EQ(10000u, arena.get_allocated_cells());
+    ASSERT_TRUE(arena.get_allocated_chunks() > 1);
+    {
+      vm::TransientCellArena::Scope no_arena{nullptr};
+      vm::CellBuilder().finalize_copy();
+    }
+    ASSERT_EQ(10000u, arena.get_allocated_cells());
+  }
+  // cells surviving the arena are still valid
+  vm::CellSlice cs{vm::NoVm(), survivor};
+  ASSERT_EQ(5000, cs.fetch_long(32));
+  ASSERT_EQ(15000, cs.fetch_long(64));
+}
+
+TEST(Cells, transient_arena_copy_out) {
+  auto heap_cell = vm::CellBuilder().store_long(7, 32).finalize();
+  td::Ref<vm::Cell> root, copy;
+  {
+    vm::TransientCellArena arena;
+    vm::TransientCellArena::Scope scope{&arena};
+    auto leaf = vm::CellBuilder().store_long(1, 32).finalize();
+    auto node = vm::CellBuilder().store_long(2, 32).store_ref(leaf).store_ref(heap_cell).finalize();
+    root = vm::CellBuilder().store_long(3, 32).store_ref(node).store_ref(node).store_ref(leaf).finalize();
+    ASSERT_EQ(3u, arena.get_allocated_cells());
+    copy = vm::TransientCellArena::copy_out(root);
+    ASSERT_EQ(3u, arena.get_allocated_cells());
+  }
+  ASSERT_TRUE(copy.get() != root.get());
+  ASSERT_TRUE(copy->get_hash() == root->get_hash());
+  root = {};
+
+  auto check_heap = [](const td::Ref<vm::Cell>& cell) {
+    auto data_cell = dynamic_cast<const vm::DataCell*>(cell.get());
+    ASSERT_TRUE(data_cell != nullptr);
+    ASSERT_TRUE(!data_cell->is_allocated_in_transient_arena());
+  };
+  check_heap(copy);
+  vm::CellSlice cs{vm::NoVm(), copy};
+  auto node = cs.prefetch_ref(0);
+  check_heap(node);
+  check_heap(cs.prefetch_ref(2));
+  // shared subtrees are copied once, heap cells are not copied at all
+  ASSERT_TRUE(node.get() == cs.prefetch_ref(1).get());
+  vm::CellSlice node_cs{vm::NoVm(), node};
+  ASSERT_TRUE(node_cs.prefetch_ref(0).get() == cs.prefetch_ref(2).get());
+  ASSERT_TRUE(node_cs.prefetch_ref(1).get() == heap_cell.get());
+}
+
 TEST(Bitstrings, main) {
   os = create_ss();
   auto test = td::BitSlice{(const unsigned char*)"test", 32};
@@ -672,8 +672,62 @@ TEST(Cell, MerkleProof) {
     auto virtualized_proof2 = MerkleProof::virtualize(proof2, 1);
     auto exploration4 = CellExplorer::explore(virtualized_proof2, exploration.ops);
     ASSERT_EQ(exploration.log, exploration4.log);
+
+    CellUsageSet usage_set;
+    {
+      CellUsageSet::Scope scope{&usage_set};
+      auto exploration5 = CellExplorer::explore(cell, exploration.ops);
+      ASSERT_EQ(exploration.log, exploration5.log);
+    }
+    auto proof3 = MerkleProof::generate(cell, usage_set);
+    auto virtualized_proof3 = MerkleProof::virtualize(proof3, 1);
+    auto exploration6 = CellExplorer::explore(virtualized_proof3, exploration.ops);
+    ASSERT_EQ(exploration.log, exploration6.log);
+  }
+};
+
+class BenchMerkleProofGenerate : public td::Benchmark {
+ public:
+  explicit BenchMerkleProofGenerate(bool use_usage_set) : use_usage_set_(use_usage_set) {
+    td::Random::Xorshift128plus rnd{123};
+    for (int i = 0; i < 16; i++) {
+      auto cell = gen_random_cell(rnd.fast(100, 1000), rnd, false);
+      auto exploration = CellExplorer::random_explore(cell, rnd);
+      samples_.emplace_back(std::move(cell), std::move(exploration.ops));
+    }
+  }
+  std::string get_description() const override {
+    return PSTRING() << "MerkleProof::generate via " << (use_usage_set_ ? "CellUsageSet" : "CellUsageTree");
   }
+
+  void run(int n) override {
+    for (int i = 0; i < n; i++) {
+      auto &sample = samples_[i % samples_.size()];
+      Ref<Cell> proof;
+      if (use_usage_set_) {
+        CellUsageSet usage_set;
+        {
+          CellUsageSet::Scope scope{&usage_set};
+          CellExplorer::explore(sample.first, sample.second);
+        }
+        proof = MerkleProof::generate(sample.first, usage_set);
+      } else {
+        auto usage_tree = std::make_shared<CellUsageTree>();
+        CellExplorer::explore(UsageCell::create(sample.first, usage_tree->root_ptr()), sample.second);
+        proof = MerkleProof::generate(sample.first, usage_tree.get());
+      }
+      CHECK(proof.not_null());
+    }
+  }
+
+ private:
+  bool use_usage_set_;
+  std::vector<std::pair<Ref<Cell>, std::vector<CellExplorer::Op>>> samples_;
 };
+TEST(Cell, BenchMerkleProofGenerate) {
+  td::bench(BenchMerkleProofGenerate(false));
+  td::bench(BenchMerkleProofGenerate(true));
+}
 
 TEST(Cell, MerkleProofCombine) {
   td::Random::Xorshift128plus rnd{123};
@@ -24,6 +24,7 @@
 #include "vm/excno.hpp"
 #include "vm/vm.h"
 #include "common/bigint.hpp"
+#include "common/bigint-native.h"
 #include "common/refint.h"
 
 namespace vm {
@@ -431,6 +432,16 @@ std::string dump_shrmod(CellSlice&, unsigned args, int mode) {
   return os.str();
 }
 
+// the native kernels produce only results fitting into 257 bits, so the quiet mode does not matter here
+static void push_native_divmod_results(Stack& stack, unsigned d, const td::BigInt256& q, const td::BigInt256& r) {
+  if (d & 1) {
+    stack.push_int(td::make_refint(q));
+  }
+  if (d & 2) {
+    stack.push_int(td::make_refint(r));
+  }
+}
+
 int exec_muldivmod(VmState* st, unsigned args, int quiet) {
   int round_mode = (int)(args & 3) - 1;
   unsigned d = (args >> 2) & 3;
@@ -449,12 +460,17 @@ int exec_muldivmod(VmState* st, unsigned args, int quiet) {
   auto w = add ? stack.pop_int() : td::RefInt256{};
   auto y = stack.pop_int();
   auto x = stack.pop_int();
+  td::BigInt256 q, r;
+  if (td::bigint_native::muldivmod(*x, *y, add ? &*w : nullptr, *z, round_mode, d & 1 ? &q : nullptr,
+                                   d & 2 ? &r : nullptr)) {
+    push_native_divmod_results(stack, d, q, r);
+    return 0;
+  }
   typename td::BigInt256::DoubleInt tmp{0}, quot;
   if (add) {
     tmp = *w;
   }
   tmp.add_mul(*x, *y);
-  auto q = td::make_refint();
   tmp.mod_div(*z, quot, round_mode);
   switch (d) {
     case 1:
@@ -619,6 +635,12 @@ int exec_shldivmod(VmState* st, unsigned args, int mode) {
   auto z = stack.pop_int();
   auto w = add ? stack.pop_int() : td::RefInt256{};
   auto x = stack.pop_int();
+  td::BigInt256 q, r;
+  if (td::bigint_native::shldivmod(*x, y, add ? &*w : nullptr, *z, round_mode, d & 1 ? &q : nullptr,
+                                   d & 2 ? &r : nullptr)) {
+    push_native_divmod_results(stack, d, q, r);
+    return 0;
+  }
   typename td::BigInt256::DoubleInt tmp{*x}, quot;
   tmp <<= y;
   if (add) {
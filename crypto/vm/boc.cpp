@@ -91,6 +91,9 @@ td::Result<Ref<DataCell>> CellSerializationInfo::create_data_cell(td::Slice cell
                                                                   td::Span<Ref<Cell>> refs) const {
   DCHECK(refs_cnt == (td::int64)refs.size());
   TRY_RESULT(bits, get_bits(cell_slice));
+  // cells loaded from a bag of cells or from the database are usually cached for long,
+  // they must not keep chunks of a transient arena alive
+  TransientCellArena::Scope no_transient_arena{nullptr};
   TRY_RESULT(res, DataCell::create(cell_slice.substr(data_offset), bits, refs, special));
   CHECK(!res.is_null());
   if (res->is_special() != special) {
@@ -22,6 +22,7 @@
 #include "vm/opctable.h"
 #include "vm/stack.hpp"
 #include "vm/excno.hpp"
+#include "vm/cells/CellUsageSet.h"
 #include "vm/vmstate.h"
 #include "vm/vm.h"
 #include "common/bigint.hpp"
@@ -894,6 +895,9 @@ int exec_load_special_cell(VmState* st, bool quiet) {
   auto cell = stack.pop_cell();
   if (st->get_global_version() >= 5) {
     st->register_cell_load(cell->get_hash());
+    if (auto usage_set = CellUsageSet::current()) {
+      usage_set->insert(cell->get_hash());
+    }
     auto r_loaded_cell = cell->load_cell();
     if (r_loaded_cell.is_error()) {
       if (quiet) {
@@ -17,6 +17,7 @@
     Copyright 2017-2020 Telegram Systems LLP
 */
 #include "vm/cells/CellSlice.h"
+#include "vm/cells/CellUsageSet.h"
 #include "vm/excno.hpp"
 #include "td/utils/bits.h"
 #include "td/utils/misc.h"
@@ -45,6 +46,9 @@ CellSlice::CellSlice() : bits_st(0), refs_st(0), bits_en(0), refs_en(0), ptr(0),
 
 namespace {
 Cell::LoadedCell load_cell_nothrow(const Ref<Cell>& ref) {
+  if (auto usage_set = CellUsageSet::current()) {
+    usage_set->insert(ref->get_hash());
+  }
   auto res = ref->load_cell();
   if (res.is_ok()) {
     auto ld = res.move_as_ok();
@@ -55,6 +59,9 @@ Cell::LoadedCell load_cell_nothrow(const Ref<Cell>& ref) {
 }
 
 Cell::LoadedCell load_cell_nothrow(const Ref<Cell>& ref, int mode) {
+  if (auto usage_set = CellUsageSet::current()) {
+    usage_set->insert(ref->get_hash());
+  }
   auto res = ref->load_cell();
   if (res.is_ok()) {
     auto ld = res.move_as_ok();
@@ -1077,6 +1084,9 @@ VirtualCell::LoadedCell load_cell_slice_impl(Ref<Cell> cell, bool* can_be_specia
     if (vm_state_interface && !library_loaded) {
       vm_state_interface->register_cell_load(cell->get_hash());
     }
+    if (auto usage_set = CellUsageSet::current()) {
+      usage_set->insert(cell->get_hash());
+    }
     auto r_loaded_cell = cell->load_cell();
     if (r_loaded_cell.is_error()) {
       throw VmError{Excno::cell_und, "failed to load cell"};
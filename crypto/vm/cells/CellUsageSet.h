@@ -0,0 +1,73 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "vm/cells/CellHash.h"
+
+#include "td/utils/HashSet.h"
+
+namespace vm {
+
+// A lightweight alternative to CellUsageTree + UsageCell for building Merkle proofs.
+// While a Scope is active in a thread, hashes of all cells loaded by this thread (via CellSlice, load_cell_slice and
+// TVM cell loading) are recorded into the set; cells are not wrapped, so reading the original tree costs only
+// a hash set insertion per load. MerkleProof::generate(root, usage_set) keeps loaded cells and prunes the others.
+// Unlike CellUsageTree, a cell is identified by its hash, not by its path from the root: loads of unrelated cells
+// (or of the same cell elsewhere) only make the proof larger, never invalid.
+class CellUsageSet {
+ public:
+  bool contains(const CellHash& hash) const {
+    return hashes_.count(hash) != 0;
+  }
+  size_t size() const {
+    return hashes_.size();
+  }
+  void clear() {
+    hashes_.clear();
+  }
+
+  void insert(const CellHash& hash) {
+    hashes_.insert(hash);
+  }
+
+  static CellUsageSet* current() {
+    return current_;
+  }
+
+  // records loads into the set in this thread until the end of scope; nullptr stops recording
+  class Scope {
+   public:
+    explicit Scope(CellUsageSet* usage_set) : prev_(current_) {
+      current_ = usage_set;
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() {
+      current_ = prev_;
+    }
+
+   private:
+    CellUsageSet* prev_;
+  };
+
+ private:
+  td::HashSet<CellHash> hashes_;
+
+  static thread_local CellUsageSet* current_;
+};
+
+}  // namespace vm
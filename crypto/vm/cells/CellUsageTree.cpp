@@ -17,9 +17,12 @@
     Copyright 2017-2020 Telegram Systems LLP
 */
 #include "vm/cells/CellUsageTree.h"
+#include "vm/cells/CellUsageSet.h"
 #include "DataCell.h"
 
 namespace vm {
+thread_local CellUsageSet* CellUsageSet::current_ = nullptr;
+
 //
 // CellUsageTree::NodePtr
 //
@@ -351,9 +351,19 @@ td::Result<Ref<DataCell>> DataCell::create(td::Slice data, int bit_length, td::S
   auto level_info_size = sizeof(detail::LevelInfo) * (checker.level_mask().get_level() + 1);
   auto cell_size = sizeof(DataCell) + level_info_size + (bit_length + 7) / 8;
 
-  void* storage = use_arena ? allocate_in_arena(cell_size) : ::operator new(cell_size);
-  DataCell* allocated_cell = new (storage)
-      DataCell{bit_length, refs.size(), checker.type(), checker.level_mask(), use_arena, checker.virtualization()};
+  void* storage = nullptr;
+  auto transient_arena = TransientCellArena::current();
+  if (use_arena) {
+    storage = allocate_in_arena(cell_size);
+  } else if (transient_arena) {
+    storage = transient_arena->allocate(cell_size);
+  }
+  bool in_transient_arena = !use_arena && storage;
+  if (!storage) {
+    storage = ::operator new(cell_size);
+  }
+  DataCell* allocated_cell = new (storage) DataCell{
+      bit_length, refs.size(), checker.type(), checker.level_mask(), use_arena, in_transient_arena, checker.virtualization()};
   auto& cell = *allocated_cell;
 
   auto mutable_data = cell.trailer_ + level_info_size;
@@ -443,13 +453,14 @@ std::string DataCell::to_hex() const {
 }
 
 DataCell::DataCell(int bit_length, size_t refs_cnt, Cell::SpecialType type, LevelMask level_mask,
-                   bool allocated_in_arena, td::uint8 virtualization)
+                   bool allocated_in_arena, bool allocated_in_transient_arena, td::uint8 virtualization)
     : bit_length_(bit_length)
     , refs_cnt_(static_cast<td::uint8>(refs_cnt))
     , type_(static_cast<td::uint8>(type))
     , level_(static_cast<td::uint8>(level_mask.get_level()))
     , level_mask_(level_mask.get_mask())
     , allocated_in_arena_(allocated_in_arena)
+    , allocated_in_transient_arena_(allocated_in_transient_arena)
     , virtualization_(virtualization) {
   get_thread_safe_counter().add(1);
 }
@@ -21,6 +21,7 @@
 #include "td/utils/Span.h"
 #include "td/utils/ThreadSafeCounter.h"
 #include "vm/cells/Cell.h"
+#include "vm/cells/TransientCellArena.h"
 
 namespace vm {
 
@@ -36,6 +37,7 @@ struct LevelInfo {
 class DataCell final : public Cell {
  public:
   // NB: cells created with use_arena=true are never freed
+  // (otherwise, cells are allocated in TransientCellArena::current() if there is one)
   static thread_local bool use_arena;
 
   static td::Result<Ref<DataCell>> create(td::Slice data, int bit_length, td::Span<Ref<Cell>> refs, bool is_special);
@@ -50,8 +52,11 @@ class DataCell final : public Cell {
 
   void operator delete(DataCell* ptr, std::destroying_delete_t) {
     bool allocated_in_arena = ptr->allocated_in_arena_;
+    bool allocated_in_transient_arena = ptr->allocated_in_transient_arena_;
     ptr->~DataCell();
-    if (!allocated_in_arena) {
+    if (allocated_in_transient_arena) {
+      TransientCellArena::deallocate(ptr);
+    } else if (!allocated_in_arena) {
       ::operator delete(ptr);
     }
   }
@@ -136,6 +141,10 @@ class DataCell final : public Cell {
     return static_cast<SpecialType>(type_);
   }
 
+  bool is_allocated_in_transient_arena() const {
+    return allocated_in_transient_arena_;
+  }
+
   int get_serialized_size(bool with_hashes = false) const {
     return ((get_bits() + 23) >> 3) +
            (with_hashes ? get_level_mask().get_hashes_count() * (hash_bytes + depth_bytes) : 0);
@@ -169,7 +178,7 @@ class DataCell final : public Cell {
   }
 
   DataCell(int bit_length, size_t refs_cnt, Cell::SpecialType type, LevelMask level_mask, bool allocated_in_arena,
-           td::uint8 virtualization);
+           bool allocated_in_transient_arena, td::uint8 virtualization);
 
   detail::LevelInfo const* level_info() const {
     return reinterpret_cast<detail::LevelInfo const*>(trailer_);
@@ -197,6 +206,7 @@ class DataCell final : public Cell {
   unsigned level_ : 3;
   unsigned level_mask_ : 3;
   unsigned allocated_in_arena_ : 1;
+  unsigned allocated_in_transient_arena_ : 1;
   unsigned virtualization_ : 8;
 
   std::array<Ref<Cell>, max_refs> refs_{};
@@ -107,6 +107,11 @@ Ref<Cell> MerkleProof::generate_raw(Ref<Cell> cell, CellUsageTree *usage_tree) {
   return detail::MerkleProofImpl(usage_tree).create_from(cell);
 }
 
+Ref<Cell> MerkleProof::generate_raw(Ref<Cell> cell, const CellUsageSet &usage_set) {
+  return detail::MerkleProofImpl([&](const Ref<Cell> &cell) { return !usage_set.contains(cell->get_hash()); })
+      .create_from(cell);
+}
+
 Ref<Cell> MerkleProof::virtualize_raw(Ref<Cell> cell, Cell::VirtualizationParameters virt) {
   return cell->virtualize(virt);
 }
@@ -132,6 +137,18 @@ Ref<Cell> MerkleProof::generate(Ref<Cell> cell, CellUsageTree *usage_tree) {
   return CellBuilder::create_merkle_proof(std::move(raw));
 }
 
+Ref<Cell> MerkleProof::generate(Ref<Cell> cell, const CellUsageSet &usage_set) {
+  int cell_level = cell->get_level();
+  if (cell_level != 0) {
+    return {};
+  }
+  auto raw = generate_raw(std::move(cell), usage_set);
+  if (raw.is_null()) {
+    return {};
+  }
+  return CellBuilder::create_merkle_proof(std::move(raw));
+}
+
 td::Result<Ref<Cell>> unpack_proof(Ref<Cell> cell) {
   CHECK(cell.not_null());
   td::uint8 level = static_cast<td::uint8>(cell->get_level());
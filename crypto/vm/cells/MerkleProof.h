@@ -18,6 +18,7 @@
 */
 #pragma once
 #include "vm/cells/Cell.h"
+#include "vm/cells/CellUsageSet.h"
 #include "td/utils/buffer.h"
 
 #include <utility>
@@ -33,6 +34,7 @@ class MerkleProof {
   // cells must have zero level
   static Ref<Cell> generate(Ref<Cell> cell, IsPrunnedFunction is_prunned);
   static Ref<Cell> generate(Ref<Cell> cell, CellUsageTree *usage_tree);
+  static Ref<Cell> generate(Ref<Cell> cell, const CellUsageSet &usage_set);
 
   // cell must have zero level and must be a MerkleProof
   static Ref<Cell> virtualize(Ref<Cell> cell, int virtualization);
@@ -47,6 +49,7 @@ class MerkleProof {
   // works fine with cell of non-zero level, but this is not supported (yet?) in MerkeProof special cell
   static Ref<Cell> generate_raw(Ref<Cell> cell, IsPrunnedFunction is_prunned);
   static Ref<Cell> generate_raw(Ref<Cell> cell, CellUsageTree *usage_tree);
+  static Ref<Cell> generate_raw(Ref<Cell> cell, const CellUsageSet &usage_set);
   static Ref<Cell> virtualize_raw(Ref<Cell> cell, Cell::VirtualizationParameters virt);
   static Ref<Cell> combine_raw(Ref<Cell> a, Ref<Cell> b);
   static Ref<Cell> combine_fast_raw(Ref<Cell> a, Ref<Cell> b);
@@ -0,0 +1,109 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "vm/cells/TransientCellArena.h"
+#include "vm/cells/DataCell.h"
+
+#include "td/utils/ThreadSafeCounter.h"
+
+#include <map>
+#include <new>
+
+namespace vm {
+
+namespace {
+td::NamedThreadSafeCounter::CounterRef get_chunk_counter() {
+  static auto res = td::NamedThreadSafeCounter::get_default().get_counter("TransientCellArenaChunk");
+  return res;
+}
+
+td::Ref<Cell> copy_out_impl(td::Ref<Cell> cell, std::map<const Cell*, td::Ref<Cell>>& copied) {
+  auto data_cell = dynamic_cast<const DataCell*>(cell.get());
+  if (!data_cell || !data_cell->is_allocated_in_transient_arena()) {
+    return cell;
+  }
+  auto it = copied.find(data_cell);
+  if (it != copied.end()) {
+    return it->second;
+  }
+  std::array<td::Ref<Cell>, Cell::max_refs> refs;
+  for (unsigned i = 0; i < data_cell->get_refs_cnt(); i++) {
+    refs[i] = copy_out_impl(data_cell->get_ref(i), copied);
+  }
+  // the copy of a valid cell is valid, so create() cannot fail
+  td::Ref<Cell> copy = DataCell::create(td::Slice{data_cell->get_data(), (data_cell->get_bits() + 7) / 8},
+                                        data_cell->get_bits(),
+                                        td::Span<td::Ref<Cell>>{refs.data(), data_cell->get_refs_cnt()},
+                                        data_cell->is_special())
+                           .move_as_ok();
+  DCHECK(copy->get_hash() == data_cell->get_hash());
+  copied.emplace(data_cell, copy);
+  return copy;
+}
+}  // namespace
+
+thread_local TransientCellArena* TransientCellArena::current_ = nullptr;
+
+TransientCellArena::~TransientCellArena() {
+  if (chunk_) {
+    release_chunk(chunk_);
+  }
+}
+
+void* TransientCellArena::allocate(size_t size) {
+  constexpr size_t header_size = (sizeof(ChunkHeader) + 7) / 8 * 8;
+  auto aligned_size = (size + 7) / 8 * 8;
+  if (aligned_size > (chunk_size - header_size) / 4) {
+    return nullptr;
+  }
+  if (!chunk_ || pos_ + aligned_size > chunk_size) {
+    if (chunk_) {
+      release_chunk(chunk_);
+    }
+    // chunks are aligned by their size, so deallocate() finds the header of a chunk by a cell pointer
+    void* storage = ::operator new(chunk_size, std::align_val_t{chunk_size});
+    chunk_ = new (storage) ChunkHeader{1};
+    pos_ = header_size;
+    allocated_chunks_++;
+    get_chunk_counter().add(1);
+  }
+  chunk_->refs.fetch_add(1, std::memory_order_relaxed);
+  auto res = reinterpret_cast<char*>(chunk_) + pos_;
+  pos_ += aligned_size;
+  allocated_cells_++;
+  return res;
+}
+
+td::Ref<Cell> TransientCellArena::copy_out(td::Ref<Cell> cell) {
+  Scope no_transient_arena{nullptr};
+  std::map<const Cell*, td::Ref<Cell>> copied;
+  return copy_out_impl(std::move(cell), copied);
+}
+
+void TransientCellArena::deallocate(void* ptr) {
+  auto chunk = reinterpret_cast<ChunkHeader*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(chunk_size - 1));
+  release_chunk(chunk);
+}
+
+void TransientCellArena::release_chunk(ChunkHeader* chunk) {
+  if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    chunk->~ChunkHeader();
+    ::operator delete(chunk, std::align_val_t{chunk_size});
+    get_chunk_counter().add(-1);
+  }
+}
+
+}  // namespace vm
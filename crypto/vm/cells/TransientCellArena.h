@@ -0,0 +1,96 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "common/refcnt.hpp"
+#include "td/utils/common.h"
+
+#include <atomic>
+
+namespace vm {
+
+class Cell;
+
+// Opt-in bump allocator for DataCells; nothing in the node enables it.
+// While a Scope is active in a thread, DataCell::create() takes memory from chunks of the arena instead of
+// calling ::operator new for every cell. Cell hashing dominates cell creation, so this only pays off where
+// profiles show the heap allocator itself as the bottleneck.
+// Every chunk counts the cells allocated in it; a chunk is freed as a whole when its last cell is destroyed
+// and the arena has moved on to another chunk (or was destroyed). Cells that outlive the arena stay valid,
+// but each of them keeps its whole chunk alive, so cells handed over to long-lived owners must be moved
+// to the heap with copy_out() first.
+// Allocation is single-threaded (by the owner of the scope), cells may be destroyed in any thread.
+class TransientCellArena {
+ public:
+  static constexpr size_t chunk_size = 1 << 16;
+
+  TransientCellArena() = default;
+  TransientCellArena(const TransientCellArena&) = delete;
+  TransientCellArena& operator=(const TransientCellArena&) = delete;
+  ~TransientCellArena();
+
+  // returns nullptr if the size is too big for a chunk; then the cell must be allocated in heap
+  void* allocate(size_t size);
+  static void deallocate(void* ptr);
+
+  static TransientCellArena* current() {
+    return current_;
+  }
+
+  // returns a tree with the same hash where all cells allocated in transient arenas are replaced by heap copies;
+  // other cells (e.g. loaded from the database) are shared, not copied
+  static td::Ref<Cell> copy_out(td::Ref<Cell> cell);
+
+  size_t get_allocated_cells() const {
+    return allocated_cells_;
+  }
+  size_t get_allocated_chunks() const {
+    return allocated_chunks_;
+  }
+
+  // makes the arena current in this thread until the end of scope; nullptr disables arena allocation
+  class Scope {
+   public:
+    explicit Scope(TransientCellArena* arena) : prev_(current_) {
+      current_ = arena;
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() {
+      current_ = prev_;
+    }
+
+   private:
+    TransientCellArena* prev_;
+  };
+
+ private:
+  struct ChunkHeader {
+    std::atomic<td::uint32> refs;  // cells allocated in the chunk + 1 while the arena allocates from it
+  };
+
+  static void release_chunk(ChunkHeader* chunk);
+
+  ChunkHeader* chunk_ = nullptr;
+  size_t pos_ = 0;
+  size_t allocated_cells_ = 0;
+  size_t allocated_chunks_ = 0;
+
+  static thread_local TransientCellArena* current_;
+};
+
+}  // namespace vm
@@ -16,6 +16,7 @@ struct TransactionEmulationParams {
   bool is_tick_tock;
   bool is_tock;
   bool debug_enabled;
+  bool native_contracts_enabled;
 };
 
 td::Result<TransactionEmulationParams> decode_transaction_emulation_params(const char* json) {
@@ -44,6 +45,9 @@ td::Result<TransactionEmulationParams> decode_transaction_emulation_params(const
   TRY_RESULT(debug_enabled, td::get_json_object_bool_field(obj, "debug_enabled", false));
   params.debug_enabled = debug_enabled;
 
+  TRY_RESULT(native_contracts_enabled, td::get_json_object_bool_field(obj, "native_contracts_enabled", true, false));
+  params.native_contracts_enabled = native_contracts_enabled;
+
   TRY_RESULT(is_tick_tock, td::get_json_object_bool_field(obj, "is_tick_tock", true, false));
   params.is_tick_tock = is_tick_tock;
 
@@ -216,6 +220,7 @@ const char *emulate_with_emulator(void* em, const char* libs, const char* accoun
         !transaction_emulator_set_unixtime(em, decoded_params.utime) ||
         !transaction_emulator_set_ignore_chksig(em, decoded_params.ignore_chksig) ||
         !transaction_emulator_set_debug_enabled(em, decoded_params.debug_enabled) ||
+        !transaction_emulator_set_native_contracts_enabled(em, decoded_params.native_contracts_enabled) ||
         !rand_seed_set ||
         !prev_blocks_set) {
         transaction_emulator_destroy(em);
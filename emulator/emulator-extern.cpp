@@ -383,6 +383,14 @@ bool transaction_emulator_set_debug_enabled(void *transaction_emulator, bool deb
   return true;
 }
 
+bool transaction_emulator_set_native_contracts_enabled(void *transaction_emulator, bool native_contracts_enabled) {
+  auto emulator = static_cast<emulator::TransactionEmulator *>(transaction_emulator);
+
+  emulator->set_native_contracts_enabled(native_contracts_enabled);
+
+  return true;
+}
+
 bool transaction_emulator_set_prev_blocks_info(void *transaction_emulator, const char* info_boc) {
   auto emulator = static_cast<emulator::TransactionEmulator *>(transaction_emulator);
 
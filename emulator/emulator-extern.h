@@ -87,6 +87,15 @@ EMULATOR_EXPORT bool transaction_emulator_set_libs(void *transaction_emulator, c
  */
 EMULATOR_EXPORT bool transaction_emulator_set_debug_enabled(void *transaction_emulator, bool debug_enabled);
 
+/**
+ * @brief Enable or disable native execution of well-known contracts (wallets) instead of TVM.
+ * Results, including gas usage and the number of TVM steps, are the same as in TVM.
+ * @param transaction_emulator Pointer to TransactionEmulator object
+ * @param native_contracts_enabled Whether native implementations should be used
+ * @return true in case of success, false in case of error
+ */
+EMULATOR_EXPORT bool transaction_emulator_set_native_contracts_enabled(void *transaction_emulator, bool native_contracts_enabled);
+
 /**
  * @brief Set tuple of previous blocks (13th element of c7)
  * @param transaction_emulator Pointer to TransactionEmulator object
@@ -11,8 +11,15 @@
 #include "td/utils/JsonBuilder.h"
 
 #include "smc-envelope/WalletV3.h"
+#include "smc-envelope/SmartContractCode.h"
+
+#include "block/precompiled-smc/PrecompiledSmartContract.h"
 
 #include "emulator/emulator-extern.h"
+#include "emulator/transaction-emulator.h"
+
+#include "td/utils/benchmark.h"
+#include "td/utils/Random.h"
 
 // testnet config as of 27.06.24
 const char *config_boc = "te6cckICAl8AAQAANecAAAIBIAABAAICAtgAAwAEAgL1AA0ADgIBIAAFAAYCAUgCPgI/AgEgAAcACAIBSAAJAAoCASAAHgAfAgEgAGUAZgIBSAALAAwCAWoA0gDTAQFI"
@@ -455,3 +462,295 @@ TEST(Emulator, tvm_emulator_extra_currencies) {
   CHECK(ec_balance[100] == 20000);
   CHECK(ec_balance[200] == 1);
 }
+
+namespace {
+
+// Native (precompiled) wallets must produce exactly the same transactions as TVM.
+// Transactions are recorded by the TVM emulator and replayed by the emulator with native contracts enabled;
+// TransactionEmulator::emulate_transaction() checks that the transaction and the new account state are the same.
+class NativeWalletTester {
+ public:
+  enum WalletType { WalletV3R2, WalletV4R2, HighloadWalletV2R2 };
+
+  explicit NativeWalletTester(WalletType type) : type_(type) {
+    tvm_emulator_ = create_emulator(false);
+    native_emulator_ = create_emulator(true);
+    private_key_ = td::Ed25519::generate_private_key().move_as_ok();
+    public_key_.as_slice().copy_from(private_key_.get_public_key().move_as_ok().as_octet_string());
+    subwallet_id_ = td::Random::fast(0, 1000000);
+    vm::CellBuilder cb;
+    switch (type_) {
+      case WalletV3R2:
+        code_ = ton::SmartContractCode::get_code(ton::SmartContractCode::WalletV3, 2);
+        cb.store_long(seqno_, 32).store_long(subwallet_id_, 32).store_bytes(public_key_.as_slice());
+        break;
+      case WalletV4R2:
+        code_ = ton::SmartContractCode::get_code(ton::SmartContractCode::WalletV4, 2);
+        cb.store_long(seqno_, 32).store_long(subwallet_id_, 32).store_bytes(public_key_.as_slice()).store_zeroes(1);
+        break;
+      case HighloadWalletV2R2:
+        code_ = ton::SmartContractCode::get_code(ton::SmartContractCode::HighloadWalletV2, 2);
+        cb.store_long(subwallet_id_, 32).store_long(0, 64).store_bytes(public_key_.as_slice()).store_zeroes(1);
+        break;
+    }
+    auto init_state = ton::GenericAccount::get_init_state(code_, cb.finalize());
+    address_ = ton::GenericAccount::get_address(ton::basechainId, init_state);
+    auto account_root = vm::CellBuilder().store_zeroes(1).finalize();  // account_none$0
+    shard_account_ = vm::CellBuilder().store_ref(account_root).store_zeroes(256).store_long(0, 64).finalize();
+    CHECK(run(create_int_message(vm::CellBuilder().finalize(), false, init_state)));
+  }
+
+  ton::UnixTime get_now() const {
+    return now_;
+  }
+
+  block::Account get_account() const {
+    block::gen::ShardAccount::Record shard_account;
+    CHECK(tlb::unpack_cell(shard_account_, shard_account));
+    block::Account account(address_.workchain, address_.addr.bits());
+    if (block::gen::t_Account.get_tag(vm::load_cell_slice(shard_account.account)) == block::gen::Account::account_none) {
+      CHECK(account.init_new(now_));
+      account.last_trans_lt_ = shard_account.last_trans_lt;
+      account.last_trans_hash_ = shard_account.last_trans_hash;
+    } else {
+      CHECK(account.unpack(vm::load_cell_slice_ref(shard_account_), now_, false));
+    }
+    return account;
+  }
+
+  // runs the message in both emulators, commits the result of TVM
+  // returns false if the external message was not accepted
+  bool run(td::Ref<vm::Cell> msg) {
+    now_ += td::Random::fast(1, 100);
+    lt_ += 1000000;
+    auto tvm_res = tvm_emulator_->emulate_transaction(get_account(), msg, now_, lt_,
+                                                      block::transaction::Transaction::tr_ord);
+    if (tvm_res.is_error()) {
+      // e.g. an external message to a wallet drained by mode 128
+      CHECK(native_emulator_->emulate_transaction(get_account(), msg, now_, lt_,
+                                                  block::transaction::Transaction::tr_ord).is_error());
+      return false;
+    }
+    auto tvm_emulation = tvm_res.move_as_ok();
+    if (auto tvm_not_accepted = dynamic_cast<emulator::TransactionEmulator::EmulationExternalNotAccepted *>(
+            tvm_emulation.get())) {
+      auto native_res = native_emulator_->emulate_transaction(get_account(), msg, now_, lt_,
+                                                              block::transaction::Transaction::tr_ord);
+      LOG_CHECK(native_res.is_ok()) << native_res.error();
+      auto native_not_accepted = dynamic_cast<emulator::TransactionEmulator::EmulationExternalNotAccepted *>(
+          native_res.ok().get());
+      CHECK(native_not_accepted != nullptr);
+      CHECK(native_not_accepted->vm_exit_code == tvm_not_accepted->vm_exit_code);
+      return false;
+    }
+    auto tvm_success = dynamic_cast<emulator::TransactionEmulator::EmulationSuccess *>(tvm_emulation.get());
+    CHECK(tvm_success != nullptr);
+    auto native_res = native_emulator_->emulate_transaction(get_account(), tvm_success->transaction);
+    LOG_CHECK(native_res.is_ok()) << native_res.error();
+    shard_account_ = vm::CellBuilder()
+                         .store_ref(tvm_success->account.total_state)
+                         .store_bits(tvm_success->account.last_trans_hash_.as_bitslice())
+                         .store_long(tvm_success->account.last_trans_lt_, 64)
+                         .finalize();
+    if (get_compute_phase_exit_code(tvm_success->transaction) == 0) {
+      // successful transactions generated by this test never fall back to TVM
+      CHECK(td::begins_with(native_res.ok().vm_log, "Running precompiled smart contract"));
+      bool is_external = block::gen::t_CommonMsgInfo.get_tag(vm::load_cell_slice(msg)) ==
+                         block::gen::CommonMsgInfo::ext_in_msg_info;
+      if (is_external) {
+        seqno_++;
+      }
+    }
+    return true;
+  }
+
+  td::Ref<vm::Cell> create_int_message(td::Ref<vm::Cell> body, bool bounced = false,
+                                       td::Ref<vm::Cell> init_state = {}) const {
+    block::gen::Message::Record message;
+    block::gen::CommonMsgInfo::Record_int_msg_info msg_info;
+    msg_info.ihr_disabled = true;
+    msg_info.bounce = false;
+    msg_info.bounced = bounced;
+    msg_info.src = block::tlb::t_MsgAddressInt.pack_std_address(ton::basechainId, td::Bits256::zero());
+    msg_info.dest = block::tlb::t_MsgAddressInt.pack_std_address(address_);
+    CHECK(block::CurrencyCollection{10 * Ton}.pack_to(msg_info.value));
+    vm::CellBuilder cb;
+    CHECK(block::tlb::t_Grams.store_integer_value(cb, td::BigInt256(0)));
+    msg_info.fwd_fee = msg_info.ihr_fee = cb.as_cellslice_ref();
+    msg_info.created_lt = 0;
+    msg_info.created_at = 0;
+    CHECK(tlb::csr_pack(message.info, msg_info));
+    if (init_state.not_null()) {
+      message.init = vm::CellBuilder().store_ones(1).store_zeroes(1).append_cellslice(vm::load_cell_slice(init_state))
+                         .as_cellslice_ref();
+    } else {
+      message.init = vm::CellBuilder().store_zeroes(1).as_cellslice_ref();
+    }
+    message.body = vm::CellBuilder().store_ones(1).store_ref(std::move(body)).as_cellslice_ref();
+    td::Ref<vm::Cell> msg;
+    CHECK(tlb::type_pack_cell(msg, block::gen::t_Message_Any, message));
+    return msg;
+  }
+
+  // an ordinary transfer with random modes, or a broken one (errors are chosen by `fault`)
+  td::Ref<vm::Cell> create_ext_message(int messages, int fault = 0) {
+    vm::CellBuilder cb;
+    td::uint32 valid_until = fault == 1 ? now_ : now_ + 1000;
+    td::uint32 seqno = fault == 2 ? seqno_ + 1 : seqno_;
+    td::uint32 subwallet_id = fault == 3 ? subwallet_id_ + 1 : subwallet_id_;
+    if (type_ == HighloadWalletV2R2) {
+      td::uint64 query_id = ((td::uint64)valid_until << 32) + td::Random::fast_uint32();
+      if (fault == 2 && last_query_id_ != 0) {
+        query_id = last_query_id_;
+      } else if (fault == 0) {
+        last_query_id_ = query_id;
+      }
+      vm::Dictionary dict{16};
+      for (int i = 0; i < messages; i++) {
+        auto value = vm::CellBuilder().store_long(create_mode(), 8).store_ref(create_out_message()).as_cellslice_ref();
+        CHECK(dict.set(td::BitArray<16>(td::Random::fast(0, 0xffff)).bits(), 16, std::move(value)));
+      }
+      cb.store_long(subwallet_id, 32).store_long(query_id, 64);
+      CHECK(std::move(dict).append_dict_to_bool(cb));
+    } else {
+      cb.store_long(subwallet_id, 32).store_long(valid_until, 32).store_long(seqno, 32);
+      if (type_ == WalletV4R2) {
+        cb.store_long(0, 8);  // simple send
+      }
+      for (int i = 0; i < messages; i++) {
+        cb.store_long(create_mode(), 8).store_ref(create_out_message());
+      }
+    }
+    if (fault == 5) {
+      cb.store_long(0, 7);  // trailing data
+    }
+    auto body = cb.finalize();
+    auto signature = private_key_.sign(body->get_hash().as_slice()).move_as_ok();
+    if (fault == 4) {
+      signature.as_mutable_slice()[0] ^= 1;
+    }
+    auto signed_body = vm::CellBuilder().store_bytes(signature).append_cellslice(vm::load_cell_slice(body)).finalize();
+    return ton::GenericAccount::create_ext_message(address_, {}, std::move(signed_body));
+  }
+
+ private:
+  WalletType type_;
+  std::unique_ptr<emulator::TransactionEmulator> tvm_emulator_, native_emulator_;
+  td::Ed25519::PrivateKey private_key_{td::SecureString()};
+  td::Bits256 public_key_;
+  td::uint32 subwallet_id_;
+  td::uint32 seqno_ = 0;
+  td::uint64 last_query_id_ = 0;
+  td::Ref<vm::Cell> code_;
+  block::StdAddress address_;
+  td::Ref<vm::Cell> shard_account_;
+  ton::UnixTime now_ = 1700000000;
+  ton::LogicalTime lt_ = 42000000000;
+
+  static std::unique_ptr<emulator::TransactionEmulator> create_emulator(bool native_contracts_enabled) {
+    auto emulator = static_cast<emulator::TransactionEmulator *>(transaction_emulator_create(config_boc, 0));
+    CHECK(emulator != nullptr);
+    emulator->set_native_contracts_enabled(native_contracts_enabled);
+    return std::unique_ptr<emulator::TransactionEmulator>(emulator);
+  }
+
+  static int get_compute_phase_exit_code(td::Ref<vm::Cell> trans_root) {
+    block::gen::Transaction::Record trans;
+    block::gen::TransactionDescr::Record_trans_ord descr;
+    block::gen::TrComputePhase::Record_tr_phase_compute_vm compute_phase;
+    if (!(tlb::unpack_cell(trans_root, trans) && tlb::unpack_cell(trans.description, descr) &&
+          tlb::csr_unpack(descr.compute_ph, compute_phase))) {
+      return -1;  // skipped
+    }
+    return compute_phase.r1.exit_code;
+  }
+
+  static int create_mode() {
+    // mode 128 drains the wallet: external messages are rejected until an internal message tops it up
+    if (td::Random::fast(0, 15) == 0) {
+      return 128 + 2 * td::Random::fast(0, 1);
+    }
+    static const int modes[] = {0, 1, 2, 3, 64, 66};
+    return modes[td::Random::fast(0, 5)];
+  }
+
+  static td::Ref<vm::Cell> create_out_message() {
+    block::StdAddress dest{ton::basechainId, td::Bits256::zero()};
+    td::Random::secure_bytes(dest.addr.as_slice());
+    vm::CellBuilder cb;
+    // int_msg_info$0 ihr_disabled:Bool bounce:Bool bounced:Bool src:addr_none dest:MsgAddressInt
+    cb.store_long(0b0100, 4).store_long(0, 2);
+    CHECK(block::tlb::t_MsgAddressInt.store_std_address(cb, dest));
+    CHECK(block::tlb::t_Grams.store_integer_value(cb, td::BigInt256(td::Random::fast(1, 1000) * 1000000LL)));
+    cb.store_zeroes(1 + 4 + 4 + 64 + 32 + 1 + 1);  // no extra currencies, fees, lt, time, init, inline body
+    return cb.finalize();
+  }
+};
+
+}  // namespace
+
+TEST(Emulator, native_wallets_registered) {
+  for (auto code : {ton::SmartContractCode::get_code(ton::SmartContractCode::WalletV3, 2),
+                    ton::SmartContractCode::get_code(ton::SmartContractCode::WalletV4, 2),
+                    ton::SmartContractCode::get_code(ton::SmartContractCode::HighloadWalletV2, 2)}) {
+    CHECK(block::precompiled::get_native_implementation(code->get_hash().bits()) != nullptr);
+  }
+  CHECK(block::precompiled::get_native_implementation(
+            ton::SmartContractCode::get_code(ton::SmartContractCode::WalletV3, 1)->get_hash().bits()) == nullptr);
+}
+
+TEST(Emulator, native_wallets_differential) {
+  for (auto type : {NativeWalletTester::WalletV3R2, NativeWalletTester::WalletV4R2,
+                    NativeWalletTester::HighloadWalletV2R2}) {
+    NativeWalletTester tester(type);
+    for (int i = 0; i < 60; i++) {
+      int fault = td::Random::fast(0, 2) == 0 ? td::Random::fast(1, 5) : 0;
+      int messages = td::Random::fast(0, 4);
+      if (td::Random::fast(0, 3) == 0) {
+        // internal message with a random body, possibly bounced
+        vm::CellBuilder cb;
+        cb.store_long(td::Random::fast_uint32(), td::Random::fast(0, 32));
+        tester.run(tester.create_int_message(cb.finalize(), td::Random::fast(0, 1) == 1));
+      } else {
+        tester.run(tester.create_ext_message(messages, fault));
+      }
+    }
+  }
+}
+
+namespace {
+
+class NativeWalletBench : public td::Benchmark {
+ public:
+  explicit NativeWalletBench(bool native) : native_(native) {
+  }
+  std::string get_description() const override {
+    return PSTRING() << "wallet v3r2 transfer, " << (native_ ? "native" : "TVM");
+  }
+  void start_up() override {
+    tester_ = std::make_unique<NativeWalletTester>(NativeWalletTester::WalletV3R2);
+    msg_ = tester_->create_ext_message(1);
+    emulator_.reset(static_cast<emulator::TransactionEmulator *>(transaction_emulator_create(config_boc, 0)));
+    emulator_->set_native_contracts_enabled(native_);
+  }
+  void run(int n) override {
+    for (int i = 0; i < n; i++) {
+      auto res = emulator_->emulate_transaction(tester_->get_account(), msg_, tester_->get_now(), 0,
+                                                block::transaction::Transaction::tr_ord);
+      CHECK(res.is_ok());
+    }
+  }
+
+ private:
+  bool native_;
+  std::unique_ptr<NativeWalletTester> tester_;
+  std::unique_ptr<emulator::TransactionEmulator> emulator_;
+  td::Ref<vm::Cell> msg_;
+};
+
+}  // namespace
+
+TEST(Emulator, native_wallets_bench) {
+  td::bench(NativeWalletBench(false));
+  td::bench(NativeWalletBench(true));
+}
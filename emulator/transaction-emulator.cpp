@@ -45,6 +45,7 @@ td::Result<std::unique_ptr<TransactionEmulator::EmulationResult>> TransactionEmu
 
     compute_phase_cfg.libraries = std::make_unique<vm::Dictionary>(libraries_);
     compute_phase_cfg.ignore_chksig = ignore_chksig_;
+    compute_phase_cfg.run_native_contracts = native_contracts_enabled_;
     compute_phase_cfg.with_vm_log = true;
     compute_phase_cfg.vm_log_verbosity = vm_log_verbosity_;
 
@@ -274,6 +275,10 @@ void TransactionEmulator::set_debug_enabled(bool debug_enabled) {
   debug_enabled_ = debug_enabled;
 }
 
+void TransactionEmulator::set_native_contracts_enabled(bool native_contracts_enabled) {
+  native_contracts_enabled_ = native_contracts_enabled;
+}
+
 void TransactionEmulator::set_prev_blocks_info(td::Ref<vm::Tuple> prev_blocks_info) {
   prev_blocks_info_ = std::move(prev_blocks_info);
 }
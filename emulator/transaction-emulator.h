@@ -17,12 +17,14 @@ class TransactionEmulator {
   td::BitArray<256> rand_seed_;
   bool ignore_chksig_;
   bool debug_enabled_;
+  bool native_contracts_enabled_;
   td::Ref<vm::Tuple> prev_blocks_info_;
 
 public:
   TransactionEmulator(std::shared_ptr<block::Config> config, int vm_log_verbosity = 0) :
     config_(std::move(config)), libraries_(256), vm_log_verbosity_(vm_log_verbosity),
-    unixtime_(0), lt_(0), rand_seed_(td::BitArray<256>::zero()), ignore_chksig_(false), debug_enabled_(false) {
+    unixtime_(0), lt_(0), rand_seed_(td::BitArray<256>::zero()), ignore_chksig_(false), debug_enabled_(false),
+    native_contracts_enabled_(false) {
   }
 
   struct EmulationResult {
@@ -81,6 +83,7 @@ public:
   void set_config(std::shared_ptr<block::Config> config);
   void set_libs(vm::Dictionary &&libs);
   void set_debug_enabled(bool debug_enabled);
+  void set_native_contracts_enabled(bool native_contracts_enabled);
   void set_prev_blocks_info(td::Ref<vm::Tuple> prev_blocks_info);
 
 private:
@@ -0,0 +1,277 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "block-range-dumper.h"
+
+#include "auto/tl/lite_api.hpp"
+#include "block/block-auto.h"
+#include "block/block-parse.h"
+#include "common/checksum.h"
+#include "ton/lite-tl.hpp"
+#include "tl-utils/lite-utils.hpp"
+#include "vm/boc.h"
+#include "vm/dict.h"
+
+#include "td/utils/base64.h"
+#include "td/utils/crypto.h"
+#include "td/utils/JsonBuilder.h"
+#include "td/utils/Time.h"
+
+#include <iostream>
+
+namespace liteclient {
+
+class BlockRangeDumper::Worker : public td::actor::Actor {
+ public:
+  void process(ton::BlockIdExt block_id, td::BufferSlice data, Format format, td::Promise<std::string> promise) {
+    promise.set_result(process_block(block_id, data.as_slice(), format));
+  }
+};
+
+BlockRangeDumper::BlockRangeDumper(td::actor::ActorId<ExtClient> client, Options options,
+                                   td::Promise<td::Unit> promise)
+    : client_(std::move(client)), options_(std::move(options)), promise_(std::move(promise)) {
+}
+
+BlockRangeDumper::~BlockRangeDumper() = default;
+
+void BlockRangeDumper::start_up() {
+  if (options_.from_seqno > options_.to_seqno) {
+    finish(td::Status::Error("empty range of blocks"));
+    return;
+  }
+  if (options_.output.empty()) {
+    out_ = &std::cout;
+  } else {
+    file_.open(options_.output, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file_.is_open()) {
+      finish(td::Status::Error(PSLICE() << "cannot open file " << options_.output));
+      return;
+    }
+    out_ = &file_;
+  }
+  options_.window = std::max<size_t>(options_.window, 1);
+  options_.workers = std::max<size_t>(options_.workers, 1);
+  for (size_t i = 0; i < options_.workers; i++) {
+    workers_.push_back(td::actor::create_actor<Worker>(PSLICE() << "BlockDumpWorker" << i));
+  }
+  next_seqno_ = next_write_seqno_ = options_.from_seqno;
+  started_at_ = td::Time::now();
+  LOG(INFO) << "dumping blocks " << options_.from_seqno << ".." << options_.to_seqno << " of shard "
+            << options_.shard.to_str() << ", window " << options_.window;
+  run_queries();
+}
+
+void BlockRangeDumper::run_queries() {
+  while (next_seqno_ <= options_.to_seqno && next_seqno_ - next_write_seqno_ < options_.window) {
+    auto seqno = static_cast<ton::BlockSeqno>(next_seqno_++);
+    pending_[seqno] = {};
+    lookup_block(seqno);
+  }
+}
+
+void BlockRangeDumper::send_query(td::BufferSlice query, td::Promise<td::BufferSlice> promise) {
+  auto b = ton::serialize_tl_object(ton::create_tl_object<ton::lite_api::liteServer_query>(std::move(query)), true);
+  td::actor::send_closure(client_, &ExtClient::send_query, "query", std::move(b), td::Timestamp::in(QUERY_TIMEOUT),
+                          std::move(promise));
+}
+
+void BlockRangeDumper::lookup_block(ton::BlockSeqno seqno) {
+  auto b = ton::serialize_tl_object(
+      ton::create_tl_object<ton::lite_api::liteServer_lookupBlock>(
+          1, ton::create_tl_lite_block_id_simple(ton::BlockId{options_.shard, seqno}), 0, 0),
+      true);
+  send_query(std::move(b), [SelfId = actor_id(this), seqno](td::Result<td::BufferSlice> R) {
+    td::actor::send_closure(SelfId, &BlockRangeDumper::got_block_id, seqno, std::move(R));
+  });
+}
+
+template <class T>
+static td::Result<ton::tl_object_ptr<T>> fetch_answer(td::Result<td::BufferSlice> R) {
+  TRY_RESULT(data, std::move(R));
+  auto E = ton::fetch_tl_object<ton::lite_api::liteServer_error>(data.as_slice(), true);
+  if (E.is_ok()) {
+    return td::Status::Error(E.ok()->code_, E.ok()->message_);
+  }
+  return ton::fetch_tl_object<T>(std::move(data), true);
+}
+
+void BlockRangeDumper::got_block_id(ton::BlockSeqno seqno, td::Result<td::BufferSlice> R) {
+  auto F = fetch_answer<ton::lite_api::liteServer_blockHeader>(std::move(R));
+  if (F.is_error()) {
+    retry(seqno, F.move_as_error_prefix("cannot look up block: "));
+    return;
+  }
+  auto block_id = ton::create_block_id(F.ok()->id_);
+  if (block_id.shard_full() != options_.shard || block_id.seqno() != seqno) {
+    finish(td::Status::Error(PSLICE() << "liteserver returned block " << block_id.to_str() << " for seqno " << seqno));
+    return;
+  }
+  pending_[seqno].block_id = block_id;
+  auto b = ton::serialize_tl_object(
+      ton::create_tl_object<ton::lite_api::liteServer_getBlock>(ton::create_tl_lite_block_id(block_id)), true);
+  send_query(std::move(b), [SelfId = actor_id(this), seqno](td::Result<td::BufferSlice> R) {
+    td::actor::send_closure(SelfId, &BlockRangeDumper::got_block_data, seqno, std::move(R));
+  });
+}
+
+void BlockRangeDumper::got_block_data(ton::BlockSeqno seqno, td::Result<td::BufferSlice> R) {
+  auto F = fetch_answer<ton::lite_api::liteServer_blockData>(std::move(R));
+  if (F.is_error()) {
+    retry(seqno, F.move_as_error_prefix("cannot download block: "));
+    return;
+  }
+  auto& block_id = pending_[seqno].block_id;
+  if (ton::create_block_id(F.ok()->id_) != block_id) {
+    finish(td::Status::Error(PSLICE() << "block id mismatch in the answer for " << block_id.to_str()));
+    return;
+  }
+  auto& worker = workers_[next_worker_++ % workers_.size()];
+  td::actor::send_closure(worker, &Worker::process, block_id, std::move(F.ok_ref()->data_), options_.format,
+                          [SelfId = actor_id(this), seqno](td::Result<std::string> R) {
+                            td::actor::send_closure(SelfId, &BlockRangeDumper::got_result, seqno, std::move(R));
+                          });
+}
+
+void BlockRangeDumper::retry(ton::BlockSeqno seqno, td::Status error) {
+  auto& pending = pending_[seqno];
+  if (++pending.attempts >= MAX_ATTEMPTS) {
+    finish(error.move_as_error_prefix(PSLICE() << "seqno " << seqno << ": "));
+    return;
+  }
+  LOG(WARNING) << "seqno " << seqno << ": " << error << ", retrying";
+  lookup_block(seqno);
+}
+
+void BlockRangeDumper::got_result(ton::BlockSeqno seqno, td::Result<std::string> R) {
+  if (R.is_error()) {
+    finish(R.move_as_error_prefix(PSLICE() << "cannot process block " << pending_[seqno].block_id.to_str() << ": "));
+    return;
+  }
+  pending_.erase(seqno);
+  ready_[seqno] = R.move_as_ok();
+  write_ready();
+}
+
+void BlockRangeDumper::write_ready() {
+  while (!ready_.empty() && ready_.begin()->first == next_write_seqno_) {
+    *out_ << ready_.begin()->second;
+    ready_.erase(ready_.begin());
+    ++written_;
+    if (written_ % 1000 == 0) {
+      LOG(INFO) << "written " << written_ << " blocks, " << written_ / (td::Time::now() - started_at_) << " blocks/s";
+    }
+    if (next_write_seqno_ == options_.to_seqno) {
+      finish(td::Status::OK());
+      return;
+    }
+    ++next_write_seqno_;
+  }
+  run_queries();
+}
+
+void BlockRangeDumper::finish(td::Status status) {
+  if (out_) {
+    out_->flush();
+  }
+  if (status.is_ok()) {
+    LOG(INFO) << "dumped " << written_ << " blocks in " << td::Time::now() - started_at_ << "s";
+    promise_.set_value(td::Unit());
+  } else {
+    promise_.set_error(std::move(status));
+  }
+  stop();
+}
+
+td::Result<std::string> BlockRangeDumper::process_block(const ton::BlockIdExt& block_id, td::Slice data,
+                                                         Format format) {
+  if (td::sha256_bits256(data) != block_id.file_hash) {
+    return td::Status::Error("file hash mismatch");
+  }
+  TRY_RESULT(root, vm::std_boc_deserialize(data));
+  if (root->get_hash().bits().compare(block_id.root_hash.cbits(), 256)) {
+    return td::Status::Error("root hash mismatch");
+  }
+  if (format == Format::Boc) {
+    return PSTRING() << block_id.to_str() << ' ' << td::base64_encode(data) << '\n';
+  }
+
+  struct Transaction {
+    ton::StdSmcAddress addr;
+    ton::LogicalTime lt;
+    td::Bits256 hash;
+    td::uint32 now;
+    int out_msgs;
+  };
+  std::vector<Transaction> transactions;
+  block::gen::Block::Record blk;
+  block::gen::BlockInfo::Record info;
+  try {
+    block::gen::BlockExtra::Record extra;
+    if (!(tlb::unpack_cell(root, blk) && tlb::unpack_cell(blk.info, info) && tlb::unpack_cell(blk.extra, extra))) {
+      return td::Status::Error("cannot unpack block header");
+    }
+    vm::AugmentedDictionary acc_dict{vm::load_cell_slice_ref(extra.account_blocks), 256,
+                                     block::tlb::aug_ShardAccountBlocks};
+    bool ok = acc_dict.check_for_each_extra([&](td::Ref<vm::CellSlice> value, td::Ref<vm::CellSlice>,
+                                                td::ConstBitPtr, int) {
+      block::gen::AccountBlock::Record acc_blk;
+      if (!tlb::csr_unpack(std::move(value), acc_blk)) {
+        return false;
+      }
+      vm::AugmentedDictionary trans_dict{vm::DictNonEmpty(), std::move(acc_blk.transactions), 64,
+                                         block::tlb::aug_AccountTransactions};
+      return trans_dict.check_for_each_extra(
+          [&](td::Ref<vm::CellSlice> tvalue, td::Ref<vm::CellSlice>, td::ConstBitPtr key, int) {
+            auto trans_root = tvalue->prefetch_ref();
+            block::gen::Transaction::Record trans;
+            if (trans_root.is_null() || !tlb::unpack_cell(trans_root, trans)) {
+              return false;
+            }
+            transactions.push_back(Transaction{acc_blk.account_addr, key.get_uint(64), trans_root->get_hash().bits(),
+                                               trans.now, static_cast<int>(trans.outmsg_cnt)});
+            return true;
+          });
+    });
+    if (!ok) {
+      return td::Status::Error("invalid AccountBlocks");
+    }
+  } catch (vm::VmError& err) {
+    return err.as_status("error while parsing block: ");
+  }
+
+  td::JsonBuilder jb;
+  {
+    auto obj = jb.enter_object();
+    obj("id", block_id.to_str());
+    obj("gen_utime", static_cast<td::int64>(info.gen_utime));
+    obj("start_lt", td::JsonLong(static_cast<td::int64>(info.start_lt)));
+    obj("end_lt", td::JsonLong(static_cast<td::int64>(info.end_lt)));
+    obj("key_block", td::JsonBool(info.key_block));
+    obj("transactions", td::json_array(transactions, [&](const Transaction& t) {
+          return td::json_object([&](auto& o) {
+            o("account", PSTRING() << block_id.id.workchain << ':' << t.addr.to_hex());
+            o("lt", td::JsonLong(static_cast<td::int64>(t.lt)));
+            o("hash", t.hash.to_hex());
+            o("now", static_cast<td::int64>(t.now));
+            o("out_msgs", t.out_msgs);
+          });
+        }));
+  }
+  return jb.string_builder().as_cslice().str() + '\n';
+}
+
+}  // namespace liteclient
@@ -0,0 +1,92 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "ext-client.h"
+#include "ton/ton-types.h"
+#include "td/actor/actor.h"
+
+#include <fstream>
+#include <map>
+
+namespace liteclient {
+
+// Downloads a range of blocks of one shard chain and writes them out in seqno order.
+// Only the given shard chain is walked: shard blocks referenced by masterchain blocks are not included.
+// At most `window` blocks are in the pipeline (lookup, download, parsing or waiting to be written) at once;
+// blocks are parsed on worker actors, so they are processed in parallel on scheduler threads.
+class BlockRangeDumper : public td::actor::Actor {
+ public:
+  enum class Format { Json, Boc };
+  struct Options {
+    ton::ShardIdFull shard{ton::masterchainId};
+    ton::BlockSeqno from_seqno = 0;
+    ton::BlockSeqno to_seqno = 0;
+    Format format = Format::Json;
+    // Empty for stdout
+    std::string output;
+    size_t window = 16;
+    size_t workers = 4;
+  };
+
+  BlockRangeDumper(td::actor::ActorId<ExtClient> client, Options options, td::Promise<td::Unit> promise);
+  ~BlockRangeDumper() override;
+
+  void start_up() override;
+
+  // One line of output for the block: JSON with header fields and transactions, or block id and base64 BOC
+  static td::Result<std::string> process_block(const ton::BlockIdExt& block_id, td::Slice data, Format format);
+
+ private:
+  class Worker;
+  struct Pending {
+    ton::BlockIdExt block_id;
+    int attempts = 0;
+  };
+
+  void run_queries();
+  void lookup_block(ton::BlockSeqno seqno);
+  void got_block_id(ton::BlockSeqno seqno, td::Result<td::BufferSlice> R);
+  void got_block_data(ton::BlockSeqno seqno, td::Result<td::BufferSlice> R);
+  void got_result(ton::BlockSeqno seqno, td::Result<std::string> R);
+  void retry(ton::BlockSeqno seqno, td::Status error);
+  void send_query(td::BufferSlice query, td::Promise<td::BufferSlice> promise);
+  void write_ready();
+  void finish(td::Status status);
+
+  td::actor::ActorId<ExtClient> client_;
+  Options options_;
+  td::Promise<td::Unit> promise_;
+
+  std::vector<td::actor::ActorOwn<Worker>> workers_;
+  size_t next_worker_ = 0;
+
+  std::ofstream file_;
+  std::ostream* out_ = nullptr;
+
+  // Next block to request and next block to write
+  td::uint64 next_seqno_ = 0;
+  td::uint64 next_write_seqno_ = 0;
+  std::map<ton::BlockSeqno, Pending> pending_;
+  std::map<ton::BlockSeqno, std::string> ready_;
+  size_t written_ = 0;
+  double started_at_ = 0;
+
+  static constexpr int MAX_ATTEMPTS = 3;
+  static constexpr double QUERY_TIMEOUT = 20.0;
+};
+
+}  // namespace liteclient
@@ -16,15 +16,20 @@
 */
 #include "ext-client.h"
 #include "td/utils/Random.h"
+#include "td/utils/Time.h"
 #include "ton/ton-shard.h"
 
+#include <map>
+#include <set>
+
 namespace liteclient {
 
 class ExtClientImpl : public ExtClient {
  public:
-  ExtClientImpl(std::vector<LiteServerConfig> liteservers, td::unique_ptr<Callback> callback, bool connect_to_all)
-      : callback_(std::move(callback)), connect_to_all_(connect_to_all) {
+  ExtClientImpl(std::vector<LiteServerConfig> liteservers, td::unique_ptr<Callback> callback, Options options)
+      : callback_(std::move(callback)), options_(options), connect_to_all_(options.connect_to_all) {
     CHECK(!liteservers.empty());
+    options_.connections_per_server = std::max<size_t>(options_.connections_per_server, 1);
     servers_.resize(liteservers.size());
     for (size_t i = 0; i < servers_.size(); ++i) {
       servers_[i].config = std::move(liteservers[i]);
@@ -52,8 +57,9 @@ class ExtClientImpl : public ExtClient {
                   td::Promise<td::BufferSlice> promise) override {
     QueryInfo query_info = get_query_info(data);
     TRY_RESULT_PROMISE(promise, server_idx, select_server(query_info));
-    send_query_internal(std::move(name), std::move(data), std::move(query_info), server_idx, timeout,
-                        std::move(promise));
+    bool hedge = options_.hedge_queries && query_info.query_id != ton::lite_api::liteServer_sendMessage::ID;
+    start_query(std::move(name), std::move(data), std::move(query_info), server_idx, timeout, hedge,
+                std::move(promise));
   }
 
   void send_query_to_server(std::string name, td::BufferSlice data, size_t server_idx, td::Timestamp timeout,
@@ -65,8 +71,8 @@ class ExtClientImpl : public ExtClient {
     server_idx = server_indices_[server_idx];
     QueryInfo query_info = get_query_info(data);
     prepare_server(server_idx, &query_info);
-    send_query_internal(std::move(name), std::move(data), std::move(query_info), server_idx, timeout,
-                        std::move(promise));
+    start_query(std::move(name), std::move(data), std::move(query_info), server_idx, timeout, false,
+                std::move(promise));
   }
 
   void get_servers_status(td::Promise<std::vector<bool>> promise) override {
@@ -83,44 +89,159 @@ class ExtClientImpl : public ExtClient {
       server.alive = false;
       server.timeout = {};
       server.ignore_until = {};
-      server.client.reset();
+      close_connections(server);
     }
   }
 
  private:
-  void send_query_internal(std::string name, td::BufferSlice data, QueryInfo query_info, size_t server_idx,
-                           td::Timestamp timeout, td::Promise<td::BufferSlice> promise) {
+  struct Query {
+    std::string name;
+    // Copy of the query kept until it is hedged
+    td::BufferSlice data;
+    QueryInfo query_info;
+    td::Timestamp timeout;
+    td::Promise<td::BufferSlice> promise;
+    size_t server_idx = 0;
+    int pending = 0;
+    bool can_hedge = false;
+  };
+
+  void start_query(std::string name, td::BufferSlice data, QueryInfo query_info, size_t server_idx,
+                   td::Timestamp timeout, bool hedge, td::Promise<td::BufferSlice> promise) {
+    td::uint64 query_id = next_query_id_++;
+    Query& query = queries_[query_id];
+    query.name = name;
+    query.query_info = query_info;
+    query.timeout = timeout;
+    query.promise = std::move(promise);
+    query.server_idx = server_idx;
+    query.can_hedge = hedge && servers_.size() > 1;
+    if (query.can_hedge) {
+      query.data = data.clone();
+      double delay = std::max(options_.min_hedge_delay, options_.hedge_factor * servers_[server_idx].avg_latency);
+      auto hedge_at = td::Timestamp::in(delay);
+      if (!timeout || hedge_at.at() < timeout.at()) {
+        hedge_queue_.emplace(hedge_at.at(), query_id);
+        alarm_timestamp().relax(hedge_at);
+      } else {
+        query.can_hedge = false;
+        query.data = {};
+      }
+    }
+    send_query_internal(query_id, std::move(name), std::move(data), std::move(query_info), server_idx, timeout);
+  }
+
+  void send_query_internal(td::uint64 query_id, std::string name, td::BufferSlice data, QueryInfo query_info,
+                           size_t server_idx, td::Timestamp timeout) {
     auto& server = servers_[server_idx];
-    CHECK(!server.client.empty());
+    CHECK(!server.connections.empty());
     if (!connect_to_all_) {
-      alarm_timestamp().relax(server.timeout = td::Timestamp::in(MAX_NO_QUERIES_TIMEOUT));
+      alarm_timestamp().relax(server.timeout = td::Timestamp::in(options_.idle_timeout));
     }
-    td::Promise<td::BufferSlice> P = [SelfId = actor_id(this), server_idx,
-                                      promise = std::move(promise)](td::Result<td::BufferSlice> R) mutable {
-      if (R.is_error() &&
-          (R.error().code() == ton::ErrorCode::timeout || R.error().code() == ton::ErrorCode::cancelled)) {
-        td::actor::send_closure(SelfId, &ExtClientImpl::on_server_status, server_idx, false);
+    size_t conn_idx = 0;
+    for (size_t i = 1; i < server.connections.size(); ++i) {
+      if (server.connections[i].inflight < server.connections[conn_idx].inflight) {
+        conn_idx = i;
       }
-      promise.set_result(std::move(R));
+    }
+    auto& conn = server.connections[conn_idx];
+    ++conn.inflight;
+    ++server.inflight;
+    ++queries_[query_id].pending;
+    td::Promise<td::BufferSlice> P = [SelfId = actor_id(this), query_id, server_idx, generation = server.generation,
+                                      conn_idx, sent_at = td::Time::now()](td::Result<td::BufferSlice> R) mutable {
+      td::actor::send_closure(SelfId, &ExtClientImpl::on_query_result, query_id, server_idx, generation, conn_idx,
+                              td::Time::now() - sent_at, std::move(R));
     };
     LOG(DEBUG) << "Sending query " << query_info.to_str() << " to server #" << server.idx << " ("
-               << server.config.addr.get_ip_str() << ":" << server.config.addr.get_port() << ")";
-    send_closure(server.client, &ton::adnl::AdnlExtClient::send_query, std::move(name), std::move(data), timeout,
+               << server.config.addr.get_ip_str() << ":" << server.config.addr.get_port() << "), connection "
+               << conn_idx;
+    send_closure(conn.client, &ton::adnl::AdnlExtClient::send_query, std::move(name), std::move(data), timeout,
                  std::move(P));
   }
 
-  td::Result<size_t> select_server(const QueryInfo& query_info) {
+  void on_query_result(td::uint64 query_id, size_t server_idx, td::uint32 generation, size_t conn_idx,
+                       double elapsed, td::Result<td::BufferSlice> R) {
+    Server& server = servers_[server_idx];
+    bool server_failed = R.is_error() && (R.error().code() == ton::ErrorCode::timeout ||
+                                          R.error().code() == ton::ErrorCode::cancelled);
+    if (server.generation == generation && conn_idx < server.connections.size()) {
+      CHECK(server.inflight > 0 && server.connections[conn_idx].inflight > 0);
+      --server.inflight;
+      --server.connections[conn_idx].inflight;
+    }
+    if (server_failed) {
+      on_server_status(server_idx, false);
+    } else {
+      // Error answers are answers too: they measure the latency of the server
+      server.avg_latency = server.has_latency ? server.avg_latency * (1.0 - LATENCY_EWMA_ALPHA) +
+                                                    elapsed * LATENCY_EWMA_ALPHA
+                                              : elapsed;
+      server.has_latency = true;
+    }
+
+    auto it = queries_.find(query_id);
+    if (it == queries_.end()) {
+      // Another attempt has already answered
+      return;
+    }
+    Query& query = it->second;
+    --query.pending;
+    if (server_failed && query.can_hedge && query.pending == 0 && !query.timeout.is_in_past()) {
+      // Do not wait for the scheduled hedge: the only attempt failed, retry on another server right away
+      if (hedge_query(query_id, query)) {
+        return;
+      }
+    }
+    if (R.is_error() && query.pending > 0) {
+      // Wait for the other attempt
+      return;
+    }
+    query.promise.set_result(std::move(R));
+    queries_.erase(it);
+  }
+
+  bool hedge_query(td::uint64 query_id, Query& query) {
+    query.can_hedge = false;
+    auto R = select_server(query.query_info, query.server_idx);
+    if (R.is_error()) {
+      query.data = {};
+      return false;
+    }
+    size_t server_idx = R.move_as_ok();
+    LOG(DEBUG) << "Hedging query " << query.query_info.to_str() << " to server #" << servers_[server_idx].idx;
+    send_query_internal(query_id, query.name, std::move(query.data), query.query_info, server_idx, query.timeout);
+    return true;
+  }
+
+  td::Result<size_t> select_server(const QueryInfo& query_info, size_t exclude = std::numeric_limits<size_t>::max()) {
+    // Power of two choices among alive servers: pick two at random, take the one with lower expected latency
+    size_t first = servers_.size(), second = servers_.size();
+    size_t alive_cnt = 0;
     for (size_t i = 0; i < servers_.size(); ++i) {
-      if (servers_[i].alive && servers_[i].config.accepts_query(query_info)) {
-        return i;
+      if (i == exclude || !servers_[i].alive || !servers_[i].config.accepts_query(query_info)) {
+        continue;
+      }
+      ++alive_cnt;
+      if (td::Random::fast(1, static_cast<int>(alive_cnt)) == 1) {
+        second = first;
+        first = i;
+      } else if (td::Random::fast(1, static_cast<int>(alive_cnt - 1)) == 1) {
+        second = i;
+      }
+    }
+    if (first != servers_.size()) {
+      if (second != servers_.size() && server_score(servers_[second]) < server_score(servers_[first])) {
+        return second;
       }
+      return first;
     }
     size_t server_idx = servers_.size();
     int cnt = 0;
     int best_priority = -1;
     for (size_t i = 0; i < servers_.size(); ++i) {
       Server& server = servers_[i];
-      if (!server.config.accepts_query(query_info)) {
+      if (i == exclude || !server.config.accepts_query(query_info)) {
         continue;
       }
       int priority = 0;
@@ -152,50 +273,99 @@ class ExtClientImpl : public ExtClient {
     server.alive = true;
     server.ignore_until = {};
     if (!connect_to_all_) {
-      alarm_timestamp().relax(server.timeout = td::Timestamp::in(MAX_NO_QUERIES_TIMEOUT));
+      alarm_timestamp().relax(server.timeout = td::Timestamp::in(options_.idle_timeout));
     }
-    if (!server.client.empty()) {
+    if (!server.connections.empty()) {
       return;
     }
 
     class Callback : public ton::adnl::AdnlExtClient::Callback {
      public:
-      explicit Callback(td::actor::ActorId<ExtClientImpl> parent, size_t idx) : parent_(std::move(parent)), idx_(idx) {
+      Callback(td::actor::ActorId<ExtClientImpl> parent, size_t idx, td::uint32 generation)
+          : parent_(std::move(parent)), idx_(idx), generation_(generation) {
       }
       void on_ready() override {
-        td::actor::send_closure(parent_, &ExtClientImpl::on_server_status, idx_, true);
+        td::actor::send_closure(parent_, &ExtClientImpl::on_connection_status, idx_, generation_, true);
       }
       void on_stop_ready() override {
-        td::actor::send_closure(parent_, &ExtClientImpl::on_server_status, idx_, false);
+        td::actor::send_closure(parent_, &ExtClientImpl::on_connection_status, idx_, generation_, false);
       }
 
      private:
       td::actor::ActorId<ExtClientImpl> parent_;
       size_t idx_;
+      td::uint32 generation_;
     };
     LOG(INFO) << "Connecting to liteserver #" << server.idx << " (" << server.config.addr.get_ip_str() << ":"
               << server.config.addr.get_port() << ") for query " << (query_info ? query_info->to_str() : "[none]");
-    server.client = ton::adnl::AdnlExtClient::create(server.config.adnl_id, server.config.addr,
-                                                     std::make_unique<Callback>(actor_id(this), server_idx));
+    server.connections.resize(options_.connections_per_server);
+    for (auto& conn : server.connections) {
+      auto callback = std::make_unique<Callback>(actor_id(this), server_idx, server.generation);
+      if (options_.create_connection) {
+        conn.client = options_.create_connection(server.config, std::move(callback));
+      } else {
+        conn.client =
+            ton::adnl::AdnlExtClient::create(server.config.adnl_id, server.config.addr, std::move(callback));
+      }
+    }
   }
 
+  struct Connection {
+    td::actor::ActorOwn<ton::adnl::AdnlExtClient> client;
+    size_t inflight = 0;
+  };
   struct Server {
     LiteServerConfig config;
     size_t idx = 0;
-    td::actor::ActorOwn<ton::adnl::AdnlExtClient> client;
+    std::vector<Connection> connections;
+    td::uint32 generation = 0;
+    size_t inflight = 0;
+    double avg_latency = 0.0;
+    bool has_latency = false;
     bool alive = false;
     td::Timestamp timeout = td::Timestamp::never();
     td::Timestamp ignore_until = td::Timestamp::never();
   };
+  static double server_score(const Server& server) {
+    // Expected waiting time; servers without measurements are optimistically probed
+    double latency = server.has_latency ? server.avg_latency : 0.0;
+    return (latency + MIN_LATENCY) * static_cast<double>(server.inflight + 1);
+  }
+
+  void close_connections(Server& server) {
+    // Answers to queries sent over the closed connections must not touch the counters of the new ones
+    server.connections.clear();
+    ++server.generation;
+    server.inflight = 0;
+  }
+
   std::vector<Server> servers_;
   std::vector<size_t> server_indices_;
 
+  std::map<td::uint64, Query> queries_;
+  td::uint64 next_query_id_ = 0;
+  std::set<std::pair<double, td::uint64>> hedge_queue_;
+
   td::unique_ptr<Callback> callback_;
+  Options options_;
   bool connect_to_all_ = false;
-  static constexpr double MAX_NO_QUERIES_TIMEOUT = 100.0;
   static constexpr double BAD_SERVER_TIMEOUT = 30.0;
+  static constexpr double LATENCY_EWMA_ALPHA = 0.2;
+  static constexpr double MIN_LATENCY = 0.001;
 
   void alarm() override {
+    double now = td::Time::now();
+    while (!hedge_queue_.empty() && hedge_queue_.begin()->first <= now) {
+      td::uint64 query_id = hedge_queue_.begin()->second;
+      hedge_queue_.erase(hedge_queue_.begin());
+      auto it = queries_.find(query_id);
+      if (it != queries_.end() && it->second.can_hedge) {
+        hedge_query(query_id, it->second);
+      }
+    }
+    if (!hedge_queue_.empty()) {
+      alarm_timestamp().relax(td::Timestamp::at(hedge_queue_.begin()->first));
+    }
     if (connect_to_all_) {
       return;
     }
@@ -206,7 +376,7 @@ class ExtClientImpl : public ExtClient {
       if (server.timeout.is_in_past()) {
         LOG(INFO) << "Closing connection to liteserver #" << server.idx << " (" << server.config.addr.get_ip_str()
                   << ":" << server.config.addr.get_port() << ")";
-        server.client.reset();
+        close_connections(server);
         server.alive = false;
         server.ignore_until = {};
         server.timeout = {};
@@ -216,6 +386,12 @@ class ExtClientImpl : public ExtClient {
     }
   }
 
+  void on_connection_status(size_t idx, td::uint32 generation, bool ok) {
+    if (servers_[idx].generation == generation) {
+      on_server_status(idx, ok);
+    }
+  }
+
   void on_server_status(size_t idx, bool ok) {
     if (ok) {
       if (connect_to_all_) {
@@ -236,7 +412,13 @@ td::actor::ActorOwn<ExtClient> ExtClient::create(ton::adnl::AdnlNodeIdFull dst,
 
 td::actor::ActorOwn<ExtClient> ExtClient::create(std::vector<LiteServerConfig> liteservers,
                                                  td::unique_ptr<Callback> callback, bool connect_to_all) {
-  return td::actor::create_actor<ExtClientImpl>("ExtClient", std::move(liteservers), std::move(callback),
-                                                connect_to_all);
+  Options options;
+  options.connect_to_all = connect_to_all;
+  return create(std::move(liteservers), std::move(callback), options);
+}
+
+td::actor::ActorOwn<ExtClient> ExtClient::create(std::vector<LiteServerConfig> liteservers,
+                                                 td::unique_ptr<Callback> callback, Options options) {
+  return td::actor::create_actor<ExtClientImpl>("ExtClient", std::move(liteservers), std::move(callback), options);
 }
 }  // namespace liteclient
@@ -20,6 +20,8 @@
 #include "adnl/adnl-ext-client.h"
 #include "query-utils.hpp"
 
+#include <functional>
+
 namespace liteclient {
 class ExtClient : public td::actor::Actor {
  public:
@@ -28,6 +30,24 @@ class ExtClient : public td::actor::Actor {
     virtual ~Callback() = default;
   };
 
+  struct Options {
+    // Connect to all liteservers at start and never close idle connections
+    bool connect_to_all = false;
+    // Number of connections to each liteserver; queries are pipelined over the least loaded one
+    size_t connections_per_server = 1;
+    // Resend a query to another liteserver if it is not answered in hedge_factor * (average latency of the server),
+    // the first answer wins
+    bool hedge_queries = false;
+    double hedge_factor = 3.0;
+    double min_hedge_delay = 0.05;
+    // Close connections to a liteserver after this many seconds without queries (unless connect_to_all)
+    double idle_timeout = 100.0;
+    // Creates a connection to a liteserver, AdnlExtClient::create if empty
+    std::function<td::actor::ActorOwn<ton::adnl::AdnlExtClient>(
+        const LiteServerConfig &, std::unique_ptr<ton::adnl::AdnlExtClient::Callback>)>
+        create_connection;
+  };
+
   virtual void send_query(std::string name, td::BufferSlice data, td::Timestamp timeout,
                           td::Promise<td::BufferSlice> promise) = 0;
   virtual void send_query_to_server(std::string name, td::BufferSlice data, size_t server_idx, td::Timestamp timeout,
@@ -44,5 +64,7 @@ class ExtClient : public td::actor::Actor {
                                                td::unique_ptr<Callback> callback);
   static td::actor::ActorOwn<ExtClient> create(std::vector<LiteServerConfig> liteservers,
                                                td::unique_ptr<Callback> callback, bool connect_to_all = false);
+  static td::actor::ActorOwn<ExtClient> create(std::vector<LiteServerConfig> liteservers,
+                                               td::unique_ptr<Callback> callback, Options options);
 };
 }  // namespace liteclient
@@ -27,6 +27,7 @@
 */
 #include "lite-client.h"
 
+#include "block-range-dumper.h"
 #include "lite-client-common.h"
 
 #include "tl-utils/lite-utils.hpp"
@@ -939,6 +940,10 @@ bool TestNode::show_help(std::string command) {
          "ones\n"
          "listblocktrans[rev][meta] <block-id-ext> <count> [<start-account-id> <start-trans-lt>]\tLists block "
          "transactions, starting immediately after or before the specified one\n"
+         "dumprange[boc] <workchain> <shard-prefix> <from-seqno> <to-seqno> [<filename>]\tDownloads blocks with "
+         "seqno from..to of one shard chain with several queries in flight (see --range-window) and writes one line "
+         "per block (JSON with transactions, or block id and base64 BOC) to stdout or <filename>; shard blocks are "
+         "not expanded from masterchain blocks, dump each shard with its own seqno range\n"
          "blkproofchain[step] <from-block-id-ext> [<to-block-id-ext>]\tDownloads and checks proof of validity of the "
          "second "
          "indicated block (or the last known masterchain block) starting from given block\n"
@@ -1078,6 +1083,12 @@ bool TestNode::do_parse_line() {
     ton::BlockIdExt blkid2{};
     return parse_block_id_ext(blkid) && (seekeoln() || parse_block_id_ext(blkid2)) && seekeoln() &&
            get_block_proof(blkid, blkid2, blkid2.is_valid() + (word == "blkproofchain") * 0x1000);
+  } else if (word == "dumprange" || word == "dumprangeboc") {
+    ton::BlockSeqno to_seqno;
+    std::string filename;
+    return parse_shard_id(shard) && parse_uint32(seqno) && parse_uint32(to_seqno) &&
+           (seekeoln() || get_word_to(filename)) && seekeoln() &&
+           dump_block_range(shard, seqno, to_seqno, word == "dumprangeboc", filename);
   } else if (word == "byseqno") {
     return parse_shard_id(shard) && parse_uint32(seqno) && seekeoln() && lookup_show_block(shard, 1, seqno);
   } else if (word == "byutime") {
@@ -3041,6 +3052,32 @@ bool TestNode::get_block(ton::BlockIdExt blkid, bool dump) {
       });
 }
 
+bool TestNode::dump_block_range(ton::ShardIdFull shard, ton::BlockSeqno from_seqno, ton::BlockSeqno to_seqno,
+                                bool boc, std::string filename) {
+  if (!ready_ || client_.empty()) {
+    return set_error("server connection not ready");
+  }
+  liteclient::BlockRangeDumper::Options options;
+  options.shard = shard;
+  options.from_seqno = from_seqno;
+  options.to_seqno = to_seqno;
+  options.format = boc ? liteclient::BlockRangeDumper::Format::Boc : liteclient::BlockRangeDumper::Format::Json;
+  options.output = std::move(filename);
+  options.window = range_window_;
+  options.workers = std::max(td::thread::hardware_concurrency(), 1u);
+  running_queries_++;
+  td::actor::create_actor<liteclient::BlockRangeDumper>(
+      "BlockRangeDumper", client_.get(), std::move(options),
+      [Self = actor_id(this)](td::Result<td::Unit> R) {
+        if (R.is_error()) {
+          LOG(ERROR) << "cannot dump block range: " << R.error();
+        }
+        td::actor::send_closure(Self, &TestNode::after_got_result, R.is_ok());
+      })
+      .release();
+  return true;
+}
+
 bool TestNode::get_state(ton::BlockIdExt blkid, bool dump) {
   LOG(INFO) << "got state download request for " << blkid.to_str();
   auto b = ton::serialize_tl_object(
@@ -4682,6 +4719,15 @@ int main(int argc, char* argv[]) {
     auto d = td::to_double(arg);
     td::actor::send_closure(x, &TestNode::set_fail_timeout, td::Timestamp::in(d));
   });
+  p.add_checked_option('\0', "range-window", "maximal number of blocks in flight for dumprange (default: 16)",
+                       [&](td::Slice arg) {
+                         TRY_RESULT(window, td::to_integer_safe<td::uint32>(arg));
+                         if (window == 0) {
+                           return td::Status::Error("range window must be positive");
+                         }
+                         td::actor::send_closure(x, &TestNode::set_range_window, window);
+                         return td::Status::OK();
+                       });
   p.add_option('p', "pub", "remote public key",
                [&](td::Slice arg) { td::actor::send_closure(x, &TestNode::set_public_key, td::BufferSlice{arg}); });
   p.add_option('b', "b64", "remote public key as base64",
@@ -4707,7 +4753,8 @@ int main(int argc, char* argv[]) {
 
   vm::init_vm(true).ensure();  // enable vm debug
 
-  td::actor::Scheduler scheduler({2});
+  // dumprange parses blocks on worker actors, so use all cores
+  td::actor::Scheduler scheduler({std::max<size_t>(td::thread::hardware_concurrency(), 2)});
 
   scheduler.run_in_context([&] { x = td::actor::create_actor<TestNode>("testnode"); });
 
@@ -57,6 +57,7 @@ class TestNode : public td::actor::Actor {
 
   bool readline_enabled_ = true;
   int print_limit_ = 1024;
+  td::uint32 range_window_ = 16;
 
   std::string db_root_;
 
@@ -232,6 +233,8 @@ class TestNode : public td::actor::Actor {
                          td::Result<td::BufferSlice> R, td::Promise<ConfigInfo> promise);
   bool get_block(ton::BlockIdExt blk, bool dump = false);
   void got_block(ton::BlockIdExt blkid, td::BufferSlice data, bool dump);
+  bool dump_block_range(ton::ShardIdFull shard, ton::BlockSeqno from_seqno, ton::BlockSeqno to_seqno, bool boc,
+                        std::string filename);
   bool get_state(ton::BlockIdExt blk, bool dump = false);
   void got_state(ton::BlockIdExt blkid, ton::RootHash root_hash, ton::FileHash file_hash, td::BufferSlice data,
                  bool dump);
@@ -429,6 +432,9 @@ class TestNode : public td::actor::Actor {
     fail_timeout_ = ts;
     alarm_timestamp().relax(fail_timeout_);
   }
+  void set_range_window(td::uint32 window) {
+    range_window_ = window;
+  }
   void set_print_limit(int plimit) {
     if (plimit >= 0) {
       print_limit_ = plimit;
@@ -0,0 +1,196 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "td/utils/base64.h"
+#include "td/utils/tests.h"
+
+#include "block/block-parse.h"
+#include "block/block.h"
+#include "common/checksum.h"
+#include "vm/boc.h"
+#include "vm/dict.h"
+
+#include "lite-client/block-range-dumper.h"
+
+namespace {
+
+using liteclient::BlockRangeDumper;
+
+ton::StdSmcAddress make_addr(td::uint8 byte) {
+  ton::StdSmcAddress addr;
+  addr.as_slice().fill(static_cast<char>(byte));
+  return addr;
+}
+
+td::Ref<vm::Cell> empty_cell() {
+  return vm::CellBuilder().finalize();
+}
+
+td::Ref<vm::Cell> make_transaction(const ton::StdSmcAddress &addr, ton::LogicalTime lt, td::uint32 now) {
+  vm::CellBuilder aux;
+  aux.store_long(0, 1)   // in_msg:(Maybe ^(Message Any))
+      .store_long(0, 1);  // out_msgs:(HashmapE 15 ^(Message Any))
+  vm::CellBuilder cb;
+  CHECK(cb.store_long_bool(7, 4)                      // transaction$0111
+        && cb.store_bits_bool(addr)                   // account_addr:bits256
+        && cb.store_long_bool(lt, 64)                 // lt:uint64
+        && cb.store_zeroes_bool(256 + 64)             // prev_trans_hash:bits256 prev_trans_lt:uint64
+        && cb.store_long_bool(now, 32)                // now:uint32
+        && cb.store_long_bool(0, 15)                  // outmsg_cnt:uint15
+        && cb.store_long_bool(2, 2)                   // orig_status:AccountStatus
+        && cb.store_long_bool(2, 2)                   // end_status:AccountStatus
+        && cb.store_ref_bool(aux.finalize())          // ^[ in_msg out_msgs ]
+        && block::tlb::t_CurrencyCollection.pack_special(cb, td::make_refint(1000), {})  // total_fees
+        && cb.store_ref_bool(empty_cell())            // state_update:^(HASH_UPDATE Account)
+        && cb.store_ref_bool(empty_cell()));          // description:^TransactionDescr
+  return cb.finalize();
+}
+
+struct Fixture {
+  // account -> lts of its transactions
+  std::map<td::uint8, std::vector<ton::LogicalTime>> accounts;
+  td::uint32 now = 1700000000;
+  ton::BlockSeqno seqno = 100;
+
+  std::map<std::pair<td::uint8, ton::LogicalTime>, td::Bits256> tx_hashes;
+
+  td::Ref<vm::Cell> make_block() {
+    vm::AugmentedDictionary acc_dict{256, block::tlb::aug_ShardAccountBlocks};
+    for (auto &it : accounts) {
+      auto addr = make_addr(it.first);
+      vm::AugmentedDictionary trans_dict{64, block::tlb::aug_AccountTransactions};
+      for (auto lt : it.second) {
+        auto tx = make_transaction(addr, lt, now);
+        tx_hashes[{it.first, lt}] = tx->get_hash().bits();
+        CHECK(trans_dict.set_ref(td::BitArray<64>{static_cast<long long>(lt)}, tx, vm::Dictionary::SetMode::Add));
+      }
+      vm::CellBuilder update;
+      update.store_long(0x72, 8).store_zeroes(512);
+      vm::CellBuilder cb;
+      CHECK(cb.store_long_bool(5, 4) && cb.store_bits_bool(addr) &&
+            cb.append_cellslice_bool(vm::load_cell_slice(std::move(trans_dict).extract_root_cell())) &&
+            cb.store_ref_bool(update.finalize()));
+      CHECK(acc_dict.set(addr, vm::load_cell_slice_ref(cb.finalize()), vm::Dictionary::SetMode::Add));
+    }
+    vm::CellBuilder account_blocks;
+    CHECK(account_blocks.append_cellslice_bool(std::move(acc_dict).extract_root()));
+
+    vm::CellBuilder info;
+    CHECK(info.store_long_bool(0x9bc7a987U, 32)  // block_info#9bc7a987
+          && info.store_long_bool(0, 32)         // version:uint32
+          && info.store_long_bool(0, 8)          // not_master .. vert_seqno_incr
+          && info.store_long_bool(0, 8)          // flags:(## 8)
+          && info.store_long_bool(seqno, 32)     // seq_no:#
+          && info.store_long_bool(0, 32)         // vert_seq_no:#
+          && block::ShardId{ton::ShardIdFull{ton::masterchainId}}.serialize(info)  // shard:ShardIdent
+          && info.store_long_bool(now, 32)       // gen_utime:uint32
+          && info.store_long_bool(1000, 64)      // start_lt:uint64
+          && info.store_long_bool(1010, 64)      // end_lt:uint64
+          && info.store_zeroes_bool(4 * 32)      // gen_validator_list_hash_short .. prev_key_block_seqno
+          && info.store_ref_bool(empty_cell()));  // prev_ref:^(BlkPrevInfo 0)
+
+    vm::CellBuilder extra;
+    CHECK(extra.store_long_bool(0x4a33f6fd, 32)  // block_extra
+          && extra.store_ref_bool(empty_cell())  // in_msg_descr:^InMsgDescr
+          && extra.store_ref_bool(empty_cell())  // out_msg_descr:^OutMsgDescr
+          && extra.store_ref_bool(account_blocks.finalize())  // account_blocks:^ShardAccountBlocks
+          && extra.store_zeroes_bool(256 + 256 + 1));         // rand_seed created_by custom
+
+    vm::CellBuilder block;
+    CHECK(block.store_long_bool(0x11ef55aa, 32)  // block#11ef55aa
+          && block.store_long_bool(-239, 32)     // global_id:int32
+          && block.store_ref_bool(info.finalize()) && block.store_ref_bool(empty_cell())  // info value_flow
+          && block.store_ref_bool(empty_cell())                                           // state_update
+          && block.store_ref_bool(extra.finalize()));
+    return block.finalize();
+  }
+};
+
+ton::BlockIdExt block_id_of(const td::Ref<vm::Cell> &root, td::Slice data, ton::BlockSeqno seqno) {
+  return ton::BlockIdExt{ton::masterchainId, ton::shardIdAll, seqno, root->get_hash().bits(),
+                         td::sha256_bits256(data)};
+}
+
+}  // namespace
+
+TEST(BlockRangeDumper, HashMismatch) {
+  Fixture fixture;
+  fixture.accounts[0x11] = {1001};
+  auto root = fixture.make_block();
+  auto data = vm::std_boc_serialize(root, 31).move_as_ok();
+  auto block_id = block_id_of(root, data, fixture.seqno);
+  ASSERT_TRUE(BlockRangeDumper::process_block(block_id, data, BlockRangeDumper::Format::Json).is_ok());
+
+  auto wrong_file_hash = block_id;
+  wrong_file_hash.file_hash.as_slice()[0] ^= 1;
+  auto R = BlockRangeDumper::process_block(wrong_file_hash, data, BlockRangeDumper::Format::Boc);
+  ASSERT_TRUE(R.is_error());
+  ASSERT_EQ("file hash mismatch", R.error().message());
+
+  auto wrong_root_hash = block_id;
+  wrong_root_hash.root_hash.as_slice()[0] ^= 1;
+  R = BlockRangeDumper::process_block(wrong_root_hash, data, BlockRangeDumper::Format::Boc);
+  ASSERT_TRUE(R.is_error());
+  ASSERT_EQ("root hash mismatch", R.error().message());
+
+  // the hashes match, but the data is not a block
+  auto not_a_block = vm::CellBuilder().store_long(0xdeadbeef, 32).finalize();
+  auto not_a_block_data = vm::std_boc_serialize(not_a_block, 31).move_as_ok();
+  R = BlockRangeDumper::process_block(block_id_of(not_a_block, not_a_block_data, 1), not_a_block_data,
+                                      BlockRangeDumper::Format::Json);
+  ASSERT_TRUE(R.is_error());
+  ASSERT_EQ("cannot unpack block header", R.error().message());
+}
+
+TEST(BlockRangeDumper, BocLine) {
+  Fixture fixture;
+  fixture.accounts[0x11] = {1001};
+  auto root = fixture.make_block();
+  auto data = vm::std_boc_serialize(root, 31).move_as_ok();
+  auto block_id = block_id_of(root, data, fixture.seqno);
+  auto line = BlockRangeDumper::process_block(block_id, data, BlockRangeDumper::Format::Boc).move_as_ok();
+  ASSERT_EQ(block_id.to_str() + " " + td::base64_encode(data) + "\n", line);
+}
+
+TEST(BlockRangeDumper, JsonTransactions) {
+  Fixture fixture;
+  fixture.accounts[0x22] = {1005};
+  fixture.accounts[0x11] = {1003, 1001};
+  auto root = fixture.make_block();
+  auto data = vm::std_boc_serialize(root, 31).move_as_ok();
+  auto block_id = block_id_of(root, data, fixture.seqno);
+  auto line = BlockRangeDumper::process_block(block_id, data, BlockRangeDumper::Format::Json).move_as_ok();
+
+  // accounts in address order, transactions of an account in lt order
+  auto tx = [&](td::uint8 account, ton::LogicalTime lt) -> std::string {
+    return PSTRING() << "{\"account\":\"-1:" << make_addr(account).to_hex() << "\",\"lt\":" << lt << ",\"hash\":\""
+                     << fixture.tx_hashes.at({account, lt}).to_hex() << "\",\"now\":" << fixture.now
+                     << ",\"out_msgs\":0}";
+  };
+  std::string expected = PSTRING() << "{\"id\":\"" << block_id.to_str() << "\",\"gen_utime\":" << fixture.now
+                                   << ",\"start_lt\":1000,\"end_lt\":1010,\"key_block\":false,\"transactions\":["
+                                   << tx(0x11, 1001) << ',' << tx(0x11, 1003) << ',' << tx(0x22, 1005) << "]}\n";
+  ASSERT_EQ(expected, line);
+
+  Fixture empty;
+  root = empty.make_block();
+  data = vm::std_boc_serialize(root, 31).move_as_ok();
+  block_id = block_id_of(root, data, empty.seqno);
+  line = BlockRangeDumper::process_block(block_id, data, BlockRangeDumper::Format::Json).move_as_ok();
+  ASSERT_EQ(PSTRING() << "{\"id\":\"" << block_id.to_str() << "\",\"gen_utime\":" << empty.now
+                      << ",\"start_lt\":1000,\"end_lt\":1010,\"key_block\":false,\"transactions\":[]}\n",
+            line);
+}
@@ -0,0 +1,259 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "td/utils/tests.h"
+
+#include "auto/tl/lite_api.h"
+#include "tl-utils/lite-utils.hpp"
+
+#include "lite-client/ext-client.h"
+
+#include <map>
+
+namespace {
+
+// Liteservers are identified by the port of their address, every server answers with its port after a delay
+struct FakeNetwork {
+  std::vector<double> delays;
+  std::vector<int> connections;
+  std::vector<int> queries;
+
+  explicit FakeNetwork(std::vector<double> delays)
+      : delays(std::move(delays)), connections(this->delays.size()), queries(this->delays.size()) {
+  }
+
+  std::vector<liteclient::LiteServerConfig> configs() const {
+    std::vector<liteclient::LiteServerConfig> result;
+    for (size_t i = 0; i < delays.size(); i++) {
+      td::IPAddress addr;
+      addr.init_ipv4_port("127.0.0.1", static_cast<int>(1000 + i)).ensure();
+      result.emplace_back(ton::adnl::AdnlNodeIdFull{ton::PublicKey{ton::pubkeys::Ed25519{td::Bits256::zero()}}},
+                          addr);
+    }
+    return result;
+  }
+};
+
+class FakeConnection : public ton::adnl::AdnlExtClient {
+ public:
+  FakeConnection(FakeNetwork *network, size_t server, std::unique_ptr<Callback> callback)
+      : network_(network), server_(server), callback_(std::move(callback)) {
+  }
+  void start_up() override {
+    network_->connections[server_]++;
+    callback_->on_ready();
+  }
+  void check_ready(td::Promise<td::Unit> promise) override {
+    promise.set_value(td::Unit());
+  }
+  void send_query(std::string name, td::BufferSlice data, td::Timestamp timeout,
+                  td::Promise<td::BufferSlice> promise) override {
+    network_->queries[server_]++;
+    auto at = td::Timestamp::in(network_->delays[server_]);
+    pending_.emplace(at.at(), std::move(promise));
+    alarm_timestamp().relax(at);
+  }
+  void alarm() override {
+    while (!pending_.empty() && pending_.begin()->first <= td::Time::now()) {
+      pending_.begin()->second.set_value(td::BufferSlice(PSLICE() << (1000 + server_)));
+      pending_.erase(pending_.begin());
+    }
+    if (!pending_.empty()) {
+      alarm_timestamp().relax(td::Timestamp::at(pending_.begin()->first));
+    }
+  }
+
+ private:
+  FakeNetwork *network_;
+  size_t server_;
+  std::unique_ptr<Callback> callback_;
+  // unanswered queries fail with "Lost promise" when the connection is closed
+  std::multimap<double, td::Promise<td::BufferSlice>> pending_;
+};
+
+// Runs the steps one after another, each one after the delay from the start of the test,
+// then closes the client and stops the scheduler
+class Script : public td::actor::Actor {
+ public:
+  struct Step {
+    double at;
+    std::function<void()> f;
+  };
+  Script(td::actor::ActorOwn<liteclient::ExtClient> client, std::vector<Step> steps)
+      : client_(std::move(client)), steps_(std::move(steps)) {
+  }
+  void start_up() override {
+    start_ = td::Timestamp::now();
+    alarm();
+  }
+  void alarm() override {
+    while (next_ < steps_.size() && start_.at() + steps_[next_].at <= td::Time::now()) {
+      steps_[next_++].f();
+    }
+    if (next_ == steps_.size()) {
+      client_.reset();
+      stop();
+      td::actor::SchedulerContext::get()->stop();
+      return;
+    }
+    alarm_timestamp() = td::Timestamp::at(start_.at() + steps_[next_].at);
+  }
+
+ private:
+  td::actor::ActorOwn<liteclient::ExtClient> client_;
+  std::vector<Step> steps_;
+  size_t next_ = 0;
+  td::Timestamp start_;
+};
+
+struct Results {
+  std::vector<td::Result<td::BufferSlice>> results;
+
+  td::Promise<td::BufferSlice> promise() {
+    results.emplace_back(td::Status::Error("not answered"));
+    return [this, i = results.size() - 1](td::Result<td::BufferSlice> R) { results[i] = std::move(R); };
+  }
+  std::string answer(size_t i) const {
+    CHECK(i < results.size());
+    return results[i].is_ok() ? results[i].ok().as_slice().str() : "error";
+  }
+};
+
+td::BufferSlice get_time_query() {
+  return ton::serialize_tl_object(
+      ton::create_tl_object<ton::lite_api::liteServer_query>(
+          ton::serialize_tl_object(ton::create_tl_object<ton::lite_api::liteServer_getTime>(), true)),
+      true);
+}
+
+void run_script(FakeNetwork &network, liteclient::ExtClient::Options options,
+                std::function<std::vector<Script::Step>(td::actor::ActorId<liteclient::ExtClient>)> script) {
+  options.create_connection = [&network](const liteclient::LiteServerConfig &config,
+                                         std::unique_ptr<ton::adnl::AdnlExtClient::Callback> callback) {
+    auto server = static_cast<size_t>(config.addr.get_port() - 1000);
+    return td::actor::create_actor<FakeConnection>("FakeConnection", &network, server, std::move(callback));
+  };
+  td::actor::Scheduler scheduler({0});
+  scheduler.run_in_context([&] {
+    auto client = liteclient::ExtClient::create(network.configs(), nullptr, options);
+    auto steps = script(client.get());
+    td::actor::create_actor<Script>("Script", std::move(client), std::move(steps)).release();
+  });
+  scheduler.run();
+}
+
+}  // namespace
+
+TEST(ExtClient, Hedging) {
+  FakeNetwork network({1.0, 1.0});
+  liteclient::ExtClient::Options options;
+  options.hedge_queries = true;
+  options.connections_per_server = 2;
+  Results results;
+  size_t fast = 0;
+  run_script(network, options, [&](td::actor::ActorId<liteclient::ExtClient> client) {
+    return std::vector<Script::Step>{
+        {0.0,
+         [&, client] {
+           for (int i = 0; i < 20; i++) {
+             td::actor::send_closure(client, &liteclient::ExtClient::send_query, "query", get_time_query(),
+                                     td::Timestamp::in(10.0), results.promise());
+           }
+         }},
+        // the server that got the queries is slow, the other one becomes fast before the hedge delay
+        {0.01,
+         [&] {
+           fast = network.queries[0] == 0 ? 0 : 1;
+           ASSERT_EQ(0, network.queries[fast]);
+           ASSERT_EQ(20, network.queries[1 - fast]);
+           network.delays[fast] = 0.01;
+         }},
+        // queries sent to the slow server are answered by the fast one
+        {0.5,
+         [&] {
+           for (size_t i = 0; i < results.results.size(); i++) {
+             ASSERT_EQ(PSTRING() << 1000 + fast, results.answer(i));
+           }
+           ASSERT_EQ(20, network.queries[fast]);
+         }},
+        // late answers of the slow server are ignored
+        {1.2, [] {}}};
+  });
+}
+
+TEST(ExtClient, ResetServers) {
+  FakeNetwork network({0.3});
+  liteclient::ExtClient::Options options;
+  options.connections_per_server = 2;
+  Results results;
+  run_script(network, options, [&](td::actor::ActorId<liteclient::ExtClient> client) {
+    auto send = [&, client] {
+      td::actor::send_closure(client, &liteclient::ExtClient::send_query, "query", get_time_query(),
+                              td::Timestamp::in(10.0), results.promise());
+    };
+    return std::vector<Script::Step>{{0.0,
+                                      [=] {
+                                        for (int i = 0; i < 3; i++) {
+                                          send();
+                                        }
+                                      }},
+                                     {0.1, [client] { td::actor::send_closure(client, &liteclient::ExtClient::reset_servers); }},
+                                     {0.15,
+                                      [=] {
+                                        send();
+                                        send();
+                                      }},
+                                     {0.6, [] {}}};
+  });
+  // queries over the closed connections fail, new queries reconnect
+  for (size_t i = 0; i < 3; i++) {
+    ASSERT_EQ("error", results.answer(i));
+  }
+  ASSERT_EQ("1000", results.answer(3));
+  ASSERT_EQ("1000", results.answer(4));
+  ASSERT_EQ(4, network.connections[0]);
+}
+
+TEST(ExtClient, IdleClose) {
+  FakeNetwork network({0.5});
+  liteclient::ExtClient::Options options;
+  options.connections_per_server = 2;
+  options.idle_timeout = 0.2;
+  Results results;
+  std::vector<bool> status;
+  run_script(network, options, [&](td::actor::ActorId<liteclient::ExtClient> client) {
+    auto send = [&, client] {
+      td::actor::send_closure(client, &liteclient::ExtClient::send_query, "query", get_time_query(),
+                              td::Timestamp::in(10.0), results.promise());
+    };
+    return std::vector<Script::Step>{
+        // the connection is closed while the query is in flight
+        {0.0, send},
+        {0.3,
+         [&, client, send] {
+           network.delays[0] = 0.05;
+           td::actor::send_closure(client, &liteclient::ExtClient::get_servers_status,
+                                   [&](td::Result<std::vector<bool>> R) { status = R.move_as_ok(); });
+           send();
+         }},
+        {0.45, [] {}}};
+  });
+  ASSERT_EQ(1u, status.size());
+  ASSERT_TRUE(!status[0]);
+  ASSERT_EQ("error", results.answer(0));
+  ASSERT_EQ("1000", results.answer(1));
+  ASSERT_EQ(4, network.connections[0]);
+}
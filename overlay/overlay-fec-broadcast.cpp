@@ -115,21 +115,29 @@ td::Status BroadcastFec::distribute_part(td::uint32 seqno) {
   auto nodes = overlay_->get_neighbours(overlay_->propagate_broadcast_to());
   auto manager = overlay_->overlay_manager();
 
+  std::vector<adnl::AdnlNodeIdShort> short_dst, full_dst;
   for (auto &n : nodes) {
     if (neighbour_completed(n)) {
       continue;
     }
     if (neighbour_received(n)) {
-      td::actor::send_closure(manager, &OverlayManager::send_message, n, overlay_->local_id(), overlay_->overlay_id(),
-                              data_short.clone());
+      short_dst.push_back(n);
     } else {
       if (hash_.count_leading_zeroes() >= 12) {
         VLOG(OVERLAY_INFO) << "broadcast " << hash_ << ": sending part " << seqno << " to " << n;
       }
-      td::actor::send_closure(manager, &OverlayManager::send_message, n, overlay_->local_id(), overlay_->overlay_id(),
-                              data.clone());
+      full_dst.push_back(n);
     }
   }
+  // one serialized packet per part kind, shared by all neighbours
+  if (!short_dst.empty()) {
+    td::actor::send_closure(manager, &OverlayManager::send_multiple_messages, std::move(short_dst),
+                            overlay_->local_id(), overlay_->overlay_id(), std::move(data_short));
+  }
+  if (!full_dst.empty()) {
+    td::actor::send_closure(manager, &OverlayManager::send_multiple_messages, std::move(full_dst),
+                            overlay_->local_id(), overlay_->overlay_id(), std::move(data));
+  }
   return td::Status::OK();
 }
 
@@ -278,8 +278,8 @@ void OverlayManager::send_query_via(adnl::AdnlNodeIdShort dst, adnl::AdnlNodeIdS
                           timeout, std::move(serialized_query), max_answer_size);
 }
 
-void OverlayManager::send_message_via(adnl::AdnlNodeIdShort dst, adnl::AdnlNodeIdShort src, OverlayIdShort overlay_id,
-                                      td::BufferSlice object, td::actor::ActorId<adnl::AdnlSenderInterface> via) {
+td::BufferSlice OverlayManager::prepare_message(td::Span<adnl::AdnlNodeIdShort> dst, adnl::AdnlNodeIdShort src,
+                                                OverlayIdShort overlay_id, td::Slice object) {
   CHECK(object.size() <= adnl::Adnl::huge_packet_max_size());
 
   auto extra = create_tl_object<ton_api::overlay_messageExtra>();
@@ -289,8 +289,10 @@ void OverlayManager::send_message_via(adnl::AdnlNodeIdShort dst, adnl::AdnlNodeI
   if (it != overlays_.end()) {
     auto it2 = it->second.find(overlay_id);
     if (it2 != it->second.end()) {
-      td::actor::send_closure(it2->second.overlay, &Overlay::update_throughput_out_ctr, dst, object.size(), false,
-                              false);
+      for (auto &n : dst) {
+        td::actor::send_closure(it2->second.overlay, &Overlay::update_throughput_out_ctr, n, object.size(), false,
+                                false);
+      }
       if (!it2->second.member_certificate.empty()) {
         // do not send certificate here, we hope that all our neighbours already know of out certificate
         // we send it every second to some random nodes. Here we don't want to increase the size of the message
@@ -303,14 +305,29 @@ void OverlayManager::send_message_via(adnl::AdnlNodeIdShort dst, adnl::AdnlNodeI
   }
 
   auto extra_flags = extra->flags_;
-  td::BufferSlice serialized_message =
-      (extra_flags ? create_serialize_tl_object_suffix<ton_api::overlay_messageWithExtra>(
-                         object.as_slice(), overlay_id.tl(), std::move(extra))
-                   : create_serialize_tl_object_suffix<ton_api::overlay_message>(object.as_slice(), overlay_id.tl()));
+  return extra_flags ? create_serialize_tl_object_suffix<ton_api::overlay_messageWithExtra>(object, overlay_id.tl(),
+                                                                                             std::move(extra))
+                     : create_serialize_tl_object_suffix<ton_api::overlay_message>(object, overlay_id.tl());
+}
 
+void OverlayManager::send_message_via(adnl::AdnlNodeIdShort dst, adnl::AdnlNodeIdShort src, OverlayIdShort overlay_id,
+                                      td::BufferSlice object, td::actor::ActorId<adnl::AdnlSenderInterface> via) {
+  auto serialized_message = prepare_message(td::span_one(dst), src, overlay_id, object.as_slice());
   td::actor::send_closure(via, &adnl::AdnlSenderInterface::send_message, src, dst, std::move(serialized_message));
 }
 
+void OverlayManager::send_multiple_messages(std::vector<adnl::AdnlNodeIdShort> dst, adnl::AdnlNodeIdShort src,
+                                            OverlayIdShort overlay_id, td::BufferSlice object) {
+  if (dst.empty()) {
+    return;
+  }
+  // the prefixed message is serialized only once and the buffer is shared by all recipients
+  auto serialized_message = prepare_message(td::as_span(dst), src, overlay_id, object.as_slice());
+  for (auto &n : dst) {
+    td::actor::send_closure(adnl_, &adnl::AdnlSenderInterface::send_message, src, n, serialized_message.clone());
+  }
+}
+
 void OverlayManager::send_broadcast(adnl::AdnlNodeIdShort local_id, OverlayIdShort overlay_id, td::BufferSlice object) {
   send_broadcast_ex(local_id, overlay_id, local_id.pubkey_hash(), 0, std::move(object));
 }
@@ -22,6 +22,7 @@
 
 #include "td/actor/actor.h"
 #include "td/db/KeyValueAsync.h"
+#include "td/utils/Span.h"
 
 #include "adnl/adnl.h"
 #include "dht/dht.h"
@@ -81,6 +82,8 @@ class OverlayManager : public Overlays {
   }
   void send_message_via(adnl::AdnlNodeIdShort dst, adnl::AdnlNodeIdShort src, OverlayIdShort overlay_id,
                         td::BufferSlice object, td::actor::ActorId<adnl::AdnlSenderInterface> via) override;
+  void send_multiple_messages(std::vector<adnl::AdnlNodeIdShort> dst, adnl::AdnlNodeIdShort src,
+                              OverlayIdShort overlay_id, td::BufferSlice object) override;
 
   void send_broadcast(adnl::AdnlNodeIdShort src, OverlayIdShort overlay_id, td::BufferSlice object) override;
   void send_broadcast_ex(adnl::AdnlNodeIdShort src, OverlayIdShort overlay_id, PublicKeyHash send_as, td::uint32 flags,
@@ -118,6 +121,10 @@ class OverlayManager : public Overlays {
   }
 
  private:
+  // updates the outbound throughput counters for all of dst and serializes the overlay message prefix
+  td::BufferSlice prepare_message(td::Span<adnl::AdnlNodeIdShort> dst, adnl::AdnlNodeIdShort src,
+                                  OverlayIdShort overlay_id, td::Slice object);
+
   struct OverlayDescription {
     td::actor::ActorOwn<Overlay> overlay;
     OverlayMemberCertificate member_certificate;
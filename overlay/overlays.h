@@ -341,8 +341,8 @@ class Overlays : public td::actor::Actor {
                               std::string name, td::Promise<td::BufferSlice> promise, td::Timestamp timeout,
                               td::BufferSlice query, td::uint64 max_answer_size,
                               td::actor::ActorId<adnl::AdnlSenderInterface> via) = 0;
-  void send_multiple_messages(std::vector<adnl::AdnlNodeIdShort> dst, adnl::AdnlNodeIdShort src,
-                              OverlayIdShort overlay_id, td::BufferSlice object) {
+  virtual void send_multiple_messages(std::vector<adnl::AdnlNodeIdShort> dst, adnl::AdnlNodeIdShort src,
+                                      OverlayIdShort overlay_id, td::BufferSlice object) {
     for (auto &n : dst) {
       send_message(n, src, overlay_id, object.clone());
     }
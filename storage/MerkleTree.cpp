@@ -46,26 +46,68 @@ MerkleTree::MerkleTree(size_t pieces_count, td::Bits256 root_hash)
   }
 }
 
-static td::Ref<vm::Cell> build_tree(td::Bits256 *hashes, size_t len) {
-  if (len == 1) {
-    return vm::CellBuilder().store_bytes(hashes[0].as_slice()).finalize();
+MerkleTree::MerkleTree(size_t pieces_count, td::Ref<vm::Cell> root) : MerkleTree(pieces_count, td::Bits256::zero()) {
+  root_hash_ = root->get_hash().bits();
+  root_proof_ = vm::CellBuilder::create_merkle_proof(std::move(root));
+}
+
+MerkleTree::MerkleTree(std::vector<td::Bits256> hashes) {
+  Builder builder(hashes.size());
+  for (const auto &hash : hashes) {
+    builder.add_piece(hash);
   }
-  td::Ref<vm::Cell> l = build_tree(hashes, len / 2);
-  td::Ref<vm::Cell> r = build_tree(hashes + len / 2, len / 2);
-  return vm::CellBuilder().store_ref(l).store_ref(r).finalize();
-};
+  *this = builder.finalize();
+}
 
-MerkleTree::MerkleTree(std::vector<td::Bits256> hashes) : pieces_count_(hashes.size()) {
-  depth_ = 0;
-  n_ = 1;
+MerkleTree::Builder::Builder(size_t pieces_count) : pieces_count_(pieces_count) {
   while (n_ < pieces_count_) {
-    ++depth_;
     n_ <<= 1;
   }
-  hashes.resize(n_, td::Bits256::zero());
-  td::Ref<vm::Cell> root = build_tree(hashes.data(), n_);
-  root_hash_ = root->get_hash().bits();
-  root_proof_ = vm::CellBuilder::create_merkle_proof(std::move(root));
+}
+
+void MerkleTree::Builder::push(size_t depth, td::Ref<vm::Cell> node) {
+  while (!stack_.empty() && stack_.back().first == depth) {
+    node = vm::CellBuilder().store_ref(std::move(stack_.back().second)).store_ref(std::move(node)).finalize();
+    stack_.pop_back();
+    ++depth;
+  }
+  stack_.emplace_back(depth, std::move(node));
+}
+
+td::Ref<vm::Cell> MerkleTree::Builder::zero_tree(size_t depth) {
+  while (zero_trees_.size() <= depth) {
+    if (zero_trees_.empty()) {
+      zero_trees_.push_back(vm::CellBuilder().store_bytes(td::Bits256::zero().as_slice()).finalize());
+    } else {
+      auto &child = zero_trees_.back();
+      zero_trees_.push_back(vm::CellBuilder().store_ref(child).store_ref(child).finalize());
+    }
+  }
+  return zero_trees_[depth];
+}
+
+void MerkleTree::Builder::add_piece(const td::Bits256 &hash) {
+  CHECK(added_ < pieces_count_);
+  ++added_;
+  push(0, vm::CellBuilder().store_bytes(hash.as_slice()).finalize());
+}
+
+MerkleTree MerkleTree::Builder::finalize() {
+  CHECK(added_ == pieces_count_);
+  // Pad with zero hashes, adding the largest complete zero subtrees possible
+  size_t size = added_;
+  while (size < n_) {
+    size_t depth = 0;
+    while (size % (size_t(2) << depth) == 0 && size + (size_t(2) << depth) <= n_) {
+      ++depth;
+    }
+    push(depth, zero_tree(depth));
+    size += size_t(1) << depth;
+  }
+  CHECK(stack_.size() == 1);
+  auto root = std::move(stack_.back().second);
+  stack_.clear();
+  return MerkleTree(pieces_count_, std::move(root));
 }
 
 static td::Status do_validate_proof(td::Ref<vm::Cell> node, size_t depth) {
@@ -36,6 +36,25 @@ class MerkleTree {
   MerkleTree(size_t pieces_count, td::Bits256 root_hash);
   explicit MerkleTree(std::vector<td::Bits256> hashes);
 
+  // Builds the tree from hashes of the pieces that are added one by one in order,
+  // so all hashes don't have to be kept in memory at once.
+  class Builder {
+   public:
+    explicit Builder(size_t pieces_count);
+    void add_piece(const td::Bits256 &hash);
+    MerkleTree finalize();
+
+   private:
+    size_t pieces_count_;
+    size_t n_{1};
+    size_t added_{0};
+    std::vector<std::pair<size_t, td::Ref<vm::Cell>>> stack_;  // (depth, root) of complete subtrees
+    std::vector<td::Ref<vm::Cell>> zero_trees_;
+
+    void push(size_t depth, td::Ref<vm::Cell> node);
+    td::Ref<vm::Cell> zero_tree(size_t depth);
+  };
+
   td::Status add_proof(td::Ref<vm::Cell> proof);
   td::Result<td::Bits256> get_piece_hash(size_t idx) const;
   td::Result<td::Ref<vm::Cell>> gen_proof(size_t l, size_t r) const;
@@ -57,6 +76,8 @@ class MerkleTree {
   size_t depth_{0}, n_{1};
   td::Ref<vm::Cell> root_proof_;
 
+  MerkleTree(size_t pieces_count, td::Ref<vm::Cell> root);
+
   td::Ref<vm::Cell> do_add_pieces(td::Ref<vm::Cell> node, std::vector<size_t> &ok_pieces, size_t il, size_t ir,
                                   std::pair<size_t, td::Bits256> *pl, std::pair<size_t, td::Bits256> *pr);
 };
@@ -18,6 +18,7 @@
 */
 
 #include "NodeActor.h"
+#include "PieceHasher.h"
 
 #include "vm/boc.h"
 #include "vm/cellslice.h"
@@ -58,7 +59,9 @@ NodeActor::NodeActor(PeerId self_id, ton::Torrent torrent, td::unique_ptr<Callba
     , added_at_(db_initial_data.added_at)
     , speed_limiters_(std::move(speed_limiters))
     , pending_set_file_priority_(std::move(db_initial_data.priorities))
-    , pieces_in_db_(std::move(db_initial_data.pieces_in_db)) {
+    , pieces_in_db_(std::move(db_initial_data.pieces_in_db))
+    , verify_progress_to_restore_(std::move(db_initial_data.verify_progress))
+    , verify_progress_steps_to_restore_(std::move(db_initial_data.verify_progress_steps)) {
 }
 
 void NodeActor::start_peer(PeerId peer_id, td::Promise<td::actor::ActorId<PeerActor>> promise) {
@@ -83,6 +86,26 @@ void NodeActor::on_signal_from_peer(PeerId peer_id) {
 void NodeActor::start_up() {
   node_callback_->register_self(actor_id(this));
   db_store_torrent();
+  if (verify_progress_to_restore_ != nullptr) {
+    if (torrent_.inited_header()) {
+      // Pieces before next_piece were verified before restart, the rest will be checked again
+      std::vector<Torrent::ReadyPieces> ranges;
+      for (auto &step : verify_progress_steps_to_restore_) {
+        ranges.push_back(Torrent::ReadyPieces{(td::uint64)step->begin_, step->ready_pieces_.as_slice().str(),
+                                              step->hashes_.as_slice().str()});
+      }
+      // Pieces that were ready, but couldn't be restored, are checked again too
+      auto next_piece =
+          td::min((td::uint64)verify_progress_to_restore_->next_piece_, torrent_.restore_ready_pieces(ranges));
+      verify_next_piece_ = next_piece;
+      verify_steps_ = verify_progress_to_restore_->steps_;
+      LOG(INFO) << "Resuming verification of files for " << torrent_.get_hash().to_hex() << " from piece "
+                << next_piece;
+      td::actor::send_closure(actor_id(this), &NodeActor::verify_files_step);
+    }
+    verify_progress_to_restore_ = nullptr;
+    verify_progress_steps_to_restore_.clear();
+  }
   if (torrent_.inited_info()) {
     init_torrent();
   }
@@ -478,13 +501,153 @@ void NodeActor::load_from(td::optional<TorrentMeta> meta, std::string files_path
 void NodeActor::copy_to_new_root_dir(std::string new_root_dir, td::Promise<td::Unit> promise) {
   TRY_STATUS_PROMISE(promise, torrent_.copy_to(new_root_dir));
   db_store_torrent();
+  if (verify_task_) {
+    // The step reads files from the old directory, it is started again
+    verify_task_ = nullptr;
+    verify_pending_parts_ = 0;
+    td::actor::send_closure(actor_id(this), &NodeActor::verify_files_step);
+  }
   promise.set_result(td::Unit());
 }
 
+void NodeActor::verify_files(td::Promise<td::Unit> promise) {
+  auto r_task = torrent_.start_revalidation(0, 0);
+  if (r_task.is_error()) {
+    promise.set_error(r_task.move_as_error());
+    return;
+  }
+  if (!verify_next_piece_) {
+    LOG(INFO) << "Starting verification of files for " << torrent_.get_hash().to_hex();
+    verify_next_piece_ = 0;
+    verify_broken_pieces_ = 0;
+    db_store_verify_progress();
+    td::actor::send_closure(actor_id(this), &NodeActor::verify_files_step);
+  }
+  promise.set_result(td::Unit());
+}
+
+void NodeActor::verify_files_step() {
+  if (!verify_next_piece_ || verify_task_) {
+    return;
+  }
+  // Each step hashes VERIFY_STEP_SIZE bytes in verify_workers_, NodeActor only applies the results
+  auto pieces_count = torrent_.get_info().pieces_count();
+  auto begin = verify_next_piece_.value();
+  auto end = td::min(pieces_count, begin + td::max<td::uint64>(VERIFY_STEP_SIZE / torrent_.get_info().piece_size, 1));
+  auto r_task = torrent_.start_revalidation(begin, end);
+  if (r_task.is_error()) {
+    LOG(ERROR) << "Cannot verify files for " << torrent_.get_hash().to_hex() << ": " << r_task.error();
+    finish_verify_files();
+    return;
+  }
+  verify_task_ = std::make_shared<const Torrent::RevalidationTask>(r_task.move_as_ok());
+  if (verify_workers_.empty()) {
+    for (size_t i = 0; i < PieceHasher::get_threads_count(0); i++) {
+      verify_workers_.push_back(td::actor::create_actor<VerifyFilesWorker>("VerifyFilesWorker"));
+    }
+  }
+  verify_hashes_.assign(end - begin, {});
+  auto part_size = td::max<td::uint64>((end - begin + verify_workers_.size() - 1) / verify_workers_.size(), 1);
+  verify_pending_parts_ = 0;
+  for (td::uint64 l = begin; l < end; l += part_size) {
+    auto r = td::min(end, l + part_size);
+    td::actor::send_closure(
+        verify_workers_[verify_pending_parts_++].get(), &VerifyFilesWorker::hash_pieces, verify_task_, l, r,
+        [SelfId = actor_id(this), task = verify_task_, l](td::Result<std::vector<td::optional<td::Bits256>>> R) {
+          td::actor::send_closure(SelfId, &NodeActor::got_verify_hashes, std::move(task), l, std::move(R));
+        });
+  }
+  if (verify_pending_parts_ == 0) {
+    got_verify_hashes(verify_task_, begin, std::vector<td::optional<td::Bits256>>());
+  }
+}
+
+void NodeActor::got_verify_hashes(std::shared_ptr<const Torrent::RevalidationTask> task, td::uint64 begin,
+                                  td::Result<std::vector<td::optional<td::Bits256>>> R) {
+  if (task != verify_task_) {
+    return;
+  }
+  if (R.is_ok()) {
+    auto hashes = R.move_as_ok();
+    for (size_t i = 0; i < hashes.size(); i++) {
+      verify_hashes_[begin - task->begin + i] = std::move(hashes[i]);
+    }
+  }
+  if (verify_pending_parts_ > 0 && --verify_pending_parts_ > 0) {
+    return;
+  }
+  verify_task_ = nullptr;
+  auto end = task->end;
+  verify_broken_pieces_ += torrent_.finish_revalidation(*task, std::move(verify_hashes_));
+  verify_hashes_.clear();
+  if (piece_cache_) {
+    // Pieces of the range were reread, broken ones must not be served from the cache
+    piece_cache_->erase_range(torrent_.get_hash(), task->begin, end);
+  }
+  recheck_parts(Torrent::PartsRange{task->begin, end});
+  if (end < torrent_.get_info().pieces_count()) {
+    db_store_verify_progress_step(task->begin, end);
+    verify_next_piece_ = end;
+    db_store_verify_progress();
+    verify_files_step();
+    return;
+  }
+  LOG(INFO) << "Finished verification of files for " << torrent_.get_hash().to_hex() << ": " << verify_broken_pieces_
+            << " broken pieces";
+  finish_verify_files();
+}
+
+void NodeActor::finish_verify_files() {
+  verify_next_piece_ = {};
+  verify_workers_.clear();
+  db_store_verify_progress();
+  if (!torrent_.is_completed()) {
+    is_completed_ = false;
+  }
+  loop();
+}
+
+void NodeActor::set_piece_cache(std::shared_ptr<PieceCache> piece_cache) {
+  piece_cache_ = std::move(piece_cache);
+}
+
+td::Result<PieceCache::Piece> NodeActor::get_piece_for_upload(Torrent &torrent, PieceCache *piece_cache,
+                                                              td::uint64 piece_i) {
+  if (!torrent.inited_info()) {
+    return td::Status::Error("Torrent info is not ready");
+  }
+  if (piece_i >= torrent.get_info().pieces_count()) {
+    return td::Status::Error("Piece idx is too big");
+  }
+  if (!torrent.is_piece_ready(piece_i)) {
+    if (piece_cache) {
+      piece_cache->erase(torrent.get_hash(), piece_i);
+    }
+    return td::Status::Error("Piece is not ready");
+  }
+  if (piece_cache) {
+    auto cached = piece_cache->get(torrent.get_hash(), piece_i);
+    if (cached) {
+      return cached.unwrap();
+    }
+  }
+  TRY_RESULT(proof, torrent.get_piece_proof(piece_i));
+  PieceCache::Piece piece;
+  TRY_RESULT_ASSIGN(piece.proof, vm::std_boc_serialize(std::move(proof)));
+  TRY_RESULT_ASSIGN(piece.data, torrent.get_piece_buffer(piece_i));
+  if (piece_cache) {
+    piece_cache->put(torrent.get_hash(), piece_i, piece);
+  }
+  return std::move(piece);
+}
+
 void NodeActor::tear_down() {
   for (auto &promise : wait_for_completion_) {
     promise.set_error(td::Status::Error("Torrent closed"));
   }
+  if (piece_cache_) {
+    piece_cache_->erase_torrent(torrent_.get_hash());
+  }
   callback_->on_closed(std::move(torrent_));
 }
 
@@ -621,12 +784,10 @@ void NodeActor::loop_peer(const PeerId &peer_id, Peer &peer) {
       if (!node_state.will_upload || !should_upload_) {
         return td::Status::Error("Won't upload");
       }
-      TRY_RESULT(proof, torrent_.get_piece_proof(part_id));
-      TRY_RESULT(data, torrent_.get_piece_data(part_id));
+      TRY_RESULT(piece, get_piece_for_upload(torrent_, piece_cache_.get(), part_id));
       PeerState::Part res;
-      TRY_RESULT(proof_serialized, vm::std_boc_serialize(std::move(proof)));
-      res.proof = std::move(proof_serialized);
-      res.data = td::BufferSlice(std::move(data));
+      res.proof = std::move(piece.proof);
+      res.data = std::move(piece.data);
       td::uint64 size = res.data.size();
       upload_speed_.add(size);
       peer.upload_speed.add(size);
@@ -821,6 +982,48 @@ void NodeActor::db_store_piece(td::uint64 i, std::string s) {
            });
 }
 
+void NodeActor::db_store_verify_progress() {
+  if (!db_) {
+    return;
+  }
+  auto key = create_hash_tl_object<ton_api::storage_db_key_verifyProgress>(torrent_.get_hash());
+  auto callback = [](td::Result<td::Unit> R) {
+    if (R.is_error()) {
+      LOG(ERROR) << "Failed to save verification progress to db: " << R.move_as_error();
+    }
+  };
+  if (!verify_next_piece_) {
+    db_->erase(key, callback);
+    for (td::int32 i = 0; i < verify_steps_; ++i) {
+      db_->erase(create_hash_tl_object<ton_api::storage_db_key_verifyProgressStep>(torrent_.get_hash(), i), callback);
+    }
+    verify_steps_ = 0;
+    return;
+  }
+  db_->set(key,
+           serialize_tl_object(
+               create_tl_object<ton_api::storage_db_verifyProgress>(verify_next_piece_.value(), verify_steps_), true),
+           std::move(callback));
+}
+
+void NodeActor::db_store_verify_progress_step(td::uint64 begin, td::uint64 end) {
+  if (!db_) {
+    return;
+  }
+  // Only the result of the step is stored, so the size of the record doesn't depend on the size of the torrent
+  auto pieces = torrent_.get_ready_pieces(begin, end);
+  db_->set(create_hash_tl_object<ton_api::storage_db_key_verifyProgressStep>(torrent_.get_hash(), verify_steps_),
+           serialize_tl_object(create_tl_object<ton_api::storage_db_verifyProgressStep>(
+                                   begin, td::BufferSlice(pieces.ready_bitset), td::BufferSlice(pieces.hashes)),
+                               true),
+           [](td::Result<td::Unit> R) {
+             if (R.is_error()) {
+               LOG(ERROR) << "Failed to save verification progress to db: " << R.move_as_error();
+             }
+           });
+  ++verify_steps_;
+}
+
 void NodeActor::db_erase_piece(td::uint64 i) {
   pieces_in_db_.erase(i);
   if (!db_) {
@@ -897,6 +1100,46 @@ void NodeActor::load_from_db(std::shared_ptr<db::DbType> db, td::Bits256 hash, t
                                          active_upload_ = t.active_upload_;
                                          added_at_ = t.added_at_;
                                        }));
+      db::db_get<ton_api::storage_db_verifyProgress>(
+          *db_, create_hash_tl_object<ton_api::storage_db_key_verifyProgress>(hash_), true,
+          [SelfId = actor_id(this)](td::Result<tl_object_ptr<ton_api::storage_db_verifyProgress>> R) {
+            if (R.is_error()) {
+              td::actor::send_closure(SelfId, &Loader::finish, R.move_as_error_prefix("Verify progress: "));
+            } else {
+              td::actor::send_closure(SelfId, &Loader::got_verify_progress, R.move_as_ok());
+            }
+          });
+    }
+
+    void got_verify_progress(tl_object_ptr<ton_api::storage_db_verifyProgress> progress) {
+      verify_progress_ = std::move(progress);
+      if (verify_progress_ == nullptr || verify_progress_->steps_ <= 0) {
+        load_meta();
+        return;
+      }
+      verify_progress_steps_.resize(verify_progress_->steps_);
+      remaining_verify_progress_steps_ = verify_progress_->steps_;
+      for (td::int32 i = 0; i < verify_progress_->steps_; ++i) {
+        db::db_get<ton_api::storage_db_verifyProgressStep>(
+            *db_, create_hash_tl_object<ton_api::storage_db_key_verifyProgressStep>(hash_, i), true,
+            [SelfId = actor_id(this), i](td::Result<tl_object_ptr<ton_api::storage_db_verifyProgressStep>> R) {
+              if (R.is_error()) {
+                td::actor::send_closure(SelfId, &Loader::finish, R.move_as_error_prefix("Verify progress: "));
+              } else {
+                td::actor::send_closure(SelfId, &Loader::got_verify_progress_step, i, R.move_as_ok());
+              }
+            });
+      }
+    }
+
+    void got_verify_progress_step(td::int32 i, tl_object_ptr<ton_api::storage_db_verifyProgressStep> step) {
+      verify_progress_steps_[i] = std::move(step);
+      if (--remaining_verify_progress_steps_ == 0) {
+        load_meta();
+      }
+    }
+
+    void load_meta() {
       db_->get(create_hash_tl_object<ton_api::storage_db_key_torrentMeta>(hash_),
                [SelfId = actor_id(this)](td::Result<db::DbType::GetResult> R) {
                  if (R.is_error()) {
@@ -920,7 +1163,8 @@ void NodeActor::load_from_db(std::shared_ptr<db::DbType> db, td::Bits256 hash, t
         options.validate = false;
         if (meta_str) {
           TRY_RESULT(meta, TorrentMeta::deserialize(meta_str.value().as_slice()));
-          options.validate = true;
+          // If verification of files was interrupted, it will be resumed by NodeActor
+          options.validate = verify_progress_ == nullptr;
           return Torrent::open(std::move(options), std::move(meta));
         } else {
           return Torrent::open(std::move(options), hash_);
@@ -1021,6 +1265,12 @@ void NodeActor::load_from_db(std::shared_ptr<db::DbType> db, td::Bits256 hash, t
       data.priorities = std::move(priorities_);
       data.pieces_in_db = std::move(pieces_in_db_);
       data.added_at = added_at_;
+      data.verify_progress = std::move(verify_progress_);
+      for (auto &step : verify_progress_steps_) {
+        if (step != nullptr) {
+          data.verify_progress_steps.push_back(std::move(step));
+        }
+      }
       finish(td::actor::create_actor<NodeActor>("Node", 1, torrent_.unwrap(), std::move(callback_),
                                                 std::move(node_callback_), std::move(db_), std::move(speed_limiters_),
                                                 active_download_, active_upload_, std::move(data)));
@@ -1042,6 +1292,9 @@ void NodeActor::load_from_db(std::shared_ptr<db::DbType> db, td::Bits256 hash, t
     std::vector<PendingSetFilePriority> priorities_;
     std::set<td::uint64> pieces_in_db_;
     size_t remaining_pieces_in_db_ = 0;
+    tl_object_ptr<ton_api::storage_db_verifyProgress> verify_progress_;
+    std::vector<tl_object_ptr<ton_api::storage_db_verifyProgressStep>> verify_progress_steps_;
+    td::int32 remaining_verify_progress_steps_ = 0;
   };
   td::actor::create_actor<Loader>("loader", std::move(db), hash, std::move(callback), std::move(node_callback),
                                   std::move(speed_limiters), std::move(promise))
@@ -1055,6 +1308,26 @@ void NodeActor::cleanup_db(std::shared_ptr<db::DbType> db, td::Bits256 hash, td:
   db->erase(create_hash_tl_object<ton_api::storage_db_key_torrent>(hash), ig.get_promise());
   db->erase(create_hash_tl_object<ton_api::storage_db_key_torrentMeta>(hash), ig.get_promise());
   db->erase(create_hash_tl_object<ton_api::storage_db_key_priorities>(hash), ig.get_promise());
+  db::db_get<ton_api::storage_db_verifyProgress>(
+      *db, create_hash_tl_object<ton_api::storage_db_key_verifyProgress>(hash), true,
+      [db, promise = ig.get_promise(), hash](td::Result<tl_object_ptr<ton_api::storage_db_verifyProgress>> R) mutable {
+        if (R.is_error()) {
+          promise.set_error(R.move_as_error());
+          return;
+        }
+        auto progress = R.move_as_ok();
+        if (progress == nullptr) {
+          promise.set_result(td::Unit());
+          return;
+        }
+        td::MultiPromise mp;
+        auto ig = mp.init_guard();
+        ig.add_promise(std::move(promise));
+        db->erase(create_hash_tl_object<ton_api::storage_db_key_verifyProgress>(hash), ig.get_promise());
+        for (td::int32 i = 0; i < progress->steps_; ++i) {
+          db->erase(create_hash_tl_object<ton_api::storage_db_key_verifyProgressStep>(hash, i), ig.get_promise());
+        }
+      });
   db::db_get<ton_api::storage_db_piecesInDb>(
       *db, create_hash_tl_object<ton_api::storage_db_key_piecesInDb>(hash), true,
       [db, promise = ig.get_promise(), hash](td::Result<tl_object_ptr<ton_api::storage_db_piecesInDb>> R) mutable {
@@ -22,6 +22,7 @@
 #include "LoadSpeed.h"
 #include "PartsHelper.h"
 #include "PeerActor.h"
+#include "PieceCache.h"
 #include "Torrent.h"
 #include "SpeedLimiter.h"
 
@@ -33,6 +34,15 @@
 
 namespace ton {
 
+// Reads and hashes pieces for NodeActor::verify_files(), so that NodeActor is not blocked by file reads
+class VerifyFilesWorker : public td::actor::Actor {
+ public:
+  void hash_pieces(std::shared_ptr<const Torrent::RevalidationTask> task, td::uint64 begin, td::uint64 end,
+                   td::Promise<std::vector<td::optional<td::Bits256>>> promise) {
+    promise.set_value(task->hash_pieces(begin, end));
+  }
+};
+
 class NodeActor : public td::actor::Actor {
  public:
   class NodeCallback {
@@ -63,6 +73,8 @@ class NodeActor : public td::actor::Actor {
     std::vector<PendingSetFilePriority> priorities;
     std::set<td::uint64> pieces_in_db;
     td::uint32 added_at;
+    tl_object_ptr<ton_api::storage_db_verifyProgress> verify_progress;
+    std::vector<tl_object_ptr<ton_api::storage_db_verifyProgressStep>> verify_progress_steps;
   };
 
   NodeActor(PeerId self_id, ton::Torrent torrent, td::unique_ptr<Callback> callback,
@@ -97,6 +109,12 @@ class NodeActor : public td::actor::Actor {
 
   void load_from(td::optional<TorrentMeta> meta, std::string files_path, td::Promise<td::Unit> promise);
   void copy_to_new_root_dir(std::string new_root_dir, td::Promise<td::Unit> promise);
+  // Rereads all pieces from files in background, pieces that don't match are marked as not ready.
+  // The progress is saved to db, so verification continues after restart.
+  void verify_files(td::Promise<td::Unit> promise);
+
+  // Pieces uploaded to peers are taken from and stored to the shared cache
+  void set_piece_cache(std::shared_ptr<PieceCache> piece_cache);
 
   void wait_for_completion(td::Promise<td::Unit> promise);
   void get_peers_info(td::Promise<tl_object_ptr<ton_api::storage_daemon_peerList>> promise);
@@ -106,6 +124,10 @@ class NodeActor : public td::actor::Actor {
                            td::Promise<td::actor::ActorOwn<NodeActor>> promise);
   static void cleanup_db(std::shared_ptr<db::DbType> db, td::Bits256 hash, td::Promise<td::Unit> promise);
 
+  // Returns data and proof of a piece requested by a peer, piece_cache may be null
+  static td::Result<PieceCache::Piece> get_piece_for_upload(Torrent &torrent, PieceCache *piece_cache,
+                                                            td::uint64 piece_i);
+
  private:
   PeerId self_id_;
   ton::Torrent torrent_;
@@ -118,6 +140,7 @@ class NodeActor : public td::actor::Actor {
   bool should_upload_{false};
   td::uint32 added_at_{0};
   SpeedLimiters speed_limiters_;
+  std::shared_ptr<PieceCache> piece_cache_;
 
   class Notifier : public td::actor::Actor {
    public:
@@ -175,9 +198,25 @@ class NodeActor : public td::actor::Actor {
   td::int64 last_stored_meta_count_ = -1;
   td::Timestamp next_db_store_meta_at_ = td::Timestamp::now();
 
+  static constexpr td::uint64 VERIFY_STEP_SIZE = 256 << 20;
+  td::optional<td::uint64> verify_next_piece_;
+  size_t verify_broken_pieces_{0};
+  td::int32 verify_steps_{0};
+  // The current step: its range is hashed by verify_workers_ in parts, the results are applied when all parts are done
+  std::shared_ptr<const Torrent::RevalidationTask> verify_task_;
+  std::vector<td::optional<td::Bits256>> verify_hashes_;
+  size_t verify_pending_parts_{0};
+  std::vector<td::actor::ActorOwn<VerifyFilesWorker>> verify_workers_;
+  tl_object_ptr<ton_api::storage_db_verifyProgress> verify_progress_to_restore_;
+  std::vector<tl_object_ptr<ton_api::storage_db_verifyProgressStep>> verify_progress_steps_to_restore_;
+
   void init_torrent();
   void init_torrent_header();
   void recheck_parts(Torrent::PartsRange range);
+  void verify_files_step();
+  void got_verify_hashes(std::shared_ptr<const Torrent::RevalidationTask> task, td::uint64 begin,
+                         td::Result<std::vector<td::optional<td::Bits256>>> R);
+  void finish_verify_files();
 
   void on_signal_from_peer(PeerId peer_id);
 
@@ -210,5 +249,7 @@ class NodeActor : public td::actor::Actor {
   void db_store_piece(td::uint64 i, std::string s);
   void db_erase_piece(td::uint64 i);
   void db_update_pieces_list();
+  void db_store_verify_progress();
+  void db_store_verify_progress_step(td::uint64 begin, td::uint64 end);
 };
 }  // namespace ton
@@ -0,0 +1,105 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+#include "PieceCache.h"
+
+#include <limits>
+
+namespace ton {
+
+td::optional<PieceCache::Piece> PieceCache::get(const td::Bits256 &hash, td::uint64 piece_i) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(Key{hash, piece_i});
+  if (it == entries_.end()) {
+    misses_++;
+    return {};
+  }
+  hits_++;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->piece.clone();
+}
+
+void PieceCache::put(const td::Bits256 &hash, td::uint64 piece_i, const Piece &piece) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (entry_size(piece) > max_size_) {
+    return;
+  }
+  Key key{hash, piece_i};
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    erase(it);
+  }
+  lru_.push_front(Entry{key, piece.clone()});
+  entries_.emplace(key, lru_.begin());
+  size_ += entry_size(piece);
+  shrink();
+}
+
+void PieceCache::erase(const td::Bits256 &hash, td::uint64 piece_i) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(Key{hash, piece_i});
+  if (it != entries_.end()) {
+    erase(it);
+  }
+}
+
+void PieceCache::erase_range(const td::Bits256 &hash, td::uint64 begin, td::uint64 end) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.lower_bound(Key{hash, begin});
+  while (it != entries_.end() && it->first.first == hash && it->first.second < end) {
+    erase(it++);
+  }
+}
+
+void PieceCache::erase_torrent(const td::Bits256 &hash) {
+  erase_range(hash, 0, std::numeric_limits<td::uint64>::max());
+}
+
+void PieceCache::set_max_size(td::uint64 max_size) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  max_size_ = max_size;
+  shrink();
+}
+
+PieceCache::Stats PieceCache::get_stats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  Stats stats;
+  stats.max_size = max_size_;
+  stats.size = size_;
+  stats.entries = entries_.size();
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  return stats;
+}
+
+void PieceCache::erase(std::map<Key, std::list<Entry>::iterator>::iterator it) {
+  size_ -= entry_size(it->second->piece);
+  lru_.erase(it->second);
+  entries_.erase(it);
+}
+
+void PieceCache::shrink() {
+  while (size_ > max_size_) {
+    CHECK(!lru_.empty());
+    erase(entries_.find(lru_.back().key));
+    evictions_++;
+  }
+}
+
+}  // namespace ton
@@ -0,0 +1,89 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+#pragma once
+
+#include "common/bitstring.h"
+#include "td/utils/buffer.h"
+#include "td/utils/optional.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace ton {
+
+// Pieces served to peers, shared between all torrents of the daemon.
+// Data and proof of a piece are kept in refcounted buffers, so a hot piece is read from files once and then
+// every peer gets a reference to the same buffer. The cache is thread-safe.
+class PieceCache {
+ public:
+  struct Piece {
+    td::BufferSlice data;
+    td::BufferSlice proof;
+
+    Piece clone() const {
+      return Piece{data.clone(), proof.clone()};
+    }
+  };
+
+  struct Stats {
+    td::uint64 max_size{0};
+    td::uint64 size{0};
+    td::uint64 entries{0};
+    td::uint64 hits{0};
+    td::uint64 misses{0};
+    td::uint64 evictions{0};
+  };
+
+  explicit PieceCache(td::uint64 max_size) : max_size_(max_size) {
+  }
+
+  td::optional<Piece> get(const td::Bits256 &hash, td::uint64 piece_i);
+  void put(const td::Bits256 &hash, td::uint64 piece_i, const Piece &piece);
+  void erase(const td::Bits256 &hash, td::uint64 piece_i);
+  // Erases pieces [begin, end) of the torrent
+  void erase_range(const td::Bits256 &hash, td::uint64 begin, td::uint64 end);
+  void erase_torrent(const td::Bits256 &hash);
+  void set_max_size(td::uint64 max_size);
+  Stats get_stats() const;
+
+ private:
+  using Key = std::pair<td::Bits256, td::uint64>;
+  struct Entry {
+    Key key;
+    Piece piece;
+  };
+
+  mutable std::mutex mutex_;
+  td::uint64 max_size_;
+  td::uint64 size_{0};
+  td::uint64 hits_{0};
+  td::uint64 misses_{0};
+  td::uint64 evictions_{0};
+  std::list<Entry> lru_;  // most recently used first
+  std::map<Key, std::list<Entry>::iterator> entries_;
+
+  static td::uint64 entry_size(const Piece &piece) {
+    return piece.data.size() + piece.proof.size();
+  }
+  void erase(std::map<Key, std::list<Entry>::iterator>::iterator it);
+  void shrink();
+};
+
+}  // namespace ton
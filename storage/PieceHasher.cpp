@@ -0,0 +1,114 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+
+#include "PieceHasher.h"
+
+#include "td/utils/buffer.h"
+#include "td/utils/crypto.h"
+#include "td/utils/port/thread.h"
+
+#include <atomic>
+
+namespace ton {
+
+size_t PieceHasher::get_threads_count(size_t threads_count) {
+  if (threads_count == 0) {
+    threads_count = td::thread::hardware_concurrency();
+  }
+  return td::max<size_t>(threads_count, 1);
+}
+
+std::vector<td::optional<td::Bits256>> PieceHasher::run(const Options &options, td::uint64 begin, td::uint64 end,
+                                                        const Reader &reader,
+                                                        const std::function<bool(td::uint64)> &need,
+                                                        const ErrorCallback &on_error) {
+  CHECK(options.piece_size > 0);
+  CHECK(begin <= end);
+  std::vector<td::optional<td::Bits256>> result(end - begin);
+  if (begin == end) {
+    return result;
+  }
+  td::uint64 batch_pieces = td::max<td::uint64>(options.read_ahead_size / options.piece_size, 1);
+  td::uint64 batches_count = (end - begin + batch_pieces - 1) / batch_pieces;
+  size_t threads_count = (size_t)td::min<td::uint64>(get_threads_count(options.threads_count), batches_count);
+
+  auto piece_size = [&](td::uint64 piece_i) {
+    return td::min<td::uint64>(options.piece_size, options.data_size - piece_i * options.piece_size);
+  };
+
+  std::atomic<td::uint64> next_batch{0};
+  auto worker = [&] {
+    td::BufferSlice buffer(batch_pieces * options.piece_size);
+    while (true) {
+      td::uint64 batch = next_batch++;
+      if (batch >= batches_count) {
+        break;
+      }
+      td::uint64 l = begin + batch * batch_pieces;
+      td::uint64 r = td::min(end, l + batch_pieces);
+      while (l < r) {
+        // Take the longest run of pieces that are needed and read it at once
+        if (need && !need(l)) {
+          ++l;
+          continue;
+        }
+        td::uint64 run_end = l + 1;
+        while (run_end < r && (!need || need(run_end))) {
+          ++run_end;
+        }
+        td::uint64 offset = l * options.piece_size;
+        td::uint64 size = (run_end - 1 - l) * options.piece_size + piece_size(run_end - 1);
+        auto data = buffer.as_slice().substr(0, size);
+        if (reader(data, offset).is_ok()) {
+          for (td::uint64 i = l; i < run_end; ++i) {
+            td::Bits256 hash;
+            td::sha256(data.substr((i - l) * options.piece_size, piece_size(i)), hash.as_slice());
+            result[i - begin] = hash;
+          }
+        } else {
+          // Some of the pieces are unavailable, fall back to reading them one by one
+          for (td::uint64 i = l; i < run_end; ++i) {
+            auto piece = buffer.as_slice().substr(0, piece_size(i));
+            auto status = reader(piece, i * options.piece_size);
+            if (status.is_ok()) {
+              td::Bits256 hash;
+              td::sha256(piece, hash.as_slice());
+              result[i - begin] = hash;
+            } else if (on_error) {
+              on_error(i, std::move(status));
+            }
+          }
+        }
+        l = run_end;
+      }
+    }
+  };
+
+  std::vector<td::thread> threads;
+  for (size_t i = 1; i < threads_count; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return result;
+}
+
+}  // namespace ton
@@ -0,0 +1,57 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+
+#pragma once
+
+#include "common/bitstring.h"
+#include "td/utils/common.h"
+#include "td/utils/optional.h"
+#include "td/utils/Slice.h"
+#include "td/utils/Status.h"
+
+#include <functional>
+
+namespace ton {
+// Computes sha256 of torrent pieces on several threads.
+// Consecutive pieces are grouped into batches of read_ahead_size bytes. Each batch is read with one call and then
+// hashed piece by piece, so workers read large contiguous blocks instead of issuing a read for every piece.
+class PieceHasher {
+ public:
+  struct Options {
+    td::uint32 piece_size{0};
+    td::uint64 data_size{0};
+    size_t threads_count{0};  // 0 - use all available cores
+    size_t read_ahead_size{8 << 20};
+  };
+
+  // Reads data[offset, offset + dest.size()) into dest. It is called concurrently from worker threads.
+  using Reader = std::function<td::Status(td::MutableSlice dest, td::uint64 offset)>;
+  // Receives the error for a piece that couldn't be read. It is called concurrently from worker threads.
+  using ErrorCallback = std::function<void(td::uint64 piece_i, td::Status error)>;
+
+  // Computes hashes of pieces [begin, end) for which need(piece_i) is true (all pieces if need is empty).
+  // Returns end - begin hashes. The hash is empty if the piece was skipped or couldn't be read.
+  static std::vector<td::optional<td::Bits256>> run(const Options &options, td::uint64 begin, td::uint64 end,
+                                                    const Reader &reader,
+                                                    const std::function<bool(td::uint64)> &need = {},
+                                                    const ErrorCallback &on_error = {});
+
+  static size_t get_threads_count(size_t threads_count);
+};
+}  // namespace ton
@@ -18,6 +18,7 @@
 */
 
 #include "Torrent.h"
+#include "PieceHasher.h"
 
 #include "td/utils/Status.h"
 #include "td/utils/crypto.h"
@@ -54,7 +55,7 @@ td::Result<Torrent> Torrent::open(Options options, TorrentMeta meta) {
     res.set_root_dir(options.root_dir);
   }
   if (options.validate) {
-    res.validate();
+    res.validate(options.validate_threads);
   }
   return std::move(res);
 }
@@ -189,7 +190,7 @@ std::string Torrent::get_stats_str() const {
   return sb.as_cslice().str();
 }
 
-void Torrent::validate() {
+void Torrent::validate(size_t threads_count) {
   if (!inited_info_ || !header_) {
     return;
   }
@@ -200,66 +201,281 @@ void Torrent::validate() {
   included_ready_size_ = 0;
   for (auto &chunk : chunks_) {
     chunk.ready_size = 0;
-    if (root_dir_) {
-      if (td::stat(get_chunk_path(chunk.name)).is_error()) {
-        continue;
+  }
+  init_existing_chunks();
+  validate_range(0, info_.pieces_count(), threads_count);
+}
+
+size_t Torrent::revalidate_pieces(td::uint64 begin, td::uint64 end, size_t threads_count) {
+  auto r_task = start_revalidation(begin, end);
+  if (r_task.is_error()) {
+    return 0;
+  }
+  auto task = r_task.move_as_ok();
+  return finish_revalidation(task, task.hash_pieces(begin, end, threads_count));
+}
+
+td::Result<Torrent::RevalidationTask> Torrent::start_revalidation(td::uint64 begin, td::uint64 end) const {
+  if (!inited_info_ || !header_) {
+    return td::Status::Error("Torrent header is not available");
+  }
+  if (!root_dir_) {
+    return td::Status::Error("Torrent is kept in memory");
+  }
+  CHECK(begin <= end && end <= info_.pieces_count());
+  RevalidationTask task;
+  task.begin = begin;
+  task.end = end;
+  task.piece_size = info_.piece_size;
+  task.data_size = info_.file_size;
+  task.header = header_.value().serialize().as_slice().str();
+  for (size_t i = 0; i < chunks_.size(); ++i) {
+    auto &chunk = chunks_[i];
+    task.files.push_back(RevalidationTask::File{i == 0 ? "" : get_chunk_path(chunk.name), chunk.offset, chunk.size});
+  }
+  for (auto i = begin; i < end; ++i) {
+    bool in_memory = in_memory_pieces_.count(i) > 0;
+    task.skip.push_back(in_memory);
+    task.was_ready.push_back(piece_is_ready_[i] && !in_memory);
+  }
+  return std::move(task);
+}
+
+std::vector<td::optional<td::Bits256>> Torrent::RevalidationTask::hash_pieces(td::uint64 l, td::uint64 r,
+                                                                              size_t threads_count) const {
+  CHECK(begin <= l && l <= r && r <= end);
+  // Files of the range are opened again, so the torrent itself is not used here
+  td::uint64 data_begin = l * piece_size;
+  td::uint64 data_end = td::min(r * piece_size, data_size);
+  std::vector<td::BlobView> blobs(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    auto &file = files[i];
+    if (file.size == 0 || file.offset >= data_end || file.offset + file.size <= data_begin) {
+      continue;
+    }
+    if (file.path.empty()) {
+      blobs[i] = td::BufferSliceBlobView::create(td::BufferSlice(header));
+    } else {
+      auto r_blob = td::FileNoCacheBlobView::create(file.path);
+      if (r_blob.is_ok()) {
+        blobs[i] = r_blob.move_as_ok();
       }
     }
-    init_chunk_data(chunk);
   }
+  auto read = [&](td::MutableSlice dest, td::uint64 offset) -> td::Status {
+    auto it = std::lower_bound(files.begin(), files.end(), offset, [](const File &file, td::uint64 offset) {
+      return file.offset + file.size <= offset;
+    });
+    for (; !dest.empty(); ++it) {
+      CHECK(it != files.end());
+      if (it->size == 0) {
+        continue;
+      }
+      auto &blob = blobs[it - files.begin()];
+      if (!blob) {
+        return td::Status::Error(NO_SUCH_FILE_ERROR, "No such file");
+      }
+      auto chunk_offset = offset - it->offset;
+      auto size = td::min<td::uint64>(dest.size(), it->size - chunk_offset);
+      if (blob.size() < chunk_offset + size) {
+        return td::Status::Error("Don't have piece");
+      }
+      TRY_RESULT(read_size, blob.view_copy(dest.substr(0, size), chunk_offset));
+      if (read_size != size) {
+        return td::Status::Error("Failed to read the whole chunk");
+      }
+      dest.remove_prefix(size);
+      offset += size;
+    }
+    return td::Status::OK();
+  };
+  PieceHasher::Options options;
+  options.piece_size = piece_size;
+  options.data_size = data_size;
+  options.threads_count = threads_count;
+  return PieceHasher::run(
+      options, l, r, read, [&](td::uint64 piece_i) { return !skip[piece_i - begin]; },
+      [](td::uint64 piece_i, td::Status error) {
+        // Missing files are expected, they are just skipped
+        LOG_IF(ERROR, error.code() != NO_SUCH_FILE_ERROR) << "Failed: " << error;
+      });
+}
 
-  std::vector<td::UInt256> hashes;
+size_t Torrent::finish_revalidation(const RevalidationTask &task, std::vector<td::optional<td::Bits256>> hashes) {
+  CHECK(inited_info_ && header_);
+  CHECK(hashes.size() == task.end - task.begin);
+  init_existing_chunks();
   std::vector<std::pair<size_t, td::Bits256>> pieces;
+  for (auto i = task.begin; i < task.end; ++i) {
+    if (hashes[i - task.begin] && !task.skip[i - task.begin]) {
+      pieces.emplace_back(i, hashes[i - task.begin].value());
+    }
+  }
+  std::set<td::uint64> ok;
+  for (size_t piece_i : merkle_tree_.add_pieces(std::move(pieces))) {
+    ok.insert(piece_i);
+  }
+  size_t broken = 0;
+  for (auto i = task.begin; i < task.end; ++i) {
+    if (task.skip[i - task.begin] || in_memory_pieces_.count(i)) {
+      continue;
+    }
+    if (ok.count(i)) {
+      if (!piece_is_ready_[i]) {
+        mark_piece_ready(i);
+      }
+    } else if (task.was_ready[i - task.begin] && piece_is_ready_[i]) {
+      mark_piece_not_ready(i);
+      ++broken;
+    }
+  }
+  return broken;
+}
 
-  auto flush = [&] {
-    for (size_t piece_i : merkle_tree_.add_pieces(std::move(pieces))) {
-      auto piece = info_.get_piece_info(piece_i);
-      iterate_piece(piece, [&](auto it, auto info) {
-        it->ready_size += info.size;
-        if (!it->excluded) {
-          included_ready_size_ += info.size;
-        }
-        return td::Status::OK();
-      });
-      piece_is_ready_[piece_i] = true;
-      ready_parts_count_++;
-      CHECK(not_ready_piece_count_);
-      not_ready_piece_count_--;
+Torrent::ReadyPieces Torrent::get_ready_pieces(td::uint64 begin, td::uint64 end) const {
+  CHECK(begin <= end && end <= info_.pieces_count());
+  ReadyPieces res;
+  res.begin = begin;
+  res.ready_bitset.assign(td::narrow_cast<size_t>((end - begin + 7) / 8), '\0');
+  res.hashes.assign(td::narrow_cast<size_t>((end - begin) * 32), '\0');
+  for (auto i = begin; i < end; ++i) {
+    auto j = td::narrow_cast<size_t>(i - begin);
+    auto r_hash = merkle_tree_.get_piece_hash(i);
+    if (r_hash.is_ok()) {
+      td::MutableSlice(res.hashes).substr(j * 32, 32).copy_from(r_hash.ok().as_slice());
     }
-    hashes.clear();
-    pieces.clear();
-  };
+    if (piece_is_ready_[i]) {
+      res.ready_bitset[j / 8] |= (char)(1 << (j % 8));
+    }
+  }
+  return res;
+}
 
-  td::BufferSlice buf(info_.piece_size);
-  ChunkState::Cache cache;
-  cache.slice = td::BufferSlice(td::max(8u << 20, info_.piece_size));
-  for (size_t piece_i = 0; piece_i < info_.pieces_count(); piece_i++) {
-    auto piece = info_.get_piece_info(piece_i);
-    td::Sha256State sha256;
-    sha256.init();
-    bool skipped = false;
-    auto is_ok = iterate_piece(piece, [&](auto it, auto info) {
-      if (!it->data) {
-        skipped = true;
-        return td::Status::Error("No such file");
+td::uint64 Torrent::restore_ready_pieces(const std::vector<ReadyPieces> &ranges) {
+  if (!inited_info_ || !header_) {
+    return 0;
+  }
+  init_existing_chunks();
+  // piece -> (hash, was ready)
+  std::map<td::uint64, std::pair<td::Bits256, bool>> pieces;
+  for (auto &range : ranges) {
+    for (size_t j = 0; j < range.hashes.size() / 32 && range.begin + j < info_.pieces_count(); ++j) {
+      td::Bits256 hash;
+      hash.as_slice().copy_from(td::Slice(range.hashes).substr(j * 32, 32));
+      bool ready = j / 8 < range.ready_bitset.size() && ((range.ready_bitset[j / 8] >> (j % 8)) & 1);
+      if (hash.is_zero()) {
+        pieces.erase(range.begin + j);
+      } else {
+        pieces[range.begin + j] = {hash, ready};
       }
-      if (!it->has_piece(info.chunk_offset, info.size)) {
+    }
+  }
+  std::vector<std::pair<size_t, td::Bits256>> hashes;
+  for (auto &p : pieces) {
+    hashes.emplace_back(td::narrow_cast<size_t>(p.first), p.second.first);
+  }
+  // Hashes of the pieces that are not ready are added too, they complete the subtrees of the merkle tree
+  auto ok_pieces = merkle_tree_.add_pieces(std::move(hashes));
+  std::set<td::uint64> ok(ok_pieces.begin(), ok_pieces.end());
+  td::uint64 first_failed = info_.pieces_count();
+  for (auto &p : pieces) {
+    auto i = p.first;
+    if (!p.second.second || piece_is_ready_[i]) {
+      continue;
+    }
+    auto S = iterate_piece(info_.get_piece_info(i), [&](auto it, auto info) {
+      if (!it->data || !it->has_piece(info.chunk_offset, info.size)) {
         return td::Status::Error("Don't have piece");
       }
-      auto dest = buf.as_slice().truncate(info.size);
-      TRY_STATUS(it->get_piece(dest, info.chunk_offset, &cache));
-      sha256.feed(dest);
       return td::Status::OK();
     });
-    if (is_ok.is_error()) {
-      LOG_IF(ERROR, !skipped) << "Failed: " << is_ok;
+    if (S.is_ok() && ok.count(i)) {
+      mark_piece_ready(i);
+    } else {
+      first_failed = td::min(first_failed, i);
+    }
+  }
+  return first_failed;
+}
+
+void Torrent::init_existing_chunks() {
+  for (auto &chunk : chunks_) {
+    if (chunk.data) {
       continue;
     }
-    td::Bits256 hash;
-    sha256.extract(hash.as_slice());
-    pieces.emplace_back(piece_i, hash);
+    if (root_dir_) {
+      if (td::stat(get_chunk_path(chunk.name)).is_error()) {
+        continue;
+      }
+    }
+    init_chunk_data(chunk).ignore();
+  }
+}
+
+td::Status Torrent::read_from_files(td::MutableSlice dest, td::uint64 offset) {
+  return iterate_piece(Info::PieceInfo{offset, dest.size()}, [&](auto it, auto info) {
+    if (!it->data) {
+      return td::Status::Error(NO_SUCH_FILE_ERROR, "No such file");
+    }
+    if (!it->has_piece(info.chunk_offset, info.size)) {
+      return td::Status::Error("Don't have piece");
+    }
+    return it->get_piece(dest.substr(info.piece_offset, info.size), info.chunk_offset);
+  });
+}
+
+void Torrent::validate_range(td::uint64 begin, td::uint64 end, size_t threads_count) {
+  PieceHasher::Options options;
+  options.piece_size = info_.piece_size;
+  options.data_size = info_.file_size;
+  options.threads_count = threads_count;
+  auto hashes = PieceHasher::run(
+      options, begin, end, [&](td::MutableSlice dest, td::uint64 offset) { return read_from_files(dest, offset); },
+      [&](td::uint64 piece_i) { return !piece_is_ready_[piece_i]; },
+      [](td::uint64 piece_i, td::Status error) {
+        // Missing files are expected, they are just skipped
+        LOG_IF(ERROR, error.code() != NO_SUCH_FILE_ERROR) << "Failed: " << error;
+      });
+
+  std::vector<std::pair<size_t, td::Bits256>> pieces;
+  for (auto i = begin; i < end; ++i) {
+    if (hashes[i - begin]) {
+      pieces.emplace_back(i, hashes[i - begin].value());
+    }
+  }
+  for (size_t piece_i : merkle_tree_.add_pieces(std::move(pieces))) {
+    mark_piece_ready(piece_i);
   }
-  flush();
+}
+
+void Torrent::mark_piece_ready(td::uint64 piece_i) {
+  auto piece = info_.get_piece_info(piece_i);
+  iterate_piece(piece, [&](auto it, auto info) {
+    it->ready_size += info.size;
+    if (!it->excluded) {
+      included_ready_size_ += info.size;
+    }
+    return td::Status::OK();
+  });
+  piece_is_ready_[piece_i] = true;
+  ready_parts_count_++;
+  CHECK(not_ready_piece_count_);
+  not_ready_piece_count_--;
+}
+
+void Torrent::mark_piece_not_ready(td::uint64 piece_i) {
+  auto piece = info_.get_piece_info(piece_i);
+  iterate_piece(piece, [&](auto it, auto info) {
+    it->ready_size -= info.size;
+    if (!it->excluded) {
+      included_ready_size_ -= info.size;
+    }
+    return td::Status::OK();
+  });
+  piece_is_ready_[piece_i] = false;
+  CHECK(ready_parts_count_);
+  ready_parts_count_--;
+  not_ready_piece_count_++;
 }
 
 td::Result<std::string> Torrent::get_piece_data(td::uint64 piece_i) {
@@ -283,12 +499,41 @@ td::Result<std::string> Torrent::get_piece_data(td::uint64 piece_i) {
   auto piece = info_.get_piece_info(piece_i);
 
   std::string res(piece.size, '\0');
-  iterate_piece(piece, [&](auto it, auto info) {
-    return it->get_piece(td::MutableSlice(res).substr(info.piece_offset, info.size), info.chunk_offset);
-  });
+  read_ready_piece(piece, res).ignore();
   return res;
 }
 
+td::Result<td::BufferSlice> Torrent::get_piece_buffer(td::uint64 piece_i) {
+  if (!inited_info_) {
+    return td::Status::Error("Torrent info not inited");
+  }
+  if (piece_i >= info_.pieces_count()) {
+    return td::Status::Error("Piece idx is too big");
+  }
+  if (!piece_is_ready_[piece_i]) {
+    return td::Status::Error("Piece is not ready");
+  }
+  auto it = pending_pieces_.find(piece_i);
+  if (it != pending_pieces_.end()) {
+    return td::BufferSlice(it->second);
+  }
+  auto it2 = in_memory_pieces_.find(piece_i);
+  if (it2 != in_memory_pieces_.end()) {
+    return td::BufferSlice(it2->second.data);
+  }
+  auto piece = info_.get_piece_info(piece_i);
+
+  td::BufferSlice res(piece.size);
+  TRY_STATUS(read_ready_piece(piece, res.as_slice()));
+  return std::move(res);
+}
+
+td::Status Torrent::read_ready_piece(Info::PieceInfo piece, td::MutableSlice dest) {
+  return iterate_piece(piece, [&](auto it, auto info) {
+    return it->get_piece(dest.substr(info.piece_offset, info.size), info.chunk_offset);
+  });
+}
+
 td::Result<td::Ref<vm::Cell>> Torrent::get_piece_proof(td::uint64 piece_i) {
   if (!inited_info_) {
     return td::Status::Error("Torrent info not inited");
@@ -676,18 +921,43 @@ void Torrent::load_from_files(std::string files_path) {
     }));
     return data;
   };
+  PieceHasher::Options options;
+  options.piece_size = info_.piece_size;
+  options.data_size = info_.file_size;
+  auto hashes = PieceHasher::run(
+      options, 0, info_.pieces_count(),
+      [&](td::MutableSlice dest, td::uint64 offset) -> td::Status {
+        return iterate_piece(Info::PieceInfo{offset, dest.size()}, [&](auto it, IterateInfo info) {
+          size_t chunk_i = it - chunks_.begin();
+          if (!new_blobs[chunk_i]) {
+            return td::Status::Error("No such file");
+          }
+          TRY_RESULT(s, new_blobs[chunk_i].value().view_copy(dest.substr(info.piece_offset, info.size),
+                                                             info.chunk_offset));
+          if (s != info.size) {
+            return td::Status::Error("Can't read file");
+          }
+          return td::Status::OK();
+        });
+      },
+      [&](td::uint64 piece_i) {
+        if (piece_is_ready_[piece_i]) {
+          return false;
+        }
+        bool included = false;
+        iterate_piece(info_.get_piece_info(piece_i), [&](auto it, IterateInfo info) {
+          if (!it->excluded) {
+            included = true;
+          }
+          return td::Status::OK();
+        });
+        return included;
+      });
   std::vector<std::pair<size_t, td::Bits256>> new_pieces;
-  for (size_t i = 0; i < piece_is_ready_.size(); ++i) {
-    if (piece_is_ready_[i]) {
-      continue;
-    }
-    auto r_data = load_new_piece(i);
-    if (r_data.is_error()) {
-      continue;
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    if (hashes[i]) {
+      new_pieces.emplace_back(i, hashes[i].value());
     }
-    td::Bits256 hash;
-    td::sha256(r_data.ok(), hash.as_slice());
-    new_pieces.emplace_back(i, hash);
   }
   size_t added_cnt = 0;
   for (size_t i : merkle_tree_.add_pieces(std::move(new_pieces))) {
@@ -38,13 +38,53 @@ class Torrent {
     std::string root_dir;
     bool in_memory{false};
     bool validate{false};
+    size_t validate_threads{0};  // 0 - use all available cores
   };
 
   // creation
   static td::Result<Torrent> open(Options options, td::Bits256 hash);
   static td::Result<Torrent> open(Options options, TorrentMeta meta);
   static td::Result<Torrent> open(Options options, td::Slice meta_str);
-  void validate();
+  void validate(size_t threads_count = 0);
+  // Reads pieces [begin, end) from files and checks them again. Pieces kept in memory are not rechecked.
+  // Returns the number of pieces that were ready, but failed the check.
+  size_t revalidate_pieces(td::uint64 begin, td::uint64 end, size_t threads_count = 0);
+  // revalidate_pieces() split into steps, so that files can be read and hashed without the torrent (e.g. in other
+  // actors): start_revalidation() captures the files and ready pieces of the range, RevalidationTask::hash_pieces()
+  // opens the files again and hashes a part of the range, finish_revalidation() checks the hashes against the merkle
+  // tree and updates ready pieces. Pieces that became ready in the meantime are kept.
+  struct RevalidationTask {
+    struct File {
+      std::string path;  // empty for the header, it is kept in memory
+      td::uint64 offset{0};
+      td::uint64 size{0};
+    };
+    td::uint64 begin{0};
+    td::uint64 end{0};
+    td::uint32 piece_size{0};
+    td::uint64 data_size{0};
+    std::string header;
+    std::vector<File> files;
+    std::vector<bool> was_ready;  // piece begin + i was ready
+    std::vector<bool> skip;       // piece begin + i is kept in memory and is not rechecked
+
+    // Returns r - l hashes, the hash is empty if the piece was skipped or couldn't be read
+    std::vector<td::optional<td::Bits256>> hash_pieces(td::uint64 l, td::uint64 r, size_t threads_count = 1) const;
+  };
+  td::Result<RevalidationTask> start_revalidation(td::uint64 begin, td::uint64 end) const;
+  // Returns the number of pieces that were ready, but failed the check.
+  size_t finish_revalidation(const RevalidationTask &task, std::vector<td::optional<td::Bits256>> hashes);
+  // Ready pieces of a range with their hashes, used to resume an interrupted validation without reading them again.
+  // Bit i of ready_bitset is piece begin + i, hashes contain 32 bytes for each piece of the range (zero if unknown).
+  struct ReadyPieces {
+    td::uint64 begin{0};
+    std::string ready_bitset;
+    std::string hashes;
+  };
+  ReadyPieces get_ready_pieces(td::uint64 begin, td::uint64 end) const;
+  // Marks the pieces as ready without reading them. Hashes are checked against the merkle tree, later ranges
+  // override earlier ones. Returns the first piece that was ready, but couldn't be restored (pieces_count() if none).
+  td::uint64 restore_ready_pieces(const std::vector<ReadyPieces> &ranges);
 
   std::string get_stats_str() const;
 
@@ -52,6 +92,7 @@ class Torrent {
 
   // get piece and proof
   td::Result<std::string> get_piece_data(td::uint64 piece_i);
+  td::Result<td::BufferSlice> get_piece_buffer(td::uint64 piece_i);
   td::Result<td::Ref<vm::Cell>> get_piece_proof(td::uint64 piece_i);
 
   // add piece (with an optional proof)
@@ -231,6 +272,13 @@ class Torrent {
 
   std::string get_chunk_path(td::Slice name) const;
   td::Status init_chunk_data(ChunkState &chunk);
+  void init_existing_chunks();
+  static constexpr int NO_SUCH_FILE_ERROR = -1;
+  td::Status read_from_files(td::MutableSlice dest, td::uint64 offset);
+  td::Status read_ready_piece(Info::PieceInfo piece, td::MutableSlice dest);
+  void validate_range(td::uint64 begin, td::uint64 end, size_t threads_count);
+  void mark_piece_ready(td::uint64 piece_i);
+  void mark_piece_not_ready(td::uint64 piece_i);
   template <class F>
   td::Status iterate_piece(Info::PieceInfo piece, F &&f);
   void add_pending_pieces();
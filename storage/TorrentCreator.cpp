@@ -19,13 +19,12 @@
 
 #include "TorrentCreator.h"
 
-#include "td/db/utils/CyclicBuffer.h"
-
 #include "td/utils/crypto.h"
 #include "td/utils/PathView.h"
 #include "td/utils/port/path.h"
 #include "td/utils/tl_helpers.h"
 #include "MicrochunkTree.h"
+#include "PieceHasher.h"
 #include "TorrentHeader.hpp"
 
 namespace ton {
@@ -135,49 +134,12 @@ td::Result<Torrent> Torrent::Creator::finalize() {
     header.dir_name = options_.dir_name.value();
   }
 
-  // Now we should stream all data to calculate sha256 of all pieces
-
-  std::string buffer;
-  td::CyclicBuffer::Options cb_options;
-  cb_options.chunk_size = td::max(options_.piece_size * 16, (1 << 20) / options_.piece_size * options_.piece_size);
-  cb_options.count = 2;
-
-  auto reader_writer = td::CyclicBuffer::create(cb_options);
-  auto reader = std::move(reader_writer.first);
-  auto writer = std::move(reader_writer.second);
-
   auto header_size = header.serialization_size();
   auto file_size = header_size + data_offset;
   auto pieces_count = (file_size + options_.piece_size - 1) / options_.piece_size;
   std::vector<Torrent::ChunkState> chunks;
-  std::vector<td::Bits256> pieces;
-  auto flush_reader = [&](bool force) {
-    while (true) {
-      auto slice = reader.prepare_read();
-      slice.truncate(options_.piece_size);
-      if (slice.empty() || (slice.size() != options_.piece_size && !force)) {
-        break;
-      }
-      td::Bits256 hash;
-      sha256(slice, hash.as_slice());
-      pieces.push_back(hash);
-      reader.confirm_read(slice.size());
-    }
-  };
   td::uint64 offset = 0;
   auto add_blob = [&](auto data, td::Slice name) {
-    td::uint64 data_offset = 0;
-    while (data_offset < data.size()) {
-      auto dest = writer.prepare_write();
-      CHECK(dest.size() != 0);
-      dest.truncate(data.size() - data_offset);
-      TRY_RESULT(got_size, data.view_copy(dest, data_offset));
-      CHECK(got_size != 0);
-      data_offset += got_size;
-      writer.confirm_write(got_size);
-      flush_reader(false);
-    }
-
     Torrent::ChunkState chunk;
     chunk.name = name.str();
     chunk.offset = offset;
@@ -187,7 +149,6 @@ td::Result<Torrent> Torrent::Creator::finalize() {
 
     offset += chunk.size;
     chunks.push_back(std::move(chunk));
-    return td::Status::OK();
   };
 
   Torrent::Info info;
@@ -196,14 +157,52 @@ td::Result<Torrent> Torrent::Creator::finalize() {
   info.header_size = header_str.size();
   td::sha256(header_str, info.header_hash.as_slice());
 
-  add_blob(td::BufferSliceBlobView::create(td::BufferSlice(header_str)), "").ensure();
+  add_blob(td::BufferSliceBlobView::create(td::BufferSlice(header_str)), "");
   for (auto& file : files_) {
-    add_blob(std::move(file.data), file.name).ensure();
+    add_blob(std::move(file.data), file.name);
   }
-  flush_reader(true);
-  CHECK(pieces.size() == pieces_count);
   CHECK(offset == file_size);
-  MerkleTree tree(std::move(pieces));
+
+  // Now we should read all data to calculate sha256 of all pieces
+  auto reader = [&](td::MutableSlice dest, td::uint64 pos) -> td::Status {
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), pos,
+                               [](td::uint64 x, const Torrent::ChunkState& chunk) { return x < chunk.offset; });
+    CHECK(it != chunks.begin());
+    --it;
+    while (!dest.empty()) {
+      CHECK(it != chunks.end());
+      auto size = td::min<td::uint64>(dest.size(), it->offset + it->size - pos);
+      if (size != 0) {
+        TRY_RESULT(got_size, it->data.view_copy(dest.substr(0, size), pos - it->offset));
+        if (got_size != size) {
+          return td::Status::Error(PSLICE() << "Failed to read " << it->name);
+        }
+        dest.remove_prefix(size);
+        pos += size;
+      }
+      ++it;
+    }
+    return td::Status::OK();
+  };
+  PieceHasher::Options hasher_options;
+  hasher_options.piece_size = options_.piece_size;
+  hasher_options.data_size = file_size;
+  hasher_options.threads_count = options_.threads_count;
+
+  // Pieces are hashed in windows, so the tree is built as the data is read
+  MerkleTree::Builder tree_builder(pieces_count);
+  const td::uint64 window_size = 1 << 16;
+  for (td::uint64 l = 0; l < pieces_count; l += window_size) {
+    auto r = td::min(pieces_count, l + window_size);
+    auto hashes = PieceHasher::run(hasher_options, l, r, reader);
+    for (td::uint64 i = l; i < r; ++i) {
+      if (!hashes[i - l]) {
+        return td::Status::Error(PSLICE() << "Failed to read piece " << i);
+      }
+      tree_builder.add_piece(hashes[i - l].value());
+    }
+  }
+  MerkleTree tree = tree_builder.finalize();
 
   info.header_size = header.serialization_size();
   info.piece_size = options_.piece_size;
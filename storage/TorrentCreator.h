@@ -35,6 +35,9 @@ class Torrent::Creator {
     td::optional<std::string> dir_name;
 
     std::string description;
+
+    // number of threads used to hash pieces, 0 - use all available cores
+    size_t threads_count{0};
   };
 
   // If path is a file create a torrent with one file in it.
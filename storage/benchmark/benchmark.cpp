@@ -0,0 +1,87 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+#include "td/utils/filesystem.h"
+#include "td/utils/format.h"
+#include "td/utils/logging.h"
+#include "td/utils/misc.h"
+#include "td/utils/PathView.h"
+#include "td/utils/port/FileFd.h"
+#include "td/utils/port/path.h"
+#include "td/utils/port/thread.h"
+#include "td/utils/Random.h"
+#include "td/utils/Timer.h"
+
+#include "Torrent.h"
+#include "TorrentCreator.h"
+
+#include <set>
+
+// Creates a synthetic bag on disk and measures creation and validation speed with different numbers of threads.
+// Usage: benchmark-storage [total size in MB] [directory]
+static void write_random_file(td::CSlice path, td::uint64 size) {
+  auto fd = td::FileFd::open(path, td::FileFd::Write | td::FileFd::Create | td::FileFd::Truncate).move_as_ok();
+  std::string buf(1 << 20, '\0');
+  for (td::uint64 offset = 0; offset < size; offset += buf.size()) {
+    td::Random::secure_bytes(td::MutableSlice(buf).substr(0, 4096));
+    auto len = td::min<td::uint64>(buf.size(), size - offset);
+    CHECK(fd.pwrite(td::Slice(buf).substr(0, len), offset).move_as_ok() == len);
+  }
+  fd.close();
+}
+
+int main(int argc, char *argv[]) {
+  SET_VERBOSITY_LEVEL(VERBOSITY_NAME(ERROR));
+  td::uint64 size_mb = argc > 1 ? td::to_integer<td::uint64>(td::Slice(argv[1])) : 4096;
+  std::string dir = argc > 2 ? argv[2] : "benchmark-storage-bag";
+  const int files_count = 8;
+  td::uint64 total_size = size_mb << 20;
+
+  td::rmrf(dir).ignore();
+  td::mkdir(dir).ensure();
+  for (int i = 0; i < files_count; i++) {
+    write_random_file(PSLICE() << dir << TD_DIR_SLASH << "file" << i << ".bin", total_size / files_count);
+  }
+  auto speed = [&](double elapsed) { return PSTRING() << td::format::as_size((td::uint64)(total_size / elapsed)); };
+
+  std::set<size_t> threads_counts{1, 2, 4, td::thread::hardware_concurrency()};
+  for (auto threads_count : threads_counts) {
+    if (threads_count == 0) {
+      continue;
+    }
+    ton::Torrent::Creator::Options options;
+    options.threads_count = threads_count;
+    td::Timer timer;
+    auto torrent = ton::Torrent::Creator::create_from_path(options, dir).move_as_ok();
+    auto create_time = timer.elapsed();
+
+    ton::Torrent::Options open_options;
+    open_options.root_dir = td::PathView(td::realpath(dir).move_as_ok()).parent_dir().str();
+    auto other = ton::Torrent::open(open_options, torrent.get_meta()).move_as_ok();
+    timer = {};
+    other.validate(threads_count);
+    auto validate_time = timer.elapsed();
+    CHECK(other.get_ready_parts_count() == torrent.get_info().pieces_count());
+
+    LOG(ERROR) << "threads=" << threads_count << " size=" << td::format::as_size(total_size)
+               << " create: " << td::format::as_time(create_time) << " (" << speed(create_time) << "/s)"
+               << " validate: " << td::format::as_time(validate_time) << " (" << speed(validate_time) << "/s)";
+  }
+  td::rmrf(dir).ignore();
+  return 0;
+}
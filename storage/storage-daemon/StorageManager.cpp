@@ -30,14 +30,19 @@ static overlay::OverlayIdFull get_overlay_id(td::Bits256 hash) {
 
 StorageManager::StorageManager(adnl::AdnlNodeIdShort local_id, std::string db_root, td::unique_ptr<Callback> callback,
                                bool client_mode, td::actor::ActorId<adnl::Adnl> adnl,
-                               td::actor::ActorId<ton_rldp::Rldp> rldp, td::actor::ActorId<overlay::Overlays> overlays)
+                               td::actor::ActorId<ton_rldp::Rldp> rldp, td::actor::ActorId<overlay::Overlays> overlays,
+                               Options options)
     : local_id_(local_id)
     , db_root_(std::move(db_root))
     , callback_(std::move(callback))
     , client_mode_(client_mode)
     , adnl_(std::move(adnl))
     , rldp_(std::move(rldp))
-    , overlays_(std::move(overlays)) {
+    , overlays_(std::move(overlays))
+    , options_(options) {
+  if (options_.piece_cache_size > 0) {
+    piece_cache_ = std::make_shared<PieceCache>(options_.piece_cache_size);
+  }
 }
 
 void StorageManager::start_up() {
@@ -119,6 +124,7 @@ void StorageManager::loaded_torrent_from_db(td::Bits256 hash, td::Result<td::act
     auto it = torrents_.find(hash);
     CHECK(it != torrents_.end());
     it->second.actor = R.move_as_ok();
+    init_node(it->second.actor.get());
     LOG(INFO) << "Loaded torrent " << hash.to_hex() << " from db";
   }
 }
@@ -189,9 +195,16 @@ td::Status StorageManager::add_torrent_impl(Torrent torrent, bool start_download
   entry.actor = td::actor::create_actor<NodeActor>(
       "Node", 1, std::move(torrent), create_callback(hash, entry.closing_state), std::move(context), db_,
       SpeedLimiters{download_speed_limiter_.get(), upload_speed_limiter_.get()}, start_download, allow_upload);
+  init_node(entry.actor.get());
   return td::Status::OK();
 }
 
+void StorageManager::init_node(td::actor::ActorId<NodeActor> node) {
+  if (piece_cache_) {
+    td::actor::send_closure(node, &NodeActor::set_piece_cache, piece_cache_);
+  }
+}
+
 void StorageManager::add_torrent_by_meta(TorrentMeta meta, std::string root_dir, bool start_download, bool allow_upload,
                                          td::Promise<td::Unit> promise) {
   td::Bits256 hash(meta.info.get_hash());
@@ -295,6 +308,11 @@ void StorageManager::load_from(td::Bits256 hash, td::optional<TorrentMeta> meta,
                           std::move(promise));
 }
 
+void StorageManager::verify_files(td::Bits256 hash, td::Promise<td::Unit> promise) {
+  TRY_RESULT_PROMISE(promise, entry, get_torrent(hash));
+  td::actor::send_closure(entry->actor, &NodeActor::verify_files, std::move(promise));
+}
+
 static bool try_rm_empty_dir(const std::string& path) {
   auto stat = td::stat(path);
   if (stat.is_error() || !stat.ok().is_dir_) {
@@ -388,4 +406,12 @@ void StorageManager::set_upload_speed_limit(double max_speed) {
   db_store_config();
 }
 
+void StorageManager::get_piece_cache_stats(td::Promise<PieceCache::Stats> promise) {
+  if (!piece_cache_) {
+    promise.set_error(td::Status::Error("Piece cache is disabled"));
+    return;
+  }
+  promise.set_result(piece_cache_->get_stats());
+}
+
 }  // namespace ton
\ No newline at end of file
@@ -34,9 +34,13 @@ class StorageManager : public td::actor::Actor {
     virtual void on_ready() = 0;
   };
 
+  struct Options {
+    td::uint64 piece_cache_size = 0;
+  };
+
   StorageManager(adnl::AdnlNodeIdShort local_id, std::string db_root, td::unique_ptr<Callback> callback,
                  bool client_mode, td::actor::ActorId<adnl::Adnl> adnl, td::actor::ActorId<ton_rldp::Rldp> rldp,
-                 td::actor::ActorId<overlay::Overlays> overlays);
+                 td::actor::ActorId<overlay::Overlays> overlays, Options options);
 
   void start_up() override;
 
@@ -60,6 +64,7 @@ class StorageManager : public td::actor::Actor {
   void remove_torrent(td::Bits256 hash, bool remove_files, td::Promise<td::Unit> promise);
   void load_from(td::Bits256 hash, td::optional<TorrentMeta> meta, std::string files_path,
                  td::Promise<td::Unit> promise);
+  void verify_files(td::Bits256 hash, td::Promise<td::Unit> promise);
 
   void wait_for_completion(td::Bits256 hash, td::Promise<td::Unit> promise);
   void get_peers_info(td::Bits256 hash, td::Promise<tl_object_ptr<ton_api::storage_daemon_peerList>> promise);
@@ -68,6 +73,8 @@ class StorageManager : public td::actor::Actor {
   void set_download_speed_limit(double max_speed);
   void set_upload_speed_limit(double max_speed);
 
+  void get_piece_cache_stats(td::Promise<PieceCache::Stats> promise);
+
  private:
   adnl::AdnlNodeIdShort local_id_;
   std::string db_root_;
@@ -76,6 +83,8 @@ class StorageManager : public td::actor::Actor {
   td::actor::ActorId<adnl::Adnl> adnl_;
   td::actor::ActorId<ton_rldp::Rldp> rldp_;
   td::actor::ActorId<overlay::Overlays> overlays_;
+  Options options_;
+  std::shared_ptr<PieceCache> piece_cache_;
 
   std::shared_ptr<db::DbType> db_;
 
@@ -102,6 +111,7 @@ class StorageManager : public td::actor::Actor {
       td::actor::create_actor<SpeedLimiter>("DownloadRateLimitrer", -1.0);
 
   td::Status add_torrent_impl(Torrent torrent, bool start_download, bool allow_upload);
+  void init_node(td::actor::ActorId<NodeActor> node);
 
   td::Result<TorrentEntry*> get_torrent(td::Bits256 hash) {
     auto it = torrents_.find(hash);
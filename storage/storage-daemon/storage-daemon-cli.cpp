@@ -610,6 +610,12 @@ class StorageDaemonCli : public td::actor::Actor {
         return td::Status::Error("Unexpected EOLN");
       }
       return execute_load_from(hash, std::move(meta), std::move(path));
+    } else if (tokens[0] == "verify-files") {
+      if (tokens.size() != 2) {
+        return td::Status::Error("Expected bag");
+      }
+      TRY_RESULT(hash, parse_torrent(tokens[1]));
+      return execute_verify_files(hash);
     } else if (tokens[0] == "get-speed-limits") {
       bool json = false;
       for (size_t i = 1; i < tokens.size(); ++i) {
@@ -652,6 +658,19 @@ class StorageDaemonCli : public td::actor::Actor {
         return td::Status::Error("Unexpected token");
       }
       return execute_set_speed_limits(download, upload);
+    } else if (tokens[0] == "piece-cache-stats") {
+      bool json = false;
+      for (size_t i = 1; i < tokens.size(); ++i) {
+        if (!tokens[i].empty() && tokens[i][0] == '-') {
+          if (tokens[i] == "--json") {
+            json = true;
+            continue;
+          }
+          return td::Status::Error(PSTRING() << "Unknown flag " << tokens[i]);
+        }
+        return td::Status::Error("Unexpected token");
+      }
+      return execute_get_piece_cache_stats(json);
     } else if (tokens[0] == "new-contract-message") {
       td::Bits256 hash;
       std::string file;
@@ -922,12 +941,17 @@ class StorageDaemonCli : public td::actor::Actor {
                                "incomplete bag.\n";
       td::TerminalIO::out() << "\t--meta meta\ttorrent info and header will be inited (if not ready) from meta file\n";
       td::TerminalIO::out() << "\t--files path\tdata for files will be taken from here\n";
+      td::TerminalIO::out() << "verify-files <bag>\tCheck all pieces of <bag> in files again, broken pieces will be "
+                               "downloaded again.\n";
+      td::TerminalIO::out() << "\tVerification runs in background and continues after restart of the daemon\n";
       td::TerminalIO::out() << "get-speed-limits [--json]\tShow global limits for download and upload speed\n";
       td::TerminalIO::out() << "\t--json\tOutput in json\n";
       td::TerminalIO::out()
           << "set-speed-limits [--download x] [--upload x]\tSet global limits for download and upload speed\n";
       td::TerminalIO::out() << "\t--download x\tDownload speed limit in bytes/s, or \"unlimited\"\n";
       td::TerminalIO::out() << "\t--upload x\tUpload speed limit in bytes/s, or \"unlimited\"\n";
+      td::TerminalIO::out() << "piece-cache-stats [--json]\tShow statistics of the cache of pieces uploaded to peers\n";
+      td::TerminalIO::out() << "\t--json\tOutput in json\n";
       td::TerminalIO::out() << "new-contract-message <bag> <file> [--query-id id] --provider <provider>\tCreate "
                                "\"new contract message\" for storage provider. Saves message body to <file>.\n";
       td::TerminalIO::out() << "\t<provider>\tAddress of storage provider account to take parameters from.\n";
@@ -1328,6 +1352,19 @@ class StorageDaemonCli : public td::actor::Actor {
     return td::Status::OK();
   }
 
+  td::Status execute_verify_files(td::Bits256 hash) {
+    auto query = create_tl_object<ton_api::storage_daemon_verifyFiles>(hash, 0);
+    send_query(std::move(query),
+               [SelfId = actor_id(this)](td::Result<tl_object_ptr<ton_api::storage_daemon_success>> R) {
+                 if (R.is_error()) {
+                   return;
+                 }
+                 td::TerminalIO::out() << "Verification of files started\n";
+                 td::actor::send_closure(SelfId, &StorageDaemonCli::command_finished, td::Status::OK());
+               });
+    return td::Status::OK();
+  }
+
   td::Status execute_load_from(td::Bits256 hash, std::string meta, std::string path) {
     if (meta.empty() && path.empty()) {
       return td::Status::Error("Expected meta or files");
@@ -1419,6 +1456,31 @@ class StorageDaemonCli : public td::actor::Actor {
     return td::Status::OK();
   }
 
+  td::Status execute_get_piece_cache_stats(bool json) {
+    auto query = create_tl_object<ton_api::storage_daemon_getPieceCacheStats>(0);
+    send_query(std::move(query), [=, SelfId = actor_id(this)](
+                                     td::Result<tl_object_ptr<ton_api::storage_daemon_pieceCacheStats>> R) {
+      if (R.is_error()) {
+        return;
+      }
+      if (json) {
+        print_json(R.ok());
+        td::actor::send_closure(SelfId, &StorageDaemonCli::command_finished, td::Status::OK());
+        return;
+      }
+      auto obj = R.move_as_ok();
+      auto requests = obj->hits_ + obj->misses_;
+      td::TerminalIO::out() << "Size:      " << td::format::as_size(obj->size_) << " / "
+                            << td::format::as_size(obj->max_size_) << " (" << obj->entries_ << " pieces)\n";
+      td::StringBuilder::FixedDouble hit_rate(requests > 0 ? 100.0 * (double)obj->hits_ / (double)requests : 0.0, 2);
+      td::TerminalIO::out() << "Hits:      " << obj->hits_ << " (" << hit_rate << "%)\n";
+      td::TerminalIO::out() << "Misses:    " << obj->misses_ << "\n";
+      td::TerminalIO::out() << "Evictions: " << obj->evictions_ << "\n";
+      td::actor::send_closure(SelfId, &StorageDaemonCli::command_finished, td::Status::OK());
+    });
+    return td::Status::OK();
+  }
+
   td::Status execute_new_contract_message(td::Bits256 hash, std::string file, td::uint64 query_id,
                                           td::optional<std::string> provider_address, td::optional<std::string> rate,
                                           td::optional<td::uint32> max_span) {
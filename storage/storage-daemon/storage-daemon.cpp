@@ -57,13 +57,14 @@ td::BufferSlice create_query_error(td::Status error) {
 class StorageDaemon : public td::actor::Actor {
  public:
   StorageDaemon(td::IPAddress ip_addr, bool client_mode, std::string global_config, std::string db_root,
-                td::uint16 control_port, bool enable_storage_provider)
+                td::uint16 control_port, bool enable_storage_provider, StorageManager::Options manager_options)
       : ip_addr_(ip_addr)
       , client_mode_(client_mode)
       , global_config_(std::move(global_config))
       , db_root_(std::move(db_root))
       , control_port_(control_port)
-      , enable_storage_provider_(enable_storage_provider) {
+      , enable_storage_provider_(enable_storage_provider)
+      , manager_options_(manager_options) {
   }
 
   void start_up() override {
@@ -99,7 +100,7 @@ class StorageDaemon : public td::actor::Actor {
     };
     manager_ = td::actor::create_actor<StorageManager>("storage", local_id_, db_root_ + "/torrent",
                                                        td::make_unique<Callback>(actor_id(this)), client_mode_,
-                                                       adnl_.get(), rldp_.get(), overlays_.get());
+                                                       adnl_.get(), rldp_.get(), overlays_.get(), manager_options_);
   }
 
   td::Status load_global_config() {
@@ -540,6 +541,12 @@ class StorageDaemon : public td::actor::Actor {
         });
   }
 
+  void run_control_query(ton_api::storage_daemon_verifyFiles &query, td::Promise<td::BufferSlice> promise) {
+    td::actor::send_closure(
+        manager_, &StorageManager::verify_files, query.hash_,
+        promise.wrap([](td::Unit &&) { return create_serialize_tl_object<ton_api::storage_daemon_success>(); }));
+  }
+
   void run_control_query(ton_api::storage_daemon_getSpeedLimits &query, td::Promise<td::BufferSlice> promise) {
     td::actor::send_closure(manager_, &StorageManager::get_speed_limits,
                             promise.wrap([](std::pair<double, double> limits) -> td::BufferSlice {
@@ -558,6 +565,15 @@ class StorageDaemon : public td::actor::Actor {
     promise.set_result(create_serialize_tl_object<ton_api::storage_daemon_success>());
   }
 
+  void run_control_query(ton_api::storage_daemon_getPieceCacheStats &query, td::Promise<td::BufferSlice> promise) {
+    td::actor::send_closure(manager_, &StorageManager::get_piece_cache_stats,
+                            promise.wrap([](PieceCache::Stats stats) -> td::BufferSlice {
+                              return create_serialize_tl_object<ton_api::storage_daemon_pieceCacheStats>(
+                                  stats.max_size, stats.size, stats.entries, stats.hits, stats.misses,
+                                  stats.evictions);
+                            }));
+  }
+
   void run_control_query(ton_api::storage_daemon_getNewContractMessage &query, td::Promise<td::BufferSlice> promise) {
     td::Promise<std::pair<td::RefInt256, td::uint32>> P =
         [promise = std::move(promise), hash = query.hash_, query_id = query.query_id_,
@@ -901,6 +917,7 @@ class StorageDaemon : public td::actor::Actor {
   std::string db_root_;
   td::uint16 control_port_;
   bool enable_storage_provider_;
+  StorageManager::Options manager_options_;
 
   tl_object_ptr<ton_api::storage_daemon_config> daemon_config_;
   std::shared_ptr<dht::DhtGlobalConfig> dht_config_;
@@ -956,6 +973,7 @@ int main(int argc, char *argv[]) {
   std::string global_config, db_root;
   td::uint16 control_port = 0;
   bool enable_storage_provider = false;
+  ton::StorageManager::Options manager_options;
 
   td::OptionParser p;
   p.set_description("Server for seeding and downloading bags of files (torrents)\n");
@@ -1009,13 +1027,20 @@ int main(int argc, char *argv[]) {
     td::log_interface = logger_.get();
   });
   p.add_option('P', "storage-provider", "run storage provider", [&]() { enable_storage_provider = true; });
+  p.add_checked_option('\0', "piece-cache-size",
+                       "size of the cache of pieces uploaded to peers in MB, 0 - disable (default: 0)",
+                       [&](td::Slice arg) -> td::Status {
+                         TRY_RESULT(size, td::to_integer_safe<td::uint64>(arg));
+                         manager_options.piece_cache_size = size << 20;
+                         return td::Status::OK();
+                       });
 
   td::actor::Scheduler scheduler({7});
 
   scheduler.run_in_context([&] {
     p.run(argc, argv).ensure();
     td::actor::create_actor<ton::StorageDaemon>("storage-daemon", ip_addr, client_mode, global_config, db_root,
-                                                control_port, enable_storage_provider)
+                                                control_port, enable_storage_provider, manager_options)
         .release();
   });
   while (scheduler.run(1)) {
@@ -58,6 +58,7 @@
 
 #include "Bitset.h"
 #include "PeerState.h"
+#include "PieceCache.h"
 #include "Torrent.h"
 #include "TorrentCreator.h"
 
@@ -1045,6 +1046,188 @@ TEST(Torrent, OneFile) {
   }
 };
 
+TEST(Torrent, ParallelValidate) {
+  td::rmrf("first").ignore();
+  td::mkdir("first").ensure();
+  td::Random::Xorshift128plus rnd(123);
+  for (int i = 0; i < 5; i++) {
+    td::write_file(PSLICE() << "first/file" << i << ".txt", td::rand_string('a', 'z', rnd.fast(1, 100000))).ensure();
+  }
+  ton::Torrent::Creator::Options options;
+  options.piece_size = 1024;
+  options.threads_count = 1;
+  auto torrent = ton::Torrent::Creator::create_from_path(options, "first").move_as_ok();
+  options.threads_count = 4;
+  auto torrent2 = ton::Torrent::Creator::create_from_path(options, "first").move_as_ok();
+  CHECK(torrent.get_info().get_hash() == torrent2.get_info().get_hash());
+  auto meta = ton::TorrentMeta::deserialize(torrent.get_meta().serialize()).move_as_ok();
+  auto pieces_count = torrent.get_info().pieces_count();
+
+  ton::Torrent::Options open_options;
+  open_options.root_dir = ".";
+  auto other_torrent = ton::Torrent::open(open_options, meta).move_as_ok();
+  other_torrent.validate(3);
+  CHECK(other_torrent.get_ready_parts_count() == pieces_count);
+
+  auto data = td::read_file_str("first/file2.txt").move_as_ok();
+  data[data.size() / 2] = data[data.size() / 2] == 'a' ? 'b' : 'a';
+  td::write_file("first/file2.txt", data).ensure();
+  CHECK(other_torrent.revalidate_pieces(0, pieces_count, 2) == 1);
+  CHECK(other_torrent.get_ready_parts_count() == pieces_count - 1);
+  CHECK(other_torrent.revalidate_pieces(0, pieces_count, 2) == 0);
+
+  // Resume from ranges saved in several steps, the last one overrides the first
+  std::vector<ton::Torrent::ReadyPieces> ranges;
+  auto step = pieces_count / 3;
+  ranges.push_back(other_torrent.get_ready_pieces(0, step * 2));
+  ranges.push_back(other_torrent.get_ready_pieces(step, pieces_count));
+  auto restored = ton::Torrent::open(open_options, meta).move_as_ok();
+  CHECK(restored.restore_ready_pieces(ranges) == pieces_count);
+  CHECK(restored.get_ready_parts_count() == pieces_count - 1);
+  CHECK(restored.revalidate_pieces(0, pieces_count) == 0);
+  CHECK(restored.get_ready_parts_count() == pieces_count - 1);
+
+  // A piece with a wrong saved hash is not restored and has to be checked again
+  ranges = {other_torrent.get_ready_pieces(0, pieces_count)};
+  auto restored2 = ton::Torrent::open(open_options, meta).move_as_ok();
+  ranges[0].hashes[0] ^= 1;
+  CHECK(restored2.restore_ready_pieces(ranges) == 0);
+  CHECK(!restored2.is_piece_ready(0));
+  td::rmrf("first").ignore();
+}
+
+TEST(Torrent, RevalidationTask) {
+  td::rmrf("first").ignore();
+  td::mkdir("first").ensure();
+  td::Random::Xorshift128plus rnd(123);
+  for (int i = 0; i < 3; i++) {
+    td::write_file(PSLICE() << "first/file" << i << ".txt", td::rand_string('a', 'z', rnd.fast(1, 30000))).ensure();
+  }
+  ton::Torrent::Creator::Options options;
+  options.piece_size = 1024;
+  auto torrent = ton::Torrent::Creator::create_from_path(options, "first").move_as_ok();
+  auto pieces_count = torrent.get_info().pieces_count();
+
+  ton::Torrent::Options open_options;
+  open_options.root_dir = ".";
+  open_options.validate = true;
+  auto other_torrent = ton::Torrent::open(open_options, torrent.get_meta()).move_as_ok();
+  CHECK(other_torrent.get_ready_parts_count() == pieces_count);
+
+  auto original_data = td::read_file_str("first/file1.txt").move_as_ok();
+  auto data = original_data;
+  data[0] = data[0] == 'a' ? 'b' : 'a';
+  td::write_file("first/file1.txt", data).ensure();
+
+  // The range is hashed in parts without the torrent, the results are applied at once
+  auto task = other_torrent.start_revalidation(0, pieces_count).move_as_ok();
+  auto hashes = task.hash_pieces(0, pieces_count / 2);
+  auto hashes2 = task.hash_pieces(pieces_count / 2, pieces_count);
+  hashes.insert(hashes.end(), hashes2.begin(), hashes2.end());
+  CHECK(other_torrent.finish_revalidation(task, std::move(hashes)) == 1);
+  CHECK(other_torrent.get_ready_parts_count() == pieces_count - 1);
+
+  // A piece that is added while its range is hashed stays ready
+  td::uint64 broken_piece = 0;
+  while (other_torrent.is_piece_ready(broken_piece)) {
+    broken_piece++;
+  }
+  task = other_torrent.start_revalidation(0, pieces_count).move_as_ok();
+  hashes = task.hash_pieces(0, pieces_count);
+  td::write_file("first/file1.txt", original_data).ensure();
+  other_torrent.add_piece(broken_piece, torrent.get_piece_data(broken_piece).move_as_ok(), {}).ensure();
+  CHECK(other_torrent.finish_revalidation(task, std::move(hashes)) == 0);
+  CHECK(other_torrent.get_ready_parts_count() == pieces_count);
+
+  // There are no files to read for a torrent in memory
+  ton::Torrent::Options in_memory_options;
+  in_memory_options.in_memory = true;
+  auto in_memory = ton::Torrent::open(in_memory_options, torrent.get_meta()).move_as_ok();
+  CHECK(in_memory.start_revalidation(0, pieces_count).is_error());
+  td::rmrf("first").ignore();
+}
+
+TEST(Torrent, UploadPieces) {
+  td::rmrf("first").ignore();
+  td::mkdir("first").ensure();
+  td::Random::Xorshift128plus rnd(123);
+  for (int i = 0; i < 3; i++) {
+    td::write_file(PSLICE() << "first/file" << i << ".txt", td::rand_string('a', 'z', rnd.fast(1, 10000))).ensure();
+  }
+  ton::Torrent::Creator::Options options;
+  options.piece_size = 1024;
+  auto torrent = ton::Torrent::Creator::create_from_path(options, "first").move_as_ok();
+  ton::Torrent::Options open_options;
+  open_options.root_dir = ".";
+  open_options.validate = true;
+  auto other_torrent = ton::Torrent::open(open_options, torrent.get_meta()).move_as_ok();
+  auto pieces_count = torrent.get_info().pieces_count();
+  ton::PieceCache cache(1 << 20);
+  for (td::uint64 i = 0; i < pieces_count; i++) {
+    auto expected = torrent.get_piece_data(i).move_as_ok();
+    ASSERT_EQ(expected, other_torrent.get_piece_buffer(i).move_as_ok().as_slice());
+    ASSERT_EQ(expected, other_torrent.get_piece_data(i).move_as_ok());
+    for (int j = 0; j < 2; j++) {
+      auto piece = ton::NodeActor::get_piece_for_upload(other_torrent, &cache, i).move_as_ok();
+      ASSERT_EQ(expected, piece.data.as_slice());
+    }
+  }
+  ASSERT_EQ(pieces_count, cache.get_stats().hits);
+
+  // Piece ids come from peers
+  CHECK(ton::NodeActor::get_piece_for_upload(other_torrent, &cache, pieces_count).is_error());
+  CHECK(ton::NodeActor::get_piece_for_upload(other_torrent, nullptr, pieces_count + 100).is_error());
+  CHECK(ton::NodeActor::get_piece_for_upload(other_torrent, &cache, std::numeric_limits<td::uint64>::max())
+            .is_error());
+
+  // A piece that became not ready is not served from the cache and is dropped from it
+  auto data = td::read_file_str("first/file0.txt").move_as_ok();
+  data[0] = data[0] == 'a' ? 'b' : 'a';
+  td::write_file("first/file0.txt", data).ensure();
+  CHECK(other_torrent.revalidate_pieces(0, pieces_count) == 1);
+  CHECK(!other_torrent.is_piece_ready(0));
+  CHECK(ton::NodeActor::get_piece_for_upload(other_torrent, &cache, 0).is_error());
+  CHECK(!cache.get(other_torrent.get_hash(), 0));
+  ASSERT_EQ(pieces_count - 1, cache.get_stats().entries);
+  cache.erase_range(other_torrent.get_hash(), 0, pieces_count / 2);
+  ASSERT_EQ(pieces_count - pieces_count / 2, cache.get_stats().entries);
+  td::rmrf("first").ignore();
+}
+
+TEST(PieceCache, Lru) {
+  ton::PieceCache cache(3000);
+  td::Bits256 hash1 = td::Bits256::zero(), hash2 = td::Bits256::zero();
+  hash2.as_slice()[0] = 1;
+  auto piece = [](char c) {
+    return ton::PieceCache::Piece{td::BufferSlice(std::string(900, c)), td::BufferSlice(std::string(100, c))};
+  };
+  cache.put(hash1, 0, piece('a'));
+  cache.put(hash1, 1, piece('b'));
+  cache.put(hash2, 0, piece('c'));
+  CHECK(!cache.get(hash2, 1));
+  auto got = cache.get(hash1, 0);
+  CHECK(got);
+  ASSERT_EQ(std::string(900, 'a'), got.value().data.as_slice());
+
+  // (hash1, 1) is the least recently used one
+  cache.put(hash2, 1, piece('d'));
+  CHECK(!cache.get(hash1, 1));
+  CHECK(cache.get(hash1, 0));
+  CHECK(cache.get(hash2, 1));
+
+  cache.erase_torrent(hash2);
+  CHECK(!cache.get(hash2, 0));
+  CHECK(!cache.get(hash2, 1));
+  CHECK(cache.get(hash1, 0));
+
+  auto stats = cache.get_stats();
+  ASSERT_EQ(1u, stats.entries);
+  ASSERT_EQ(1000u, stats.size);
+  ASSERT_EQ(1u, stats.evictions);
+  ASSERT_EQ(4u, stats.hits);
+  ASSERT_EQ(4u, stats.misses);
+}
+
 TEST(Torrent, PartsHelper) {
   int parts_count = 100;
   ton::PartsHelper parts(parts_count);
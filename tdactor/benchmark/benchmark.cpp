@@ -44,6 +44,7 @@ extern "C" {
 
 #include "td/actor/core/ActorLocker.h"
 #include "td/actor/actor.h"
+#include "td/actor/Task.h"
 
 #include "td/utils/benchmark.h"
 #include "td/utils/crypto.h"
@@ -53,6 +54,7 @@ extern "C" {
 #include "td/utils/MpmcWaiter.h"
 #include "td/utils/port/thread.h"
 #include "td/utils/queue.h"
+#include "td/utils/ScopeGuard.h"
 #include "td/utils/Random.h"
 #include "td/utils/Slice.h"
 #include "td/utils/Status.h"
@@ -65,14 +67,33 @@ extern "C" {
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstdlib>
 #include <functional>
 #include <mutex>
+#include <new>
 #include <queue>
 #include <string>
 
 using td::int32;
 using td::uint32;
 
+// Count calls of global operator new to report the number of allocations per actor message
+static std::atomic<td::uint64> malloc_count{0};
+
+void *operator new(std::size_t size) {
+  malloc_count.fetch_add(1, std::memory_order_relaxed);
+  if (auto *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
 // Concurrent SHA256 benchmark
 // Simplified ton Cell and Block structures
 struct CellRef {
@@ -1637,6 +1658,273 @@ class YieldMany : public td::Benchmark {
   bool use_io_{false};
 };
 
+class SendClosureMany : public td::Benchmark {
+ public:
+  // sampling is passed to ActorTypeStatManager::set_sampling when actor statistics are enabled
+  explicit SendClosureMany(bool with_promise, bool with_stats = false, td::uint32 sampling = 0)
+      : with_promise_(with_promise), with_stats_(with_stats), sampling_(sampling) {
+  }
+  std::string get_description() const {
+    td::StringBuilder sb;
+    sb << "SendClosure with_promise(" << with_promise_ << ")";
+    if (with_stats_) {
+      sb << " with_stats sampling(1/" << sampling_ << ")";
+    }
+    sb << " " << td::StringBuilder::FixedDouble(mallocs_per_message_, 3) << " mallocs/msg";
+    return sb.as_cslice().str();
+  }
+
+  void run(int n) {
+    td::actor::set_debug(with_stats_);
+    td::actor::core::ActorTypeStatManager::set_sampling(with_stats_ ? sampling_ : 0);
+    SCOPE_EXIT {
+      td::actor::set_debug(false);
+      td::actor::core::ActorTypeStatManager::set_sampling(0);
+    };
+    constexpr int pairs = 8;
+    class Task : public td::actor::Actor {
+     public:
+      Task(bool with_promise, Sem *sem) : with_promise_(with_promise), sem_(sem) {
+      }
+      void set_peer(td::actor::ActorId<Task> peer) {
+        peer_ = peer;
+      }
+      void ping(int n) {
+        if (n <= 0) {
+          sem_->post();
+          return;
+        }
+        if (!with_promise_) {
+          send_closure(peer_, &Task::ping, n - 1);
+          return;
+        }
+        // a query and its answer are two messages
+        send_closure(peer_, &Task::query, n - 2,
+                     td::PromiseCreator::lambda([self = actor_id(this)](td::Result<int> r) {
+                       send_closure(self, &Task::ping, r.move_as_ok());
+                     }));
+      }
+      void query(int n, td::Promise<int> promise) {
+        promise.set_value(std::move(n));
+      }
+
+     private:
+      bool with_promise_;
+      Sem *sem_;
+      td::actor::ActorId<Task> peer_;
+    };
+    td::actor::Scheduler scheduler{{8}};
+    auto sch = td::thread([&] { scheduler.run(); });
+
+    Sem sem;
+    scheduler.run_in_context_external([&] {
+      std::vector<td::actor::ActorOwn<Task>> actors;
+      for (int i = 0; i < pairs; i++) {
+        auto a = td::actor::create_actor<Task>("Task", with_promise_, &sem);
+        auto b = td::actor::create_actor<Task>("Task", with_promise_, &sem);
+        send_closure(a, &Task::set_peer, b.get());
+        send_closure(b, &Task::set_peer, a.get());
+        actors.push_back(std::move(a));
+        actors.push_back(std::move(b));
+      }
+      auto messages = std::max(n / pairs, 1);
+      auto begin_malloc_count = malloc_count.load();
+      for (int i = 0; i < pairs; i++) {
+        send_closure(actors[2 * i], &Task::ping, messages);
+      }
+      sem.wait(pairs);
+      mallocs_per_message_ = static_cast<double>(malloc_count.load() - begin_malloc_count) / (messages * pairs);
+      actors.clear();
+      td::actor::SchedulerContext::get()->stop();
+    });
+
+    sch.join();
+  }
+
+ private:
+  bool with_promise_{false};
+  bool with_stats_{false};
+  td::uint32 sampling_{0};
+  double mallocs_per_message_{0};
+};
+
+class AskChain : public td::Benchmark {
+ public:
+  explicit AskChain(bool use_coroutines) : use_coroutines_(use_coroutines) {
+  }
+  std::string get_description() const {
+    return PSTRING() << "AskChain use_coroutines(" << use_coroutines_ << ") "
+                     << td::StringBuilder::FixedDouble(mallocs_per_query_, 3) << " mallocs/query";
+  }
+
+  // Each query is a chain of sequential requests to another actor, like liteserver queries:
+  // either continuation methods called back by promises, or a coroutine
+  void run(int n) {
+    constexpr int clients = 8;
+    constexpr int steps = 4;
+    class Server : public td::actor::Actor {
+     public:
+      void get(int x, td::Promise<int> promise) {
+        promise.set_value(x + 1);
+      }
+    };
+    class Client : public td::actor::Actor {
+     public:
+      Client(td::actor::ActorId<Server> server, bool use_coroutines, int queries, Sem *sem)
+          : server_(server), use_coroutines_(use_coroutines), queries_(queries), sem_(sem) {
+      }
+      void start() {
+        next_query();
+      }
+
+     private:
+      td::actor::ActorId<Server> server_;
+      bool use_coroutines_;
+      int queries_;
+      Sem *sem_;
+
+      void next_query() {
+        if (queries_-- == 0) {
+          sem_->post();
+          return;
+        }
+        if (use_coroutines_) {
+          run_query().start([this](td::Result<int> r) {
+            CHECK(r.move_as_ok() == steps);
+            next_query();
+          });
+        } else {
+          continue_query(0);
+        }
+      }
+      void continue_query(int x) {
+        if (x == steps) {
+          next_query();
+          return;
+        }
+        send_closure(server_, &Server::get, x, [self = actor_id(this)](td::Result<int> r) {
+          send_closure(self, &Client::continue_query, r.move_as_ok());
+        });
+      }
+      td::actor::Task<int> run_query() {
+        int x = 0;
+        for (int i = 0; i < steps; i++) {
+          CO_TRY_RESULT_ASSIGN(x, co_await td::actor::ask(server_, &Server::get, x));
+        }
+        co_return x;
+      }
+    };
+    td::actor::Scheduler scheduler{{8}};
+    auto sch = td::thread([&] { scheduler.run(); });
+
+    Sem sem;
+    scheduler.run_in_context_external([&] {
+      auto server = td::actor::create_actor<Server>("Server");
+      std::vector<td::actor::ActorOwn<Client>> actors;
+      auto queries = std::max(n / clients, 1);
+      for (int i = 0; i < clients; i++) {
+        actors.push_back(td::actor::create_actor<Client>("Client", server.get(), use_coroutines_, queries, &sem));
+      }
+      auto begin_malloc_count = malloc_count.load();
+      for (auto &actor : actors) {
+        send_closure(actor, &Client::start);
+      }
+      sem.wait(clients);
+      mallocs_per_query_ = static_cast<double>(malloc_count.load() - begin_malloc_count) / (queries * clients);
+      actors.clear();
+      server.reset();
+      td::actor::SchedulerContext::get()->stop();
+    });
+
+    sch.join();
+  }
+
+ private:
+  bool use_coroutines_{false};
+  double mallocs_per_query_{0};
+};
+
+// A token makes rounds along a ring of actors, like a consensus round, while background actors keep every
+// worker busy with 20us slices of bulk work. Each hop goes through the scheduler queues.
+class PriorityRound : public td::Benchmark {
+ public:
+  PriorityRound(td::actor::ActorPriority priority, td::actor::ActorPriority background_priority)
+      : priority_(priority), background_priority_(background_priority) {
+  }
+  std::string get_description() const {
+    return PSTRING() << "PriorityRound priority(" << static_cast<int>(priority_) << ") background_priority("
+                     << static_cast<int>(background_priority_) << ")";
+  }
+
+  void run(int n) {
+    constexpr int threads = 4;
+    constexpr int background_per_thread = 4;
+    constexpr int ring_size = 8;
+    class Background : public td::actor::Actor {
+     public:
+      void loop() override {
+        auto end = td::Time::now() + 20e-6;
+        while (td::Time::now() < end) {
+        }
+        yield();
+      }
+    };
+    class Node : public td::actor::Actor {
+     public:
+      Node(int rounds, Sem *sem) : rounds_(rounds), sem_(sem) {
+      }
+      void set_next(td::actor::ActorId<Node> next) {
+        next_ = next;
+      }
+      void token(int hops) {
+        if (hops == 0) {
+          if (--rounds_ == 0) {
+            sem_->post();
+            return;
+          }
+          hops = ring_size;
+        }
+        send_closure_later(next_, &Node::token, hops - 1);
+      }
+
+     private:
+      int rounds_;
+      Sem *sem_;
+      td::actor::ActorId<Node> next_;
+    };
+
+    td::actor::Scheduler scheduler{{threads}};
+    auto sch = td::thread([&] { scheduler.run(); });
+
+    Sem sem;
+    scheduler.run_in_context_external([&] {
+      for (int i = 0; i < threads * background_per_thread; i++) {
+        td::actor::create_actor<Background>(
+            td::actor::ActorOptions().with_name("Background").with_priority(background_priority_))
+            .release();
+      }
+      std::vector<td::actor::ActorOwn<Node>> ring;
+      for (int i = 0; i < ring_size; i++) {
+        ring.push_back(td::actor::create_actor<Node>(
+            td::actor::ActorOptions().with_name("Node").with_priority(priority_), std::max(n, 1), &sem));
+      }
+      for (int i = 0; i < ring_size; i++) {
+        send_closure(ring[i], &Node::set_next, ring[(i + 1) % ring_size].get());
+      }
+      send_closure_later(ring[0], &Node::token, ring_size);
+      sem.wait();
+      ring.clear();
+      td::actor::SchedulerContext::get()->stop();
+    });
+
+    sch.join();
+  }
+
+ private:
+  td::actor::ActorPriority priority_;
+  td::actor::ActorPriority background_priority_;
+};
+
 int main(int argc, char **argv) {
   if (argc > 1) {
     if (argv[1][0] == 'a') {
@@ -1652,6 +1940,16 @@ int main(int argc, char **argv) {
     }
     return 0;
   }
+  bench(SendClosureMany(false));
+  bench(SendClosureMany(true));
+  bench(SendClosureMany(false, true, 0));
+  bench(SendClosureMany(false, true, 64));
+  bench(SendClosureMany(false, true, 1));
+  bench(PriorityRound(td::actor::ActorPriority::Normal, td::actor::ActorPriority::Normal));
+  bench(PriorityRound(td::actor::ActorPriority::Normal, td::actor::ActorPriority::Background));
+  bench(PriorityRound(td::actor::ActorPriority::Realtime, td::actor::ActorPriority::Background));
+  bench(AskChain(false));
+  bench(AskChain(true));
   bench(YieldMany(false));
   bench(YieldMany(true));
   bench(SpawnMany(false));
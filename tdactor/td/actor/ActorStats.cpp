@@ -3,6 +3,85 @@
 #include "td/utils/ThreadSafeCounter.h"
 namespace td {
 namespace actor {
+namespace {
+// Returns the top-level template argument with the given index of the first template named by prefix, if any
+td::Slice get_template_argument(td::Slice name, td::Slice prefix, size_t index) {
+  auto pos = name.str().find(prefix.str());
+  if (pos == std::string::npos) {
+    return {};
+  }
+  name.remove_prefix(pos + prefix.size());
+  int depth = 0;
+  size_t begin = 0;
+  for (size_t i = 0; i < name.size(); i++) {
+    auto c = name[i];
+    if (c == '<' || c == '(') {
+      depth++;
+    } else if ((c == '>' || c == ')') && depth > 0) {
+      depth--;
+    } else if ((c == ',' || c == '>') && depth == 0) {
+      if (index == 0) {
+        return td::trim(name.substr(begin, i - begin));
+      }
+      if (c == '>') {
+        break;
+      }
+      index--;
+      begin = i + 1;
+    }
+  }
+  return {};
+}
+
+std::string get_message_name(const char *name) {
+  auto result = ActorTypeStatManager::get_class_name(name);
+  // closures are sent as lambdas capturing a DelayedClosure, whose type is named by the member function pointer
+  auto function = get_template_argument(result, "td::DelayedClosure<", 1);
+  if (!function.empty()) {
+    return function.str();
+  }
+  td::Slice wrapper = "td::actor::detail::ActorMessageLambda<";
+  if (td::begins_with(result, wrapper) && td::ends_with(result, ">")) {
+    result = result.substr(wrapper.size(), result.size() - wrapper.size() - 1);
+  }
+  return result;
+}
+
+std::string escape_label(td::Slice value) {
+  std::string result;
+  result.reserve(value.size());
+  for (auto c : value) {
+    if (c == '\\' || c == '"') {
+      result += '\\';
+      result += c;
+    } else if (c == '\n') {
+      result += "\\n";
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+void store_family(td::StringBuilder &sb, td::Slice name, td::Slice type, td::Slice help) {
+  sb << "# HELP " << name << " " << help << "\n";
+  sb << "# TYPE " << name << " " << type << "\n";
+}
+
+// bounds are in exported units, the histogram is in units of scale
+template <class SnapshotT>
+void store_histogram(td::StringBuilder &sb, td::Slice name, td::Slice labels, const SnapshotT &snapshot,
+                     const std::vector<double> &bounds, double scale) {
+  for (auto bound : bounds) {
+    sb << name << "_bucket{" << labels << ",le=\"" << bound << "\"} "
+       << snapshot.count_not_greater(static_cast<td::uint64>(bound / scale)) << "\n";
+  }
+  sb << name << "_bucket{" << labels << ",le=\"+Inf\"} " << snapshot.count << "\n";
+  sb << name << "_sum{" << labels << "} " << td::StringBuilder::FixedDouble(double(snapshot.sum) * scale, 9) << "\n";
+  sb << name << "_count{" << labels << "} " << snapshot.count << "\n";
+}
+}  // namespace
+
 void td::actor::ActorStats::start_up() {
   auto now = td::Time::now();
   for (std::size_t i = 0; i < SIZE; i++) {
@@ -211,15 +290,114 @@ std::string ActorStats::prepare_stats() {
             [&](auto &left, auto &right) { return main_key(left.first) > main_key(right.first); });
   auto debug = Debug(SchedulerContext::get()->scheduler_group());
   debug.dump(sb);
+  auto latency_stats = ActorTypeStatManager::get_latency_stats();
   sb << "All actors:\n";
   for (auto &it : stats) {
     sb << "\t" << ActorTypeStatManager::get_class_name(it.first.name()) << "\n";
     auto key = main_key(it.first);
     describe(sb, it.first);
+    auto latency_it = latency_stats.by_actor.find(it.first);
+    if (latency_it != latency_stats.by_actor.end()) {
+      auto &latency = latency_it->second.total;
+      auto quantiles = [&](auto &snapshot) {
+        for (auto q : {0.5, 0.99, 0.999}) {
+          sb << " " << double(snapshot.quantile(q)) * estimated_inv_ticks_per_second << "s";
+        }
+      };
+      sb << "\t\tsampled_delay_p50_p99_p999:\t";
+      quantiles(latency.delay);
+      sb << "\n\t\tsampled_execute_p50_p99_p999:\t";
+      quantiles(latency.execute);
+      sb << "\n";
+    }
   }
   sb << "\n";
   return sb.as_cslice().str();
 }
+std::string ActorStats::prepare_prometheus_stats() {
+  auto inv_ticks_per_second = estimate_inv_ticks_per_second();
+  auto stats = ActorTypeStatManager::get_stats(inv_ticks_per_second).stats;
+  auto latency_stats = ActorTypeStatManager::get_latency_stats();
+
+  std::map<std::type_index, std::string> actor_labels;
+  for (auto &it : stats) {
+    actor_labels[it.first] =
+        PSTRING() << "actor=\"" << escape_label(ActorTypeStatManager::get_class_name(it.first.name())) << "\"";
+  }
+  for (auto &it : latency_stats.by_actor) {
+    if (!actor_labels.count(it.first)) {
+      actor_labels[it.first] =
+          PSTRING() << "actor=\"" << escape_label(ActorTypeStatManager::get_class_name(it.first.name())) << "\"";
+    }
+  }
+
+  td::StringBuilder sb;
+  auto store_counter = [&](td::Slice name, td::Slice type, td::Slice help, auto get) {
+    store_family(sb, name, type, help);
+    for (auto &it : stats) {
+      sb << name << "{" << actor_labels[it.first] << "} " << get(it.second) << "\n";
+    }
+  };
+  store_counter("ton_actor_messages_total", "counter", "Messages executed by actors",
+                [](const ActorTypeStat &stat) { return static_cast<td::uint64>(stat.messages); });
+  store_counter("ton_actor_busy_seconds_total", "counter", "Time spent executing actors",
+                [](const ActorTypeStat &stat) { return td::StringBuilder::FixedDouble(stat.seconds, 9); });
+  store_counter("ton_actor_created_total", "counter", "Actors created",
+                [](const ActorTypeStat &stat) { return static_cast<td::uint64>(stat.created); });
+  store_counter("ton_actor_alive", "gauge", "Actors alive", [](const ActorTypeStat &stat) { return stat.alive; });
+
+  // 1us, 4us, ..., 67s
+  std::vector<double> time_bounds;
+  for (double bound = 1e-6; bound < 100; bound *= 4) {
+    time_bounds.push_back(bound);
+  }
+  std::vector<double> mailbox_bounds;
+  for (double bound = 1; bound <= 16384; bound *= 4) {
+    mailbox_bounds.push_back(bound);
+  }
+
+  auto sampling = ActorTypeStatManager::get_sampling();
+  store_family(sb, "ton_actor_sampling", "gauge", "One of how many events is sampled into histograms, 0 if disabled");
+  sb << "ton_actor_sampling " << sampling << "\n";
+
+  store_family(sb, "ton_actor_delay_seconds", "histogram", "Sampled time from scheduling an actor to its execution");
+  for (auto &it : latency_stats.by_actor) {
+    store_histogram(sb, "ton_actor_delay_seconds", actor_labels[it.first], it.second.total.delay, time_bounds,
+                    inv_ticks_per_second);
+  }
+  store_family(sb, "ton_actor_mailbox_messages", "histogram", "Sampled number of messages in an actor mailbox");
+  for (auto &it : latency_stats.by_actor) {
+    store_histogram(sb, "ton_actor_mailbox_messages", actor_labels[it.first], it.second.total.mailbox,
+                    mailbox_bounds, 1.0);
+  }
+
+  std::map<std::type_index, std::string> message_labels;
+  auto get_labels = [&](std::type_index actor, std::type_index message) {
+    auto it = message_labels.find(message);
+    if (it == message_labels.end()) {
+      it = message_labels
+               .emplace(message, PSTRING() << "message=\"" << escape_label(get_message_name(message.name())) << "\"")
+               .first;
+    }
+    return PSTRING() << actor_labels[actor] << "," << it->second;
+  };
+  store_family(sb, "ton_actor_message_wait_seconds", "histogram", "Sampled time from sending a message to its execution");
+  for (auto &it : latency_stats.by_actor) {
+    for (auto &message_it : it.second.by_message) {
+      store_histogram(sb, "ton_actor_message_wait_seconds", get_labels(it.first, message_it.first),
+                      message_it.second.wait, time_bounds, inv_ticks_per_second);
+    }
+  }
+  store_family(sb, "ton_actor_message_execute_seconds", "histogram", "Sampled message execution time");
+  for (auto &it : latency_stats.by_actor) {
+    for (auto &message_it : it.second.by_message) {
+      store_histogram(sb, "ton_actor_message_execute_seconds", get_labels(it.first, message_it.first),
+                      message_it.second.execute, time_bounds, inv_ticks_per_second);
+    }
+  }
+  return sb.as_cslice().str();
+}
+
 ActorStats::PefStat::PefStat() {
   for (std::size_t i = 0; i < SIZE; i++) {
     perf_stat_[i] = td::TimedStat<StatStorer<td::int64>>(DURATIONS[i], td::Time::now());
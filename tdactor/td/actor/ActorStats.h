@@ -11,6 +11,8 @@ class ActorStats : public td::actor::Actor {
   void start_up() override;
   double estimate_inv_ticks_per_second();
   std::string prepare_stats();
+  // Counters and sampled latency histograms in the Prometheus text exposition format
+  std::string prepare_prometheus_stats();
 
  private:
   template <class T>
@@ -22,6 +22,7 @@
 #include "td/utils/invoke.h"  // for tuple_for_each
 #include "td/utils/logging.h"
 #include "td/utils/ScopeGuard.h"
+#include "td/utils/SmallObjectAllocator.h"
 #include "td/utils/Status.h"
 
 #include <tuple>
@@ -77,8 +78,9 @@ template <class T>
 using drop_result_t = typename DropResult<T>::type;
 }  // namespace detail
 
+// promises are allocated with SmallObjectAllocator, so creation of a LambdaPromise usually doesn't call malloc
 template <class T = Unit>
-class PromiseInterface {
+class PromiseInterface : public SmallObject {
  public:
   using ValueType = T;
   PromiseInterface() = default;
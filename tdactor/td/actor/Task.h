@@ -0,0 +1,417 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "td/actor/actor.h"
+#include "td/actor/PromiseFuture.h"
+
+#include "td/utils/common.h"
+#include "td/utils/SmallObjectAllocator.h"
+#include "td/utils/Status.h"
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Coroutines for actors.
+//
+//   td::actor::Task<int> MyActor::get_sum(BlockIdExt id) {
+//     CO_TRY_RESULT(a, co_await td::actor::ask(manager_, &Manager::get_a, id));
+//     auto [b, c] = co_await td::actor::all(td::actor::ask(x_, &X::get, 1), td::actor::ask(y_, &Y::get, 2));
+//     CO_TRY_RESULT(d, co_await get_d());  // another Task
+//     co_return a + b.move_as_ok() + c.move_as_ok() + d;
+//   }
+//   get_sum(id).start(std::move(promise));
+//
+// A coroutine runs inside the actor which started it: when a result of ask() arrives, the coroutine is resumed by
+// a message to that actor, so it may access members of the actor as ordinary methods do. No helper actors are created.
+// Awaiting results yields Result<T>; errors and exceptions thrown by the coroutine are returned as Result errors.
+// If the actor is stopped while a coroutine is suspended, the resume message is lost and the coroutine is destroyed
+// together with all coroutines awaiting it; the promise passed to start() then receives "Lost promise" error.
+
+#define CO_TRY_STATUS(status)               \
+  {                                         \
+    auto try_status = (status);             \
+    if (try_status.is_error()) {            \
+      co_return try_status.move_as_error(); \
+    }                                       \
+  }
+
+#define CO_TRY_STATUS_PREFIX(status, prefix)             \
+  {                                                      \
+    auto try_status = (status);                          \
+    if (try_status.is_error()) {                         \
+      co_return try_status.move_as_error_prefix(prefix); \
+    }                                                    \
+  }
+
+#define CO_TRY_RESULT(name, result) CO_TRY_RESULT_IMPL(TD_CONCAT(TD_CONCAT(r_, name), __LINE__), auto name, result)
+
+#define CO_TRY_RESULT_ASSIGN(name, result) CO_TRY_RESULT_IMPL(TD_CONCAT(r_response, __LINE__), name, result)
+
+#define CO_TRY_RESULT_PREFIX(name, result, prefix) \
+  CO_TRY_RESULT_PREFIX_IMPL(TD_CONCAT(TD_CONCAT(r_, name), __LINE__), auto name, result, prefix)
+
+#define CO_TRY_RESULT_PREFIX_ASSIGN(name, result, prefix) \
+  CO_TRY_RESULT_PREFIX_IMPL(TD_CONCAT(r_response, __LINE__), name, result, prefix)
+
+#define CO_TRY_RESULT_IMPL(r_name, name, result) \
+  auto r_name = (result);                        \
+  if (r_name.is_error()) {                       \
+    co_return r_name.move_as_error();            \
+  }                                              \
+  name = r_name.move_as_ok();
+
+#define CO_TRY_RESULT_PREFIX_IMPL(r_name, name, result, prefix) \
+  auto r_name = (result);                                       \
+  if (r_name.is_error()) {                                      \
+    co_return r_name.move_as_error_prefix(prefix);              \
+  }                                                             \
+  name = r_name.move_as_ok();
+
+namespace td {
+namespace actor {
+
+template <class T = Unit>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+  // coroutine frames are allocated with SmallObjectAllocator too; SmallObject itself isn't used as a base,
+  // because its placement operator new would be chosen for coroutines taking a single pointer argument
+  static void *operator new(std::size_t size) {
+    return SmallObjectAllocator::allocate(size);
+  }
+  static void operator delete(void *ptr, std::size_t size) noexcept {
+    SmallObjectAllocator::deallocate(ptr, size);
+  }
+
+  std::coroutine_handle<> continuation_;
+  // outermost coroutine of the chain; it owns all the others
+  std::coroutine_handle<> root_;
+};
+
+// Resumes the coroutine when run; destroys the whole chain of coroutines if the message is dropped
+class ResumeCoroutine {
+ public:
+  ResumeCoroutine(std::coroutine_handle<> handle, std::coroutine_handle<> root) : handle_(handle), root_(root) {
+  }
+  ResumeCoroutine(const ResumeCoroutine &) = delete;
+  ResumeCoroutine &operator=(const ResumeCoroutine &) = delete;
+  ResumeCoroutine(ResumeCoroutine &&other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)), root_(std::exchange(other.root_, nullptr)) {
+  }
+  ResumeCoroutine &operator=(ResumeCoroutine &&) = delete;
+  ~ResumeCoroutine() {
+    if (root_) {
+      root_.destroy();
+    }
+  }
+
+  void operator()() {
+    root_ = nullptr;
+    std::exchange(handle_, nullptr).resume();
+  }
+
+ private:
+  std::coroutine_handle<> handle_;
+  std::coroutine_handle<> root_;
+};
+
+// A suspended coroutine waiting for a number of results. Results may arrive from any thread;
+// the last one sends a message to the actor which runs the coroutine.
+class Suspension {
+ public:
+  Suspension() = default;
+  // awaiters are moved only before they are awaited
+  Suspension(Suspension &&) noexcept {
+  }
+  Suspension &operator=(Suspension &&) = delete;
+
+  template <class P>
+  void suspend(std::coroutine_handle<P> handle, int pending) {
+    CHECK(core::ActorExecuteContext::get() != nullptr);  // coroutines must be run by an actor
+    self_ = actor_id();
+    handle_ = handle;
+    root_ = handle.promise().root_;
+    pending_.store(pending, std::memory_order_relaxed);
+  }
+
+  void on_ready() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    // the coroutine may be resumed and destroyed immediately, so nothing in *this may be used after sending
+    auto self = std::move(self_);
+    send_lambda(self.as_actor_ref(), ResumeCoroutine(handle_, root_));
+  }
+
+ private:
+  ActorId<> self_;
+  std::coroutine_handle<> handle_;
+  std::coroutine_handle<> root_;
+  std::atomic<int> pending_{0};
+};
+
+// Awaitable result of a function which takes Promise<T>; the function is called when the coroutine is suspended
+template <class T, class StartF>
+class PromiseAwaiter {
+ public:
+  using ValueT = T;
+
+  explicit PromiseAwaiter(StartF start) : start_(std::move(start)) {
+  }
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  template <class P>
+  void await_suspend(std::coroutine_handle<P> handle) {
+    suspension_.suspend(handle, 1);
+    start(suspension_);
+  }
+  Result<T> await_resume() {
+    return std::move(result_);
+  }
+
+  void start(Suspension &suspension) {
+    start_(Promise<T>([this, &suspension](Result<T> result) {
+      result_ = std::move(result);
+      suspension.on_ready();
+    }));
+  }
+
+ private:
+  StartF start_;
+  Result<T> result_;
+  Suspension suspension_;
+};
+
+template <class... AwaitersT>
+class AllAwaiter {
+ public:
+  explicit AllAwaiter(AwaitersT... awaiters) : awaiters_(std::move(awaiters)...) {
+  }
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  template <class P>
+  void await_suspend(std::coroutine_handle<P> handle) {
+    suspension_.suspend(handle, static_cast<int>(sizeof...(AwaitersT)));
+    std::apply([&](auto &...awaiter) { (awaiter.start(suspension_), ...); }, awaiters_);
+  }
+  std::tuple<Result<typename AwaitersT::ValueT>...> await_resume() {
+    return std::apply([](auto &...awaiter) { return std::make_tuple(awaiter.await_resume()...); }, awaiters_);
+  }
+
+ private:
+  std::tuple<AwaitersT...> awaiters_;
+  Suspension suspension_;
+};
+
+template <class ActorT>
+ActorId<ActorT> to_actor_id(const ActorId<ActorT> &actor_id) {
+  return actor_id;
+}
+template <class ActorT>
+ActorId<ActorT> to_actor_id(const ActorOwn<ActorT> &actor_own) {
+  return actor_own.get();
+}
+template <class ActorT>
+ActorId<ActorT> to_actor_id(const ActorShared<ActorT> &actor_shared) {
+  return actor_shared.get();
+}
+
+template <class FunctionT>
+struct AskResult;
+
+template <class ActorT, class... ArgsT>
+struct AskResult<void (ActorT::*)(ArgsT...)> {
+  using PromiseT = std::decay_t<std::tuple_element_t<sizeof...(ArgsT) - 1, std::tuple<ArgsT...>>>;
+  using type = typename PromiseT::ArgT;
+};
+
+template <class T>
+class TaskPromise : public TaskPromiseBase {
+ public:
+  Task<T> get_return_object() noexcept;
+
+  std::suspend_always initial_suspend() noexcept {
+    return {};
+  }
+
+  struct FinalAwaiter {
+    bool await_ready() const noexcept {
+      return false;
+    }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<TaskPromise> handle) noexcept {
+      return handle.promise().continuation_;
+    }
+    void await_resume() noexcept {
+    }
+  };
+  FinalAwaiter final_suspend() noexcept {
+    return {};
+  }
+
+  void return_value(Result<T> result) {
+    result_ = std::move(result);
+  }
+  void unhandled_exception() {
+    try {
+      throw;
+    } catch (const std::exception &e) {
+      result_ = Status::Error(PSLICE() << "unhandled exception in coroutine: " << e.what());
+    } catch (...) {
+      result_ = Status::Error("unhandled exception in coroutine");
+    }
+  }
+
+  Result<T> move_result() {
+    return std::move(result_);
+  }
+
+ private:
+  Result<T> result_;
+};
+
+// Outermost coroutine of a chain, started by Task::start(); destroys itself when finished
+struct DetachedTask {
+  struct promise_type : public TaskPromiseBase {
+    promise_type() {
+      root_ = std::coroutine_handle<promise_type>::from_promise(*this);
+    }
+    DetachedTask get_return_object() noexcept {
+      return {};
+    }
+    std::suspend_never initial_suspend() noexcept {
+      return {};
+    }
+    std::suspend_never final_suspend() noexcept {
+      return {};
+    }
+    void return_void() noexcept {
+    }
+    void unhandled_exception() noexcept {
+      std::terminate();
+    }
+  };
+};
+
+template <class T>
+DetachedTask run_detached(Task<T> task, Promise<T> promise) {
+  promise.set_result(co_await std::move(task));
+}
+
+}  // namespace detail
+
+// Lazily started coroutine returning Result<T>. It starts when awaited by another coroutine or by start().
+template <class T>
+class [[nodiscard]] Task {
+ public:
+  using promise_type = detail::TaskPromise<T>;
+
+  Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {
+  }
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      reset();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task() {
+    reset();
+  }
+
+  // runs the task in the current actor until its first suspension; the promise receives the result
+  void start(Promise<T> promise) && {
+    detail::run_detached(std::move(*this), std::move(promise));
+  }
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  template <class P>
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<P> continuation) noexcept {
+    CHECK(handle_);
+    auto &promise = handle_.promise();
+    promise.continuation_ = continuation;
+    promise.root_ = continuation.promise().root_;
+    return handle_;
+  }
+  Result<T> await_resume() {
+    return handle_.promise().move_result();
+  }
+
+ private:
+  friend class detail::TaskPromise<T>;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {
+  }
+
+  void reset() {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+template <class T>
+Task<T> detail::TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+// co_await await_promise<T>([&](Promise<T> promise) { ... }) calls the function and waits for the promise
+template <class T, class F>
+auto await_promise(F &&f) {
+  return detail::PromiseAwaiter<T, std::decay_t<F>>(std::forward<F>(f));
+}
+
+// co_await ask(actor_id, &Actor::method, args...) sends a closure with a promise appended as the last argument
+// and waits for the result
+template <class ActorIdT, class FunctionT, class... ArgsT>
+auto ask(const ActorIdT &actor_id, FunctionT function, ArgsT &&...args) {
+  using T = typename detail::AskResult<FunctionT>::type;
+  return await_promise<T>([actor_id = detail::to_actor_id(actor_id), function,
+                           args = std::make_tuple(std::forward<ArgsT>(args)...)](Promise<T> promise) mutable {
+    std::apply(
+        [&](auto &&...nargs) {
+          send_closure(std::move(actor_id), function, std::forward<decltype(nargs)>(nargs)..., std::move(promise));
+        },
+        std::move(args));
+  });
+}
+
+// co_await all(ask(...), ask(...)) starts all requests at once and returns a tuple of their results
+template <class... AwaitersT>
+auto all(AwaitersT &&...awaiters) {
+  return detail::AllAwaiter<std::decay_t<AwaitersT>...>(std::forward<AwaitersT>(awaiters)...);
+}
+
+}  // namespace actor
+}  // namespace td
@@ -31,6 +31,7 @@
 namespace td {
 namespace actor {
 using core::ActorOptions;
+using core::ActorPriority;
 
 // Replacement for core::ActorSignals. Easier to use and do not allow internal signals
 class ActorSignals {
@@ -92,10 +93,12 @@ struct Debug {
     });
     sb << "\nsizes of cpu local queues:\n";
     for (auto &scheduler : group_info_->schedulers) {
-      for (size_t i = 0; i < scheduler.cpu_threads_count; i++) {
-        auto size = scheduler.cpu_local_queue[i].size();
-        if (size != 0) {
-          sb << "\tcpu#" << i << " queue.size() = " << size << "\n";
+      for (size_t priority = 0; priority < scheduler.cpu_queues.size(); priority++) {
+        for (size_t i = 0; i < scheduler.cpu_threads_count; i++) {
+          auto size = scheduler.cpu_queues[priority].local_queue[i].size();
+          if (size != 0) {
+            sb << "\tcpu#" << i << " priority#" << priority << " queue.size() = " << size << "\n";
+          }
         }
       }
     }
@@ -115,6 +118,13 @@ class Scheduler {
     }
     size_t cpu_threads_;
     size_t io_threads_{1};
+    // cpus to bind cpu workers to, one per worker; empty means workers are not bound
+    std::vector<td::CpuTopology::Cpu> cpus_;
+
+    NodeInfo &pin_to(const td::CpuTopology &topology) {
+      cpus_ = topology.select(cpu_threads_);
+      return *this;
+    }
   };
 
   enum Mode { Running, Paused };
@@ -206,7 +216,8 @@ class Scheduler {
     td::uint8 id = 0;
     for (const auto &info : infos_) {
       schedulers_.emplace_back(
-          td::make_unique<core::Scheduler>(group_info_, core::SchedulerId{id}, info.cpu_threads_, skip_timeouts_));
+          td::make_unique<core::Scheduler>(group_info_, core::SchedulerId{id}, info.cpu_threads_, skip_timeouts_,
+                                           info.cpus_));
       id++;
     }
   }
@@ -249,8 +260,6 @@ class ActorMessageCreator {
   static auto hangup_shared() {
     return core::ActorMessage(std::make_unique<core::ActorMessageHangupShared>());
   }
-
-  // Use faster allocation?
 };
 struct ActorRef {
   ActorRef(core::ActorInfo &actor_info, uint64 link_token = core::EmptyLinkToken)
@@ -59,6 +59,9 @@ void ActorExecutor::send(ActorMessage message) {
     return send_immediate(std::move(message));
   }
   //LOG(ERROR) << "AE::send delayed";
+  if (unlikely(ActorTypeStatManager::need_sample())) {
+    message.set_sent_at(Clocks::rdtsc());
+  }
   actor_info_.mailbox().push(std::move(message));
   pending_signals_.add_signal(ActorSignals::Message);
 }
@@ -235,6 +238,9 @@ bool ActorExecutor::flush_one_signal(ActorSignals &signals) {
     case ActorSignals::Message:
       pending_signals_.add_signal(ActorSignals::Message);
       actor_info_.mailbox().pop_all();
+      if (unlikely(ActorTypeStatManager::need_sample())) {
+        actor_stats_.read_mailbox(actor_info_.mailbox().reader().calc_size());
+      }
       break;
     case ActorSignals::Pop:
       flags().set_in_queue(false);
@@ -261,6 +267,12 @@ bool ActorExecutor::flush_one_message() {
 
   actor_execute_context_.set_link_token(message.get_link_token());
   auto message_timer = actor_stats_.create_message_timer();
+  if (unlikely(message.get_sent_at() != 0)) {
+    auto started_at = Clocks::rdtsc();
+    message.run();
+    actor_stats_.sampled_message(message.get_type(), message.get_sent_at(), started_at);
+    return true;
+  }
   message.run();
   return true;
 }
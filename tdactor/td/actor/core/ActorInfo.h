@@ -21,6 +21,7 @@
 #include "td/actor/core/ActorState.h"
 #include "td/actor/core/ActorTypeStat.h"
 #include "td/actor/core/ActorMailbox.h"
+#include "td/actor/core/SchedulerId.h"
 
 #include "td/utils/Heap.h"
 #include "td/utils/List.h"
@@ -35,8 +36,9 @@ class ActorInfo;
 using ActorInfoPtr = SharedObjectPool<ActorInfo>::Ptr;
 class ActorInfo : private HeapNode, private ListNode {
  public:
-  ActorInfo(std::unique_ptr<Actor> actor, ActorState::Flags state_flags, Slice name, td::uint32 actor_stat_id)
-      : actor_(std::move(actor)), name_(name.begin(), name.size()), actor_stat_id_(actor_stat_id) {
+  ActorInfo(std::unique_ptr<Actor> actor, ActorState::Flags state_flags, Slice name, td::uint32 actor_stat_id,
+            ActorPriority priority)
+      : actor_(std::move(actor)), name_(name.begin(), name.size()), actor_stat_id_(actor_stat_id), priority_(priority) {
     state_.set_flags_unsafe(state_flags);
     VLOG(actor) << "Create actor [" << name_ << "]";
   }
@@ -83,6 +85,9 @@ class ActorInfo : private HeapNode, private ListNode {
   CSlice get_name() const {
     return name_;
   }
+  ActorPriority get_priority() const {
+    return priority_;
+  }
 
   HeapNode *as_heap_node() {
     return this;
@@ -118,6 +123,7 @@ class ActorInfo : private HeapNode, private ListNode {
   ActorInfoPtr pin_;
   td::uint64 in_queue_since_{0};
   td::uint32 actor_stat_id_{0};
+  ActorPriority priority_{ActorPriority::Normal};
 };
 
 }  // namespace core
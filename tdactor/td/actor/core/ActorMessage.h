@@ -21,11 +21,16 @@
 #include "td/actor/core/ActorExecuteContext.h"
 
 #include "td/utils/MpscLinkQueue.h"
+#include "td/utils/SmallObjectAllocator.h"
+
+#include <typeinfo>
 
 namespace td {
 namespace actor {
 namespace core {
-class ActorMessageImpl : private MpscLinkQueueImpl::Node {
+// Messages are allocated with SmallObjectAllocator: a message is usually destroyed by the scheduler thread which
+// runs the receiver, and its memory is reused for the next messages sent from that thread
+class ActorMessageImpl : private MpscLinkQueueImpl::Node, public SmallObject {
  public:
   ActorMessageImpl() = default;
   ActorMessageImpl(const ActorMessageImpl &) = delete;
@@ -49,6 +54,7 @@ class ActorMessageImpl : private MpscLinkQueueImpl::Node {
   }
 
   uint64 link_token_{EmptyLinkToken};
+  uint64 sent_at_{0};
   bool is_big_{false};
 };
 
@@ -78,6 +84,16 @@ class ActorMessage {
   void set_big() {
     impl_->is_big_ = true;
   }
+  // rdtsc at the moment a sampled message was sent, 0 for other messages
+  void set_sent_at(uint64 sent_at) {
+    impl_->sent_at_ = sent_at;
+  }
+  uint64 get_sent_at() const {
+    return impl_->sent_at_;
+  }
+  const std::type_info &get_type() const {
+    return typeid(*impl_);
+  }
 
  private:
   std::unique_ptr<ActorMessageImpl> impl_;
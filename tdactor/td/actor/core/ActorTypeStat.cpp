@@ -83,6 +83,9 @@ struct ActorTypeStatsTlsEntryRef {
 
 static TD_THREAD_LOCAL ActorTypeStatsTlsEntryRef *actor_type_stats_tls_entry = nullptr;
 
+std::atomic<td::uint32> ActorTypeStatManager::sampling_{0};
+TD_THREAD_LOCAL td::uint32 ActorTypeStatManager::sample_countdown_;
+
 ActorTypeStatRef ActorTypeStatManager::get_actor_type_stat(td::uint32 id, Actor *actor) {
   if (!actor || !need_debug()) {
     return ActorTypeStatRef{nullptr};
@@ -119,6 +122,18 @@ ActorTypeStats ActorTypeStatManager::get_stats(double inv_ticks_per_second) {
   });
   return ActorTypeStats{.stats = std::move(stats)};
 }
+
+ActorLatencyStats ActorTypeStatManager::get_latency_stats() {
+  ActorLatencyStats stats;
+  registry.foreach_entry([&](ActorTypeStatsTlsEntry &tls_entry) {
+    tls_entry.foreach_entry([&](ActorTypeStatsTlsEntry::Entry &entry) {
+      if (entry.o_type_index) {
+        entry.stat->to_latency_stat(stats.by_actor[entry.o_type_index.value()]);
+      }
+    });
+  });
+  return stats;
+}
 }  // namespace core
 }  // namespace actor
 }  // namespace td
@@ -1,7 +1,12 @@
 #pragma once
 #include "td/utils/int_types.h"
+#include "td/utils/LogHistogram.h"
 #include "td/utils/port/Clocks.h"
+#include "td/utils/port/thread_local.h"
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <typeindex>
 #include <map>
 
@@ -80,10 +85,43 @@ struct ActorTypeStat {
   }
 };
 
+// Histograms of sampled events: delays and times are in rdtsc ticks
+using LatencyHistogram = LogHistogram<2, 48>;
+using MailboxHistogram = LogHistogram<2, 32>;
+
+struct ActorLatencyStat {
+  // from being added to a scheduler queue to execution
+  LatencyHistogram::Snapshot delay;
+  // from being sent to execution (mailbox wait)
+  LatencyHistogram::Snapshot wait;
+  LatencyHistogram::Snapshot execute;
+  // messages read from the mailbox at once
+  MailboxHistogram::Snapshot mailbox;
+
+  ActorLatencyStat &operator+=(const ActorLatencyStat &other) {
+    delay += other.delay;
+    wait += other.wait;
+    execute += other.execute;
+    mailbox += other.mailbox;
+    return *this;
+  }
+};
+
+struct ActorLatencyStats {
+  struct Entry {
+    ActorLatencyStat total;
+    std::map<std::type_index, ActorLatencyStat> by_message;
+  };
+  std::map<std::type_index, Entry> by_actor;
+};
+
 struct ActorTypeStatImpl {
  public:
   ActorTypeStatImpl() {
   }
+  ~ActorTypeStatImpl() {
+    delete latency_.load(std::memory_order_relaxed);
+  }
 
   class MessageTimer {
    public:
@@ -146,6 +184,24 @@ struct ActorTypeStatImpl {
     }
   }
 
+  void on_sampled_delay(td::uint64 ticks) {
+    latency().delay.add(ticks);
+  }
+  void on_sampled_mailbox(size_t size) {
+    latency().mailbox.add(size);
+  }
+  void on_sampled_message(const std::type_info &message_type, td::uint64 wait_ticks, td::uint64 execute_ticks) {
+    auto &latency = this->latency();
+    // only this thread inserts, so it may look up without the lock
+    auto it = latency.by_message.find(message_type);
+    if (it == latency.by_message.end()) {
+      std::lock_guard<std::mutex> guard(latency.mutex);
+      it = latency.by_message.emplace(message_type, std::make_unique<MessageLatency>()).first;
+    }
+    it->second->wait.add(wait_ticks);
+    it->second->execute.add(execute_ticks);
+  }
+
   template <class T>
   static td::uint32 get_unique_id() {
     static td::uint32 value = get_next_unique_id();
@@ -177,6 +233,22 @@ struct ActorTypeStatImpl {
                          .max_execute_seconds = load_seconds(max_execute_ticks_, inv_ticks_per_second),
                          .max_delay_seconds = load_seconds(max_delay_ticks_, inv_ticks_per_second)};
   }
+  void to_latency_stat(ActorLatencyStats::Entry &entry) const {
+    auto *latency = latency_.load(std::memory_order_acquire);
+    if (!latency) {
+      return;
+    }
+    entry.total.delay += latency->delay.snapshot();
+    entry.total.mailbox += latency->mailbox.snapshot();
+    std::lock_guard<std::mutex> guard(latency->mutex);
+    for (auto &it : latency->by_message) {
+      ActorLatencyStat stat;
+      stat.wait = it.second->wait.snapshot();
+      stat.execute = it.second->execute.snapshot();
+      entry.total += stat;
+      entry.by_message[it.first] += stat;
+    }
+  }
 
  private:
   static double ticks_to_seconds(td::uint64 ticks, double inv_tick_per_second) {
@@ -293,6 +365,28 @@ struct ActorTypeStatImpl {
   std::atomic<td::int64> alive_{0};
   std::atomic<td::int32> executing_{0};
 
+  // sampled statistics, allocated on the first sample
+  struct MessageLatency {
+    LatencyHistogram wait;
+    LatencyHistogram execute;
+  };
+  struct Latency {
+    LatencyHistogram delay;
+    MailboxHistogram mailbox;
+    std::mutex mutex;  // protects insertions into by_message from concurrent readers
+    std::map<std::type_index, std::unique_ptr<MessageLatency>> by_message;
+  };
+  std::atomic<Latency *> latency_{nullptr};
+
+  Latency &latency() {
+    auto *latency = latency_.load(std::memory_order_relaxed);
+    if (!latency) {
+      latency = new Latency();
+      latency_.store(latency, std::memory_order_release);
+    }
+    return *latency;
+  }
+
   // max statistics (TODO: recent_max)
   MaxCounterGroup<td::uint32> max_execute_messages_;
   MaxCounterGroup<td::uint64> max_message_ticks_;
@@ -304,6 +398,37 @@ struct ActorTypeStatImpl {
   std::atomic<td::uint32> execute_messages_{0};
 };
 
+class ActorTypeStatRef;
+struct ActorTypeStats;
+
+class ActorTypeStatManager {
+ public:
+  static ActorTypeStatRef get_actor_type_stat(td::uint32 id, Actor *actor);
+  static ActorTypeStats get_stats(double inv_ticks_per_second);
+  static ActorLatencyStats get_latency_stats();
+  static std::string get_class_name(const char *name);
+
+  // Latency histograms are filled for about one of every `one_in` events on each thread; 0 disables them
+  static void set_sampling(td::uint32 one_in) {
+    sampling_.store(one_in, std::memory_order_relaxed);
+  }
+  static td::uint32 get_sampling() {
+    return sampling_.load(std::memory_order_relaxed);
+  }
+  static bool need_sample() {
+    if (likely(sample_countdown_ > 1)) {
+      sample_countdown_--;
+      return false;
+    }
+    sample_countdown_ = get_sampling();
+    return sample_countdown_ != 0;
+  }
+
+ private:
+  static std::atomic<td::uint32> sampling_;
+  static TD_THREAD_LOCAL td::uint32 sample_countdown_;
+};
+
 class ActorTypeStatRef {
  public:
   ActorTypeStatImpl *ref_{nullptr};
@@ -327,6 +452,22 @@ class ActorTypeStatRef {
     CHECK(in_queue_since);
     auto ts = td::Clocks::rdtsc();
     ref_->on_delay(ts, ts - in_queue_since);
+    if (ActorTypeStatManager::need_sample()) {
+      ref_->on_sampled_delay(ts - in_queue_since);
+    }
+  }
+  void read_mailbox(size_t size) {
+    if (ref_) {
+      ref_->on_sampled_mailbox(size);
+    }
+  }
+  void sampled_message(const std::type_info &message_type, td::uint64 sent_at, td::uint64 started_at) {
+    if (!ref_) {
+      return;
+    }
+    // rdtsc of different cores may be slightly out of sync
+    auto wait_ticks = started_at > sent_at ? started_at - sent_at : 0;
+    ref_->on_sampled_message(message_type, wait_ticks, td::Clocks::rdtsc() - started_at);
   }
   void start_execute() {
     if (!ref_) {
@@ -383,12 +524,6 @@ struct ActorTypeStats {
     return *this;
   }
 };
-class ActorTypeStatManager {
- public:
-  static ActorTypeStatRef get_actor_type_stat(td::uint32 id, Actor *actor);
-  static ActorTypeStats get_stats(double inv_ticks_per_second);
-  static std::string get_class_name(const char *name);
-};
 
 }  // namespace core
 }  // namespace actor
@@ -23,6 +23,8 @@
 
 #include "td/actor/core/Scheduler.h"  // FIXME: afer LocalQueue is in a separate file
 
+#include <algorithm>
+
 namespace td {
 namespace actor {
 namespace core {
@@ -48,40 +50,42 @@ void CpuWorker::run() {
   }
 }
 
-bool CpuWorker::try_pop_local(SchedulerMessage &message) {
+// Strides of realtime, normal and background priorities: a busy worker serves them in shares of 16:4:1
+static constexpr uint64 PRIORITY_STRIDE[ACTOR_PRIORITY_COUNT] = {1, 4, 16};
+
+bool CpuWorker::try_pop_local(CpuQueues &queues, SchedulerMessage &message) {
   SchedulerMessage::Raw *raw_message;
-  if (local_queues_[id_].try_pop(raw_message)) {
+  if (queues.local_queue[id_].try_pop(raw_message)) {
     message = SchedulerMessage(SchedulerMessage::acquire_t{}, raw_message);
     return true;
   }
   return false;
 }
 
-bool CpuWorker::try_pop_global(SchedulerMessage &message, size_t thread_id) {
+bool CpuWorker::try_pop_global(CpuQueues &queues, SchedulerMessage &message, size_t thread_id) {
   SchedulerMessage::Raw *raw_message;
-  if (queue_.try_pop(raw_message, thread_id)) {
+  if (queues.queue->try_pop(raw_message, thread_id)) {
     message = SchedulerMessage(SchedulerMessage::acquire_t{}, raw_message);
     return true;
   }
   return false;
 }
 
-bool CpuWorker::try_pop(SchedulerMessage &message, size_t thread_id) {
+bool CpuWorker::try_pop(CpuQueues &queues, SchedulerMessage &message, size_t thread_id) {
   if (++cnt_ == 51) {
     cnt_ = 0;
-    if (try_pop_global(message, thread_id) || try_pop_local(message)) {
+    if (try_pop_global(queues, message, thread_id) || try_pop_local(queues, message)) {
       return true;
     }
   } else {
-    if (try_pop_local(message) || try_pop_global(message, thread_id)) {
+    if (try_pop_local(queues, message) || try_pop_global(queues, message, thread_id)) {
       return true;
     }
   }
 
-  for (size_t i = 1; i < local_queues_.size(); i++) {
-    size_t pos = (i + id_) % local_queues_.size();
+  for (auto pos : steal_order_) {
     SchedulerMessage::Raw *raw_message;
-    if (local_queues_[id_].steal(raw_message, local_queues_[pos])) {
+    if (queues.local_queue[id_].steal(raw_message, queues.local_queue[pos])) {
       message = SchedulerMessage(SchedulerMessage::acquire_t{}, raw_message);
       return true;
     }
@@ -90,6 +94,37 @@ bool CpuWorker::try_pop(SchedulerMessage &message, size_t thread_id) {
   return false;
 }
 
+// Stride scheduling: the priority with the least virtual time goes first, ties are won by the higher priority
+bool CpuWorker::try_pop(SchedulerMessage &message, size_t thread_id) {
+  std::array<size_t, ACTOR_PRIORITY_COUNT> order;
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return pass_[a] < pass_[b]; });
+
+  for (size_t i = 0; i < order.size(); i++) {
+    auto priority = order[i];
+    auto &queues = queues_[priority];
+    bool is_counted = CpuQueues::is_counted(static_cast<ActorPriority>(priority));
+    if (is_counted && queues.size.load(std::memory_order_relaxed) <= 0) {
+      continue;
+    }
+    if (!try_pop(queues, message, thread_id)) {
+      continue;
+    }
+    if (is_counted) {
+      queues.size.fetch_sub(1, std::memory_order_relaxed);
+    }
+    // priorities with nothing to do must not save up their share
+    for (size_t j = 0; j < i; j++) {
+      pass_[order[j]] = pass_[priority];
+    }
+    pass_[priority] += PRIORITY_STRIDE[priority];
+    return true;
+  }
+  return false;
+}
+
 }  // namespace core
 }  // namespace actor
 }  // namespace td
@@ -18,36 +18,39 @@
 */
 #pragma once
 
+#include "td/actor/core/SchedulerId.h"
 #include "td/actor/core/SchedulerMessage.h"
 
-#include "td/utils/MpmcQueue.h"
 #include "td/utils/MpmcWaiter.h"
 #include "td/utils/Span.h"
 
+#include <array>
+
 namespace td {
 namespace actor {
 namespace core {
-template <class T>
-struct LocalQueue;
+struct CpuQueues;
 class CpuWorker {
  public:
-  CpuWorker(MpmcQueue<SchedulerMessage::Raw *> &queue, MpmcWaiter &waiter, size_t id,
-            MutableSpan<LocalQueue<SchedulerMessage::Raw *>> local_queues)
-      : queue_(queue), waiter_(waiter), id_(id), local_queues_(local_queues) {
+  CpuWorker(MutableSpan<CpuQueues> queues, MpmcWaiter &waiter, size_t id, Span<size_t> steal_order)
+      : queues_(queues), waiter_(waiter), id_(id), steal_order_(steal_order) {
   }
   void run();
 
  private:
-  MpmcQueue<SchedulerMessage::Raw *> &queue_;
+  MutableSpan<CpuQueues> queues_;  // indexed by ActorPriority
   MpmcWaiter &waiter_;
   size_t id_;
-  MutableSpan<LocalQueue<SchedulerMessage::Raw *>> local_queues_;
+  Span<size_t> steal_order_;
   size_t cnt_{0};
+  // virtual time of each priority; serving an actor advances it by the stride of the priority
+  std::array<uint64, ACTOR_PRIORITY_COUNT> pass_{};
 
   bool try_pop(SchedulerMessage &message, size_t thread_id);
+  bool try_pop(CpuQueues &queues, SchedulerMessage &message, size_t thread_id);
 
-  bool try_pop_local(SchedulerMessage &message);
-  bool try_pop_global(SchedulerMessage &message, size_t thread_id);
+  bool try_pop_local(CpuQueues &queues, SchedulerMessage &message);
+  bool try_pop_global(CpuQueues &queues, SchedulerMessage &message, size_t thread_id);
 };
 }  // namespace core
 }  // namespace actor
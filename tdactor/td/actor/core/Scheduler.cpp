@@ -21,6 +21,8 @@
 #include "td/actor/core/CpuWorker.h"
 #include "td/actor/core/IoWorker.h"
 
+#include <algorithm>
+
 namespace td {
 namespace actor {
 namespace core {
@@ -33,20 +35,53 @@ bool need_debug() {
   return debug.load(std::memory_order_relaxed);
 }
 
+// Workers steal round robin. When they are bound to cpus, nearer workers are tried first:
+// on the same core, then in the same core complex, then on the same NUMA node.
+static std::vector<std::vector<size_t>> calc_steal_order(size_t cpu_threads_count,
+                                                         const std::vector<CpuTopology::Cpu> &cpus) {
+  std::vector<std::vector<size_t>> res(cpu_threads_count);
+  for (size_t i = 0; i < cpu_threads_count; i++) {
+    for (size_t j = 1; j < cpu_threads_count; j++) {
+      res[i].push_back((i + j) % cpu_threads_count);
+    }
+    if (cpus.size() == cpu_threads_count) {
+      auto distance = [&](size_t j) {
+        if (cpus[i].core == cpus[j].core) {
+          return 0;
+        }
+        if (cpus[i].cache == cpus[j].cache) {
+          return 1;
+        }
+        if (cpus[i].node == cpus[j].node) {
+          return 2;
+        }
+        return 3;
+      };
+      std::stable_sort(res[i].begin(), res[i].end(), [&](size_t a, size_t b) { return distance(a) < distance(b); });
+    }
+  }
+  return res;
+}
+
 Scheduler::Scheduler(std::shared_ptr<SchedulerGroupInfo> scheduler_group_info, SchedulerId id, size_t cpu_threads_count,
-                     bool skip_timeouts)
+                     bool skip_timeouts, std::vector<CpuTopology::Cpu> cpu_worker_cpus)
     : scheduler_group_info_(std::move(scheduler_group_info))
     , cpu_threads_(cpu_threads_count)
+    , cpu_worker_cpus_(std::move(cpu_worker_cpus))
     , skip_timeouts_(skip_timeouts) {
+  CHECK(cpu_worker_cpus_.empty() || cpu_worker_cpus_.size() == cpu_threads_count);
   scheduler_group_info_->active_scheduler_count++;
   info_ = &scheduler_group_info_->schedulers.at(id.value());
   info_->id = id;
   if (cpu_threads_count != 0) {
     info_->cpu_threads_count = cpu_threads_count;
-    info_->cpu_queue = std::make_unique<MpmcQueue<SchedulerMessage::Raw *>>(1024, max_thread_count());
+    for (auto &queues : info_->cpu_queues) {
+      queues.queue = std::make_unique<MpmcQueue<SchedulerMessage::Raw *>>(1024, max_thread_count());
+      queues.local_queue = std::vector<LocalQueue<SchedulerMessage::Raw *>>(cpu_threads_count);
+    }
     info_->cpu_queue_waiter = std::make_unique<MpmcWaiter>();
 
-    info_->cpu_local_queue = std::vector<LocalQueue<SchedulerMessage::Raw *>>(cpu_threads_count);
+    info_->cpu_steal_order = calc_steal_order(cpu_threads_count, cpu_worker_cpus_);
   }
   info_->io_queue = std::make_unique<MpscPollableQueue<SchedulerMessage>>();
   info_->io_queue->init();
@@ -78,8 +113,15 @@ Scheduler::~Scheduler() {
 void Scheduler::start() {
   for (size_t i = 0; i < cpu_threads_.size(); i++) {
     cpu_threads_[i] = td::thread([this, i] {
+      if (!cpu_worker_cpus_.empty()) {
+        // bind before running anything, so memory first touched by the worker (e.g. its pool of ActorInfo)
+        // is allocated on its NUMA node
+        auto cpu = cpu_worker_cpus_[i].id;
+        auto status = td::thread::set_affinity(td::this_thread::get_id(), {cpu});
+        LOG_IF(WARNING, status.is_error()) << "Failed to bind cpu worker #" << i << " to cpu " << cpu << ": " << status;
+      }
       this->run_in_context_impl(*this->info_->cpu_workers[i], [this, i] {
-        CpuWorker(*info_->cpu_queue, *info_->cpu_queue_waiter, i, info_->cpu_local_queue).run();
+        CpuWorker(info_->cpu_queues, *info_->cpu_queue_waiter, i, info_->cpu_steal_order[i]).run();
       });
     });
     cpu_threads_[i].set_name(PSLICE() << "#" << info_->id.value() << ":cpu#" << i);
@@ -158,21 +200,26 @@ void Scheduler::ContextImpl::add_to_queue(ActorInfoPtr actor_info_ptr, Scheduler
   }
   //LOG(ERROR) << "Add to queue: " << actor_info_ptr->get_name() << " " << scheduler_id.value();
   auto &info = scheduler_group()->schedulers.at(scheduler_id.value());
-  if (need_poll || !info.cpu_queue) {
+  if (need_poll || info.cpu_threads_count == 0) {
     info.io_queue->writer_put(std::move(actor_info_ptr));
   } else {
+    CHECK(actor_info_ptr);
+    auto priority = actor_info_ptr->get_priority();
+    auto &queues = info.cpu_queues[static_cast<size_t>(priority)];
+    if (CpuQueues::is_counted(priority)) {
+      queues.size.fetch_add(1, std::memory_order_relaxed);
+    }
     if (scheduler_id == get_scheduler_id() && cpu_worker_id_.is_valid()) {
       // may push local
-      CHECK(actor_info_ptr);
       auto raw = actor_info_ptr.release();
-      auto should_notify = info.cpu_local_queue[cpu_worker_id_.value()].push(
-          raw, [&](auto value) { info.cpu_queue->push(value, get_thread_id()); });
+      auto should_notify = queues.local_queue[cpu_worker_id_.value()].push(
+          raw, [&](auto value) { queues.queue->push(value, get_thread_id()); });
       if (should_notify) {
         info.cpu_queue_waiter->notify();
       }
       return;
     }
-    info.cpu_queue->push(actor_info_ptr.release(), get_thread_id());
+    queues.queue->push(actor_info_ptr.release(), get_thread_id());
     info.cpu_queue_waiter->notify();
   }
 }
@@ -244,8 +291,10 @@ void Scheduler::ContextImpl::stop() {
   // Notify all workers of all schedulers
   for (auto &scheduler_info : group.schedulers) {
     scheduler_info.io_queue->writer_put({});
+    // workers always poll the queue of normal priority
+    auto &queues = scheduler_info.cpu_queues[static_cast<size_t>(ActorPriority::Normal)];
     for (size_t i = 0; i < scheduler_info.cpu_threads_count; i++) {
-      scheduler_info.cpu_queue->push({}, get_thread_id());
+      queues.queue->push({}, get_thread_id());
       scheduler_info.cpu_queue_waiter->notify();
     }
   }
@@ -290,29 +339,31 @@ void Scheduler::close_scheduler_group(SchedulerGroupInfo &group_info) {
         }
       }
 
-      // Drain cpu queue
-      for (auto &q : scheduler_info.cpu_local_queue) {
-        auto &cpu_queue = q;
-        while (true) {
-          SchedulerMessage::Raw *raw_message;
-          if (!cpu_queue.try_pop(raw_message)) {
-            break;
+      // Drain cpu queues
+      for (auto &queues : scheduler_info.cpu_queues) {
+        for (auto &q : queues.local_queue) {
+          auto &cpu_queue = q;
+          while (true) {
+            SchedulerMessage::Raw *raw_message;
+            if (!cpu_queue.try_pop(raw_message)) {
+              break;
+            }
+            SchedulerMessage(SchedulerMessage::acquire_t{}, raw_message);
+            // message's destructor is called
+            queues_are_empty = false;
           }
-          SchedulerMessage(SchedulerMessage::acquire_t{}, raw_message);
-          // message's destructor is called
-          queues_are_empty = false;
         }
-      }
-      if (scheduler_info.cpu_queue) {
-        auto &cpu_queue = *scheduler_info.cpu_queue;
-        while (true) {
-          SchedulerMessage::Raw *raw_message;
-          if (!cpu_queue.try_pop(raw_message, get_thread_id())) {
-            break;
+        if (queues.queue) {
+          auto &cpu_queue = *queues.queue;
+          while (true) {
+            SchedulerMessage::Raw *raw_message;
+            if (!cpu_queue.try_pop(raw_message, get_thread_id())) {
+              break;
+            }
+            SchedulerMessage(SchedulerMessage::acquire_t{}, raw_message);
+            // message's destructor is called
+            queues_are_empty = false;
           }
-          SchedulerMessage(SchedulerMessage::acquire_t{}, raw_message);
-          // message's destructor is called
-          queues_are_empty = false;
         }
       }
     }
@@ -325,7 +376,9 @@ void Scheduler::close_scheduler_group(SchedulerGroupInfo &group_info) {
   // Just to destroy all elements should be ok.
   for (auto &scheduler_info : group_info.schedulers) {
     scheduler_info.io_queue.reset();
-    scheduler_info.cpu_queue.reset();
+    for (auto &queues : scheduler_info.cpu_queues) {
+      queues.queue.reset();
+    }
 
     // Do not destroy worker infos. run_in_context will crash if they are empty
     scheduler_info.io_worker->actor_info_creator.clear();
@@ -44,6 +44,7 @@
 #include "td/utils/MpscLinkQueue.h"
 #include "td/utils/MpscPollableQueue.h"
 #include "td/utils/optional.h"
+#include "td/utils/port/CpuTopology.h"
 #include "td/utils/port/Poll.h"
 #include "td/utils/port/detail/Iocp.h"
 #include "td/utils/port/thread.h"
@@ -53,6 +54,7 @@
 #include "td/utils/Time.h"
 #include "td/utils/type_traits.h"
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <limits>
@@ -148,13 +150,29 @@ struct LocalQueue {
   char pad[TD_CONCURRENCY_PAD - sizeof(optional<T>)];
 };
 
+// Queues of actors of one priority
+struct CpuQueues {
+  // will be read by all workers is any thread
+  std::unique_ptr<MpmcQueue<SchedulerMessage::Raw *>> queue;
+  std::vector<LocalQueue<SchedulerMessage::Raw *>> local_queue;
+
+  // Not less than the number of queued actors, so workers may skip empty queues without polling them.
+  // Not maintained for ActorPriority::Normal, which is always polled.
+  std::atomic<int64> size{0};
+
+  static bool is_counted(ActorPriority priority) {
+    return priority != ActorPriority::Normal;
+  }
+};
+
 struct SchedulerInfo {
   SchedulerId id;
-  // will be read by all workers is any thread
-  std::unique_ptr<MpmcQueue<SchedulerMessage::Raw *>> cpu_queue;
+  // indexed by ActorPriority
+  std::array<CpuQueues, ACTOR_PRIORITY_COUNT> cpu_queues;
   std::unique_ptr<MpmcWaiter> cpu_queue_waiter;
 
-  std::vector<LocalQueue<SchedulerMessage::Raw *>> cpu_local_queue;
+  // order in which each cpu worker tries to steal from local queues of the other workers
+  std::vector<std::vector<size_t>> cpu_steal_order;
   //std::vector<td::StealingQueue<SchedulerMessage>> cpu_stealing_queue;
 
   // only scheduler itself may read from io_queue_
@@ -193,8 +211,9 @@ class Scheduler {
     return thread_id;
   }
 
+  // cpu_worker_cpus, if not empty, holds a cpu for each cpu worker to be bound to
   Scheduler(std::shared_ptr<SchedulerGroupInfo> scheduler_group_info, SchedulerId id, size_t cpu_threads_count,
-            bool skip_timeouts = false);
+            bool skip_timeouts = false, std::vector<CpuTopology::Cpu> cpu_worker_cpus = {});
 
   Scheduler(const Scheduler &) = delete;
   Scheduler &operator=(const Scheduler &) = delete;
@@ -231,6 +250,7 @@ class Scheduler {
   std::shared_ptr<SchedulerGroupInfo> scheduler_group_info_;
   SchedulerInfo *info_;
   std::vector<td::thread> cpu_threads_;
+  std::vector<CpuTopology::Cpu> cpu_worker_cpus_;
   bool is_stopped_{false};
   Poll poll_;
   KHeap<double> heap_;
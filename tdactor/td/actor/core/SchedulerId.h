@@ -63,6 +63,11 @@ class CpuWorkerId {
  private:
   int32 id_{-1};
 };
+
+// Cpu workers keep actors of each priority in separate queues and serve them in shares, so that latency-critical
+// actors overtake bulk work, which nevertheless keeps making progress. Actors with poll ignore the priority.
+enum class ActorPriority : uint8 { Realtime, Normal, Background };
+constexpr size_t ACTOR_PRIORITY_COUNT = 3;
 }  // namespace core
 }  // namespace actor
 }  // namespace td
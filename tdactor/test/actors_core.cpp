@@ -459,6 +459,74 @@ TEST(Actor2, scheduler_simple) {
   core::Scheduler::close_scheduler_group(*group_info);
 }
 
+TEST(Actor2, scheduler_pinned) {
+  auto group_info = std::make_shared<core::SchedulerGroupInfo>(1);
+  core::Scheduler scheduler{group_info, SchedulerId{0}, 3, false, td::CpuTopology::get().select(3)};
+  scheduler.start();
+  scheduler.run_in_context([] {
+    global_cnt = 1000;
+    for (int i = 0; i < global_cnt; i++) {
+      detail::create_actor<Master>(ActorOptions().with_name("Master"));
+    }
+  });
+  while (scheduler.run(1000)) {
+  }
+  core::Scheduler::close_scheduler_group(*group_info);
+}
+
+TEST(Actor2, scheduler_priorities) {
+  auto group_info = std::make_shared<core::SchedulerGroupInfo>(1);
+  core::Scheduler scheduler{group_info, SchedulerId{0}, 1};
+
+  class Recorder : public Actor {
+   public:
+    Recorder(ActorPriority priority, std::vector<ActorPriority> *order, size_t total)
+        : priority_(priority), order_(order), total_(total) {
+    }
+    void start_up() override {
+      order_->push_back(priority_);
+      if (order_->size() == total_) {
+        SchedulerContext::get()->stop();
+      }
+      stop();
+    }
+
+   private:
+    ActorPriority priority_;
+    std::vector<ActorPriority> *order_;
+    size_t total_;
+  };
+
+  // everything is queued before the only cpu worker starts
+  constexpr size_t n = 32;
+  std::vector<ActorPriority> order;
+  scheduler.run_in_context([&] {
+    for (size_t i = 0; i < n; i++) {
+      for (auto priority : {ActorPriority::Background, ActorPriority::Normal, ActorPriority::Realtime}) {
+        create_actor<Recorder>(ActorOptions().with_name("Recorder").with_priority(priority), priority, &order, 3 * n)
+            .release();
+      }
+    }
+  });
+  scheduler.start();
+  while (scheduler.run(1000)) {
+  }
+  core::Scheduler::close_scheduler_group(*group_info);
+
+  ASSERT_EQ(3 * n, order.size());
+  auto count_before_last = [&](ActorPriority last, ActorPriority priority) {
+    auto end = std::find(order.rbegin(), order.rend(), last).base();
+    return std::count(order.begin(), end, priority);
+  };
+  // shares are 16:4:1, but lower priorities are not starved
+  auto normal = count_before_last(ActorPriority::Realtime, ActorPriority::Normal);
+  auto background = count_before_last(ActorPriority::Realtime, ActorPriority::Background);
+  ASSERT_TRUE(6 <= normal && normal <= 10);
+  ASSERT_TRUE(1 <= background && background <= 3);
+  background = count_before_last(ActorPriority::Normal, ActorPriority::Background);
+  ASSERT_TRUE(background <= static_cast<std::ptrdiff_t>(n / 4 + 2));
+}
+
 TEST(Actor2, actor_id_simple) {
   auto group_info = std::make_shared<core::SchedulerGroupInfo>(1);
   core::Scheduler scheduler{group_info, SchedulerId{0}, 2};
@@ -1108,6 +1176,70 @@ TEST(Actor2, send_vs_close2) {
   }
 }
 
+TEST(Actor2, latency_stats) {
+  Scheduler scheduler({2});
+  td::actor::set_debug(true);
+  td::actor::core::ActorTypeStatManager::set_sampling(1);
+
+  auto watcher = td::create_shared_destructor([] { SchedulerContext::get()->stop(); });
+  scheduler.run_in_context([watcher = std::move(watcher)] {
+    class Receiver : public Actor {
+     public:
+      void ping(int x) {
+        sum_ += x;
+      }
+
+     private:
+      int sum_{0};
+    };
+    class Master : public Actor {
+     public:
+      explicit Master(std::shared_ptr<td::Destructor> watcher) : watcher_(std::move(watcher)) {
+      }
+      void start_up() override {
+        stats_ = td::actor::create_actor<ActorStats>("actor_stats");
+        receiver_ = td::actor::create_actor<Receiver>("receiver");
+        for (int i = 0; i < 1000; i++) {
+          send_closure_later(receiver_, &Receiver::ping, i);
+        }
+        alarm_timestamp() = td::Timestamp::in(0.1);
+      }
+      void alarm() override {
+        td::actor::send_closure(stats_, &ActorStats::prepare_prometheus_stats,
+                                td::promise_send_closure(actor_id(this), &Master::on_stats));
+      }
+      void on_stats(td::Result<std::string> r_stats) {
+        auto stats = r_stats.move_as_ok();
+        auto latency_stats = td::actor::core::ActorTypeStatManager::get_latency_stats();
+        auto it = latency_stats.by_actor.find(typeid(Receiver));
+        CHECK(it != latency_stats.by_actor.end());
+        CHECK(it->second.total.execute.count == 1000);
+        CHECK(it->second.total.wait.count == 1000);
+        CHECK(it->second.by_message.size() == 1);
+        CHECK(it->second.total.mailbox.count > 0);
+
+        auto find = [&](td::Slice needle) { return stats.find(needle.str()) != std::string::npos; };
+        CHECK(find("# TYPE ton_actor_message_execute_seconds histogram\n"));
+        CHECK(find("ton_actor_messages_total{actor=\""));
+        CHECK(find("ton_actor_delay_seconds_bucket{actor=\""));
+        CHECK(find("ton_actor_message_wait_seconds_count{actor=\""));
+        CHECK(find("Receiver::*)(int)\"}"));
+        CHECK(find(",le=\"+Inf\"} 1000\n"));
+        stop();
+      }
+
+     private:
+      std::shared_ptr<td::Destructor> watcher_;
+      td::actor::ActorOwn<ActorStats> stats_;
+      td::actor::ActorOwn<Receiver> receiver_;
+    };
+    td::actor::create_actor<Master>("Master", watcher).release();
+  });
+
+  scheduler.run();
+  td::actor::core::ActorTypeStatManager::set_sampling(0);
+}
+
 TEST(Actor2, test_stats) {
   Scheduler scheduler({8});
   td::actor::set_debug(true);
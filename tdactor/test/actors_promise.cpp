@@ -19,6 +19,7 @@
 #include "td/actor/actor.h"
 #include "td/actor/PromiseFuture.h"
 #include "td/actor/MultiPromise.h"
+#include "td/actor/Task.h"
 #include "td/utils/MovableValue.h"
 #include "td/utils/tests.h"
 
@@ -381,190 +382,131 @@ TEST(Actor2, MultiPromise) {
   }
 }
 
-#if TD_HAVE_COROUTINES
-#include <experimental/coroutine>
 namespace td {
-template <class T = Unit>
-struct task {
-  struct final_awaiter {
-    bool await_ready() const noexcept {
-      return false;
-    }
-    template <class P>
-    std::experimental::coroutine_handle<> await_suspend(std::experimental::coroutine_handle<P> continuation) noexcept {
-      return continuation.promise().continuation_;
-    }
-    void await_resume() noexcept {
-    }
-  };
-  struct promise_type {
-    task get_return_object() {
-      return task{*this};
-    }
-    std::experimental::suspend_always initial_suspend() {
-      return {};
-    }
-    final_awaiter final_suspend() {
-      return final_awaiter{};
-    }
-    void return_value(T v) {
-      value_ = v;
-    }
-    T move_value() {
-      return std::move(value_.value());
-    }
-    void unhandled_exception() {
-    }
-
-    optional<T> value_;
-    std::experimental::coroutine_handle<> continuation_;
-  };
-
-  // awaiter
-  std::experimental::coroutine_handle<promise_type> coroutine_handle_;
-  task(task &&other) = default;
-  task(promise_type &promise)
-      : coroutine_handle_(std::experimental::coroutine_handle<promise_type>::from_promise(promise)) {
+namespace actor {
+class CoroWorker : public Actor {
+ public:
+  void square(int x, Promise<int> promise) {
+    promise.set_value(x * x);
   }
-
-  bool await_ready() const noexcept {
-    return !coroutine_handle_ || coroutine_handle_.done();
+  void fail(Promise<int> promise) {
+    promise.set_error(Status::Error(1, "fail"));
   }
-  std::experimental::coroutine_handle<> await_suspend(std::experimental::coroutine_handle<> continuation) noexcept {
-    coroutine_handle_.promise().continuation_ = continuation;
-    return coroutine_handle_;
+  void hold(Promise<int> promise) {
+    held_ = std::move(promise);
   }
-  T await_resume() noexcept {
-    return coroutine_handle_.promise().move_value();
+  void release(int x) {
+    held_.set_value(std::move(x));
   }
-};
-
-task<int> f() {
-  co_return 1;
-}
-task<int> g() {
-  co_return 2;
-}
-task<int> h() {
-  auto a = co_await f();
-  auto b = co_await g();
-  co_return a + b;
-}
 
-struct immediate_task {
-  struct promise_type {
-    immediate_task get_return_object() {
-      return {};
-    }
-    std::experimental::suspend_never initial_suspend() {
-      return {};
-    }
-    std::experimental::suspend_never final_suspend() {
-      return {};
-    }
-    void return_void() {
-    }
-    void unhandled_exception() {
-    }
-  };
+ private:
+  Promise<int> held_;
 };
 
-struct OnActor {
+class CoroSample : public Actor {
  public:
-  template <class T>
-  OnActor(T &&actor_id) : actor_id_(actor_id.as_actor_ref()) {
+  explicit CoroSample(std::shared_ptr<Destructor> watcher) : watcher_(std::move(watcher)) {
   }
-  bool await_ready() const noexcept {
-    return false;
+
+ private:
+  std::shared_ptr<Destructor> watcher_;
+  ActorOwn<CoroWorker> worker_;
+  int steps_{0};
+
+  void start_up() override {
+    worker_ = create_actor<CoroWorker>("CoroWorker");
+    run().start([this](Result<int> r) {
+      ASSERT_EQ(142, r.move_as_ok());
+      stop();
+    });
   }
-  void await_suspend(std::experimental::coroutine_handle<> continuation) noexcept {
-    //TODO: destroy if lambda is lost
-    send_lambda(actor_id_, [continuation]() mutable { continuation.resume(); });
+
+  Task<int> sum_of_squares(int a, int b) {
+    auto [x, y] = co_await all(ask(worker_, &CoroWorker::square, a), ask(worker_, &CoroWorker::square, b));
+    steps_++;  // resumed in this actor
+    co_return x.move_as_ok() + y.move_as_ok();
   }
-  void await_resume() noexcept {
+
+  Task<int> failing() {
+    CO_TRY_RESULT(x, co_await ask(worker_, &CoroWorker::fail));
+    co_return x + 1;
   }
 
- private:
-  actor::detail::ActorRef actor_id_;
-};
+  Task<int> throwing() {
+    throw std::runtime_error("oops");
+    co_return 0;
+  }
 
-immediate_task check_h() {
-  LOG(ERROR) << "check_h: call h";
-  auto c = co_await h();
-  LOG(ERROR) << "check_h: after call h";
-  ASSERT_EQ(3, c);
-}
+  Task<int> run() {
+    CO_TRY_RESULT(a, co_await ask(worker_, &CoroWorker::square, 10));
+    CO_TRY_RESULT(b, co_await sum_of_squares(5, 4));
+    ASSERT_EQ(100, a);
+    ASSERT_EQ(41, b);
+    ASSERT_EQ(1, steps_);
 
-TEST(ActorCoro, Task) {
-  check_h();
-}
-namespace actor {
-class AsyncQuery {};
+    auto r_failed = co_await failing();
+    ASSERT_TRUE(r_failed.is_error());
+    ASSERT_EQ(1, r_failed.error().code());
+    auto r_thrown = co_await throwing();
+    ASSERT_TRUE(r_thrown.is_error());
 
-class Printer : public Actor {
- public:
-  void f();
-  void print_a() {
-    LOG(ERROR) << "a";
-  }
-  void print_b() {
-    LOG(ERROR) << "b";
+    CO_TRY_RESULT(c, co_await await_promise<int>([](Promise<int> promise) { promise.set_value(1); }));
+    co_return a + b + c;
   }
 };
 
-class SampleActor : public Actor {
+class CoroStopped : public Actor {
  public:
-  SampleActor(std::shared_ptr<td::Destructor> watcher) : watcher_(std::move(watcher)) {
+  CoroStopped(std::shared_ptr<Destructor> watcher, ActorId<CoroWorker> worker, std::shared_ptr<int> destroyed)
+      : watcher_(std::move(watcher)), worker_(worker), destroyed_(std::move(destroyed)) {
   }
 
  private:
   std::shared_ptr<Destructor> watcher_;
-  ActorOwn<Printer> printer_;
+  ActorId<CoroWorker> worker_;
+  std::shared_ptr<int> destroyed_;
+
   void start_up() override {
-    printer_ = create_actor<Printer>("Printer");
-    run_coroutine();
-  }
-  task<Unit> print_a() {
-    auto self = actor_id(this);
-    LOG(ERROR) << "enter print_a";
-    co_await OnActor(printer_);
-    detail::current_actor<Printer>().print_a();
-    co_await OnActor(self);
-    LOG(ERROR) << "exit print_a";
-    co_return {};
-  }
-  task<Unit> print_b() {
-    auto self = actor_id(this);
-    LOG(ERROR) << "enter print_b";
-    co_await OnActor(printer_);
-    detail::current_actor<Printer>().print_b();
-    co_await OnActor(self);
-    LOG(ERROR) << "exit print_b";
-    co_return {};
+    wait().start([watcher = watcher_, destroyed = destroyed_](Result<int> r) {
+      ASSERT_TRUE(r.is_error());  // lost promise
+      ++*destroyed;
+    });
+    stop();
   }
 
-  immediate_task run_coroutine() {
-    co_await print_a();
-    co_await print_b();
-    stop();
+  Task<int> wait() {
+    auto guard = ScopeExit() + [watcher = watcher_, destroyed = destroyed_] { ++*destroyed; };
+    auto r = co_await ask(worker_, &CoroWorker::hold);
+    UNREACHABLE();
+    co_return r;
   }
 };
 }  // namespace actor
 
-TEST(ActorCoro, Simple) {
+TEST(ActorCoro, Task) {
   using namespace td::actor;
-  using namespace td;
-  Scheduler scheduler({1});
-
-  auto watcher = td::create_shared_destructor([] {
-    LOG(ERROR) << "STOP";
-    SchedulerContext::get()->stop();
-  });
+  Scheduler scheduler({2});
+  auto watcher = td::create_shared_destructor([] { SchedulerContext::get()->stop(); });
   scheduler.run_in_context([watcher = std::move(watcher)] {
-    create_actor<actor::SampleActor>(ActorOptions().with_name("SampleActor").with_poll(), watcher).release();
+    create_actor<CoroSample>(ActorOptions().with_name("CoroSample").with_poll(), watcher).release();
+  });
+  scheduler.run();
+}
+
+TEST(ActorCoro, StopWhileSuspended) {
+  using namespace td::actor;
+  Scheduler scheduler({2});
+  auto destroyed = std::make_shared<int>(0);
+  auto watcher = td::create_shared_destructor([] { SchedulerContext::get()->stop(); });
+  scheduler.run_in_context([watcher = std::move(watcher), destroyed] {
+    auto worker = create_actor<CoroWorker>("CoroWorker").release();
+    create_actor<CoroStopped>("CoroStopped", watcher, worker, destroyed).release();
+    // the answer arrives after CoroStopped is stopped
+    send_closure_later(worker, &CoroWorker::release, 1);
+    send_lambda_later(worker, [worker_own = ActorOwn<CoroWorker>(worker)] {});
   });
   scheduler.run();
+  ASSERT_EQ(2, *destroyed);
 }
 
 }  // namespace td
-#endif
@@ -124,6 +124,10 @@ class KeyValue : public KeyValueReader {
   virtual Status flush() {
     return Status::OK();
   }
+  // Secondary (read-only) instances only: apply the updates made by the primary since the last call
+  virtual Status try_catch_up_with_primary() {
+    return Status::OK();
+  }
   virtual UsageStats get_usage_stats() {
     return {};
   }
@@ -184,6 +188,9 @@ class PrefixedKeyValue : public KeyValue {
   Status flush() override {
     return kv_->flush();
   }
+  Status try_catch_up_with_primary() override {
+    return kv_->try_catch_up_with_primary();
+  }
 
  private:
   std::shared_ptr<KeyValue> kv_;
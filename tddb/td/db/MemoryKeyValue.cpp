@@ -21,6 +21,8 @@
 #include "td/utils/format.h"
 #include "td/utils/Span.h"
 
+#include <algorithm>
+
 namespace td {
 Result<MemoryKeyValue::GetStatus> MemoryKeyValue::get(Slice key, std::string &value) {
   auto bucket = lock(key);
@@ -64,17 +66,23 @@ Status MemoryKeyValue::for_each(std::function<Status(Slice, Slice)> f) {
 }
 
 Status MemoryKeyValue::for_each_in_range(Slice begin, Slice end, std::function<Status(Slice, Slice)> f) {
+  // Keys are spread over buckets by hash, so the range is collected first and visited in key order
+  std::vector<std::pair<std::string, std::string>> range;
   for (auto &unlocked_bucket : buckets_) {
     auto bucket = lock(unlocked_bucket);
     auto &map = bucket->map;
     for (auto it = map.lower_bound(begin); it != map.end(); it++) {
       if (it->first < end) {
-        TRY_STATUS(f(it->first, it->second));
+        range.emplace_back(it->first, it->second);
       } else {
         break;
       }
     }
   }
+  std::sort(range.begin(), range.end());
+  for (auto &it : range) {
+    TRY_STATUS(f(it.first, it.second));
+  }
   return Status::OK();
 }
 Status MemoryKeyValue::set(Slice key, Slice value) {
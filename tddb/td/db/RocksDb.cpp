@@ -26,6 +26,7 @@
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/filter_policy.h"
 #include "td/utils/misc.h"
+#include "td/utils/port/path.h"
 
 namespace td {
 namespace {
@@ -113,6 +114,16 @@ Result<RocksDb> RocksDb::open(std::string path, RocksDbOptions options) {
     // Place your experimental options here
   }
 
+  if (!options.secondary_path.empty()) {
+    // Secondary instances must keep all table files open: the primary may delete them at any time
+    db_options.max_open_files = -1;
+    db_options.create_if_missing = false;
+    TRY_STATUS(td::mkpath(options.secondary_path));
+    rocksdb::DB *db{nullptr};
+    TRY_STATUS(from_rocksdb(rocksdb::DB::OpenAsSecondary(db_options, std::move(path), options.secondary_path, &db)));
+    return RocksDb(std::shared_ptr<rocksdb::DB>(db), std::move(options));
+  }
+
   if (options.no_transactions) {
     rocksdb::DB *db{nullptr};
     TRY_STATUS(from_rocksdb(rocksdb::DB::Open(db_options, std::move(path), &db)));
@@ -378,9 +389,19 @@ Status RocksDb::abort_transaction() {
 }
 
 Status RocksDb::flush() {
+  if (!options_.secondary_path.empty()) {
+    return Status::OK();
+  }
   return from_rocksdb(db_->Flush({}));
 }
 
+Status RocksDb::try_catch_up_with_primary() {
+  if (options_.secondary_path.empty()) {
+    return Status::OK();
+  }
+  return from_rocksdb(db_->TryCatchUpWithPrimary());
+}
+
 Status RocksDb::begin_snapshot() {
   snapshot_.reset(db_->GetSnapshot());
   if (options_.snapshot_statistics) {
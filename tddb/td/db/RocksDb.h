@@ -77,6 +77,10 @@ struct RocksDbOptions {
   bool no_block_cache = false;
   bool enable_bloom_filter = false;
   bool two_level_index_and_filter = false;
+
+  // If set, the database is opened as a read-only secondary instance of the primary at `path`.
+  // The directory is used by the secondary for its own info logs. Call try_catch_up_with_primary to see new writes.
+  std::string secondary_path;
 };
 
 class RocksDb : public KeyValue {
@@ -103,6 +107,7 @@ class RocksDb : public KeyValue {
   Status commit_transaction() override;
   Status abort_transaction() override;
   Status flush() override;
+  Status try_catch_up_with_primary() override;
 
   Status begin_snapshot();
   Status end_snapshot();
@@ -76,6 +76,43 @@ TEST(KeyValue, simple) {
   CHECK(!options.snapshot_statistics->oldest_snapshot_timestamp());
 };
 
+TEST(KeyValue, secondary) {
+  td::Slice db_name = "testdb";
+  td::RocksDb::destroy(db_name).ignore();
+
+  auto primary = td::RocksDb::open(db_name.str()).move_as_ok();
+  auto set_value = [&](td::Slice key, td::Slice value) {
+    primary.begin_write_batch().ensure();
+    primary.set(key, value).ensure();
+    primary.commit_write_batch().ensure();
+  };
+  set_value("A", "HELLO");
+
+  td::RocksDbOptions options;
+  options.secondary_path = "testdb-secondary";
+  auto secondary = td::RocksDb::open(db_name.str(), options).move_as_ok();
+  auto get_value = [&](td::Slice key) -> td::optional<std::string> {
+    std::string value;
+    if (secondary.get(key, value).move_as_ok() == td::KeyValue::GetStatus::NotFound) {
+      return {};
+    }
+    return value;
+  };
+  ASSERT_EQ("HELLO", get_value("A").value());
+
+  set_value("B", "WORLD");
+  ASSERT_TRUE(!get_value("B"));
+  secondary.try_catch_up_with_primary().ensure();
+  ASSERT_EQ("WORLD", get_value("B").value());
+
+  primary.flush().ensure();
+  set_value("A", "BYE");
+  secondary.try_catch_up_with_primary().ensure();
+  ASSERT_EQ("BYE", get_value("A").value());
+
+  ASSERT_TRUE(secondary.set("C", "X").is_error());
+}
+
 TEST(KeyValue, async_simple) {
   td::Slice db_name = "testdb";
   td::RocksDb::destroy(db_name).ignore();
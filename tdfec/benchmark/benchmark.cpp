@@ -35,6 +35,8 @@
 #include "td/fec/algebra/Octet.h"
 #include "td/fec/algebra/GaussianElimination.h"
 #include "td/fec/algebra/Simd.h"
+#include "td/fec/common/SymbolsView.h"
+#include "td/fec/raptorq/Solver.h"
 #include <cstdio>
 
 template <class Simd, size_t size = 256>
@@ -185,6 +187,34 @@ class SolverBenchmark : public td::Benchmark {
   size_t symbol_size_;
 };
 
+// Encoder precalc: the first K_padded symbols of a block, with and without the cached solver plan
+class SolverPlanBenchmark : public td::Benchmark {
+ public:
+  SolverPlanBenchmark(size_t symbols_count, size_t symbol_size, bool use_plan_cache)
+      : p_(td::raptorq::Rfc::get_parameters(symbols_count).move_as_ok())
+      , symbol_size_(symbol_size)
+      , use_plan_cache_(use_plan_cache) {
+    data_ = td::rand_string('a', 'z', td::narrow_cast<int>(symbols_count * symbol_size));
+  }
+  std::string get_description() const override {
+    return PSTRING() << "SolverPlanBenchmark " << (use_plan_cache_ ? "cached " : "uncached ")
+                     << td::tag("symbols_count", p_.K) << td::tag("symbol_size", symbol_size_);
+  }
+
+  void run(int n) override {
+    td::raptorq::SymbolsView symbols(p_.K_padded, symbol_size_, data_);
+    for (int j = 0; j < n; j++) {
+      td::raptorq::Solver::run(p_, symbols.symbols(), use_plan_cache_).ensure();
+    }
+  }
+
+ private:
+  td::raptorq::Rfc::Parameters p_;
+  size_t symbol_size_;
+  bool use_plan_cache_;
+  std::string data_;
+};
+
 template <class Encoder, class Decoder>
 class FecBenchmark : public td::Benchmark {
  public:
@@ -235,12 +265,25 @@ class FecBenchmark : public td::Benchmark {
 template <template <class T, size_t size> class O, size_t size = 256 * 8>
 void bench_simd() {
   bench(O<td::Simd_null, size>("baseline"));
-#if TD_SSSE3
-  bench(O<td::Simd_sse, size>("SSE"));
+#if TD_SSE3 || TD_SIMD_DISPATCH
+  if (td::Simd_sse::is_supported()) {
+    bench(O<td::Simd_sse, size>("SSE"));
+  }
+#endif
+#if TD_AVX2 || TD_SIMD_DISPATCH
+  if (td::Simd_avx::is_supported()) {
+    bench(O<td::Simd_avx, size>("AVX"));
+  }
 #endif
-#if TD_AVX2
-  bench(O<td::Simd_avx, size>("AVX"));
+#if TD_SIMD_DISPATCH
+  if (td::Simd_avx512::is_supported()) {
+    bench(O<td::Simd_avx512, size>("AVX-512"));
+  }
+  if (td::Simd_gfni::is_supported()) {
+    bench(O<td::Simd_gfni, size>("GFNI"));
+  }
 #endif
+  bench(O<td::Simd_dispatch, size>("dispatch"));
 }
 
 void run_encode_benchmark() {
@@ -277,6 +320,8 @@ void run_encode_benchmark() {
 
 int main(void) {
   SET_VERBOSITY_LEVEL(VERBOSITY_NAME(ERROR));
+  fprintf(stderr, "Simd: %s, runtime dispatch: %s\n", td::Simd::get_name().c_str(),
+          td::Simd_dispatch::get_name().c_str());
   run_encode_benchmark();
   bench_simd<Simd_gf256_mul, 32>();
   bench_simd<Simd_gf256_add_mul, 32>();
@@ -298,6 +343,11 @@ int main(void) {
     bench(FecBenchmark<td::fec::RaptorQEncoder, td::fec::RaptorQDecoder>(symbol_size, 50000, "RaptorQ"));
   }
 
+  for (size_t symbols_count : {100, 1000, 3000}) {
+    bench(SolverPlanBenchmark(symbols_count, 768, false));
+    bench(SolverPlanBenchmark(symbols_count, 768, true));
+  }
+
   SET_VERBOSITY_LEVEL(VERBOSITY_NAME(WARNING));
   bench(SolverBenchmark(50000 * 200, 200));
   return 0;
@@ -0,0 +1,83 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+#include "td/fec/algebra/Simd.h"
+
+namespace td {
+
+#if TD_SIMD_DISPATCH
+namespace {
+constexpr uint8 gf256_mul_slow(uint8 a, uint8 b) {
+  uint32 res = 0;
+  uint32 x = a;
+  for (int i = 0; i < 8; i++) {
+    if (b & (1 << i)) {
+      res ^= x;
+    }
+    x <<= 1;
+    if (x & 0x100) {
+      x ^= 0x11d;
+    }
+  }
+  return static_cast<uint8>(res);
+}
+
+// Byte 7 - i of the matrix selects the input bits that make up bit i of the product
+constexpr uint64 gf256_affine_matrix(uint8 u) {
+  uint64 res = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64 row = 0;
+    for (int j = 0; j < 8; j++) {
+      row |= static_cast<uint64>((gf256_mul_slow(u, static_cast<uint8>(1 << j)) >> i) & 1) << j;
+    }
+    res |= row << (8 * (7 - i));
+  }
+  return res;
+}
+
+constexpr std::array<uint64, 256> gf256_affine_matrices() {
+  std::array<uint64, 256> res{};
+  for (int u = 0; u < 256; u++) {
+    res[u] = gf256_affine_matrix(static_cast<uint8>(u));
+  }
+  return res;
+}
+}  // namespace
+
+const std::array<uint64, 256> Simd_gfni::AffineMatrix = gf256_affine_matrices();
+#endif
+
+SimdKernels SimdKernels::select() {
+#if TD_SIMD_DISPATCH
+  if (Simd_gfni::is_supported()) {
+    return create<Simd_gfni>();
+  }
+  if (Simd_avx512::is_supported()) {
+    return create<Simd_avx512>();
+  }
+  if (Simd_avx::is_supported()) {
+    return create<Simd_avx>();
+  }
+  if (Simd_sse::is_supported()) {
+    return create<Simd_sse>();
+  }
+#endif
+  return create<Simd_null>();
+}
+
+}  // namespace td
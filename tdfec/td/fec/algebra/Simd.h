@@ -21,6 +21,9 @@
 
 #include "td/fec/algebra/Octet.h"
 
+#include <array>
+#include <string>
+
 #if __SSSE3__
 #define TD_SSE3 1
 #endif
@@ -30,8 +33,17 @@
 #define TD_SSE3 1
 #endif
 
-#if TD_AVX2
-#include <immintrin.h> /* avx2 */
+// With GCC or Clang on x86 all SIMD variants are compiled with per-function target attributes,
+// so a portable binary may pick the best one at runtime (see Simd_dispatch)
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(_MSC_VER) && (defined(__clang__) || __GNUC__ >= 9)
+#define TD_SIMD_DISPATCH 1
+#define TD_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define TD_SIMD_TARGET(isa)
+#endif
+
+#if TD_AVX2 || TD_SIMD_DISPATCH
+#include <immintrin.h> /* avx2, avx512, gfni */
 #elif TD_SSE3
 #include <tmmintrin.h> /* ssse3 */
 #endif
@@ -46,6 +58,9 @@ class Simd_null {
   static std::string get_name() {
     return "Without simd";
   }
+  static bool is_supported() {
+    return true;
+  }
   static bool is_aligned_pointer(const void *ptr) {
     return ::td::is_aligned_pointer<alignment()>(ptr);
   }
@@ -88,7 +103,7 @@ class Simd_null {
   }
 };
 
-#if TD_SSE3
+#if TD_SSE3 || TD_SIMD_DISPATCH
 class Simd_sse : public Simd_null {
  public:
   static constexpr size_t alignment() {
@@ -99,11 +114,19 @@ class Simd_sse : public Simd_null {
     return "With SSE";
   }
 
+  static bool is_supported() {
+#if TD_SIMD_DISPATCH
+    return __builtin_cpu_supports("ssse3");
+#else
+    return true;
+#endif
+  }
+
   static bool is_aligned_pointer(const void *ptr) {
     return ::td::is_aligned_pointer<alignment()>(ptr);
   }
 
-  static void gf256_add(void *a, const void *b, size_t size) {
+  TD_SIMD_TARGET("ssse3") static void gf256_add(void *a, const void *b, size_t size) {
     DCHECK(is_aligned_pointer(a));
     DCHECK(is_aligned_pointer(b));
     uint8 *ap = reinterpret_cast<uint8 *>(a);
@@ -116,7 +139,7 @@ class Simd_sse : public Simd_null {
       bp128++;
     }
   }
-  static void gf256_mul(void *a, uint8 u, size_t size) {
+  TD_SIMD_TARGET("ssse3") static void gf256_mul(void *a, uint8 u, size_t size) {
     DCHECK(is_aligned_pointer(a));
     uint8 *ap = reinterpret_cast<uint8 *>(a);
 
@@ -137,7 +160,7 @@ class Simd_sse : public Simd_null {
       ap128++;
     }
   }
-  static void gf256_add_mul(void *a, const void *b, uint8 u, size_t size) {
+  TD_SIMD_TARGET("ssse3") static void gf256_add_mul(void *a, const void *b, uint8 u, size_t size) {
     DCHECK(is_aligned_pointer(a));
     DCHECK(is_aligned_pointer(b));
     uint8 *ap = reinterpret_cast<uint8 *>(a);
@@ -164,14 +187,22 @@ class Simd_sse : public Simd_null {
 };
 #endif  // SSSE3
 
-#ifdef TD_AVX2
+#if TD_AVX2 || TD_SIMD_DISPATCH
 class Simd_avx : public Simd_sse {
  public:
   static std::string get_name() {
     return "With AVX";
   }
 
-  static void gf256_add(void *a, const void *b, size_t size) {
+  static bool is_supported() {
+#if TD_SIMD_DISPATCH
+    return __builtin_cpu_supports("avx2");
+#else
+    return true;
+#endif
+  }
+
+  TD_SIMD_TARGET("avx2") static void gf256_add(void *a, const void *b, size_t size) {
     DCHECK(is_aligned_pointer(a));
     DCHECK(is_aligned_pointer(b));
     uint8 *ap = reinterpret_cast<uint8 *>(a);
@@ -185,7 +216,7 @@ class Simd_avx : public Simd_sse {
     }
   }
 
-  static __m256i get_mask(const uint32 mask) {
+  TD_SIMD_TARGET("avx2") static __m256i get_mask(const uint32 mask) {
     // abcd -> abcd * 8
     __m256i vmask(_mm256_set1_epi32(mask));
 
@@ -199,7 +230,7 @@ class Simd_avx : public Simd_sse {
     return _mm256_and_si256(_mm256_cmpeq_epi8(vmask, _mm256_set1_epi64x(-1)), _mm256_set1_epi8(1));
   }
 
-  static void gf256_from_gf2(void *a, const void *b, size_t size) {
+  TD_SIMD_TARGET("avx2") static void gf256_from_gf2(void *a, const void *b, size_t size) {
     DCHECK(is_aligned_pointer(a));
     DCHECK(size % 4 == 0);
     __m256i *ap256 = reinterpret_cast<__m256i *>(a);
@@ -210,7 +241,7 @@ class Simd_avx : public Simd_sse {
     }
   }
 
-  static __attribute__((noinline)) void gf256_mul(void *a, uint8 u, size_t size) {
+  TD_SIMD_TARGET("avx2") static __attribute__((noinline)) void gf256_mul(void *a, uint8 u, size_t size) {
     const __m128i urow_hi_small = _mm_load_si128(reinterpret_cast<const __m128i *>(Octet::OctMulHi[u]));
     const __m256i urow_hi = _mm256_broadcastsi128_si256(urow_hi_small);
     const __m128i urow_lo_small = _mm_load_si128(reinterpret_cast<const __m128i *>(Octet::OctMulLo[u]));
@@ -231,7 +262,7 @@ class Simd_avx : public Simd_sse {
     }
   }
 
-  static __attribute__((noinline)) void gf256_add_mul(void *a, const void *b, uint8 u, size_t size) {
+  TD_SIMD_TARGET("avx2") static __attribute__((noinline)) void gf256_add_mul(void *a, const void *b, uint8 u, size_t size) {
     const __m128i urow_hi_small = _mm_load_si128(reinterpret_cast<const __m128i *>(Octet::OctMulHi[u]));
     const __m256i urow_hi = _mm256_broadcastsi128_si256(urow_hi_small);
     const __m128i urow_lo_small = _mm_load_si128(reinterpret_cast<const __m128i *>(Octet::OctMulLo[u]));
@@ -255,8 +286,198 @@ class Simd_avx : public Simd_sse {
 };
 #endif  // AVX2
 
+#if TD_SIMD_DISPATCH
+// Sizes are multiples of 32 but not necessarily of 64, so the 512-bit kernels finish with a masked tail
+class Simd_avx512 : public Simd_avx {
+ public:
+  static std::string get_name() {
+    return "With AVX-512";
+  }
+
+  static bool is_supported() {
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && Simd_avx::is_supported();
+  }
+
+  TD_SIMD_TARGET("avx512f,avx512bw") static __mmask64 tail_mask(size_t size) {
+    DCHECK(size > 0 && size < 64);
+    return ~static_cast<__mmask64>(0) >> (64 - size);
+  }
+
+  TD_SIMD_TARGET("avx512f,avx512bw") static void gf256_add(void *a, const void *b, size_t size) {
+    DCHECK(is_aligned_pointer(a));
+    DCHECK(is_aligned_pointer(b));
+    uint8 *ap = reinterpret_cast<uint8 *>(a);
+    const uint8 *bp = reinterpret_cast<const uint8 *>(b);
+    size_t idx = 0;
+    for (; idx + 64 <= size; idx += 64) {
+      _mm512_storeu_si512(ap + idx, _mm512_xor_si512(_mm512_loadu_si512(ap + idx), _mm512_loadu_si512(bp + idx)));
+    }
+    if (idx < size) {
+      auto mask = tail_mask(size - idx);
+      _mm512_mask_storeu_epi8(
+          ap + idx, mask,
+          _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, ap + idx), _mm512_maskz_loadu_epi8(mask, bp + idx)));
+    }
+  }
+
+  TD_SIMD_TARGET("avx512f,avx512bw") static __m512i mul(__m512i x, __m512i urow_lo, __m512i urow_hi) {
+    const __m512i mask = _mm512_set1_epi8(0x0f);
+    __m512i lo = _mm512_and_si512(x, mask);
+    __m512i hi = _mm512_and_si512(_mm512_srli_epi64(x, 4), mask);
+    return _mm512_xor_si512(_mm512_shuffle_epi8(urow_lo, lo), _mm512_shuffle_epi8(urow_hi, hi));
+  }
+
+  TD_SIMD_TARGET("avx512f,avx512bw") static void gf256_mul(void *a, uint8 u, size_t size) {
+    DCHECK(is_aligned_pointer(a));
+    uint8 *ap = reinterpret_cast<uint8 *>(a);
+    const __m512i urow_hi =
+        _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Octet::OctMulHi[u])));
+    const __m512i urow_lo =
+        _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Octet::OctMulLo[u])));
+    size_t idx = 0;
+    for (; idx + 64 <= size; idx += 64) {
+      _mm512_storeu_si512(ap + idx, mul(_mm512_loadu_si512(ap + idx), urow_lo, urow_hi));
+    }
+    if (idx < size) {
+      auto mask = tail_mask(size - idx);
+      _mm512_mask_storeu_epi8(ap + idx, mask, mul(_mm512_maskz_loadu_epi8(mask, ap + idx), urow_lo, urow_hi));
+    }
+  }
+
+  TD_SIMD_TARGET("avx512f,avx512bw") static void gf256_add_mul(void *a, const void *b, uint8 u, size_t size) {
+    DCHECK(is_aligned_pointer(a));
+    DCHECK(is_aligned_pointer(b));
+    uint8 *ap = reinterpret_cast<uint8 *>(a);
+    const uint8 *bp = reinterpret_cast<const uint8 *>(b);
+    const __m512i urow_hi =
+        _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Octet::OctMulHi[u])));
+    const __m512i urow_lo =
+        _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Octet::OctMulLo[u])));
+    size_t idx = 0;
+    for (; idx + 64 <= size; idx += 64) {
+      _mm512_storeu_si512(ap + idx, _mm512_xor_si512(_mm512_loadu_si512(ap + idx),
+                                                     mul(_mm512_loadu_si512(bp + idx), urow_lo, urow_hi)));
+    }
+    if (idx < size) {
+      auto mask = tail_mask(size - idx);
+      _mm512_mask_storeu_epi8(ap + idx, mask,
+                              _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, ap + idx),
+                                               mul(_mm512_maskz_loadu_epi8(mask, bp + idx), urow_lo, urow_hi)));
+    }
+  }
+};
+
+// Multiplication by a constant is GF(2)-linear, so GF2P8AFFINEQB applies it with one 8x8 bit matrix per
+// multiplier. GF2P8MULB itself can't be used: it is hardwired to the AES polynomial, RaptorQ uses 0x11d.
+class Simd_gfni : public Simd_avx512 {
+ public:
+  static std::string get_name() {
+    return "With AVX-512 GFNI";
+  }
+
+  static bool is_supported() {
+    return __builtin_cpu_supports("gfni") && Simd_avx512::is_supported();
+  }
+
+  static const std::array<uint64, 256> AffineMatrix;
+
+  TD_SIMD_TARGET("avx512f,avx512bw,gfni") static void gf256_mul(void *a, uint8 u, size_t size) {
+    DCHECK(is_aligned_pointer(a));
+    uint8 *ap = reinterpret_cast<uint8 *>(a);
+    const __m512i matrix = _mm512_set1_epi64(static_cast<long long>(AffineMatrix[u]));
+    size_t idx = 0;
+    for (; idx + 64 <= size; idx += 64) {
+      _mm512_storeu_si512(ap + idx, _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(ap + idx), matrix, 0));
+    }
+    if (idx < size) {
+      auto mask = tail_mask(size - idx);
+      _mm512_mask_storeu_epi8(ap + idx, mask,
+                              _mm512_gf2p8affine_epi64_epi8(_mm512_maskz_loadu_epi8(mask, ap + idx), matrix, 0));
+    }
+  }
+
+  TD_SIMD_TARGET("avx512f,avx512bw,gfni") static void gf256_add_mul(void *a, const void *b, uint8 u, size_t size) {
+    DCHECK(is_aligned_pointer(a));
+    DCHECK(is_aligned_pointer(b));
+    uint8 *ap = reinterpret_cast<uint8 *>(a);
+    const uint8 *bp = reinterpret_cast<const uint8 *>(b);
+    const __m512i matrix = _mm512_set1_epi64(static_cast<long long>(AffineMatrix[u]));
+    size_t idx = 0;
+    for (; idx + 64 <= size; idx += 64) {
+      _mm512_storeu_si512(ap + idx,
+                          _mm512_xor_si512(_mm512_loadu_si512(ap + idx),
+                                           _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(bp + idx), matrix, 0)));
+    }
+    if (idx < size) {
+      auto mask = tail_mask(size - idx);
+      _mm512_mask_storeu_epi8(
+          ap + idx, mask,
+          _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, ap + idx),
+                           _mm512_gf2p8affine_epi64_epi8(_mm512_maskz_loadu_epi8(mask, bp + idx), matrix, 0)));
+    }
+  }
+};
+#endif  // TD_SIMD_DISPATCH
+
+// Function table of one of the variants above, chosen once by Simd_dispatch
+struct SimdKernels {
+  std::string name;
+  void (*gf256_add)(void *a, const void *b, size_t size);
+  void (*gf256_mul)(void *a, uint8 u, size_t size);
+  void (*gf256_add_mul)(void *a, const void *b, uint8 u, size_t size);
+  void (*gf256_from_gf2)(void *a, const void *b, size_t size);
+
+  template <class SimdT>
+  static SimdKernels create() {
+    return SimdKernels{SimdT::get_name(), &SimdT::gf256_add, &SimdT::gf256_mul, &SimdT::gf256_add_mul,
+                       &SimdT::gf256_from_gf2};
+  }
+
+  // the fastest variant supported by the current CPU
+  static SimdKernels select();
+};
+
+class Simd_dispatch {
+ public:
+  static constexpr size_t alignment() {
+    return 32;
+  }
+
+  static std::string get_name() {
+    return kernels().name;
+  }
+  static bool is_supported() {
+    return true;
+  }
+  static bool is_aligned_pointer(const void *ptr) {
+    return ::td::is_aligned_pointer<alignment()>(ptr);
+  }
+
+  static void gf256_add(void *a, const void *b, size_t size) {
+    kernels().gf256_add(a, b, size);
+  }
+  static void gf256_mul(void *a, uint8 u, size_t size) {
+    kernels().gf256_mul(a, u, size);
+  }
+  static void gf256_add_mul(void *a, const void *b, uint8 u, size_t size) {
+    kernels().gf256_add_mul(a, b, u, size);
+  }
+  static void gf256_from_gf2(void *a, const void *b, size_t size) {
+    kernels().gf256_from_gf2(a, b, size);
+  }
+
+ private:
+  static const SimdKernels &kernels() {
+    static const SimdKernels res = SimdKernels::select();
+    return res;
+  }
+};
+
+// Builds targeting AVX2 use it directly; otherwise the best variant is chosen at runtime where possible
 #if TD_AVX2
 using Simd = Simd_avx;
+#elif TD_SIMD_DISPATCH
+using Simd = Simd_dispatch;
 #elif TD_SSE3
 using Simd = Simd_sse;
 #else
@@ -64,7 +64,7 @@ Result<DataWithEncoder> RoundRobinDecoder::try_decode(bool need_encoder) {
   }
   std::unique_ptr<Encoder> encoder;
   if (need_encoder) {
-    encoder = RoundRobinEncoder::create(data_.copy(), symbol_size_);
+    encoder = RoundRobinEncoder::create(data_.clone(), symbol_size_);
   }
   return DataWithEncoder{data_.clone(), std::move(encoder)};
 }
@@ -195,7 +195,7 @@ Result<DataWithEncoder> OnlineDecoder::try_decode(bool need_encoder) {
   std::unique_ptr<Encoder> encoder;
   auto data = decoder_->get_data();
   if (need_encoder) {
-    encoder = RoundRobinEncoder::create(data.copy(), symbol_size_);
+    encoder = RoundRobinEncoder::create(data.clone(), symbol_size_);
   }
   return DataWithEncoder{std::move(data), nullptr};
 }
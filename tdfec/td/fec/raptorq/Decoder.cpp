@@ -75,7 +75,7 @@ Result<Decoder::DataWithEncoder> Decoder::try_decode(bool need_encoder) {
 
   std::unique_ptr<Encoder> encoder;
   if (need_encoder) {
-    encoder = std::make_unique<Encoder>(p_, symbol_size_, data.copy(), std::move(raw_encoder));
+    encoder = std::make_unique<Encoder>(p_, symbol_size_, data.clone(), std::move(raw_encoder));
   }
 
   return DataWithEncoder{std::move(data), std::move(encoder)};
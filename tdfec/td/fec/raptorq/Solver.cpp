@@ -19,14 +19,80 @@
 #include "td/fec/raptorq/Solver.h"
 #include "td/fec/algebra/GaussianElimination.h"
 #include "td/fec/algebra/InactivationDecoding.h"
+#include "td/utils/LRUCache.h"
 #include "td/utils/ThreadSafeCounter.h"
 
 #include "td/utils/Timer.h"
 #include <map>
+#include <mutex>
 
 namespace td {
 namespace raptorq {
 
+namespace {
+class PerfLog {
+ public:
+  void operator()(Slice message) {
+    if (GET_VERBOSITY_LEVEL() > VERBOSITY_NAME(DEBUG)) {
+      static std::map<std::string, double> total;
+      static double total_all = 0;
+      auto elapsed = timer_.elapsed();
+      auto current_total = total[message.str()] += elapsed;
+      total_all += elapsed;
+      LOG(DEBUG) << "PERF: " << message << " " << timer_ << " " << current_total / total_all * 100;
+      timer_ = {};
+    }
+  }
+
+ private:
+  Timer timer_;
+};
+
+class PlanCache {
+ public:
+  static PlanCache &get() {
+    static PlanCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<const Solver::Plan> get_plan(uint32 K_padded) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto plan = plans_->get_if_exists(K_padded);
+    return plan ? *plan : nullptr;
+  }
+
+  void put_plan(uint32 K_padded, std::shared_ptr<const Solver::Plan> plan) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    plans_->put(K_padded, std::move(plan));
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    plans_ = std::make_unique<Plans>(MAX_PLANS);
+  }
+
+ private:
+  // broadcasts come in a handful of typical sizes
+  static constexpr uint64 MAX_PLANS = 16;
+  using Plans = LRUCache<uint32, std::shared_ptr<const Solver::Plan>>;
+
+  std::mutex mutex_;
+  std::unique_ptr<Plans> plans_ = std::make_unique<Plans>(MAX_PLANS);
+};
+
+bool is_first_symbols(const Rfc::Parameters &p, Span<SymbolRef> symbols) {
+  if (symbols.size() != p.K_padded) {
+    return false;
+  }
+  for (uint32 i = 0; i < symbols.size(); i++) {
+    if (symbols[i].id != i) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
 MatrixGF256 create_D(const Rfc::Parameters &p, Span<SymbolRef> symbols) {
   auto symbol_size = symbols[0].data.size();
   MatrixGF256 D(p.S + p.H + symbols.size(), symbol_size);
@@ -34,15 +100,13 @@ MatrixGF256 create_D(const Rfc::Parameters &p, Span<SymbolRef> symbols) {
 
   auto offset = p.S;
   for (auto &symbol : symbols) {
-    for (size_t i = 0; i < symbol_size; i++) {
-      D.set(offset, i, Octet(symbol.data[i]));
-    }
+    D.row(offset).copy_from(symbol.data);
     offset++;
   }
   return D;
 }
 
-Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbols) {
+Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbols, bool use_plan_cache) {
   if (0) {  // turns out gauss is slower even for small symbols count
     auto encoding_rows = transform(symbols, [&p](auto &symbol) { return p.get_encoding_row(symbol.id); });
     MatrixGF256 A(p.S + p.H + symbols.size(), p.L);
@@ -73,18 +137,26 @@ Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbol
   }
   TD_PERF_COUNTER(raptor_solve);
   PerfWarningTimer x("solve");
-  Timer timer;
-  auto perf_log = [&](Slice message) {
-    if (GET_VERBOSITY_LEVEL() > VERBOSITY_NAME(DEBUG)) {
-      static std::map<std::string, double> total;
-      static double total_all = 0;
-      auto elapsed = timer.elapsed();
-      auto current_total = total[message.str()] += elapsed;
-      total_all += elapsed;
-      LOG(DEBUG) << "PERF: " << message << " " << timer << " " << current_total / total_all * 100;
-      timer = {};
-    }
-  };
+  if (!use_plan_cache || !is_first_symbols(p, symbols)) {
+    TRY_RESULT(plan, create_plan(p, symbols));
+    return apply_plan(p, plan, symbols);
+  }
+
+  auto plan = PlanCache::get().get_plan(p.K_padded);
+  if (!plan) {
+    TRY_RESULT(new_plan, create_plan(p, symbols));
+    plan = std::make_shared<const Plan>(std::move(new_plan));
+    PlanCache::get().put_plan(p.K_padded, plan);
+  }
+  return apply_plan(p, *plan, symbols);
+}
+
+void Solver::clear_plan_cache() {
+  PlanCache::get().clear();
+}
+
+Result<Solver::Plan> Solver::create_plan(const Rfc::Parameters &p, Span<SymbolRef> symbols) {
+  PerfLog perf_log;
   // Solve linear system
   // A * C = D
   // C - intermeidate symbols
@@ -98,12 +170,13 @@ Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbol
   // +---------------+------+
   // | HDCP          | I_H  |
   // +---------------+------+
+  //
+  // The plan is everything that depends on A only; apply_plan performs the same operations on D.
   CHECK(p.K_padded <= symbols.size());
   auto encoding_rows = transform(symbols, [&p](auto &symbol) { return p.get_encoding_row(symbol.id); });
 
   // Generate matrix A_upper: sparse part of A, first S + K_padded rows.
   SparseMatrixGF2 A_upper = p.get_A_upper(encoding_rows);
-  auto D = create_D(p, symbols);
   perf_log("Generate sparse matrix");
 
   // Run indactivation decoding.
@@ -113,7 +186,7 @@ Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbol
   uint32 U_size = decoding_result.size;
 
   auto row_permutation = std::move(decoding_result.p_rows);
-  while (row_permutation.size() < D.rows()) {
+  while (row_permutation.size() < p.S + p.H + symbols.size()) {
     row_permutation.push_back(narrow_cast<uint32>(row_permutation.size()));
   }
   auto col_permutation = std::move(decoding_result.p_cols);
@@ -126,17 +199,13 @@ Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbol
   // |HDCP       | I_H  |        |         |
   // +-----------+------+        +---------+
 
-  D = D.apply_row_permutation(row_permutation);
-  perf_log("D: apply permutation");
   A_upper = A_upper.apply_row_permutation(row_permutation).apply_col_permutation(col_permutation);
   perf_log("A_upper: apply permutation");
 
   auto E = A_upper.block_dense(0, U_size, U_size, p.L - U_size);
   perf_log("Calc E");
 
-  MatrixGF256 C(A_upper.cols(), D.cols());
-  C.set_from(D.block_view(0, 0, U_size, D.cols()), 0, 0);
-  // Make U Identity matrix and calculate E and D_upper.
+  // Make U Identity matrix and calculate E.
   for (uint32 i = 0; i < U_size; i++) {
     for (auto row : A_upper.col(i)) {
       if (row == i) {
@@ -146,20 +215,10 @@ Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbol
         break;
       }
       E.row_add(row, i);
-      D.row_add(row, i);  // this is SLOW
     }
   }
   perf_log("Triangular -> Identity");
 
-  auto HDPC_left_multiply = [&](const MatrixGF256 &m) {
-    MatrixGF256 T(p.K_padded + p.S, m.cols());
-    T.set_zero();
-    for (uint32 i = 0; i < m.rows(); i++) {
-      T.row_set(col_permutation[i], m.row(i));
-    }
-    return p.HDPC_multiply(std::move(T));
-  };
-
   SparseMatrixGF2 G_left = A_upper.block_sparse(U_size, 0, A_upper.rows() - U_size, U_size);
   perf_log("G_left");
 
@@ -192,16 +251,69 @@ Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbol
   // small_A_lower += HDPC_left * E
   auto t = E.to_gf256();
   perf_log("t");
-  small_A_lower.add(HDPC_left_multiply(std::move(t)));
+  small_A_lower.add(HDPC_left_multiply(p, col_permutation, t));
   perf_log("small_A_lower += HDPC_left * E");
 
+  // Combine small_A from small_A_lower and small_A_upper
+  MatrixGF256 small_A(small_A_upper.rows() + small_A_lower.rows(), small_A_upper.cols());
+  small_A.set_from(small_A_upper, 0, 0);
+  small_A.set_from(small_A_lower, small_A_upper.rows(), 0);
+
+  // Record the Gaussian elimination by running it on the identity matrix
+  MatrixGF256 small_D(small_A.rows(), small_A.rows());
+  small_D.set_zero();
+  for (uint32 i = 0; i < small_D.rows(); i++) {
+    small_D.set(i, i, Octet(1));
+  }
+  auto small_C_rows = A_upper.cols() - U_size;
+  TRY_RESULT(small_C, GaussianElimination::run(std::move(small_A), std::move(small_D)));
+  MatrixGF256 small_A_solve(small_C_rows, small_C.cols());
+  small_A_solve.set_from(small_C.block_view(0, 0, small_C_rows, small_C.cols()), 0, 0);
+  perf_log("gauss");
+
+  SparseMatrixGF2 A_upper_t = A_upper.transpose();
+  return Plan{U_size,
+              std::move(row_permutation),
+              std::move(col_permutation),
+              std::move(A_upper),
+              std::move(A_upper_t),
+              std::move(G_left),
+              std::move(small_A_solve)};
+}
+
+MatrixGF256 Solver::apply_plan(const Rfc::Parameters &p, const Plan &plan, Span<SymbolRef> symbols) {
+  PerfLog perf_log;
+  auto U_size = plan.U_size;
+  const auto &A_upper = plan.A_upper;
+
+  auto D = create_D(p, symbols);
+  CHECK(D.rows() == plan.row_permutation.size());
+  D = D.apply_row_permutation(plan.row_permutation);
+  perf_log("D: apply permutation");
+
+  MatrixGF256 C(A_upper.cols(), D.cols());
+  C.set_from(D.block_view(0, 0, U_size, D.cols()), 0, 0);
+  // Make U Identity matrix and calculate D_upper.
+  for (uint32 i = 0; i < U_size; i++) {
+    for (auto row : A_upper.col(i)) {
+      if (row == i) {
+        continue;
+      }
+      if (row >= U_size) {
+        break;
+      }
+      D.row_add(row, i);  // this is SLOW
+    }
+  }
+  perf_log("Triangular -> Identity");
+
   MatrixGF256 D_upper(U_size, D.cols());
   D_upper.set_from(D.block_view(0, 0, D_upper.rows(), D_upper.cols()), 0, 0);
 
   // small_D_upper
   MatrixGF256 small_D_upper(A_upper.rows() - U_size, D.cols());
   small_D_upper.set_from(D.block_view(U_size, 0, small_D_upper.rows(), small_D_upper.cols()), 0, 0);
-  small_D_upper.add(G_left * D_upper);
+  small_D_upper.add(plan.G_left * D_upper);
   perf_log("small_D_upper");
 
   // small_D_lower
@@ -209,27 +321,30 @@ Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbol
   small_D_lower.set_from(D.block_view(A_upper.rows(), 0, small_D_lower.rows(), small_D_lower.cols()), 0, 0);
   perf_log("small_D_lower");
 
-  small_D_lower.add(HDPC_left_multiply(D_upper));
+  small_D_lower.add(HDPC_left_multiply(p, plan.col_permutation, D_upper));
   perf_log("small_D_lower += HDPC_left * D_upper");
 
-  // Combine small_A from small_A_lower and small_A_upper
-  MatrixGF256 small_A(small_A_upper.rows() + small_A_lower.rows(), small_A_upper.cols());
-  small_A.set_from(small_A_upper, 0, 0);
-  small_A.set_from(small_A_lower, small_A_upper.rows(), 0);
-
   // Combine small_D from small_D_lower and small_D_upper
   MatrixGF256 small_D(small_D_upper.rows() + small_D_lower.rows(), small_D_upper.cols());
   small_D.set_from(small_D_upper, 0, 0);
   small_D.set_from(small_D_lower, small_D_upper.rows(), 0);
 
-  TRY_RESULT(small_C, GaussianElimination::run(std::move(small_A), std::move(small_D)));
+  // small_C = small_A_solve * small_D, written directly into C
+  const auto &solve = plan.small_A_solve;
+  CHECK(solve.cols() == small_D.rows());
+  for (uint32 i = 0; i < solve.rows(); i++) {
+    auto row = solve.row(i);
+    for (uint32 j = 0; j < solve.cols(); j++) {
+      auto x = Octet(row[j]);
+      if (!x.is_zero()) {
+        C.row_add_mul(U_size + i, small_D.row(j), x);
+      }
+    }
+  }
   perf_log("gauss");
 
-  C.set_from(small_C.block_view(0, 0, C.rows() - U_size, C.cols()), U_size, 0);
-
-  SparseMatrixGF2 A_upper_t = A_upper.transpose();
   for (uint32 row = 0; row < U_size; row++) {
-    for (auto col : A_upper_t.col(row)) {
+    for (auto col : plan.A_upper_t.col(row)) {
       if (col == row) {
         continue;
       }
@@ -238,9 +353,18 @@ Result<MatrixGF256> Solver::run(const Rfc::Parameters &p, Span<SymbolRef> symbol
   }
   perf_log("Calc result");
 
-  auto res = C.apply_row_permutation(inverse_permutation(col_permutation));
+  auto res = C.apply_row_permutation(inverse_permutation(plan.col_permutation));
   perf_log("Apply permutation");
-  return std::move(res);
+  return res;
+}
+
+MatrixGF256 Solver::HDPC_left_multiply(const Rfc::Parameters &p, Span<uint32> col_permutation, const MatrixGF256 &m) {
+  MatrixGF256 T(p.K_padded + p.S, m.cols());
+  T.set_zero();
+  for (uint32 i = 0; i < m.rows(); i++) {
+    T.row_set(col_permutation[i], m.row(i));
+  }
+  return p.HDPC_multiply(std::move(T));
 }
 }  // namespace raptorq
 }  // namespace td
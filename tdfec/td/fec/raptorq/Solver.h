@@ -23,12 +23,37 @@
 #include "td/fec/raptorq/Rfc.h"
 #include "td/fec/common/SymbolRef.h"
 
+#include <memory>
+
 namespace td {
 namespace raptorq {
 
 class Solver {
  public:
-  static Result<MatrixGF256> run(const Rfc::Parameters &p, Span<SymbolRef> symbols);
+  // Everything Solver::run derives from the constraint matrix A. It depends only on the parameters and on the ids
+  // of the symbols, not on their data or size, so it may be computed once and applied to many symbol sets.
+  struct Plan {
+    uint32 U_size;
+    std::vector<uint32> row_permutation;
+    std::vector<uint32> col_permutation;
+    SparseMatrixGF2 A_upper;    // with both permutations applied
+    SparseMatrixGF2 A_upper_t;  // A_upper.transpose()
+    SparseMatrixGF2 G_left;
+    // Gaussian elimination of the inactivated part, applied to the identity matrix:
+    // small_C = small_A_solve * small_D
+    MatrixGF256 small_A_solve;
+  };
+
+  // Encoders always solve for the first K_padded symbols, so their plans are cached by K_padded
+  static Result<MatrixGF256> run(const Rfc::Parameters &p, Span<SymbolRef> symbols, bool use_plan_cache = true);
+
+  static Result<Plan> create_plan(const Rfc::Parameters &p, Span<SymbolRef> symbols);
+  static MatrixGF256 apply_plan(const Rfc::Parameters &p, const Plan &plan, Span<SymbolRef> symbols);
+  static void clear_plan_cache();
+
+ private:
+  static MatrixGF256 HDPC_left_multiply(const Rfc::Parameters &p, Span<uint32> col_permutation,
+                                        const MatrixGF256 &m);
 };
 
 }  // namespace raptorq
@@ -21,6 +21,7 @@
 #include "td/fec/fec.h"
 #include "td/fec/raptorq/Encoder.h"
 #include "td/fec/raptorq/Decoder.h"
+#include "td/fec/raptorq/Solver.h"
 #if USE_LIBRAPTORQ
 #include "LibRaptorQ.h"
 #endif
@@ -90,12 +91,25 @@ TEST(Fec, Simd) {
       }
     };
     run(td::Simd_null());
-#if TD_SSE3
-    run(td::Simd_sse());
+#if TD_SSE3 || TD_SIMD_DISPATCH
+    if (td::Simd_sse::is_supported()) {
+      run(td::Simd_sse());
+    }
+#endif
+#if TD_AVX2 || TD_SIMD_DISPATCH
+    if (td::Simd_avx::is_supported()) {
+      run(td::Simd_avx());
+    }
 #endif
-#if TD_AVX2
-    run(td::Simd_avx());
+#if TD_SIMD_DISPATCH
+    if (td::Simd_avx512::is_supported()) {
+      run(td::Simd_avx512());
+    }
+    if (td::Simd_gfni::is_supported()) {
+      run(td::Simd_gfni());
+    }
 #endif
+    run(td::Simd_dispatch());
     run(td::Simd());
   }
 }
@@ -167,6 +181,88 @@ TEST(Fec, RaptorQRandomSymbols) {
   UNREACHABLE();
 }
 
+TEST(Fec, RaptorQPlanCache) {
+  td::raptorq::Solver::clear_plan_cache();
+  for (size_t symbol_size : {200, 768}) {
+    for (int i = 0; i < 3; i++) {
+      std::string data = td::rand_string('a', 'z', td::narrow_cast<int>(symbol_size * 300));
+      auto p = td::raptorq::Rfc::get_parameters(300).move_as_ok();
+      td::raptorq::SymbolsView symbols(p.K_padded, symbol_size, data);
+      auto cached = td::raptorq::Solver::run(p, symbols.symbols()).move_as_ok();
+      auto uncached = td::raptorq::Solver::run(p, symbols.symbols(), false).move_as_ok();
+      ASSERT_EQ(cached.rows(), uncached.rows());
+      for (size_t row = 0; row < cached.rows(); row++) {
+        ASSERT_EQ(cached.row(row), uncached.row(row));
+      }
+    }
+  }
+}
+
+// Plans are shared by all encoders of the same size, so an encoder must never see the data of the one that built
+// the plan, and the cache must keep working after plans are evicted or dropped
+TEST(Fec, RaptorQPlanCacheInvalidation) {
+  td::raptorq::Solver::clear_plan_cache();
+  constexpr size_t symbol_size = 200;
+  auto check_data = [&](const std::string &data) {
+    auto encoder = td::raptorq::Encoder::create(symbol_size, td::BufferSlice(data)).move_as_ok();
+    encoder->precalc();
+    auto parameters = encoder->get_parameters();
+    auto decoder = td::raptorq::Decoder::create(parameters).move_as_ok();
+    std::string symbol(symbol_size, '\0');
+    // repair symbols only, so that decoding depends on the intermediate symbols computed from the cached plan,
+    // while the decoder itself solves for these ids without the cache
+    for (td::uint32 i = 0; i < parameters.symbols_count + 100; i++) {
+      td::uint32 id = i + (1 << 20);
+      encoder->gen_symbol(id, symbol);
+      decoder->add_symbol({id, td::Slice(symbol)});
+      if (decoder->may_try_decode()) {
+        auto r = decoder->try_decode(false);
+        if (r.is_ok()) {
+          ASSERT_EQ(r.ok().data, data);
+          return;
+        }
+      }
+    }
+    UNREACHABLE();
+  };
+
+  auto first = td::rand_string('a', 'z', td::narrow_cast<int>(symbol_size * 50));
+  check_data(first);
+  // same size, so the plan of the first encoder is reused
+  auto second = td::rand_string('a', 'z', td::narrow_cast<int>(symbol_size * 50));
+  check_data(second);
+  second[symbol_size * 17 + 3] ^= 1;
+  check_data(second);
+
+  // more sizes than the cache holds evict the plan for the first size
+  for (size_t symbols_count = 51; symbols_count < 71; symbols_count++) {
+    check_data(td::rand_string('a', 'z', td::narrow_cast<int>(symbol_size * symbols_count)));
+  }
+  check_data(first);
+
+  td::raptorq::Solver::clear_plan_cache();
+  check_data(second);
+
+  // symbols other than the first K_padded ones must not be solved with the cached plan for K_padded
+  auto p = td::raptorq::Rfc::get_parameters(50).move_as_ok();
+  auto data = td::rand_string('a', 'z', td::narrow_cast<int>(symbol_size * p.K_padded));
+  td::raptorq::SymbolsView first_symbols(p.K_padded, symbol_size, data);
+  td::raptorq::Solver::run(p, first_symbols.symbols()).ensure();
+  std::vector<td::raptorq::SymbolRef> symbols(first_symbols.symbols().begin(), first_symbols.symbols().end());
+  symbols.back().id = p.K_padded;
+  auto r_cached = td::raptorq::Solver::run(p, symbols);
+  auto r_uncached = td::raptorq::Solver::run(p, symbols, false);
+  ASSERT_EQ(r_cached.is_ok(), r_uncached.is_ok());
+  if (r_cached.is_ok()) {
+    auto cached = r_cached.move_as_ok();
+    auto uncached = r_uncached.move_as_ok();
+    ASSERT_EQ(cached.rows(), uncached.rows());
+    for (size_t row = 0; row < cached.rows(); row++) {
+      ASSERT_EQ(cached.row(row), uncached.row(row));
+    }
+  }
+}
+
 template <class Encoder, class Decoder>
 void fec_test(td::Slice data, size_t max_symbol_size) {
   LOG(ERROR) << "!";
@@ -19,7 +19,8 @@
 #include "td/net/TcpListener.h"
 
 namespace td {
-TcpListener::TcpListener(int port, std::unique_ptr<Callback> callback) : port_(port), callback_(std::move(callback)) {
+TcpListener::TcpListener(int port, std::unique_ptr<Callback> callback, string server_address)
+    : port_(port), server_address_(std::move(server_address)), callback_(std::move(callback)) {
 }
 void TcpListener::notify() {
   td::actor::send_closure_later(self_, &TcpListener::on_net);
@@ -31,7 +32,7 @@ void TcpListener::on_net() {
 void TcpListener::start_up() {
   self_ = actor_id(this);
 
-  auto r_socket = td::ServerSocketFd::open(port_);
+  auto r_socket = td::ServerSocketFd::open(port_, server_address_);
   if (r_socket.is_error()) {
     LOG(ERROR) << r_socket.error();
     return stop();
@@ -75,8 +76,9 @@ void TcpListener::loop() {
     return stop();
   }
 }
-TcpInfiniteListener::TcpInfiniteListener(int32 port, std::unique_ptr<TcpListener::Callback> callback)
-    : port_(port), callback_(std::move(callback)) {
+TcpInfiniteListener::TcpInfiniteListener(int32 port, std::unique_ptr<TcpListener::Callback> callback,
+                                         string server_address)
+    : port_(port), server_address_(std::move(server_address)), callback_(std::move(callback)) {
 }
 
 void TcpInfiniteListener::start_up() {
@@ -109,7 +111,7 @@ void TcpInfiniteListener::loop() {
   refcnt_++;
   tcp_listener_ = actor::create_actor<TcpListener>(
       actor::ActorOptions().with_name(PSLICE() << "TcpListener" << tag("port", port_)).with_poll(), port_,
-      std::make_unique<Callback>(actor_shared(this)));
+      std::make_unique<Callback>(actor_shared(this)), server_address_);
 }
 
 void TcpInfiniteListener::accept(SocketFd fd) {
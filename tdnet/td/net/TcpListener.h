@@ -32,10 +32,11 @@ class TcpListener : public td::actor::Actor, private td::ObserverBase {
     virtual void accept(SocketFd fd) = 0;
   };
 
-  TcpListener(int port, std::unique_ptr<Callback> callback);
+  TcpListener(int port, std::unique_ptr<Callback> callback, string server_address = "0.0.0.0");
 
  private:
   int port_;
+  string server_address_;
   std::unique_ptr<Callback> callback_;
   td::ServerSocketFd server_socket_fd_;
   td::actor::ActorId<TcpListener> self_;
@@ -52,10 +53,12 @@ class TcpListener : public td::actor::Actor, private td::ObserverBase {
 
 class TcpInfiniteListener : public actor::Actor {
  public:
-  TcpInfiniteListener(int32 port, std::unique_ptr<TcpListener::Callback> callback);
+  TcpInfiniteListener(int32 port, std::unique_ptr<TcpListener::Callback> callback,
+                      string server_address = "0.0.0.0");
 
  private:
   int32 port_;
+  string server_address_;
   std::unique_ptr<TcpListener::Callback> callback_;
   actor::ActorOwn<TcpListener> tcp_listener_;
   int32 refcnt_{0};
@@ -0,0 +1,359 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "td/utils/AsyncFileLog.h"
+
+#include "td/utils/common.h"
+#include "td/utils/logging.h"
+#include "td/utils/port/FileFd.h"
+#include "td/utils/port/IoSlice.h"
+#include "td/utils/port/path.h"
+#include "td/utils/port/signals.h"
+#include "td/utils/port/Stat.h"
+#include "td/utils/port/StdStreams.h"
+#include "td/utils/port/thread.h"
+#include "td/utils/port/thread_local.h"
+#include "td/utils/Slice.h"
+#include "td/utils/Span.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+namespace td {
+namespace detail {
+class AsyncFileLog : public LogInterface {
+ public:
+  ~AsyncFileLog() override {
+    auto *self = this;
+    current_log.compare_exchange_strong(self, nullptr);
+    close_flag_ = true;
+    wakeup_flusher();
+    flusher_.join();
+    for (auto &ring : rings_) {
+      delete[] ring.data.load(std::memory_order_relaxed);
+    }
+  }
+
+  Status init(string path, size_t buffer_size, int64 rotate_threshold, bool redirect_stderr) {
+    if (path.empty()) {
+      return Status::Error("Log file path can't be empty");
+    }
+    TRY_RESULT_ASSIGN(fd_, FileFd::open(path, FileFd::Create | FileFd::Write | FileFd::Append));
+    if (!Stderr().empty() && redirect_stderr) {
+      fd_.get_native_fd().duplicate(Stderr().get_native_fd()).ignore();
+    }
+    auto r_path = realpath(path, true);
+    if (r_path.is_error()) {
+      path_ = std::move(path);
+    } else {
+      path_ = r_path.move_as_ok();
+    }
+    TRY_RESULT_ASSIGN(size_, fd_.get_size());
+    rotate_threshold_ = rotate_threshold;
+    redirect_stderr_ = redirect_stderr;
+
+    buffer_size_ = 64;
+    while (buffer_size_ < buffer_size) {
+      buffer_size_ *= 2;
+    }
+    // the crash handler must not allocate memory
+    io_slices_.reserve(rings_.size() * 3);
+    dropped_notices_.reserve(rings_.size());
+
+    flusher_ = td::thread([this] { run_flusher(); });
+    current_log = this;
+    set_failure_signal_callback(flush_on_crash);
+    return Status::OK();
+  }
+
+  vector<string> get_file_paths() override {
+    return {path_, PSTRING() << path_ << ".old"};
+  }
+
+  void append(CSlice cslice) override {
+    append(cslice, -1);
+  }
+
+  void append(CSlice cslice, int log_level) override {
+    auto thread_id = get_thread_id();
+    if (thread_id <= 0 || thread_id >= static_cast<int32>(rings_.size())) {
+      while (shared_ring_lock_.test_and_set(std::memory_order_acquire)) {
+        td::this_thread::yield();
+      }
+      push(rings_[0], cslice, log_level);
+      shared_ring_lock_.clear(std::memory_order_release);
+    } else {
+      push(rings_[thread_id], cslice, log_level);
+    }
+    if (log_level == VERBOSITY_NAME(FATAL)) {
+      flush();
+      process_fatal_error(cslice);
+    }
+  }
+
+  void rotate() override {
+    want_rotate_ = true;
+    wakeup_flusher();
+  }
+
+  void flush() {
+    lock_flush();
+    do_flush(true);
+    unlock_flush();
+  }
+
+  static std::atomic<AsyncFileLog *> current_log;
+
+ private:
+  struct Ring {
+    std::atomic<char *> data{nullptr};
+    // head is changed only by the producer, tail is changed only under flush lock
+    std::atomic<uint64> head{0};
+    std::atomic<uint64> tail{0};
+    std::atomic<uint64> dropped{0};
+  };
+  static constexpr int MAX_THREAD_ID = 128;
+  static constexpr int FLUSH_INTERVAL_MS = 10;
+
+  std::array<Ring, MAX_THREAD_ID> rings_;
+  size_t buffer_size_ = 0;
+  std::atomic_flag shared_ring_lock_ = ATOMIC_FLAG_INIT;
+
+  // all fields below are accessed only under flush lock
+  std::atomic_flag flush_lock_ = ATOMIC_FLAG_INIT;
+  FileFd fd_;
+  string path_;
+  int64 size_ = 0;
+  int64 rotate_threshold_ = 0;
+  bool redirect_stderr_ = false;
+  vector<IoSlice> io_slices_;
+  vector<string> dropped_notices_;
+  std::array<uint64, MAX_THREAD_ID> new_tails_;
+
+  std::atomic<bool> want_rotate_{false};
+  std::atomic<bool> close_flag_{false};
+  std::atomic<bool> flush_requested_{false};
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cv_;
+  td::thread flusher_;
+
+  static bool is_important(int log_level) {
+    return log_level <= VERBOSITY_NAME(WARNING);
+  }
+
+  void push(Ring &ring, Slice slice, int log_level) {
+    auto *data = ring.data.load(std::memory_order_relaxed);
+    if (data == nullptr) {
+      data = new char[buffer_size_];
+      ring.data.store(data, std::memory_order_release);
+    }
+    auto size = slice.size();
+    auto head = ring.head.load(std::memory_order_relaxed);
+    if (size > buffer_size_) {
+      if (!is_important(log_level)) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      // the message doesn't fit into the buffer, write it directly after all previous messages of the thread
+      while (ring.tail.load(std::memory_order_acquire) != head) {
+        wakeup_flusher();
+        td::this_thread::yield();
+      }
+      auto io_slice = as_io_slice(slice);
+      lock_flush();
+      write_all(mutable_span_one(io_slice));
+      unlock_flush();
+      return;
+    }
+    uint64 used;
+    while (true) {
+      used = head - ring.tail.load(std::memory_order_acquire);
+      if (buffer_size_ - used >= size) {
+        break;
+      }
+      if (!is_important(log_level)) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      wakeup_flusher();
+      td::this_thread::yield();
+    }
+    auto begin = static_cast<size_t>(head & (buffer_size_ - 1));
+    auto first = std::min(size, buffer_size_ - begin);
+    std::memcpy(data + begin, slice.data(), first);
+    std::memcpy(data, slice.data() + first, size - first);
+    ring.head.store(head + size, std::memory_order_release);
+    if (used < buffer_size_ / 2 && used + size >= buffer_size_ / 2) {
+      wakeup_flusher();
+    }
+  }
+
+  void wakeup_flusher() {
+    if (!flush_requested_.exchange(true, std::memory_order_acq_rel)) {
+      wait_cv_.notify_one();
+    }
+  }
+
+  void run_flusher() {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> guard(wait_mutex_);
+        wait_cv_.wait_for(guard, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+                          [&] { return flush_requested_.load(std::memory_order_acquire); });
+        flush_requested_ = false;
+      }
+      if (close_flag_.load(std::memory_order_acquire)) {
+        break;
+      }
+      flush();
+    }
+    flush();
+  }
+
+  void lock_flush() {
+    while (flush_lock_.test_and_set(std::memory_order_acquire)) {
+      td::this_thread::yield();
+    }
+  }
+
+  void unlock_flush() {
+    flush_lock_.clear(std::memory_order_release);
+  }
+
+  // must be called under flush lock
+  void do_flush(bool can_allocate) {
+    io_slices_.clear();
+    dropped_notices_.clear();
+    for (size_t i = 0; i < rings_.size(); i++) {
+      auto &ring = rings_[i];
+      auto *data = ring.data.load(std::memory_order_acquire);
+      if (data == nullptr) {
+        new_tails_[i] = 0;
+        continue;
+      }
+      auto head = ring.head.load(std::memory_order_acquire);
+      auto tail = ring.tail.load(std::memory_order_relaxed);
+      new_tails_[i] = head;
+      if (head != tail) {
+        auto begin = static_cast<size_t>(tail & (buffer_size_ - 1));
+        auto size = static_cast<size_t>(head - tail);
+        auto first = std::min(size, buffer_size_ - begin);
+        io_slices_.push_back(as_io_slice(Slice(data + begin, first)));
+        if (size > first) {
+          io_slices_.push_back(as_io_slice(Slice(data, size - first)));
+        }
+      }
+      if (can_allocate && ring.dropped.load(std::memory_order_relaxed) != 0) {
+        dropped_notices_.push_back(PSTRING() << "[ " << ring.dropped.exchange(0, std::memory_order_relaxed)
+                                             << " log messages of thread " << i << " were dropped ]\n");
+        io_slices_.push_back(as_io_slice(dropped_notices_.back()));
+      }
+    }
+    write_all(as_mutable_span(io_slices_));
+    for (size_t i = 0; i < rings_.size(); i++) {
+      if (new_tails_[i] != 0) {
+        rings_[i].tail.store(new_tails_[i], std::memory_order_release);
+      }
+    }
+    io_slices_.clear();
+    dropped_notices_.clear();
+
+    // pending rotations are dropped on close: the owner can remove the files right after the log is destroyed
+    if (can_allocate && !close_flag_.load(std::memory_order_relaxed) &&
+        (size_ > rotate_threshold_ || want_rotate_.load(std::memory_order_relaxed))) {
+      do_rotate();
+    }
+  }
+
+  void write_all(MutableSpan<IoSlice> slices) {
+    while (!slices.empty()) {
+      auto r_size = fd_.writev(slices);
+      if (r_size.is_error()) {
+        process_fatal_error(PSLICE() << r_size.error() << " in " << __FILE__ << " at " << __LINE__);
+      }
+      auto written = r_size.ok();
+      size_ += static_cast<int64>(written);
+      while (!slices.empty() && written >= as_slice(slices[0]).size()) {
+        written -= as_slice(slices[0]).size();
+        slices = slices.substr(1);
+      }
+      if (!slices.empty()) {
+        slices[0] = as_io_slice(as_slice(slices[0]).substr(written));
+      }
+    }
+  }
+
+  void do_rotate() {
+    want_rotate_ = false;
+    auto status = rename(path_, PSLICE() << path_ << ".old");
+    // if the file was removed, just create a new one
+    if (status.is_error() && stat(path_).is_ok()) {
+      process_fatal_error(PSLICE() << status.error() << " in " << __FILE__ << " at " << __LINE__);
+    }
+    fd_.close();
+    auto r_fd = FileFd::open(path_, FileFd::Create | FileFd::Truncate | FileFd::Write);
+    if (r_fd.is_error()) {
+      process_fatal_error(PSLICE() << r_fd.error() << " in " << __FILE__ << " at " << __LINE__);
+    }
+    fd_ = r_fd.move_as_ok();
+    if (!Stderr().empty() && redirect_stderr_) {
+      fd_.get_native_fd().duplicate(Stderr().get_native_fd()).ignore();
+    }
+    size_ = 0;
+  }
+
+  static void flush_on_crash() {
+    auto *log = current_log.load(std::memory_order_acquire);
+    if (log == nullptr) {
+      return;
+    }
+    // the crashed thread can hold the lock itself, so wait only for a while
+    bool locked = false;
+    for (int i = 0; i < 1000 && !locked; i++) {
+      locked = !log->flush_lock_.test_and_set(std::memory_order_acquire);
+      if (!locked) {
+        td::this_thread::yield();
+      }
+    }
+    log->do_flush(false);
+    if (locked) {
+      log->unlock_flush();
+    }
+  }
+};
+
+std::atomic<AsyncFileLog *> AsyncFileLog::current_log{nullptr};
+}  // namespace detail
+
+Result<td::unique_ptr<LogInterface>> AsyncFileLog::create(string path, size_t buffer_size, int64 rotate_threshold,
+                                                          bool redirect_stderr) {
+  auto res = td::make_unique<detail::AsyncFileLog>();
+  TRY_STATUS(res->init(std::move(path), buffer_size, rotate_threshold, redirect_stderr));
+  return std::move(res);
+}
+
+void AsyncFileLog::flush_all() {
+  auto *log = detail::AsyncFileLog::current_log.load(std::memory_order_acquire);
+  if (log != nullptr) {
+    log->flush();
+  }
+}
+
+}  // namespace td
@@ -0,0 +1,44 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "td/utils/common.h"
+#include "td/utils/logging.h"
+#include "td/utils/Status.h"
+
+namespace td {
+
+// Asynchronous file log. Every thread appends messages to its own lock-free ring buffer, a background thread
+// writes all buffers to the file with writev. Messages of one thread are written in order.
+// If a buffer is full, messages less important than WARNING are dropped (the number of dropped messages is written
+// to the log), more important messages wait for the buffer to be flushed. FATAL messages are flushed synchronously.
+// Threads not created by td::thread share one buffer protected by a spinlock.
+class AsyncFileLog {
+  static constexpr int64 DEFAULT_ROTATE_THRESHOLD = 10 * (1 << 20);
+  static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+ public:
+  // buffer_size is the size of the buffer of each thread, it is rounded up to a power of two
+  static Result<td::unique_ptr<LogInterface>> create(string path, size_t buffer_size = DEFAULT_BUFFER_SIZE,
+                                                     int64 rotate_threshold = DEFAULT_ROTATE_THRESHOLD,
+                                                     bool redirect_stderr = true);
+
+  // Synchronously writes all buffered messages of the current asynchronous log, if any
+  static void flush_all();
+};
+
+}  // namespace td
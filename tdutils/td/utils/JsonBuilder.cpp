@@ -18,6 +18,7 @@
 */
 #include "td/utils/JsonBuilder.h"
 
+#include "td/utils/base64.h"
 #include "td/utils/misc.h"
 #include "td/utils/ScopeGuard.h"
 
@@ -69,6 +70,21 @@ StringBuilder &operator<<(StringBuilder &sb, const JsonRawString &val) {
   return sb;
 }
 
+StringBuilder &operator<<(StringBuilder &sb, const JsonBase64String &val) {
+  sb << '"';
+  constexpr size_t CHUNK_SIZE = 3 * 256;
+  char buf[base64_encoded_size(CHUNK_SIZE)];
+  auto bytes = val.bytes_;
+  while (!bytes.empty()) {
+    auto chunk = bytes.substr(0, CHUNK_SIZE);
+    bytes.remove_prefix(chunk.size());
+    auto encoded = MutableSlice(buf, base64_encoded_size(chunk.size()));
+    base64_encode(chunk, encoded);
+    sb << encoded;
+  }
+  return sb << '"';
+}
+
 StringBuilder &operator<<(StringBuilder &sb, const JsonString &val) {
   sb << '"';
   SCOPE_EXIT {
@@ -576,6 +592,187 @@ Status do_json_skip(Parser &parser, int32 max_depth) {
   return Status::Error("Can't parse");
 }
 
+Result<JsonValue::Type> JsonReader::peek_type() {
+  parser_.skip_whitespaces();
+  switch (parser_.peek_char()) {
+    case 'f':
+    case 't':
+      return JsonValue::Type::Boolean;
+    case 'n':
+      return JsonValue::Type::Null;
+    case '"':
+      return JsonValue::Type::String;
+    case '[':
+      return JsonValue::Type::Array;
+    case '{':
+      return JsonValue::Type::Object;
+    case '-':
+    case '+':
+    case '.':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+      return JsonValue::Type::Number;
+    case 0:
+      return Status::Error("Unexpected string end");
+    default: {
+      char next = parser_.peek_char();
+      if (0 < next && next < 127) {
+        return Status::Error(PSLICE() << "Unexpected symbol '" << next << "'");
+      } else {
+        return Status::Error("Unexpected symbol");
+      }
+    }
+  }
+}
+
+bool JsonReader::try_read_null() {
+  parser_.skip_whitespaces();
+  return parser_.skip_start_with("null");
+}
+
+Result<bool> JsonReader::read_boolean() {
+  parser_.skip_whitespaces();
+  if (parser_.skip_start_with("true")) {
+    return true;
+  }
+  if (parser_.skip_start_with("false")) {
+    return false;
+  }
+  return Status::Error("Expected bool");
+}
+
+Result<Slice> JsonReader::read_number() {
+  parser_.skip_whitespaces();
+  auto num = parser_.read_while(
+      [](char c) { return c == '-' || ('0' <= c && c <= '9') || c == 'e' || c == 'E' || c == '+' || c == '.'; });
+  if (num.empty()) {
+    return Status::Error("Expected number");
+  }
+  return num;
+}
+
+Result<MutableSlice> JsonReader::read_string() {
+  parser_.skip_whitespaces();
+  return json_string_decode(parser_);
+}
+
+Status JsonReader::enter(char c) {
+  parser_.skip_whitespaces();
+  if (!parser_.try_skip(c)) {
+    return Status::Error(PSLICE() << "'" << c << "' expected");
+  }
+  if (++depth_ > max_depth_) {
+    return Status::Error("Too big object depth");
+  }
+  is_first_ = true;
+  return Status::OK();
+}
+
+Result<bool> JsonReader::next(char end_c) {
+  parser_.skip_whitespaces();
+  if (parser_.try_skip(end_c)) {
+    depth_--;
+    is_first_ = false;
+    return false;
+  }
+  if (is_first_) {
+    is_first_ = false;
+  } else if (!parser_.try_skip(',')) {
+    if (parser_.empty()) {
+      return Status::Error("Unexpected string end");
+    }
+    return Status::Error(PSLICE() << "Unexpected symbol while parsing JSON " << (end_c == '}' ? "Object" : "Array"));
+  }
+  return true;
+}
+
+Status JsonReader::enter_object() {
+  return enter('{');
+}
+
+Result<bool> JsonReader::next_field(MutableSlice &key) {
+  TRY_RESULT(has_field, next('}'));
+  if (!has_field) {
+    return false;
+  }
+  parser_.skip_whitespaces();
+  TRY_RESULT_ASSIGN(key, json_string_decode(parser_));
+  parser_.skip_whitespaces();
+  if (!parser_.try_skip(':')) {
+    return Status::Error("':' expected");
+  }
+  return true;
+}
+
+Status JsonReader::enter_array() {
+  return enter('[');
+}
+
+Result<bool> JsonReader::next_element() {
+  return next(']');
+}
+
+Result<Slice> JsonReader::skip_value() {
+  parser_.skip_whitespaces();
+  auto *begin = parser_.data().begin();
+  TRY_STATUS(do_json_skip(parser_, max_depth_ - depth_));
+  return Slice(begin, parser_.data().begin());
+}
+
+Result<Slice> JsonReader::find_object_field(Slice name) {
+  parser_.skip_whitespaces();
+  Parser parser(parser_.data());
+  if (!parser.try_skip('{')) {
+    return Status::Error("'{' expected");
+  }
+  parser.skip_whitespaces();
+  if (parser.try_skip('}')) {
+    return Slice();
+  }
+  while (true) {
+    auto *key_begin = parser.data().begin();
+    TRY_STATUS(json_string_skip(parser));
+    Slice key(key_begin + 1, parser.data().begin() - 1);
+    parser.skip_whitespaces();
+    if (!parser.try_skip(':')) {
+      return Status::Error("':' expected");
+    }
+    parser.skip_whitespaces();
+    auto *value_begin = parser.data().begin();
+    TRY_STATUS(do_json_skip(parser, max_depth_ - depth_ - 1));
+    if (key == name) {
+      return Slice(value_begin, parser.data().begin());
+    }
+    parser.skip_whitespaces();
+    if (parser.try_skip('}')) {
+      return Slice();
+    }
+    if (!parser.try_skip(',')) {
+      if (parser.empty()) {
+        return Status::Error("Unexpected string end");
+      }
+      return Status::Error("Unexpected symbol while parsing JSON Object");
+    }
+    parser.skip_whitespaces();
+  }
+}
+
+Status JsonReader::finish() {
+  parser_.skip_whitespaces();
+  if (!parser_.empty()) {
+    return Status::Error("Expected string end");
+  }
+  return Status::OK();
+}
+
 Slice JsonValue::get_type_name(Type type) {
   switch (type) {
     case Type::Null:
@@ -166,6 +166,17 @@ class JsonRawString {
   Slice value_;
 };
 
+// base64-encoded bytes, encoded directly into the output buffer
+class JsonBase64String {
+ public:
+  explicit JsonBase64String(Slice bytes) : bytes_(bytes) {
+  }
+  friend StringBuilder &operator<<(StringBuilder &sb, const JsonBase64String &val);
+
+ private:
+  Slice bytes_;
+};
+
 class JsonString {
  public:
   explicit JsonString(Slice str) : str_(str) {
@@ -301,6 +312,10 @@ class JsonScope {
     *sb_ << x;
     return *this;
   }
+  JsonScope &operator<<(const JsonBase64String &x) {
+    *sb_ << x;
+    return *this;
+  }
   JsonScope &operator<<(bool x) = delete;
   JsonScope &operator<<(int32 x) {
     return *this << JsonInt(x);
@@ -771,6 +786,48 @@ inline Result<JsonValue> json_decode(MutableSlice json) {
   return result;
 }
 
+// Pull parser, which reads values one by one without building JsonValue trees.
+// Strings are decoded in place, so returned slices point into the parsed buffer.
+class JsonReader {
+ public:
+  static constexpr int32 DEFAULT_MAX_DEPTH = 100;
+
+  explicit JsonReader(MutableSlice json, int32 max_depth = DEFAULT_MAX_DEPTH) : parser_(json), max_depth_(max_depth) {
+  }
+
+  Result<JsonValue::Type> peek_type() TD_WARN_UNUSED_RESULT;
+  // skips the next value and returns true if it is null
+  bool try_read_null();
+  Result<bool> read_boolean() TD_WARN_UNUSED_RESULT;
+  Result<Slice> read_number() TD_WARN_UNUSED_RESULT;
+  Result<MutableSlice> read_string() TD_WARN_UNUSED_RESULT;
+
+  Status enter_object() TD_WARN_UNUSED_RESULT;
+  // reads the key of the next field of the current object, returns false at the end of the object
+  Result<bool> next_field(MutableSlice &key) TD_WARN_UNUSED_RESULT;
+  Status enter_array() TD_WARN_UNUSED_RESULT;
+  // returns false at the end of the current array
+  Result<bool> next_element() TD_WARN_UNUSED_RESULT;
+
+  // skips the next value without decoding it and returns its source text
+  Result<Slice> skip_value() TD_WARN_UNUSED_RESULT;
+  // returns source text of the value of the field of the next object with a raw key equal to name,
+  // or an empty slice if there is no such field; the reader isn't advanced
+  Result<Slice> find_object_field(Slice name) TD_WARN_UNUSED_RESULT;
+
+  // checks that nothing except whitespaces is left
+  Status finish() TD_WARN_UNUSED_RESULT;
+
+ private:
+  Parser parser_;
+  int32 max_depth_;
+  int32 depth_ = 0;
+  bool is_first_ = false;
+
+  Status enter(char c);
+  Result<bool> next(char end_c);
+};
+
 template <class StrT, class ValT>
 StrT json_encode(const ValT &val, bool pretty = false) {
   auto buf_len = 1 << 18;
@@ -0,0 +1,122 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "td/utils/bits.h"
+#include "td/utils/common.h"
+
+#include <array>
+#include <atomic>
+#include <limits>
+
+namespace td {
+
+// HDR-style histogram of non-negative integers. Buckets grow by powers of two and each of them is split
+// into 2^SubBucketBits equal parts, so bucket bounds have relative error below 2^-SubBucketBits.
+// Values with more than ValueBits bits are counted in the last bucket.
+// add() must be called by a single thread at a time; snapshot() may be called concurrently.
+template <int SubBucketBits = 2, int ValueBits = 48>
+class LogHistogram {
+  static_assert(0 < SubBucketBits && SubBucketBits < ValueBits && ValueBits <= 64, "");
+
+ public:
+  static constexpr size_t BUCKET_COUNT = static_cast<size_t>(ValueBits - SubBucketBits + 1) << SubBucketBits;
+
+  static size_t bucket(uint64 value) {
+    if (value < (uint64{1} << SubBucketBits)) {
+      return static_cast<size_t>(value);
+    }
+    auto msb = 63 - count_leading_zeroes64(value);
+    if (msb >= ValueBits) {
+      return BUCKET_COUNT - 1;
+    }
+    auto sub_bucket = (value >> (msb - SubBucketBits)) & ((uint64{1} << SubBucketBits) - 1);
+    return (static_cast<size_t>(msb - SubBucketBits + 1) << SubBucketBits) + static_cast<size_t>(sub_bucket);
+  }
+  static uint64 bucket_min(size_t i) {
+    if (i < (size_t{1} << SubBucketBits)) {
+      return i;
+    }
+    auto shift = static_cast<int>(i >> SubBucketBits) - 1;
+    return ((uint64{1} << SubBucketBits) + (i & ((size_t{1} << SubBucketBits) - 1))) << shift;
+  }
+  static uint64 bucket_max(size_t i) {
+    if (i + 1 == BUCKET_COUNT) {
+      return std::numeric_limits<uint64>::max();
+    }
+    return bucket_min(i + 1) - 1;
+  }
+
+  struct Snapshot {
+    std::array<uint64, BUCKET_COUNT> counts{};
+    uint64 count{0};
+    uint64 sum{0};
+
+    Snapshot &operator+=(const Snapshot &other) {
+      for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] += other.counts[i];
+      }
+      count += other.count;
+      sum += other.sum;
+      return *this;
+    }
+
+    // upper bound of the q-quantile
+    uint64 quantile(double q) const {
+      auto rank = static_cast<uint64>(q * static_cast<double>(count));
+      uint64 seen = 0;
+      for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen > rank) {
+          return bucket_max(i);
+        }
+      }
+      return 0;
+    }
+
+    // number of values not exceeding value; exact when value is bucket_max of some bucket
+    uint64 count_not_greater(uint64 value) const {
+      uint64 res = 0;
+      for (size_t i = 0; i < BUCKET_COUNT && bucket_max(i) <= value; i++) {
+        res += counts[i];
+      }
+      return res;
+    }
+  };
+
+  void add(uint64 value) {
+    auto &counter = counts_[bucket(value)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  Snapshot snapshot() const {
+    Snapshot res;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+      res.counts[i] = counts_[i].load(std::memory_order_relaxed);
+      res.count += res.counts[i];
+    }
+    res.sum = sum_.load(std::memory_order_relaxed);
+    return res;
+  }
+
+ private:
+  std::array<std::atomic<uint64>, BUCKET_COUNT> counts_{};
+  std::atomic<uint64> sum_{0};
+};
+
+}  // namespace td
@@ -0,0 +1,128 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "td/utils/SmallObjectAllocator.h"
+
+#include "td/utils/port/thread_local.h"
+
+#include <array>
+
+namespace td {
+
+namespace {
+
+constexpr size_t MIN_BLOCK_SIZE = 32;
+constexpr size_t SIZE_CLASS_COUNT = 4;  // 32, 64, 128, 256
+static_assert(MIN_BLOCK_SIZE << (SIZE_CLASS_COUNT - 1) == SmallObjectAllocator::MAX_SIZE, "");
+
+size_t get_size_class(size_t size) {
+  size_t size_class = 0;
+  while ((MIN_BLOCK_SIZE << size_class) < size) {
+    size_class++;
+  }
+  return size_class;
+}
+
+class FreeLists {
+ public:
+  FreeLists() = default;
+  FreeLists(const FreeLists &) = delete;
+  FreeLists &operator=(const FreeLists &) = delete;
+  ~FreeLists();
+
+  void *pop(size_t size_class) {
+    auto &list = lists_[size_class];
+    auto *block = list.head;
+    if (block != nullptr) {
+      list.head = block->next;
+      list.size--;
+    }
+    return block;
+  }
+  bool push(size_t size_class, void *ptr) {
+    auto &list = lists_[size_class];
+    if (list.size >= SmallObjectAllocator::MAX_FREE_BLOCKS) {
+      return false;
+    }
+    auto *block = static_cast<Block *>(ptr);
+    block->next = list.head;
+    list.head = block;
+    list.size++;
+    return true;
+  }
+
+ private:
+  struct Block {
+    Block *next;
+  };
+  struct List {
+    Block *head{nullptr};
+    size_t size{0};
+  };
+  std::array<List, SIZE_CLASS_COUNT> lists_;
+};
+
+TD_THREAD_LOCAL FreeLists *free_lists;  // static zero-initialized
+// set when free lists of the thread are destroyed; blocks freed after that (e.g. by other thread local destructors)
+// are returned directly to the system
+TD_THREAD_LOCAL bool free_lists_destroyed;
+
+FreeLists::~FreeLists() {
+  free_lists_destroyed = true;
+  for (auto &list : lists_) {
+    while (list.head != nullptr) {
+      auto *next = list.head->next;
+      ::operator delete(list.head);
+      list.head = next;
+    }
+  }
+}
+
+FreeLists *get_free_lists() {
+  if (free_lists == nullptr && !free_lists_destroyed) {
+    init_thread_local<FreeLists>(free_lists);
+  }
+  return free_lists;
+}
+
+}  // namespace
+
+void *SmallObjectAllocator::allocate(size_t size) {
+  if (size > MAX_SIZE) {
+    return ::operator new(size);
+  }
+  auto size_class = get_size_class(size);
+  auto *lists = get_free_lists();
+  if (lists != nullptr) {
+    auto *ptr = lists->pop(size_class);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+  return ::operator new(MIN_BLOCK_SIZE << size_class);
+}
+
+void SmallObjectAllocator::deallocate(void *ptr, size_t size) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (size <= MAX_SIZE && free_lists != nullptr && free_lists->push(get_size_class(size), ptr)) {
+    return;
+  }
+  ::operator delete(ptr);
+}
+
+}  // namespace td
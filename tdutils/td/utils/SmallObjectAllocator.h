@@ -0,0 +1,66 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "td/utils/common.h"
+
+#include <cstddef>
+#include <new>
+
+namespace td {
+
+// Allocator for small short-lived objects (actor messages, promises).
+// Blocks of up to MAX_SIZE bytes are rounded up to one of a few size classes and reused through thread-local free
+// lists. A block may be freed by any thread; it is put into the free list of the freeing thread. The lists are
+// bounded, so blocks which migrate from producer threads to consumer threads are returned to the system once
+// the lists of the consumers are full. Bigger blocks are allocated with ::operator new.
+class SmallObjectAllocator {
+ public:
+  static constexpr size_t MAX_SIZE = 256;
+  static constexpr size_t MAX_FREE_BLOCKS = 1024;  // per size class per thread
+
+  static void *allocate(size_t size);
+  static void deallocate(void *ptr, size_t size) noexcept;
+};
+
+// Base class which makes new/delete of derived classes use SmallObjectAllocator.
+// Objects must be deleted either through their own type or through a base with a virtual destructor,
+// so that operator delete receives the size of the whole object.
+class SmallObject {
+ public:
+  static void *operator new(std::size_t size) {
+    return SmallObjectAllocator::allocate(size);
+  }
+  static void operator delete(void *ptr, std::size_t size) noexcept {
+    SmallObjectAllocator::deallocate(ptr, size);
+  }
+
+  // over-aligned objects and placement new are not pooled
+  static void *operator new(std::size_t size, std::align_val_t align) {
+    return ::operator new(size, align);
+  }
+  static void operator delete(void *ptr, std::size_t size, std::align_val_t align) noexcept {
+    ::operator delete(ptr, size, align);
+  }
+  static void *operator new(std::size_t size, void *ptr) noexcept {
+    return ptr;
+  }
+  static void operator delete(void *ptr, void *place) noexcept {
+  }
+};
+
+}  // namespace td
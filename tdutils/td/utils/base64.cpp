@@ -50,32 +50,38 @@ static const unsigned char *get_character_table() {
 }
 
 template <bool is_url>
-string base64_encode_impl(Slice input) {
+char *base64_encode_impl(Slice input, char *ptr) {
   auto characters = get_characters<is_url>();
-  string base64;
-  base64.reserve((input.size() + 2) / 3 * 4);
   for (size_t i = 0; i < input.size();) {
     size_t left = min(input.size() - i, static_cast<size_t>(3));
     int c = input.ubegin()[i++] << 16;
-    base64 += characters[c >> 18];
+    *ptr++ = characters[c >> 18];
     if (left != 1) {
       c |= input.ubegin()[i++] << 8;
     }
-    base64 += characters[(c >> 12) & 63];
+    *ptr++ = characters[(c >> 12) & 63];
     if (left == 3) {
       c |= input.ubegin()[i++];
     }
     if (left != 1) {
-      base64 += characters[(c >> 6) & 63];
+      *ptr++ = characters[(c >> 6) & 63];
     } else if (!is_url) {
-      base64 += '=';
+      *ptr++ = '=';
     }
     if (left == 3) {
-      base64 += characters[c & 63];
+      *ptr++ = characters[c & 63];
     } else if (!is_url) {
-      base64 += '=';
+      *ptr++ = '=';
     }
   }
+  return ptr;
+}
+
+template <bool is_url>
+string base64_encode_impl(Slice input) {
+  string base64(base64_encoded_size(input.size()), '\0');
+  auto *end = base64_encode_impl<is_url>(input, &base64[0]);
+  base64.resize(end - base64.data());
   return base64;
 }
 
@@ -83,6 +89,11 @@ string base64_encode(Slice input) {
   return base64_encode_impl<false>(input);
 }
 
+void base64_encode(Slice input, MutableSlice output) {
+  CHECK(output.size() == base64_encoded_size(input.size()));
+  base64_encode_impl<false>(input, output.begin());
+}
+
 string base64url_encode(Slice input) {
   return base64_encode_impl<true>(input);
 }
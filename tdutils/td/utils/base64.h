@@ -27,6 +27,11 @@
 namespace td {
 
 string base64_encode(Slice input);
+// writes exactly base64_encoded_size(input.size()) characters to output
+void base64_encode(Slice input, MutableSlice output);
+constexpr size_t base64_encoded_size(size_t size) {
+  return (size + 2) / 3 * 4;
+}
 Result<string> base64_decode(Slice base64);
 Result<SecureString> base64_decode_secure(Slice base64);
 
@@ -0,0 +1,256 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "td/utils/port/CpuTopology.h"
+
+#include "td/utils/port/config.h"
+
+#include "td/utils/misc.h"
+#include "td/utils/port/thread.h"
+
+#if TD_LINUX
+#include "td/utils/port/FileFd.h"
+#include "td/utils/ScopeGuard.h"
+
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace td {
+
+namespace {
+bool cpu_less(const CpuTopology::Cpu &a, const CpuTopology::Cpu &b) {
+  return std::tie(a.node, a.cache, a.core, a.id) < std::tie(b.node, b.cache, b.core, b.id);
+}
+
+#if TD_LINUX
+Result<string> read_sys_file(CSlice path) {
+  TRY_RESULT(fd, FileFd::open(path, FileFd::Read));
+  SCOPE_EXIT {
+    fd.close();
+  };
+  constexpr size_t MAX_SIZE = 4096;
+  char mem[MAX_SIZE];
+  TRY_RESULT(size, fd.read(MutableSlice(mem, MAX_SIZE)));
+  if (size == MAX_SIZE) {
+    return Status::Error(PSLICE() << "Too long " << path);
+  }
+  return trim(string(mem, size));
+}
+
+Result<int32> read_sys_int(CSlice path) {
+  TRY_RESULT(str, read_sys_file(path));
+  return to_integer_safe<int32>(str);
+}
+
+int32 read_sys_int(CSlice path, int32 default_value) {
+  auto r_value = read_sys_int(path);
+  return r_value.is_ok() ? r_value.ok() : default_value;
+}
+
+vector<CpuTopology::Cpu> discover_cpus() {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    return {};
+  }
+
+  std::map<int32, int32> cpu_node;
+  auto r_nodes = read_sys_file("/sys/devices/system/node/online");
+  if (r_nodes.is_ok()) {
+    auto r_node_ids = parse_cpu_list(r_nodes.ok());
+    if (r_node_ids.is_ok()) {
+      for (auto node : r_node_ids.ok()) {
+        auto r_node_cpus = read_sys_file(PSLICE() << "/sys/devices/system/node/node" << node << "/cpulist");
+        if (r_node_cpus.is_error()) {
+          continue;
+        }
+        auto r_node_cpu_ids = parse_cpu_list(r_node_cpus.ok());
+        if (r_node_cpu_ids.is_error()) {
+          continue;
+        }
+        for (auto cpu : r_node_cpu_ids.ok()) {
+          cpu_node[cpu] = node;
+        }
+      }
+    }
+  }
+
+  std::map<std::pair<int32, int32>, int32> core_index;
+  std::map<int32, int32> cache_index;
+  vector<CpuTopology::Cpu> cpus;
+  for (int32 id = 0; id < CPU_SETSIZE; id++) {
+    if (!CPU_ISSET(id, &cpu_set)) {
+      continue;
+    }
+    string prefix = PSTRING() << "/sys/devices/system/cpu/cpu" << id;
+    CpuTopology::Cpu cpu;
+    cpu.id = id;
+    auto it = cpu_node.find(id);
+    cpu.node = it == cpu_node.end() ? 0 : it->second;
+
+    auto package = read_sys_int(prefix + "/topology/physical_package_id", 0);
+    auto core_id = read_sys_int(prefix + "/topology/core_id", id);
+    cpu.core = core_index.emplace(std::make_pair(package, core_id), narrow_cast<int32>(core_index.size()))
+                   .first->second;
+
+    // the cache of the highest level is shared by a core complex; its first cpu identifies it
+    int32 cache_key = -1 - package;
+    int32 max_level = 0;
+    for (int index = 0;; index++) {
+      string cache_prefix = PSTRING() << prefix << "/cache/index" << index;
+      auto r_level = read_sys_int(cache_prefix + "/level");
+      if (r_level.is_error()) {
+        break;
+      }
+      if (r_level.ok() <= max_level) {
+        continue;
+      }
+      auto r_shared = read_sys_file(cache_prefix + "/shared_cpu_list");
+      if (r_shared.is_error()) {
+        continue;
+      }
+      auto r_shared_ids = parse_cpu_list(r_shared.ok());
+      if (r_shared_ids.is_error() || r_shared_ids.ok().empty()) {
+        continue;
+      }
+      max_level = r_level.ok();
+      cache_key = r_shared_ids.ok()[0];
+    }
+    cpu.cache = cache_index.emplace(cache_key, narrow_cast<int32>(cache_index.size())).first->second;
+    cpus.push_back(cpu);
+  }
+  return cpus;
+}
+#endif
+}  // namespace
+
+CpuTopology::CpuTopology(vector<Cpu> cpus) : cpus_(std::move(cpus)) {
+  std::sort(cpus_.begin(), cpus_.end(), cpu_less);
+}
+
+CpuTopology CpuTopology::get() {
+  vector<Cpu> cpus;
+#if TD_LINUX
+  cpus = discover_cpus();
+#endif
+  if (cpus.empty()) {
+    auto n = narrow_cast<int32>(thread::hardware_concurrency());
+    for (int32 id = 0; id < n; id++) {
+      Cpu cpu;
+      cpu.id = id;
+      cpu.core = id;
+      cpus.push_back(cpu);
+    }
+  }
+  return CpuTopology(std::move(cpus));
+}
+
+vector<int32> CpuTopology::cpu_ids() const {
+  return transform(cpus_, [](const Cpu &cpu) { return cpu.id; });
+}
+
+vector<int32> CpuTopology::nodes() const {
+  std::set<int32> nodes;
+  for (auto &cpu : cpus_) {
+    nodes.insert(cpu.node);
+  }
+  return vector<int32>(nodes.begin(), nodes.end());
+}
+
+CpuTopology CpuTopology::restrict_to_nodes(const vector<int32> &nodes) const {
+  vector<Cpu> cpus;
+  for (auto &cpu : cpus_) {
+    if (td::contains(nodes, cpu.node)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return CpuTopology(std::move(cpus));
+}
+
+CpuTopology CpuTopology::restrict_to_cpus(const vector<int32> &cpu_ids) const {
+  vector<Cpu> cpus;
+  for (auto &cpu : cpus_) {
+    if (td::contains(cpu_ids, cpu.id)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return CpuTopology(std::move(cpus));
+}
+
+vector<CpuTopology::Cpu> CpuTopology::select(size_t n) const {
+  vector<Cpu> result;
+  if (cpus_.empty()) {
+    return result;
+  }
+  vector<Cpu> order;
+  vector<Cpu> siblings;
+  std::set<int32> used_cores;
+  for (auto &cpu : cpus_) {
+    if (used_cores.insert(cpu.core).second) {
+      order.push_back(cpu);
+    } else {
+      siblings.push_back(cpu);
+    }
+  }
+  append(order, siblings);
+  for (size_t i = 0; i < n; i++) {
+    result.push_back(order[i % order.size()]);
+  }
+  std::stable_sort(result.begin(), result.end(), cpu_less);
+  return result;
+}
+
+StringBuilder &operator<<(StringBuilder &sb, const CpuTopology &topology) {
+  std::set<int32> cores;
+  std::set<int32> caches;
+  for (auto &cpu : topology.cpus()) {
+    cores.insert(cpu.core);
+    caches.insert(cpu.cache);
+  }
+  return sb << "[cpus:" << topology.cpus().size() << " cores:" << cores.size() << " caches:" << caches.size()
+            << " nodes:" << topology.nodes().size() << "]";
+}
+
+Result<vector<int32>> parse_cpu_list(Slice list) {
+  vector<int32> result;
+  for (auto range : full_split(trim(list), ',')) {
+    range = trim(range);
+    if (range.empty()) {
+      continue;
+    }
+    auto bounds = split(range, '-');
+    TRY_RESULT(from, to_integer_safe<int32>(bounds.first));
+    auto to = from;
+    if (!bounds.second.empty()) {
+      TRY_RESULT_ASSIGN(to, to_integer_safe<int32>(bounds.second));
+    }
+    if (from < 0 || to < from || to - from >= 65536) {
+      return Status::Error(PSLICE() << "Invalid range \"" << range << '"');
+    }
+    for (auto id = from; id <= to; id++) {
+      result.push_back(id);
+    }
+  }
+  return std::move(result);
+}
+
+}  // namespace td
@@ -0,0 +1,67 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "td/utils/common.h"
+#include "td/utils/Slice.h"
+#include "td/utils/Status.h"
+#include "td/utils/StringBuilder.h"
+
+namespace td {
+
+// Placement of the cpus available to the process.
+// Discovered from sysfs on Linux; elsewhere all cpus are assumed to be on one NUMA node without shared caches.
+class CpuTopology {
+ public:
+  struct Cpu {
+    int32 id{0};
+    int32 node{0};   // NUMA node
+    int32 core{0};   // physical core, shared by SMT siblings
+    int32 cache{0};  // last level cache, i.e. core complex
+  };
+
+  CpuTopology() = default;
+  explicit CpuTopology(vector<Cpu> cpus);
+
+  static CpuTopology get();
+
+  const vector<Cpu> &cpus() const {
+    return cpus_;
+  }
+  bool empty() const {
+    return cpus_.empty();
+  }
+  vector<int32> cpu_ids() const;
+  vector<int32> nodes() const;
+
+  CpuTopology restrict_to_nodes(const vector<int32> &nodes) const;
+  CpuTopology restrict_to_cpus(const vector<int32> &cpu_ids) const;
+
+  // Cpus to bind n threads to: one per physical core before SMT siblings, wrapping around if n exceeds
+  // the number of cpus. The result is ordered so that neighbours share a cache, then a NUMA node.
+  vector<Cpu> select(size_t n) const;
+
+ private:
+  vector<Cpu> cpus_;  // ordered by node, cache, core, id
+};
+
+StringBuilder &operator<<(StringBuilder &sb, const CpuTopology &topology);
+
+// Parses lists like "0-3,8,10-11"
+Result<vector<int32>> parse_cpu_list(Slice list);
+
+}  // namespace td
@@ -95,6 +95,26 @@ void ThreadPthread::detach() {
   }
 }
 
+Status ThreadPthread::set_affinity(id thread_id, const vector<int32> &cpus) {
+#if TD_LINUX
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return Status::Error(PSLICE() << "Invalid cpu " << cpu);
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+  auto err = pthread_setaffinity_np(thread_id, sizeof(cpu_set), &cpu_set);
+  if (err != 0) {
+    return Status::PosixError(err, "pthread_setaffinity_np failed");
+  }
+  return Status::OK();
+#else
+  return Status::Error("Thread affinity is not supported");
+#endif
+}
+
 int ThreadPthread::do_pthread_create(pthread_t *thread, const pthread_attr_t *attr, void *(*start_routine)(void *),
                                      void *arg) {
   return pthread_create(thread, attr, start_routine, arg);
@@ -29,6 +29,7 @@
 #include "td/utils/port/detail/ThreadIdGuard.h"
 #include "td/utils/port/thread_local.h"
 #include "td/utils/Slice.h"
+#include "td/utils/Status.h"
 
 #include <tuple>
 #include <type_traits>
@@ -75,6 +76,9 @@ class ThreadPthread {
 
   using id = pthread_t;
 
+  // Restricts the thread to the given cpus
+  static Status set_affinity(id thread_id, const vector<int32> &cpus);
+
  private:
   MovableValue<bool> is_inited_;
   pthread_t thread_;
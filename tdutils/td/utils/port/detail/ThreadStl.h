@@ -27,6 +27,7 @@
 #include "td/utils/port/detail/ThreadIdGuard.h"
 #include "td/utils/port/thread_local.h"
 #include "td/utils/Slice.h"
+#include "td/utils/Status.h"
 
 #include <thread>
 #include <tuple>
@@ -74,6 +75,10 @@ class ThreadStl {
 
   using id = std::thread::id;
 
+  static Status set_affinity(id thread_id, const vector<int32> &cpus) {
+    return Status::Error("Thread affinity is not supported");
+  }
+
  private:
   std::thread thread_;
 
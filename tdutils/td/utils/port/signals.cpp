@@ -34,6 +34,7 @@
 #include <csignal>
 #endif
 
+#include <atomic>
 #include <cerrno>
 #include <cstdint>
 #include <cstdlib>
@@ -317,7 +318,17 @@ static void block_stdin() {
 #endif
 }
 
+static std::atomic<void (*)()> failure_signal_callback{nullptr};
+
+void set_failure_signal_callback(void (*callback)()) {
+  failure_signal_callback = callback;
+}
+
 [[maybe_unused]] static void default_failure_signal_handler(int sig) {
+  auto callback = failure_signal_callback.load();
+  if (callback) {
+    callback();
+  }
   Stacktrace::init();
   signal_safe_write_signal_number(sig);
 
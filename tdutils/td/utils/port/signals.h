@@ -45,4 +45,8 @@ void signal_safe_write_pointer(void *p, bool add_header = true);
 
 Status set_default_failure_signal_handler();
 
+// the callback is called by the default failure signal handler before the stack trace is printed,
+// it must be signal-safe
+void set_failure_signal_callback(void (*callback)());
+
 }  // namespace td
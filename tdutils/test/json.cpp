@@ -18,6 +18,7 @@
 */
 #include "td/utils/tests.h"
 
+#include "td/utils/base64.h"
 #include "td/utils/JsonBuilder.h"
 #include "td/utils/logging.h"
 #include "td/utils/Slice.h"
@@ -104,3 +105,52 @@ TEST(JSON, kphp) {
       "{\"keyboard\":[[\"\\u2022 abcdefg\"],[\"\\u2022 hijklmnop\"],[\"\\u2022 "
       "qrstuvwxyz\"]],\"one_time_keyboard\":true}");
 }
+
+TEST(JSON, reader) {
+  string str = " {\"a\" : [1, \"x\\ny\", {}], \"b\\\"\": {\"c\": null}, \"@type\": \"t\", \"d\": true} ";
+  JsonReader reader(str);
+  ASSERT_EQ("\"t\"", reader.find_object_field("@type").move_as_ok());
+  ASSERT_EQ("[1, \"x\\ny\", {}]", reader.find_object_field("a").move_as_ok());
+  ASSERT_TRUE(reader.find_object_field("c").move_as_ok().empty());
+
+  reader.enter_object().ensure();
+  MutableSlice key;
+  ASSERT_TRUE(reader.next_field(key).move_as_ok());
+  ASSERT_EQ("a", key);
+  reader.enter_array().ensure();
+  ASSERT_TRUE(reader.next_element().move_as_ok());
+  ASSERT_EQ("1", reader.read_number().move_as_ok());
+  ASSERT_TRUE(reader.next_element().move_as_ok());
+  ASSERT_EQ("x\ny", reader.read_string().move_as_ok());
+  ASSERT_TRUE(reader.next_element().move_as_ok());
+  reader.enter_object().ensure();
+  ASSERT_TRUE(!reader.next_field(key).move_as_ok());
+  ASSERT_TRUE(!reader.next_element().move_as_ok());
+  ASSERT_TRUE(reader.next_field(key).move_as_ok());
+  ASSERT_EQ("b\"", key);
+  ASSERT_EQ("{\"c\": null}", reader.skip_value().move_as_ok());
+  ASSERT_TRUE(reader.next_field(key).move_as_ok());
+  ASSERT_EQ("@type", key);
+  ASSERT_TRUE(reader.peek_type().move_as_ok() == JsonValue::Type::String);
+  ASSERT_EQ("t", reader.read_string().move_as_ok());
+  ASSERT_TRUE(reader.next_field(key).move_as_ok());
+  ASSERT_TRUE(!reader.try_read_null());
+  ASSERT_TRUE(reader.read_boolean().move_as_ok());
+  ASSERT_TRUE(!reader.next_field(key).move_as_ok());
+  reader.finish().ensure();
+
+  string bad = "[1 2]";
+  JsonReader bad_reader(bad);
+  bad_reader.enter_array().ensure();
+  ASSERT_TRUE(bad_reader.next_element().move_as_ok());
+  bad_reader.read_number().ensure();
+  bad_reader.next_element().ensure_error();
+}
+
+TEST(JSON, base64) {
+  for (size_t size = 0; size < 2000; size += 7) {
+    auto bytes = string(size, static_cast<char>(size));
+    auto encoded = json_encode<string>(JsonBase64String(bytes));
+    ASSERT_EQ(PSTRING() << '"' << base64_encode(bytes) << '"', encoded);
+  }
+}
@@ -17,11 +17,15 @@
     Copyright 2017-2020 Telegram Systems LLP
 */
 
+#include "td/utils/AsyncFileLog.h"
 #include "td/utils/benchmark.h"
 #include "td/utils/FileLog.h"
+#include "td/utils/filesystem.h"
 #include "td/utils/format.h"
 #include "td/utils/logging.h"
+#include "td/utils/misc.h"
 #include "td/utils/port/path.h"
+#include "td/utils/port/Stat.h"
 #include "td/utils/port/thread.h"
 #include "td/utils/Slice.h"
 #include "td/utils/tests.h"
@@ -47,10 +51,11 @@ class LogBenchmark : public td::Benchmark {
     threads_.resize(threads_n_);
   }
   void tear_down() override {
-    for (auto path : log_->get_file_paths()) {
+    auto paths = log_->get_file_paths();
+    log_.reset();
+    for (auto &path : paths) {
       td::unlink(path).ignore();
     }
-    log_.reset();
   }
   void run(int n) override {
     for (auto &thread : threads_) {
@@ -85,6 +90,9 @@ static void bench_log(std::string name, int threads_n, F &&f) {
 };
 
 TEST(Log, TsLogger) {
+  bench_log("AsyncFileLog", 4, [] {
+    return td::AsyncFileLog::create("tmplog", 1 << 20, std::numeric_limits<td::int64>::max(), false).move_as_ok();
+  });
   bench_log("NewTsFileLog", 4,
             [] { return td::TsFileLog::create("tmplog", std::numeric_limits<td::int64>::max(), false).move_as_ok(); });
   bench_log("TsFileLog", 8, [] {
@@ -140,4 +148,73 @@ TEST(Log, TsLogger) {
     return td::make_unique<FileLog>();
   });
 }
+
+TEST(Log, AsyncFileLog) {
+  const int threads_n = 4;
+  const int n = 20000;
+  td::string path = "tmplog_async";
+  td::unlink(path).ignore();
+  {
+    // small buffers to make producers wait for the flusher
+    auto log = td::AsyncFileLog::create(path, 1 << 10, std::numeric_limits<td::int64>::max(), false).move_as_ok();
+    std::vector<td::thread> threads(threads_n);
+    for (int t = 0; t < threads_n; t++) {
+      threads[t] = td::thread([&log, t, n] {
+        for (int i = 0; i < n; i++) {
+          log->append(PSTRING() << t << " " << i << "\n", VERBOSITY_NAME(WARNING));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+  auto data = td::read_file_str(path).move_as_ok();
+  std::vector<int> next(threads_n, 0);
+  for (auto line : td::full_split(data, '\n')) {
+    if (line.empty()) {
+      continue;
+    }
+    auto parts = td::split(line);
+    auto t = td::to_integer<int>(parts.first);
+    ASSERT_TRUE(0 <= t && t < threads_n);
+    ASSERT_EQ(next[t], td::to_integer<int>(parts.second));
+    next[t]++;
+  }
+  for (int t = 0; t < threads_n; t++) {
+    ASSERT_EQ(n, next[t]);
+  }
+  td::unlink(path).ignore();
+}
+
+TEST(Log, AsyncFileLogRotate) {
+  td::string path = "tmplog_async_rotate";
+  td::string old_path = path + ".old";
+  td::unlink(path).ignore();
+  td::unlink(old_path).ignore();
+  {
+    auto log = td::AsyncFileLog::create(path, 1 << 10, std::numeric_limits<td::int64>::max(), false).move_as_ok();
+    log->append("first\n", VERBOSITY_NAME(WARNING));
+    td::AsyncFileLog::flush_all();
+
+    // the file was removed by someone else, rotation creates a new one
+    td::unlink(path).ensure();
+    log->rotate();
+    while (td::stat(path).is_error()) {
+      td::this_thread::yield();
+    }
+    log->append("second\n", VERBOSITY_NAME(WARNING));
+    td::AsyncFileLog::flush_all();
+    ASSERT_EQ("second\n", td::read_file_str(path).move_as_ok());
+    ASSERT_TRUE(td::stat(old_path).is_error());
+
+    // a rotation requested right before the log is destroyed must not fail
+    log->append("third\n", VERBOSITY_NAME(WARNING));
+    td::unlink(path).ensure();
+    log->rotate();
+  }
+  ASSERT_TRUE(td::stat(old_path).is_error());
+  td::unlink(path).ignore();
+  td::unlink(old_path).ignore();
+}
 #endif
@@ -28,6 +28,7 @@
 #include "td/utils/HttpUrl.h"
 #include "td/utils/invoke.h"
 #include "td/utils/logging.h"
+#include "td/utils/LogHistogram.h"
 #include "td/utils/misc.h"
 #include "td/utils/port/EventFd.h"
 #include "td/utils/port/FileFd.h"
@@ -1166,6 +1167,43 @@ TEST(Misc, Xorshift128plus) {
   ASSERT_EQ(5645917797309401285ull, rnd());
   ASSERT_EQ(13554822455746959330ull, rnd());
 }
+TEST(Misc, LogHistogram) {
+  using Histogram = td::LogHistogram<2, 16>;
+  // the last bucket is unbounded
+  for (td::uint64 value = 0; value < (7u << 13); value++) {
+    auto bucket = Histogram::bucket(value);
+    ASSERT_TRUE(bucket < Histogram::BUCKET_COUNT);
+    ASSERT_TRUE(Histogram::bucket_min(bucket) <= value);
+    ASSERT_TRUE(value <= Histogram::bucket_max(bucket));
+    // relative error is below 1/4
+    ASSERT_TRUE(Histogram::bucket_max(bucket) - Histogram::bucket_min(bucket) <= value / 4);
+  }
+  ASSERT_EQ(Histogram::BUCKET_COUNT - 1, Histogram::bucket(1u << 16));
+  ASSERT_EQ(Histogram::BUCKET_COUNT - 1, Histogram::bucket(std::numeric_limits<td::uint64>::max()));
+
+  Histogram histogram;
+  for (td::uint64 value = 1; value <= 1000; value++) {
+    histogram.add(value);
+  }
+  auto snapshot = histogram.snapshot();
+  ASSERT_EQ(1000u, snapshot.count);
+  ASSERT_EQ(500500u, snapshot.sum);
+  for (auto q : {0.1, 0.5, 0.9, 0.99}) {
+    auto exact = static_cast<td::uint64>(q * 1000) + 1;
+    auto quantile = snapshot.quantile(q);
+    ASSERT_TRUE(exact <= quantile);
+    ASSERT_TRUE(quantile <= exact + exact / 4);
+  }
+  ASSERT_EQ(0u, snapshot.count_not_greater(0));
+  ASSERT_EQ(7u, snapshot.count_not_greater(7));
+  ASSERT_EQ(1000u, snapshot.count_not_greater(1023));
+
+  auto sum = snapshot;
+  sum += snapshot;
+  ASSERT_EQ(2000u, sum.count);
+  ASSERT_EQ(snapshot.quantile(0.5), sum.quantile(0.5));
+}
+
 TEST(Misc, uname) {
   auto first_version = get_operating_system_version();
   auto second_version = get_operating_system_version();
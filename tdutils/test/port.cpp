@@ -17,8 +17,10 @@
     Copyright 2017-2020 Telegram Systems LLP
 */
 #include "td/utils/common.h"
+#include "td/utils/format.h"
 #include "td/utils/logging.h"
 #include "td/utils/misc.h"
+#include "td/utils/port/CpuTopology.h"
 #include "td/utils/port/FileFd.h"
 #include "td/utils/port/IoSlice.h"
 #include "td/utils/port/path.h"
@@ -146,6 +148,37 @@ TEST(Port, Writev) {
   ASSERT_EQ(expected_content, content);
 }
 
+TEST(Port, CpuTopology) {
+  ASSERT_EQ("{0, 1, 2, 3, 8, 10, 11}", PSTRING() << format::as_array(parse_cpu_list("0-3,8, 10-11").move_as_ok()));
+  ASSERT_TRUE(parse_cpu_list("").move_as_ok().empty());
+  ASSERT_TRUE(parse_cpu_list("3-1").is_error());
+  ASSERT_TRUE(parse_cpu_list("a").is_error());
+
+  auto topology = CpuTopology::get();
+  ASSERT_TRUE(!topology.empty());
+  ASSERT_EQ(5u, topology.select(5).size());
+
+  // two nodes with two core complexes each; cpus 8-15 are SMT siblings of 0-7
+  std::vector<CpuTopology::Cpu> cpus;
+  for (int32 id = 0; id < 16; id++) {
+    CpuTopology::Cpu cpu;
+    cpu.id = id;
+    cpu.core = id % 8;
+    cpu.cache = id % 8 / 2;
+    cpu.node = id % 8 / 4;
+    cpus.push_back(cpu);
+  }
+  CpuTopology numa(cpus);
+  ASSERT_EQ("{0, 1}", PSTRING() << format::as_array(numa.nodes()));
+  auto ids = [](const std::vector<CpuTopology::Cpu> &cpus) {
+    return PSTRING() << format::as_array(transform(cpus, [](auto &cpu) { return cpu.id; }));
+  };
+  ASSERT_EQ("{0, 1, 2}", ids(numa.select(3)));
+  ASSERT_EQ("{0, 8, 1, 2, 3, 4, 5, 6, 7}", ids(numa.select(9)));
+  ASSERT_EQ("{4, 12, 5, 13, 6, 7}", ids(numa.restrict_to_nodes({1}).select(6)));
+  ASSERT_EQ("{2, 3, 11}", ids(numa.restrict_to_cpus({2, 3, 11}).select(3)));
+}
+
 #if TD_PORT_POSIX && !TD_THREAD_UNSUPPORTED
 #include <signal.h>
 #include <sys/syscall.h>
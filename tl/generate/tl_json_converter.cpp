@@ -167,6 +167,47 @@ void gen_from_json_constructor(StringBuilder &sb, const T *constructor, bool is_
   }
 }
 
+template <class T>
+void gen_from_json_stream_constructor(StringBuilder &sb, const T *constructor, bool is_header) {
+  sb << "Status from_json(" << tl_name << "::" << tl::simple::gen_cpp_name(constructor->name)
+     << " &to, JsonReader &from)";
+  if (is_header) {
+    sb << ";\n";
+    return;
+  }
+  sb << " {\n";
+  sb << "  TRY_STATUS(from.enter_object());\n";
+  sb << "  while (true) {\n";
+  sb << "    MutableSlice field;\n";
+  sb << "    TRY_RESULT(has_field, from.next_field(field));\n";
+  sb << "    if (!has_field) {\n";
+  sb << "      break;\n";
+  sb << "    }\n";
+  sb << "    if (from.try_read_null()) {\n";
+  sb << "      continue;\n";
+  sb << "    }\n";
+  sb << "    ";
+  for (auto &arg : constructor->args) {
+    sb << "if (field == \"" << tl::simple::gen_cpp_name(arg.name) << "\") {\n";
+    if (arg.type->type == tl::simple::Type::Bytes || arg.type->type == tl::simple::Type::SecureBytes) {
+      sb << "      TRY_STATUS(from_json_bytes(to." << tl::simple::gen_cpp_field_name(arg.name) << ", from));\n";
+    } else if (arg.type->type == tl::simple::Type::Vector &&
+               (arg.type->vector_value_type->type == tl::simple::Type::Bytes ||
+                arg.type->vector_value_type->type == tl::simple::Type::SecureBytes)) {
+      sb << "      TRY_STATUS(from_json_vector_bytes(to." << tl::simple::gen_cpp_field_name(arg.name) << ", from));\n";
+    } else {
+      sb << "      TRY_STATUS(from_json(to." << tl::simple::gen_cpp_field_name(arg.name) << ", from));\n";
+    }
+    sb << "    } else ";
+  }
+  sb << "{\n";
+  sb << "      TRY_STATUS(from.skip_value());\n";
+  sb << "    }\n";
+  sb << "  }\n";
+  sb << "  return Status::OK();\n";
+  sb << "}\n";
+}
+
 void gen_from_json(StringBuilder &sb, const tl::simple::Schema &schema, bool is_header, Mode mode) {
   for (auto *custom_type : schema.custom_types) {
     if (!((custom_type->is_query_ && mode != Mode::Client) || (custom_type->is_result_ && mode != Mode::Server)) &&
@@ -175,6 +216,7 @@ void gen_from_json(StringBuilder &sb, const tl::simple::Schema &schema, bool is_
     }
     for (auto *constructor : custom_type->constructors) {
       gen_from_json_constructor(sb, constructor, is_header);
+      gen_from_json_stream_constructor(sb, constructor, is_header);
     }
   }
   if (mode == Mode::Client) {
@@ -182,12 +224,13 @@ void gen_from_json(StringBuilder &sb, const tl::simple::Schema &schema, bool is_
   }
   for (auto *function : schema.functions) {
     gen_from_json_constructor(sb, function, is_header);
+    gen_from_json_stream_constructor(sb, function, is_header);
   }
 }
 
 using Vec = std::vector<std::pair<int32, std::string>>;
 void gen_tl_constructor_from_string(StringBuilder &sb, Slice name, const Vec &vec, bool is_header) {
-  sb << "Result<int32> tl_constructor_from_string(" << tl_name << "::" << name << " *object, const std::string &str)";
+  sb << "Result<int32> tl_constructor_from_string(" << tl_name << "::" << name << " *object, Slice str)";
   if (is_header) {
     sb << ";\n\n";
     return;
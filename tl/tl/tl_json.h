@@ -36,7 +36,7 @@ struct JsonInt64 {
 };
 
 inline void to_json(JsonValueScope &jv, const JsonInt64 json_int64) {
-  jv << JsonString(PSLICE() << json_int64.value);
+  jv << JsonRaw(PSLICE() << '"' << json_int64.value << '"');
 }
 struct JsonVectorInt64 {
   const std::vector<int64> &value;
@@ -53,8 +53,7 @@ struct JsonBytes {
 };
 
 inline void to_json(JsonValueScope &jv, const JsonBytes json_bytes) {
-  auto base64 = base64_encode(json_bytes.bytes);
-  jv << JsonString(base64);
+  jv << JsonBase64String(json_bytes.bytes);
 }
 template <class T>
 struct JsonVectorBytesImpl {
@@ -75,7 +74,7 @@ void to_json(JsonValueScope &jv, const JsonVectorBytesImpl<T> &vec) {
 }
 template <unsigned size>
 inline void to_json(JsonValueScope &jv, const td::BitArray<size> &vec) {
-  to_json(jv, base64_encode(as_slice(vec)));
+  jv << JsonBase64String(as_slice(vec));
 }
 
 template <class T>
@@ -270,7 +269,7 @@ std::enable_if_t<!std::is_constructible<T>::value, Status> from_json(ton::tl_obj
   if (constructor_value.type() == JsonValue::Type::Number) {
     constructor = to_integer<int32>(constructor_value.get_number());
   } else if (constructor_value.type() == JsonValue::Type::String) {
-    TRY_RESULT(t_constructor, tl_constructor_from_string(to.get(), constructor_value.get_string().str()));
+    TRY_RESULT(t_constructor, tl_constructor_from_string(to.get(), constructor_value.get_string()));
     constructor = t_constructor;
   } else {
     return Status::Error(PSLICE() << "Expected string or int, got " << constructor_value.type());
@@ -303,4 +302,213 @@ std::enable_if_t<std::is_constructible<T>::value, Status> from_json(ton::tl_obje
   return from_json(*to, from.get_object());
 }
 
+// Streaming counterparts of the functions above, which read values directly from JsonReader
+
+inline Result<Slice> read_json_number(JsonReader &from) {
+  TRY_RESULT(type, from.peek_type());
+  if (type == JsonValue::Type::String) {
+    TRY_RESULT(number, from.read_string());
+    return number;
+  }
+  if (type != JsonValue::Type::Number) {
+    return Status::Error(PSLICE() << "Expected number, got " << type);
+  }
+  return from.read_number();
+}
+
+inline Result<MutableSlice> read_json_string(JsonReader &from) {
+  TRY_RESULT(type, from.peek_type());
+  if (type != JsonValue::Type::String) {
+    return Status::Error(PSLICE() << "Expected string, got " << type);
+  }
+  return from.read_string();
+}
+
+inline Status from_json(std::int32_t &to, JsonReader &from) {
+  TRY_RESULT(number, read_json_number(from));
+  TRY_RESULT_ASSIGN(to, to_integer_safe<int32>(number));
+  return Status::OK();
+}
+
+inline Status from_json(bool &to, JsonReader &from) {
+  TRY_RESULT(type, from.peek_type());
+  if (type != JsonValue::Type::Boolean) {
+    int32 x;
+    auto status = from_json(x, from);
+    if (status.is_ok()) {
+      to = x != 0;
+      return Status::OK();
+    }
+    return Status::Error(PSLICE() << "Expected bool, got " << type);
+  }
+  TRY_RESULT_ASSIGN(to, from.read_boolean());
+  return Status::OK();
+}
+
+inline Status from_json(std::int64_t &to, JsonReader &from) {
+  TRY_RESULT(number, read_json_number(from));
+  TRY_RESULT_ASSIGN(to, to_integer_safe<int64>(number));
+  return Status::OK();
+}
+
+inline Status from_json(double &to, JsonReader &from) {
+  TRY_RESULT(type, from.peek_type());
+  if (type != JsonValue::Type::Number) {
+    return Status::Error(PSLICE() << "Expected number, got " << type);
+  }
+  TRY_RESULT(number, from.read_number());
+  to = to_double(number);
+  return Status::OK();
+}
+
+inline Status from_json(string &to, JsonReader &from) {
+  TRY_RESULT(value, read_json_string(from));
+  to.assign(value.data(), value.size());
+  return Status::OK();
+}
+
+inline Status from_json(SecureString &to, JsonReader &from) {
+  TRY_RESULT(value, read_json_string(from));
+  to = SecureString(value);
+  return Status::OK();
+}
+
+inline Status from_json(Slice &to, JsonReader &from) {
+  TRY_RESULT_ASSIGN(to, read_json_string(from));
+  return Status::OK();
+}
+
+inline Status from_json_bytes(string &to, JsonReader &from) {
+  TRY_RESULT(value, read_json_string(from));
+  TRY_RESULT_ASSIGN(to, base64_decode(value));
+  return Status::OK();
+}
+
+inline Status from_json_bytes(SecureString &to, JsonReader &from) {
+  TRY_RESULT(value, read_json_string(from));
+  TRY_RESULT_ASSIGN(to, base64_decode_secure(value));
+  return Status::OK();
+}
+
+inline Status from_json_bytes(BufferSlice &to, JsonReader &from) {
+  TRY_RESULT(value, read_json_string(from));
+  TRY_RESULT(decoded, base64_decode(value));
+  to = BufferSlice(decoded);
+  return Status::OK();
+}
+
+inline Status from_json_bytes(Slice &to, JsonReader &from) {
+  TRY_RESULT(value, read_json_string(from));
+  TRY_RESULT(decoded, base64_decode(value));
+  value.copy_from(decoded);
+  value.truncate(decoded.size());
+  to = value;
+  return Status::OK();
+}
+
+template <unsigned size>
+inline Status from_json(td::BitArray<size> &to, JsonReader &from) {
+  TRY_RESULT(value, read_json_string(from));
+  TRY_RESULT(raw, base64_decode(value));
+  auto S = to.as_slice();
+  if (raw.size() != S.size()) {
+    return Status::Error("Wrong length for UInt");
+  }
+  S.copy_from(raw);
+  return Status::OK();
+}
+
+template <class T>
+Status from_json(std::vector<T> &to, JsonReader &from) {
+  TRY_RESULT(type, from.peek_type());
+  if (type != JsonValue::Type::Array) {
+    return Status::Error(PSLICE() << "Expected array, got " << type);
+  }
+  TRY_STATUS(from.enter_array());
+  to.clear();
+  while (true) {
+    TRY_RESULT(has_element, from.next_element());
+    if (!has_element) {
+      break;
+    }
+    to.emplace_back();
+    TRY_STATUS(from_json(to.back(), from));
+  }
+  return Status::OK();
+}
+
+template <class T>
+inline Status from_json_vector_bytes(std::vector<T> &to, JsonReader &from) {
+  TRY_RESULT(type, from.peek_type());
+  if (type != JsonValue::Type::Array) {
+    return Status::Error(PSLICE() << "Expected array, got " << type);
+  }
+  TRY_STATUS(from.enter_array());
+  to.clear();
+  while (true) {
+    TRY_RESULT(has_element, from.next_element());
+    if (!has_element) {
+      break;
+    }
+    to.emplace_back();
+    TRY_STATUS(from_json_bytes(to.back(), from));
+  }
+  return Status::OK();
+}
+
+template <class T>
+std::enable_if_t<!std::is_constructible<T>::value, Status> from_json(ton::tl_object_ptr<T> &to, JsonReader &from) {
+  TRY_RESULT(type, from.peek_type());
+  if (type != JsonValue::Type::Object) {
+    if (from.try_read_null()) {
+      to = nullptr;
+      return Status::OK();
+    }
+    return Status::Error(PSLICE() << "Expected object, got " << type);
+  }
+
+  // the constructor must be known before the object is parsed, so "@type" is looked up in advance
+  TRY_RESULT(constructor_value, from.find_object_field("@type"));
+  if (constructor_value.empty()) {
+    return Status::Error("Can't find field \"@type\"");
+  }
+  int32 constructor = 0;
+  if (constructor_value[0] == '"') {
+    TRY_RESULT(t_constructor,
+               tl_constructor_from_string(to.get(), constructor_value.substr(1, constructor_value.size() - 2)));
+    constructor = t_constructor;
+  } else if (constructor_value[0] == '-' || is_digit(constructor_value[0])) {
+    constructor = to_integer<int32>(constructor_value);
+  } else {
+    return Status::Error(PSLICE() << "Expected string or int, got " << constructor_value);
+  }
+
+  DowncastHelper<T> helper(constructor);
+  Status status;
+  bool ok = downcast_construct(static_cast<T &>(helper), [&](auto result) {
+    status = from_json(*result, from);
+    to = std::move(result);
+  });
+  TRY_STATUS(std::move(status));
+  if (!ok) {
+    return Status::Error(PSLICE() << "Unknown constructor " << format::as_hex(constructor));
+  }
+
+  return Status::OK();
+}
+
+template <class T>
+std::enable_if_t<std::is_constructible<T>::value, Status> from_json(ton::tl_object_ptr<T> &to, JsonReader &from) {
+  TRY_RESULT(type, from.peek_type());
+  if (type != JsonValue::Type::Object) {
+    if (from.try_read_null()) {
+      to = nullptr;
+      return Status::OK();
+    }
+    return Status::Error(PSLICE() << "Expected object, got " << type);
+  }
+  to = ton::create_tl_object<T>();
+  return from_json(*to, from);
+}
+
 }  // namespace td
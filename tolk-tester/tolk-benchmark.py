@@ -0,0 +1,88 @@
+# Usage: `tolk-benchmark.py tests_dir` OR `tolk-benchmark.py tests_dir file_pattern`
+# from current dir, providing the same env as for tolk-tester.py.
+#
+# Measures how long it takes to get a .boc from every .tolk file:
+# * via Fift: `tolk -o compiled.fif` followed by `fift` running Asm.fif
+# * in-process: `tolk -B compiled.boc`
+# Negative tests (compilation fails) are skipped.
+
+import os
+import os.path
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from typing import List
+
+
+def getenv(name, default=None):
+    if name in os.environ:
+        return os.environ[name]
+    if default is None:
+        print("Environment variable", name, "is not set", file=sys.stderr)
+        exit(1)
+    return default
+
+
+TOLK_EXECUTABLE = getenv("TOLK_EXECUTABLE", "tolk")
+FIFT_EXECUTABLE = getenv("FIFT_EXECUTABLE", "fift")
+FIFT_LIBS_FOLDER = getenv("FIFTPATH")  # this env is needed for fift to work properly
+N_RUNS = int(getenv("N_RUNS", "5"))    # the best of N runs is taken for every file
+TMP_DIR = tempfile.mkdtemp()
+
+
+def find_tests(tests_dir: str, file_pattern: str) -> List[str]:
+    all_test_files: List[str] = []
+    for root, _, files in os.walk(tests_dir):
+        all_test_files += [os.path.join(root, f) for f in files if f.endswith(".tolk") and "imports" not in root]
+    all_test_files.sort()
+    if file_pattern is not None:
+        all_test_files = [f for f in all_test_files if f.find(file_pattern) != -1]
+    return all_test_files
+
+
+def best_time_of(cmd_args_list: List[List[str]]) -> float:
+    best = None
+    for _ in range(N_RUNS):
+        started = time.perf_counter()
+        for cmd_args in cmd_args_list:
+            res = subprocess.run(cmd_args, capture_output=True, timeout=10)
+            if res.returncode != 0:
+                return -1
+        elapsed = time.perf_counter() - started
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def run_benchmark(tests: List[str]):
+    compiled_fif = os.path.join(TMP_DIR, "compiled.fif")
+    compiled_boc = os.path.join(TMP_DIR, "compiled.boc")
+    runner_fif = os.path.join(TMP_DIR, "runner.fif")
+    with open(runner_fif, "w") as fd:
+        fd.write("\"%s\" include boc>B \"%s\" B>file\n" % (compiled_fif, compiled_boc))
+
+    total_fift, total_inproc, n_files = 0.0, 0.0, 0
+    print("%-50s %12s %12s %8s" % ("file", "via fift, ms", "-B, ms", "speedup"))
+    for tolk_filename in tests:
+        t_fift = best_time_of([[TOLK_EXECUTABLE, "-o", compiled_fif, tolk_filename], [FIFT_EXECUTABLE, runner_fif]])
+        if t_fift < 0:
+            continue
+        t_inproc = best_time_of([[TOLK_EXECUTABLE, "-o", os.devnull, "-B", compiled_boc, tolk_filename]])
+        if t_inproc < 0:
+            print("%-50s failed to assemble in-process" % os.path.basename(tolk_filename), file=sys.stderr)
+            exit(2)
+        print("%-50s %12.1f %12.1f %7.2fx" % (os.path.basename(tolk_filename), t_fift * 1000, t_inproc * 1000, t_fift / t_inproc))
+        total_fift += t_fift
+        total_inproc += t_inproc
+        n_files += 1
+
+    if n_files:
+        print("%-50s %12.1f %12.1f %7.2fx" % ("total (%d files)" % n_files, total_fift * 1000, total_inproc * 1000, total_fift / total_inproc))
+
+
+if len(sys.argv) < 2 or not os.path.isdir(sys.argv[1]):
+    print("Usage: tolk-benchmark.py tests_dir [file_pattern]", file=sys.stderr)
+    exit(1)
+run_benchmark(find_tests(sys.argv[1], sys.argv[2] if len(sys.argv) > 2 else None))
+shutil.rmtree(TMP_DIR)
@@ -8,6 +8,7 @@
 #
 # Note, that there is also tolk-tester.js to test Tolk compiled to WASM.
 # Don't forget to keep it identical to Python version!
+# (the only difference: WASM has no `-B` option, so comparing compiled.boc with compiled.fif is done only here)
 
 import os
 import os.path
@@ -328,11 +329,14 @@ class TolkTestFile:
     def get_compiled_fif_filename(self):
         return self.artifacts_folder + "/compiled.fif"
 
+    def get_compiled_boc_filename(self):
+        return self.artifacts_folder + "/compiled.boc"
+
     def get_runner_fif_filename(self):
         return self.artifacts_folder + "/runner.fif"
 
     def run_and_check(self):
-        cmd_args = [TOLK_EXECUTABLE, "-o", self.get_compiled_fif_filename()]
+        cmd_args = [TOLK_EXECUTABLE, "-o", self.get_compiled_fif_filename(), "-B", self.get_compiled_boc_filename()]
         if self.experimental_options:
             cmd_args = cmd_args + ["-x", self.experimental_options]
         if not self.enable_tolk_lines_comments:
@@ -356,6 +360,8 @@ class TolkTestFile:
 
         with open(self.get_runner_fif_filename(), "w") as fd:
             fd.write("\"%s\" include <s constant code\n" % self.get_compiled_fif_filename())
+            # bitcode assembled by tolk in-process (-B) must be identical to the one assembled by Fift
+            fd.write("\"%s\" file>B B>boc hashu <b code s, b> hashu <> abort\"compiled.boc differs from compiled.fif\"\n" % self.get_compiled_boc_filename())
             for t in self.input_output:
                 fd.write("%s %d code 1 runvmx abort\"exitcode is not 0\" .s cr { drop } depth 1- times\n" % (t.input, t.method_id))
             if self.expected_hash is not None:
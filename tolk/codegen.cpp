@@ -897,8 +897,7 @@ void Op::generate_code_all(Stack& stack) {
   }
 }
 
-void CodeBlob::generate_code(std::ostream& os, int mode, int indent) const {
-  AsmOpList out_list(indent, &vars);
+void CodeBlob::generate_code(AsmOpList& out_list, int mode) const {
   Stack stack{out_list, mode};
   tolk_assert(ops && ops->cl == Op::_Import);
   int n_import_width = static_cast<int>(ops->left.size());
@@ -910,7 +909,6 @@ void CodeBlob::generate_code(std::ostream& os, int mode, int indent) const {
   if (G.settings.optimization_level >= 2) {
     optimize_code(out_list);
   }
-  out_list.out(os, mode);
 }
 
 }  // namespace tolk
@@ -27,6 +27,9 @@
 #include "src-file.h"
 #include "ast.h"
 #include "compiler-state.h"
+#include "tvm-assembler.h"
+#include "vm/boc.h"
+#include "td/utils/filesystem.h"
 
 namespace tolk {
 
@@ -39,7 +42,7 @@ void FunctionBodyAsm::set_code(std::vector<AsmOp>&& code) {
 }
 
 
-static void generate_output_func(FunctionPtr fun_ref) {
+static void generate_output_func(FunctionPtr fun_ref, TvmAssembler* assembler) {
   tolk_assert(fun_ref->is_code_function());
   if (G.is_verbosity(2)) {
     std::cerr << "\n\n=========================\nfunction " << fun_ref->name << " : " << fun_ref->inferred_return_type << std::endl;
@@ -109,8 +112,13 @@ static void generate_output_func(FunctionPtr fun_ref) {
   if (fun_ref->inline_mode == FunctionInlineMode::inlineViaFif || fun_ref->inline_mode == FunctionInlineMode::inlineRef) {
     mode |= Stack::_InlineAny;
   }
-  code->generate_code(std::cout, mode, 2);
+  AsmOpList out_list(2, &code->vars);
+  code->generate_code(out_list, mode);
+  out_list.out(std::cout, mode);
   std::cout << "  " << "}>\n";
+  if (assembler) {
+    assembler->define_proc(fun_ref, out_list);
+  }
   if (G.is_verbosity(2)) {
     std::cerr << "--------------\n";
   }
@@ -132,6 +140,12 @@ void pipeline_generate_fif_output_to_std_cout() {
   std::cout << std::endl;
   std::cout << "PROGRAM{\n";
 
+  // with `-B`, bitcode is assembled in-process from the same AsmOp lists that are printed as Fift code
+  std::unique_ptr<TvmAssembler> assembler;
+  if (!G.settings.tvm_boc_output_filename.empty()) {
+    assembler = std::make_unique<TvmAssembler>();
+  }
+
   bool has_main_procedure = false;
   int n_inlined_in_place = 0;
   for (FunctionPtr fun_ref : G.all_functions) {
@@ -150,8 +164,14 @@ void pipeline_generate_fif_output_to_std_cout() {
     std::cout << "  ";
     if (fun_ref->has_tvm_method_id()) {
       std::cout << fun_ref->tvm_method_id << " DECLMETHOD " << fun_ref->name << "()\n";
+      if (assembler) {
+        assembler->declare_method(fun_ref);
+      }
     } else {
       std::cout << "DECLPROC " << fun_ref->name << "()\n";
+      if (assembler) {
+        assembler->declare_proc(fun_ref);
+      }
     }
   }
 
@@ -177,19 +197,33 @@ void pipeline_generate_fif_output_to_std_cout() {
     }
 
     std::cout << "  " << "DECLGLOBVAR $" << var_ref->name << "\n";
+    if (assembler) {
+      assembler->declare_global_var(var_ref);
+    }
   }
 
   for (FunctionPtr fun_ref : G.all_functions) {
     if (fun_ref->is_asm_function() || !fun_ref->does_need_codegen()) {
       continue;
     }
-    generate_output_func(fun_ref);
+    generate_output_func(fun_ref, assembler.get());
   }
 
   std::cout << "}END>c\n";
   if (!G.settings.boc_output_filename.empty()) {
     std::cout << "boc>B \"" << G.settings.boc_output_filename << "\" B>file\n";
   }
+
+  if (assembler) {
+    td::Ref<vm::Cell> root = assembler->finish_program();
+    auto boc = vm::std_boc_serialize(std::move(root));
+    if (boc.is_error()) {
+      throw Fatal("failed to serialize bitcode: " + boc.error().message().str());
+    }
+    if (auto status = td::write_file(G.settings.tvm_boc_output_filename, boc.ok()); status.is_error()) {
+      throw Fatal("failed to write " + G.settings.tvm_boc_output_filename + ": " + status.message().str());
+    }
+  }
 }
 
 } // namespace tolk
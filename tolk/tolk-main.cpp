@@ -47,6 +47,7 @@ void usage(const char* progname) {
          "\tGenerates Fift TVM assembler code from a .tolk file\n"
          "-o<fif-filename>\tWrites generated code into specified .fif file instead of stdout\n"
          "-b<boc-filename>\tGenerate Fift instructions to save TVM bytecode into .boc file\n"
+         "-B<boc-filename>\tAssemble TVM bytecode in-process (without Fift) and save it into .boc file\n"
          "-O<level>\tSets optimization level (2 by default)\n"
          "-x<option-names>\tEnables experimental options, comma-separated\n"
          "-S\tDon't include stack layout comments into Fift output\n"
@@ -211,7 +212,7 @@ public:
 
 int main(int argc, char* const argv[]) {
   int i;
-  while ((i = getopt(argc, argv, "o:b:O:x:SLevh")) != -1) {
+  while ((i = getopt(argc, argv, "o:b:B:O:x:SLevh")) != -1) {
     switch (i) {
       case 'o':
         G.settings.output_filename = optarg;
@@ -219,6 +220,9 @@ int main(int argc, char* const argv[]) {
       case 'b':
         G.settings.boc_output_filename = optarg;
         break;
+      case 'B':
+        G.settings.tvm_boc_output_filename = optarg;
+        break;
       case 'O':
         G.settings.optimization_level = std::max(0, atoi(optarg));
         break;
@@ -1143,7 +1143,7 @@ struct CodeBlob {
   void prune_unreachable_code();
   void fwd_analyze();
   void mark_noreturn();
-  void generate_code(std::ostream& os, int mode = 0, int indent = 0) const;
+  void generate_code(AsmOpList& out_list, int mode = 0) const;
 };
 
 // defined in builtins.cpp
@@ -0,0 +1,1196 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "tvm-assembler.h"
+#include "symtable.h"
+#include "common/bitstring.h"
+
+/*
+ *   This file contains an in-process TVM assembler, used by `tolk -B`.
+ *   Its input is AsmOpList of every function (the same as printed to Fift output),
+ * and custom ops are interpreted word by word, like Fift does: "x{...} PUSHSLICE", "f() CALLDICT", "IF:<{", etc.
+ *   Every decision is a mirror of crypto/fift/lib/Asm.fif; comments like `@cont-fits?` refer to its words.
+ * When Asm.fif is modified, this file must be kept in sync (tolk-tester compares both outputs on every test).
+ */
+
+namespace tolk {
+
+// hex `x{...}` or binary `b{...}` bitstring literal, the same as in Fift; nullptr if invalid
+static td::Ref<vm::CellSlice> parse_bitstring_literal(std::string_view literal, bool is_hex) {
+  unsigned char buff[128];
+  long bits = is_hex
+      ? td::bitstring::parse_bitstring_hex_literal(buff, sizeof(buff), literal.data(), literal.data() + literal.size())
+      : td::bitstring::parse_bitstring_binary_literal(buff, sizeof(buff) * 8, literal.data(), literal.data() + literal.size());
+  vm::CellBuilder cb;
+  if (bits < 0 || !cb.store_bits_bool(td::ConstBitPtr{buff}, bits)) {
+    return {};
+  }
+  return cb.as_cellslice_ref();
+}
+
+// opcode prefixes are static strings from tvm-opcodes.cpp, parse each of them once
+static const vm::CellSlice& parse_opcode_prefix(const char* hex_prefix) {
+  static std::unordered_map<const char*, td::Ref<vm::CellSlice>> parsed;
+  td::Ref<vm::CellSlice>& cs = parsed[hex_prefix];
+  if (cs.is_null()) {
+    cs = parse_bitstring_literal(hex_prefix, true);
+    tolk_assert(cs.not_null());
+  }
+  return *cs;
+}
+
+// Fift number literals: 123, -123, 0x7B, -0x7B, 0b1111011
+static td::RefInt256 parse_number_literal(std::string_view word) {
+  size_t i = word[0] == '-' ? 1 : 0;
+  if (i >= word.size() || word[i] < '0' || word[i] > '9') {
+    return {};
+  }
+  if (word.size() > i + 2 && word[i] == '0' && word[i + 1] == 'b') {
+    td::RefInt256 x = td::make_refint(0);
+    for (size_t j = i + 2; j < word.size(); ++j) {
+      if (word[j] != '0' && word[j] != '1') {
+        return {};
+      }
+      x = x * 2 + (word[j] - '0');
+    }
+    return i ? -x : x;
+  }
+  td::RefInt256 x = td::string_to_int256(td::Slice(word.data(), word.size()));
+  return x.not_null() && x->is_valid() ? x : td::RefInt256{};
+}
+
+static bool is_cont_empty(const vm::CellBuilder& body) {
+  return body.size() == 0 && body.size_refs() == 0;
+}
+
+static bool is_cont_aligned(const vm::CellBuilder& body) {
+  return body.size() % 8 == 0;
+}
+
+TvmAssembler::TvmAssembler() {
+  proc_list.emplace_back("main", 0);
+  proc_info[0] = 16;
+}
+
+void TvmAssembler::fire_error(const std::string& message) const {
+  throw ParseError(cur_loc, "TVM assembler: " + message);
+}
+
+vm::CellBuilder& TvmAssembler::cur() {
+  if (blocks.empty()) {
+    fire_error("not in asm context");
+  }
+  return blocks.back().segments.back().write();
+}
+
+// `@havebitrefs`: one ref is always reserved to continue code in a new cell
+bool TvmAssembler::have_bits_refs(int bits, int refs) const {
+  const vm::CellBuilder& cb = *blocks.back().segments.back();
+  return bits <= static_cast<int>(cb.remaining_bits()) && refs <= static_cast<int>(cb.remaining_refs()) - 1;
+}
+
+// `@|`
+void TvmAssembler::split() {
+  blocks.back().segments.push_back(td::make_ref<vm::CellBuilder>());
+}
+
+// `@addopb`
+void TvmAssembler::add_op(const vm::CellBuilder& op) {
+  if (!have_bits_refs(static_cast<int>(op.size()), static_cast<int>(op.size_refs()))) {
+    split();
+  }
+  if (!cur().append_builder_bool(op)) {
+    fire_error("instruction is too long");
+  }
+}
+
+// `@addop`
+void TvmAssembler::add_op(const vm::CellSlice& op) {
+  if (!have_bits_refs(static_cast<int>(op.size()), static_cast<int>(op.size_refs()))) {
+    split();
+  }
+  if (!cur().append_cellslice_bool(op)) {
+    fire_error("instruction is too long");
+  }
+}
+
+void TvmAssembler::open_block(AfterBlock after, td::Ref<vm::CellBuilder> captured, const char* after_op) {
+  Block block;
+  block.after = after;
+  block.segments.push_back(td::make_ref<vm::CellBuilder>());
+  block.captured = std::move(captured);
+  block.after_op = after_op;
+  blocks.push_back(std::move(block));
+}
+
+void TvmAssembler::close_block(BlockEnd end) {
+  if (blocks.empty()) {
+    fire_error("not in asm context");
+  }
+  Block block = std::move(blocks.back());
+  blocks.pop_back();
+
+  // every next segment becomes the last ref of the previous one
+  bool was_split = block.segments.size() > 1;
+  td::Ref<vm::CellBuilder> body = std::move(block.segments.back());
+  for (size_t i = block.segments.size() - 1; i > 0; --i) {
+    td::Ref<vm::CellBuilder> prev = std::move(block.segments[i - 1]);
+    if (!prev.write().store_ref_bool(body->finalize_copy())) {
+      fire_error("cannot chain code cells");
+    }
+    body = std::move(prev);
+  }
+
+  if (end != BlockEnd::normal) {
+    bool expected = (end == BlockEnd::else_ || end == BlockEnd::else_colon) ? block.after == AfterBlock::if_ || block.after == AfterBlock::ifnot
+                  : (end == BlockEnd::do_ || end == BlockEnd::do_colon) ? block.after == AfterBlock::while_cond
+                  : block.after == AfterBlock::try_body;
+    if (!expected) {
+      fire_error("must be terminated by }>");
+    }
+  }
+
+  switch (block.after) {
+    case AfterBlock::push_builder:
+      stack.emplace_back(std::move(body));
+      break;
+    case AfterBlock::push_cont:
+      emit_pushcont(std::move(body));
+      break;
+    case AfterBlock::push_cont_and_op:
+      emit_pushcont(std::move(body));
+      emit_named(block.after_op);
+      break;
+    case AfterBlock::if_:
+      if (end == BlockEnd::else_) {
+        open_block(AfterBlock::if_else, std::move(body));
+      } else if (end == BlockEnd::else_colon) {
+        emit_cont_op(std::move(body), {"IFRET", "IFJMP", "IFJMPREF"});
+      } else {
+        emit_cont_op(std::move(body), {"DROP", "IF", "IFREF"});
+      }
+      break;
+    case AfterBlock::ifnot:
+      if (end == BlockEnd::else_) {
+        open_block(AfterBlock::ifnot_else, std::move(body));
+      } else if (end == BlockEnd::else_colon) {
+        emit_cont_op(std::move(body), {"IFNOTRET", "IFNOTJMP", "IFNOTJMPREF"});
+      } else {
+        emit_cont_op(std::move(body), {"DROP", "IFNOT", "IFNOTREF"});
+      }
+      break;
+    case AfterBlock::ifjmp:
+      emit_cont_op(std::move(body), {"IFRET", "IFJMP", "IFJMPREF"});
+      break;
+    case AfterBlock::ifnotjmp:
+      emit_cont_op(std::move(body), {"IFNOTRET", "IFNOTJMP", "IFNOTJMPREF"});
+      break;
+    case AfterBlock::if_else:
+      emit_if_else(std::move(block.captured), std::move(body));
+      break;
+    case AfterBlock::ifnot_else:
+      emit_if_else(std::move(body), std::move(block.captured));
+      break;
+    case AfterBlock::while_cond:
+      if (end == BlockEnd::do_) {
+        emit_pushcont(std::move(body));
+        open_block(AfterBlock::while_body, {}, block.after_op);
+      } else if (end == BlockEnd::do_colon) {
+        emit_pushcont(std::move(body));
+        emit_named(std::string_view(block.after_op) == "WHILEBRK" ? "WHILEENDBRK" : "WHILEEND");
+      } else {
+        fire_error("`}>DO<{` expected");
+      }
+      break;
+    case AfterBlock::while_body:
+      emit_pushcont(std::move(body));
+      emit_named(block.after_op);
+      break;
+    case AfterBlock::try_body:
+      if (end != BlockEnd::catch_) {
+        fire_error("`}>CATCH<{` expected");
+      }
+      emit_pushcont(std::move(body));
+      open_block(AfterBlock::try_catch);
+      break;
+    case AfterBlock::try_catch:
+      emit_pushcont(std::move(body));
+      emit_named("TRY");
+      break;
+    case AfterBlock::proc: {
+      // `@PROC:<{` starts a procedure with 32 zero bits (to make it shorter than a cell), they are cut off here
+      td::Ref<vm::CellSlice> cs = vm::load_cell_slice_ref(body->finalize_copy());
+      cs.write().advance(32);
+      def_proc(block.proc_idx, std::move(cs), block.proc_len_limit, was_split);
+      break;
+    }
+  }
+}
+
+TvmAssembler::Value TvmAssembler::pop_value() {
+  if (stack.empty()) {
+    fire_error("stack underflow");
+  }
+  Value v = std::move(stack.back());
+  stack.pop_back();
+  return v;
+}
+
+td::RefInt256 TvmAssembler::pop_int() {
+  Value v = pop_value();
+  if (!std::holds_alternative<td::RefInt256>(v)) {
+    fire_error("integer expected");
+  }
+  return std::get<td::RefInt256>(std::move(v));
+}
+
+long long TvmAssembler::pop_long() {
+  td::RefInt256 x = pop_int();
+  if (!x->signed_fits_bits(64)) {
+    fire_error("integer out of range");
+  }
+  return x->to_long();
+}
+
+long long TvmAssembler::pop_long_range(long long min_value, long long max_value, const char* err_msg) {
+  long long x = pop_long();
+  if (x < min_value || x > max_value) {
+    fire_error(err_msg);
+  }
+  return x;
+}
+
+// `@bigsridx`
+int TvmAssembler::pop_big_sreg() {
+  Value v = pop_value();
+  if (!std::holds_alternative<StackReg>(v)) {
+    fire_error("not a stack register");
+  }
+  return std::get<StackReg>(v).idx;
+}
+
+// `@sridx` and `@sridx+`
+int TvmAssembler::pop_sreg(int add) {
+  int idx = pop_big_sreg() + add;
+  if (idx < 0 || idx >= 16) {
+    fire_error(add ? "stack register out of range" : "stack register s0..s15 expected");
+  }
+  return idx;
+}
+
+// `@cridx`
+int TvmAssembler::pop_creg() {
+  Value v = pop_value();
+  if (!std::holds_alternative<ControlReg>(v) || std::get<ControlReg>(v).idx == 6) {
+    fire_error("not a control register c0..c5 or c7");
+  }
+  return std::get<ControlReg>(v).idx;
+}
+
+td::Ref<vm::Cell> TvmAssembler::pop_cell() {
+  Value v = pop_value();
+  if (!std::holds_alternative<td::Ref<vm::Cell>>(v)) {
+    fire_error("cell expected");
+  }
+  return std::get<td::Ref<vm::Cell>>(std::move(v));
+}
+
+td::Ref<vm::CellSlice> TvmAssembler::pop_slice() {
+  Value v = pop_value();
+  if (!std::holds_alternative<td::Ref<vm::CellSlice>>(v)) {
+    fire_error("slice expected");
+  }
+  return std::get<td::Ref<vm::CellSlice>>(std::move(v));
+}
+
+td::Ref<vm::CellBuilder> TvmAssembler::pop_builder() {
+  Value v = pop_value();
+  if (!std::holds_alternative<td::Ref<vm::CellBuilder>>(v)) {
+    fire_error("builder expected");
+  }
+  return std::get<td::Ref<vm::CellBuilder>>(std::move(v));
+}
+
+void TvmAssembler::store_uint(vm::CellBuilder& cb, long long value, int bits) const {
+  if (value < 0 || (bits < 63 && value >> bits) || !cb.store_long_bool(value, bits)) {
+    fire_error("integer " + std::to_string(value) + " does not fit into " + std::to_string(bits) + " bits");
+  }
+}
+
+void TvmAssembler::store_int(vm::CellBuilder& cb, const td::RefInt256& value, int bits) const {
+  if (!value->signed_fits_bits(bits) || !cb.store_int256_bool(value, bits, true)) {
+    fire_error("integer does not fit into " + std::to_string(bits) + " bits");
+  }
+}
+
+// `s, @scomplete`: slice data is followed by a completion tag, padding is 1..8 bits
+void TvmAssembler::store_slice_complete(vm::CellBuilder& cb, const vm::CellSlice& cs, int padding) const {
+  if (padding < 1 || padding > 8 || !cb.append_cellslice_bool(cs) || !cb.store_long_bool(1, 1) ||
+      !cb.store_zeroes_bool(padding - 1)) {
+    fire_error("invalid slice padding");
+  }
+}
+
+// `PUSHINT` into a standalone builder (it's also a part of ADDCONST with large arguments, etc.)
+void TvmAssembler::store_pushint(vm::CellBuilder& cb, const td::RefInt256& x) const {
+  if (!x->is_valid()) {
+    fire_error("integer expected");
+  }
+  if (x->signed_fits_bits(64) && x->to_long() >= -5 && x->to_long() <= 10) {
+    cb.append_cellslice(parse_opcode_prefix("7"));
+    store_uint(cb, x->to_long() & 15, 4);
+  } else if (x->signed_fits_bits(8)) {
+    cb.append_cellslice(parse_opcode_prefix("80"));
+    store_int(cb, x, 8);
+  } else if (x->signed_fits_bits(16)) {
+    cb.append_cellslice(parse_opcode_prefix("81"));
+    store_int(cb, x, 16);
+  } else {
+    int len = 11;
+    do {
+      if (len > 259) {
+        fire_error("integer too large");
+      }
+      len += 8;
+    } while (!x->signed_fits_bits(len));
+    cb.append_cellslice(parse_opcode_prefix("82"));
+    store_uint(cb, (len >> 3) - 2, 5);
+    store_int(cb, x, len);
+  }
+}
+
+void TvmAssembler::emit_simple(const TvmOpcode* opcode) {
+  const vm::CellSlice& prefix = parse_opcode_prefix(opcode->prefix);
+  if (opcode->args == TvmOpArgs::none) {
+    add_op(prefix);
+    return;
+  }
+
+  vm::CellBuilder cb;
+  switch (opcode->args) {
+    case TvmOpArgs::u8:
+      cb.append_cellslice(prefix);
+      store_uint(cb, pop_long(), 8);
+      break;
+    case TvmOpArgs::u8_minus1:
+      cb.append_cellslice(prefix);
+      store_uint(cb, pop_long() - 1, 8);
+      break;
+    case TvmOpArgs::u4:
+      cb.append_cellslice(prefix);
+      store_uint(cb, pop_long(), 4);
+      break;
+    case TvmOpArgs::u12:
+      cb.append_cellslice(prefix);
+      store_uint(cb, pop_long(), 12);
+      break;
+    case TvmOpArgs::u4_u4: {
+      long long y = pop_long();
+      long long x = pop_long();
+      cb.append_cellslice(prefix);
+      store_uint(cb, x, 4);
+      store_uint(cb, y, 4);
+      break;
+    }
+    case TvmOpArgs::ref:
+      cb.append_cellslice(prefix);
+      cb.store_ref(pop_cell());
+      break;
+    case TvmOpArgs::ref_ref: {
+      td::Ref<vm::Cell> c2 = pop_cell();
+      td::Ref<vm::Cell> c1 = pop_cell();
+      cb.append_cellslice(prefix);
+      cb.store_ref(std::move(c1));
+      cb.store_ref(std::move(c2));
+      break;
+    }
+    case TvmOpArgs::sreg:
+      cb.append_cellslice(prefix);
+      store_uint(cb, pop_sreg(), 4);
+      break;
+    case TvmOpArgs::sreg_sreg: {
+      int j = pop_sreg();
+      int i = pop_sreg();
+      cb.append_cellslice(prefix);
+      store_uint(cb, i, 4);
+      store_uint(cb, j, 4);
+      break;
+    }
+    case TvmOpArgs::creg:
+      cb.append_cellslice(prefix);
+      store_uint(cb, pop_creg(), 4);
+      break;
+    case TvmOpArgs::i8_or_pushint: {
+      td::RefInt256 x = pop_int();
+      if (x->signed_fits_bits(8)) {
+        cb.append_cellslice(prefix);
+        store_int(cb, x, 8);
+      } else {
+        store_pushint(cb, x);
+        cb.append_cellslice(parse_opcode_prefix(opcode->alt_prefix));
+      }
+      break;
+    }
+    default:
+      tolk_assert(false);
+  }
+  add_op(cb);
+}
+
+void TvmAssembler::emit_named(std::string_view name) {
+  if (!exec_word(name)) {
+    fire_error("unknown word `" + static_cast<std::string>(name) + "`");
+  }
+}
+
+void TvmAssembler::emit_prefix_uint(const char* prefix, long long x, int bits) {
+  vm::CellBuilder cb;
+  cb.append_cellslice(parse_opcode_prefix(prefix));
+  store_uint(cb, x, bits);
+  add_op(cb);
+}
+
+// XCHG3, PUXC2 and similar: three 4-bit stack registers, some of them adjusted
+void TvmAssembler::emit_stack3(const char* prefix, int add_i, int add_j, int add_k) {
+  int k = pop_sreg(add_k);
+  int j = pop_sreg(add_j);
+  int i = pop_sreg(add_i);
+  vm::CellBuilder cb;
+  cb.append_cellslice(parse_opcode_prefix(prefix));
+  store_uint(cb, i, 4);
+  store_uint(cb, j, 4);
+  store_uint(cb, k, 4);
+  add_op(cb);
+}
+
+void TvmAssembler::emit_xchg(int i, int j) {
+  vm::CellBuilder cb;
+  if (i != j) {
+    int big = std::max(i, j), small = std::min(i, j);
+    if (small == 0) {
+      if (big < 16) {
+        cb.append_cellslice(parse_opcode_prefix("0"));
+        store_uint(cb, big, 4);
+      } else {
+        cb.append_cellslice(parse_opcode_prefix("11"));
+        store_uint(cb, big, 8);
+      }
+    } else if (big >= 16) {
+      if (small >= 16) {
+        cb.append_cellslice(parse_opcode_prefix("11"));
+        store_uint(cb, small, 8);
+        cb.append_cellslice(parse_opcode_prefix("11"));
+        store_uint(cb, big, 8);
+        cb.append_cellslice(parse_opcode_prefix("11"));
+        store_uint(cb, small, 8);
+      } else {
+        cb.append_cellslice(parse_opcode_prefix("0"));
+        store_uint(cb, small, 4);
+        cb.append_cellslice(parse_opcode_prefix("11"));
+        store_uint(cb, big, 8);
+        cb.append_cellslice(parse_opcode_prefix("0"));
+        store_uint(cb, small, 4);
+      }
+    } else if (small == 1) {
+      cb.append_cellslice(parse_opcode_prefix("1"));
+      store_uint(cb, big, 4);
+    } else {
+      cb.append_cellslice(parse_opcode_prefix("10"));
+      store_uint(cb, small, 4);
+      store_uint(cb, big, 4);
+    }
+  }
+  add_op(cb);
+}
+
+// `PUSH` and `POP` accept both stack and control registers
+void TvmAssembler::emit_push_or_pop(bool is_push) {
+  if (!stack.empty() && std::holds_alternative<ControlReg>(stack.back())) {
+    emit_simple(lookup_tvm_opcode(is_push ? "PUSHCTR" : "POPCTR"));
+    return;
+  }
+  int idx = pop_big_sreg();
+  if (idx < 16) {
+    emit_prefix_uint(is_push ? "2" : "3", idx, 4);
+  } else {
+    emit_prefix_uint(is_push ? "56" : "57", idx, 8);
+  }
+}
+
+void TvmAssembler::emit_pushint(const td::RefInt256& x) {
+  vm::CellBuilder cb;
+  store_pushint(cb, x);
+  add_op(cb);
+}
+
+// `PUSHINTX`: large powers of 2 are pushed shorter
+void TvmAssembler::emit_pushintx(td::RefInt256 x) {
+  if (x->signed_fits_bits(8)) {
+    emit_pushint(x);
+    return;
+  }
+  // `pow2decomp`: x = y * 2^k, y is odd
+  auto pow2decomp = [](td::RefInt256 v, int& k) {
+    k = 0;
+    while (!v->is_odd()) {
+      v = v >> 1;
+      k++;
+    }
+    return v;
+  };
+  int k;
+  td::RefInt256 y = pow2decomp(x, k);
+  if (!td::cmp(y, 1)) {
+    emit_pushpow2(k, "83");
+  } else if (!td::cmp(y, -1)) {
+    emit_pushpow2(k, "85");
+  } else if (k >= 20) {
+    emit_pushint(y);
+    stack.emplace_back(td::make_refint(k));
+    emit_named("LSHIFT#");
+  } else if (k != 0) {
+    emit_pushint(x);
+  } else {
+    int k2;
+    td::RefInt256 y2 = pow2decomp(~x, k2);
+    if (!td::cmp(y2, -1)) {
+      emit_pushpow2(k2, "84");
+    } else {
+      emit_pushint(x);
+    }
+  }
+}
+
+// PUSHPOW2 / PUSHPOW2DEC / PUSHNEGPOW2
+void TvmAssembler::emit_pushpow2(long long k, const char* prefix) {
+  if (k == 256 && !strcmp(prefix, "83")) {
+    fire_error("use PUSHNAN instead of 256 PUSHPOW2");
+  }
+  emit_prefix_uint(prefix, k - 1, 8);
+}
+
+// `PUSHSLICE`: short slices are inlined into code, long ones are stored as refs
+void TvmAssembler::emit_pushslice(td::Ref<vm::CellSlice> cs) {
+  int bits = static_cast<int>(cs->size()), refs = static_cast<int>(cs->size_refs());
+  if (!have_bits_refs(bits + 26, refs)) {
+    vm::CellBuilder cb;
+    cb.append_cellslice(cs);
+    stack.emplace_back(cb.finalize_copy());
+    emit_named("PUSHREFSLICE");
+    return;
+  }
+  vm::CellBuilder& b = cur();
+  if (bits <= 123 && refs == 0) {
+    int len = (bits + 4) >> 3;
+    b.append_cellslice(parse_opcode_prefix("8B"));
+    store_uint(b, len, 4);
+    store_slice_complete(b, *cs, len * 8 + 4 - bits);
+  } else if (refs >= 1 && bits <= 248) {
+    int len = (bits + 7) >> 3;
+    b.append_cellslice(parse_opcode_prefix("8C"));
+    store_uint(b, refs - 1, 2);
+    store_uint(b, len, 5);
+    store_slice_complete(b, *cs, len * 8 + 1 - bits);
+  } else {
+    int len = (bits + 2) >> 3;
+    b.append_cellslice(parse_opcode_prefix("8D"));
+    store_uint(b, refs, 3);
+    store_uint(b, len, 7);
+    store_slice_complete(b, *cs, len * 8 + 6 - bits);
+  }
+}
+
+// `PUSHCONT`: a continuation is inlined if it fits, or stored as a ref otherwise
+void TvmAssembler::emit_pushcont(td::Ref<vm::CellBuilder> body) {
+  if (!is_cont_fits(*body)) {
+    stack.emplace_back(body->finalize_copy());
+    emit_named("PUSHREFCONT");
+    return;
+  }
+  int bits = static_cast<int>(body->size()), refs = static_cast<int>(body->size_refs());
+  vm::CellBuilder& b = cur();
+  if (bits <= 120 && refs == 0) {
+    b.append_cellslice(parse_opcode_prefix("9"));
+    store_uint(b, bits >> 3, 4);
+  } else {
+    b.append_cellslice(parse_opcode_prefix("8F_"));
+    store_uint(b, refs, 2);
+    store_uint(b, bits >> 3, 7);
+  }
+  b.append_builder(*body);
+}
+
+// `STSLICECONST`
+void TvmAssembler::emit_stslice_const(td::Ref<vm::CellSlice> cs) {
+  int bits = static_cast<int>(cs->size()), refs = static_cast<int>(cs->size_refs());
+  if (have_bits_refs(bits + 22, refs) && bits <= 57 && refs <= 3) {
+    vm::CellBuilder& b = cur();
+    int len = (bits + 6) >> 3;
+    b.append_cellslice(parse_opcode_prefix("CFC_"));
+    store_uint(b, refs, 2);
+    store_uint(b, len, 3);
+    store_slice_complete(b, *cs, len * 8 + 2 - bits);
+    return;
+  }
+  emit_pushslice(std::move(cs));
+  emit_named("STSLICER");
+}
+
+// `SDBEGINS` and `SDBEGINSQ`
+void TvmAssembler::emit_sdbegins(td::Ref<vm::CellSlice> cs, bool quiet) {
+  if (cs->size_refs()) {
+    fire_error("no references allowed in slice");
+  }
+  int bits = static_cast<int>(cs->size());
+  int len = (bits + 5) >> 3;
+  if (len * 8 + 24 <= static_cast<int>(blocks.back().segments.back()->remaining_bits())) {
+    vm::CellBuilder cb;
+    cb.append_cellslice(parse_opcode_prefix(quiet ? "D72E_" : "D72A_"));
+    store_uint(cb, len, 7);
+    store_slice_complete(cb, *cs, len * 8 + 3 - bits);
+    add_op(cb);
+  } else {
+    emit_pushslice(std::move(cs));
+    emit_named(quiet ? "SDBEGINSXQ" : "SDBEGINSX");
+  }
+}
+
+void TvmAssembler::emit_call_dict(long long idx) {
+  if (idx >= 0 && idx < (1 << 8)) {
+    emit_prefix_uint("F0", idx, 8);
+  } else if (idx >= 0 && idx < (1 << 14)) {
+    emit_prefix_uint("F12_", idx, 14);
+  } else {
+    emit_pushint(td::make_refint(idx));
+    emit_named("CALLVAR");
+  }
+}
+
+void TvmAssembler::emit_jmp_dict(long long idx) {
+  if (idx >= 0 && idx < (1 << 14)) {
+    emit_prefix_uint("F16_", idx, 14);
+  } else {
+    emit_pushint(td::make_refint(idx));
+    emit_named("JMPVAR");
+  }
+}
+
+void TvmAssembler::emit_prepare_dict(long long idx) {
+  if (idx >= 0 && idx < (1 << 14)) {
+    emit_prefix_uint("F1A_", idx, 14);
+  } else {
+    // Asm.fif has no working fallback for large indices either
+    fire_error("PREPAREDICT: procedure index does not fit into 14 bits");
+  }
+}
+
+// `INLINE`: a body of an already defined procedure is copied to the call site
+void TvmAssembler::emit_inline(td::Ref<vm::CellSlice> cs) {
+  if (cs->size()) {
+    add_op(*cs);
+  } else if (cs->size_refs()) {
+    stack.emplace_back(cs->prefetch_ref());
+    emit_named("CALLREF");
+  }
+}
+
+// `@run-cont-op`: IF-cont, IFJMP-cont and similar
+void TvmAssembler::emit_cont_op(td::Ref<vm::CellBuilder> body, const ContOp& cont_op) {
+  if (is_cont_empty(*body)) {
+    emit_named(cont_op.if_empty);
+    return;
+  }
+  if (!is_cont_fits(*body) && !have_bits_refs(16, 1)) {
+    split();
+  }
+  if (is_cont_fits(*body)) {
+    emit_pushcont(std::move(body));
+    emit_named(cont_op.if_inline);
+  } else {
+    stack.emplace_back(body->finalize_copy());
+    emit_named(cont_op.if_ref);
+  }
+}
+
+// `IFELSE-cont2`
+void TvmAssembler::emit_if_else(td::Ref<vm::CellBuilder> body_then, td::Ref<vm::CellBuilder> body_else) {
+  if (is_cont_empty(*body_else)) {
+    emit_cont_op(std::move(body_then), {"DROP", "IF", "IFREF"});
+    return;
+  }
+  if (is_cont_empty(*body_then)) {
+    emit_cont_op(std::move(body_else), {"DROP", "IFNOT", "IFNOTREF"});
+    return;
+  }
+  while (true) {
+    if (is_two_cont_fit(*body_then, *body_else)) {
+      emit_pushcont(std::move(body_then));
+      emit_pushcont(std::move(body_else));
+      emit_named("IFELSE");
+    } else if (is_cont_ref_fit(*body_else)) {
+      emit_pushcont(std::move(body_else));
+      stack.emplace_back(body_then->finalize_copy());
+      emit_named("IFREFELSE");
+    } else if (is_cont_ref_fit(*body_then)) {
+      emit_pushcont(std::move(body_then));
+      stack.emplace_back(body_else->finalize_copy());
+      emit_named("IFELSEREF");
+    } else if (have_bits_refs(32, 2)) {
+      stack.emplace_back(body_then->finalize_copy());
+      stack.emplace_back(body_else->finalize_copy());
+      emit_named("IFREFELSEREF");
+    } else {
+      split();
+      continue;
+    }
+    return;
+  }
+}
+
+// `DICTPUSHCONST`
+void TvmAssembler::emit_dict_push_const(td::Ref<vm::Cell> dict, int key_len) {
+  if (dict.is_null()) {
+    emit_named("NEWDICT");
+    emit_pushint(td::make_refint(key_len));
+    return;
+  }
+  vm::CellBuilder cb;
+  cb.append_cellslice(parse_opcode_prefix("F4A6_"));
+  cb.store_ref(std::move(dict));
+  store_uint(cb, key_len, 10);
+  add_op(cb);
+}
+
+// `@cont-fits?`
+bool TvmAssembler::is_cont_fits(const vm::CellBuilder& body) const {
+  return is_cont_aligned(body) && have_bits_refs(static_cast<int>(body.size()) + 16, static_cast<int>(body.size_refs()));
+}
+
+// `@cont-ref-fit?`
+bool TvmAssembler::is_cont_ref_fit(const vm::CellBuilder& body) const {
+  return is_cont_aligned(body) && have_bits_refs(static_cast<int>(body.size()) + 32, static_cast<int>(body.size_refs()) + 1);
+}
+
+// `@two-cont-fit?`
+bool TvmAssembler::is_two_cont_fit(const vm::CellBuilder& body1, const vm::CellBuilder& body2) const {
+  return is_cont_aligned(body1) && is_cont_aligned(body2) &&
+         have_bits_refs(static_cast<int>(body1.size() + body2.size()) + 32, static_cast<int>(body1.size_refs() + body2.size_refs()));
+}
+
+// words that are not table-driven: they have custom arguments, or expand to several instructions
+const std::unordered_map<std::string_view, TvmAssembler::CustomWordHandler>& TvmAssembler::custom_words() {
+  static const std::unordered_map<std::string_view, CustomWordHandler> words = {
+    // stack registers and blocks
+    {"s()", [](TvmAssembler& a) { a.stack.emplace_back(StackReg{static_cast<int>(a.pop_long_range(0, 255, "Invalid stack register number"))}); }},
+    {"<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_builder); }},
+    {"}>", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); }},
+    {"}>ELSE<{", [](TvmAssembler& a) { a.close_block(BlockEnd::else_); }},
+    {"}>ELSE:", [](TvmAssembler& a) { a.close_block(BlockEnd::else_colon); }},
+    {"}>DO<{", [](TvmAssembler& a) { a.close_block(BlockEnd::do_); }},
+    {"}>DO:", [](TvmAssembler& a) { a.close_block(BlockEnd::do_colon); }},
+    {"}>CATCH<{", [](TvmAssembler& a) { a.close_block(BlockEnd::catch_); }},
+    {"}>c", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.stack.emplace_back(a.pop_builder()->finalize_copy()); }},
+    {"}>s", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.stack.emplace_back(a.pop_builder()->as_cellslice_ref()); }},
+    {"}>CONT", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.emit_pushcont(a.pop_builder()); }},
+    {"}>IF", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.emit_cont_op(a.pop_builder(), {"DROP", "IF", "IFREF"}); }},
+    {"}>IFNOT", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.emit_cont_op(a.pop_builder(), {"DROP", "IFNOT", "IFNOTREF"}); }},
+    {"}>IFJMP", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.emit_cont_op(a.pop_builder(), {"IFRET", "IFJMP", "IFJMPREF"}); }},
+    {"}>IFNOTJMP", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.emit_cont_op(a.pop_builder(), {"IFNOTRET", "IFNOTJMP", "IFNOTJMPREF"}); }},
+    {"}>REPEAT", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.emit_pushcont(a.pop_builder()); a.emit_named("REPEAT"); }},
+    {"}>UNTIL", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.emit_pushcont(a.pop_builder()); a.emit_named("UNTIL"); }},
+    {"}>AGAIN", [](TvmAssembler& a) { a.close_block(BlockEnd::normal); a.emit_pushcont(a.pop_builder()); a.emit_named("AGAIN"); }},
+    {"CONT:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont); }},
+    {"IF:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::if_); }},
+    {"IFNOT:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::ifnot); }},
+    {"IFJMP:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::ifjmp); }},
+    {"IFNOTJMP:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::ifnotjmp); }},
+    {"REPEAT:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "REPEAT"); }},
+    {"UNTIL:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "UNTIL"); }},
+    {"AGAIN:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "AGAIN"); }},
+    {"REPEATBRK:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "REPEATBRK"); }},
+    {"UNTILBRK:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "UNTILBRK"); }},
+    {"AGAINBRK:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "AGAINBRK"); }},
+    {"ATEXIT:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "ATEXIT"); }},
+    {"ATEXITALT:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "ATEXITALT"); }},
+    {"SETEXITALT:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::push_cont_and_op, {}, "SETEXITALT"); }},
+    {"WHILE:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::while_cond, {}, "WHILE"); }},
+    {"WHILEBRK:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::while_cond, {}, "WHILEBRK"); }},
+    {"TRY:<{", [](TvmAssembler& a) { a.open_block(AfterBlock::try_body); }},
+    // plain Fift words applicable to `<b b> PUSHREF` and similar
+    {"<b", [](TvmAssembler& a) { a.stack.emplace_back(td::make_ref<vm::CellBuilder>()); }},
+    {"b>", [](TvmAssembler& a) { a.stack.emplace_back(a.pop_builder()->finalize_copy()); }},
+    {"<s", [](TvmAssembler& a) { a.stack.emplace_back(vm::load_cell_slice_ref(a.pop_cell())); }},
+    // stack primitives
+    {"XCHG", [](TvmAssembler& a) { int j = a.pop_big_sreg(); int i = a.pop_big_sreg(); a.emit_xchg(i, j); }},
+    {"PUSH", [](TvmAssembler& a) { a.emit_push_or_pop(true); }},
+    {"POP", [](TvmAssembler& a) { a.emit_push_or_pop(false); }},
+    {"XCHG3", [](TvmAssembler& a) { a.emit_stack3("4", 0, 0, 0); }},
+    {"PUXC", [](TvmAssembler& a) { int j = a.pop_sreg(1); int i = a.pop_sreg(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("52")); a.store_uint(cb, i, 4); a.store_uint(cb, j, 4); a.add_op(cb); }},
+    {"XCHG3_l", [](TvmAssembler& a) { a.emit_stack3("540", 0, 0, 0); }},
+    {"XC2PU", [](TvmAssembler& a) { a.emit_stack3("541", 0, 0, 0); }},
+    {"XCPUXC", [](TvmAssembler& a) { a.emit_stack3("542", 0, 0, 1); }},
+    {"XCPU2", [](TvmAssembler& a) { a.emit_stack3("543", 0, 0, 0); }},
+    {"PUXC2", [](TvmAssembler& a) { a.emit_stack3("544", 0, 1, 1); }},
+    {"PUXCPU", [](TvmAssembler& a) { a.emit_stack3("545", 0, 1, 1); }},
+    {"PU2XC", [](TvmAssembler& a) { a.emit_stack3("546", 0, 1, 2); }},
+    {"PUSH3", [](TvmAssembler& a) { a.emit_stack3("547", 0, 0, 0); }},
+    {"BLKSWAP", [](TvmAssembler& a) { long long j = a.pop_long(); long long i = a.pop_long(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("55")); a.store_uint(cb, i - 1, 4); a.store_uint(cb, j - 1, 4); a.add_op(cb); }},
+    {"ROLL", [](TvmAssembler& a) { long long n = a.pop_long(); if (n) { a.stack.emplace_back(td::make_refint(1)); a.stack.emplace_back(td::make_refint(n)); a.emit_named("BLKSWAP"); } }},
+    {"-ROLL", [](TvmAssembler& a) { long long n = a.pop_long(); if (n) { a.stack.emplace_back(td::make_refint(n)); a.stack.emplace_back(td::make_refint(1)); a.emit_named("BLKSWAP"); } }},
+    {"ROLLREV", [](TvmAssembler& a) { a.emit_named("-ROLL"); }},
+    {"REVERSE", [](TvmAssembler& a) { long long j = a.pop_long(); long long i = a.pop_long(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("5E")); a.store_uint(cb, i - 2, 4); a.store_uint(cb, j, 4); a.add_op(cb); }},
+    {"BLKDROP", [](TvmAssembler& a) { a.emit_prefix_uint("5F0", a.pop_long(), 4); }},
+    {"BLKPUSH", [](TvmAssembler& a) { long long j = a.pop_long(); long long i = a.pop_long(); if (!i) a.fire_error("first argument must be non-zero"); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("5F")); a.store_uint(cb, i, 4); a.store_uint(cb, j, 4); a.add_op(cb); }},
+    {"BLKDROP2", [](TvmAssembler& a) { long long j = a.pop_long(); long long i = a.pop_long(); if (!i) a.fire_error("first argument must be non-zero"); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("6C")); a.store_uint(cb, i, 4); a.store_uint(cb, j, 4); a.add_op(cb); }},
+    {"INDEX2", [](TvmAssembler& a) { long long j = a.pop_long(); long long i = a.pop_long(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("6FB")); a.store_uint(cb, i, 2); a.store_uint(cb, j, 2); a.add_op(cb); }},
+    {"INDEX3", [](TvmAssembler& a) { long long k = a.pop_long(); long long j = a.pop_long(); long long i = a.pop_long(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("6FE_")); a.store_uint(cb, i, 2); a.store_uint(cb, j, 2); a.store_uint(cb, k, 2); a.add_op(cb); }},
+    // constants
+    {"PUSHINT", [](TvmAssembler& a) { a.emit_pushint(a.pop_int()); }},
+    {"INT", [](TvmAssembler& a) { a.emit_pushint(a.pop_int()); }},
+    {"PUSHINTX", [](TvmAssembler& a) { a.emit_pushintx(a.pop_int()); }},
+    {"INTX", [](TvmAssembler& a) { a.emit_pushintx(a.pop_int()); }},
+    {"PUSHPOW2", [](TvmAssembler& a) { a.emit_pushpow2(a.pop_long(), "83"); }},
+    {"PUSHPOW2DEC", [](TvmAssembler& a) { a.emit_pushpow2(a.pop_long(), "84"); }},
+    {"PUSHNEGPOW2", [](TvmAssembler& a) { a.emit_pushpow2(a.pop_long(), "85"); }},
+    {"PUSHSLICE", [](TvmAssembler& a) { a.emit_pushslice(a.pop_slice()); }},
+    {"SLICE", [](TvmAssembler& a) { a.emit_pushslice(a.pop_slice()); }},
+    {"PUSHCONT", [](TvmAssembler& a) { a.emit_pushcont(a.pop_builder()); }},
+    {"CONT", [](TvmAssembler& a) { a.emit_pushcont(a.pop_builder()); }},
+    // arithmetic and comparison with immediate arguments
+    {"SUBCONST", [](TvmAssembler& a) { a.stack.emplace_back(-a.pop_int()); a.emit_named("ADDCONST"); }},
+    {"SUBINT", [](TvmAssembler& a) { a.stack.emplace_back(-a.pop_int()); a.emit_named("ADDCONST"); }},
+    {"LEQINT", [](TvmAssembler& a) { a.stack.emplace_back(a.pop_int() + 1); a.emit_named("LESSINT"); }},
+    {"GEQINT", [](TvmAssembler& a) { a.stack.emplace_back(a.pop_int() - 1); a.emit_named("GTINT"); }},
+    // cells and slices
+    {"STREF2CONST", [](TvmAssembler& a) { td::Ref<vm::Cell> c2 = a.pop_cell(); td::Ref<vm::Cell> c1 = a.pop_cell(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("CF21")); cb.store_ref(std::move(c1)); cb.store_ref(std::move(c2)); a.add_op(cb); }},
+    {"STSLICECONST", [](TvmAssembler& a) { a.emit_stslice_const(a.pop_slice()); }},
+    {"PLDUZ", [](TvmAssembler& a) { long long n = a.pop_long(); if (n & 31) a.fire_error("argument must be a multiple of 32"); a.emit_prefix_uint("D714_", (n >> 5) - 1, 3); }},
+    {"SDBEGINS", [](TvmAssembler& a) { a.emit_sdbegins(a.pop_slice(), false); }},
+    {"SDBEGINSQ", [](TvmAssembler& a) { a.emit_sdbegins(a.pop_slice(), true); }},
+    {"PLDREFIDX", [](TvmAssembler& a) { a.emit_prefix_uint("D74E_", a.pop_long(), 2); }},
+    {"CHASHI", [](TvmAssembler& a) { a.emit_prefix_uint("D76A_", a.pop_long(), 2); }},
+    {"CDEPTHI", [](TvmAssembler& a) { a.emit_prefix_uint("D76E_", a.pop_long(), 2); }},
+    // continuations
+    {"CALLXARGS", [](TvmAssembler& a) { long long r = a.pop_long(); long long p = a.pop_long(); vm::CellBuilder cb; if (r != -1) { cb.append_cellslice(parse_opcode_prefix("DA")); a.store_uint(cb, p, 4); a.store_uint(cb, r, 4); } else { cb.append_cellslice(parse_opcode_prefix("DB0")); a.store_uint(cb, p, 4); } a.add_op(cb); }},
+    {"CALLCCARGS", [](TvmAssembler& a) { long long r = a.pop_long(); long long p = a.pop_long(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("DB36")); a.store_uint(cb, p, 4); a.store_uint(cb, r == -1 ? 15 : r, 4); a.add_op(cb); }},
+    {"IFBITJMP", [](TvmAssembler& a) { a.emit_prefix_uint("E39_", a.pop_long(), 5); }},
+    {"IFNBITJMP", [](TvmAssembler& a) { a.emit_prefix_uint("E3B_", a.pop_long(), 5); }},
+    {"IFBITJMPREF", [](TvmAssembler& a) { long long n = a.pop_long(); td::Ref<vm::Cell> c = a.pop_cell(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("E3D_")); a.store_uint(cb, n, 5); cb.store_ref(std::move(c)); a.add_op(cb); }},
+    {"IFNBITJMPREF", [](TvmAssembler& a) { long long n = a.pop_long(); td::Ref<vm::Cell> c = a.pop_cell(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("E3F_")); a.store_uint(cb, n, 5); cb.store_ref(std::move(c)); a.add_op(cb); }},
+    {"SETCONTARGS", [](TvmAssembler& a) { long long n = a.pop_long(); long long r = a.pop_long(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("EC")); a.store_uint(cb, r, 4); a.store_uint(cb, n == -1 ? 15 : n, 4); a.add_op(cb); }},
+    {"SETNUMARGS", [](TvmAssembler& a) { td::RefInt256 n = a.pop_int(); a.stack.emplace_back(td::make_refint(0)); a.stack.emplace_back(std::move(n)); a.emit_named("SETCONTARGS"); }},
+    {"BLESSARGS", [](TvmAssembler& a) { long long n = a.pop_long(); long long r = a.pop_long(); vm::CellBuilder cb; cb.append_cellslice(parse_opcode_prefix("EE")); a.store_uint(cb, r, 4); a.store_uint(cb, n == -1 ? 15 : n, 4); a.add_op(cb); }},
+    {"BLESSNUMARGS", [](TvmAssembler& a) { td::RefInt256 n = a.pop_int(); a.stack.emplace_back(td::make_refint(0)); a.stack.emplace_back(std::move(n)); a.emit_named("BLESSARGS"); }},
+    {"PUSHROOT", [](TvmAssembler& a) { a.stack.emplace_back(ControlReg{4}); a.emit_named("PUSHCTR"); }},
+    {"POPROOT", [](TvmAssembler& a) { a.stack.emplace_back(ControlReg{4}); a.emit_named("POPCTR"); }},
+    {"CALLVAR", [](TvmAssembler& a) { a.stack.emplace_back(ControlReg{3}); a.emit_named("PUSH"); a.emit_named("EXECUTE"); }},
+    {"JMPVAR", [](TvmAssembler& a) { a.stack.emplace_back(ControlReg{3}); a.emit_named("PUSH"); a.emit_named("JMPX"); }},
+    {"PREPAREVAR", [](TvmAssembler& a) { a.stack.emplace_back(ControlReg{3}); a.emit_named("PUSH"); }},
+    // procedures; inside PROGRAM{ they also track which of them are called or inlined
+    {"CALLDICT", [](TvmAssembler& a) { long long idx = a.pop_long(); a.mark_proc(idx, 8); a.emit_call_dict(idx); }},
+    {"CALL", [](TvmAssembler& a) { long long idx = a.pop_long(); a.mark_proc(idx, 8); a.emit_call_dict(idx); }},
+    {"JMPDICT", [](TvmAssembler& a) { long long idx = a.pop_long(); a.mark_proc(idx, 8); a.emit_jmp_dict(idx); }},
+    {"JMP", [](TvmAssembler& a) { long long idx = a.pop_long(); a.mark_proc(idx, 8); a.emit_jmp_dict(idx); }},
+    {"PREPAREDICT", [](TvmAssembler& a) { long long idx = a.pop_long(); a.mark_proc(idx, 8); a.emit_prepare_dict(idx); }},
+    {"PREPARE", [](TvmAssembler& a) { long long idx = a.pop_long(); a.mark_proc(idx, 8); a.emit_prepare_dict(idx); }},
+    {"INLINECALLDICT", [](TvmAssembler& a) { a.emit_named("INLINECALL"); }},
+    {"INLINECALL", [](TvmAssembler& a) {
+      long long idx = a.pop_long();
+      if (td::Ref<vm::CellSlice> body = a.lookup_proc(static_cast<int>(idx)); body.not_null()) {
+        a.mark_proc(idx, 4);
+        a.emit_inline(std::move(body));
+      } else {
+        a.mark_proc(idx, 8);
+        a.emit_call_dict(idx);
+      }
+    }},
+    {"INLINE", [](TvmAssembler& a) { a.emit_inline(a.pop_slice()); }},
+    // exceptions
+    {"THROW", [](TvmAssembler& a) { long long n = a.pop_long(); n >= 0 && n < 64 ? a.emit_prefix_uint("F22_", n, 6) : a.emit_prefix_uint("F2C4_", n, 11); }},
+    {"THROWIF", [](TvmAssembler& a) { long long n = a.pop_long(); n >= 0 && n < 64 ? a.emit_prefix_uint("F26_", n, 6) : a.emit_prefix_uint("F2D4_", n, 11); }},
+    {"THROWIFNOT", [](TvmAssembler& a) { long long n = a.pop_long(); n >= 0 && n < 64 ? a.emit_prefix_uint("F2A_", n, 6) : a.emit_prefix_uint("F2E4_", n, 11); }},
+    {"THROWARG", [](TvmAssembler& a) { a.emit_prefix_uint("F2CC_", a.pop_long(), 11); }},
+    {"THROWARGIF", [](TvmAssembler& a) { a.emit_prefix_uint("F2DC_", a.pop_long(), 11); }},
+    {"THROWARGIFNOT", [](TvmAssembler& a) { a.emit_prefix_uint("F2EC_", a.pop_long(), 11); }},
+    // globals, debug, codepage
+    {"GETGLOB", [](TvmAssembler& a) { a.emit_prefix_uint("F85_", a.pop_long_range(1, 31, "Out of range"), 5); }},
+    {"SETGLOB", [](TvmAssembler& a) { a.emit_prefix_uint("F87_", a.pop_long_range(1, 31, "Out of range"), 5); }},
+    {"DEBUG", [](TvmAssembler& a) { a.emit_prefix_uint("FE", a.pop_long_range(0, 239, "debug selector out of range"), 8); }},
+    {"DUMPSTKTOP", [](TvmAssembler& a) { a.emit_prefix_uint("FE0", a.pop_long_range(1, 15, "Out of range"), 4); }},
+    {"SETCP", [](TvmAssembler& a) { a.emit_prefix_uint("FF", a.pop_long_range(-14, 239, "codepage out of range") & 255, 8); }},
+  };
+  return words;
+}
+
+// executes a word that is not a literal; returns false if it's unknown
+bool TvmAssembler::exec_word(std::string_view word) {
+  const auto& words = custom_words();
+  if (auto it = words.find(word); it != words.end()) {
+    it->second(*this);
+    return true;
+  }
+  if (const TvmOpcode* opcode = lookup_tvm_opcode(word)) {
+    emit_simple(opcode);
+    return true;
+  }
+  return false;
+}
+
+// executes a single word of a custom op: a literal, a register, a procedure/global name, or an instruction
+void TvmAssembler::exec_token(std::string_view token) {
+  if (exec_word(token)) {
+    return;
+  }
+  if (auto it = proc_words.find(static_cast<std::string>(token)); it != proc_words.end()) {
+    stack.emplace_back(td::make_refint(it->second));
+    return;
+  }
+  if (auto it = global_words.find(static_cast<std::string>(token)); it != global_words.end()) {
+    stack.emplace_back(td::make_refint(it->second));
+    return;
+  }
+  if (token.size() >= 2 && token.size() <= 3 && (token[0] == 's' || token[0] == 'c') && token[1] >= '0' && token[1] <= '9') {
+    int idx = token[1] - '0';
+    if (token.size() == 3 && idx == 1 && token[2] >= '0' && token[2] <= '5') {
+      idx = 10 + token[2] - '0';
+    } else if (token.size() == 3) {
+      idx = -1;
+    }
+    if (token[0] == 's' && idx >= 0) {
+      stack.emplace_back(StackReg{idx});
+      return;
+    }
+    if (token[0] == 'c' && idx >= 0 && idx <= 7 && idx != 6) {
+      stack.emplace_back(ControlReg{idx});
+      return;
+    }
+  }
+  if (token == "s(-1)" || token == "s(-2)") {
+    stack.emplace_back(StackReg{token[3] == '1' ? -1 : -2});
+    return;
+  }
+  if (td::RefInt256 x = parse_number_literal(token); x.not_null()) {
+    stack.emplace_back(std::move(x));
+    return;
+  }
+  fire_error("unknown word `" + static_cast<std::string>(token) + "`, use Fift to assemble this code");
+}
+
+void TvmAssembler::exec_asm_op(const AsmOp& op) {
+  cur_loc = op.loc;
+  switch (op.t) {
+    case AsmOp::a_nop:
+    case AsmOp::a_comment:
+      return;
+    default:
+      break;
+  }
+
+  // stack ops without text are emitted directly, the same way as AsmOp::out() would print them
+  if (op.op.empty()) {
+    switch (op.t) {
+      case AsmOp::a_xchg:
+        if (!op.a && !(op.b & -2)) {
+          emit_named(op.b ? "SWAP" : "NOP");
+        } else {
+          emit_xchg(op.a, op.b);
+        }
+        return;
+      case AsmOp::a_push:
+        if (!(op.a & -2)) {
+          emit_named(op.a ? "OVER" : "DUP");
+        } else {
+          emit_prefix_uint(op.a < 16 ? "2" : "56", op.a, op.a < 16 ? 4 : 8);
+        }
+        return;
+      case AsmOp::a_pop:
+        if (!(op.a & -2)) {
+          emit_named(op.a ? "NIP" : "DROP");
+        } else {
+          emit_prefix_uint(op.a < 16 ? "3" : "57", op.a, op.a < 16 ? 4 : 8);
+        }
+        return;
+      default:
+        throw Fatal("unknown assembler operation");
+    }
+  }
+
+  std::string_view text = op.op;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    if (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r') {
+      pos++;
+      continue;
+    }
+    size_t end = pos;
+    while (end < text.size() && text[end] != ' ' && text[end] != '\t' && text[end] != '\n' && text[end] != '\r') {
+      end++;
+    }
+    std::string_view token = text.substr(pos, end - pos);
+    if (token.starts_with("//")) {      // a comment till the end of line
+      end = text.find('\n', pos);
+      pos = end == std::string_view::npos ? text.size() : end;
+      continue;
+    }
+    if (token.starts_with("x{") || token.starts_with("b{")) {   // like Fift, scan a literal up to `}`
+      size_t close = text.find('}', pos);
+      if (close == std::string_view::npos) {
+        fire_error("`}` expected in bitstring literal");
+      }
+      td::Ref<vm::CellSlice> cs = parse_bitstring_literal(text.substr(pos + 2, close - pos - 2), token[0] == 'x');
+      if (cs.is_null()) {
+        fire_error(token[0] == 'x' ? "Invalid hex bitstring constant" : "Invalid binary bitstring constant");
+      }
+      stack.emplace_back(std::move(cs));
+      pos = close + 1;
+      continue;
+    }
+    exec_token(token);
+    pos = end;
+  }
+}
+
+td::Ref<vm::CellSlice> TvmAssembler::lookup_proc(int idx) {
+  unsigned char buffer[vm::Dictionary::max_key_bytes];
+  return proc_dict.lookup(vm::Dictionary::integer_key(td::make_refint(idx), 19, true, buffer));
+}
+
+// `@procinfo~!`: +1=declared, +2=defined, +4=inlined, +8=called, +16=method
+void TvmAssembler::mark_proc(long long idx, int flags) {
+  proc_info[static_cast<int>(idx)] |= flags;
+}
+
+// `@declproc`
+void TvmAssembler::declare_proc_idx(const std::string& name, int idx, int flags) {
+  if (idx < -(1 << 18) || idx >= (1 << 18)) {
+    fire_error("procedure index out of range");
+  }
+  if (exec_word_exists(name)) {
+    fire_error("procedure name `" + name + "` conflicts with an assembler word");
+  }
+  mark_proc(idx, flags);
+  proc_list.emplace_back(name, idx);
+  proc_words[name] = idx;
+}
+
+// `@def-proc`: a body is stored into a dictionary (or into a separate cell if it's long)
+void TvmAssembler::def_proc(int idx, td::Ref<vm::CellSlice> body, int len_limit, bool was_split) {
+  if (len_limit < 0) {
+    len_limit = was_split ? 0 : -len_limit;
+  }
+  if (len_limit < static_cast<int>(body->size())) {    // `@adj-long-proc`
+    vm::CellBuilder cb;
+    cb.append_cellslice(body);
+    vm::CellBuilder wrapper;
+    wrapper.store_ref(cb.finalize_copy());
+    body = vm::load_cell_slice_ref(wrapper.finalize_copy());
+  }
+  unsigned char buffer[vm::Dictionary::max_key_bytes];
+  if (!proc_dict.set(vm::Dictionary::integer_key(td::make_refint(idx), 19, true, buffer), std::move(body), vm::Dictionary::SetMode::Add)) {
+    fire_error("cannot define procedure, redefined?");
+  }
+  mark_proc(idx, 2);
+}
+
+bool TvmAssembler::exec_word_exists(std::string_view word) {
+  return custom_words().contains(word) || lookup_tvm_opcode(word) != nullptr;
+}
+
+// `DECLPROC f()`
+void TvmAssembler::declare_proc(FunctionPtr fun_ref) {
+  std::string name = fun_ref->name + "()";
+  cur_loc = fun_ref->loc;
+  if (!proc_words.contains(name)) {
+    declare_proc_idx(name, ++proc_cnt, 1);
+  }
+}
+
+// `123 DECLMETHOD f()`
+void TvmAssembler::declare_method(FunctionPtr fun_ref) {
+  std::string name = fun_ref->name + "()";
+  cur_loc = fun_ref->loc;
+  int method_id = static_cast<int>(fun_ref->tvm_method_id);
+  if (auto it = proc_words.find(name); it != proc_words.end()) {
+    if (it->second != method_id) {
+      fire_error("method redefined with different id");
+    }
+  } else {
+    declare_proc_idx(name, method_id, 17);
+  }
+}
+
+// `DECLGLOBVAR $g`
+void TvmAssembler::declare_global_var(GlobalVarPtr var_ref) {
+  global_words["$" + var_ref->name] = ++global_cnt;
+}
+
+// `f() PROC:<{ ... }>`, `PROCINLINE:<{` or `PROCREF:<{`
+void TvmAssembler::define_proc(FunctionPtr fun_ref, const AsmOpList& code) {
+  cur_loc = fun_ref->loc;
+  auto it = proc_words.find(fun_ref->name + "()");
+  if (it == proc_words.end()) {
+    fire_error("procedure `" + fun_ref->name + "` was not declared");
+  }
+  int idx = it->second;
+  if (lookup_proc(idx).not_null()) {
+    fire_error("procedure already defined");
+  }
+
+  open_block(AfterBlock::proc);
+  blocks.back().proc_idx = idx;
+  blocks.back().proc_len_limit = fun_ref->inline_mode == FunctionInlineMode::inlineViaFif ? -1000
+                               : fun_ref->inline_mode == FunctionInlineMode::inlineRef ? 0
+                               : 1000;
+  cur().store_zeroes(32);
+
+  for (const AsmOp& op : code.list_) {
+    exec_asm_op(op);
+  }
+
+  cur_loc = fun_ref->loc;
+  if (blocks.size() != 1 || !stack.empty()) {
+    fire_error("unbalanced code in procedure `" + fun_ref->name + "`");
+  }
+  close_block(BlockEnd::normal);
+}
+
+// `}END>c`: checks that all procedures are defined, removes unused ones, and creates a dictionary-dispatching root
+td::Ref<vm::Cell> TvmAssembler::finish_program() {
+  if (lookup_proc(0).is_null()) {
+    fire_error("`main` procedure not defined");
+  }
+  for (auto it = proc_list.rbegin(); it != proc_list.rend(); ++it) {
+    int idx = it->second;
+    if (lookup_proc(idx).is_null()) {
+      fire_error(it->first + ": procedure declared but left undefined");
+    }
+    if ((proc_info[idx] & 0x1a) == 2) {     // defined, but neither called nor a method (so, inlined everywhere)
+      unsigned char buffer[vm::Dictionary::max_key_bytes];
+      proc_dict.lookup_delete(vm::Dictionary::integer_key(td::make_refint(idx), 19, true, buffer));
+    }
+  }
+
+  open_block(AfterBlock::push_builder);
+  emit_named("SETCP0");
+  emit_dict_push_const(proc_dict.get_root_cell(), 19);
+  emit_named("DICTIGETJMPZ");
+  stack.emplace_back(td::make_refint(11));
+  emit_named("THROWARG");
+  close_block(BlockEnd::normal);
+  return pop_builder()->finalize_copy();
+}
+
+} // namespace tolk
@@ -0,0 +1,198 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "fwd-declarations.h"
+#include "tolk.h"
+#include "vm/cells.h"
+#include "vm/dict.h"
+#include <map>
+#include <unordered_map>
+#include <variant>
+
+namespace tolk {
+
+// arguments of simple TVM instructions, mirroring @Defop(...) variants of Asm.fif
+enum class TvmOpArgs {
+  none,
+  u8,
+  u8_minus1,
+  u4,
+  u12,
+  u4_u4,
+  ref,
+  ref_ref,
+  sreg,
+  sreg_sreg,
+  creg,
+  i8_or_pushint,   // `x{A6} x{A0} @Defop(8i,alt) ADDCONST`: an 8-bit immediate, or PUSHINT + alt_prefix otherwise
+};
+
+struct TvmOpcode {
+  const char* name;
+  const char* prefix;        // hex bitstring, like in x{...} literals, may end with `_`
+  TvmOpArgs args;
+  const char* alt_prefix = nullptr;
+};
+
+// find a simple (table-driven) instruction by its Fift name, or nullptr (defined in tvm-opcodes.cpp)
+const TvmOpcode* lookup_tvm_opcode(std::string_view name);
+
+/*
+ *   TvmAssembler builds TVM bitcode in-process from AsmOp lists, without printing Fift text and running Asm.fif.
+ *   It repeats Asm.fif decisions exactly (how continuations are inlined or moved to refs, when a cell is split
+ * into a chain, the layout of the procedure dictionary and removal of unused procedures),
+ * so its output is bit-identical to `"output.fif" include` in Fift.
+ *   Only words that Tolk code generation and stdlib/asm functions actually use are recognized;
+ * on anything else, a compilation error is fired, and the Fift path should be used.
+ */
+class TvmAssembler {
+  struct StackReg {
+    int idx;
+  };
+  struct ControlReg {
+    int idx;
+  };
+  // values of Fift stack: arguments of instructions, like `s1 s2 XCHG` or `x{...} PUSHSLICE`
+  using Value = std::variant<td::RefInt256, StackReg, ControlReg, td::Ref<vm::CellSlice>, td::Ref<vm::CellBuilder>,
+                             td::Ref<vm::Cell>>;
+
+  // what happens when a block `<{ ... }>` is closed, like closures passed to @doafter<{ in Asm.fif
+  enum class AfterBlock {
+    push_builder,
+    push_cont,
+    push_cont_and_op,
+    if_,
+    ifnot,
+    ifjmp,
+    ifnotjmp,
+    if_else,
+    ifnot_else,
+    while_cond,
+    while_body,
+    try_body,
+    try_catch,
+    proc,
+  };
+  // how a block was terminated: `}>`, `}>ELSE<{`, `}>ELSE:`, `}>DO<{`, `}>DO:`, `}>CATCH<{`
+  enum class BlockEnd { normal, else_, else_colon, do_, do_colon, catch_ };
+
+  // IF-cont and similar of Asm.fif: instructions for an empty / inlined / moved-to-ref continuation
+  struct ContOp {
+    const char* if_empty;
+    const char* if_inline;
+    const char* if_ref;
+  };
+
+  struct Block {
+    AfterBlock after;
+    // when an instruction doesn't fit into a cell, code continues in a new cell (`@|` in Asm.fif);
+    // on closing, every next segment is stored as the last ref of the previous one
+    std::vector<td::Ref<vm::CellBuilder>> segments;
+    td::Ref<vm::CellBuilder> captured;    // the first part of IF:<{ }>ELSE<{, WHILE:<{ }>DO<{, TRY:<{ }>CATCH<{
+    const char* after_op = nullptr;       // REPEAT for REPEAT:<{, WHILEBRK for WHILEBRK:<{, etc.
+    int proc_idx = 0;
+    int proc_len_limit = 0;
+  };
+
+  std::vector<Block> blocks;
+  std::vector<Value> stack;
+  SrcLocation cur_loc;
+
+  std::unordered_map<std::string, int> proc_words;      // "f()" -> proc index
+  std::unordered_map<std::string, int> global_words;    // "$g" -> global var index
+  std::vector<std::pair<std::string, int>> proc_list;
+  std::map<int, int> proc_info;                          // +1=declared, +2=defined, +4=inlined, +8=called, +16=method
+  vm::Dictionary proc_dict{19};
+  int proc_cnt = 0;
+  int global_cnt = 0;
+
+  using CustomWordHandler = void (*)(TvmAssembler&);
+  static const std::unordered_map<std::string_view, CustomWordHandler>& custom_words();
+
+  [[noreturn]] void fire_error(const std::string& message) const;
+
+  vm::CellBuilder& cur();
+  bool have_bits_refs(int bits, int refs) const;
+  void split();
+  void add_op(const vm::CellBuilder& op);
+  void add_op(const vm::CellSlice& op);
+  void open_block(AfterBlock after, td::Ref<vm::CellBuilder> captured = {}, const char* after_op = nullptr);
+  void close_block(BlockEnd end);
+
+  Value pop_value();
+  td::RefInt256 pop_int();
+  long long pop_long();
+  long long pop_long_range(long long min_value, long long max_value, const char* err_msg);
+  int pop_big_sreg();
+  int pop_sreg(int add = 0);
+  int pop_creg();
+  td::Ref<vm::Cell> pop_cell();
+  td::Ref<vm::CellSlice> pop_slice();
+  td::Ref<vm::CellBuilder> pop_builder();
+
+  void store_uint(vm::CellBuilder& cb, long long value, int bits) const;
+  void store_int(vm::CellBuilder& cb, const td::RefInt256& value, int bits) const;
+  void store_slice_complete(vm::CellBuilder& cb, const vm::CellSlice& cs, int padding) const;
+  void store_pushint(vm::CellBuilder& cb, const td::RefInt256& x) const;
+
+  void emit_simple(const TvmOpcode* opcode);
+  void emit_named(std::string_view name);
+  void emit_prefix_uint(const char* prefix, long long x, int bits);
+  void emit_stack3(const char* prefix, int add_i, int add_j, int add_k);
+  void emit_xchg(int i, int j);
+  void emit_push_or_pop(bool is_push);
+  void emit_pushint(const td::RefInt256& x);
+  void emit_pushintx(td::RefInt256 x);
+  void emit_pushpow2(long long k, const char* prefix);
+  void emit_pushslice(td::Ref<vm::CellSlice> cs);
+  void emit_pushcont(td::Ref<vm::CellBuilder> body);
+  void emit_stslice_const(td::Ref<vm::CellSlice> cs);
+  void emit_sdbegins(td::Ref<vm::CellSlice> cs, bool quiet);
+  void emit_call_dict(long long idx);
+  void emit_jmp_dict(long long idx);
+  void emit_prepare_dict(long long idx);
+  void emit_inline(td::Ref<vm::CellSlice> cs);
+  void emit_cont_op(td::Ref<vm::CellBuilder> body, const ContOp& cont_op);
+  void emit_if_else(td::Ref<vm::CellBuilder> body_then, td::Ref<vm::CellBuilder> body_else);
+  void emit_dict_push_const(td::Ref<vm::Cell> dict, int key_len);
+
+  bool is_cont_fits(const vm::CellBuilder& body) const;
+  bool is_cont_ref_fit(const vm::CellBuilder& body) const;
+  bool is_two_cont_fit(const vm::CellBuilder& body1, const vm::CellBuilder& body2) const;
+
+  bool exec_word(std::string_view word);
+  static bool exec_word_exists(std::string_view word);
+  void exec_token(std::string_view token);
+  void exec_asm_op(const AsmOp& op);
+
+  td::Ref<vm::CellSlice> lookup_proc(int idx);
+  void mark_proc(long long idx, int flags);
+  void declare_proc_idx(const std::string& name, int idx, int flags);
+  void def_proc(int idx, td::Ref<vm::CellSlice> body, int len_limit, bool was_split);
+
+public:
+  TvmAssembler();
+
+  void declare_proc(FunctionPtr fun_ref);
+  void declare_method(FunctionPtr fun_ref);
+  void declare_global_var(GlobalVarPtr var_ref);
+  void define_proc(FunctionPtr fun_ref, const AsmOpList& code);
+  td::Ref<vm::Cell> finish_program();
+};
+
+} // namespace tolk
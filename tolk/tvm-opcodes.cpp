@@ -0,0 +1,1014 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "tvm-assembler.h"
+#include <unordered_map>
+
+/*
+ *   Simple TVM instructions, in the order they are defined in crypto/fift/lib/Asm.fif via `x{..} @Defop...`.
+ *   Words that Asm.fif defines with custom Fift code (PUSHINT, XCHG, IF:<{, CALLDICT, etc.)
+ * are not listed here, they are implemented by TvmAssembler itself.
+ *   When Asm.fif gets new instructions, this table must be updated as well (tolk-tester checks that
+ * boc emitted by `tolk -B` is identical to the one assembled by Fift).
+ */
+
+namespace tolk {
+
+static const TvmOpcode all_tvm_opcodes[] = {
+  {"NOP", "00", TvmOpArgs::none},
+  {"SWAP", "01", TvmOpArgs::none},
+  {"XCHG0", "0", TvmOpArgs::sreg},
+  {"PUSHCTR", "ED4", TvmOpArgs::creg},
+  {"POPCTR", "ED5", TvmOpArgs::creg},
+  {"DUP", "20", TvmOpArgs::none},
+  {"OVER", "21", TvmOpArgs::none},
+  {"DROP", "30", TvmOpArgs::none},
+  {"NIP", "31", TvmOpArgs::none},
+  {"XCHG2", "50", TvmOpArgs::sreg_sreg},
+  {"XCPU", "51", TvmOpArgs::sreg_sreg},
+  {"PUSH2", "53", TvmOpArgs::sreg_sreg},
+  {"2ROT", "5513", TvmOpArgs::none},
+  {"ROT2", "5513", TvmOpArgs::none},
+  {"ROT", "58", TvmOpArgs::none},
+  {"-ROT", "59", TvmOpArgs::none},
+  {"ROTREV", "59", TvmOpArgs::none},
+  {"2SWAP", "5A", TvmOpArgs::none},
+  {"SWAP2", "5A", TvmOpArgs::none},
+  {"2DROP", "5B", TvmOpArgs::none},
+  {"DROP2", "5B", TvmOpArgs::none},
+  {"2DUP", "5C", TvmOpArgs::none},
+  {"DUP2", "5C", TvmOpArgs::none},
+  {"2OVER", "5D", TvmOpArgs::none},
+  {"OVER2", "5D", TvmOpArgs::none},
+  {"PICK", "60", TvmOpArgs::none},
+  {"PUSHX", "60", TvmOpArgs::none},
+  {"ROLLX", "61", TvmOpArgs::none},
+  {"-ROLLX", "62", TvmOpArgs::none},
+  {"ROLLREVX", "62", TvmOpArgs::none},
+  {"BLKSWX", "63", TvmOpArgs::none},
+  {"REVX", "64", TvmOpArgs::none},
+  {"DROPX", "65", TvmOpArgs::none},
+  {"TUCK", "66", TvmOpArgs::none},
+  {"XCHGX", "67", TvmOpArgs::none},
+  {"DEPTH", "68", TvmOpArgs::none},
+  {"CHKDEPTH", "69", TvmOpArgs::none},
+  {"ONLYTOPX", "6A", TvmOpArgs::none},
+  {"ONLYX", "6B", TvmOpArgs::none},
+  {"NULL", "6D", TvmOpArgs::none},
+  {"PUSHNULL", "6D", TvmOpArgs::none},
+  {"ISNULL", "6E", TvmOpArgs::none},
+  {"TUPLE", "6F0", TvmOpArgs::u4},
+  {"NIL", "6F00", TvmOpArgs::none},
+  {"SINGLE", "6F01", TvmOpArgs::none},
+  {"PAIR", "6F02", TvmOpArgs::none},
+  {"CONS", "6F02", TvmOpArgs::none},
+  {"TRIPLE", "6F03", TvmOpArgs::none},
+  {"INDEX", "6F1", TvmOpArgs::u4},
+  {"FIRST", "6F10", TvmOpArgs::none},
+  {"CAR", "6F10", TvmOpArgs::none},
+  {"SECOND", "6F11", TvmOpArgs::none},
+  {"CDR", "6F11", TvmOpArgs::none},
+  {"THIRD", "6F12", TvmOpArgs::none},
+  {"UNTUPLE", "6F2", TvmOpArgs::u4},
+  {"UNSINGLE", "6F21", TvmOpArgs::none},
+  {"UNPAIR", "6F22", TvmOpArgs::none},
+  {"UNCONS", "6F22", TvmOpArgs::none},
+  {"UNTRIPLE", "6F23", TvmOpArgs::none},
+  {"UNPACKFIRST", "6F3", TvmOpArgs::u4},
+  {"CHKTUPLE", "6F30", TvmOpArgs::none},
+  {"EXPLODE", "6F4", TvmOpArgs::u4},
+  {"SETINDEX", "6F5", TvmOpArgs::u4},
+  {"SETFIRST", "6F50", TvmOpArgs::none},
+  {"SETSECOND", "6F51", TvmOpArgs::none},
+  {"SETTHIRD", "6F52", TvmOpArgs::none},
+  {"INDEXQ", "6F6", TvmOpArgs::u4},
+  {"FIRSTQ", "6F60", TvmOpArgs::none},
+  {"CARQ", "6F60", TvmOpArgs::none},
+  {"SECONDQ", "6F61", TvmOpArgs::none},
+  {"CDRQ", "6F61", TvmOpArgs::none},
+  {"THIRDQ", "6F62", TvmOpArgs::none},
+  {"SETINDEXQ", "6F7", TvmOpArgs::u4},
+  {"SETFIRSTQ", "6F70", TvmOpArgs::none},
+  {"SETSECONDQ", "6F71", TvmOpArgs::none},
+  {"SETTHIRDQ", "6F72", TvmOpArgs::none},
+  {"TUPLEVAR", "6F80", TvmOpArgs::none},
+  {"INDEXVAR", "6F81", TvmOpArgs::none},
+  {"UNTUPLEVAR", "6F82", TvmOpArgs::none},
+  {"UNPACKFIRSTVAR", "6F83", TvmOpArgs::none},
+  {"EXPLODEVAR", "6F84", TvmOpArgs::none},
+  {"SETINDEXVAR", "6F85", TvmOpArgs::none},
+  {"INDEXVARQ", "6F86", TvmOpArgs::none},
+  {"SETINDEXVARQ", "6F87", TvmOpArgs::none},
+  {"TLEN", "6F88", TvmOpArgs::none},
+  {"QTLEN", "6F89", TvmOpArgs::none},
+  {"ISTUPLE", "6F8A", TvmOpArgs::none},
+  {"LAST", "6F8B", TvmOpArgs::none},
+  {"TPUSH", "6F8C", TvmOpArgs::none},
+  {"COMMA", "6F8C", TvmOpArgs::none},
+  {"TPOP", "6F8D", TvmOpArgs::none},
+  {"NULLSWAPIF", "6FA0", TvmOpArgs::none},
+  {"NULLSWAPIFNOT", "6FA1", TvmOpArgs::none},
+  {"NULLROTRIF", "6FA2", TvmOpArgs::none},
+  {"NULLROTRIFNOT", "6FA3", TvmOpArgs::none},
+  {"NULLSWAPIF2", "6FA4", TvmOpArgs::none},
+  {"NULLSWAPIFNOT2", "6FA5", TvmOpArgs::none},
+  {"NULLROTRIF2", "6FA6", TvmOpArgs::none},
+  {"NULLROTRIFNOT2", "6FA7", TvmOpArgs::none},
+  {"CADR", "6FB4", TvmOpArgs::none},
+  {"CDDR", "6FB5", TvmOpArgs::none},
+  {"CADDR", "6FD4", TvmOpArgs::none},
+  {"CDDDR", "6FD5", TvmOpArgs::none},
+  {"ZERO", "70", TvmOpArgs::none},
+  {"FALSE", "70", TvmOpArgs::none},
+  {"ONE", "71", TvmOpArgs::none},
+  {"TWO", "72", TvmOpArgs::none},
+  {"TEN", "7A", TvmOpArgs::none},
+  {"TRUE", "7F", TvmOpArgs::none},
+  {"PUSHNAN", "83FF", TvmOpArgs::none},
+  {"PUSHREF", "88", TvmOpArgs::ref},
+  {"PUSHREFSLICE", "89", TvmOpArgs::ref},
+  {"PUSHREFCONT", "8A", TvmOpArgs::ref},
+  {"ADD", "A0", TvmOpArgs::none},
+  {"SUB", "A1", TvmOpArgs::none},
+  {"SUBR", "A2", TvmOpArgs::none},
+  {"NEGATE", "A3", TvmOpArgs::none},
+  {"INC", "A4", TvmOpArgs::none},
+  {"DEC", "A5", TvmOpArgs::none},
+  {"ADDCONST", "A6", TvmOpArgs::i8_or_pushint, "A0"},
+  {"MULCONST", "A7", TvmOpArgs::i8_or_pushint, "A8"},
+  {"ADDINT", "A6", TvmOpArgs::i8_or_pushint, "A0"},
+  {"MULINT", "A7", TvmOpArgs::i8_or_pushint, "A8"},
+  {"MUL", "A8", TvmOpArgs::none},
+  {"DIV", "A904", TvmOpArgs::none},
+  {"DIVR", "A905", TvmOpArgs::none},
+  {"DIVC", "A906", TvmOpArgs::none},
+  {"MOD", "A908", TvmOpArgs::none},
+  {"MODR", "A909", TvmOpArgs::none},
+  {"MODC", "A90A", TvmOpArgs::none},
+  {"DIVMOD", "A90C", TvmOpArgs::none},
+  {"DIVMODR", "A90D", TvmOpArgs::none},
+  {"DIVMODC", "A90E", TvmOpArgs::none},
+  {"ADDDIVMOD", "A900", TvmOpArgs::none},
+  {"ADDDIVMODR", "A901", TvmOpArgs::none},
+  {"ADDDIVMODC", "A902", TvmOpArgs::none},
+  {"RSHIFTR", "A925", TvmOpArgs::none},
+  {"RSHIFTC", "A926", TvmOpArgs::none},
+  {"MODPOW2", "A928", TvmOpArgs::none},
+  {"MODPOW2R", "A929", TvmOpArgs::none},
+  {"MODPOW2C", "A92A", TvmOpArgs::none},
+  {"RSHIFTMOD", "A92C", TvmOpArgs::none},
+  {"RSHIFTMODR", "A92D", TvmOpArgs::none},
+  {"RSHIFTMODC", "A92E", TvmOpArgs::none},
+  {"ADDRSHIFTMOD", "A920", TvmOpArgs::none},
+  {"ADDRSHIFTMODR", "A921", TvmOpArgs::none},
+  {"ADDRSHIFTMODC", "A922", TvmOpArgs::none},
+  {"RSHIFTR#", "A935", TvmOpArgs::u8_minus1},
+  {"RSHIFTC#", "A936", TvmOpArgs::u8_minus1},
+  {"MODPOW2#", "A938", TvmOpArgs::u8_minus1},
+  {"MODPOW2R#", "A939", TvmOpArgs::u8_minus1},
+  {"MODPOW2C#", "A93A", TvmOpArgs::u8_minus1},
+  {"RSHIFT#MOD", "A93C", TvmOpArgs::u8_minus1},
+  {"RSHIFTR#MOD", "A93D", TvmOpArgs::u8_minus1},
+  {"RSHIFTC#MOD", "A93E", TvmOpArgs::u8_minus1},
+  {"ADDRSHIFT#MOD", "A930", TvmOpArgs::u8_minus1},
+  {"ADDRSHIFTR#MOD", "A931", TvmOpArgs::u8_minus1},
+  {"ADDRSHIFTC#MOD", "A932", TvmOpArgs::u8_minus1},
+  {"MULDIV", "A984", TvmOpArgs::none},
+  {"MULDIVR", "A985", TvmOpArgs::none},
+  {"MULDIVC", "A986", TvmOpArgs::none},
+  {"MULMOD", "A988", TvmOpArgs::none},
+  {"MULMODR", "A989", TvmOpArgs::none},
+  {"MULMODC", "A98A", TvmOpArgs::none},
+  {"MULDIVMOD", "A98C", TvmOpArgs::none},
+  {"MULDIVMODR", "A98D", TvmOpArgs::none},
+  {"MULDIVMODC", "A98E", TvmOpArgs::none},
+  {"MULADDDIVMOD", "A980", TvmOpArgs::none},
+  {"MULADDDIVMODR", "A981", TvmOpArgs::none},
+  {"MULADDDIVMODC", "A982", TvmOpArgs::none},
+  {"MULRSHIFT", "A9A4", TvmOpArgs::none},
+  {"MULRSHIFTR", "A9A5", TvmOpArgs::none},
+  {"MULRSHIFTC", "A9A6", TvmOpArgs::none},
+  {"MULMODPOW2", "A9A8", TvmOpArgs::none},
+  {"MULMODPOW2R", "A9A9", TvmOpArgs::none},
+  {"MULMODPOW2C", "A9AA", TvmOpArgs::none},
+  {"MULRSHIFTMOD", "A9AC", TvmOpArgs::none},
+  {"MULRSHIFTRMOD", "A9AD", TvmOpArgs::none},
+  {"MULRSHIFTCMOD", "A9AE", TvmOpArgs::none},
+  {"MULADDRSHIFTMOD", "A9A0", TvmOpArgs::none},
+  {"MULADDRSHIFTRMOD", "A9A1", TvmOpArgs::none},
+  {"MULADDRSHIFTCMOD", "A9A2", TvmOpArgs::none},
+  {"MULRSHIFT#", "A9B4", TvmOpArgs::u8_minus1},
+  {"MULRSHIFTR#", "A9B5", TvmOpArgs::u8_minus1},
+  {"MULRSHIFTC#", "A9B6", TvmOpArgs::u8_minus1},
+  {"MULMODPOW2#", "A9B8", TvmOpArgs::u8_minus1},
+  {"MULMODPOW2R#", "A9B9", TvmOpArgs::u8_minus1},
+  {"MULMODPOW2C#", "A9BA", TvmOpArgs::u8_minus1},
+  {"MULRSHIFT#MOD", "A9BC", TvmOpArgs::u8_minus1},
+  {"MULRSHIFTR#MOD", "A9BD", TvmOpArgs::u8_minus1},
+  {"MULRSHIFTC#MOD", "A9BE", TvmOpArgs::u8_minus1},
+  {"MULADDRSHIFT#MOD", "A9B0", TvmOpArgs::u8_minus1},
+  {"MULADDRSHIFTR#MOD", "A9B1", TvmOpArgs::u8_minus1},
+  {"MULADDRSHIFTC#MOD", "A9B2", TvmOpArgs::u8_minus1},
+  {"LSHIFTDIV", "A9C4", TvmOpArgs::none},
+  {"LSHIFTDIVR", "A9C5", TvmOpArgs::none},
+  {"LSHIFTDIVC", "A9C6", TvmOpArgs::none},
+  {"LSHIFTMOD", "A9C8", TvmOpArgs::none},
+  {"LSHIFTMODR", "A9C9", TvmOpArgs::none},
+  {"LSHIFTMODC", "A9CA", TvmOpArgs::none},
+  {"LSHIFTDIVMOD", "A9CC", TvmOpArgs::none},
+  {"LSHIFTDIVMODR", "A9CD", TvmOpArgs::none},
+  {"LSHIFTDIVMODC", "A9CE", TvmOpArgs::none},
+  {"LSHIFTADDDIVMOD", "A9C0", TvmOpArgs::none},
+  {"LSHIFTADDDIVMODR", "A9C1", TvmOpArgs::none},
+  {"LSHIFTADDDIVMODC", "A9C2", TvmOpArgs::none},
+  {"LSHIFT#DIV", "A9D4", TvmOpArgs::u8_minus1},
+  {"LSHIFT#DIVR", "A9D5", TvmOpArgs::u8_minus1},
+  {"LSHIFT#DIVC", "A9D6", TvmOpArgs::u8_minus1},
+  {"LSHIFT#MOD", "A9D8", TvmOpArgs::u8_minus1},
+  {"LSHIFT#MODR", "A9D9", TvmOpArgs::u8_minus1},
+  {"LSHIFT#MODC", "A9DA", TvmOpArgs::u8_minus1},
+  {"LSHIFT#DIVMOD", "A9DC", TvmOpArgs::u8_minus1},
+  {"LSHIFT#DIVMODR", "A9DD", TvmOpArgs::u8_minus1},
+  {"LSHIFT#DIVMODC", "A9DE", TvmOpArgs::u8_minus1},
+  {"LSHIFT#ADDDIVMOD", "A9D0", TvmOpArgs::u8_minus1},
+  {"LSHIFT#ADDDIVMODR", "A9D1", TvmOpArgs::u8_minus1},
+  {"LSHIFT#ADDDIVMODC", "A9D2", TvmOpArgs::u8_minus1},
+  {"LSHIFT#", "AA", TvmOpArgs::u8_minus1},
+  {"RSHIFT#", "AB", TvmOpArgs::u8_minus1},
+  {"LSHIFT", "AC", TvmOpArgs::none},
+  {"RSHIFT", "AD", TvmOpArgs::none},
+  {"POW2", "AE", TvmOpArgs::none},
+  {"AND", "B0", TvmOpArgs::none},
+  {"OR", "B1", TvmOpArgs::none},
+  {"XOR", "B2", TvmOpArgs::none},
+  {"NOT", "B3", TvmOpArgs::none},
+  {"FITS", "B4", TvmOpArgs::u8_minus1},
+  {"CHKBOOL", "B400", TvmOpArgs::none},
+  {"UFITS", "B5", TvmOpArgs::u8_minus1},
+  {"CHKBIT", "B500", TvmOpArgs::none},
+  {"FITSX", "B600", TvmOpArgs::none},
+  {"UFITSX", "B601", TvmOpArgs::none},
+  {"BITSIZE", "B602", TvmOpArgs::none},
+  {"UBITSIZE", "B603", TvmOpArgs::none},
+  {"MIN", "B608", TvmOpArgs::none},
+  {"MAX", "B609", TvmOpArgs::none},
+  {"MINMAX", "B60A", TvmOpArgs::none},
+  {"INTSORT2", "B60A", TvmOpArgs::none},
+  {"ABS", "B60B", TvmOpArgs::none},
+  {"QUIET", "B7", TvmOpArgs::none},
+  {"QADD", "B7A0", TvmOpArgs::none},
+  {"QSUB", "B7A1", TvmOpArgs::none},
+  {"QSUBR", "B7A2", TvmOpArgs::none},
+  {"QNEGATE", "B7A3", TvmOpArgs::none},
+  {"QINC", "B7A4", TvmOpArgs::none},
+  {"QDEC", "B7A5", TvmOpArgs::none},
+  {"QMUL", "B7A8", TvmOpArgs::none},
+  {"QDIV", "B7A904", TvmOpArgs::none},
+  {"QDIVR", "B7A905", TvmOpArgs::none},
+  {"QDIVC", "B7A906", TvmOpArgs::none},
+  {"QMOD", "B7A908", TvmOpArgs::none},
+  {"QMODR", "B7A909", TvmOpArgs::none},
+  {"QMODC", "B7A90A", TvmOpArgs::none},
+  {"QDIVMOD", "B7A90C", TvmOpArgs::none},
+  {"QDIVMODR", "B7A90D", TvmOpArgs::none},
+  {"QDIVMODC", "B7A90E", TvmOpArgs::none},
+  {"QADDDIVMOD", "B7A900", TvmOpArgs::none},
+  {"QADDDIVMODR", "B7A901", TvmOpArgs::none},
+  {"QADDDIVMODC", "B7A902", TvmOpArgs::none},
+  {"QRSHIFTR", "B7A925", TvmOpArgs::none},
+  {"QRSHIFTC", "B7A926", TvmOpArgs::none},
+  {"QMODPOW2", "B7A928", TvmOpArgs::none},
+  {"QMODPOW2R", "B7A929", TvmOpArgs::none},
+  {"QMODPOW2C", "B7A92A", TvmOpArgs::none},
+  {"QRSHIFTMOD", "B7A92C", TvmOpArgs::none},
+  {"QRSHIFTMODR", "B7A92D", TvmOpArgs::none},
+  {"QRSHIFTMODC", "B7A92E", TvmOpArgs::none},
+  {"QADDRSHIFTMOD", "B7A920", TvmOpArgs::none},
+  {"QADDRSHIFTMODR", "B7A921", TvmOpArgs::none},
+  {"QADDRSHIFTMODC", "B7A922", TvmOpArgs::none},
+  {"QRSHIFTR#", "B7A935", TvmOpArgs::u8_minus1},
+  {"QRSHIFTC#", "B7A936", TvmOpArgs::u8_minus1},
+  {"QMODPOW2#", "B7A938", TvmOpArgs::u8_minus1},
+  {"QMODPOW2R#", "B7A939", TvmOpArgs::u8_minus1},
+  {"QMODPOW2C#", "B7A93A", TvmOpArgs::u8_minus1},
+  {"QRSHIFT#MOD", "B7A93C", TvmOpArgs::u8_minus1},
+  {"QRSHIFTR#MOD", "B7A93D", TvmOpArgs::u8_minus1},
+  {"QRSHIFTC#MOD", "B7A93E", TvmOpArgs::u8_minus1},
+  {"QADDRSHIFT#MOD", "B7A930", TvmOpArgs::u8_minus1},
+  {"QADDRSHIFTR#MOD", "B7A931", TvmOpArgs::u8_minus1},
+  {"QADDRSHIFTC#MOD", "B7A932", TvmOpArgs::u8_minus1},
+  {"QMULDIV", "B7A984", TvmOpArgs::none},
+  {"QMULDIVR", "B7A985", TvmOpArgs::none},
+  {"QMULDIVC", "B7A986", TvmOpArgs::none},
+  {"QMULMOD", "B7A988", TvmOpArgs::none},
+  {"QMULMODR", "B7A989", TvmOpArgs::none},
+  {"QMULMODC", "B7A98A", TvmOpArgs::none},
+  {"QMULDIVMOD", "B7A98C", TvmOpArgs::none},
+  {"QMULDIVMODR", "B7A98D", TvmOpArgs::none},
+  {"QMULDIVMODC", "B7A98E", TvmOpArgs::none},
+  {"QMULADDDIVMOD", "B7A980", TvmOpArgs::none},
+  {"QMULADDDIVMODR", "B7A981", TvmOpArgs::none},
+  {"QMULADDDIVMODC", "B7A982", TvmOpArgs::none},
+  {"QMULRSHIFT", "B7A9A4", TvmOpArgs::none},
+  {"QMULRSHIFTR", "B7A9A5", TvmOpArgs::none},
+  {"QMULRSHIFTC", "B7A9A6", TvmOpArgs::none},
+  {"QMULMODPOW2", "B7A9A8", TvmOpArgs::none},
+  {"QMULMODPOW2R", "B7A9A9", TvmOpArgs::none},
+  {"QMULMODPOW2C", "B7A9AA", TvmOpArgs::none},
+  {"QMULRSHIFTMOD", "B7A9AC", TvmOpArgs::none},
+  {"QMULRSHIFTRMOD", "B7A9AD", TvmOpArgs::none},
+  {"QMULRSHIFTCMOD", "B7A9AE", TvmOpArgs::none},
+  {"QMULADDRSHIFTMOD", "B7A9A0", TvmOpArgs::none},
+  {"QMULADDRSHIFTRMOD", "B7A9A1", TvmOpArgs::none},
+  {"QMULADDRSHIFTCMOD", "B7A9A2", TvmOpArgs::none},
+  {"QMULRSHIFT#", "B7A9B4", TvmOpArgs::u8_minus1},
+  {"QMULRSHIFTR#", "B7A9B5", TvmOpArgs::u8_minus1},
+  {"QMULRSHIFTC#", "B7A9B6", TvmOpArgs::u8_minus1},
+  {"QMULMODPOW2#", "B7A9B8", TvmOpArgs::u8_minus1},
+  {"QMULMODPOW2R#", "B7A9B9", TvmOpArgs::u8_minus1},
+  {"QMULMODPOW2C#", "B7A9BA", TvmOpArgs::u8_minus1},
+  {"QMULRSHIFT#MOD", "B7A9BC", TvmOpArgs::u8_minus1},
+  {"QMULRSHIFTR#MOD", "B7A9BD", TvmOpArgs::u8_minus1},
+  {"QMULRSHIFTC#MOD", "B7A9BE", TvmOpArgs::u8_minus1},
+  {"QMULADDRSHIFT#MOD", "B7A9B0", TvmOpArgs::u8_minus1},
+  {"QMULADDRSHIFTR#MOD", "B7A9B1", TvmOpArgs::u8_minus1},
+  {"QMULADDRSHIFTC#MOD", "B7A9B2", TvmOpArgs::u8_minus1},
+  {"QLSHIFTDIV", "B7A9C4", TvmOpArgs::none},
+  {"QLSHIFTDIVR", "B7A9C5", TvmOpArgs::none},
+  {"QLSHIFTDIVC", "B7A9C6", TvmOpArgs::none},
+  {"QLSHIFTMOD", "B7A9C8", TvmOpArgs::none},
+  {"QLSHIFTMODR", "B7A9C9", TvmOpArgs::none},
+  {"QLSHIFTMODC", "B7A9CA", TvmOpArgs::none},
+  {"QLSHIFTDIVMOD", "B7A9CC", TvmOpArgs::none},
+  {"QLSHIFTDIVMODR", "B7A9CD", TvmOpArgs::none},
+  {"QLSHIFTDIVMODC", "B7A9CE", TvmOpArgs::none},
+  {"QLSHIFTADDDIVMOD", "B7A9C0", TvmOpArgs::none},
+  {"QLSHIFTADDDIVMODR", "B7A9C1", TvmOpArgs::none},
+  {"QLSHIFTADDDIVMODC", "B7A9C2", TvmOpArgs::none},
+  {"QLSHIFT#DIV", "B7A9D4", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#DIVR", "B7A9D5", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#DIVC", "B7A9D6", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#MOD", "B7A9D8", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#MODR", "B7A9D9", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#MODC", "B7A9DA", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#DIVMOD", "B7A9DC", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#DIVMODR", "B7A9DD", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#DIVMODC", "B7A9DE", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#ADDDIVMOD", "B7A9D0", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#ADDDIVMODR", "B7A9D1", TvmOpArgs::u8_minus1},
+  {"QLSHIFT#ADDDIVMODC", "B7A9D2", TvmOpArgs::u8_minus1},
+  {"QLSHIFT", "B7AC", TvmOpArgs::none},
+  {"QRSHIFT", "B7AD", TvmOpArgs::none},
+  {"QPOW2", "B7AE", TvmOpArgs::none},
+  {"QAND", "B7B0", TvmOpArgs::none},
+  {"QOR", "B7B1", TvmOpArgs::none},
+  {"QXOR", "B7B2", TvmOpArgs::none},
+  {"QNOT", "B7B3", TvmOpArgs::none},
+  {"QFITS", "B7B4", TvmOpArgs::u8_minus1},
+  {"QUFITS", "B7B5", TvmOpArgs::u8_minus1},
+  {"QFITSX", "B7B600", TvmOpArgs::none},
+  {"QUFITSX", "B7B601", TvmOpArgs::none},
+  {"SGN", "B8", TvmOpArgs::none},
+  {"LESS", "B9", TvmOpArgs::none},
+  {"EQUAL", "BA", TvmOpArgs::none},
+  {"LEQ", "BB", TvmOpArgs::none},
+  {"GREATER", "BC", TvmOpArgs::none},
+  {"NEQ", "BD", TvmOpArgs::none},
+  {"GEQ", "BE", TvmOpArgs::none},
+  {"CMP", "BF", TvmOpArgs::none},
+  {"EQINT", "C0", TvmOpArgs::i8_or_pushint, "BA"},
+  {"ISZERO", "C000", TvmOpArgs::none},
+  {"LESSINT", "C1", TvmOpArgs::i8_or_pushint, "B9"},
+  {"ISNEG", "C100", TvmOpArgs::none},
+  {"ISNPOS", "C101", TvmOpArgs::none},
+  {"GTINT", "C2", TvmOpArgs::i8_or_pushint, "BC"},
+  {"ISPOS", "C200", TvmOpArgs::none},
+  {"ISNNEG", "C2FF", TvmOpArgs::none},
+  {"NEQINT", "C3", TvmOpArgs::i8_or_pushint, "BD"},
+  {"ISNZERO", "C300", TvmOpArgs::none},
+  {"ISNAN", "C4", TvmOpArgs::none},
+  {"CHKNAN", "C5", TvmOpArgs::none},
+  {"SEMPTY", "C700", TvmOpArgs::none},
+  {"SDEMPTY", "C701", TvmOpArgs::none},
+  {"SREMPTY", "C702", TvmOpArgs::none},
+  {"SDFIRST", "C703", TvmOpArgs::none},
+  {"SDLEXCMP", "C704", TvmOpArgs::none},
+  {"SDEQ", "C705", TvmOpArgs::none},
+  {"SDPFX", "C708", TvmOpArgs::none},
+  {"SDPFXREV", "C709", TvmOpArgs::none},
+  {"SDPPFX", "C70A", TvmOpArgs::none},
+  {"SDPPFXREV", "C70B", TvmOpArgs::none},
+  {"SDSFX", "C70C", TvmOpArgs::none},
+  {"SDSFXREV", "C70D", TvmOpArgs::none},
+  {"SDPSFX", "C70E", TvmOpArgs::none},
+  {"SDPSFXREV", "C70F", TvmOpArgs::none},
+  {"SDCNTLEAD0", "C710", TvmOpArgs::none},
+  {"SDCNTLEAD1", "C711", TvmOpArgs::none},
+  {"SDCNTTRAIL0", "C712", TvmOpArgs::none},
+  {"SDCNTTRAIL1", "C713", TvmOpArgs::none},
+  {"NEWC", "C8", TvmOpArgs::none},
+  {"ENDC", "C9", TvmOpArgs::none},
+  {"STI", "CA", TvmOpArgs::u8_minus1},
+  {"STU", "CB", TvmOpArgs::u8_minus1},
+  {"STREF", "CC", TvmOpArgs::none},
+  {"STBREFR", "CD", TvmOpArgs::none},
+  {"ENDCST", "CD", TvmOpArgs::none},
+  {"STSLICE", "CE", TvmOpArgs::none},
+  {"STIX", "CF00", TvmOpArgs::none},
+  {"STUX", "CF01", TvmOpArgs::none},
+  {"STIXR", "CF02", TvmOpArgs::none},
+  {"STUXR", "CF03", TvmOpArgs::none},
+  {"STIXQ", "CF04", TvmOpArgs::none},
+  {"STUXQ", "CF05", TvmOpArgs::none},
+  {"STIXRQ", "CF06", TvmOpArgs::none},
+  {"STUXRQ", "CF07", TvmOpArgs::none},
+  {"STI_l", "CF08", TvmOpArgs::u8_minus1},
+  {"STU_l", "CF09", TvmOpArgs::u8_minus1},
+  {"STIR", "CF0A", TvmOpArgs::u8_minus1},
+  {"STUR", "CF0B", TvmOpArgs::u8_minus1},
+  {"STIQ", "CF0C", TvmOpArgs::u8_minus1},
+  {"STUQ", "CF0D", TvmOpArgs::u8_minus1},
+  {"STIRQ", "CF0E", TvmOpArgs::u8_minus1},
+  {"STURQ", "CF0F", TvmOpArgs::u8_minus1},
+  {"STREF_l", "CF10", TvmOpArgs::none},
+  {"STBREF", "CF11", TvmOpArgs::none},
+  {"STSLICE_l", "CF12", TvmOpArgs::none},
+  {"STB", "CF13", TvmOpArgs::none},
+  {"STREFR", "CF14", TvmOpArgs::none},
+  {"STBREFR_l", "CF15", TvmOpArgs::none},
+  {"STSLICER", "CF16", TvmOpArgs::none},
+  {"STBR", "CF17", TvmOpArgs::none},
+  {"BCONCAT", "CF17", TvmOpArgs::none},
+  {"STREFQ", "CF18", TvmOpArgs::none},
+  {"STBREFQ", "CF19", TvmOpArgs::none},
+  {"STSLICEQ", "CF1A", TvmOpArgs::none},
+  {"STBQ", "CF1B", TvmOpArgs::none},
+  {"STREFRQ", "CF1C", TvmOpArgs::none},
+  {"STBREFRQ", "CF1D", TvmOpArgs::none},
+  {"STSLICERQ", "CF1E", TvmOpArgs::none},
+  {"STBRQ", "CF1F", TvmOpArgs::none},
+  {"BCONCATQ", "CF1F", TvmOpArgs::none},
+  {"STREFCONST", "CF20", TvmOpArgs::ref},
+  {"ENDXC", "CF23", TvmOpArgs::none},
+  {"STILE4", "CF28", TvmOpArgs::none},
+  {"STULE4", "CF29", TvmOpArgs::none},
+  {"STILE8", "CF2A", TvmOpArgs::none},
+  {"STULE8", "CF2B", TvmOpArgs::none},
+  {"BDEPTH", "CF30", TvmOpArgs::none},
+  {"BBITS", "CF31", TvmOpArgs::none},
+  {"BREFS", "CF32", TvmOpArgs::none},
+  {"BBITREFS", "CF33", TvmOpArgs::none},
+  {"BREMBITS", "CF35", TvmOpArgs::none},
+  {"BREMREFS", "CF36", TvmOpArgs::none},
+  {"BREMBITREFS", "CF37", TvmOpArgs::none},
+  {"BCHKBITS#", "CF38", TvmOpArgs::u8_minus1},
+  {"BCHKBITS", "CF39", TvmOpArgs::none},
+  {"BCHKREFS", "CF3A", TvmOpArgs::none},
+  {"BCHKBITREFS", "CF3B", TvmOpArgs::none},
+  {"BCHKBITSQ#", "CF3C", TvmOpArgs::u8_minus1},
+  {"BCHKBITSQ", "CF3D", TvmOpArgs::none},
+  {"BCHKREFSQ", "CF3E", TvmOpArgs::none},
+  {"BCHKBITREFSQ", "CF3F", TvmOpArgs::none},
+  {"STZEROES", "CF40", TvmOpArgs::none},
+  {"STONES", "CF41", TvmOpArgs::none},
+  {"STSAME", "CF42", TvmOpArgs::none},
+  {"STZERO", "CF81", TvmOpArgs::none},
+  {"STONE", "CF83", TvmOpArgs::none},
+  {"CTOS", "D0", TvmOpArgs::none},
+  {"ENDS", "D1", TvmOpArgs::none},
+  {"LDI", "D2", TvmOpArgs::u8_minus1},
+  {"LDU", "D3", TvmOpArgs::u8_minus1},
+  {"LDREF", "D4", TvmOpArgs::none},
+  {"LDREFRTOS", "D5", TvmOpArgs::none},
+  {"LDSLICE", "D6", TvmOpArgs::u8_minus1},
+  {"LDIX", "D700", TvmOpArgs::none},
+  {"LDUX", "D701", TvmOpArgs::none},
+  {"PLDIX", "D702", TvmOpArgs::none},
+  {"PLDUX", "D703", TvmOpArgs::none},
+  {"LDIXQ", "D704", TvmOpArgs::none},
+  {"LDUXQ", "D705", TvmOpArgs::none},
+  {"PLDIXQ", "D706", TvmOpArgs::none},
+  {"PLDUXQ", "D707", TvmOpArgs::none},
+  {"LDI_l", "D708", TvmOpArgs::u8_minus1},
+  {"LDU_l", "D709", TvmOpArgs::u8_minus1},
+  {"PLDI", "D70A", TvmOpArgs::u8_minus1},
+  {"PLDU", "D70B", TvmOpArgs::u8_minus1},
+  {"LDIQ", "D70C", TvmOpArgs::u8_minus1},
+  {"LDUQ", "D70D", TvmOpArgs::u8_minus1},
+  {"PLDIQ", "D70E", TvmOpArgs::u8_minus1},
+  {"PLDUQ", "D70F", TvmOpArgs::u8_minus1},
+  {"LDSLICEX", "D718", TvmOpArgs::none},
+  {"PLDSLICEX", "D719", TvmOpArgs::none},
+  {"LDSLICEXQ", "D71A", TvmOpArgs::none},
+  {"PLDSLICEXQ", "D71B", TvmOpArgs::none},
+  {"LDSLICE_l", "D71C", TvmOpArgs::u8_minus1},
+  {"PLDSLICE", "D71D", TvmOpArgs::u8_minus1},
+  {"LDSLICEQ", "D71E", TvmOpArgs::u8_minus1},
+  {"PLDSLICEQ", "D71F", TvmOpArgs::u8_minus1},
+  {"SDCUTFIRST", "D720", TvmOpArgs::none},
+  {"SDSKIPFIRST", "D721", TvmOpArgs::none},
+  {"SDCUTLAST", "D722", TvmOpArgs::none},
+  {"SDSKIPLAST", "D723", TvmOpArgs::none},
+  {"SDSUBSTR", "D724", TvmOpArgs::none},
+  {"SDBEGINSX", "D726", TvmOpArgs::none},
+  {"SDBEGINSXQ", "D727", TvmOpArgs::none},
+  {"SCUTFIRST", "D730", TvmOpArgs::none},
+  {"SSKIPFIRST", "D731", TvmOpArgs::none},
+  {"SCUTLAST", "D732", TvmOpArgs::none},
+  {"SSKIPLAST", "D733", TvmOpArgs::none},
+  {"SUBSLICE", "D734", TvmOpArgs::none},
+  {"SPLIT", "D736", TvmOpArgs::none},
+  {"SPLITQ", "D737", TvmOpArgs::none},
+  {"XCTOS", "D739", TvmOpArgs::none},
+  {"XLOAD", "D73A", TvmOpArgs::none},
+  {"XLOADQ", "D73B", TvmOpArgs::none},
+  {"SCHKBITS", "D741", TvmOpArgs::none},
+  {"SCHKREFS", "D742", TvmOpArgs::none},
+  {"SCHKBITREFS", "D743", TvmOpArgs::none},
+  {"SCHKBITSQ", "D745", TvmOpArgs::none},
+  {"SCHKREFSQ", "D746", TvmOpArgs::none},
+  {"SCHKBITREFSQ", "D747", TvmOpArgs::none},
+  {"PLDREFVAR", "D748", TvmOpArgs::none},
+  {"SBITS", "D749", TvmOpArgs::none},
+  {"SREFS", "D74A", TvmOpArgs::none},
+  {"SBITREFS", "D74B", TvmOpArgs::none},
+  {"PLDREF", "D74C", TvmOpArgs::none},
+  {"LDILE4", "D750", TvmOpArgs::none},
+  {"LDULE4", "D751", TvmOpArgs::none},
+  {"LDILE8", "D752", TvmOpArgs::none},
+  {"LDULE8", "D753", TvmOpArgs::none},
+  {"PLDILE4", "D754", TvmOpArgs::none},
+  {"PLDULE4", "D755", TvmOpArgs::none},
+  {"PLDILE8", "D756", TvmOpArgs::none},
+  {"PLDULE8", "D757", TvmOpArgs::none},
+  {"LDILE4Q", "D758", TvmOpArgs::none},
+  {"LDULE4Q", "D759", TvmOpArgs::none},
+  {"LDILE8Q", "D75A", TvmOpArgs::none},
+  {"LDULE8Q", "D75B", TvmOpArgs::none},
+  {"PLDILE4Q", "D75C", TvmOpArgs::none},
+  {"PLDULE4Q", "D75D", TvmOpArgs::none},
+  {"PLDILE8Q", "D75E", TvmOpArgs::none},
+  {"PLDULE8Q", "D75F", TvmOpArgs::none},
+  {"LDZEROES", "D760", TvmOpArgs::none},
+  {"LDONES", "D761", TvmOpArgs::none},
+  {"LDSAME", "D762", TvmOpArgs::none},
+  {"SDEPTH", "D764", TvmOpArgs::none},
+  {"CDEPTH", "D765", TvmOpArgs::none},
+  {"CLEVEL", "D766", TvmOpArgs::none},
+  {"CLEVELMASK", "D767", TvmOpArgs::none},
+  {"CHASHIX", "D770", TvmOpArgs::none},
+  {"CDEPTHIX", "D771", TvmOpArgs::none},
+  {"EXECUTE", "D8", TvmOpArgs::none},
+  {"CALLX", "D8", TvmOpArgs::none},
+  {"JMPX", "D9", TvmOpArgs::none},
+  {"JMPXARGS", "DB1", TvmOpArgs::u4},
+  {"RETARGS", "DB2", TvmOpArgs::u4},
+  {"RET", "DB30", TvmOpArgs::none},
+  {"RETTRUE", "DB30", TvmOpArgs::none},
+  {"RETALT", "DB31", TvmOpArgs::none},
+  {"RETFALSE", "DB31", TvmOpArgs::none},
+  {"BRANCH", "DB32", TvmOpArgs::none},
+  {"RETBOOL", "DB32", TvmOpArgs::none},
+  {"CALLCC", "DB34", TvmOpArgs::none},
+  {"JMPXDATA", "DB35", TvmOpArgs::none},
+  {"CALLXVARARGS", "DB38", TvmOpArgs::none},
+  {"RETVARARGS", "DB39", TvmOpArgs::none},
+  {"JMPXVARARGS", "DB3A", TvmOpArgs::none},
+  {"CALLCCVARARGS", "DB3B", TvmOpArgs::none},
+  {"CALLREF", "DB3C", TvmOpArgs::ref},
+  {"JMPREF", "DB3D", TvmOpArgs::ref},
+  {"JMPREFDATA", "DB3E", TvmOpArgs::ref},
+  {"RETDATA", "DB3F", TvmOpArgs::none},
+  {"RUNVM", "DB4", TvmOpArgs::u12},
+  {"RUNVMX", "DB50", TvmOpArgs::none},
+  {"IFRET", "DC", TvmOpArgs::none},
+  {"IFNOTRET", "DD", TvmOpArgs::none},
+  {"IF", "DE", TvmOpArgs::none},
+  {"IFNOT", "DF", TvmOpArgs::none},
+  {"IF:", "DD", TvmOpArgs::none},
+  {"IFNOT:", "DC", TvmOpArgs::none},
+  {"IFJMP", "E0", TvmOpArgs::none},
+  {"IFNOTJMP", "E1", TvmOpArgs::none},
+  {"IFELSE", "E2", TvmOpArgs::none},
+  {"IFREF", "E300", TvmOpArgs::ref},
+  {"IFNOTREF", "E301", TvmOpArgs::ref},
+  {"IFJMPREF", "E302", TvmOpArgs::ref},
+  {"IFNOTJMPREF", "E303", TvmOpArgs::ref},
+  {"IFREFELSE", "E30D", TvmOpArgs::ref},
+  {"IFELSEREF", "E30E", TvmOpArgs::ref},
+  {"IFREFELSEREF", "E30F", TvmOpArgs::ref_ref},
+  {"CONDSEL", "E304", TvmOpArgs::none},
+  {"CONDSELCHK", "E305", TvmOpArgs::none},
+  {"IFRETALT", "E308", TvmOpArgs::none},
+  {"IFNOTRETALT", "E309", TvmOpArgs::none},
+  {"REPEAT", "E4", TvmOpArgs::none},
+  {"REPEATEND", "E5", TvmOpArgs::none},
+  {"REPEAT:", "E5", TvmOpArgs::none},
+  {"UNTIL", "E6", TvmOpArgs::none},
+  {"UNTILEND", "E7", TvmOpArgs::none},
+  {"UNTIL:", "E7", TvmOpArgs::none},
+  {"WHILE", "E8", TvmOpArgs::none},
+  {"WHILEEND", "E9", TvmOpArgs::none},
+  {"AGAIN", "EA", TvmOpArgs::none},
+  {"AGAINEND", "EB", TvmOpArgs::none},
+  {"AGAIN:", "EB", TvmOpArgs::none},
+  {"REPEATBRK", "E314", TvmOpArgs::none},
+  {"REPEATENDBRK", "E315", TvmOpArgs::none},
+  {"UNTILBRK", "E316", TvmOpArgs::none},
+  {"UNTILENDBRK", "E317", TvmOpArgs::none},
+  {"UNTILBRK:", "E317", TvmOpArgs::none},
+  {"WHILEBRK", "E318", TvmOpArgs::none},
+  {"WHILEENDBRK", "E319", TvmOpArgs::none},
+  {"AGAINBRK", "E31A", TvmOpArgs::none},
+  {"AGAINENDBRK", "E31B", TvmOpArgs::none},
+  {"AGAINBRK:", "E31B", TvmOpArgs::none},
+  {"RETURNARGS", "ED0", TvmOpArgs::u4},
+  {"RETURNVARARGS", "ED10", TvmOpArgs::none},
+  {"SETCONTVARARGS", "ED11", TvmOpArgs::none},
+  {"SETNUMVARARGS", "ED12", TvmOpArgs::none},
+  {"BLESS", "ED1E", TvmOpArgs::none},
+  {"BLESSVARARGS", "ED1F", TvmOpArgs::none},
+  {"SETCONTCTR", "ED6", TvmOpArgs::creg},
+  {"SETCONT", "ED6", TvmOpArgs::creg},
+  {"SETRETCTR", "ED7", TvmOpArgs::creg},
+  {"SETALTCTR", "ED8", TvmOpArgs::creg},
+  {"POPSAVE", "ED9", TvmOpArgs::creg},
+  {"POPCTRSAVE", "ED9", TvmOpArgs::creg},
+  {"SAVE", "EDA", TvmOpArgs::creg},
+  {"SAVECTR", "EDA", TvmOpArgs::creg},
+  {"SAVEALT", "EDB", TvmOpArgs::creg},
+  {"SAVEALTCTR", "EDB", TvmOpArgs::creg},
+  {"SAVEBOTH", "EDC", TvmOpArgs::creg},
+  {"SAVEBOTHCTR", "EDC", TvmOpArgs::creg},
+  {"PUSHCTRX", "EDE0", TvmOpArgs::none},
+  {"POPCTRX", "EDE1", TvmOpArgs::none},
+  {"SETCONTCTRX", "EDE2", TvmOpArgs::none},
+  {"SETCONTCTRMANY", "EDE3", TvmOpArgs::u8},
+  {"SETCONTMANY", "EDE3", TvmOpArgs::u8},
+  {"SETCONTCTRMANYX", "EDE4", TvmOpArgs::none},
+  {"SETCONTMANYX", "EDE4", TvmOpArgs::none},
+  {"BOOLAND", "EDF0", TvmOpArgs::none},
+  {"COMPOS", "EDF0", TvmOpArgs::none},
+  {"BOOLOR", "EDF1", TvmOpArgs::none},
+  {"COMPOSALT", "EDF1", TvmOpArgs::none},
+  {"COMPOSBOTH", "EDF2", TvmOpArgs::none},
+  {"ATEXIT", "EDF3", TvmOpArgs::none},
+  {"ATEXITALT", "EDF4", TvmOpArgs::none},
+  {"SETEXITALT", "EDF5", TvmOpArgs::none},
+  {"THENRET", "EDF6", TvmOpArgs::none},
+  {"THENRETALT", "EDF7", TvmOpArgs::none},
+  {"INVERT", "EDF8", TvmOpArgs::none},
+  {"BOOLEVAL", "EDF9", TvmOpArgs::none},
+  {"SAMEALT", "EDFA", TvmOpArgs::none},
+  {"SAMEALTSAVE", "EDFB", TvmOpArgs::none},
+  {"THROWANY", "F2F0", TvmOpArgs::none},
+  {"THROWARGANY", "F2F1", TvmOpArgs::none},
+  {"THROWANYIF", "F2F2", TvmOpArgs::none},
+  {"THROWARGANYIF", "F2F3", TvmOpArgs::none},
+  {"THROWANYIFNOT", "F2F4", TvmOpArgs::none},
+  {"THROWARGANYIFNOT", "F2F5", TvmOpArgs::none},
+  {"TRY", "F2FF", TvmOpArgs::none},
+  {"TRYARGS", "F3", TvmOpArgs::u4_u4},
+  {"NEWDICT", "6D", TvmOpArgs::none},
+  {"DICTEMPTY", "6E", TvmOpArgs::none},
+  {"STDICTS", "CE", TvmOpArgs::none},
+  {"STDICT", "F400", TvmOpArgs::none},
+  {"STOPTREF", "F400", TvmOpArgs::none},
+  {"SKIPDICT", "F401", TvmOpArgs::none},
+  {"SKIPOPTREF", "F401", TvmOpArgs::none},
+  {"LDDICTS", "F402", TvmOpArgs::none},
+  {"PLDDICTS", "F403", TvmOpArgs::none},
+  {"LDDICT", "F404", TvmOpArgs::none},
+  {"LDOPTREF", "F404", TvmOpArgs::none},
+  {"PLDDICT", "F405", TvmOpArgs::none},
+  {"PLDOPTREF", "F405", TvmOpArgs::none},
+  {"LDDICTQ", "F406", TvmOpArgs::none},
+  {"PLDDICTQ", "F407", TvmOpArgs::none},
+  {"DICTGET", "F40A", TvmOpArgs::none},
+  {"DICTGETREF", "F40B", TvmOpArgs::none},
+  {"DICTIGET", "F40C", TvmOpArgs::none},
+  {"DICTIGETREF", "F40D", TvmOpArgs::none},
+  {"DICTUGET", "F40E", TvmOpArgs::none},
+  {"DICTUGETREF", "F40F", TvmOpArgs::none},
+  {"DICTSET", "F412", TvmOpArgs::none},
+  {"DICTSETREF", "F413", TvmOpArgs::none},
+  {"DICTISET", "F414", TvmOpArgs::none},
+  {"DICTISETREF", "F415", TvmOpArgs::none},
+  {"DICTUSET", "F416", TvmOpArgs::none},
+  {"DICTUSETREF", "F417", TvmOpArgs::none},
+  {"DICTSETGET", "F41A", TvmOpArgs::none},
+  {"DICTSETGETREF", "F41B", TvmOpArgs::none},
+  {"DICTISETGET", "F41C", TvmOpArgs::none},
+  {"DICTISETGETREF", "F41D", TvmOpArgs::none},
+  {"DICTUSETGET", "F41E", TvmOpArgs::none},
+  {"DICTUSETGETREF", "F41F", TvmOpArgs::none},
+  {"DICTREPLACE", "F422", TvmOpArgs::none},
+  {"DICTREPLACEREF", "F423", TvmOpArgs::none},
+  {"DICTIREPLACE", "F424", TvmOpArgs::none},
+  {"DICTIREPLACEREF", "F425", TvmOpArgs::none},
+  {"DICTUREPLACE", "F426", TvmOpArgs::none},
+  {"DICTUREPLACEREF", "F427", TvmOpArgs::none},
+  {"DICTREPLACEGET", "F42A", TvmOpArgs::none},
+  {"DICTREPLACEGETREF", "F42B", TvmOpArgs::none},
+  {"DICTIREPLACEGET", "F42C", TvmOpArgs::none},
+  {"DICTIREPLACEGETREF", "F42D", TvmOpArgs::none},
+  {"DICTUREPLACEGET", "F42E", TvmOpArgs::none},
+  {"DICTUREPLACEGETREF", "F42F", TvmOpArgs::none},
+  {"DICTADD", "F432", TvmOpArgs::none},
+  {"DICTADDREF", "F433", TvmOpArgs::none},
+  {"DICTIADD", "F434", TvmOpArgs::none},
+  {"DICTIADDREF", "F435", TvmOpArgs::none},
+  {"DICTUADD", "F436", TvmOpArgs::none},
+  {"DICTUADDREF", "F437", TvmOpArgs::none},
+  {"DICTADDGET", "F43A", TvmOpArgs::none},
+  {"DICTADDGETREF", "F43B", TvmOpArgs::none},
+  {"DICTIADDGET", "F43C", TvmOpArgs::none},
+  {"DICTIADDGETREF", "F43D", TvmOpArgs::none},
+  {"DICTUADDGET", "F43E", TvmOpArgs::none},
+  {"DICTUADDGETREF", "F43F", TvmOpArgs::none},
+  {"DICTSETB", "F441", TvmOpArgs::none},
+  {"DICTISETB", "F442", TvmOpArgs::none},
+  {"DICTUSETB", "F443", TvmOpArgs::none},
+  {"DICTSETGETB", "F445", TvmOpArgs::none},
+  {"DICTISETGETB", "F446", TvmOpArgs::none},
+  {"DICTUSETGETB", "F447", TvmOpArgs::none},
+  {"DICTREPLACEB", "F449", TvmOpArgs::none},
+  {"DICTIREPLACEB", "F44A", TvmOpArgs::none},
+  {"DICTUREPLACEB", "F44B", TvmOpArgs::none},
+  {"DICTREPLACEGETB", "F44D", TvmOpArgs::none},
+  {"DICTIREPLACEGETB", "F44E", TvmOpArgs::none},
+  {"DICTUREPLACEGETB", "F44F", TvmOpArgs::none},
+  {"DICTADDB", "F451", TvmOpArgs::none},
+  {"DICTIADDB", "F452", TvmOpArgs::none},
+  {"DICTUADDB", "F453", TvmOpArgs::none},
+  {"DICTADDGETB", "F455", TvmOpArgs::none},
+  {"DICTIADDGETB", "F456", TvmOpArgs::none},
+  {"DICTUADDGETB", "F457", TvmOpArgs::none},
+  {"DICTDEL", "F459", TvmOpArgs::none},
+  {"DICTIDEL", "F45A", TvmOpArgs::none},
+  {"DICTUDEL", "F45B", TvmOpArgs::none},
+  {"DICTDELGET", "F462", TvmOpArgs::none},
+  {"DICTDELGETREF", "F463", TvmOpArgs::none},
+  {"DICTIDELGET", "F464", TvmOpArgs::none},
+  {"DICTIDELGETREF", "F465", TvmOpArgs::none},
+  {"DICTUDELGET", "F466", TvmOpArgs::none},
+  {"DICTUDELGETREF", "F467", TvmOpArgs::none},
+  {"DICTGETOPTREF", "F469", TvmOpArgs::none},
+  {"DICTIGETOPTREF", "F46A", TvmOpArgs::none},
+  {"DICTUGETOPTREF", "F46B", TvmOpArgs::none},
+  {"DICTSETGETOPTREF", "F46D", TvmOpArgs::none},
+  {"DICTISETGETOPTREF", "F46E", TvmOpArgs::none},
+  {"DICTUSETGETOPTREF", "F46F", TvmOpArgs::none},
+  {"PFXDICTSET", "F470", TvmOpArgs::none},
+  {"PFXDICTREPLACE", "F471", TvmOpArgs::none},
+  {"PFXDICTADD", "F472", TvmOpArgs::none},
+  {"PFXDICTDEL", "F473", TvmOpArgs::none},
+  {"DICTGETNEXT", "F474", TvmOpArgs::none},
+  {"DICTGETNEXTEQ", "F475", TvmOpArgs::none},
+  {"DICTGETPREV", "F476", TvmOpArgs::none},
+  {"DICTGETPREVEQ", "F477", TvmOpArgs::none},
+  {"DICTIGETNEXT", "F478", TvmOpArgs::none},
+  {"DICTIGETNEXTEQ", "F479", TvmOpArgs::none},
+  {"DICTIGETPREV", "F47A", TvmOpArgs::none},
+  {"DICTIGETPREVEQ", "F47B", TvmOpArgs::none},
+  {"DICTUGETNEXT", "F47C", TvmOpArgs::none},
+  {"DICTUGETNEXTEQ", "F47D", TvmOpArgs::none},
+  {"DICTUGETPREV", "F47E", TvmOpArgs::none},
+  {"DICTUGETPREVEQ", "F47F", TvmOpArgs::none},
+  {"DICTMIN", "F482", TvmOpArgs::none},
+  {"DICTMINREF", "F483", TvmOpArgs::none},
+  {"DICTIMIN", "F484", TvmOpArgs::none},
+  {"DICTIMINREF", "F485", TvmOpArgs::none},
+  {"DICTUMIN", "F486", TvmOpArgs::none},
+  {"DICTUMINREF", "F487", TvmOpArgs::none},
+  {"DICTMAX", "F48A", TvmOpArgs::none},
+  {"DICTMAXREF", "F48B", TvmOpArgs::none},
+  {"DICTIMAX", "F48C", TvmOpArgs::none},
+  {"DICTIMAXREF", "F48D", TvmOpArgs::none},
+  {"DICTUMAX", "F48E", TvmOpArgs::none},
+  {"DICTUMAXREF", "F48F", TvmOpArgs::none},
+  {"DICTREMMIN", "F492", TvmOpArgs::none},
+  {"DICTREMMINREF", "F493", TvmOpArgs::none},
+  {"DICTIREMMIN", "F494", TvmOpArgs::none},
+  {"DICTIREMMINREF", "F495", TvmOpArgs::none},
+  {"DICTUREMMIN", "F496", TvmOpArgs::none},
+  {"DICTUREMMINREF", "F497", TvmOpArgs::none},
+  {"DICTREMMAX", "F49A", TvmOpArgs::none},
+  {"DICTREMMAXREF", "F49B", TvmOpArgs::none},
+  {"DICTIREMMAX", "F49C", TvmOpArgs::none},
+  {"DICTIREMMAXREF", "F49D", TvmOpArgs::none},
+  {"DICTUREMMAX", "F49E", TvmOpArgs::none},
+  {"DICTUREMMAXREF", "F49F", TvmOpArgs::none},
+  {"DICTIGETJMP", "F4A0", TvmOpArgs::none},
+  {"DICTUGETJMP", "F4A1", TvmOpArgs::none},
+  {"DICTIGETEXEC", "F4A2", TvmOpArgs::none},
+  {"DICTUGETEXEC", "F4A3", TvmOpArgs::none},
+  {"PFXDICTGETQ", "F4A8", TvmOpArgs::none},
+  {"PFXDICTGET", "F4A9", TvmOpArgs::none},
+  {"PFXDICTGETJMP", "F4AA", TvmOpArgs::none},
+  {"PFXDICTGETEXEC", "F4AB", TvmOpArgs::none},
+  {"SUBDICTGET", "F4B1", TvmOpArgs::none},
+  {"SUBDICTIGET", "F4B2", TvmOpArgs::none},
+  {"SUBDICTUGET", "F4B3", TvmOpArgs::none},
+  {"SUBDICTRPGET", "F4B5", TvmOpArgs::none},
+  {"SUBDICTIRPGET", "F4B6", TvmOpArgs::none},
+  {"SUBDICTURPGET", "F4B7", TvmOpArgs::none},
+  {"DICTIGETJMPZ", "F4BC", TvmOpArgs::none},
+  {"DICTUGETJMPZ", "F4BD", TvmOpArgs::none},
+  {"DICTIGETEXECZ", "F4BE", TvmOpArgs::none},
+  {"DICTUGETEXECZ", "F4BF", TvmOpArgs::none},
+  {"ACCEPT", "F800", TvmOpArgs::none},
+  {"SETGASLIMIT", "F801", TvmOpArgs::none},
+  {"GASCONSUMED", "F807", TvmOpArgs::none},
+  {"COMMIT", "F80F", TvmOpArgs::none},
+  {"RANDU256", "F810", TvmOpArgs::none},
+  {"RAND", "F811", TvmOpArgs::none},
+  {"SETRAND", "F814", TvmOpArgs::none},
+  {"ADDRAND", "F815", TvmOpArgs::none},
+  {"RANDOMIZE", "F815", TvmOpArgs::none},
+  {"GETPARAM", "F82", TvmOpArgs::u4},
+  {"GETPARAMLONG", "F881", TvmOpArgs::u8},
+  {"NOW", "F823", TvmOpArgs::none},
+  {"BLOCKLT", "F824", TvmOpArgs::none},
+  {"LTIME", "F825", TvmOpArgs::none},
+  {"RANDSEED", "F826", TvmOpArgs::none},
+  {"BALANCE", "F827", TvmOpArgs::none},
+  {"MYADDR", "F828", TvmOpArgs::none},
+  {"CONFIGROOT", "F829", TvmOpArgs::none},
+  {"MYCODE", "F82A", TvmOpArgs::none},
+  {"INCOMINGVALUE", "F82B", TvmOpArgs::none},
+  {"STORAGEFEES", "F82C", TvmOpArgs::none},
+  {"PREVBLOCKSINFOTUPLE", "F82D", TvmOpArgs::none},
+  {"UNPACKEDCONFIGTUPLE", "F82E", TvmOpArgs::none},
+  {"DUEPAYMENT", "F82F", TvmOpArgs::none},
+  {"INMSGPARAMS", "F88111", TvmOpArgs::none},
+  {"CONFIGDICT", "F830", TvmOpArgs::none},
+  {"CONFIGPARAM", "F832", TvmOpArgs::none},
+  {"CONFIGOPTPARAM", "F833", TvmOpArgs::none},
+  {"PREVMCBLOCKS", "F83400", TvmOpArgs::none},
+  {"PREVKEYBLOCK", "F83401", TvmOpArgs::none},
+  {"PREVMCBLOCKS_100", "F83402", TvmOpArgs::none},
+  {"GLOBALID", "F835", TvmOpArgs::none},
+  {"GETGASFEE", "F836", TvmOpArgs::none},
+  {"GETSTORAGEFEE", "F837", TvmOpArgs::none},
+  {"GETFORWARDFEE", "F838", TvmOpArgs::none},
+  {"GETPRECOMPILEDGAS", "F839", TvmOpArgs::none},
+  {"GETORIGINALFWDFEE", "F83A", TvmOpArgs::none},
+  {"GETGASFEESIMPLE", "F83B", TvmOpArgs::none},
+  {"GETFORWARDFEESIMPLE", "F83C", TvmOpArgs::none},
+  {"INMSGPARAM", "F89", TvmOpArgs::u4},
+  {"INMSG_BOUNCE", "F890", TvmOpArgs::none},
+  {"INMSG_BOUNCED", "F891", TvmOpArgs::none},
+  {"INMSG_SRC", "F892", TvmOpArgs::none},
+  {"INMSG_FWDFEE", "F893", TvmOpArgs::none},
+  {"INMSG_LT", "F894", TvmOpArgs::none},
+  {"INMSG_UTIME", "F895", TvmOpArgs::none},
+  {"INMSG_ORIGVALUE", "F896", TvmOpArgs::none},
+  {"INMSG_VALUE", "F897", TvmOpArgs::none},
+  {"INMSG_VALUEEXTRA", "F898", TvmOpArgs::none},
+  {"INMSG_STATEINIT", "F899", TvmOpArgs::none},
+  {"GETGLOBVAR", "F840", TvmOpArgs::none},
+  {"SETGLOBVAR", "F860", TvmOpArgs::none},
+  {"GETEXTRABALANCE", "F880", TvmOpArgs::none},
+  {"HASHCU", "F900", TvmOpArgs::none},
+  {"HASHSU", "F901", TvmOpArgs::none},
+  {"SHA256U", "F902", TvmOpArgs::none},
+  {"HASHEXT", "F904", TvmOpArgs::u8},
+  {"HASHEXT_SHA256", "F90400", TvmOpArgs::none},
+  {"HASHEXT_SHA512", "F90401", TvmOpArgs::none},
+  {"HASHEXT_BLAKE2B", "F90402", TvmOpArgs::none},
+  {"HASHEXT_KECCAK256", "F90403", TvmOpArgs::none},
+  {"HASHEXT_KECCAK512", "F90404", TvmOpArgs::none},
+  {"HASHEXTR", "F905", TvmOpArgs::u8},
+  {"HASHEXTR_SHA256", "F90500", TvmOpArgs::none},
+  {"HASHEXTR_SHA512", "F90501", TvmOpArgs::none},
+  {"HASHEXTR_BLAKE2B", "F90502", TvmOpArgs::none},
+  {"HASHEXTR_KECCAK256", "F90503", TvmOpArgs::none},
+  {"HASHEXTR_KECCAK512", "F90504", TvmOpArgs::none},
+  {"HASHEXTA", "F906", TvmOpArgs::u8},
+  {"HASHEXTA_SHA256", "F90600", TvmOpArgs::none},
+  {"HASHEXTA_SHA512", "F90601", TvmOpArgs::none},
+  {"HASHEXTA_BLAKE2B", "F90602", TvmOpArgs::none},
+  {"HASHEXTA_KECCAK256", "F90603", TvmOpArgs::none},
+  {"HASHEXTA_KECCAK512", "F90604", TvmOpArgs::none},
+  {"HASHEXTAR", "F907", TvmOpArgs::u8},
+  {"HASHEXTAR_SHA256", "F90700", TvmOpArgs::none},
+  {"HASHEXTAR_SHA512", "F90701", TvmOpArgs::none},
+  {"HASHEXTAR_BLAKE2B", "F90702", TvmOpArgs::none},
+  {"HASHEXTAR_KECCAK256", "F90703", TvmOpArgs::none},
+  {"HASHEXTAR_KECCAK512", "F90704", TvmOpArgs::none},
+  {"CHKSIGNU", "F910", TvmOpArgs::none},
+  {"CHKSIGNS", "F911", TvmOpArgs::none},
+  {"ECRECOVER", "F912", TvmOpArgs::none},
+  {"SECP256K1_XONLY_PUBKEY_TWEAK_ADD", "F913", TvmOpArgs::none},
+  {"P256_CHKSIGNU", "F914", TvmOpArgs::none},
+  {"P256_CHKSIGNS", "F915", TvmOpArgs::none},
+  {"RIST255_FROMHASH", "F920", TvmOpArgs::none},
+  {"RIST255_VALIDATE", "F921", TvmOpArgs::none},
+  {"RIST255_ADD", "F922", TvmOpArgs::none},
+  {"RIST255_SUB", "F923", TvmOpArgs::none},
+  {"RIST255_MUL", "F924", TvmOpArgs::none},
+  {"RIST255_MULBASE", "F925", TvmOpArgs::none},
+  {"RIST255_PUSHL", "F926", TvmOpArgs::none},
+  {"RIST255_QVALIDATE", "B7F921", TvmOpArgs::none},
+  {"RIST255_QADD", "B7F922", TvmOpArgs::none},
+  {"RIST255_QSUB", "B7F923", TvmOpArgs::none},
+  {"RIST255_QMUL", "B7F924", TvmOpArgs::none},
+  {"RIST255_QMULBASE", "B7F925", TvmOpArgs::none},
+  {"BLS_VERIFY", "F93000", TvmOpArgs::none},
+  {"BLS_AGGREGATE", "F93001", TvmOpArgs::none},
+  {"BLS_FASTAGGREGATEVERIFY", "F93002", TvmOpArgs::none},
+  {"BLS_AGGREGATEVERIFY", "F93003", TvmOpArgs::none},
+  {"BLS_G1_ADD", "F93010", TvmOpArgs::none},
+  {"BLS_G1_SUB", "F93011", TvmOpArgs::none},
+  {"BLS_G1_NEG", "F93012", TvmOpArgs::none},
+  {"BLS_G1_MUL", "F93013", TvmOpArgs::none},
+  {"BLS_G1_MULTIEXP", "F93014", TvmOpArgs::none},
+  {"BLS_G1_ZERO", "F93015", TvmOpArgs::none},
+  {"BLS_MAP_TO_G1", "F93016", TvmOpArgs::none},
+  {"BLS_G1_INGROUP", "F93017", TvmOpArgs::none},
+  {"BLS_G1_ISZERO", "F93018", TvmOpArgs::none},
+  {"BLS_G2_ADD", "F93020", TvmOpArgs::none},
+  {"BLS_G2_SUB", "F93021", TvmOpArgs::none},
+  {"BLS_G2_NEG", "F93022", TvmOpArgs::none},
+  {"BLS_G2_MUL", "F93023", TvmOpArgs::none},
+  {"BLS_G2_MULTIEXP", "F93024", TvmOpArgs::none},
+  {"BLS_G2_ZERO", "F93025", TvmOpArgs::none},
+  {"BLS_MAP_TO_G2", "F93026", TvmOpArgs::none},
+  {"BLS_G2_INGROUP", "F93027", TvmOpArgs::none},
+  {"BLS_G2_ISZERO", "F93028", TvmOpArgs::none},
+  {"BLS_PAIRING", "F93030", TvmOpArgs::none},
+  {"BLS_PUSHR", "F93031", TvmOpArgs::none},
+  {"CDATASIZEQ", "F940", TvmOpArgs::none},
+  {"CDATASIZE", "F941", TvmOpArgs::none},
+  {"SDATASIZEQ", "F942", TvmOpArgs::none},
+  {"SDATASIZE", "F943", TvmOpArgs::none},
+  {"LDGRAMS", "FA00", TvmOpArgs::none},
+  {"LDVARUINT16", "FA00", TvmOpArgs::none},
+  {"LDVARINT16", "FA01", TvmOpArgs::none},
+  {"STGRAMS", "FA02", TvmOpArgs::none},
+  {"STVARUINT16", "FA02", TvmOpArgs::none},
+  {"STVARINT16", "FA03", TvmOpArgs::none},
+  {"LDVARUINT32", "FA04", TvmOpArgs::none},
+  {"LDVARINT32", "FA05", TvmOpArgs::none},
+  {"STVARUINT32", "FA06", TvmOpArgs::none},
+  {"STVARINT32", "FA07", TvmOpArgs::none},
+  {"LDMSGADDR", "FA40", TvmOpArgs::none},
+  {"LDMSGADDRQ", "FA41", TvmOpArgs::none},
+  {"PARSEMSGADDR", "FA42", TvmOpArgs::none},
+  {"PARSEMSGADDRQ", "FA43", TvmOpArgs::none},
+  {"REWRITESTDADDR", "FA44", TvmOpArgs::none},
+  {"REWRITESTDADDRQ", "FA45", TvmOpArgs::none},
+  {"REWRITEVARADDR", "FA46", TvmOpArgs::none},
+  {"REWRITEVARADDRQ", "FA47", TvmOpArgs::none},
+  {"SENDRAWMSG", "FB00", TvmOpArgs::none},
+  {"RAWRESERVE", "FB02", TvmOpArgs::none},
+  {"RAWRESERVEX", "FB03", TvmOpArgs::none},
+  {"SETCODE", "FB04", TvmOpArgs::none},
+  {"SETLIBCODE", "FB06", TvmOpArgs::none},
+  {"CHANGELIB", "FB07", TvmOpArgs::none},
+  {"SENDMSG", "FB08", TvmOpArgs::none},
+  {"DUMPSTK", "FE00", TvmOpArgs::none},
+  {"HEXDUMP", "FE10", TvmOpArgs::none},
+  {"HEXPRINT", "FE11", TvmOpArgs::none},
+  {"BINDUMP", "FE12", TvmOpArgs::none},
+  {"BINPRINT", "FE13", TvmOpArgs::none},
+  {"STRDUMP", "FE14", TvmOpArgs::none},
+  {"STRPRINT", "FE15", TvmOpArgs::none},
+  {"DEBUGOFF", "FE1E", TvmOpArgs::none},
+  {"DEBUGON", "FE1F", TvmOpArgs::none},
+  {"DUMP", "FE2", TvmOpArgs::sreg},
+  {"PRINT", "FE3", TvmOpArgs::sreg},
+  {"LOGFLUSH", "FEF000", TvmOpArgs::none},
+  {"SETCP0", "FF00", TvmOpArgs::none},
+  {"SETCPX", "FFF0", TvmOpArgs::none},
+};
+
+const TvmOpcode* lookup_tvm_opcode(std::string_view name) {
+  static const std::unordered_map<std::string_view, const TvmOpcode*> by_name = [] {
+    std::unordered_map<std::string_view, const TvmOpcode*> m;
+    m.reserve(std::size(all_tvm_opcodes));
+    for (const TvmOpcode& opcode : all_tvm_opcodes) {
+      m.emplace(opcode.name, &opcode);
+    }
+    return m;
+  }();
+
+  auto it = by_name.find(name);
+  return it == by_name.end() ? nullptr : it->second;
+}
+
+} // namespace tolk
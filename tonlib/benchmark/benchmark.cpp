@@ -0,0 +1,183 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+
+#include "vm/boc.h"
+
+#include "smc-envelope/WalletV3.h"
+
+#include "tonlib/SmcGetMethodBatch.h"
+
+#include "auto/tl/tonlib_api_json.h"
+#include "tl/tl_json.h"
+
+#include "td/utils/benchmark.h"
+#include "td/utils/crypto.h"
+#include "td/utils/JsonBuilder.h"
+#include "td/utils/logging.h"
+
+namespace tonlib_api = ton::tonlib_api;
+
+namespace {
+td::Result<tonlib_api::object_ptr<tonlib_api::Function>> parse_request_dom(std::string request) {
+  TRY_RESULT(value, td::json_decode(request));
+  tonlib_api::object_ptr<tonlib_api::Function> func;
+  TRY_STATUS(from_json(func, std::move(value)));
+  return std::move(func);
+}
+
+td::Result<tonlib_api::object_ptr<tonlib_api::Function>> parse_request_stream(std::string request) {
+  td::JsonReader reader(request);
+  tonlib_api::object_ptr<tonlib_api::Function> func;
+  TRY_STATUS(from_json(func, reader));
+  TRY_STATUS(reader.finish());
+  return std::move(func);
+}
+
+const char *get_transactions_request =
+    R"({"@type":"raw.getTransactionsV2","private_key":null,)"
+    R"("account_address":{"@type":"accountAddress","account_address":"EQCD39VS5jcptHL8vMjEXrzGaRcCVYto7HUn4bpAOg8xqB2N"},)"
+    R"("from_transaction_id":{"@type":"internal.transactionId","lt":"47256010000001",)"
+    R"("hash":"x2GO0aVm1GbDZfjkOIVFBNKbuAqf4hbRGVIN+K+BEwg="},"count":16,"try_decode_messages":true,"@extra":"5"})";
+
+tonlib_api::object_ptr<tonlib_api::raw_transactions> create_transactions(int n) {
+  std::vector<tonlib_api::object_ptr<tonlib_api::raw_transaction>> transactions;
+  for (int i = 0; i < n; i++) {
+    auto message = [&] {
+      return tonlib_api::make_object<tonlib_api::raw_message>(
+          std::string(32, 'h'), tonlib_api::make_object<tonlib_api::accountAddress>("EQCD39VS5jcptHL8vMjEXrzGaRcC"),
+          tonlib_api::make_object<tonlib_api::accountAddress>("EQCD39VS5jcptHL8vMjEXrzGaRcC"), 1000000000,
+          std::vector<tonlib_api::object_ptr<tonlib_api::extraCurrency>>(), 1000, 0, 47256010000001 + i,
+          std::string(32, 'b'), tonlib_api::make_object<tonlib_api::msg_dataRaw>(std::string(200, 'c'), ""));
+    };
+    std::vector<tonlib_api::object_ptr<tonlib_api::raw_message>> out_msgs;
+    out_msgs.push_back(message());
+    transactions.push_back(tonlib_api::make_object<tonlib_api::raw_transaction>(
+        tonlib_api::make_object<tonlib_api::accountAddress>("EQCD39VS5jcptHL8vMjEXrzGaRcC"), 1700000000,
+        std::string(700, 'd'), tonlib_api::make_object<tonlib_api::internal_transactionId>(47256010000001 + i, "hash"),
+        1000, 10, 990, message(), std::move(out_msgs)));
+  }
+  return tonlib_api::make_object<tonlib_api::raw_transactions>(
+      std::move(transactions), tonlib_api::make_object<tonlib_api::internal_transactionId>(1, "hash"));
+}
+
+class JsonBench : public td::Benchmark {
+ public:
+  enum class Mode { ParseDom, ParseStream, Encode };
+  explicit JsonBench(Mode mode) : mode_(mode) {
+  }
+  std::string get_description() const override {
+    switch (mode_) {
+      case Mode::ParseDom:
+        return "parse getTransactions request with JsonValue";
+      case Mode::ParseStream:
+        return "parse getTransactions request with JsonReader";
+      case Mode::Encode:
+        return "encode raw.transactions with 16 transactions";
+    }
+    UNREACHABLE();
+  }
+  void start_up() override {
+    transactions_ = create_transactions(16);
+  }
+  void run(int n) override {
+    size_t x = 0;
+    for (int i = 0; i < n; i++) {
+      switch (mode_) {
+        case Mode::ParseDom:
+          x += parse_request_dom(get_transactions_request).move_as_ok()->get_id();
+          break;
+        case Mode::ParseStream:
+          x += parse_request_stream(get_transactions_request).move_as_ok()->get_id();
+          break;
+        case Mode::Encode:
+          x += td::json_encode<std::string>(td::ToJson(*transactions_)).size();
+          break;
+      }
+    }
+    td::do_not_optimize_away(x);
+  }
+
+ private:
+  Mode mode_;
+  tonlib_api::object_ptr<tonlib_api::raw_transactions> transactions_;
+};
+
+ton::SmartContract::State create_wallet_state(td::Ref<vm::Cell> code, int i) {
+  ton::WalletV3::InitData init_data(std::string(32, static_cast<char>(i)), 698983191 + i);
+  return {std::move(code), ton::WalletV3::get_init_data(init_data)};
+}
+
+block::StdAddress create_wallet_address(int i) {
+  block::StdAddress address;
+  address.addr.as_slice().copy_from(td::sha256(PSLICE() << "wallet" << i));
+  return address;
+}
+
+class GetMethodBatchBench : public td::Benchmark {
+ public:
+  static constexpr int ACCOUNTS = 100;
+  explicit GetMethodBatchBench(bool batch) : batch_(batch) {
+  }
+  std::string get_description() const override {
+    return batch_ ? "seqno of 100 wallets with SmcGetMethodBatch" : "seqno of 100 wallets with separate contracts";
+  }
+  void start_up() override {
+    code_boc_ = vm::std_boc_serialize(ton::WalletV3::get_init_code(2)).move_as_ok();
+    auto code = vm::std_boc_deserialize(code_boc_).move_as_ok();
+    for (int i = 0; i < ACCOUNTS; i++) {
+      batch_runner_.add_account({create_wallet_address(i), create_wallet_state(code, i), 1000000000, {}, 1700000000});
+    }
+  }
+  void run(int n) override {
+    td::int64 x = 0;
+    for (int i = 0; i < n; i++) {
+      int account = i % ACCOUNTS;
+      if (batch_) {
+        x += batch_runner_.run(account, ton::SmartContract::Args().set_method_id("seqno")).code;
+      } else {
+        // What a client does per account with smc.load and smc.runGetMethod, excluding network queries
+        auto code = vm::std_boc_deserialize(code_boc_).move_as_ok();
+        td::Ref<ton::SmartContract> smc(true, create_wallet_state(code, account));
+        x += smc->run_get_method(ton::SmartContract::Args()
+                                     .set_method_id("seqno")
+                                     .set_balance(1000000000)
+                                     .set_now(1700000000)
+                                     .set_address(create_wallet_address(account)))
+                 .code;
+      }
+    }
+    td::do_not_optimize_away(x);
+  }
+
+ private:
+  bool batch_;
+  td::BufferSlice code_boc_;
+  tonlib::SmcGetMethodBatch batch_runner_;
+};
+}  // namespace
+
+int main() {
+  SET_VERBOSITY_LEVEL(VERBOSITY_NAME(ERROR));
+  td::bench(JsonBench(JsonBench::Mode::ParseDom));
+  td::bench(JsonBench(JsonBench::Mode::ParseStream));
+  td::bench(JsonBench(JsonBench::Mode::Encode));
+  td::bench(GetMethodBatchBench(true));
+  td::bench(GetMethodBatchBench(false));
+  return 0;
+}
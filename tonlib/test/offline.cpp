@@ -25,12 +25,17 @@
 #include "vm/boc.h"
 #include "vm/cells/CellString.h"
 
+#include "smc-envelope/WalletV3.h"
+
+#include "tonlib/AccountStateCache.h"
+#include "tonlib/SmcGetMethodBatch.h"
 #include "tonlib/utils.h"
 #include "tonlib/TonlibClient.h"
 #include "tonlib/Client.h"
 
 #include "auto/tl/ton_api_json.h"
 #include "auto/tl/tonlib_api_json.h"
+#include "tl/tl_json.h"
 
 #include "td/utils/benchmark.h"
 #include "td/utils/filesystem.h"
@@ -289,6 +294,226 @@ TEST(Tonlib, Mnemonic) {
   CHECK(c.to_private_key().as_octet_string() == d.to_private_key().as_octet_string());
 }
 
+namespace {
+td::Result<tonlib_api::object_ptr<tonlib_api::Function>> parse_request_dom(std::string request) {
+  TRY_RESULT(value, td::json_decode(request));
+  tonlib_api::object_ptr<tonlib_api::Function> func;
+  TRY_STATUS(from_json(func, std::move(value)));
+  return std::move(func);
+}
+
+td::Result<tonlib_api::object_ptr<tonlib_api::Function>> parse_request_stream(std::string request) {
+  td::JsonReader reader(request);
+  tonlib_api::object_ptr<tonlib_api::Function> func;
+  TRY_STATUS(from_json(func, reader));
+  TRY_STATUS(reader.finish());
+  return std::move(func);
+}
+
+const char *get_transactions_request =
+    R"({"@type":"raw.getTransactionsV2","private_key":null,)"
+    R"("account_address":{"@type":"accountAddress","account_address":"EQCD39VS5jcptHL8vMjEXrzGaRcCVYto7HUn4bpAOg8xqB2N"},)"
+    R"("from_transaction_id":{"@type":"internal.transactionId","lt":"47256010000001",)"
+    R"("hash":"x2GO0aVm1GbDZfjkOIVFBNKbuAqf4hbRGVIN+K+BEwg="},"count":16,"try_decode_messages":true,"@extra":"5"})";
+
+tonlib_api::object_ptr<tonlib_api::raw_transactions> create_transactions(int n) {
+  std::vector<tonlib_api::object_ptr<tonlib_api::raw_transaction>> transactions;
+  for (int i = 0; i < n; i++) {
+    auto message = [&] {
+      return tonlib_api::make_object<tonlib_api::raw_message>(
+          std::string(32, 'h'), tonlib_api::make_object<tonlib_api::accountAddress>("EQCD39VS5jcptHL8vMjEXrzGaRcC"),
+          tonlib_api::make_object<tonlib_api::accountAddress>("EQCD39VS5jcptHL8vMjEXrzGaRcC"), 1000000000,
+          std::vector<tonlib_api::object_ptr<tonlib_api::extraCurrency>>(), 1000, 0, 47256010000001 + i,
+          std::string(32, 'b'), tonlib_api::make_object<tonlib_api::msg_dataRaw>(std::string(200, 'c'), ""));
+    };
+    std::vector<tonlib_api::object_ptr<tonlib_api::raw_message>> out_msgs;
+    out_msgs.push_back(message());
+    transactions.push_back(tonlib_api::make_object<tonlib_api::raw_transaction>(
+        tonlib_api::make_object<tonlib_api::accountAddress>("EQCD39VS5jcptHL8vMjEXrzGaRcC"), 1700000000,
+        std::string(700, 'd'), tonlib_api::make_object<tonlib_api::internal_transactionId>(47256010000001 + i, "hash"),
+        1000, 10, 990, message(), std::move(out_msgs)));
+  }
+  return tonlib_api::make_object<tonlib_api::raw_transactions>(
+      std::move(transactions), tonlib_api::make_object<tonlib_api::internal_transactionId>(1, "hash"));
+}
+
+}  // namespace
+
+TEST(Tonlib, AccountStateCache) {
+  tonlib::AccountStateCache::Options options;
+  options.max_entries = 3;
+  options.keep_blocks = 2;
+  tonlib::AccountStateCache cache(options);
+
+  auto block_id = [](ton::BlockSeqno seqno) {
+    ton::BlockIdExt id{ton::masterchainId, ton::shardIdAll, seqno, {}, {}};
+    id.root_hash.as_slice().copy_from(td::sha256(PSLICE() << "block" << seqno));
+    return id;
+  };
+  auto address = [](int i) {
+    block::StdAddress addr;
+    addr.workchain = ton::basechainId;
+    addr.addr.as_slice().copy_from(td::sha256(PSLICE() << "account" << i));
+    return addr;
+  };
+  block::AccountState::Info info;
+  info.last_trans_lt = 123;
+
+  CHECK(!cache.get(address(1), block_id(10)));
+  cache.add(address(1), block_id(10), info);
+  auto r = cache.get(address(1), block_id(10));
+  CHECK(r);
+  ASSERT_EQ(123u, r.value().last_trans_lt);
+  CHECK(!cache.get(address(2), block_id(10)));
+  CHECK(!cache.get(address(1), block_id(11)));
+  auto other_block = block_id(10);
+  other_block.root_hash.as_slice()[0] ^= 1;
+  CHECK(!cache.get(address(1), other_block));
+
+  // oldest entry is evicted when the cache is full
+  cache.add(address(2), block_id(11), info);
+  cache.add(address(3), block_id(11), info);
+  cache.add(address(4), block_id(12), info);
+  ASSERT_EQ(3u, cache.size());
+  CHECK(!cache.get(address(1), block_id(10)));
+
+  // entries of old blocks are dropped by last block updates, and are not added anymore
+  cache.on_last_block(block_id(14));
+  ASSERT_EQ(1u, cache.size());
+  CHECK(cache.get(address(4), block_id(12)));
+  cache.add(address(5), block_id(11), info);
+  ASSERT_EQ(1u, cache.size());
+  cache.clear();
+  ASSERT_EQ(0u, cache.size());
+}
+
+namespace {
+ton::SmartContract::State create_wallet_state(td::Ref<vm::Cell> code, int i) {
+  ton::WalletV3::InitData init_data(std::string(32, static_cast<char>(i)), 698983191 + i);
+  return {std::move(code), ton::WalletV3::get_init_data(init_data)};
+}
+
+block::StdAddress create_wallet_address(int i) {
+  block::StdAddress address;
+  address.addr.as_slice().copy_from(td::sha256(PSLICE() << "wallet" << i));
+  return address;
+}
+}  // namespace
+
+TEST(Tonlib, SmcGetMethodBatch) {
+  SmcGetMethodBatch batch;
+  for (int i = 0; i < 3; i++) {
+    // each account has its own copy of the code
+    auto code = vm::std_boc_deserialize(vm::std_boc_serialize(ton::WalletV3::get_init_code(2)).move_as_ok());
+    ASSERT_EQ(i, static_cast<int>(batch.add_account(
+                     {create_wallet_address(i), create_wallet_state(code.move_as_ok(), i), 1000000000, {}, 0})));
+  }
+  ASSERT_EQ(3u, batch.account_count());
+  ASSERT_EQ(1u, batch.codes().size());
+  batch.set_libraries(vm::Dictionary{256});
+
+  for (int i = 0; i < 3; i++) {
+    auto seqno = batch.run(i, ton::SmartContract::Args().set_method_id("seqno"));
+    CHECK(seqno.success);
+    ASSERT_EQ(0, seqno.stack.write().pop_long_range(std::numeric_limits<td::int64>::max()));
+    auto key = batch.run(i, ton::SmartContract::Args().set_method_id("get_public_key"));
+    CHECK(key.success);
+    td::Bits256 public_key;
+    public_key.as_slice().fill(static_cast<char>(i));
+    ASSERT_EQ(td::bits_to_refint(public_key.bits(), 256, false)->to_hex_string(),
+              key.stack.write().pop_int()->to_hex_string());
+  }
+  auto missing = batch.run(0, ton::SmartContract::Args().set_method_id("no_such_method"));
+  CHECK(!missing.success);
+}
+
+TEST(Tonlib, SmcGetMethodBatchMissingLibrary) {
+  // the code of both accounts is a reference to a library, only the first one can be obtained
+  auto make_library_ref = [](const td::Bits256 &hash) {
+    vm::CellBuilder cb;
+    cb.store_long(static_cast<td::uint8>(vm::Cell::SpecialType::Library), 8).store_bytes(hash.as_slice());
+    return cb.finalize(true);
+  };
+  auto library = ton::WalletV3::get_init_code(2);
+  td::Bits256 library_hash = library->get_hash().bits();
+  td::Bits256 unknown_hash;
+  unknown_hash.as_slice().fill('u');
+  SmcGetMethodBatch batch;
+  for (int i = 0; i < 2; i++) {
+    auto code = make_library_ref(i == 0 ? library_hash : unknown_hash);
+    batch.add_account({create_wallet_address(i), create_wallet_state(code, i), 1000000000, {}, 0});
+  }
+  vm::Dictionary libraries{256};
+  batch.set_libraries(libraries);
+
+  MissingLibraries missing_libraries;
+  std::vector<ton::SmartContract::Answer> answers(2);
+  std::vector<bool> done(2);
+  int rounds = 0;
+  while (true) {
+    for (size_t i = 0; i < 2; i++) {
+      if (!done[i]) {
+        answers[i] = batch.run(i, ton::SmartContract::Args().set_method_id("seqno"));
+        done[i] = !missing_libraries.add(answers[i]);
+      }
+    }
+    auto library_list = missing_libraries.extract();
+    if (library_list.empty()) {
+      break;
+    }
+    rounds++;
+    // what the liteserver has
+    for (auto &hash : library_list) {
+      if (hash == library_hash) {
+        libraries.set_ref(hash, library);
+      }
+    }
+    batch.set_libraries(libraries);
+  }
+  // the libraries of all calls are requested together, and the unknown one is requested only once
+  ASSERT_EQ(1, rounds);
+  CHECK(answers[0].success);
+  ASSERT_EQ(0, answers[0].stack.write().pop_long_range(std::numeric_limits<td::int64>::max()));
+  CHECK(!answers[1].success);
+  CHECK(answers[1].missing_library);
+  ASSERT_EQ(unknown_hash.to_hex(), answers[1].missing_library.value().to_hex());
+}
+
+TEST(Tonlib, JsonReader) {
+  std::vector<std::string> requests = {
+      get_transactions_request,
+      // "@type" isn't the first field, unknown fields and nested polymorphic objects
+      R"({ "id" : 1, "unknown": [1, {"@type": "x", "a": "\"}"}], "@type": "smc.runGetMethod",)"
+      R"( "method": {"name": "get_wallet_address", "@type": "smc.methodIdName"},)"
+      R"( "stack": [{"@type": "tvm.stackEntryNumber", "number": {"@type": "tvm.numberDecimal", "number": "-5"}},)"
+      R"( {"@type": "tvm.stackEntryCell", "cell": {"@type": "tvm.cell", "bytes": ""}}] })",
+      R"({"@type":"raw.getAccountState","account_address":null})",
+      R"({"@type":"smc.runGetMethod","id":"2","method":{"@type":"smc.methodIdNumber","number":85143},"stack":[]})"};
+  for (auto &request : requests) {
+    auto dom = parse_request_dom(request).move_as_ok();
+    auto stream = parse_request_stream(request).move_as_ok();
+    ASSERT_EQ(tonlib_api::to_string(dom), tonlib_api::to_string(stream));
+  }
+
+  std::vector<std::string> bad_requests = {R"({"@type":"raw.getAccountState","account_address":})",
+                                           R"({"@type":"raw.getAccountState"} x)",
+                                           R"({"@type":"unknownFunction"})",
+                                           R"({"account_address":null})",
+                                           R"({"@type":"smc.runGetMethod","id":"a"})",
+                                           R"({"@type":"smc.runGetMethod","stack":[1,]})"};
+  for (auto &request : bad_requests) {
+    parse_request_dom(request).ensure_error();
+    parse_request_stream(request).ensure_error();
+  }
+
+  auto transactions = create_transactions(2);
+  auto json = td::json_encode<std::string>(td::ToJson(*transactions));
+  tonlib_api::object_ptr<tonlib_api::raw_transactions> decoded;
+  td::JsonReader reader(json);
+  from_json(decoded, reader).ensure();
+  ASSERT_EQ(tonlib_api::to_string(transactions), tonlib_api::to_string(decoded));
+}
+
 TEST(Tonlib, Keys) {
   auto a = Mnemonic::create(td::SecureString(" Hello, . $^\n# World!   "), td::SecureString("cucumber")).move_as_ok();
   DecryptedKey decrypted_key(std::move(a));
@@ -0,0 +1,85 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "tonlib/AccountStateCache.h"
+
+namespace tonlib {
+
+AccountStateCache::Key AccountStateCache::make_key(const block::StdAddress& address, const ton::BlockIdExt& block_id) {
+  return Key{block_id.id.seqno, address.workchain, address.addr, block_id.root_hash};
+}
+
+td::optional<block::AccountState::Info> AccountStateCache::get(const block::StdAddress& address,
+                                                                const ton::BlockIdExt& block_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(make_key(address, block_id));
+  if (it == entries_.end()) {
+    return {};
+  }
+  return it->second.info;
+}
+
+void AccountStateCache::add(const block::StdAddress& address, const ton::BlockIdExt& block_id,
+                            const block::AccountState::Info& info) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (options_.max_entries == 0 || block_id.id.seqno + options_.keep_blocks < last_seqno_) {
+    return;
+  }
+  auto key = make_key(address, block_id);
+  if (entries_.count(key)) {
+    return;
+  }
+  while (entries_.size() >= options_.max_entries) {
+    erase(entries_.find(order_.begin()->second));
+  }
+  auto id = next_id_++;
+  entries_.emplace(key, Entry{info, id});
+  order_.emplace(id, key);
+}
+
+void AccountStateCache::on_last_block(const ton::BlockIdExt& block_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (block_id.id.seqno <= last_seqno_) {
+    return;
+  }
+  last_seqno_ = block_id.id.seqno;
+  if (last_seqno_ <= options_.keep_blocks) {
+    return;
+  }
+  ton::BlockSeqno min_seqno = last_seqno_ - options_.keep_blocks;
+  while (!entries_.empty() && entries_.begin()->first.seqno < min_seqno) {
+    erase(entries_.begin());
+  }
+}
+
+void AccountStateCache::clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.clear();
+  order_.clear();
+  last_seqno_ = 0;
+}
+
+size_t AccountStateCache::size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return entries_.size();
+}
+
+void AccountStateCache::erase(std::map<Key, Entry>::iterator it) {
+  order_.erase(it->second.order_id);
+  entries_.erase(it);
+}
+
+}  // namespace tonlib
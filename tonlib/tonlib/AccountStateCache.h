@@ -0,0 +1,82 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "block/block.h"
+#include "block/check-proof.h"
+#include "ton/ton-types.h"
+
+#include "td/utils/optional.h"
+
+#include <map>
+#include <mutex>
+
+namespace tonlib {
+
+// Cache of account states whose proofs were already checked, keyed by (account, masterchain block).
+// The state of an account at a given block never changes, so entries are never stale; they are dropped
+// when the last known masterchain block moves away from them, or when the cache is full.
+// Shared between query actors, so all methods are thread-safe.
+class AccountStateCache {
+ public:
+  struct Options {
+    size_t max_entries = 4096;
+    // Entries for masterchain blocks older than the last block by more than this are dropped
+    ton::BlockSeqno keep_blocks = 8;
+  };
+
+  AccountStateCache() = default;
+  explicit AccountStateCache(Options options) : options_(options) {
+  }
+
+  td::optional<block::AccountState::Info> get(const block::StdAddress& address, const ton::BlockIdExt& block_id);
+  void add(const block::StdAddress& address, const ton::BlockIdExt& block_id, const block::AccountState::Info& info);
+  void on_last_block(const ton::BlockIdExt& block_id);
+  void clear();
+
+  size_t size() const;
+
+ private:
+  struct Key {
+    ton::BlockSeqno seqno;
+    ton::WorkchainId workchain;
+    ton::StdSmcAddress addr;
+    ton::RootHash block_root_hash;
+
+    bool operator<(const Key& other) const {
+      return std::tie(seqno, workchain, addr, block_root_hash) <
+             std::tie(other.seqno, other.workchain, other.addr, other.block_root_hash);
+    }
+  };
+  struct Entry {
+    block::AccountState::Info info;
+    td::uint64 order_id;
+  };
+
+  static Key make_key(const block::StdAddress& address, const ton::BlockIdExt& block_id);
+  void erase(std::map<Key, Entry>::iterator it);
+
+  Options options_;
+  mutable std::mutex mutex_;
+  // Sorted by seqno first, so that old blocks are dropped with a prefix erase
+  std::map<Key, Entry> entries_;
+  // Insertion order, for eviction when the cache is full
+  std::map<td::uint64, Key> order_;
+  td::uint64 next_id_ = 0;
+  ton::BlockSeqno last_seqno_ = 0;
+};
+
+}  // namespace tonlib
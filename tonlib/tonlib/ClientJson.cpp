@@ -27,6 +27,7 @@
 #include "td/utils/JsonBuilder.h"
 #include "td/utils/logging.h"
 #include "td/utils/port/thread_local.h"
+#include "td/utils/StackAllocator.h"
 #include "td/utils/Status.h"
 
 #include <utility>
@@ -35,41 +36,43 @@ namespace tonlib {
 
 static td::Result<std::pair<tonlib_api::object_ptr<tonlib_api::Function>, std::string>> to_request(td::Slice request) {
   auto request_str = request.str();
-  TRY_RESULT(json_value, td::json_decode(request_str));
-  if (json_value.type() != td::JsonValue::Type::Object) {
+  td::JsonReader reader(request_str);
+  TRY_RESULT(type, reader.peek_type());
+  if (type != td::JsonValue::Type::Object) {
     return td::Status::Error("Expected an Object");
   }
 
-  std::string extra;
-  if (has_json_object_field(json_value.get_object(), "@extra")) {
-    extra = td::json_encode<std::string>(
-        get_json_object_field(json_value.get_object(), "@extra", td::JsonValue::Type::Null).move_as_ok());
-  }
+  // "@extra" is returned to the client as is, so its source text is saved before strings are decoded in place
+  TRY_RESULT(extra, reader.find_object_field("@extra"));
+  auto extra_str = extra.str();
 
   tonlib_api::object_ptr<tonlib_api::Function> func;
-  TRY_STATUS(from_json(func, std::move(json_value)));
-  return std::make_pair(std::move(func), extra);
-}
-
-static std::string from_response(const tonlib_api::Object &object, const td::string &extra) {
-  auto str = td::json_encode<td::string>(td::ToJson(object));
-  CHECK(!str.empty() && str.back() == '}');
-  if (!extra.empty()) {
-    str.pop_back();
-    str.reserve(str.size() + 11 + extra.size());
-    str += ",\"@extra\":";
-    str += extra;
-    str += '}';
-  }
-  return str;
+  TRY_STATUS(from_json(func, reader));
+  TRY_STATUS(reader.finish());
+  return std::make_pair(std::move(func), std::move(extra_str));
 }
 
 static TD_THREAD_LOCAL std::string *current_output;
 
-static td::CSlice store_string(std::string str) {
+static td::CSlice from_response(const tonlib_api::Object &object, td::Slice extra) {
+  auto buf = td::StackAllocator::alloc(1 << 18);
+  td::JsonBuilder jb(td::StringBuilder(buf.as_slice(), true), -1);
+  jb.enter_value() << td::ToJson(object);
+  auto str = jb.string_builder().as_cslice();
+  CHECK(!str.empty() && str.back() == '}');
+
   td::init_thread_local<std::string>(current_output);
-  *current_output = std::move(str);
-  return *current_output;
+  auto &output = *current_output;
+  if (extra.empty()) {
+    output.assign(str.data(), str.size());
+  } else {
+    output.reserve(str.size() + 10 + extra.size());
+    output.assign(str.data(), str.size() - 1);
+    output += ",\"@extra\":";
+    output.append(extra.data(), extra.size());
+    output += '}';
+  }
+  return output;
 }
 
 void ClientJson::send(td::Slice request) {
@@ -102,7 +105,7 @@ td::CSlice ClientJson::receive(double timeout) {
       extra_.erase(it);
     }
   }
-  return store_string(from_response(*response.object, extra));
+  return from_response(*response.object, extra);
 }
 
 td::CSlice ClientJson::execute(td::Slice request) {
@@ -112,8 +115,8 @@ td::CSlice ClientJson::execute(td::Slice request) {
     return {};
   }
 
-  return store_string(from_response(*Client::execute(Client::Request{0, std::move(r_request.ok_ref().first)}).object,
-                                    r_request.ok().second));
+  return from_response(*Client::execute(Client::Request{0, std::move(r_request.ok_ref().first)}).object,
+                       r_request.ok().second);
 }
 
 }  // namespace tonlib
@@ -29,6 +29,7 @@
 #include "td/utils/Random.h"
 
 #include "lite-client/ext-client.h"
+#include "AccountStateCache.h"
 #include "TonlibError.h"
 #include "utils.h"
 
@@ -41,6 +42,7 @@ struct ExtClientRef {
   td::actor::ActorId<liteclient::ExtClient> adnl_ext_client_;
   td::actor::ActorId<LastBlock> last_block_actor_;
   td::actor::ActorId<LastConfig> last_config_actor_;
+  std::shared_ptr<AccountStateCache> account_state_cache_;
 };
 
 class ExtClient {
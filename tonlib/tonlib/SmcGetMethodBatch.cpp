@@ -0,0 +1,79 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "tonlib/SmcGetMethodBatch.h"
+
+namespace tonlib {
+
+size_t SmcGetMethodBatch::add_account(Account account) {
+  auto& code = account.state.code;
+  if (code.not_null()) {
+    auto it = codes_.emplace(code->get_hash(), code).first;
+    code = it->second;
+  }
+  contracts_.emplace_back(true, account.state);
+  accounts_.push_back(std::move(account));
+  return accounts_.size() - 1;
+}
+
+void SmcGetMethodBatch::set_config(std::shared_ptr<const block::Config> config, td::Ref<vm::Tuple> prev_blocks_info) {
+  config_ = std::move(config);
+  prev_blocks_info_ = std::move(prev_blocks_info);
+}
+
+void SmcGetMethodBatch::set_libraries(vm::Dictionary libraries) {
+  libraries_ = std::move(libraries);
+}
+
+ton::SmartContract::Answer SmcGetMethodBatch::run(size_t account_idx, ton::SmartContract::Args args) const {
+  CHECK(account_idx < accounts_.size());
+  auto& account = accounts_[account_idx];
+  args.set_balance(account.balance);
+  args.set_extra_currencies(account.extra_currencies);
+  args.set_now(account.now);
+  args.set_address(account.address);
+  if (config_) {
+    args.set_config(config_);
+  }
+  if (prev_blocks_info_.not_null()) {
+    args.set_prev_blocks_info(prev_blocks_info_);
+  }
+  if (libraries_) {
+    args.set_libraries(libraries_.value());
+  }
+  return contracts_[account_idx]->run_get_method(std::move(args));
+}
+
+bool MissingLibraries::add(const ton::SmartContract::Answer& answer) {
+  if (!answer.missing_library) {
+    return false;
+  }
+  auto& hash = answer.missing_library.value();
+  if (requested_.count(hash)) {
+    return false;
+  }
+  pending_.insert(hash);
+  return true;
+}
+
+std::vector<td::Bits256> MissingLibraries::extract() {
+  std::vector<td::Bits256> res{pending_.begin(), pending_.end()};
+  requested_.insert(pending_.begin(), pending_.end());
+  pending_.clear();
+  return res;
+}
+
+}  // namespace tonlib
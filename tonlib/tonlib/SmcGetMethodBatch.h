@@ -0,0 +1,76 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "smc-envelope/SmartContract.h"
+
+#include "td/utils/common.h"
+
+#include <map>
+#include <set>
+
+namespace tonlib {
+
+// Runs get-methods of many accounts taken from one masterchain block.
+// Accounts with equal code share one code cell, and config and libraries are set once for all runs.
+class SmcGetMethodBatch {
+ public:
+  struct Account {
+    block::StdAddress address;
+    ton::SmartContract::State state;
+    td::uint64 balance{0};
+    td::Ref<vm::Cell> extra_currencies;
+    td::uint32 now{0};
+  };
+
+  size_t add_account(Account account);
+  size_t account_count() const {
+    return accounts_.size();
+  }
+  // Distinct code cells of all accounts, to look for libraries only once per code
+  const std::map<vm::CellHash, td::Ref<vm::Cell>>& codes() const {
+    return codes_;
+  }
+
+  void set_config(std::shared_ptr<const block::Config> config, td::Ref<vm::Tuple> prev_blocks_info);
+  void set_libraries(vm::Dictionary libraries);
+
+  ton::SmartContract::Answer run(size_t account_idx, ton::SmartContract::Args args) const;
+
+ private:
+  std::vector<Account> accounts_;
+  std::vector<td::Ref<ton::SmartContract>> contracts_;
+  std::map<vm::CellHash, td::Ref<vm::Cell>> codes_;
+  std::shared_ptr<const block::Config> config_;
+  td::Ref<vm::Tuple> prev_blocks_info_;
+  td::optional<vm::Dictionary> libraries_;
+};
+
+// Libraries that get methods stopped at. A get method is run again once its missing library is requested,
+// but every library is requested only once, so a library that cannot be obtained does not make it run forever.
+class MissingLibraries {
+ public:
+  // Returns true if the get method must be run again after the libraries from extract() are loaded
+  bool add(const ton::SmartContract::Answer& answer);
+  // Libraries to request, each one is returned once
+  std::vector<td::Bits256> extract();
+
+ private:
+  std::set<td::Bits256> requested_;
+  std::set<td::Bits256> pending_;
+};
+
+}  // namespace tonlib
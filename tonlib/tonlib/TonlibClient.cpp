@@ -22,6 +22,7 @@
 #include "tonlib/LastBlock.h"
 #include "tonlib/LastConfig.h"
 #include "tonlib/Logging.h"
+#include "tonlib/SmcGetMethodBatch.h"
 #include "tonlib/utils.h"
 #include "tonlib/keys/Mnemonic.h"
 #include "tonlib/keys/SimpleEncryption.h"
@@ -1333,7 +1334,8 @@ class GetRawAccountState : public td::actor::Actor {
       : address_(std::move(address))
       , block_id_(std::move(block_id))
       , promise_(std::move(promise))
-      , parent_(std::move(parent)) {
+      , parent_(std::move(parent))
+      , cache_(ext_client_ref.account_state_cache_) {
     client_.set_client(ext_client_ref);
   }
 
@@ -1343,6 +1345,7 @@ class GetRawAccountState : public td::actor::Actor {
   td::Promise<RawAccountState> promise_;
   td::actor::ActorShared<> parent_;
   ExtClient client_;
+  std::shared_ptr<AccountStateCache> cache_;
 
   void with_account_state(td::Result<ton::tl_object_ptr<ton::lite_api::liteServer_accountState>> r_account_state) {
     check(do_with_account_state(std::move(r_account_state)));
@@ -1362,7 +1365,13 @@ class GetRawAccountState : public td::actor::Actor {
       ton::tl_object_ptr<ton::lite_api::liteServer_accountState> raw_account_state) {
     auto account_state = create_account_state(std::move(raw_account_state));
     TRY_RESULT(info, account_state.validate(block_id_.value(), address_));
-    auto serialized_state = account_state.state.clone();
+    if (cache_) {
+      cache_->add(address_, block_id_.value(), info);
+    }
+    return do_with_account_info(std::move(info));
+  }
+
+  td::Result<RawAccountState> do_with_account_info(block::AccountState::Info info) {
     RawAccountState res;
     res.block_id = block_id_.value();
     res.info = std::move(info);
@@ -1452,6 +1461,13 @@ class GetRawAccountState : public td::actor::Actor {
   }
 
   void with_block_id() {
+    if (cache_) {
+      auto info = cache_->get(address_, block_id_.value());
+      if (info) {
+        check(do_with_cached_info(info.unwrap()));
+        return;
+      }
+    }
     client_.send_query(
         ton::lite_api::liteServer_getAccountState(
             ton::create_tl_lite_block_id(block_id_.value()),
@@ -1459,6 +1475,13 @@ class GetRawAccountState : public td::actor::Actor {
         [self = this](auto r_state) { self->with_account_state(std::move(r_state)); });
   }
 
+  td::Status do_with_cached_info(block::AccountState::Info info) {
+    TRY_RESULT_PREFIX(state, TRY_VM(do_with_account_info(std::move(info))), TonlibError::ValidateAccountState());
+    promise_.set_value(std::move(state));
+    stop();
+    return td::Status::OK();
+  }
+
   td::Status do_with_last_block(td::Result<LastBlockState> r_last_block) {
     TRY_RESULT(last_block, std::move(r_last_block));
     block_id_ = std::move(last_block.last_block_id);
@@ -2279,6 +2302,7 @@ ExtClientRef TonlibClient::get_client_ref() {
   ref.adnl_ext_client_ = raw_client_.get();
   ref.last_block_actor_ = raw_last_block_.get();
   ref.last_config_actor_ = raw_last_config_.get();
+  ref.account_state_cache_ = account_state_cache_;
 
   return ref;
 }
@@ -2288,6 +2312,8 @@ void TonlibClient::proxy_request(td::int64 query_id, std::string data) {
 }
 
 void TonlibClient::init_ext_client() {
+  // Cached states belong to the network of the previous config
+  account_state_cache_ = std::make_shared<AccountStateCache>();
   if (use_callbacks_for_network_) {
     class Callback : public ExtClientOutbound::Callback {
      public:
@@ -2311,7 +2337,10 @@ void TonlibClient::init_ext_client() {
     raw_client_ = std::move(client);
   } else {
     ext_client_outbound_ = {};
-    raw_client_ = liteclient::ExtClient::create(config_.lite_servers, nullptr);
+    liteclient::ExtClient::Options options;
+    options.connections_per_server = 2;
+    options.hedge_queries = true;
+    raw_client_ = liteclient::ExtClient::create(config_.lite_servers, nullptr, options);
   }
 }
 
@@ -2320,6 +2349,9 @@ void TonlibClient::update_last_block_state(LastBlockState state, td::uint32 conf
     return;
   }
 
+  if (account_state_cache_) {
+    account_state_cache_->on_last_block(state.last_block_id);
+  }
   last_block_storage_.save_state(last_state_key_, state);
 }
 
@@ -4978,13 +5010,10 @@ td::Status TonlibClient::do_request(const tonlib_api::smc_runGetMethod& request,
       std::vector<td::Bits256> libraryList{librarySet.begin(), librarySet.end()};
       if (libraryList.size() > 0) {
         LOG(DEBUG) << "Requesting found libraries in code (" << libraryList.size() << ")";
-        self->client_.send_query(
-            ton::lite_api::liteServer_getLibraries(std::move(libraryList)),
-            [self, smc = std::move(smc), args = std::move(args), promise = std::move(promise)](
-                td::Result<ton::lite_api::object_ptr<ton::lite_api::liteServer_libraryResult>> r_libraries) mutable {
-              self->process_new_libraries(std::move(r_libraries));
-              self->perform_smc_execution(std::move(smc), std::move(args), std::move(promise));
-            });
+        self->load_libraries(std::move(libraryList), [self, smc = std::move(smc), args = std::move(args),
+                                                      promise = std::move(promise)](td::Result<td::Unit>) mutable {
+          self->perform_smc_execution(std::move(smc), std::move(args), std::move(promise));
+        });
       } else {
         self->perform_smc_execution(std::move(smc), std::move(args), std::move(promise));
       }
@@ -4996,6 +5025,166 @@ td::Status TonlibClient::do_request(const tonlib_api::smc_runGetMethod& request,
   return td::Status::OK();
 }
 
+struct TonlibClient::GetMethodBatch {
+  struct Call {
+    size_t account;
+    ton::SmartContract::Args args;
+  };
+  std::vector<Call> calls;
+  std::vector<block::StdAddress> addresses;
+  // Index of the loaded account in runner, or the error of loading it; one per address
+  std::vector<td::Result<size_t>> accounts;
+  SmcGetMethodBatch runner;
+  // Result of every call, empty while the call waits for a missing library
+  std::vector<object_ptr<tonlib_api::smc_GetMethodCallResult>> results;
+  MissingLibraries missing_libraries;
+  ton::BlockIdExt block_id;
+  td::Promise<object_ptr<tonlib_api::smc_getMethodBatchResult>> promise;
+};
+
+static constexpr size_t MAX_GET_METHOD_BATCH_SIZE = 1024;
+
+td::Status TonlibClient::do_request(const tonlib_api::smc_runGetMethodBatch& request,
+                                    td::Promise<object_ptr<tonlib_api::smc_getMethodBatchResult>>&& promise) {
+  if (request.calls_.size() > MAX_GET_METHOD_BATCH_SIZE) {
+    return TonlibError::InvalidField("calls", PSLICE() << ": too many calls, " << MAX_GET_METHOD_BATCH_SIZE
+                                                       << " maximum");
+  }
+  auto batch = std::make_shared<GetMethodBatch>();
+  std::map<std::pair<ton::WorkchainId, ton::StdSmcAddress>, size_t> address_idx;
+  for (auto& call : request.calls_) {
+    if (!call) {
+      return TonlibError::EmptyField("calls");
+    }
+    if (!call->account_address_) {
+      return TonlibError::EmptyField("account_address");
+    }
+    if (!call->method_) {
+      return TonlibError::EmptyField("method");
+    }
+    TRY_RESULT(account_address, get_account_address(call->account_address_->account_address_));
+    auto it = address_idx.emplace(std::make_pair(account_address.workchain, account_address.addr),
+                                  batch->addresses.size());
+    if (it.second) {
+      batch->addresses.push_back(account_address);
+      batch->accounts.push_back(td::Status::Error("account is not loaded"));
+    }
+    ton::SmartContract::Args args;
+    downcast_call(*call->method_,
+                  td::overloaded([&](tonlib_api::smc_methodIdNumber& number) { args.set_method_id(number.number_); },
+                                 [&](tonlib_api::smc_methodIdName& name) { args.set_method_id(name.name_); }));
+    td::Ref<vm::Stack> stack(true);
+    for (auto& entry : call->stack_) {
+      TRY_RESULT(e, from_tonlib_api(*entry));
+      stack.write().push(std::move(e));
+    }
+    args.set_stack(std::move(stack));
+    batch->calls.push_back(GetMethodBatch::Call{it.first->second, std::move(args)});
+  }
+  batch->results.resize(batch->calls.size());
+  batch->promise = std::move(promise);
+
+  if (query_context_.block_id) {
+    run_get_method_batch(std::move(batch), query_context_.block_id.value());
+  } else {
+    client_.with_last_block([self = this, batch = std::move(batch)](td::Result<LastBlockState> r_last_block) mutable {
+      if (r_last_block.is_error()) {
+        batch->promise.set_error(r_last_block.move_as_error_prefix(TonlibError::Internal("get last block failed ")));
+        return;
+      }
+      self->run_get_method_batch(std::move(batch), r_last_block.move_as_ok().last_block_id);
+    });
+  }
+  return td::Status::OK();
+}
+
+void TonlibClient::run_get_method_batch(std::shared_ptr<GetMethodBatch> batch, ton::BlockIdExt block_id) {
+  batch->block_id = block_id;
+  td::MultiPromise mp;
+  auto ig = mp.init_guard();
+  ig.add_promise([self = this, batch](td::Result<td::Unit> R) {
+    if (R.is_error()) {
+      batch->promise.set_error(R.move_as_error());
+      return;
+    }
+    self->load_get_method_batch_libraries(std::move(batch));
+  });
+
+  // All accounts are requested at once, ExtClient spreads the queries over liteservers
+  for (size_t i = 0; i < batch->addresses.size(); i++) {
+    make_request(int_api::GetAccountState{batch->addresses[i], block_id, {}},
+                 [batch, i, promise = ig.get_promise()](td::Result<td::unique_ptr<AccountState>> r_state) mutable {
+                   if (r_state.is_error()) {
+                     batch->accounts[i] = r_state.move_as_error();
+                   } else {
+                     auto state = r_state.move_as_ok();
+                     batch->accounts[i] = batch->runner.add_account(SmcGetMethodBatch::Account{
+                         state->get_address(), state->get_smc_state(), static_cast<td::uint64>(state->get_balance()),
+                         state->get_extra_currencies(), state->get_sync_time()});
+                   }
+                   promise.set_value(td::Unit());
+                 });
+  }
+  client_.with_last_config([batch, promise = ig.get_promise()](td::Result<LastConfigState> r_state) mutable {
+    TRY_RESULT_PROMISE(promise, state, std::move(r_state));
+    batch->runner.set_config(state.config, state.prev_blocks_info);
+    promise.set_value(td::Unit());
+  });
+}
+
+void TonlibClient::load_get_method_batch_libraries(std::shared_ptr<GetMethodBatch> batch) {
+  std::set<td::Bits256> library_set;
+  for (auto& it : batch->runner.codes()) {
+    std::set<vm::Cell::Hash> visited;
+    deep_library_search(library_set, visited, libraries, it.second, 24, MAX_GET_METHOD_BATCH_SIZE);
+  }
+  std::vector<td::Bits256> library_list{library_set.begin(), library_set.end()};
+  LOG(DEBUG) << "Requesting " << library_list.size() << " libraries for " << batch->calls.size() << " get methods";
+  load_libraries(std::move(library_list), [self = this, batch](td::Result<td::Unit>) {
+    self->finish_get_method_batch(std::move(batch));
+  });
+}
+
+void TonlibClient::finish_get_method_batch(std::shared_ptr<GetMethodBatch> batch) {
+  batch->runner.set_libraries(libraries);
+  for (size_t i = 0; i < batch->calls.size(); i++) {
+    if (batch->results[i]) {
+      continue;
+    }
+    auto& call = batch->calls[i];
+    auto r_result = [&]() -> td::Result<object_ptr<tonlib_api::smc_runResult>> {
+      auto& account = batch->accounts[call.account];
+      if (account.is_error()) {
+        return account.error().clone();
+      }
+      auto res = batch->runner.run(account.ok(), call.args);
+      if (batch->missing_libraries.add(res)) {
+        return object_ptr<tonlib_api::smc_runResult>();
+      }
+      TRY_RESULT(stack, to_tonlib_api(res.stack));
+      return tonlib_api::make_object<tonlib_api::smc_runResult>(res.gas_used, std::move(stack), res.code);
+    }();
+    if (r_result.is_error()) {
+      batch->results[i] =
+          tonlib_api::make_object<tonlib_api::smc_getMethodCallResultError>(status_to_tonlib_api(r_result.error()));
+    } else if (r_result.ok()) {
+      batch->results[i] = tonlib_api::make_object<tonlib_api::smc_getMethodCallResultOk>(r_result.move_as_ok());
+    }
+  }
+
+  auto library_list = batch->missing_libraries.extract();
+  if (!library_list.empty()) {
+    // Calls that stopped at a missing library are run again once it is loaded
+    LOG(DEBUG) << "Requesting " << library_list.size() << " missing libraries for get methods";
+    load_libraries(std::move(library_list), [self = this, batch](td::Result<td::Unit>) {
+      self->finish_get_method_batch(std::move(batch));
+    });
+    return;
+  }
+  batch->promise.set_value(tonlib_api::make_object<tonlib_api::smc_getMethodBatchResult>(
+      to_tonlib_api(batch->block_id), std::move(batch->results)));
+}
+
 void TonlibClient::process_new_libraries(
     td::Result<ton::lite_api::object_ptr<ton::lite_api::liteServer_libraryResult>> r_libraries) {
   if (r_libraries.is_error()) {
@@ -5023,66 +5212,54 @@ void TonlibClient::process_new_libraries(
   }
 }
 
+void TonlibClient::load_libraries(std::vector<td::Bits256> library_list, td::Promise<td::Unit> promise) {
+  td::MultiPromise mp;
+  auto ig = mp.init_guard();
+  ig.add_promise(std::move(promise));
+  for (size_t i = 0; i < library_list.size(); i += 16) {
+    size_t r = std::min(i + 16, library_list.size());
+    client_.send_query(
+        ton::lite_api::liteServer_getLibraries(
+            std::vector<td::Bits256>(library_list.begin() + i, library_list.begin() + r)),
+        [self = this, promise = ig.get_promise()](
+            td::Result<ton::lite_api::object_ptr<ton::lite_api::liteServer_libraryResult>> r_libraries) mutable {
+          self->process_new_libraries(std::move(r_libraries));
+          promise.set_value(td::Unit());
+        });
+  }
+}
+
 void TonlibClient::perform_smc_execution(td::Ref<ton::SmartContract> smc, ton::SmartContract::Args args,
                                          td::Promise<object_ptr<tonlib_api::smc_runResult>>&& promise) {
+  perform_smc_execution(std::move(smc), std::move(args), MissingLibraries{}, std::move(promise));
+}
 
+void TonlibClient::perform_smc_execution(td::Ref<ton::SmartContract> smc, ton::SmartContract::Args args,
+                                         MissingLibraries missing_libraries,
+                                         td::Promise<object_ptr<tonlib_api::smc_runResult>>&& promise) {
   args.set_libraries(libraries);
 
   auto res = smc->run_get_method(args);
 
-  // smc.runResult gas_used:int53 stack:vector<tvm.StackEntry> exit_code:int32 = smc.RunResult;
-  auto R = to_tonlib_api(res.stack);
-  if (R.is_error()) {
-    promise.set_error(R.move_as_error());
+  if (missing_libraries.add(res)) {
+    LOG(DEBUG) << "Requesting missing library: " << res.missing_library.value().to_hex();
+    auto library_list = missing_libraries.extract();
+    load_libraries(std::move(library_list),
+                   [self = this, smc = std::move(smc), args = std::move(args),
+                    missing_libraries = std::move(missing_libraries),
+                    promise = std::move(promise)](td::Result<td::Unit>) mutable {
+                     self->perform_smc_execution(std::move(smc), std::move(args), std::move(missing_libraries),
+                                                 std::move(promise));
+                   });
     return;
   }
-  auto res_stack = R.move_as_ok();
-
   if (res.missing_library) {
-    td::Bits256 hash = res.missing_library.value();
-    LOG(DEBUG) << "Requesting missing library: " << hash.to_hex();
-    std::vector<td::Bits256> req = {hash};
-    client_.send_query(ton::lite_api::liteServer_getLibraries(std::move(req)),
-                [self = this, res = std::move(res), res_stack = std::move(res_stack), hash,
-                 smc = std::move(smc), args = std::move(args), promise = std::move(promise)]
-                (td::Result<ton::lite_api::object_ptr<ton::lite_api::liteServer_libraryResult>> r_libraries) mutable
-    {
-      if (r_libraries.is_error()) {
-        LOG(WARNING) << "cannot obtain missing library: " << r_libraries.move_as_error().to_string();
-        promise.set_value(tonlib_api::make_object<tonlib_api::smc_runResult>(res.gas_used, std::move(res_stack), res.code));
-        return;
-      }
-      bool found = false, updated = false;
-      auto libraries = r_libraries.move_as_ok();
-      for (auto& lr : libraries->result_) {
-        auto contents = vm::std_boc_deserialize(lr->data_);
-        if (contents.is_ok() && contents.ok().not_null()) {
-          if (contents.ok()->get_hash().bits().compare(lr->hash_.cbits(), 256)) {
-            LOG(WARNING) << "hash mismatch for library " << lr->hash_.to_hex();
-            continue;
-          }
-          found |= (lr->hash_ == hash);
-          updated = true;
-          self->libraries.set_ref(lr->hash_, contents.move_as_ok());
-          LOG(DEBUG) << "registered library " << lr->hash_.to_hex();
-        } else {
-          LOG(WARNING) << "failed to deserialize library: " << lr->hash_.to_hex();
-        }
-      }
-      if (updated) {
-        self->store_libs_to_disk();
-      }
-      if (!found) {
-        LOG(WARNING) << "cannot obtain library " << hash.to_hex() << ", it may not exist";
-        promise.set_value(tonlib_api::make_object<tonlib_api::smc_runResult>(res.gas_used, std::move(res_stack), res.code));
-      } else {
-        self->perform_smc_execution(std::move(smc), std::move(args), std::move(promise));
-      }
-    });
-  }
-  else {
-    promise.set_value(tonlib_api::make_object<tonlib_api::smc_runResult>(res.gas_used, std::move(res_stack), res.code));
+    LOG(WARNING) << "cannot obtain library " << res.missing_library.value().to_hex() << ", it may not exist";
   }
+
+  // smc.runResult gas_used:int53 stack:vector<tvm.StackEntry> exit_code:int32 = smc.RunResult;
+  TRY_RESULT_PROMISE(promise, res_stack, to_tonlib_api(res.stack));
+  promise.set_value(tonlib_api::make_object<tonlib_api::smc_runResult>(res.gas_used, std::move(res_stack), res.code));
 }
 
 td::Result<tonlib_api::object_ptr<tonlib_api::dns_EntryData>> to_tonlib_api(
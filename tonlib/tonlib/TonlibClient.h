@@ -53,6 +53,7 @@ inline std::string to_string(const int_api::SendMessage&) {
 }
 }  // namespace int_api
 class AccountState;
+class MissingLibraries;
 class Query;
 class RunEmulator;
 
@@ -119,6 +120,7 @@ class TonlibClient : public td::actor::Actor {
   td::actor::ActorId<ExtClientOutbound> ext_client_outbound_;
   td::actor::ActorOwn<LastBlock> raw_last_block_;
   td::actor::ActorOwn<LastConfig> raw_last_config_;
+  std::shared_ptr<AccountStateCache> account_state_cache_;
   ExtClient client_;
 
   td::CancellationTokenSource source_;
@@ -332,6 +334,13 @@ class TonlibClient : public td::actor::Actor {
   td::Status do_request(const tonlib_api::smc_runGetMethod& request,
                         td::Promise<object_ptr<tonlib_api::smc_runResult>>&& promise);
 
+  struct GetMethodBatch;
+  td::Status do_request(const tonlib_api::smc_runGetMethodBatch& request,
+                        td::Promise<object_ptr<tonlib_api::smc_getMethodBatchResult>>&& promise);
+  void run_get_method_batch(std::shared_ptr<GetMethodBatch> batch, ton::BlockIdExt block_id);
+  void load_get_method_batch_libraries(std::shared_ptr<GetMethodBatch> batch);
+  void finish_get_method_batch(std::shared_ptr<GetMethodBatch> batch);
+
   td::Status do_request(const tonlib_api::smc_getLibraries& request,
                         td::Promise<object_ptr<tonlib_api::smc_libraryResult>>&& promise);
   void get_libraries(ton::BlockIdExt blkid, std::vector<td::Bits256> library_list_, td::Promise<object_ptr<tonlib_api::smc_libraryResult>>&& promise);
@@ -352,7 +361,11 @@ class TonlibClient : public td::actor::Actor {
 
   void process_new_libraries(
       td::Result<ton::lite_api::object_ptr<ton::lite_api::liteServer_libraryResult>> r_libraries);
+  void load_libraries(std::vector<td::Bits256> library_list, td::Promise<td::Unit> promise);
+  void perform_smc_execution(td::Ref<ton::SmartContract> smc, ton::SmartContract::Args args,
+                             td::Promise<object_ptr<tonlib_api::smc_runResult>>&& promise);
   void perform_smc_execution(td::Ref<ton::SmartContract> smc, ton::SmartContract::Args args,
+                             MissingLibraries missing_libraries,
                              td::Promise<object_ptr<tonlib_api::smc_runResult>>&& promise);
 
   void do_dns_request(std::string name, td::Bits256 category, td::int32 ttl, td::optional<ton::BlockIdExt> block_id,
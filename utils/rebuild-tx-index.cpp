@@ -0,0 +1,138 @@
+/*
+    This file is part of TON Blockchain source code.
+
+    TON Blockchain is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    TON Blockchain is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with TON Blockchain.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "td/utils/OptionParser.h"
+#include "td/utils/overloaded.h"
+#include "td/utils/port/path.h"
+#include "td/utils/Time.h"
+#include "td/db/RocksDb.h"
+#include "git.h"
+
+#include "validator/db/package.hpp"
+#include "validator/db/fileref.hpp"
+#include "validator/db/txindex.hpp"
+
+#include <iostream>
+
+// Fills the per-account transaction index (db/txindex) from blocks stored in archive packages.
+// Must be run while validator-engine is stopped. Indexing is idempotent, so it is safe to run it
+// on a partially indexed database.
+
+namespace {
+
+struct Stats {
+  size_t packages = 0;
+  size_t blocks = 0;
+  size_t transactions = 0;
+  size_t errors = 0;
+};
+
+td::Status index_package(td::KeyValue &kv, const std::string &filename, Stats &stats) {
+  TRY_RESULT(package, ton::Package::open(filename, true, false));
+  TRY_STATUS(kv.begin_write_batch());
+  package.iterate([&](std::string name, td::BufferSlice data, td::uint64) -> bool {
+    auto R = ton::validator::FileReference::create(name);
+    if (R.is_error()) {
+      return true;
+    }
+    R.ok_ref().ref().visit(td::overloaded(
+        [&](const ton::validator::fileref::Block &b) {
+          auto S = ton::validator::TxIndexDb::write_block(kv, b.block_id, data.as_slice());
+          if (S.is_error()) {
+            LOG(WARNING) << "cannot index block " << b.block_id.to_str() << " from " << filename << ": "
+                         << S.move_as_error();
+            ++stats.errors;
+          } else {
+            ++stats.blocks;
+            stats.transactions += S.ok();
+          }
+        },
+        [&](const auto &) {}));
+    return true;
+  });
+  TRY_STATUS(kv.commit_write_batch());
+  ++stats.packages;
+  return td::Status::OK();
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  SET_VERBOSITY_LEVEL(verbosity_INFO);
+
+  std::string db_root;
+  td::OptionParser p;
+  p.set_description("Rebuild per-account transaction index (--tx-index of validator-engine) from archive packages\n");
+  p.add_option('v', "verbosity", "set verbosity level", [&](td::Slice arg) {
+    int v = VERBOSITY_NAME(FATAL) + (td::to_integer<int>(arg));
+    SET_VERBOSITY_LEVEL(v);
+  });
+  p.add_option('V', "version", "show build information", [&]() {
+    std::cout << "rebuild-tx-index build information: [ Commit: " << GitMetadata::CommitSHA1()
+              << ", Date: " << GitMetadata::CommitDate() << "]\n";
+    std::exit(0);
+  });
+  p.add_option('h', "help", "print help", [&]() {
+    char b[10240];
+    td::StringBuilder sb(td::MutableSlice{b, 10000});
+    sb << p;
+    std::cout << sb.as_cslice().c_str();
+    std::exit(2);
+  });
+  p.add_option('D', "db", "root directory of validator-engine database", [&](td::Slice arg) { db_root = arg.str(); });
+  p.run(argc, argv).ensure();
+  if (db_root.empty()) {
+    std::cerr << "database root is not set (use -D)\n";
+    return 2;
+  }
+
+  auto R = td::RocksDb::open(db_root + "/txindex/");
+  if (R.is_error()) {
+    std::cerr << "cannot open transaction index: " << R.error().to_string() << "\n";
+    return 2;
+  }
+  auto kv = R.move_as_ok();
+
+  std::vector<std::string> packages;
+  auto S = td::WalkPath::run(db_root + "/archive/packages/", [&](td::CSlice name, td::WalkPath::Type type) {
+    if (type == td::WalkPath::Type::NotDir && td::ends_with(name, ".pack")) {
+      packages.push_back(name.str());
+    }
+  });
+  if (S.is_error()) {
+    std::cerr << "cannot list archive packages: " << S.to_string() << "\n";
+    return 2;
+  }
+  std::sort(packages.begin(), packages.end());
+
+  Stats stats;
+  auto start = td::Timestamp::now();
+  for (auto &filename : packages) {
+    auto S = index_package(kv, filename, stats);
+    if (S.is_error()) {
+      LOG(ERROR) << "cannot index package " << filename << ": " << S;
+      kv.abort_write_batch().ignore();
+      ++stats.errors;
+      continue;
+    }
+    LOG(INFO) << "indexed " << filename << " (" << stats.packages << "/" << packages.size()
+              << "), transactions: " << stats.transactions;
+  }
+  std::cout << "packages: " << stats.packages << ", blocks: " << stats.blocks
+            << ", transactions: " << stats.transactions << ", errors: " << stats.errors
+            << ", time: " << td::Timestamp::now().at() - start.at() << "s\n";
+  return stats.errors ? 1 : 0;
+}
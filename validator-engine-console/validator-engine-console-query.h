@@ -1130,6 +1130,29 @@ class GetActorStatsQuery : public Query {
   std::string file_name_;
 };
 
+class GetActorStatsPrometheusQuery : public Query {
+ public:
+  GetActorStatsPrometheusQuery(td::actor::ActorId<ValidatorEngineConsole> console, Tokenizer tokenizer)
+      : Query(console, std::move(tokenizer)) {
+  }
+  td::Status run() override;
+  td::Status send() override;
+  td::Status receive(td::BufferSlice data) override;
+  static std::string get_name() {
+    return "get-actor-stats-prometheus";
+  }
+  static std::string get_help() {
+    return "get-actor-stats-prometheus [<outfile>]\tget actor stats and latency histograms in the Prometheus text "
+           "format and print them either in stdout or in <outfile>";
+  }
+  std::string name() const override {
+    return get_name();
+  }
+
+ private:
+  std::string file_name_;
+};
+
 class GetPerfTimerStatsJsonQuery : public Query {
  public:
   GetPerfTimerStatsJsonQuery(td::actor::ActorId<ValidatorEngineConsole> console, Tokenizer tokenizer)
@@ -33,6 +33,7 @@
 #include "keys/keys.hpp"
 #include "overlay-manager.h"
 #include "overlays.h"
+#include "td/actor/ActorStats.h"
 #include "td/actor/PromiseFuture.h"
 #include "td/actor/actor.h"
 #include "td/utils/Status.h"
@@ -53,12 +54,14 @@
 #include "td/actor/MultiPromise.h"
 #include "td/utils/overloaded.h"
 #include "td/utils/OptionParser.h"
+#include "td/utils/port/CpuTopology.h"
 #include "td/utils/port/path.h"
 #include "td/utils/port/signals.h"
 #include "td/utils/port/user.h"
 #include "td/utils/port/rlimit.h"
 #include "td/utils/ThreadSafeCounter.h"
 #include "td/utils/TsFileLog.h"
+#include "td/utils/AsyncFileLog.h"
 #include "td/utils/Random.h"
 
 #include "auto/tl/lite_api.h"
@@ -67,6 +70,7 @@
 #include "memprof/memprof.h"
 
 #include "dht/dht.hpp"
+#include "http/http-server.h"
 #include <memory>
 #include <vector>
 
@@ -1375,6 +1379,7 @@ void ValidatorEngine::schedule_shutdown(double at) {
     ton::delay_action(
         []() {
           LOG(WARNING) << "Shutting down as scheduled";
+          td::AsyncFileLog::flush_all();
           std::_Exit(0);
         },
         ts);
@@ -1623,6 +1628,10 @@ td::Status ValidatorEngine::load_global_config() {
     validator_options_.write().set_catchain_max_block_delay_slow(catchain_max_block_delay_slow_.value());
   }
   validator_options_.write().set_permanent_celldb(permanent_celldb_);
+  validator_options_.write().set_tx_index_enabled(tx_index_enabled_);
+  if (!read_replica_db_.empty()) {
+    validator_options_.write().set_read_replica_path(db_root_ + "/replica/");
+  }
   validator_options_.write().set_initial_sync_disabled(skip_key_sync_);
 
   std::vector<ton::BlockIdExt> h;
@@ -1975,10 +1984,12 @@ void ValidatorEngine::load_config(td::Promise<td::Unit> promise) {
         [name = local_config_, new_name = config_file_, promise = std::move(promise)](td::Result<td::Unit> R) {
           if (R.is_error()) {
             LOG(ERROR) << "failed to parse local config '" << name << "': " << R.move_as_error();
+            td::AsyncFileLog::flush_all();
             std::_Exit(2);
           } else {
             LOG(ERROR) << "created config file '" << new_name << "'";
             LOG(ERROR) << "check it manually before continue";
+            td::AsyncFileLog::flush_all();
             std::_Exit(0);
           }
         });
@@ -2181,6 +2192,14 @@ void ValidatorEngine::start_validator() {
                                                           !state_serializer_disabled_flag_);
   load_collator_options();
 
+  if (!read_replica_db_.empty()) {
+    // the manager only reads the databases of the primary instance; adnl, keyring and config stay in db_root_
+    validator_manager_ =
+        ton::validator::ValidatorManagerFactory::create(validator_options_, read_replica_db_, keyring_.get(),
+                                                        adnl_.get(), rldp_.get(), rldp2_.get(), overlay_manager_.get());
+    started_validator();
+    return;
+  }
   validator_manager_ = ton::validator::ValidatorManagerFactory::create(
       validator_options_, db_root_, keyring_.get(), adnl_.get(), rldp_.get(), rldp2_.get(), overlay_manager_.get());
 
@@ -2214,6 +2233,11 @@ void ValidatorEngine::started_validator() {
 }
 
 void ValidatorEngine::start_full_node() {
+  if (!read_replica_db_.empty()) {
+    // read replica serves lite server queries only, blocks are downloaded by the primary instance
+    started_full_node();
+    return;
+  }
   if (!config_.full_node.is_zero() || !config_.full_node_slaves.empty()) {
     full_node_id_ = ton::adnl::AdnlNodeIdShort{config_.full_node};
     auto pk = ton::PrivateKey{ton::privkeys::Ed25519::random()};
@@ -2293,6 +2317,10 @@ void ValidatorEngine::started_lite_server() {
 }
 
 void ValidatorEngine::start_collator() {
+  if (!read_replica_db_.empty()) {
+    started_collator();
+    return;
+  }
   for (auto& [id, shards] : config_.collators) {
     for (auto& shard : shards) {
       td::actor::send_closure(validator_manager_, &ton::validator::ValidatorManagerInterface::add_collator, id, shard);
@@ -2364,6 +2392,10 @@ void ValidatorEngine::started_control_interface(td::actor::ActorOwn<ton::adnl::A
 }
 
 void ValidatorEngine::start_full_node_masters() {
+  if (!read_replica_db_.empty()) {
+    started_full_node_masters();
+    return;
+  }
   for (auto &x : config_.full_node_masters) {
     full_node_masters_.emplace(
         static_cast<td::uint16>(x.first),
@@ -4187,6 +4219,32 @@ void ValidatorEngine::run_control_query(ton::ton_api::engine_validator_getActorT
                           std::move(P));
 }
 
+void ValidatorEngine::run_control_query(ton::ton_api::engine_validator_getActorStatsPrometheus &query,
+                                        td::BufferSlice data, ton::PublicKeyHash src, td::uint32 perm,
+                                        td::Promise<td::BufferSlice> promise) {
+  if (!(perm & ValidatorEnginePermissions::vep_default)) {
+    promise.set_value(create_control_query_error(td::Status::Error(ton::ErrorCode::error, "not authorized")));
+    return;
+  }
+
+  if (validator_manager_.empty()) {
+    promise.set_value(
+        create_control_query_error(td::Status::Error(ton::ErrorCode::notready, "validator manager not started")));
+    return;
+  }
+
+  auto P = td::PromiseCreator::lambda([promise = std::move(promise)](td::Result<std::string> R) mutable {
+    if (R.is_error()) {
+      promise.set_value(create_control_query_error(R.move_as_error()));
+    } else {
+      auto r = R.move_as_ok();
+      promise.set_value(ton::create_serialize_tl_object<ton::ton_api::engine_validator_textStats>(std::move(r)));
+    }
+  });
+  td::actor::send_closure(validator_manager_,
+                          &ton::validator::ValidatorManagerInterface::prepare_actor_stats_prometheus, std::move(P));
+}
+
 void ValidatorEngine::run_control_query(ton::ton_api::engine_validator_getPerfTimerStats &query, td::BufferSlice data,
                                         ton::PublicKeyHash src, td::uint32 perm, td::Promise<td::BufferSlice> promise) {
   if (!(perm & ValidatorEnginePermissions::vep_default)) {
@@ -5121,6 +5179,7 @@ void ValidatorEngine::run() {
   auto Sr = load_global_config();
   if (Sr.is_error()) {
     LOG(ERROR) << "failed to load global config'" << global_config_ << "': " << Sr;
+    td::AsyncFileLog::flush_all();
     std::_Exit(2);
   }
 
@@ -5131,6 +5190,7 @@ void ValidatorEngine::run() {
   auto P = td::PromiseCreator::lambda([SelfId = actor_id(this)](td::Result<td::Unit> R) {
     if (R.is_error()) {
       LOG(ERROR) << "failed to parse config: " << R.move_as_error();
+      td::AsyncFileLog::flush_all();
       std::_Exit(2);
     } else {
       td::actor::send_closure(SelfId, &ValidatorEngine::start);
@@ -5216,12 +5276,44 @@ void dump_stats() {
   LOG(WARNING) << td::NamedThreadSafeCounter::get_default();
 }
 
+// Answers every request with actor statistics in the Prometheus text format
+class PrometheusHttpCallback : public ton::http::HttpServer::Callback {
+ public:
+  explicit PrometheusHttpCallback(td::actor::ActorId<td::actor::ActorStats> actor_stats)
+      : actor_stats_(std::move(actor_stats)) {
+  }
+  void receive_request(
+      std::unique_ptr<ton::http::HttpRequest> request, std::shared_ptr<ton::http::HttpPayload> payload,
+      td::Promise<std::pair<std::unique_ptr<ton::http::HttpResponse>, std::shared_ptr<ton::http::HttpPayload>>> promise)
+      override {
+    td::actor::send_closure(
+        actor_stats_, &td::actor::ActorStats::prepare_prometheus_stats,
+        promise.wrap([](std::string stats)
+                         -> td::Result<std::pair<std::unique_ptr<ton::http::HttpResponse>,
+                                                 std::shared_ptr<ton::http::HttpPayload>>> {
+          TRY_RESULT(response, ton::http::HttpResponse::create("HTTP/1.1", 200, "OK", false, false));
+          TRY_STATUS(response->add_header({"Content-Type", "text/plain; version=0.0.4"}));
+          TRY_STATUS(response->add_header({"Content-Length", PSTRING() << stats.size()}));
+          TRY_STATUS(response->complete_parse_header());
+          TRY_RESULT(response_payload, response->create_empty_payload());
+          response_payload->add_chunk(td::BufferSlice(stats));
+          response_payload->complete_parse();
+          return std::make_pair(std::move(response), std::move(response_payload));
+        }));
+  }
+
+ private:
+  td::actor::ActorId<td::actor::ActorStats> actor_stats_;
+};
+
 int main(int argc, char *argv[]) {
   SET_VERBOSITY_LEVEL(verbosity_INFO);
 
   td::set_default_failure_signal_handler().ensure();
 
   td::actor::ActorOwn<ValidatorEngine> x;
+  td::actor::ActorOwn<td::actor::ActorStats> prometheus_stats;
+  td::actor::ActorOwn<ton::http::HttpServer> prometheus_server;
   td::unique_ptr<td::LogInterface> logger_;
   SCOPE_EXIT {
     td::log_interface = td::default_log_interface;
@@ -5277,13 +5369,17 @@ int main(int argc, char *argv[]) {
     td::set_signal_handler(td::SignalType::HangUp, force_rotate_logs).ensure();
   });
   std::string session_logs_file;
+  std::string log_file;
+  bool async_log = false;
   p.add_option('l', "logname", "log to file", [&](td::Slice fname) {
     if (session_logs_file.empty()) {
       session_logs_file = fname.str() + ".session-stats";
     }
-    logger_ = td::TsFileLog::create(fname.str()).move_as_ok();
-    td::log_interface = logger_.get();
+    log_file = fname.str();
   });
+  p.add_option('\0', "async-log",
+               "write log file from a background thread, messages below WARNING are dropped if the log can't keep up",
+               [&]() { async_log = true; });
   p.add_checked_option('s', "state-ttl", "state will be gc'd after this time (in seconds) default=86400",
                        [&](td::Slice fname) {
                          auto v = td::to_double(fname);
@@ -5405,6 +5501,40 @@ int main(int argc, char *argv[]) {
         threads = v;
         return td::Status::OK();
       });
+  bool pin_threads = false;
+  p.add_option('\0', "pin-threads", "bind each worker thread to its own cpu, placed by cpu topology",
+               [&]() { pin_threads = true; });
+  std::vector<td::int32> numa_nodes;
+  p.add_checked_option('\0', "numa-nodes", "run only on cpus of the given NUMA nodes (e.g. 0 or 0-1)",
+                       [&](td::Slice arg) -> td::Status {
+                         TRY_RESULT_ASSIGN(numa_nodes, td::parse_cpu_list(arg));
+                         if (numa_nodes.empty()) {
+                           return td::Status::Error("bad value for --numa-nodes: empty list");
+                         }
+                         return td::Status::OK();
+                       });
+  std::vector<td::int32> cpus;
+  p.add_checked_option('\0', "cpus", "run only on the given cpus (e.g. 0-15,32-47)", [&](td::Slice arg) -> td::Status {
+    TRY_RESULT_ASSIGN(cpus, td::parse_cpu_list(arg));
+    if (cpus.empty()) {
+      return td::Status::Error("bad value for --cpus: empty list");
+    }
+    return td::Status::OK();
+  });
+  td::uint32 actor_stats_sampling = 64;
+  p.add_checked_option('\0', "actor-stats-sampling",
+                       PSTRING() << "sample one of every N actor events into latency histograms, 0 to disable (default="
+                                 << actor_stats_sampling << ")",
+                       [&](td::Slice arg) -> td::Status {
+                         TRY_RESULT_ASSIGN(actor_stats_sampling, td::to_integer_safe<td::uint32>(arg));
+                         return td::Status::OK();
+                       });
+  td::uint16 prometheus_port = 0;
+  p.add_checked_option('\0', "prometheus-port", "serve actor statistics in the Prometheus format on 127.0.0.1:<port>",
+                       [&](td::Slice arg) -> td::Status {
+                         TRY_RESULT_ASSIGN(prometheus_port, td::to_integer_safe<td::uint16>(arg));
+                         return td::Status::OK();
+                       });
   p.add_checked_option('u', "user", "change user", [&](td::Slice user) { return td::change_user(user.str()); });
   p.add_checked_option('\0', "shutdown-at", "stop validator at the given time (unix timestamp)", [&](td::Slice arg) {
     TRY_RESULT(at, td::to_integer_safe<td::uint32>(arg));
@@ -5568,6 +5698,21 @@ int main(int argc, char *argv[]) {
       "disable garbage collection in CellDb. This improves performance on archival nodes (once enabled, this option "
       "cannot be disabled)",
       [&]() { acts.push_back([&x]() { td::actor::send_closure(x, &ValidatorEngine::set_permanent_celldb, true); }); });
+  p.add_option('\0', "tx-index",
+               "maintain per-account transaction index in archive db for fast getTransactions (blocks applied before "
+               "enabling are not indexed, use rebuild-tx-index to index them)",
+               [&]() {
+                 acts.push_back([&x]() { td::actor::send_closure(x, &ValidatorEngine::set_tx_index_enabled, true); });
+               });
+  p.add_option('\0', "read-replica",
+               "run as a read replica of the validator-engine whose db root is <arg>: open its databases read-only "
+               "and serve lite server queries from them (no sync, no validation, external messages are rejected). "
+               "-D is used for own config, keys and replica logs",
+               [&](td::Slice fname) {
+                 acts.push_back([&x, db = fname.str()]() {
+                   td::actor::send_closure(x, &ValidatorEngine::set_read_replica_db, db);
+                 });
+               });
   p.add_option('\0', "skip-key-sync",
                "don't select the best persistent state on initial sync, start on init_block from global config", [&]() {
                  acts.push_back([&x]() { td::actor::send_closure(x, &ValidatorEngine::set_skip_key_sync, true); });
@@ -5602,12 +5747,38 @@ int main(int argc, char *argv[]) {
     LOG(ERROR) << "failed to parse options: " << S.move_as_error();
     std::_Exit(2);
   }
+  if (!log_file.empty()) {
+    logger_ = (async_log ? td::AsyncFileLog::create(log_file) : td::TsFileLog::create(log_file)).move_as_ok();
+    td::log_interface = logger_.get();
+  }
 
   td::set_runtime_signal_handler(1, need_stats).ensure();
   td::set_runtime_signal_handler(2, need_scheduler_status).ensure();
 
   td::actor::set_debug(true);
-  td::actor::Scheduler scheduler({threads});
+  td::actor::core::ActorTypeStatManager::set_sampling(actor_stats_sampling);
+  td::actor::Scheduler::NodeInfo node_info{threads};
+  if (pin_threads || !numa_nodes.empty() || !cpus.empty()) {
+    auto topology = td::CpuTopology::get();
+    if (!numa_nodes.empty()) {
+      topology = topology.restrict_to_nodes(numa_nodes);
+    }
+    if (!cpus.empty()) {
+      topology = topology.restrict_to_cpus(cpus);
+    }
+    if (topology.empty()) {
+      LOG(ERROR) << "no available cpus match --numa-nodes and --cpus";
+      std::_Exit(2);
+    }
+    LOG(INFO) << "Using cpus " << topology;
+    // threads created later, including io threads, inherit the affinity of the main thread
+    auto S_affinity = td::thread::set_affinity(td::this_thread::get_id(), topology.cpu_ids());
+    LOG_IF(ERROR, S_affinity.is_error()) << "failed to set cpu affinity: " << S_affinity;
+    if (pin_threads) {
+      node_info.pin_to(topology);
+    }
+  }
+  td::actor::Scheduler scheduler({node_info});
 
   scheduler.run_in_context([&] {
     vm::init_vm().ensure();
@@ -5617,6 +5788,11 @@ int main(int argc, char *argv[]) {
     }
     acts.clear();
     td::actor::send_closure(x, &ValidatorEngine::run);
+    if (prometheus_port != 0) {
+      prometheus_stats = td::actor::create_actor<td::actor::ActorStats>("prometheus_stats");
+      prometheus_server = ton::http::HttpServer::create(
+          prometheus_port, std::make_shared<PrometheusHttpCallback>(prometheus_stats.get()), "127.0.0.1");
+    }
   });
   while (scheduler.run(1)) {
     if (need_stats_flag.exchange(false)) {
@@ -256,6 +256,8 @@ class ValidatorEngine : public td::actor::Actor {
   double broadcast_speed_multiplier_public_ = 3.33;
   double broadcast_speed_multiplier_private_ = 3.33;
   bool permanent_celldb_ = false;
+  bool tx_index_enabled_ = false;
+  std::string read_replica_db_;
   bool skip_key_sync_ = false;
   td::optional<ton::BlockSeqno> sync_shards_upto_;
   ton::adnl::AdnlNodeIdShort shard_block_retainer_adnl_id_ = ton::adnl::AdnlNodeIdShort::zero();
@@ -378,6 +380,12 @@ class ValidatorEngine : public td::actor::Actor {
   void set_permanent_celldb(bool value) {
     permanent_celldb_ = value;
   }
+  void set_tx_index_enabled(bool value) {
+    tx_index_enabled_ = value;
+  }
+  void set_read_replica_db(std::string db) {
+    read_replica_db_ = std::move(db);
+  }
   void set_skip_key_sync(bool value) {
     skip_key_sync_ = value;
   }
@@ -588,6 +596,8 @@ class ValidatorEngine : public td::actor::Actor {
                          ton::PublicKeyHash src, td::uint32 perm, td::Promise<td::BufferSlice> promise);
   void run_control_query(ton::ton_api::engine_validator_getActorTextStats &query, td::BufferSlice data,
                          ton::PublicKeyHash src, td::uint32 perm, td::Promise<td::BufferSlice> promise);
+  void run_control_query(ton::ton_api::engine_validator_getActorStatsPrometheus &query, td::BufferSlice data,
+                         ton::PublicKeyHash src, td::uint32 perm, td::Promise<td::BufferSlice> promise);
   void run_control_query(ton::ton_api::engine_validator_addShard &query, td::BufferSlice data,
                          ton::PublicKeyHash src, td::uint32 perm, td::Promise<td::BufferSlice> promise);
   void run_control_query(ton::ton_api::engine_validator_delShard &query, td::BufferSlice data,
@@ -0,0 +1,240 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+#include "archive-lt-index.hpp"
+#include "ton/ton-shard.h"
+#include "common/errorcode.h"
+
+#include <algorithm>
+
+namespace ton {
+
+namespace validator {
+
+namespace {
+
+// Branchless binary search: the loop has a fixed number of iterations for a given size and compiles to cmov
+template <typename T>
+size_t branchless_lower_bound(const std::vector<T> &v, T value) {
+  if (v.empty()) {
+    return 0;
+  }
+  const T *base = v.data();
+  size_t len = v.size();
+  while (len > 1) {
+    size_t half = len / 2;
+    base += (base[half] < value) ? half : 0;
+    len -= half;
+  }
+  return (base - v.data()) + (*base < value);
+}
+
+}  // namespace
+
+void ArchiveLtIndex::Shard::append(const BlockIdExt &id, LogicalTime block_lt, UnixTime block_ts) {
+  lt.push_back(block_lt);
+  unix_time.push_back(block_ts);
+  seqno.push_back(id.seqno());
+  block_id.push_back(id);
+  last_lt = block_lt;
+  last_ts = block_ts;
+  last_seqno = id.seqno();
+}
+
+td::uint64 ArchiveLtIndex::Shard::get_last(Key key) const {
+  switch (key) {
+    case Key::lt:
+      return last_lt;
+    case Key::unix_time:
+      return last_ts;
+    case Key::seqno:
+      return last_seqno;
+  }
+  UNREACHABLE();
+}
+
+td::uint64 ArchiveLtIndex::Shard::get(Key key, size_t idx) const {
+  switch (key) {
+    case Key::lt:
+      return lt[idx];
+    case Key::unix_time:
+      return unix_time[idx];
+    case Key::seqno:
+      return seqno[idx];
+  }
+  UNREACHABLE();
+}
+
+size_t ArchiveLtIndex::Shard::lower_bound(Key key, td::uint64 value) const {
+  switch (key) {
+    case Key::lt:
+      return branchless_lower_bound<LogicalTime>(lt, value);
+    case Key::unix_time:
+      return branchless_lower_bound<UnixTime>(unix_time, static_cast<UnixTime>(value));
+    case Key::seqno:
+      return branchless_lower_bound<BlockSeqno>(seqno, static_cast<BlockSeqno>(value));
+  }
+  UNREACHABLE();
+}
+
+td::optional<td::Result<BlockIdExt>> ArchiveLtIndex::lookup(AccountIdPrefixFull account_id, Key key,
+                                                             td::uint64 value, bool exact) {
+  bool f = false;
+  BlockIdExt block_id;
+  td::uint32 ls = 0;
+  ++access_counter_;
+  for (td::uint32 len = 0; len <= 60; len++) {
+    auto it = shards_.find(shard_prefix(account_id, len));
+    if (it == shards_.end()) {
+      return {};
+    }
+    it->second.last_access = access_counter_;
+    if (!it->second.shard) {
+      if (!f) {
+        continue;
+      } else {
+        break;
+      }
+    }
+    auto s = &it->second.shard.value();
+    f = true;
+    if (value > s->get_last(key)) {
+      continue;
+    }
+    size_t pos = s->lower_bound(key, value);
+    if (pos < s->size() && s->get(key, pos) == value) {
+      return td::Result<BlockIdExt>(s->block_id[pos]);
+    }
+    if (pos < s->size()) {
+      auto &rseq = s->block_id[pos];
+      if (!block_id.is_valid() || block_id.id.seqno > rseq.id.seqno) {
+        block_id = rseq;
+      }
+    }
+    if (pos > 0) {
+      ls = std::max(ls, s->seqno[pos - 1]);
+    }
+    if (block_id.is_valid() && ls + 1 == block_id.id.seqno) {
+      if (!exact) {
+        return td::Result<BlockIdExt>(block_id);
+      }
+      return td::Result<BlockIdExt>(td::Status::Error(ErrorCode::notready, "ltdb: block not found"));
+    }
+  }
+  if (!exact && block_id.is_valid()) {
+    return td::Result<BlockIdExt>(block_id);
+  }
+  return td::Result<BlockIdExt>(td::Status::Error(ErrorCode::notready, "ltdb: block not found"));
+}
+
+std::set<ShardIdFull> ArchiveLtIndex::begin_load(AccountIdPrefixFull account_id) {
+  ++loads_in_progress_;
+  std::set<ShardIdFull> loaded;
+  for (td::uint32 len = 0; len <= 60; len++) {
+    auto shard = shard_prefix(account_id, len);
+    if (shards_.count(shard)) {
+      loaded.insert(shard);
+    }
+  }
+  return loaded;
+}
+
+bool ArchiveLtIndex::finish_load(td::uint64 epoch, LoadedShards shards) {
+  if (epoch != epoch_) {
+    return false;
+  }
+  CHECK(loads_in_progress_ > 0);
+  for (auto &p : shards) {
+    auto r = shards_.emplace(p.first, Entry{});
+    if (!r.second) {
+      // loaded by another query, possibly with blocks appended after that
+      continue;
+    }
+    auto &entry = r.first->second;
+    entry.shard = std::move(p.second);
+    auto it = appended_.find(p.first);
+    if (it != appended_.end()) {
+      // the database snapshot can be older than some appended blocks
+      for (auto &b : it->second) {
+        if (!entry.shard) {
+          entry.shard = Shard{};
+        }
+        auto &s = entry.shard.value();
+        if (s.size() == 0 || s.seqno.back() < b.id.seqno()) {
+          s.append(b.id, b.lt, b.ts);
+        }
+      }
+    }
+    entry.last_access = ++access_counter_;
+    total_elements_ += entry.elements();
+  }
+  if (--loads_in_progress_ == 0) {
+    appended_.clear();
+  }
+  return true;
+}
+
+void ArchiveLtIndex::shrink() {
+  if (loads_in_progress_ > 0 || total_elements_ <= max_elements_) {
+    return;
+  }
+  std::vector<std::pair<td::uint64, ShardIdFull>> order;
+  order.reserve(shards_.size());
+  for (auto &p : shards_) {
+    order.emplace_back(p.second.last_access, p.first);
+  }
+  std::sort(order.begin(), order.end());
+  for (auto &p : order) {
+    if (total_elements_ <= max_elements_) {
+      break;
+    }
+    auto it = shards_.find(p.second);
+    total_elements_ -= it->second.elements();
+    shards_.erase(it);
+  }
+}
+
+void ArchiveLtIndex::append(const BlockIdExt &id, LogicalTime lt, UnixTime ts) {
+  auto it = shards_.find(id.shard_full());
+  if (it == shards_.end()) {
+    // Not loaded yet, will be read from the database with this block
+    if (loads_in_progress_ > 0) {
+      appended_[id.shard_full()].push_back(Appended{id, lt, ts});
+    }
+    return;
+  }
+  auto &entry = it->second;
+  total_elements_ -= entry.elements();
+  if (!entry.shard) {
+    entry.shard = Shard{};
+  }
+  entry.shard.value().append(id, lt, ts);
+  total_elements_ += entry.elements();
+}
+
+void ArchiveLtIndex::clear() {
+  shards_.clear();
+  appended_.clear();
+  total_elements_ = 0;
+  loads_in_progress_ = 0;
+  ++epoch_;
+}
+
+}  // namespace validator
+
+}  // namespace ton
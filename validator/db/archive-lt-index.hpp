@@ -0,0 +1,120 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+#pragma once
+
+#include "ton/ton-types.h"
+#include "td/utils/optional.h"
+#include "td/utils/Status.h"
+
+#include <map>
+#include <set>
+
+namespace ton {
+
+namespace validator {
+
+/* In-memory copy of ltdb of an archive slice.
+ * Blocks of each shard are kept in columns sorted by seqno (lt and unix time grow together with seqno),
+ * so block lookups are answered without reading the database.
+ * Shards are loaded on first access by the owner (see ArchiveSlice), usually from a database snapshot in another
+ * thread. Blocks appended while a load is in progress are remembered and applied to the loaded shards.
+ * Least recently used shards are evicted when the total number of elements exceeds max_elements. */
+class ArchiveLtIndex {
+ public:
+  enum class Key { lt, unix_time, seqno };
+  static constexpr size_t DEFAULT_MAX_ELEMENTS = 1 << 16;
+
+  struct Shard {
+    // values from db.lt.desc.value, can be greater than the last element after truncation
+    LogicalTime last_lt = 0;
+    UnixTime last_ts = 0;
+    BlockSeqno last_seqno = 0;
+
+    std::vector<LogicalTime> lt;
+    std::vector<UnixTime> unix_time;
+    std::vector<BlockSeqno> seqno;
+    std::vector<BlockIdExt> block_id;
+
+    size_t size() const {
+      return block_id.size();
+    }
+    void append(const BlockIdExt &id, LogicalTime block_lt, UnixTime block_ts);
+    td::uint64 get_last(Key key) const;
+    td::uint64 get(Key key, size_t idx) const;
+    // number of elements that are less than value
+    size_t lower_bound(Key key, td::uint64 value) const;
+  };
+  // Empty optional means that there is no such shard in the database
+  using LoadedShards = std::vector<std::pair<ShardIdFull, td::optional<Shard>>>;
+
+  explicit ArchiveLtIndex(size_t max_elements = DEFAULT_MAX_ELEMENTS) : max_elements_(max_elements) {
+  }
+
+  // Same search as in ltdb: the block with the exact value or, if !exact, the first block after it.
+  // Returns empty optional if a shard on the search path is not loaded.
+  td::optional<td::Result<BlockIdExt>> lookup(AccountIdPrefixFull account_id, Key key, td::uint64 value, bool exact);
+
+  // Starts loading the shards for a lookup of account_id. Returns the shards on its path that are already loaded and
+  // need not be read; they are not evicted until the load is finished.
+  std::set<ShardIdFull> begin_load(AccountIdPrefixFull account_id);
+  // Adds the loaded shards. Returns false if the index was cleared after begin_load, then shards are dropped.
+  bool finish_load(td::uint64 epoch, LoadedShards shards);
+  td::uint64 epoch() const {
+    return epoch_;
+  }
+  // Evicts least recently used shards if there are too many elements and no loads are in progress
+  void shrink();
+
+  // Called after a block is added to the database
+  void append(const BlockIdExt &id, LogicalTime lt, UnixTime ts);
+  void clear();
+
+  size_t loaded_elements() const {
+    return total_elements_;
+  }
+
+ private:
+  struct Entry {
+    td::optional<Shard> shard;
+    td::uint64 last_access = 0;
+
+    size_t elements() const {
+      // missing shards are counted too, so that lookups of random accounts cannot grow the index without limit
+      return shard ? std::max<size_t>(shard.value().size(), 1) : 1;
+    }
+  };
+  struct Appended {
+    BlockIdExt id;
+    LogicalTime lt;
+    UnixTime ts;
+  };
+
+  std::map<ShardIdFull, Entry> shards_;
+  size_t max_elements_;
+  size_t total_elements_ = 0;
+  td::uint64 access_counter_ = 0;
+  td::uint64 epoch_ = 0;
+  size_t loads_in_progress_ = 0;
+  // blocks of not loaded shards appended while loads are in progress
+  std::map<ShardIdFull, std::vector<Appended>> appended_;
+};
+
+}  // namespace validator
+
+}  // namespace ton
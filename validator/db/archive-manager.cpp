@@ -57,7 +57,7 @@ std::string PackageId::name() const {
 
 ArchiveManager::ArchiveManager(td::actor::ActorId<RootDb> root, std::string db_root,
                                td::Ref<ValidatorManagerOptions> opts)
-    : db_root_(db_root), opts_(opts) {
+    : db_root_(db_root), opts_(opts), secondary_root_(opts->get_read_replica_path()) {
 }
 
 void ArchiveManager::add_handle(BlockHandle handle, td::Promise<td::Unit> promise) {
@@ -650,12 +650,39 @@ void ArchiveManager::load_package(PackageId id) {
   }
 
   desc.file = td::actor::create_actor<ArchiveSlice>("slice", id.id, id.key, id.temp, false, 0, db_root_,
-                                                    archive_lru_.get(), statistics_);
+                                                    archive_lru_.get(), statistics_, secondary_root_);
 
   m.emplace(id, std::move(desc));
   update_permanent_slices();
 }
 
+void ArchiveManager::reload_package_desc(FileMap &f, const FileDescription &desc) {
+  auto key = create_serialize_tl_object<ton_api::db_files_package_key>(desc.id.id, desc.id.key, desc.id.temp);
+
+  std::string value;
+  auto v = index_->get(key.as_slice(), value);
+  v.ensure();
+  CHECK(v.move_as_ok() == td::KeyValue::GetStatus::Ok);
+
+  auto R = fetch_tl_object<ton_api::db_files_package_value>(value, true);
+  R.ensure();
+  auto x = R.move_as_ok();
+  if (x->deleted_) {
+    desc.deleted = true;
+    return;
+  }
+  for (auto &e : x->firstblocks_) {
+    ShardIdFull shard{e->workchain_, static_cast<ShardId>(e->shard_)};
+    auto it = desc.first_blocks.find(shard);
+    if (it == desc.first_blocks.end() || it->second.seqno != static_cast<BlockSeqno>(e->seqno_)) {
+      f.set_shard_first_block(desc, shard,
+                              FileDescription::Desc{static_cast<BlockSeqno>(e->seqno_),
+                                                    static_cast<UnixTime>(e->unixtime_),
+                                                    static_cast<LogicalTime>(e->lt_)});
+    }
+  }
+}
+
 const ArchiveManager::FileDescription *ArchiveManager::get_file_desc(ShardIdFull shard, PackageId id, BlockSeqno seqno,
                                                                      UnixTime ts, LogicalTime lt, bool force) {
   auto &f = get_file_map(id);
@@ -884,6 +911,9 @@ void ArchiveManager::start_up() {
   }
   td::RocksDbOptions db_options;
   db_options.statistics = statistics_.rocksdb_statistics;
+  if (!secondary_root_.empty()) {
+    db_options.secondary_path = secondary_root_ + "/files/globalindex";
+  }
   index_ = std::make_shared<td::RocksDb>(
       td::RocksDb::open(db_root_ + "/files/globalindex", std::move(db_options)).move_as_ok());
   std::string value;
@@ -921,6 +951,10 @@ void ArchiveManager::start_up() {
         fname.remove_prefix(pos + 1);
       }
       auto R = FileReferenceShort::create(fname.str());
+      if (R.is_error() && !secondary_root_.empty()) {
+        // files are fixed up by the primary
+        return;
+      }
       if (R.is_error()) {
         auto R2 = FileReference::create(fname.str());
         if (R2.is_error()) {
@@ -935,6 +969,9 @@ void ArchiveManager::start_up() {
         R.ensure();
       }
       if (!R.ok().is_state_like()) {
+        if (!secondary_root_.empty()) {
+          return;
+        }
         LOG(ERROR) << "deleting file that is not state-like '" << fname << "'";
         td::unlink(db_root_ + "/archive/states/" + fname.str()).ignore();
         return;
@@ -943,7 +980,9 @@ void ArchiveManager::start_up() {
     }
   }).ensure();
 
-  persistent_state_gc({0, FileHash::zero()});
+  if (secondary_root_.empty()) {
+    persistent_state_gc({0, FileHash::zero()});
+  }
 
   double open_since = td::Clocks::system() - opts_->get_archive_preload_period();
   for (auto it = files_.rbegin(); it != files_.rend(); ++it) {
@@ -972,7 +1011,7 @@ void ArchiveManager::alarm() {
   alarm_timestamp() = td::Timestamp::in(60.0);
   auto stats = statistics_.to_string_and_reset();
   auto to_file_r =
-      td::FileFd::open(db_root_ + "/db_stats.txt", td::FileFd::Truncate | td::FileFd::Create | td::FileFd::Write, 0644);
+      td::FileFd::open((secondary_root_.empty() ? db_root_ : secondary_root_) + "/db_stats.txt", td::FileFd::Truncate | td::FileFd::Create | td::FileFd::Write, 0644);
   if (to_file_r.is_error()) {
     LOG(ERROR) << "Failed to open db_stats.txt: " << to_file_r.move_as_error();
     return;
@@ -986,6 +1025,72 @@ void ArchiveManager::alarm() {
   }
 }
 
+void ArchiveManager::catch_up_with_primary(td::Promise<td::Unit> promise) {
+  CHECK(!secondary_root_.empty());
+  TRY_STATUS_PROMISE(promise, index_->try_catch_up_with_primary());
+  std::string value;
+  auto v = index_->get(create_serialize_tl_object<ton_api::db_files_index_key>().as_slice(), value);
+  v.ensure();
+  if (v.move_as_ok() == td::KeyValue::GetStatus::Ok) {
+    auto R = fetch_tl_object<ton_api::db_files_index_value>(value, true);
+    R.ensure();
+    auto x = R.move_as_ok();
+
+    std::set<PackageId> ids;
+    for (auto &d : x->packages_) {
+      ids.insert(PackageId{static_cast<td::uint32>(d), false, false});
+    }
+    for (auto &d : x->key_packages_) {
+      ids.insert(PackageId{static_cast<td::uint32>(d), true, false});
+    }
+    for (auto &d : x->temp_packages_) {
+      ids.insert(PackageId{static_cast<td::uint32>(d), false, true});
+    }
+    // packages deleted by the primary
+    bool removed = false;
+    for (auto m : {&files_, &key_files_, &temp_files_}) {
+      for (auto it = m->begin(); it != m->end();) {
+        auto cur = it++;
+        if (!ids.count(cur->first)) {
+          m->erase(cur);
+          removed = true;
+        }
+      }
+    }
+    if (removed) {
+      update_permanent_slices();
+    }
+    for (auto &id : ids) {
+      auto &m = get_file_map(id);
+      auto it = m.find(id);
+      if (it == m.end()) {
+        load_package(id);
+      } else if (!id.temp && !it->second.deleted) {
+        reload_package_desc(m, it->second);
+      }
+    }
+  }
+
+  v = index_->get("finalizedupto", value);
+  v.ensure();
+  if (v.move_as_ok() == td::KeyValue::GetStatus::Ok) {
+    auto R = td::to_integer_safe<td::uint32>(value);
+    R.ensure();
+    finalized_up_to_ = R.move_as_ok();
+  }
+
+  td::MultiPromise mp;
+  auto ig = mp.init_guard();
+  ig.add_promise(std::move(promise));
+  for (auto m : {&files_, &key_files_, &temp_files_}) {
+    for (auto &f : *m) {
+      if (!f.second.deleted && !f.second.file_actor_id().empty()) {
+        td::actor::send_closure(f.second.file_actor_id(), &ArchiveSlice::catch_up_with_primary, ig.get_promise());
+      }
+    }
+  }
+}
+
 void ArchiveManager::run_gc(UnixTime mc_ts, UnixTime gc_ts, double archive_ttl) {
   auto p = get_temp_package_id_by_unixtime((double)mc_ts - TEMP_PACKAGES_TTL);
   std::vector<PackageId> vec;
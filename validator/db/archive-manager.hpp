@@ -76,6 +76,9 @@ class ArchiveManager : public td::actor::Actor {
   void start_up() override;
   void alarm() override;
 
+  // Read replica mode: reload the package list and the slices written by the primary since the last call
+  void catch_up_with_primary(td::Promise<td::Unit> promise);
+
   void commit_transaction();
   void set_async_mode(bool mode, td::Promise<td::Unit> promise);
 
@@ -200,6 +203,7 @@ class ArchiveManager : public td::actor::Actor {
   std::map<std::pair<BlockSeqno, FileHash>, PermState> perm_states_;  // Mc block seqno, hash -> state
 
   void load_package(PackageId seqno);
+  void reload_package_desc(FileMap &f, const FileDescription &desc);
   void delete_package(PackageId seqno, td::Promise<td::Unit> promise);
   void deleted_package(PackageId seqno, td::Promise<td::Unit> promise);
   void get_handle_cont(BlockIdExt block_id, PackageId id, td::Promise<BlockHandle> promise);
@@ -231,6 +235,8 @@ class ArchiveManager : public td::actor::Actor {
 
   std::string db_root_;
   td::Ref<ValidatorManagerOptions> opts_;
+  // non-empty in read replica mode
+  std::string secondary_root_;
 
   std::shared_ptr<td::KeyValue> index_;
 
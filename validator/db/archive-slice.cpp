@@ -230,6 +230,7 @@ void ArchiveSlice::add_handle(BlockHandle handle, td::Promise<td::Unit> promise)
   begin_transaction();
   kv_->set(key, serialize_tl_object(v, true)).ensure();
   kv_->set(db_key, db_value.as_slice()).ensure();
+  lt_index_.append(handle->id(), handle->logical_time(), handle->unix_time());
   if (add_shard) {
     auto shard_key = create_serialize_tl_object<ton_api::db_lt_shard_key>(idx);
     auto shard_value =
@@ -406,131 +407,160 @@ void ArchiveSlice::get_file(ConstBlockHandle handle, FileReference ref_id, td::P
   td::actor::create_actor<PackageReader>("reader", p->package, offset, std::move(P), statistics_.pack_statistics).release();
 }
 
-void ArchiveSlice::get_block_common(AccountIdPrefixFull account_id,
-                                    std::function<td::int32(ton_api::db_lt_desc_value &)> compare_desc,
-                                    std::function<td::int32(ton_api::db_lt_el_value &)> compare, bool exact,
-                                    td::Promise<ConstBlockHandle> promise) {
+void ArchiveSlice::get_block_common(AccountIdPrefixFull account_id, ArchiveLtIndex::Key key, td::uint64 value,
+                                    bool exact, td::Promise<ConstBlockHandle> promise) {
   if (destroyed_) {
     promise.set_error(td::Status::Error(ErrorCode::notready, "package already gc'd"));
     return;
   }
   before_query();
-  bool f = false;
-  BlockIdExt block_id;
-  td::uint32 ls = 0;
-  for (td::uint32 len = 0; len <= 60; len++) {
-    auto s = shard_prefix(account_id, len);
-    auto key = get_db_key_lt_desc(s);
-    std::string value;
-    auto F = kv_->get(key, value);
-    F.ensure();
-    if (F.move_as_ok() == td::KeyValue::GetStatus::NotFound) {
-      if (!f) {
-        continue;
-      } else {
-        break;
-      }
+  auto R = lt_index_.lookup(account_id, key, value, exact);
+  if (R) {
+    auto &r = R.value();
+    if (r.is_error()) {
+      promise.set_error(r.move_as_error());
+      return;
     }
-    f = true;
-    auto G = fetch_tl_object<ton_api::db_lt_desc_value>(value, true);
-    G.ensure();
-    auto g = G.move_as_ok();
-    if (compare_desc(*g) > 0) {
-      continue;
+    get_temp_handle(r.move_as_ok(), std::move(promise));
+    return;
+  }
+  auto epoch = lt_index_.epoch();
+  auto loaded = lt_index_.begin_load(account_id);
+  if (huge_transaction_started_ || !secondary_root_.empty()) {
+    // a snapshot would not see the blocks of the open transaction, secondary instances have no snapshots
+    got_lt_index_shards(account_id, key, value, exact, epoch, load_lt_index_shards(*kv_, account_id, loaded),
+                        std::move(promise));
+    return;
+  }
+  // Read the shards from a snapshot in a separate thread
+  delay_action(
+      [SelfId = actor_id(this), snapshot = kv_->snapshot(), account_id, key, value, exact, epoch,
+       loaded = std::move(loaded), promise = std::move(promise)]() mutable {
+        auto shards = load_lt_index_shards(*snapshot, account_id, loaded);
+        td::actor::send_closure(SelfId, &ArchiveSlice::got_lt_index_shards, account_id, key, value, exact, epoch,
+                                std::move(shards), std::move(promise));
+      },
+      td::Timestamp::now());
+}
+
+void ArchiveSlice::got_lt_index_shards(AccountIdPrefixFull account_id, ArchiveLtIndex::Key key, td::uint64 value,
+                                       bool exact, td::uint64 epoch, ArchiveLtIndex::LoadedShards shards,
+                                       td::Promise<ConstBlockHandle> promise) {
+  if (!lt_index_.finish_load(epoch, std::move(shards))) {
+    // the index was dropped (slice closed or truncated) while loading
+    get_block_common(account_id, key, value, exact, std::move(promise));
+    return;
+  }
+  auto R = lt_index_.lookup(account_id, key, value, exact);
+  lt_index_.shrink();
+  if (!R) {
+    // the slice got a new shard on the search path while loading
+    get_block_common(account_id, key, value, exact, std::move(promise));
+    return;
+  }
+  auto &r = R.value();
+  if (r.is_error()) {
+    promise.set_error(r.move_as_error());
+    return;
+  }
+  get_temp_handle(r.move_as_ok(), std::move(promise));
+}
+
+ArchiveLtIndex::LoadedShards ArchiveSlice::load_lt_index_shards(td::KeyValueReader &kv, AccountIdPrefixFull account_id,
+                                                                const std::set<ShardIdFull> &loaded) {
+  constexpr size_t BATCH_SIZE = 1024;
+  auto get_multi = [&](const std::vector<td::BufferSlice> &keys, size_t begin, size_t end) {
+    std::vector<td::Slice> key_slices;
+    key_slices.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+      key_slices.push_back(keys[i].as_slice());
     }
-    td::uint32 l = g->first_idx_ - 1;
-    BlockIdExt lseq;
-    td::uint32 r = g->last_idx_;
-    BlockIdExt rseq;
-    while (r - l > 1) {
-      auto x = (r + l) / 2;
-      auto db_key = get_db_key_lt_el(s, x);
-      F = kv_->get(db_key, value);
-      F.ensure();
-      CHECK(F.move_as_ok() == td::KeyValue::GetStatus::Ok);
-      auto E = fetch_tl_object<ton_api::db_lt_el_value>(td::BufferSlice{value}, true);
-      E.ensure();
-      auto e = E.move_as_ok();
-      int cmp_val = compare(*e);
-
-      if (cmp_val < 0) {
-        rseq = create_block_id(e->id_);
-        r = x;
-      } else if (cmp_val > 0) {
-        lseq = create_block_id(e->id_);
-        l = x;
-      } else {
-        get_temp_handle(create_block_id(e->id_), std::move(promise));
-        return;
+    std::vector<std::string> values;
+    auto statuses = kv.get_multi(key_slices, &values).move_as_ok();
+    for (size_t i = 0; i < statuses.size(); i++) {
+      if (statuses[i] == td::KeyValue::GetStatus::NotFound) {
+        values[i].clear();
       }
     }
-    if (rseq.is_valid()) {
-      if (!block_id.is_valid() || block_id.id.seqno > rseq.id.seqno) {
-        block_id = rseq;
+    return values;
+  };
+
+  // Descriptions of all shards on the search path are read in one batch
+  std::vector<ShardIdFull> path;
+  std::vector<td::BufferSlice> keys;
+  for (td::uint32 len = 0; len <= 60; len++) {
+    path.push_back(shard_prefix(account_id, len));
+    keys.push_back(create_serialize_tl_object<ton_api::db_lt_desc_key>(path.back().workchain, path.back().shard));
+  }
+  auto descs = get_multi(keys, 0, keys.size());
+
+  ArchiveLtIndex::LoadedShards result;
+  std::vector<tl_object_ptr<ton_api::db_lt_desc_value>> result_descs;
+  std::vector<td::BufferSlice> el_keys;
+  std::vector<size_t> el_shard;
+  bool f = false;
+  for (size_t i = 0; i < path.size(); i++) {
+    bool found = !descs[i].empty();
+    if (!loaded.count(path[i])) {
+      if (!found) {
+        result.emplace_back(path[i], td::optional<ArchiveLtIndex::Shard>{});
+        result_descs.push_back(nullptr);
+      } else {
+        auto G = fetch_tl_object<ton_api::db_lt_desc_value>(td::Slice{descs[i]}, true);
+        G.ensure();
+        auto g = G.move_as_ok();
+        for (td::int32 idx = g->first_idx_; idx < g->last_idx_; idx++) {
+          el_keys.push_back(create_serialize_tl_object<ton_api::db_lt_el_key>(path[i].workchain, path[i].shard, idx));
+          el_shard.push_back(result.size());
+        }
+        result.emplace_back(path[i], ArchiveLtIndex::Shard{});
+        result_descs.push_back(std::move(g));
       }
     }
-    if (lseq.is_valid()) {
-      if (ls < lseq.id.seqno) {
-        ls = lseq.id.seqno;
-      }
+    // same as in the search: it stops at the first missing shard after an existing one
+    if (found) {
+      f = true;
+    } else if (f) {
+      break;
     }
-    if (block_id.is_valid() && ls + 1 == block_id.id.seqno) {
-      if (!exact) {
-        get_temp_handle(block_id, std::move(promise));
-      } else {
-        promise.set_error(td::Status::Error(ErrorCode::notready, "ltdb: block not found"));
-      }
-      return;
+  }
+
+  for (size_t begin = 0; begin < el_keys.size(); begin += BATCH_SIZE) {
+    size_t end = std::min(begin + BATCH_SIZE, el_keys.size());
+    auto values = get_multi(el_keys, begin, end);
+    for (size_t i = begin; i < end; i++) {
+      auto &value = values[i - begin];
+      CHECK(!value.empty());
+      auto E = fetch_tl_object<ton_api::db_lt_el_value>(td::Slice{value}, true);
+      E.ensure();
+      auto e = E.move_as_ok();
+      result[el_shard[i]].second.value().append(create_block_id(e->id_), e->lt_, e->ts_);
     }
   }
-  if (!exact && block_id.is_valid()) {
-    get_temp_handle(block_id, std::move(promise));
-  } else {
-    promise.set_error(td::Status::Error(ErrorCode::notready, "ltdb: block not found"));
+  for (size_t i = 0; i < result.size(); i++) {
+    if (result_descs[i]) {
+      auto &shard = result[i].second.value();
+      shard.last_lt = result_descs[i]->last_lt_;
+      shard.last_ts = result_descs[i]->last_ts_;
+      shard.last_seqno = result_descs[i]->last_seqno_;
+    }
   }
+  return result;
 }
 
 void ArchiveSlice::get_block_by_lt(AccountIdPrefixFull account_id, LogicalTime lt,
                                    td::Promise<ConstBlockHandle> promise) {
-  return get_block_common(
-      account_id,
-      [lt](ton_api::db_lt_desc_value &w) {
-        return lt > static_cast<LogicalTime>(w.last_lt_) ? 1 : lt == static_cast<LogicalTime>(w.last_lt_) ? 0 : -1;
-      },
-      [lt](ton_api::db_lt_el_value &w) {
-        return lt > static_cast<LogicalTime>(w.lt_) ? 1 : lt == static_cast<LogicalTime>(w.lt_) ? 0 : -1;
-      },
-      false, std::move(promise));
+  return get_block_common(account_id, ArchiveLtIndex::Key::lt, lt, false, std::move(promise));
 }
 
 void ArchiveSlice::get_block_by_seqno(AccountIdPrefixFull account_id, BlockSeqno seqno,
                                       td::Promise<ConstBlockHandle> promise) {
-  return get_block_common(
-      account_id,
-      [seqno](ton_api::db_lt_desc_value &w) {
-        return seqno > static_cast<BlockSeqno>(w.last_seqno_)
-                   ? 1
-                   : seqno == static_cast<BlockSeqno>(w.last_seqno_) ? 0 : -1;
-      },
-      [seqno](ton_api::db_lt_el_value &w) {
-        return seqno > static_cast<BlockSeqno>(w.id_->seqno_)
-                   ? 1
-                   : seqno == static_cast<BlockSeqno>(w.id_->seqno_) ? 0 : -1;
-      },
-      true, std::move(promise));
+  return get_block_common(account_id, ArchiveLtIndex::Key::seqno, seqno, true, std::move(promise));
 }
 
 void ArchiveSlice::get_block_by_unix_time(AccountIdPrefixFull account_id, UnixTime ts,
                                           td::Promise<ConstBlockHandle> promise) {
-  return get_block_common(
-      account_id,
-      [ts](ton_api::db_lt_desc_value &w) {
-        return ts > static_cast<UnixTime>(w.last_ts_) ? 1 : ts == static_cast<UnixTime>(w.last_ts_) ? 0 : -1;
-      },
-      [ts](ton_api::db_lt_el_value &w) {
-        return ts > static_cast<UnixTime>(w.ts_) ? 1 : ts == static_cast<UnixTime>(w.ts_) ? 0 : -1;
-      },
-      false, std::move(promise));
+  return get_block_common(account_id, ArchiveLtIndex::Key::unix_time, ts, false, std::move(promise));
 }
 
 td::BufferSlice ArchiveSlice::get_db_key_lt_desc(ShardIdFull shard) {
@@ -587,96 +617,121 @@ void ArchiveSlice::before_query() {
     LOG(DEBUG) << "Opening archive slice " << db_path_;
     td::RocksDbOptions db_options;
     db_options.statistics = statistics_.rocksdb_statistics;
+    if (!secondary_root_.empty()) {
+      db_options.secondary_path = PSTRING() << secondary_root_ << p_id_.path() << p_id_.name() << ".index";
+    }
     kv_ = std::make_unique<td::RocksDb>(td::RocksDb::open(db_path_, std::move(db_options)).move_as_ok());
-    std::string value;
-    auto R2 = kv_->get("status", value);
-    R2.ensure();
     sliced_mode_ = false;
     slice_size_ = 100;
+    load_packages();
+  }
+  status_ = st_open;
+  if (!archive_lru_.empty()) {
+    td::actor::send_closure(archive_lru_, &ArchiveLru::on_query, actor_id(this), p_id_,
+                            packages_.size() + ESTIMATED_DB_OPEN_FILES);
+  }
+}
 
-    if (R2.move_as_ok() == td::KeyValue::GetStatus::Ok) {
-      if (value == "sliced") {
-        sliced_mode_ = true;
-        R2 = kv_->get("slices", value);
-        R2.ensure();
-        auto tot = td::to_integer<td::uint32>(value);
-        R2 = kv_->get("slice_size", value);
+void ArchiveSlice::load_packages() {
+  std::string value;
+  auto R2 = kv_->get("status", value);
+  R2.ensure();
+
+  if (R2.move_as_ok() == td::KeyValue::GetStatus::Ok) {
+    if (value == "sliced") {
+      sliced_mode_ = true;
+      R2 = kv_->get("slices", value);
+      R2.ensure();
+      auto tot = td::to_integer<td::uint32>(value);
+      R2 = kv_->get("slice_size", value);
+      R2.ensure();
+      slice_size_ = td::to_integer<td::uint32>(value);
+      CHECK(slice_size_ > 0);
+      R2 = kv_->get("shard_split_depth", value);
+      R2.ensure();
+      if (R2.move_as_ok() == td::KeyValue::GetStatus::Ok) {
+        shard_split_depth_ = td::to_integer<td::uint32>(value);
+        CHECK(shard_split_depth_ <= 60);
+        shard_separated_ = true;
+      } else {
+        shard_split_depth_ = 0;
+        shard_separated_ = false;
+      }
+      // packages are only appended, so after catching up with the primary only new ones have to be opened
+      for (auto i = td::narrow_cast<td::uint32>(packages_.size()); i < tot; i++) {
+        R2 = kv_->get(PSTRING() << "status." << i, value);
         R2.ensure();
-        slice_size_ = td::to_integer<td::uint32>(value);
-        CHECK(slice_size_ > 0);
-        R2 = kv_->get("shard_split_depth", value);
+        CHECK(R2.move_as_ok() == td::KeyValue::GetStatus::Ok);
+        auto len = td::to_integer<td::uint64>(value);
+        R2 = kv_->get(PSTRING() << "version." << i, value);
         R2.ensure();
+        td::uint32 ver = 0;
         if (R2.move_as_ok() == td::KeyValue::GetStatus::Ok) {
-          shard_split_depth_ = td::to_integer<td::uint32>(value);
-          CHECK(shard_split_depth_ <= 60);
-          shard_separated_ = true;
-        } else {
-          shard_split_depth_ = 0;
-          shard_separated_ = false;
+          ver = td::to_integer<td::uint32>(value);
         }
-        for (td::uint32 i = 0; i < tot; i++) {
-          R2 = kv_->get(PSTRING() << "status." << i, value);
+        td::uint32 seqno;
+        ShardIdFull shard_prefix;
+        if (shard_separated_) {
+          R2 = kv_->get(PSTRING() << "info." << i, value);
           R2.ensure();
           CHECK(R2.move_as_ok() == td::KeyValue::GetStatus::Ok);
-          auto len = td::to_integer<td::uint64>(value);
-          R2 = kv_->get(PSTRING() << "version." << i, value);
-          R2.ensure();
-          td::uint32 ver = 0;
-          if (R2.move_as_ok() == td::KeyValue::GetStatus::Ok) {
-            ver = td::to_integer<td::uint32>(value);
-          }
-          td::uint32 seqno;
-          ShardIdFull shard_prefix;
-          if (shard_separated_) {
-            R2 = kv_->get(PSTRING() << "info." << i, value);
-            R2.ensure();
-            CHECK(R2.move_as_ok() == td::KeyValue::GetStatus::Ok);
-            unsigned long long shard;
-            CHECK(sscanf(value.c_str(), "%u.%d:%016llx", &seqno, &shard_prefix.workchain, &shard) == 3);
-            shard_prefix.shard = shard;
-          } else {
-            seqno = archive_id_ + slice_size_ * i;
-            shard_prefix = ShardIdFull{masterchainId};
-          }
-          add_package(seqno, shard_prefix, len, ver);
+          unsigned long long shard;
+          CHECK(sscanf(value.c_str(), "%u.%d:%016llx", &seqno, &shard_prefix.workchain, &shard) == 3);
+          shard_prefix.shard = shard;
+        } else {
+          seqno = archive_id_ + slice_size_ * i;
+          shard_prefix = ShardIdFull{masterchainId};
+        }
+        if (!add_package(seqno, shard_prefix, len, ver)) {
+          break;
         }
-      } else {
-        auto len = td::to_integer<td::uint64>(value);
-        add_package(archive_id_, ShardIdFull{masterchainId}, len, 0);
       }
+    } else if (packages_.empty()) {
+      auto len = td::to_integer<td::uint64>(value);
+      add_package(archive_id_, ShardIdFull{masterchainId}, len, 0);
+    }
+  } else if (!secondary_root_.empty()) {
+    // the primary has not initialized the slice yet, it will be loaded after catching up
+  } else {
+    if (!temp_ && !key_blocks_only_) {
+      sliced_mode_ = true;
+      kv_->begin_transaction().ensure();
+      kv_->set("status", "sliced").ensure();
+      kv_->set("slices", "1").ensure();
+      kv_->set("slice_size", td::to_string(slice_size_)).ensure();
+      kv_->set("status.0", "0").ensure();
+      kv_->set("version.0", td::to_string(default_package_version())).ensure();
+      shard_separated_ = true;
+      kv_->set("info.0", package_info_to_str(archive_id_, ShardIdFull{masterchainId})).ensure();
+      kv_->set("shard_split_depth", td::to_string(shard_split_depth_)).ensure();
+      kv_->commit_transaction().ensure();
+      add_package(archive_id_, ShardIdFull{masterchainId}, 0, default_package_version());
     } else {
-      if (!temp_ && !key_blocks_only_) {
-        sliced_mode_ = true;
-        kv_->begin_transaction().ensure();
-        kv_->set("status", "sliced").ensure();
-        kv_->set("slices", "1").ensure();
-        kv_->set("slice_size", td::to_string(slice_size_)).ensure();
-        kv_->set("status.0", "0").ensure();
-        kv_->set("version.0", td::to_string(default_package_version())).ensure();
-        shard_separated_ = true;
-        kv_->set("info.0", package_info_to_str(archive_id_, ShardIdFull{masterchainId})).ensure();
-        kv_->set("shard_split_depth", td::to_string(shard_split_depth_)).ensure();
-        kv_->commit_transaction().ensure();
-        add_package(archive_id_, ShardIdFull{masterchainId}, 0, default_package_version());
-      } else {
-        kv_->begin_transaction().ensure();
-        kv_->set("status", "0").ensure();
-        kv_->commit_transaction().ensure();
-        add_package(archive_id_, ShardIdFull{masterchainId}, 0, 0);
-      }
+      kv_->begin_transaction().ensure();
+      kv_->set("status", "0").ensure();
+      kv_->commit_transaction().ensure();
+      add_package(archive_id_, ShardIdFull{masterchainId}, 0, 0);
     }
   }
-  status_ = st_open;
-  if (!archive_lru_.empty()) {
-    td::actor::send_closure(archive_lru_, &ArchiveLru::on_query, actor_id(this), p_id_,
-                            packages_.size() + ESTIMATED_DB_OPEN_FILES);
-  }
 }
 
 void ArchiveSlice::open_files() {
   before_query();
 }
 
+void ArchiveSlice::catch_up_with_primary(td::Promise<td::Unit> promise) {
+  CHECK(!secondary_root_.empty());
+  if (status_ == st_closed || destroyed_) {
+    // the latest state will be read when the slice is opened
+    promise.set_value(td::Unit());
+    return;
+  }
+  TRY_STATUS_PROMISE(promise, kv_->try_catch_up_with_primary());
+  load_packages();
+  lt_index_.clear();
+  promise.set_value(td::Unit());
+}
+
 void ArchiveSlice::close_files() {
   if (status_ == st_open) {
     if (active_queries_ == 0) {
@@ -713,6 +768,7 @@ void ArchiveSlice::do_close() {
   LOG(DEBUG) << "Closing archive slice " << db_path_;
   status_ = st_closed;
   kv_ = {};
+  lt_index_.clear();
   if (statistics_.pack_statistics) {
     statistics_.pack_statistics->record_close(packages_.size());
   }
@@ -775,7 +831,8 @@ void ArchiveSlice::set_async_mode(bool mode, td::Promise<td::Unit> promise) {
 
 ArchiveSlice::ArchiveSlice(td::uint32 archive_id, bool key_blocks_only, bool temp, bool finalized,
                            td::uint32 shard_split_depth, std::string db_root,
-                           td::actor::ActorId<ArchiveLru> archive_lru, DbStatistics statistics)
+                           td::actor::ActorId<ArchiveLru> archive_lru, DbStatistics statistics,
+                           std::string secondary_root)
     : archive_id_(archive_id)
     , key_blocks_only_(key_blocks_only)
     , temp_(temp)
@@ -783,6 +840,7 @@ ArchiveSlice::ArchiveSlice(td::uint32 archive_id, bool key_blocks_only, bool tem
     , p_id_(archive_id_, key_blocks_only_, temp_)
     , shard_split_depth_(temp || key_blocks_only ? 0 : shard_split_depth)
     , db_root_(std::move(db_root))
+    , secondary_root_(std::move(secondary_root))
     , archive_lru_(std::move(archive_lru))
     , statistics_(statistics) {
   db_path_ = PSTRING() << db_root_ << p_id_.path() << p_id_.name() << ".index";
@@ -790,6 +848,10 @@ ArchiveSlice::ArchiveSlice(td::uint32 archive_id, bool key_blocks_only, bool tem
 
 td::Result<ArchiveSlice::PackageInfo *> ArchiveSlice::choose_package(BlockSeqno masterchain_seqno,
                                                                      ShardIdFull shard_prefix, bool force) {
+  if (packages_.empty()) {
+    // possible only in read replica mode, before the primary creates the first package
+    return td::Status::Error(ErrorCode::notready, "no such package");
+  }
   if (temp_ || key_blocks_only_ || !sliced_mode_) {
     return &packages_[0];
   }
@@ -825,13 +887,29 @@ td::Result<ArchiveSlice::PackageInfo *> ArchiveSlice::choose_package(BlockSeqno
   }
 }
 
-void ArchiveSlice::add_package(td::uint32 seqno, ShardIdFull shard_prefix, td::uint64 size, td::uint32 version) {
+bool ArchiveSlice::add_package(td::uint32 seqno, ShardIdFull shard_prefix, td::uint64 size, td::uint32 version) {
   PackageId p_id{seqno, key_blocks_only_, temp_};
   std::string path = PSTRING() << db_root_ << p_id.path() << get_package_file_name(p_id, shard_prefix);
+  if (!secondary_root_.empty()) {
+    // read replica: the package is owned by the primary, it may be still growing but is never truncated here
+    auto R = Package::open(path, true, false);
+    if (R.is_error()) {
+      LOG(DEBUG) << "package '" << path << "' is not created by the primary yet: " << R.move_as_error();
+      return false;
+    }
+    if (statistics_.pack_statistics) {
+      statistics_.pack_statistics->record_open();
+    }
+    auto idx = td::narrow_cast<td::uint32>(packages_.size());
+    id_to_package_[{seqno, shard_prefix}] = idx;
+    packages_.emplace_back(std::make_shared<Package>(R.move_as_ok()), td::actor::ActorOwn<PackageWriter>(), seqno,
+                           shard_prefix, path, idx, version);
+    return true;
+  }
   auto R = Package::open(path, false, true);
   if (R.is_error()) {
     LOG(FATAL) << "failed to open/create archive '" << path << "': " << R.move_as_error();
-    return;
+    return false;
   }
   if (statistics_.pack_statistics) {
     statistics_.pack_statistics->record_open();
@@ -840,7 +918,7 @@ void ArchiveSlice::add_package(td::uint32 seqno, ShardIdFull shard_prefix, td::u
   id_to_package_[{seqno, shard_prefix}] = idx;
   if (finalized_) {
     packages_.emplace_back(nullptr, td::actor::ActorOwn<PackageWriter>(), seqno, shard_prefix, path, idx, version);
-    return;
+    return true;
   }
   auto pack = std::make_shared<Package>(R.move_as_ok());
   if (version >= 1) {
@@ -848,6 +926,7 @@ void ArchiveSlice::add_package(td::uint32 seqno, ShardIdFull shard_prefix, td::u
   }
   auto writer = td::actor::create_actor<PackageWriter>("writer", pack, async_mode_, statistics_.pack_statistics);
   packages_.emplace_back(std::move(pack), std::move(writer), seqno, shard_prefix, path, idx, version);
+  return true;
 }
 
 namespace {
@@ -882,6 +961,7 @@ void ArchiveSlice::destroy(td::Promise<td::Unit> promise) {
   packages_.clear();
   id_to_package_.clear();
   kv_ = nullptr;
+  lt_index_.clear();
 
   delay_action([name = db_path_, attempt = 0,
                 promise = std::move(promise)]() mutable { destroy_db(name, attempt, std::move(promise)); },
@@ -1069,6 +1149,7 @@ void ArchiveSlice::truncate(BlockSeqno masterchain_seqno, ConstBlockHandle, td::
     }
     truncate_shard(masterchain_seqno, shard, package->seqno, new_packages[package->shard_prefix].get());
   }
+  lt_index_.clear();
 
   for (auto& [shard_prefix, package] : old_packages) {
     auto new_package = new_packages[shard_prefix];
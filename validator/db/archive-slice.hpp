@@ -21,6 +21,7 @@
 #include "validator/interfaces/db.h"
 #include "package.hpp"
 #include "fileref.hpp"
+#include "archive-lt-index.hpp"
 #include "td/db/RocksDb.h"
 #include <map>
 
@@ -96,8 +97,10 @@ class ArchiveLru;
 
 class ArchiveSlice : public td::actor::Actor {
  public:
+  // Non-empty secondary_root opens the slice read-only as a secondary of the primary database at db_root
   ArchiveSlice(td::uint32 archive_id, bool key_blocks_only, bool temp, bool finalized, td::uint32 shard_split_depth,
-               std::string db_root, td::actor::ActorId<ArchiveLru> archive_lru, DbStatistics statistics = {});
+               std::string db_root, td::actor::ActorId<ArchiveLru> archive_lru, DbStatistics statistics = {},
+               std::string secondary_root = "");
 
   void get_archive_id(BlockSeqno masterchain_seqno, ShardIdFull shard_prefix, td::Promise<td::uint64> promise);
 
@@ -112,9 +115,7 @@ class ArchiveSlice : public td::actor::Actor {
   void get_block_by_unix_time(AccountIdPrefixFull account_id, UnixTime ts, td::Promise<ConstBlockHandle> promise);
   void get_block_by_lt(AccountIdPrefixFull account_id, LogicalTime lt, td::Promise<ConstBlockHandle> promise);
   void get_block_by_seqno(AccountIdPrefixFull account_id, BlockSeqno seqno, td::Promise<ConstBlockHandle> promise);
-  void get_block_common(AccountIdPrefixFull account_id,
-                        std::function<td::int32(ton_api::db_lt_desc_value &)> compare_desc,
-                        std::function<td::int32(ton_api::db_lt_el_value &)> compare, bool exact,
+  void get_block_common(AccountIdPrefixFull account_id, ArchiveLtIndex::Key key, td::uint64 value, bool exact,
                         td::Promise<ConstBlockHandle> promise);
 
   void get_slice(td::uint64 archive_id, td::uint64 offset, td::uint32 limit, td::Promise<td::BufferSlice> promise);
@@ -126,11 +127,13 @@ class ArchiveSlice : public td::actor::Actor {
 
   void open_files();
   void close_files();
+  void catch_up_with_primary(td::Promise<td::Unit> promise);
 
   void iterate_block_handles(std::function<void(const BlockHandleInterface &)> f);
 
  private:
   void before_query();
+  void load_packages();
   void do_close();
   template<typename T>
   td::Promise<T> begin_async_query(td::Promise<T> promise);
@@ -146,6 +149,11 @@ class ArchiveSlice : public td::actor::Actor {
   td::BufferSlice get_db_key_lt_desc(ShardIdFull shard);
   td::BufferSlice get_db_key_lt_el(ShardIdFull shard, td::uint32 idx);
   td::BufferSlice get_db_key_block_info(BlockIdExt block_id);
+  void got_lt_index_shards(AccountIdPrefixFull account_id, ArchiveLtIndex::Key key, td::uint64 value, bool exact,
+                           td::uint64 epoch, ArchiveLtIndex::LoadedShards shards,
+                           td::Promise<ConstBlockHandle> promise);
+  static ArchiveLtIndex::LoadedShards load_lt_index_shards(td::KeyValueReader &kv, AccountIdPrefixFull account_id,
+                                                           const std::set<ShardIdFull> &loaded);
 
   td::uint32 archive_id_;
 
@@ -170,9 +178,11 @@ class ArchiveSlice : public td::actor::Actor {
   size_t active_queries_ = 0;
 
   std::string db_root_;
+  std::string secondary_root_;
   td::actor::ActorId<ArchiveLru> archive_lru_;
   DbStatistics statistics_;
   std::unique_ptr<td::KeyValue> kv_;
+  ArchiveLtIndex lt_index_;
 
   struct PackageInfo {
     PackageInfo(std::shared_ptr<Package> package, td::actor::ActorOwn<PackageWriter> writer, BlockSeqno seqno, ShardIdFull shard_prefix,
@@ -197,7 +207,7 @@ class ArchiveSlice : public td::actor::Actor {
   std::map<std::pair<BlockSeqno, ShardIdFull>, td::uint32> id_to_package_;
 
   td::Result<PackageInfo *> choose_package(BlockSeqno masterchain_seqno, ShardIdFull shard_prefix, bool force);
-  void add_package(BlockSeqno masterchain_seqno, ShardIdFull shard_prefix, td::uint64 size, td::uint32 version);
+  bool add_package(BlockSeqno masterchain_seqno, ShardIdFull shard_prefix, td::uint64 size, td::uint32 version);
   void truncate_shard(BlockSeqno masterchain_seqno, ShardIdFull shard, td::uint32 cutoff_seqno, Package *pack);
   bool truncate_block(BlockSeqno masterchain_seqno, BlockIdExt block_id, td::uint32 cutoff_seqno, Package *pack);
 
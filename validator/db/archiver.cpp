@@ -25,8 +25,13 @@ namespace ton {
 namespace validator {
 
 BlockArchiver::BlockArchiver(BlockHandle handle, td::actor::ActorId<ArchiveManager> archive_db,
-                             td::actor::ActorId<Db> db, td::Promise<td::Unit> promise)
-    : handle_(std::move(handle)), archive_(archive_db), db_(std::move(db)), promise_(std::move(promise)) {
+                             td::actor::ActorId<TxIndexDb> tx_index, td::actor::ActorId<Db> db,
+                             td::Promise<td::Unit> promise)
+    : handle_(std::move(handle))
+    , archive_(archive_db)
+    , tx_index_(std::move(tx_index))
+    , db_(std::move(db))
+    , promise_(std::move(promise)) {
 }
 
 void BlockArchiver::start_up() {
@@ -124,6 +129,21 @@ void BlockArchiver::written_proof_link() {
 }
 
 void BlockArchiver::got_block_data(td::BufferSlice data) {
+  if (tx_index_.empty()) {
+    indexed_block_data(std::move(data));
+    return;
+  }
+  auto P = td::PromiseCreator::lambda([SelfId = actor_id(this), id = handle_->id(),
+                                       data = data.clone()](td::Result<td::Unit> R) mutable {
+    if (R.is_error()) {
+      VLOG(VALIDATOR_WARNING) << "failed to add block " << id.to_str() << " to transaction index: " << R.error();
+    }
+    td::actor::send_closure(SelfId, &BlockArchiver::indexed_block_data, std::move(data));
+  });
+  td::actor::send_closure(tx_index_, &TxIndexDb::add_block, handle_->id(), std::move(data), std::move(P));
+}
+
+void BlockArchiver::indexed_block_data(td::BufferSlice data) {
   auto P = td::PromiseCreator::lambda([SelfId = actor_id(this)](td::Result<td::Unit> R) {
     R.ensure();
     td::actor::send_closure(SelfId, &BlockArchiver::written_block_data);
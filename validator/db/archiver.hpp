@@ -23,6 +23,7 @@
 #include "validator/interfaces/block-handle.h"
 #include "ton/ton-io.hpp"
 #include "archive-manager.hpp"
+#include "txindex.hpp"
 
 namespace ton {
 
@@ -33,8 +34,8 @@ class FileDb;
 
 class BlockArchiver : public td::actor::Actor {
  public:
-  BlockArchiver(BlockHandle handle, td::actor::ActorId<ArchiveManager> archive_db, td::actor::ActorId<Db> db,
-                td::Promise<td::Unit> promise);
+  BlockArchiver(BlockHandle handle, td::actor::ActorId<ArchiveManager> archive_db,
+                td::actor::ActorId<TxIndexDb> tx_index, td::actor::ActorId<Db> db, td::Promise<td::Unit> promise);
 
   void abort_query(td::Status error);
 
@@ -46,12 +47,14 @@ class BlockArchiver : public td::actor::Actor {
   void got_proof_link(td::BufferSlice data);
   void written_proof_link();
   void got_block_data(td::BufferSlice data);
+  void indexed_block_data(td::BufferSlice data);
   void written_block_data();
   void finish_query();
 
  private:
   BlockHandle handle_;
   td::actor::ActorId<ArchiveManager> archive_;
+  td::actor::ActorId<TxIndexDb> tx_index_;
   td::actor::ActorId<Db> db_;
   td::Promise<td::Unit> promise_;
 };
@@ -79,7 +79,11 @@ void CellDbBase::execute_sync(std::function<void()> f) {
 
 CellDbIn::CellDbIn(td::actor::ActorId<RootDb> root_db, td::actor::ActorId<CellDb> parent, std::string path,
                    td::Ref<ValidatorManagerOptions> opts)
-    : root_db_(root_db), parent_(parent), path_(std::move(path)), opts_(opts) {
+    : root_db_(root_db)
+    , parent_(parent)
+    , path_(std::move(path))
+    , opts_(opts)
+    , read_replica_(!opts->get_read_replica_path().empty()) {
 }
 
 struct MergeOperatorAddCellRefcnt : public rocksdb::MergeOperator {
@@ -245,6 +249,10 @@ void CellDbIn::start_up() {
     LOG(WARNING) << "Set CellDb block cache size to " << td::format::as_size(o_celldb_cache_size.value());
   }
   db_options.use_direct_reads = opts_->get_celldb_direct_io();
+  if (read_replica_) {
+    LOG_IF(FATAL, opts_->get_celldb_in_memory()) << "celldb in-memory mode is not supported in read replica mode";
+    db_options.secondary_path = opts_->get_read_replica_path() + "/celldb/";
+  }
 
   // NB: from now on we MUST use this merge operator
   // Only V2 and InMemory BoC actually use them, but it still should be kept for V1,
@@ -286,7 +294,9 @@ void CellDbIn::start_up() {
   alarm_timestamp() = td::Timestamp::in(10.0);
 
   auto empty = get_empty_key_hash();
-  if (get_block(empty).is_error()) {
+  if (read_replica_) {
+    LOG_IF(FATAL, get_block(empty).is_error()) << "celldb of the primary instance is not initialized";
+  } else if (get_block(empty).is_error()) {
     DbEntry e{get_empty_key(), empty, empty, RootHash::zero()};
     vm::CellStorer stor{*cell_db_};
     cell_db_->begin_write_batch().ensure();
@@ -345,7 +355,7 @@ void CellDbIn::start_up() {
     permanent_mode_ = stored_permanent_mode || opts_->get_permanent_celldb();
     if (permanent_mode_) {
       LOG(WARNING) << "Celldb is in permanent mode";
-      if (!stored_permanent_mode) {
+      if (!stored_permanent_mode && !read_replica_) {
         cell_db_->begin_write_batch().ensure();
         value = "1";
         vm::CellStorer stor{*cell_db_};
@@ -702,7 +712,7 @@ void CellDbIn::alarm() {
               << " queue_size=" << cells_to_migrate_.size();
     migration_stats_ = {};
   }
-  if (permanent_mode_) {
+  if (permanent_mode_ || read_replica_) {
     skip_gc();
     return;
   }
@@ -855,6 +865,24 @@ void CellDbIn::skip_gc() {
   alarm_timestamp() = td::Timestamp::in(1.0);
 }
 
+void CellDbIn::catch_up_with_primary(td::Promise<td::Unit> promise) {
+  CHECK(read_replica_);
+  if (db_busy_) {
+    action_queue_.push([self = this, promise = std::move(promise)](td::Result<td::Unit> R) mutable {
+      R.ensure();
+      self->catch_up_with_primary(std::move(promise));
+    });
+    return;
+  }
+  TRY_STATUS_PROMISE(promise, cell_db_->try_catch_up_with_primary());
+  auto snapshot = cell_db_->snapshot();
+  boc_->set_loader(std::make_unique<vm::CellLoader>(cell_db_->snapshot(), on_load_callback_)).ensure();
+  if (!opts_->get_celldb_v2()) {
+    send_closure(parent_, &CellDb::update_snapshot, std::move(snapshot));
+  }
+  promise.set_value(td::Unit());
+}
+
 std::string CellDbIn::get_key(KeyHash key_hash) {
   if (!key_hash.is_zero()) {
     return PSTRING() << "desc" << key_hash;
@@ -899,7 +927,7 @@ void CellDbIn::set_block(KeyHash key_hash, DbEntry e) {
 }
 
 void CellDbIn::migrate_cell(td::Bits256 hash) {
-  if (permanent_mode_) {
+  if (permanent_mode_ || read_replica_) {
     return;
   }
   cells_to_migrate_.insert(hash);
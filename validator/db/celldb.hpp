@@ -72,6 +72,7 @@ class CellDbIn : public CellDbBase {
   void migrate_cell(td::Bits256 hash);
 
   void flush_db_stats();
+  void catch_up_with_primary(td::Promise<td::Unit> promise);
 
   CellDbIn(td::actor::ActorId<RootDb> root_db, td::actor::ActorId<CellDb> parent, std::string path,
            td::Ref<ValidatorManagerOptions> opts);
@@ -117,6 +118,7 @@ class CellDbIn : public CellDbBase {
 
   std::string path_;
   td::Ref<ValidatorManagerOptions> opts_;
+  bool read_replica_ = false;
 
   std::shared_ptr<vm::DynamicBagOfCellsDb> boc_;
   std::shared_ptr<vm::KeyValue> cell_db_;
@@ -213,6 +215,9 @@ class CellDb : public CellDbBase {
     thread_safe_boc_ = std::move(thread_safe_boc);
   }
   void get_cell_db_reader(td::Promise<std::shared_ptr<vm::CellDbReader>> promise);
+  void catch_up_with_primary(td::Promise<td::Unit> promise) {
+    td::actor::send_closure(cell_db_, &CellDbIn::catch_up_with_primary, std::move(promise));
+  }
 
   CellDb(td::actor::ActorId<RootDb> root_db, std::string path, td::Ref<ValidatorManagerOptions> opts)
       : root_db_(root_db), path_(path), opts_(opts) {
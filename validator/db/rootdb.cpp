@@ -389,8 +389,8 @@ void RootDb::try_get_static_file(FileHash file_hash, td::Promise<td::BufferSlice
 }
 
 void RootDb::apply_block(BlockHandle handle, td::Promise<td::Unit> promise) {
-  td::actor::create_actor<BlockArchiver>("archiver", std::move(handle), archive_db_.get(), actor_id(this),
-                                         std::move(promise))
+  td::actor::create_actor<BlockArchiver>("archiver", std::move(handle), archive_db_.get(), tx_index_.get(),
+                                         actor_id(this), std::move(promise))
       .release();
 }
 
@@ -406,6 +406,15 @@ void RootDb::get_block_by_seqno(AccountIdPrefixFull account, BlockSeqno seqno, t
   td::actor::send_closure(archive_db_, &ArchiveManager::get_block_by_seqno, account, seqno, std::move(promise));
 }
 
+void RootDb::get_account_transactions(WorkchainId workchain, StdSmcAddress addr, LogicalTime lt, td::uint32 count,
+                                      td::Promise<std::vector<AccountTransactionRef>> promise) {
+  if (tx_index_.empty()) {
+    promise.set_error(td::Status::Error(ErrorCode::notready, "transaction index is not enabled"));
+    return;
+  }
+  td::actor::send_closure(tx_index_, &TxIndexDb::get_transactions, workchain, addr, lt, count, std::move(promise));
+}
+
 void RootDb::update_init_masterchain_block(BlockIdExt block, td::Promise<td::Unit> promise) {
   td::actor::send_closure(state_db_, &StateDb::update_init_masterchain_block, block, std::move(promise));
 }
@@ -457,15 +466,49 @@ void RootDb::get_hardforks(td::Promise<std::vector<BlockIdExt>> promise) {
 }
 
 void RootDb::start_up() {
+  // in read replica mode all databases are opened as secondary instances, their logs are kept in the replica dir
+  auto replica_path = opts_->get_read_replica_path();
   cell_db_ = td::actor::create_actor<CellDb>("celldb", actor_id(this), root_path_ + "/celldb/", opts_);
-  state_db_ = td::actor::create_actor<StateDb>("statedb", actor_id(this), root_path_ + "/state/");
+  state_db_ = td::actor::create_actor<StateDb>("statedb", actor_id(this), root_path_ + "/state/",
+                                               replica_path.empty() ? "" : replica_path + "/state/");
   static_files_db_ = td::actor::create_actor<StaticFilesDb>("staticfilesdb", actor_id(this), root_path_ + "/static/");
   archive_db_ = td::actor::create_actor<ArchiveManager>("archive", actor_id(this), root_path_, opts_);
+  if (opts_->get_tx_index_enabled()) {
+    tx_index_ = td::actor::create_actor<TxIndexDb>("txindex", root_path_ + "/txindex/",
+                                                   replica_path.empty() ? "" : replica_path + "/txindex/");
+  }
+}
+
+void RootDb::catch_up_with_primary(td::Promise<td::Unit> promise) {
+  if (opts_->get_read_replica_path().empty()) {
+    promise.set_error(td::Status::Error(ErrorCode::error, "not a read replica"));
+    return;
+  }
+  // statedb goes first: the primary stores blocks and states before it moves the shard client state,
+  // so everything the new shard client state refers to is visible after the other databases catch up
+  auto P = td::PromiseCreator::lambda(
+      [SelfId = actor_id(this), promise = std::move(promise)](td::Result<td::Unit> R) mutable {
+        TRY_STATUS_PROMISE(promise, R.move_as_status());
+        td::actor::send_closure(SelfId, &RootDb::catch_up_with_primary_cont, std::move(promise));
+      });
+  td::actor::send_closure(state_db_, &StateDb::catch_up_with_primary, std::move(P));
+}
+
+void RootDb::catch_up_with_primary_cont(td::Promise<td::Unit> promise) {
+  td::MultiPromise mp;
+  auto ig = mp.init_guard();
+  ig.add_promise(std::move(promise));
+
+  td::actor::send_closure(cell_db_, &CellDb::catch_up_with_primary, ig.get_promise());
+  td::actor::send_closure(archive_db_, &ArchiveManager::catch_up_with_primary, ig.get_promise());
+  if (!tx_index_.empty()) {
+    td::actor::send_closure(tx_index_, &TxIndexDb::catch_up_with_primary, ig.get_promise());
+  }
 }
 
 void RootDb::archive(BlockHandle handle, td::Promise<td::Unit> promise) {
-  td::actor::create_actor<BlockArchiver>("archiveblock", std::move(handle), archive_db_.get(), actor_id(this),
-                                         std::move(promise))
+  td::actor::create_actor<BlockArchiver>("archiveblock", std::move(handle), archive_db_.get(), tx_index_.get(),
+                                         actor_id(this), std::move(promise))
       .release();
 }
 
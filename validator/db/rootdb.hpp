@@ -26,6 +26,7 @@
 #include "statedb.hpp"
 #include "staticfilesdb.hpp"
 #include "archive-manager.hpp"
+#include "txindex.hpp"
 #include "validator.h"
 
 namespace ton {
@@ -102,6 +103,8 @@ class RootDb : public Db {
   void get_block_by_unix_time(AccountIdPrefixFull account, UnixTime ts, td::Promise<ConstBlockHandle> promise) override;
   void get_block_by_seqno(AccountIdPrefixFull account, BlockSeqno seqno,
                           td::Promise<ConstBlockHandle> promise) override;
+  void get_account_transactions(WorkchainId workchain, StdSmcAddress addr, LogicalTime lt, td::uint32 count,
+                                td::Promise<std::vector<AccountTransactionRef>> promise) override;
 
   void update_init_masterchain_block(BlockIdExt block, td::Promise<td::Unit> promise) override;
   void get_init_masterchain_block(td::Promise<BlockIdExt> promise) override;
@@ -129,6 +132,8 @@ class RootDb : public Db {
   void prepare_stats(td::Promise<std::vector<std::pair<std::string, std::string>>> promise) override;
 
   void truncate(BlockSeqno seqno, ConstBlockHandle handle, td::Promise<td::Unit> promise) override;
+  void catch_up_with_primary(td::Promise<td::Unit> promise) override;
+  void catch_up_with_primary_cont(td::Promise<td::Unit> promise);
 
   void add_key_block_proof(td::Ref<Proof> proof, td::Promise<td::Unit> promise) override;
   void add_key_block_proof_link(td::Ref<ProofLink> proof_link, td::Promise<td::Unit> promise) override;
@@ -157,6 +162,7 @@ class RootDb : public Db {
   td::actor::ActorOwn<StateDb> state_db_;
   td::actor::ActorOwn<StaticFilesDb> static_files_db_;
   td::actor::ActorOwn<ArchiveManager> archive_db_;
+  td::actor::ActorOwn<TxIndexDb> tx_index_;
 };
 
 }  // namespace validator
@@ -217,11 +217,14 @@ void StateDb::get_hardforks(td::Promise<std::vector<BlockIdExt>> promise) {
   promise.set_value(std::move(vec));
 }
 
-StateDb::StateDb(td::actor::ActorId<RootDb> root_db, std::string db_path) : root_db_(root_db), db_path_(db_path) {
+StateDb::StateDb(td::actor::ActorId<RootDb> root_db, std::string db_path, std::string secondary_path)
+    : root_db_(root_db), db_path_(db_path), secondary_path_(std::move(secondary_path)) {
 }
 
 void StateDb::start_up() {
-  kv_ = std::make_shared<td::RocksDb>(td::RocksDb::open(db_path_).move_as_ok());
+  td::RocksDbOptions db_options;
+  db_options.secondary_path = secondary_path_;
+  kv_ = std::make_shared<td::RocksDb>(td::RocksDb::open(db_path_, std::move(db_options)).move_as_ok());
 
   std::string value;
   auto R = kv_->get(create_serialize_tl_object<ton_api::db_state_key_dbVersion>(), value);
@@ -232,6 +235,7 @@ void StateDb::start_up() {
     auto f = F.move_as_ok();
     CHECK(f->version_ == 2);
   } else {
+    LOG_IF(FATAL, !secondary_path_.empty()) << "statedb of the primary instance is not initialized";
     kv_->begin_write_batch().ensure();
     kv_->set(create_serialize_tl_object<ton_api::db_state_key_dbVersion>(),
              create_serialize_tl_object<ton_api::db_state_dbVersion>(2))
@@ -240,6 +244,10 @@ void StateDb::start_up() {
   }
 }
 
+void StateDb::catch_up_with_primary(td::Promise<td::Unit> promise) {
+  promise.set_result(kv_->try_catch_up_with_primary());
+}
+
 void StateDb::add_persistent_state_description(td::Ref<PersistentStateDescription> desc,
                                                td::Promise<td::Unit> promise) {
   std::string value;
@@ -0,0 +1,184 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "txindex.hpp"
+#include "ton/ton-tl.hpp"
+#include "td/db/RocksDb.h"
+#include "vm/boc.h"
+#include "vm/dict.h"
+#include "block/block-parse.h"
+#include "block/block-auto.h"
+
+#include <cstring>
+
+namespace ton {
+
+namespace validator {
+
+namespace {
+
+void store_be(unsigned char *ptr, td::uint64 value, int bytes) {
+  for (int i = bytes - 1; i >= 0; i--) {
+    ptr[i] = static_cast<unsigned char>(value & 0xff);
+    value >>= 8;
+  }
+}
+
+td::uint64 fetch_be(const unsigned char *ptr, int bytes) {
+  td::uint64 value = 0;
+  for (int i = 0; i < bytes; i++) {
+    value = (value << 8) | ptr[i];
+  }
+  return value;
+}
+
+}  // namespace
+
+std::string TxIndexDb::make_key(WorkchainId workchain, const StdSmcAddress &addr, LogicalTime lt) {
+  std::string key(key_size, '\0');
+  auto ptr = reinterpret_cast<unsigned char *>(&key[0]);
+  store_be(ptr, static_cast<td::uint32>(workchain) ^ 0x80000000u, 4);
+  std::memcpy(ptr + 4, addr.data(), 32);
+  store_be(ptr + 36, ~lt, 8);
+  return key;
+}
+
+TxIndexDb::TxIndexDb(std::string path, std::string secondary_path)
+    : path_(std::move(path)), secondary_path_(std::move(secondary_path)) {
+}
+
+void TxIndexDb::start_up() {
+  td::RocksDbOptions db_options;
+  db_options.secondary_path = secondary_path_;
+  kv_ = std::make_shared<td::RocksDb>(td::RocksDb::open(path_, std::move(db_options)).move_as_ok());
+}
+
+void TxIndexDb::catch_up_with_primary(td::Promise<td::Unit> promise) {
+  promise.set_result(kv_->try_catch_up_with_primary());
+}
+
+void TxIndexDb::add_block(BlockIdExt block_id, td::BufferSlice data, td::Promise<td::Unit> promise) {
+  kv_->begin_write_batch().ensure();
+  auto R = write_block(*kv_, block_id, data.as_slice());
+  if (R.is_error()) {
+    kv_->abort_write_batch().ensure();
+    promise.set_error(R.move_as_error_prefix(PSTRING() << "cannot index block " << block_id.to_str() << ": "));
+    return;
+  }
+  kv_->commit_write_batch().ensure();
+  promise.set_value(td::Unit());
+}
+
+void TxIndexDb::get_transactions(WorkchainId workchain, StdSmcAddress addr, LogicalTime lt, td::uint32 count,
+                                 td::Promise<std::vector<AccountTransactionRef>> promise) {
+  promise.set_result(read_transactions(*kv_, workchain, addr, lt, count));
+}
+
+td::Result<std::vector<TxIndexDb::Entry>> TxIndexDb::extract_transactions(td::Ref<vm::Cell> block_root) {
+  std::vector<Entry> result;
+  try {
+    block::gen::Block::Record blk;
+    block::gen::BlockExtra::Record extra;
+    if (!(tlb::unpack_cell(std::move(block_root), blk) && tlb::unpack_cell(std::move(blk.extra), extra))) {
+      return td::Status::Error("cannot unpack block extra");
+    }
+    vm::AugmentedDictionary acc_dict{vm::load_cell_slice_ref(extra.account_blocks), 256,
+                                     block::tlb::aug_ShardAccountBlocks};
+    bool ok = acc_dict.check_for_each_extra(
+        [&](td::Ref<vm::CellSlice> value, td::Ref<vm::CellSlice>, td::ConstBitPtr, int) {
+          block::gen::AccountBlock::Record acc_blk;
+          if (!tlb::csr_unpack(std::move(value), acc_blk)) {
+            return false;
+          }
+          vm::AugmentedDictionary trans_dict{vm::DictNonEmpty(), std::move(acc_blk.transactions), 64,
+                                             block::tlb::aug_AccountTransactions};
+          return trans_dict.check_for_each_extra(
+              [&](td::Ref<vm::CellSlice> tvalue, td::Ref<vm::CellSlice>, td::ConstBitPtr tkey, int) {
+                auto root = tvalue->prefetch_ref();
+                if (root.is_null()) {
+                  return false;
+                }
+                result.push_back(Entry{acc_blk.account_addr, tkey.get_uint(64), root->get_hash().bits()});
+                return true;
+              });
+        });
+    if (!ok) {
+      return td::Status::Error("invalid AccountBlocks");
+    }
+  } catch (vm::VmError &err) {
+    return err.as_status("error while traversing AccountBlocks: ");
+  }
+  return result;
+}
+
+td::Result<size_t> TxIndexDb::write_block(td::KeyValue &kv, const BlockIdExt &block_id, td::Slice data) {
+  TRY_RESULT(root, vm::std_boc_deserialize(data));
+  if (root->get_hash().bits().compare(block_id.root_hash.cbits(), 256)) {
+    return td::Status::Error("block root hash mismatch");
+  }
+  TRY_RESULT(entries, extract_transactions(std::move(root)));
+  for (auto &e : entries) {
+    auto value = create_serialize_tl_object<ton_api::db_txindex_value>(create_tl_block_id(block_id), e.hash);
+    TRY_STATUS(kv.set(make_key(block_id.id.workchain, e.addr, e.lt), value.as_slice()));
+  }
+  return entries.size();
+}
+
+td::Result<std::vector<AccountTransactionRef>> TxIndexDb::read_transactions(td::KeyValueReader &kv,
+                                                                             WorkchainId workchain,
+                                                                             const StdSmcAddress &addr,
+                                                                             LogicalTime lt, td::uint32 count) {
+  std::vector<AccountTransactionRef> result;
+  if (lt == 0 || count == 0) {
+    return result;
+  }
+  count = std::min(count, max_transactions_per_query());
+  auto begin = make_key(workchain, addr, lt);
+  // lt = 0 is never used by transactions, so its key is a valid exclusive end of the account range
+  auto end = make_key(workchain, addr, 0);
+  td::Status error;
+  // for_each_in_range() stops at the first error returned by the callback; a full result is not an error
+  bool stopped = false;
+  auto S = kv.for_each_in_range(begin, end, [&](td::Slice key, td::Slice value) -> td::Status {
+    if (key.size() != key_size) {
+      error = td::Status::Error("invalid key in transaction index");
+      return error.clone();
+    }
+    auto F = fetch_tl_object<ton_api::db_txindex_value>(value, true);
+    if (F.is_error()) {
+      error = F.move_as_error_prefix("invalid value in transaction index: ");
+      return error.clone();
+    }
+    auto f = F.move_as_ok();
+    result.push_back(AccountTransactionRef{~fetch_be(key.ubegin() + 36, 8), f->hash_, create_block_id(f->block_)});
+    if (result.size() >= count) {
+      stopped = true;
+      return td::Status::Error("stop");
+    }
+    return td::Status::OK();
+  });
+  if (error.is_error()) {
+    return std::move(error);
+  }
+  if (S.is_error() && !stopped) {
+    return std::move(S);
+  }
+  return result;
+}
+
+}  // namespace validator
+
+}  // namespace ton
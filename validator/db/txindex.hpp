@@ -0,0 +1,78 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "td/actor/actor.h"
+#include "td/db/KeyValue.h"
+#include "ton/ton-types.h"
+#include "vm/cells.h"
+
+#include "validator/interfaces/db.h"
+
+namespace ton {
+
+namespace validator {
+
+/*
+ * Per-account transaction index: (workchain, account, lt) -> (block id, transaction hash).
+ * Keys are raw big-endian with inverted lt, so that a forward range scan starting at (account, lt) returns
+ * transactions of the account in the order of getTransactions (newest first).
+ * The index is a hint: readers must verify transactions against the blocks they load.
+ */
+class TxIndexDb : public td::actor::Actor {
+ public:
+  struct Entry {
+    StdSmcAddress addr;
+    LogicalTime lt;
+    td::Bits256 hash;
+  };
+
+  // Non-empty secondary_path opens the index as a read-only secondary instance
+  explicit TxIndexDb(std::string path, std::string secondary_path = "");
+
+  void start_up() override;
+  void catch_up_with_primary(td::Promise<td::Unit> promise);
+
+  void add_block(BlockIdExt block_id, td::BufferSlice data, td::Promise<td::Unit> promise);
+  void get_transactions(WorkchainId workchain, StdSmcAddress addr, LogicalTime lt, td::uint32 count,
+                        td::Promise<std::vector<AccountTransactionRef>> promise);
+
+  static td::Result<std::vector<Entry>> extract_transactions(td::Ref<vm::Cell> block_root);
+  // Writes entries for all transactions of the block, returns the number of transactions
+  static td::Result<size_t> write_block(td::KeyValue &kv, const BlockIdExt &block_id, td::Slice data);
+  static td::Result<std::vector<AccountTransactionRef>> read_transactions(td::KeyValueReader &kv,
+                                                                          WorkchainId workchain,
+                                                                          const StdSmcAddress &addr, LogicalTime lt,
+                                                                          td::uint32 count);
+
+  static constexpr td::uint32 max_transactions_per_query() {
+    return 256;
+  }
+
+  static constexpr size_t key_size = 4 + 32 + 8;
+  // Workchain with the sign bit flipped (negative workchains go first), account, ~lt; all big-endian
+  static std::string make_key(WorkchainId workchain, const StdSmcAddress &addr, LogicalTime lt);
+
+ private:
+  std::string path_;
+  std::string secondary_path_;
+  std::shared_ptr<td::KeyValue> kv_;
+};
+
+}  // namespace validator
+
+}  // namespace ton
@@ -767,7 +767,7 @@ bool Collator::unpack_last_mc_state() {
       mc_state_root,
       block::ConfigInfo::needShardHashes | block::ConfigInfo::needLibraries | block::ConfigInfo::needValidatorSet |
           block::ConfigInfo::needWorkchainInfo | block::ConfigInfo::needCapabilities |
-          block::ConfigInfo::needPrevBlocks |
+          block::ConfigInfo::needPrevBlocks | block::ConfigInfo::needShardTable |
           (is_masterchain() ? block::ConfigInfo::needAccountsRoot | block::ConfigInfo::needSpecialSmc : 0));
   if (res.is_error()) {
     td::Status err = res.move_as_error();
@@ -651,6 +651,41 @@ bool LiteQuery::request_mc_block_state(BlockIdExt blkid) {
   return true;
 }
 
+td::actor::Task<td::Unit> LiteQuery::load_mc_block_data_state(BlockIdExt blkid) {
+  if (!blkid.is_masterchain() || !blkid.is_valid_full()) {
+    co_return td::Status::Error(-400, "reference block must belong to the masterchain");
+  }
+  base_blk_id_ = blkid;
+  auto [r_data, r_state] =
+      co_await td::actor::all(td::actor::ask(manager_, &ValidatorManager::get_block_data_for_litequery, blkid),
+                              td::actor::ask(manager_, &ValidatorManager::get_block_state_for_litequery, blkid));
+  CO_TRY_RESULT_PREFIX(data, std::move(r_data), "cannot load block "s + blkid.to_str() + " : ");
+  CO_TRY_RESULT_PREFIX(state, std::move(r_state), "cannot load state for "s + blkid.to_str() + " : ");
+  LOG(INFO) << "obtained data and state of " << blkid.to_str() << " needed by a liteserver query";
+  mc_block_ = Ref<BlockQ>(std::move(data));
+  mc_state_ = Ref<MasterchainStateQ>(std::move(state));
+  CHECK(mc_block_.not_null() && mc_state_.not_null());
+  co_return td::Unit();
+}
+
+td::actor::Task<td::Unit> LiteQuery::load_block_data_state(BlockIdExt blkid) {
+  LOG(INFO) << "requesting state for block (" << blkid.to_str() << ")";
+  if (!blkid.is_valid_full()) {
+    co_return td::Status::Error(-400, "invalid block id requested");
+  }
+  blk_id_ = blkid;
+  auto [r_data, r_state] =
+      co_await td::actor::all(td::actor::ask(manager_, &ValidatorManager::get_block_data_for_litequery, blkid),
+                              td::actor::ask(manager_, &ValidatorManager::get_block_state_for_litequery, blkid));
+  CO_TRY_RESULT_PREFIX(data, std::move(r_data), "cannot load block "s + blkid.to_str() + " : ");
+  CO_TRY_RESULT_PREFIX(state, std::move(r_state), "cannot load state for "s + blkid.to_str() + " : ");
+  LOG(INFO) << "obtained data and state of " << blkid.to_str() << " needed by a liteserver query";
+  block_ = Ref<BlockQ>(std::move(data));
+  state_ = Ref<ShardStateQ>(std::move(state));
+  CHECK(block_.not_null() && state_.not_null());
+  co_return td::Unit();
+}
+
 bool LiteQuery::request_mc_block_data_state(BlockIdExt blkid) {
   return request_mc_block_data(blkid) && request_mc_block_state(blkid);
 }
@@ -811,37 +846,65 @@ void LiteQuery::perform_getAccountState(BlockIdExt blkid, WorkchainId workchain,
   acc_workchain_ = workchain;
   acc_addr_ = addr;
   mode_ = mode;
+  run_getAccountState(blkid).start([SelfId = actor_id(this)](td::Result<td::Unit> R) {
+    if (R.is_error()) {
+      td::actor::send_closure(SelfId, &LiteQuery::abort_query, R.move_as_error());
+    }
+  });
+}
+
+td::actor::Task<td::Unit> LiteQuery::run_getAccountState(BlockIdExt blkid) {
   if (blkid.id.workchain != masterchainId) {
     base_blk_id_ = blkid;
-    set_continuation([&]() -> void { finish_getAccountState({}); });
-    request_block_data_state(blkid);
-  } else if (blkid.id.seqno != ~0U) {
-    set_continuation([&]() -> void { continue_getAccountState(); });
-    request_mc_block_data_state(blkid);
+    CO_TRY_STATUS(co_await load_block_data_state(blkid));
+    co_return co_await finish_getAccountState({});
+  }
+  if (blkid.id.seqno != ~0U) {
+    CO_TRY_STATUS(co_await load_mc_block_data_state(blkid));
   } else {
     LOG(INFO) << "sending a get_last_liteserver_state_block query to manager";
-    td::actor::send_closure_later(
-        manager_, &ton::validator::ValidatorManager::get_last_liteserver_state_block,
-        [Self = actor_id(this)](td::Result<std::pair<Ref<ton::validator::MasterchainState>, BlockIdExt>> res) -> void {
-          if (res.is_error()) {
-            td::actor::send_closure(Self, &LiteQuery::abort_query, res.move_as_error());
-          } else {
-            auto pair = res.move_as_ok();
-            td::actor::send_closure_later(Self, &LiteQuery::continue_getAccountState_0, std::move(pair.first),
-                                          pair.second);
-          }
-        });
+    CO_TRY_RESULT(last, co_await td::actor::ask(manager_, &ValidatorManager::get_last_liteserver_state_block));
+    auto [mc_state, last_blkid] = std::move(last);
+    LOG(INFO) << "obtained last masterchain block = " << last_blkid.to_str();
+    base_blk_id_ = last_blkid;
+    CHECK(mc_state.not_null());
+    mc_state_ = Ref<MasterchainStateQ>(std::move(mc_state));
+    CHECK(mc_state_.not_null());
+    CO_TRY_RESULT_PREFIX(
+        mc_block, co_await td::actor::ask(manager_, &ValidatorManager::get_block_data_for_litequery, last_blkid),
+        "cannot load block "s + last_blkid.to_str() + " : ");
+    mc_block_ = Ref<BlockQ>(std::move(mc_block));
+    CHECK(mc_block_.not_null());
   }
-}
-
-void LiteQuery::continue_getAccountState_0(Ref<ton::validator::MasterchainState> mc_state, BlockIdExt blkid) {
-  LOG(INFO) << "obtained last masterchain block = " << blkid.to_str();
-  base_blk_id_ = blkid;
-  CHECK(mc_state.not_null());
-  mc_state_ = Ref<MasterchainStateQ>(std::move(mc_state));
-  CHECK(mc_state_.not_null());
-  set_continuation([&]() -> void { continue_getAccountState(); });
-  request_mc_block_data(blkid);
+  LOG(INFO) << "continue getAccountState() query";
+  if (acc_workchain_ == masterchainId) {
+    blk_id_ = base_blk_id_;
+    block_ = mc_block_;
+    state_ = mc_state_;
+    co_return co_await finish_getAccountState({});
+  }
+  Ref<vm::Cell> proof3, proof4;
+  ton::BlockIdExt shard_blkid;
+  if (!(make_mc_state_root_proof(proof3) &&
+        make_shard_info_proof(proof4, shard_blkid, extract_addr_prefix(acc_workchain_, acc_addr_)))) {
+    co_return td::Unit();
+  }
+  auto proof = vm::std_boc_serialize_multi({std::move(proof3), std::move(proof4)});
+  if (proof.is_error()) {
+    co_return proof.move_as_error();
+  }
+  if (!shard_blkid.is_valid()) {
+    // no shard with requested address found
+    LOG(INFO) << "getAccountState(" << acc_workchain_ << ":" << acc_addr_.to_hex()
+              << ") query completed (unknown workchain/shard)";
+    auto b = ton::create_serialize_tl_object<ton::lite_api::liteServer_accountState>(
+        ton::create_tl_lite_block_id(base_blk_id_), ton::create_tl_lite_block_id(shard_blkid), proof.move_as_ok(),
+        td::BufferSlice{}, td::BufferSlice{});
+    finish_query(std::move(b));
+    co_return td::Unit();
+  }
+  CO_TRY_STATUS(co_await load_block_data_state(shard_blkid));
+  co_return co_await finish_getAccountState(proof.move_as_ok());
 }
 
 void LiteQuery::perform_fetchAccountState() {
@@ -1269,52 +1332,17 @@ bool LiteQuery::make_ancestor_block_proof(Ref<vm::Cell>& proof, Ref<vm::Cell> st
   return true;
 }
 
-void LiteQuery::continue_getAccountState() {
-  LOG(INFO) << "continue getAccountState() query";
-  if (acc_workchain_ == masterchainId) {
-    blk_id_ = base_blk_id_;
-    block_ = mc_block_;
-    state_ = mc_state_;
-    finish_getAccountState({});
-    return;
-  }
-  Ref<vm::Cell> proof3, proof4;
-  ton::BlockIdExt blkid;
-  if (!(make_mc_state_root_proof(proof3) &&
-        make_shard_info_proof(proof4, blkid, extract_addr_prefix(acc_workchain_, acc_addr_)))) {
-    return;
-  }
-  auto proof = vm::std_boc_serialize_multi({std::move(proof3), std::move(proof4)});
-  if (proof.is_error()) {
-    fatal_error(proof.move_as_error());
-    return;
-  }
-  if (!blkid.is_valid()) {
-    // no shard with requested address found
-    LOG(INFO) << "getAccountState(" << acc_workchain_ << ":" << acc_addr_.to_hex()
-              << ") query completed (unknown workchain/shard)";
-    auto b = ton::create_serialize_tl_object<ton::lite_api::liteServer_accountState>(
-        ton::create_tl_lite_block_id(base_blk_id_), ton::create_tl_lite_block_id(blkid), proof.move_as_ok(),
-        td::BufferSlice{}, td::BufferSlice{});
-    finish_query(std::move(b));
-  } else {
-    shard_proof_ = proof.move_as_ok();
-    set_continuation([this]() -> void { finish_getAccountState(std::move(shard_proof_)); });
-    request_block_data_state(blkid);
-  }
-}
-
-void LiteQuery::finish_getAccountState(td::BufferSlice shard_proof) {
+td::actor::Task<td::Unit> LiteQuery::finish_getAccountState(td::BufferSlice shard_proof) {
   LOG(INFO) << "completing getAccountState() query";
   Ref<vm::Cell> proof1, proof2;
   if (!make_state_root_proof(proof1)) {
-    return;
+    co_return td::Unit();
   }
   vm::MerkleProofBuilder pb{state_->root_cell()};
   block::gen::ShardStateUnsplit::Record sstate;
   if (!tlb::unpack_cell(pb.root(), sstate)) {
     fatal_error("cannot unpack state header");
-    return;
+    co_return td::Unit();
   }
   vm::AugmentedDictionary accounts_dict{vm::load_cell_slice_ref(sstate.accounts), 256, block::tlb::aug_ShardAccounts};
   auto acc_csr = accounts_dict.lookup(acc_addr_);
@@ -1322,14 +1350,14 @@ void LiteQuery::finish_getAccountState(td::BufferSlice shard_proof) {
     auto config = block::ConfigInfo::extract_config(mc_state_->root_cell(), 0xFFFF);
     if (config.is_error()) {
       fatal_error(config.move_as_error());
-      return;
+      co_return td::Unit();
     }
     auto rconfig = config.move_as_ok();
     rconfig->set_block_id_ext(mc_state_->get_block_id());
     acc_state_promise_.set_value(std::make_tuple(
                                   std::move(acc_csr), sstate.gen_utime, sstate.gen_lt, std::move(rconfig)
                                  ));
-    return;
+    co_return td::Unit();
   }
 
   Ref<vm::Cell> acc_root;
@@ -1338,53 +1366,51 @@ void LiteQuery::finish_getAccountState(td::BufferSlice shard_proof) {
   }
   if (!pb.extract_proof_to(proof2)) {
     fatal_error("unknown error creating Merkle proof");
-    return;
+    co_return td::Unit();
   }
   auto proof = vm::std_boc_serialize_multi({std::move(proof1), std::move(proof2)});
   pb.clear();
   if (proof.is_error()) {
     fatal_error(proof.move_as_error());
-    return;
+    co_return td::Unit();
   }
   if (mode_ & 0x10000) {
-    if (!mc_state_.is_null()) {
-      finish_runSmcMethod(std::move(shard_proof), proof.move_as_ok(), std::move(acc_root), sstate.gen_utime,
-                          sstate.gen_lt);
-      return;
-    }
-    shard_proof_ = std::move(shard_proof);
-    proof_ = proof.move_as_ok();
-    set_continuation(
-        [&, base_blk_id = base_blk_id_, acc_root, utime = sstate.gen_utime, lt = sstate.gen_lt]() mutable -> void {
-          base_blk_id_ = base_blk_id;  // It gets overridden by request_mc_block_data_state
-          finish_runSmcMethod(std::move(shard_proof_), std::move(proof_), std::move(acc_root), utime, lt);
-        });
-    td::optional<BlockIdExt> master_ref = state_->get_master_ref();
-    if (!master_ref) {
-      fatal_error("masterchain ref block is not available");
-      return;
+    if (mc_state_.is_null()) {
+      td::optional<BlockIdExt> master_ref = state_->get_master_ref();
+      if (!master_ref) {
+        fatal_error("masterchain ref block is not available");
+        co_return td::Unit();
+      }
+      auto base_blk_id = base_blk_id_;
+      CO_TRY_STATUS(co_await load_mc_block_data_state(master_ref.value()));
+      base_blk_id_ = base_blk_id;  // It gets overridden by load_mc_block_data_state
     }
-    request_mc_block_data_state(master_ref.value());
-    return;
+    finish_runSmcMethod(std::move(shard_proof), proof.move_as_ok(), std::move(acc_root), sstate.gen_utime,
+                        sstate.gen_lt);
+    co_return td::Unit();
   }
   td::BufferSlice data;
   if (acc_root.not_null()) {
     if (mode_ & 0x40000000) {
-      vm::MerkleProofBuilder mpb{acc_root};
       // This does not include code, data and libs into proof, but it includes extra currencies
-      if (!block::gen::t_Account.validate_ref(mpb.root())) {
-        fatal_error("failed to validate Account");
-        return;
+      vm::CellUsageSet usage_set;
+      {
+        vm::CellUsageSet::Scope usage_scope{&usage_set};
+        if (!block::gen::t_Account.validate_ref(acc_root)) {
+          fatal_error("failed to validate Account");
+          co_return td::Unit();
+        }
       }
-      if (!mpb.extract_proof_to(acc_root)) {
+      acc_root = vm::MerkleProof::generate(std::move(acc_root), usage_set);
+      if (acc_root.is_null()) {
         fatal_error("unknown error creating Merkle proof");
-        return;
+        co_return td::Unit();
       }
     }
     auto res = vm::std_boc_serialize(std::move(acc_root));
     if (res.is_error()) {
       fatal_error(res.move_as_error());
-      return;
+      co_return td::Unit();
     }
     data = res.move_as_ok();
   }
@@ -1393,6 +1419,7 @@ void LiteQuery::finish_getAccountState(td::BufferSlice shard_proof) {
       ton::create_tl_lite_block_id(base_blk_id_), ton::create_tl_lite_block_id(blk_id_), std::move(shard_proof),
       proof.move_as_ok(), std::move(data));
   finish_query(std::move(b));
+  co_return td::Unit();
 }
 
 // same as in lite-client/lite-client-common.cpp
@@ -1639,7 +1666,96 @@ void LiteQuery::perform_getTransactions(WorkchainId workchain, StdSmcAddress add
   acc_addr_ = addr;
   trans_lt_ = lt;
   trans_hash_ = hash;
-  continue_getTransactions(count, false);
+  td::actor::send_closure_later(
+      manager_, &ValidatorManager::get_account_transactions_for_litequery, workchain, addr, lt, count,
+      [Self = actor_id(this), count](td::Result<std::vector<AccountTransactionRef>> res) {
+        std::vector<AccountTransactionRef> trans;
+        if (res.is_ok()) {
+          trans = res.move_as_ok();
+        }
+        td::actor::send_closure_later(Self, &LiteQuery::continue_getTransactions_indexed, std::move(trans), count);
+      });
+}
+
+void LiteQuery::continue_getTransactions_indexed(std::vector<AccountTransactionRef> trans, unsigned count) {
+  if (trans.empty() || trans[0].lt != trans_lt_ || trans[0].hash != trans_hash_) {
+    // no index or the account is not indexed: follow prev_trans_lt chain block by block
+    continue_getTransactions(count, false);
+    return;
+  }
+  LOG(INFO) << "getTransactions() : " << trans.size() << " transactions found in index";
+  indexed_trans_ = std::move(trans);
+  std::set<BlockIdExt> blocks;
+  for (const auto& t : indexed_trans_) {
+    blocks.insert(t.block_id);
+  }
+  pending_ += (int)blocks.size();
+  for (const auto& blkid : blocks) {
+    td::actor::send_closure_later(
+        manager_, &ValidatorManager::get_block_data_for_litequery, blkid,
+        [Self = actor_id(this), blkid, count](td::Result<Ref<BlockData>> res) {
+          td::actor::send_closure_later(Self, &LiteQuery::got_indexed_block, blkid, std::move(res), count);
+        });
+  }
+}
+
+void LiteQuery::got_indexed_block(BlockIdExt blkid, td::Result<Ref<BlockData>> res, unsigned count) {
+  if (res.is_ok()) {
+    indexed_blocks_[blkid] = Ref<BlockQ>(res.move_as_ok());
+  } else {
+    LOG(DEBUG) << "getTransactions() : cannot load indexed block " << blkid.to_str() << " : " << res.error();
+  }
+  if (!--pending_) {
+    finish_getTransactions_indexed(count);
+  }
+}
+
+void LiteQuery::finish_getTransactions_indexed(unsigned count) {
+  unsigned remaining = count;
+  // the index is only a hint: every transaction is checked against its block and the prev_trans chain,
+  // the rest of the chain (if any) is resolved by continue_getTransactions
+  for (const auto& t : indexed_trans_) {
+    if (!remaining || !trans_lt_ || t.lt != trans_lt_ || t.hash != trans_hash_) {
+      break;
+    }
+    auto it = indexed_blocks_.find(t.block_id);
+    if (it == indexed_blocks_.end() ||
+        !ton::shard_contains(t.block_id.shard_full(), ton::extract_addr_prefix(acc_workchain_, acc_addr_))) {
+      break;
+    }
+    auto res = block::get_block_transaction_try(it->second->root_cell(), acc_workchain_, acc_addr_, trans_lt_);
+    if (res.is_error() || res.ok().is_null() || trans_hash_ != res.ok()->get_hash().bits()) {
+      break;
+    }
+    auto S = add_transaction_to_list(res.move_as_ok(), it->second);
+    if (S.is_error()) {
+      fatal_error(std::move(S));
+      return;
+    }
+    block_ = it->second;
+    blk_id_ = t.block_id;
+    --remaining;
+  }
+  indexed_trans_.clear();
+  indexed_blocks_.clear();
+  continue_getTransactions(remaining, false);
+}
+
+td::Status LiteQuery::add_transaction_to_list(Ref<vm::Cell> root, Ref<BlockQ> block) {
+  block::gen::Transaction::Record trans;
+  if (!tlb::unpack_cell(root, trans)) {
+    return td::Status::Error("cannot unpack transaction");
+  }
+  if (trans.prev_trans_lt >= trans_lt_) {
+    return td::Status::Error("previous transaction time is not less than the current one");
+  }
+  roots_.push_back(std::move(root));
+  blk_ids_.push_back(block->block_id());
+  aux_objs_.push_back(std::move(block));
+  LOG(DEBUG) << "going to previous transaction with lt=" << trans.prev_trans_lt << " from current lt=" << trans_lt_;
+  trans_lt_ = trans.prev_trans_lt;
+  trans_hash_ = trans.prev_trans_hash;
+  return td::Status::OK();
 }
 
 void LiteQuery::continue_getTransactions(unsigned remaining, bool exact) {
@@ -1668,21 +1784,11 @@ void LiteQuery::continue_getTransactions(unsigned remaining, bool exact) {
         fatal_error("transaction hash mismatch");
         return;
       }
-      block::gen::Transaction::Record trans;
-      if (!tlb::unpack_cell(root, trans)) {
-        fatal_error("cannot unpack transaction");
-        return;
-      }
-      if (trans.prev_trans_lt >= trans_lt_) {
-        fatal_error("previous transaction time is not less than the current one");
+      auto S = add_transaction_to_list(std::move(root), block_);
+      if (S.is_error()) {
+        fatal_error(std::move(S));
         return;
       }
-      roots_.push_back(std::move(root));
-      aux_objs_.push_back(block_);
-      blk_ids_.push_back(block_->block_id());
-      LOG(DEBUG) << "going to previous transaction with lt=" << trans.prev_trans_lt << " from current lt=" << trans_lt_;
-      trans_lt_ = trans.prev_trans_lt;
-      trans_hash_ = trans.prev_trans_hash;
       redo = (trans_lt_ > 0);
       exact = false;
       --remaining;
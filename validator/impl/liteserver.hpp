@@ -19,6 +19,7 @@
 #pragma once
 #include "ton/ton-types.h"
 #include "td/actor/actor.h"
+#include "td/actor/Task.h"
 #include "td/utils/Time.h"
 #include "interfaces/block-handle.h"
 #include "interfaces/validator-manager.h"
@@ -62,10 +63,11 @@ class LiteQuery : public td::actor::Actor {
   td::BufferSlice buffer_;
   std::function<void()> continuation_;
   bool cont_set_{false};
-  td::BufferSlice shard_proof_, proof_;
   std::vector<Ref<vm::Cell>> roots_;
   std::vector<Ref<td::CntObject>> aux_objs_;
   std::vector<ton::BlockIdExt> blk_ids_;
+  std::vector<AccountTransactionRef> indexed_trans_;
+  std::map<BlockIdExt, Ref<BlockQ>> indexed_blocks_;
   std::unique_ptr<block::BlockProofChain> chain_;
   Ref<vm::Stack> stack_;
 
@@ -116,9 +118,8 @@ class LiteQuery : public td::actor::Actor {
   void continue_getZeroState(BlockIdExt blkid, td::BufferSlice state);
   void perform_sendMessage(td::BufferSlice ext_msg);
   void perform_getAccountState(BlockIdExt blkid, WorkchainId workchain, StdSmcAddress addr, int mode);
-  void continue_getAccountState_0(Ref<MasterchainState> mc_state, BlockIdExt blkid);
-  void continue_getAccountState();
-  void finish_getAccountState(td::BufferSlice shard_proof);
+  td::actor::Task<td::Unit> run_getAccountState(BlockIdExt blkid);
+  td::actor::Task<td::Unit> finish_getAccountState(td::BufferSlice shard_proof);
   void perform_fetchAccountState();
   void perform_runSmcMethod(BlockIdExt blkid, WorkchainId workchain, StdSmcAddress addr, int mode, td::int64 method_id,
                             td::BufferSlice params);
@@ -132,6 +133,10 @@ class LiteQuery : public td::actor::Actor {
   void continue_getOneTransaction();
   void perform_getTransactions(WorkchainId workchain, StdSmcAddress addr, LogicalTime lt, Bits256 hash, unsigned count);
   void continue_getTransactions(unsigned remaining, bool exact);
+  void continue_getTransactions_indexed(std::vector<AccountTransactionRef> trans, unsigned count);
+  void got_indexed_block(BlockIdExt blkid, td::Result<Ref<BlockData>> res, unsigned count);
+  void finish_getTransactions_indexed(unsigned count);
+  td::Status add_transaction_to_list(Ref<vm::Cell> root, Ref<BlockQ> block);
   void continue_getTransactions_2(BlockIdExt blkid, Ref<BlockData> block, unsigned remaining);
   void abort_getTransactions(td::Status error, ton::BlockIdExt blkid);
   void finish_getTransactions();
@@ -196,6 +201,8 @@ class LiteQuery : public td::actor::Actor {
   bool request_mc_block_data_state(BlockIdExt blkid);
   bool request_mc_proof(BlockIdExt blkid, int mode = 0);
   bool request_zero_state(BlockIdExt blkid);
+  td::actor::Task<td::Unit> load_block_data_state(BlockIdExt blkid);
+  td::actor::Task<td::Unit> load_mc_block_data_state(BlockIdExt blkid);
   void got_block_state(BlockIdExt blkid, Ref<ShardState> state);
   void got_mc_block_state(BlockIdExt blkid, Ref<ShardState> state);
   void got_block_data(BlockIdExt blkid, Ref<BlockData> data);
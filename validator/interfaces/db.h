@@ -94,6 +94,10 @@ class Db : public td::actor::Actor {
                                       td::Promise<ConstBlockHandle> promise) = 0;
   virtual void get_block_by_seqno(AccountIdPrefixFull account, BlockSeqno seqno,
                                   td::Promise<ConstBlockHandle> promise) = 0;
+  virtual void get_account_transactions(WorkchainId workchain, StdSmcAddress addr, LogicalTime lt, td::uint32 count,
+                                        td::Promise<std::vector<AccountTransactionRef>> promise) {
+    promise.set_error(td::Status::Error(ErrorCode::notready, "transaction index is not enabled"));
+  }
 
   virtual void update_init_masterchain_block(BlockIdExt block, td::Promise<td::Unit> promise) = 0;
   virtual void get_init_masterchain_block(td::Promise<BlockIdExt> promise) = 0;
@@ -141,6 +145,11 @@ class Db : public td::actor::Actor {
       td::Promise<std::vector<td::Ref<PersistentStateDescription>>> promise) = 0;
 
   virtual void iterate_temp_block_handles(std::function<void(const BlockHandleInterface &)> f) = 0;
+
+  // Read replica mode only: make the updates written by the primary instance visible
+  virtual void catch_up_with_primary(td::Promise<td::Unit> promise) {
+    promise.set_error(td::Status::Error(ErrorCode::error, "not a read replica"));
+  }
 };
 
 }  // namespace validator
@@ -55,6 +55,12 @@ struct AsyncSerializerState {
   UnixTime last_written_block_ts;
 };
 
+struct AccountTransactionRef {
+  LogicalTime lt;
+  td::Bits256 hash;
+  BlockIdExt block_id;
+};
+
 struct CollationStats {
   BlockIdExt block_id{workchainInvalid, 0, 0, RootHash::zero(), FileHash::zero()};
   td::Status status = td::Status::OK();
@@ -307,6 +313,11 @@ class ValidatorManager : public ValidatorManagerInterface {
                                                     td::Promise<ConstBlockHandle> promise) = 0;
   virtual void get_block_by_seqno_for_litequery(AccountIdPrefixFull account, BlockSeqno seqno,
                                                 td::Promise<ConstBlockHandle> promise) = 0;
+  virtual void get_account_transactions_for_litequery(WorkchainId workchain, StdSmcAddress addr, LogicalTime lt,
+                                                     td::uint32 count,
+                                                     td::Promise<std::vector<AccountTransactionRef>> promise) {
+    promise.set_error(td::Status::Error(ErrorCode::notready, "transaction index is not enabled"));
+  }
   virtual void get_block_candidate_for_litequery(PublicKey source, BlockIdExt block_id, FileHash collated_data_hash,
                                                  td::Promise<BlockCandidate> promise) = 0;
   virtual void get_validator_groups_info_for_litequery(
@@ -441,6 +441,10 @@ void ValidatorManagerImpl::add_external_message(td::Ref<ExtMessage> msg, int pri
   ext_messages_hashes_[id.hash] = {priority, id};
 }
 void ValidatorManagerImpl::check_external_message(td::BufferSlice data, td::Promise<td::Ref<ExtMessage>> promise) {
+  if (is_read_replica()) {
+    promise.set_error(td::Status::Error(ErrorCode::error, "external messages are not accepted by a read replica"));
+    return;
+  }
   if (!started_) {
     promise.set_error(td::Status::Error(ErrorCode::notready, "node not synced"));
     return;
@@ -1929,8 +1933,6 @@ void ValidatorManagerImpl::start_up() {
   lite_server_cache_ = create_liteserver_cache_actor(actor_id(this), db_root_);
   token_manager_ = td::actor::create_actor<TokenManager>("tokenmanager");
   storage_stat_cache_ = td::actor::create_actor<StorageStatCache>("storagestatcache");
-  td::mkdir(db_root_ + "/tmp/").ensure();
-  td::mkdir(db_root_ + "/catchains/").ensure();
 
   auto Q =
       td::PromiseCreator::lambda([SelfId = actor_id(this)](td::Result<td::actor::ActorOwn<adnl::AdnlExtServer>> R) {
@@ -1940,6 +1942,16 @@ void ValidatorManagerImpl::start_up() {
   td::actor::send_closure(adnl_, &adnl::Adnl::create_ext_server, std::vector<adnl::AdnlNodeIdShort>{},
                           std::vector<td::uint16>{}, std::move(Q));
 
+  if (is_read_replica()) {
+    LOG(WARNING) << "Starting in read replica mode, serving lite server queries from the db of the primary instance";
+    read_replica_sync();
+    check_waiters_at_ = td::Timestamp::in(1.0);
+    alarm_timestamp().relax(check_waiters_at_);
+    return;
+  }
+  td::mkdir(db_root_ + "/tmp/").ensure();
+  td::mkdir(db_root_ + "/catchains/").ensure();
+
   auto P = td::PromiseCreator::lambda([SelfId = actor_id(this)](td::Result<ValidatorManagerInitResult> R) {
     R.ensure();
     td::actor::send_closure(SelfId, &ValidatorManagerImpl::started, R.move_as_ok());
@@ -1998,6 +2010,80 @@ void ValidatorManagerImpl::start_up() {
   alarm_timestamp().relax(check_waiters_at_);
 }
 
+void ValidatorManagerImpl::read_replica_sync() {
+  auto P = td::PromiseCreator::lambda([SelfId = actor_id(this)](td::Result<td::Unit> R) {
+    if (R.is_error()) {
+      LOG(WARNING) << "failed to catch up with the primary instance: " << R.move_as_error();
+      td::actor::send_closure(SelfId, &ValidatorManagerImpl::read_replica_sync_done);
+    } else {
+      td::actor::send_closure(SelfId, &ValidatorManagerImpl::read_replica_caught_up);
+    }
+  });
+  td::actor::send_closure(db_, &Db::catch_up_with_primary, std::move(P));
+}
+
+void ValidatorManagerImpl::read_replica_caught_up() {
+  auto P = td::PromiseCreator::lambda([SelfId = actor_id(this)](td::Result<BlockIdExt> R) {
+    if (R.is_error()) {
+      LOG(WARNING) << "failed to get shard client state of the primary instance: " << R.move_as_error();
+      td::actor::send_closure(SelfId, &ValidatorManagerImpl::read_replica_sync_done);
+    } else {
+      td::actor::send_closure(SelfId, &ValidatorManagerImpl::read_replica_got_shard_client_block, R.move_as_ok());
+    }
+  });
+  td::actor::send_closure(db_, &Db::get_shard_client_state, std::move(P));
+}
+
+void ValidatorManagerImpl::read_replica_got_shard_client_block(BlockIdExt block_id) {
+  if (shard_client_handle_ && shard_client_handle_->id() == block_id) {
+    read_replica_sync_done();
+    return;
+  }
+  // Block handles are written by the primary instance, cached ones may be outdated (e.g. not applied yet)
+  handle_lru_map_.clear();
+  handle_lru_size_ = 0;
+  handles_.clear();
+
+  auto P = td::PromiseCreator::lambda([SelfId = actor_id(this)](td::Result<BlockHandle> R) {
+    if (R.is_error()) {
+      LOG(WARNING) << "failed to load shard client block handle: " << R.move_as_error();
+      td::actor::send_closure(SelfId, &ValidatorManagerImpl::read_replica_sync_done);
+      return;
+    }
+    auto handle = R.move_as_ok();
+    auto Q = td::PromiseCreator::lambda([SelfId, handle](td::Result<td::Ref<ShardState>> R) {
+      if (R.is_error()) {
+        LOG(WARNING) << "failed to load shard client state " << handle->id().to_str() << ": " << R.move_as_error();
+        td::actor::send_closure(SelfId, &ValidatorManagerImpl::read_replica_sync_done);
+      } else {
+        td::actor::send_closure(SelfId, &ValidatorManagerImpl::read_replica_got_state, handle, R.move_as_ok());
+      }
+    });
+    td::actor::send_closure(SelfId, &ValidatorManagerImpl::get_shard_state_from_db, handle, std::move(Q));
+  });
+  get_block_handle(block_id, false, std::move(P));
+}
+
+void ValidatorManagerImpl::read_replica_got_state(BlockHandle handle, td::Ref<ShardState> state) {
+  td::Ref<MasterchainState> mc_state{std::move(state)};
+  CHECK(mc_state.not_null());
+  last_masterchain_block_handle_ = handle;
+  last_masterchain_block_id_ = handle->id();
+  last_masterchain_seqno_ = handle->id().seqno();
+  last_masterchain_state_ = mc_state;
+  update_shard_client_block_handle(std::move(handle), std::move(mc_state), [](td::Unit) {});
+  if (!started_) {
+    started_ = true;
+    LOG(WARNING) << "Read replica is ready, last masterchain block " << last_masterchain_block_id_.to_str();
+  }
+  read_replica_sync_done();
+}
+
+void ValidatorManagerImpl::read_replica_sync_done() {
+  read_replica_sync_at_ = td::Timestamp::in(0.5);
+  alarm_timestamp().relax(read_replica_sync_at_);
+}
+
 void ValidatorManagerImpl::init_last_masterchain_state(td::Ref<MasterchainState> state) {
   if (last_masterchain_state_.not_null()) {
     return;
@@ -2064,8 +2150,9 @@ void ValidatorManagerImpl::read_gc_list(std::vector<ValidatorSessionId> list) {
 
   new_masterchain_block();
 
-  serializer_ =
-      td::actor::create_actor<AsyncStateSerializer>("serializer", last_key_block_handle_->id(), opts_, actor_id(this));
+  serializer_ = td::actor::create_actor<AsyncStateSerializer>(
+      td::actor::ActorOptions().with_name("serializer").with_priority(td::actor::ActorPriority::Background),
+      last_key_block_handle_->id(), opts_, actor_id(this));
   td::actor::send_closure(serializer_, &AsyncStateSerializer::update_last_known_key_block_ts,
                           last_key_block_handle_->unix_time());
 
@@ -2174,12 +2261,14 @@ void ValidatorManagerImpl::download_next_archive() {
     }
   });
   if (to_import_files.empty()) {
-    td::actor::create_actor<ArchiveImporter>("archiveimport", db_root_, last_masterchain_state_, seqno, opts_,
-                                             actor_id(this), std::move(to_import_files), std::move(P))
+    td::actor::create_actor<ArchiveImporter>(
+        td::actor::ActorOptions().with_name("archiveimport").with_priority(td::actor::ActorPriority::Background),
+        db_root_, last_masterchain_state_, seqno, opts_, actor_id(this), std::move(to_import_files), std::move(P))
         .release();
   } else {
-    td::actor::create_actor<ArchiveImporterLocal>("archiveimport", db_root_, last_masterchain_state_, seqno, opts_,
-                                                  actor_id(this), std::move(to_import_files), std::move(P))
+    td::actor::create_actor<ArchiveImporterLocal>(
+        td::actor::ActorOptions().with_name("archiveimport").with_priority(td::actor::ActorPriority::Background),
+        db_root_, last_masterchain_state_, seqno, opts_, actor_id(this), std::move(to_import_files), std::move(P))
         .release();
   }
 }
@@ -2824,12 +2913,17 @@ void ValidatorManagerImpl::state_serializer_update(BlockSeqno seqno) {
 void ValidatorManagerImpl::alarm() {
   try_advance_gc_masterchain_block();
   alarm_timestamp() = td::Timestamp::in(1.0);
+  if (read_replica_sync_at_ && read_replica_sync_at_.is_in_past()) {
+    read_replica_sync_at_ = td::Timestamp::never();
+    read_replica_sync();
+  }
+  alarm_timestamp().relax(read_replica_sync_at_);
   if (shard_client_handle_ && gc_masterchain_handle_) {
     td::actor::send_closure(db_, &Db::run_gc, shard_client_handle_->unix_time(), gc_masterchain_handle_->unix_time(),
                             opts_->archive_ttl());
   }
   if (log_status_at_.is_in_past()) {
-    if (last_masterchain_block_handle_) {
+    if (last_masterchain_block_handle_ && last_known_key_block_handle_) {
       LOG(ERROR) << "STATUS: last_masterchain_block_ago="
                  << td::format::as_time(td::Clocks::system() - last_masterchain_block_handle_->unix_time())
                  << " last_known_key_block_ago="
@@ -3065,6 +3159,10 @@ void ValidatorManagerImpl::prepare_actor_stats(td::Promise<std::string> promise)
   send_closure(actor_stats_, &td::actor::ActorStats::prepare_stats, std::move(promise));
 }
 
+void ValidatorManagerImpl::prepare_actor_stats_prometheus(td::Promise<std::string> promise) {
+  send_closure(actor_stats_, &td::actor::ActorStats::prepare_prometheus_stats, std::move(promise));
+}
+
 void ValidatorManagerImpl::prepare_stats(td::Promise<std::vector<std::pair<std::string, std::string>>> promise) {
   auto merger = StatsMerger::create(std::move(promise));
 
@@ -3299,6 +3397,12 @@ void ValidatorManagerImpl::get_block_by_seqno_for_litequery(AccountIdPrefixFull
       });
 }
 
+void ValidatorManagerImpl::get_account_transactions_for_litequery(
+    WorkchainId workchain, StdSmcAddress addr, LogicalTime lt, td::uint32 count,
+    td::Promise<std::vector<AccountTransactionRef>> promise) {
+  td::actor::send_closure(db_, &Db::get_account_transactions, workchain, addr, lt, count, std::move(promise));
+}
+
 void ValidatorManagerImpl::process_block_handle_for_litequery_error(BlockIdExt block_id,
                                                                     td::Result<BlockHandle> r_handle,
                                                                     td::Promise<ConstBlockHandle> promise) {
@@ -593,6 +593,16 @@ class ValidatorManagerImpl : public ValidatorManager {
   void started(ValidatorManagerInitResult result);
   void read_gc_list(std::vector<ValidatorSessionId> list);
 
+  // Read replica mode: no sync and no validation, the state of the primary instance is polled from the shared db
+  bool is_read_replica() const {
+    return !opts_->get_read_replica_path().empty();
+  }
+  void read_replica_sync();
+  void read_replica_caught_up();
+  void read_replica_got_shard_client_block(BlockIdExt block_id);
+  void read_replica_got_state(BlockHandle handle, td::Ref<ShardState> state);
+  void read_replica_sync_done();
+
   bool is_validator();
   bool validating_masterchain();
   PublicKeyHash get_validator(ShardIdFull shard, td::Ref<ValidatorSet> val_set);
@@ -624,6 +634,7 @@ class ValidatorManagerImpl : public ValidatorManager {
   void prepare_stats(td::Promise<std::vector<std::pair<std::string, std::string>>> promise) override;
 
   void prepare_actor_stats(td::Promise<std::string> promise) override;
+  void prepare_actor_stats_prometheus(td::Promise<std::string> promise) override;
 
   void prepare_perf_timer_stats(td::Promise<std::vector<PerfTimerStats>> promise) override;
   void add_perf_timer_stat(std::string name, double duration) override;
@@ -672,6 +683,9 @@ class ValidatorManagerImpl : public ValidatorManager {
                                                     td::Promise<ConstBlockHandle> promise) override;
   void get_block_by_seqno_for_litequery(AccountIdPrefixFull account, BlockSeqno seqno,
                                                 td::Promise<ConstBlockHandle> promise) override;
+  void get_account_transactions_for_litequery(WorkchainId workchain, StdSmcAddress addr, LogicalTime lt,
+                                              td::uint32 count,
+                                              td::Promise<std::vector<AccountTransactionRef>> promise) override;
   void process_block_handle_for_litequery_error(BlockIdExt block_id, td::Result<BlockHandle> r_handle,
                                                 td::Promise<ConstBlockHandle> promise);
   void process_lookup_block_for_litequery_error(AccountIdPrefixFull account, int type, td::uint64 value,
@@ -700,6 +714,7 @@ class ValidatorManagerImpl : public ValidatorManager {
   td::Timestamp check_waiters_at_;
   td::Timestamp check_shard_clients_;
   td::Timestamp log_status_at_;
+  td::Timestamp read_replica_sync_at_;
   void alarm() override;
   std::map<ShardTopBlockDescriptionId, td::Ref<ShardTopBlockDescription>> out_shard_blocks_;
 
@@ -0,0 +1,216 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+
+    Copyright 2017-2020 Telegram Systems LLP
+*/
+#include "td/utils/Random.h"
+#include "td/utils/tests.h"
+
+#include "ton/ton-shard.h"
+#include "validator/db/archive-lt-index.hpp"
+
+using ton::validator::ArchiveLtIndex;
+
+namespace {
+
+// Shards of a workchain split twice: 0:8 -> 0:4, 0:c -> 0:2, 0:6
+struct TestDb {
+  std::map<ton::ShardIdFull, ArchiveLtIndex::Shard> shards;
+  std::vector<ton::BlockIdExt> blocks;
+
+  void add(ton::ShardIdFull shard, ton::BlockSeqno seqno) {
+    ton::BlockIdExt id{ton::BlockId{shard, seqno}, td::Bits256::zero(), td::Bits256::zero()};
+    id.root_hash.as_slice().copy_from(td::Slice(reinterpret_cast<const char *>(&seqno), sizeof(seqno)));
+    shards[shard].append(id, lt(seqno), ts(seqno));
+    blocks.push_back(id);
+  }
+  static ton::LogicalTime lt(ton::BlockSeqno seqno) {
+    return seqno * 1000;
+  }
+  static ton::UnixTime ts(ton::BlockSeqno seqno) {
+    return 1000 + seqno * 5;
+  }
+
+  TestDb() {
+    ton::ShardIdFull root{ton::basechainId, ton::shardIdAll};
+    for (ton::BlockSeqno seqno = 1; seqno <= 100; seqno++) {
+      add(root, seqno);
+    }
+    auto left = ton::shard_child(root, true);
+    auto right = ton::shard_child(root, false);
+    for (ton::BlockSeqno seqno = 101; seqno <= 200; seqno++) {
+      add(left, seqno);
+      add(right, seqno);
+    }
+    for (ton::BlockSeqno seqno = 201; seqno <= 300; seqno++) {
+      add(ton::shard_child(left, true), seqno);
+      add(ton::shard_child(left, false), seqno);
+      add(right, seqno);
+    }
+  }
+
+  // Same as ArchiveSlice::load_lt_index_shards
+  ArchiveLtIndex::LoadedShards load(ton::AccountIdPrefixFull account_id, const std::set<ton::ShardIdFull> &loaded) const {
+    ArchiveLtIndex::LoadedShards result;
+    bool f = false;
+    for (td::uint32 len = 0; len <= 60; len++) {
+      auto shard = ton::shard_prefix(account_id, len);
+      auto it = shards.find(shard);
+      bool found = it != shards.end();
+      if (!loaded.count(shard)) {
+        if (found) {
+          result.emplace_back(shard, it->second);
+        } else {
+          result.emplace_back(shard, td::optional<ArchiveLtIndex::Shard>{});
+        }
+      }
+      if (found) {
+        f = true;
+      } else if (f) {
+        break;
+      }
+    }
+    return result;
+  }
+
+  // The first block (by seqno) of the account with the value not less than the given one
+  td::Result<ton::BlockIdExt> reference(ton::AccountIdPrefixFull account_id, ArchiveLtIndex::Key key, td::uint64 value,
+                                        bool exact) const {
+    td::optional<ton::BlockIdExt> best;
+    for (auto &id : blocks) {
+      if (!ton::shard_contains(id.shard_full(), account_id)) {
+        continue;
+      }
+      td::uint64 v = key == ArchiveLtIndex::Key::lt ? lt(id.seqno())
+                     : key == ArchiveLtIndex::Key::unix_time ? ts(id.seqno())
+                                                             : id.seqno();
+      if (v < value || (exact && v != value)) {
+        continue;
+      }
+      if (!best || best.value().seqno() > id.seqno()) {
+        best = id;
+      }
+    }
+    if (!best) {
+      return td::Status::Error("not found");
+    }
+    return best.unwrap();
+  }
+};
+
+td::Result<ton::BlockIdExt> lookup(ArchiveLtIndex &index, const TestDb &db, ton::AccountIdPrefixFull account_id,
+                                   ArchiveLtIndex::Key key, td::uint64 value, bool exact) {
+  auto R = index.lookup(account_id, key, value, exact);
+  if (!R) {
+    auto epoch = index.epoch();
+    auto loaded = index.begin_load(account_id);
+    CHECK(index.finish_load(epoch, db.load(account_id, loaded)));
+    R = index.lookup(account_id, key, value, exact);
+    index.shrink();
+    CHECK(R);
+  }
+  return R.unwrap();
+}
+
+ton::AccountIdPrefixFull random_account() {
+  return ton::AccountIdPrefixFull{ton::basechainId, td::Random::fast_uint64()};
+}
+
+}  // namespace
+
+TEST(ArchiveLtIndex, Lookup) {
+  TestDb db;
+  ArchiveLtIndex index;
+  for (int i = 0; i < 10000; i++) {
+    auto account_id = random_account();
+    auto key = static_cast<ArchiveLtIndex::Key>(td::Random::fast(0, 2));
+    bool exact = key == ArchiveLtIndex::Key::seqno;
+    td::uint64 value = key == ArchiveLtIndex::Key::lt          ? td::Random::fast(0, 310000)
+                       : key == ArchiveLtIndex::Key::unix_time ? td::Random::fast(900, 2600)
+                                                               : td::Random::fast(0, 310);
+    auto expected = db.reference(account_id, key, value, exact);
+    auto got = lookup(index, db, account_id, key, value, exact);
+    ASSERT_EQ(expected.is_ok(), got.is_ok());
+    if (expected.is_ok()) {
+      ASSERT_EQ(expected.ok().to_str(), got.ok().to_str());
+    }
+  }
+}
+
+TEST(ArchiveLtIndex, AppendWhileLoading) {
+  TestDb db;
+  ArchiveLtIndex index;
+  ton::AccountIdPrefixFull account_id{ton::basechainId, 0xf000000000000000ULL};
+  ton::ShardIdFull right{ton::basechainId, 0xc000000000000000ULL};
+
+  // the block is added after the database snapshot was taken
+  auto epoch = index.epoch();
+  auto loaded = index.begin_load(account_id);
+  auto shards = db.load(account_id, loaded);
+  db.add(right, 301);
+  index.append(db.blocks.back(), TestDb::lt(301), TestDb::ts(301));
+  ASSERT_TRUE(index.finish_load(epoch, std::move(shards)));
+  auto R = index.lookup(account_id, ArchiveLtIndex::Key::seqno, 301, true);
+  ASSERT_TRUE(static_cast<bool>(R));
+  ASSERT_EQ(db.blocks.back().to_str(), R.value().ok().to_str());
+
+  // appended to a loaded shard
+  db.add(right, 302);
+  index.append(db.blocks.back(), TestDb::lt(302), TestDb::ts(302));
+  R = index.lookup(account_id, ArchiveLtIndex::Key::lt, TestDb::lt(302) - 1, false);
+  ASSERT_TRUE(static_cast<bool>(R));
+  ASSERT_EQ(db.blocks.back().to_str(), R.value().ok().to_str());
+}
+
+TEST(ArchiveLtIndex, ClearWhileLoading) {
+  TestDb db;
+  ArchiveLtIndex index;
+  auto account_id = random_account();
+  auto epoch = index.epoch();
+  auto loaded = index.begin_load(account_id);
+  index.clear();
+  ASSERT_TRUE(!index.finish_load(epoch, db.load(account_id, loaded)));
+  ASSERT_EQ(0u, index.loaded_elements());
+  ASSERT_TRUE(!index.lookup(account_id, ArchiveLtIndex::Key::seqno, 1, true));
+}
+
+TEST(ArchiveLtIndex, Eviction) {
+  TestDb db;
+  // enough for one search path (root, one child and one grandchild), but not for the whole workchain
+  ArchiveLtIndex index(350);
+  ton::AccountIdPrefixFull left_account{ton::basechainId, 0x1000000000000000ULL};
+  ton::AccountIdPrefixFull right_account{ton::basechainId, 0xf000000000000000ULL};
+  for (int i = 0; i < 100; i++) {
+    auto account_id = i % 2 ? left_account : right_account;
+    auto seqno = static_cast<ton::BlockSeqno>(td::Random::fast(1, 300));
+    auto got = lookup(index, db, account_id, ArchiveLtIndex::Key::seqno, seqno, true);
+    ASSERT_EQ(db.reference(account_id, ArchiveLtIndex::Key::seqno, seqno, true).ok().to_str(), got.ok().to_str());
+    ASSERT_TRUE(index.loaded_elements() <= 350);
+  }
+
+  // shards of a load in progress are not evicted
+  auto epoch = index.epoch();
+  auto loaded = index.begin_load(left_account);
+  ASSERT_TRUE(index.finish_load(epoch, db.load(left_account, loaded)));
+  epoch = index.epoch();
+  loaded = index.begin_load(right_account);
+  index.shrink();
+  ASSERT_TRUE(static_cast<bool>(index.lookup(left_account, ArchiveLtIndex::Key::seqno, 1, true)));
+  ASSERT_TRUE(index.finish_load(epoch, db.load(right_account, loaded)));
+  ASSERT_TRUE(static_cast<bool>(index.lookup(right_account, ArchiveLtIndex::Key::seqno, 1, true)));
+  index.shrink();
+  ASSERT_TRUE(index.loaded_elements() <= 350);
+}
@@ -0,0 +1,132 @@
+/*
+    This file is part of TON Blockchain Library.
+
+    TON Blockchain Library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    TON Blockchain Library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TON Blockchain Library.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "td/db/MemoryKeyValue.h"
+#include "td/utils/tests.h"
+
+#include "auto/tl/ton_api.h"
+#include "tl-utils/tl-utils.hpp"
+#include "ton/ton-tl.hpp"
+#include "validator/db/txindex.hpp"
+
+using ton::validator::TxIndexDb;
+
+namespace {
+
+ton::StdSmcAddress make_addr(td::uint8 last_byte) {
+  ton::StdSmcAddress addr;
+  addr.as_slice().fill('\x55');
+  addr.as_slice()[31] = last_byte;
+  return addr;
+}
+
+ton::BlockIdExt block_of(ton::WorkchainId workchain, ton::LogicalTime lt) {
+  return ton::BlockIdExt{workchain, ton::shardIdAll, static_cast<ton::BlockSeqno>(lt), td::Bits256::zero(),
+                         td::Bits256::zero()};
+}
+
+td::Bits256 hash_of(ton::WorkchainId workchain, td::uint8 last_byte, ton::LogicalTime lt) {
+  td::Bits256 hash = td::Bits256::zero();
+  hash.as_slice()[0] = static_cast<char>(workchain);
+  hash.as_slice()[1] = static_cast<char>(last_byte);
+  hash.as_slice().substr(8).copy_from(td::Slice(reinterpret_cast<const char *>(&lt), sizeof(lt)));
+  return hash;
+}
+
+void add(td::KeyValue &kv, ton::WorkchainId workchain, td::uint8 last_byte, ton::LogicalTime lt) {
+  auto value = ton::create_serialize_tl_object<ton::ton_api::db_txindex_value>(
+      ton::create_tl_block_id(block_of(workchain, lt)), hash_of(workchain, last_byte, lt));
+  kv.set(TxIndexDb::make_key(workchain, make_addr(last_byte), lt), value.as_slice()).ensure();
+}
+
+std::vector<ton::LogicalTime> read_lts(td::KeyValue &kv, ton::WorkchainId workchain, td::uint8 last_byte,
+                                       ton::LogicalTime lt, td::uint32 count) {
+  auto txs = TxIndexDb::read_transactions(kv, workchain, make_addr(last_byte), lt, count).move_as_ok();
+  std::vector<ton::LogicalTime> lts;
+  for (auto &tx : txs) {
+    CHECK(tx.hash == hash_of(workchain, last_byte, tx.lt));
+    CHECK(tx.block_id == block_of(workchain, tx.lt));
+    lts.push_back(tx.lt);
+  }
+  return lts;
+}
+
+using Lts = std::vector<ton::LogicalTime>;
+
+}  // namespace
+
+TEST(TxIndex, KeyOrder) {
+  auto addr = make_addr(7);
+  // negative workchains go before non-negative ones, then accounts, then lt from the newest
+  CHECK(TxIndexDb::make_key(-1, make_addr(0xff), 1) < TxIndexDb::make_key(0, make_addr(0), 1));
+  CHECK(TxIndexDb::make_key(ton::workchainInvalid, addr, 1) < TxIndexDb::make_key(-1, addr, 1));
+  CHECK(TxIndexDb::make_key(0, addr, 1) < TxIndexDb::make_key(1, addr, 1));
+  CHECK(TxIndexDb::make_key(0, addr, 1) <
+        TxIndexDb::make_key(0, make_addr(8), std::numeric_limits<td::uint64>::max()));
+  CHECK(TxIndexDb::make_key(0, addr, 20) < TxIndexDb::make_key(0, addr, 10));
+  CHECK(TxIndexDb::make_key(0, addr, 20).size() == TxIndexDb::key_size);
+}
+
+TEST(TxIndex, ReadTransactions) {
+  td::MemoryKeyValue kv;
+  for (ton::LogicalTime lt : {10, 20, 30, 40, 50}) {
+    add(kv, 0, 7, lt);
+  }
+  // neighbours of the account: adjacent addresses and the same address in other workchains
+  for (ton::LogicalTime lt : {5, 15, 25, 35, 45, 55}) {
+    add(kv, 0, 6, lt);
+    add(kv, 0, 8, lt);
+    add(kv, -1, 7, lt);
+    add(kv, 1, 7, lt);
+  }
+
+  ASSERT_TRUE(read_lts(kv, 0, 7, std::numeric_limits<td::uint64>::max(), 100) == Lts({50, 40, 30, 20, 10}));
+  // the start lt is included, the scan stops at the end of the account
+  ASSERT_TRUE(read_lts(kv, 0, 7, 30, 100) == Lts({30, 20, 10}));
+  ASSERT_TRUE(read_lts(kv, 0, 7, 35, 100) == Lts({30, 20, 10}));
+  ASSERT_TRUE(read_lts(kv, 0, 7, 9, 100) == Lts());
+  ASSERT_TRUE(read_lts(kv, 0, 7, 45, 2) == Lts({40, 30}));
+  ASSERT_TRUE(read_lts(kv, 0, 7, 50, 0) == Lts());
+  ASSERT_TRUE(read_lts(kv, 0, 7, 0, 10) == Lts());
+
+  ASSERT_TRUE(read_lts(kv, -1, 7, 100, 100) == Lts({55, 45, 35, 25, 15, 5}));
+  ASSERT_TRUE(read_lts(kv, 1, 7, 30, 2) == Lts({25, 15}));
+  ASSERT_TRUE(read_lts(kv, 0, 8, 100, 100) == Lts({55, 45, 35, 25, 15, 5}));
+  ASSERT_TRUE(read_lts(kv, -2, 7, 100, 100) == Lts());
+  ASSERT_TRUE(read_lts(kv, 0, 9, 100, 100) == Lts());
+}
+
+TEST(TxIndex, CountLimit) {
+  td::MemoryKeyValue kv;
+  auto max_count = TxIndexDb::max_transactions_per_query();
+  for (ton::LogicalTime lt = 1; lt <= max_count + 10; lt++) {
+    add(kv, 0, 7, lt);
+  }
+  auto lts = read_lts(kv, 0, 7, max_count + 10, max_count + 5);
+  ASSERT_EQ(max_count, lts.size());
+  ASSERT_EQ(max_count + 10, lts.front());
+  ASSERT_EQ(11u, lts.back());
+}
+
+TEST(TxIndex, InvalidValue) {
+  td::MemoryKeyValue kv;
+  add(kv, 0, 7, 10);
+  add(kv, 0, 7, 30);
+  kv.set(TxIndexDb::make_key(0, make_addr(7), 20), "garbage").ensure();
+  // a broken entry is an error even if the result is cut by count right after it
+  ASSERT_TRUE(TxIndexDb::read_transactions(kv, 0, make_addr(7), 30, 2).is_error());
+  ASSERT_EQ(1u, TxIndexDb::read_transactions(kv, 0, make_addr(7), 30, 1).move_as_ok().size());
+}
@@ -167,6 +167,12 @@ struct ValidatorManagerOptionsImpl : public ValidatorManagerOptions {
   bool get_permanent_celldb() const override {
     return permanent_celldb_;
   }
+  bool get_tx_index_enabled() const override {
+    return tx_index_enabled_;
+  }
+  std::string get_read_replica_path() const override {
+    return read_replica_path_;
+  }
   td::Ref<CollatorsList> get_collators_list() const override {
     return collators_list_;
   }
@@ -283,6 +289,12 @@ struct ValidatorManagerOptionsImpl : public ValidatorManagerOptions {
   void set_permanent_celldb(bool value) override {
     permanent_celldb_ = value;
   }
+  void set_tx_index_enabled(bool value) override {
+    tx_index_enabled_ = value;
+  }
+  void set_read_replica_path(std::string path) override {
+    read_replica_path_ = std::move(path);
+  }
   void set_collators_list(td::Ref<CollatorsList> list) override {
     collators_list_ = std::move(list);
   }
@@ -354,6 +366,8 @@ struct ValidatorManagerOptionsImpl : public ValidatorManagerOptions {
   bool fast_state_serializer_enabled_ = false;
   double catchain_broadcast_speed_multipliers_;
   bool permanent_celldb_ = false;
+  bool tx_index_enabled_ = false;
+  std::string read_replica_path_;
   td::Ref<CollatorsList> collators_list_{true, CollatorsList::default_list()};
   std::set<adnl::AdnlNodeIdShort> collator_node_whitelist_;
   bool collator_node_whitelist_enabled_ = false;
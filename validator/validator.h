@@ -152,6 +152,9 @@ struct ValidatorManagerOptions : public td::CntObject {
   virtual bool get_fast_state_serializer_enabled() const = 0;
   virtual double get_catchain_broadcast_speed_multiplier() const = 0;
   virtual bool get_permanent_celldb() const = 0;
+  virtual bool get_tx_index_enabled() const = 0;
+  // Non-empty in read replica mode: the databases are opened as secondary instances, this directory holds their logs
+  virtual std::string get_read_replica_path() const = 0;
   virtual td::Ref<CollatorsList> get_collators_list() const = 0;
   virtual bool check_collator_node_whitelist(adnl::AdnlNodeIdShort id) const = 0;
   virtual td::Ref<ShardBlockVerifierConfig> get_shard_block_verifier_config() const = 0;
@@ -191,6 +194,8 @@ struct ValidatorManagerOptions : public td::CntObject {
   virtual void set_fast_state_serializer_enabled(bool value) = 0;
   virtual void set_catchain_broadcast_speed_multiplier(double value) = 0;
   virtual void set_permanent_celldb(bool value) = 0;
+  virtual void set_tx_index_enabled(bool value) = 0;
+  virtual void set_read_replica_path(std::string path) = 0;
   virtual void set_collators_list(td::Ref<CollatorsList> list) = 0;
   virtual void set_collator_node_whitelisted_validator(adnl::AdnlNodeIdShort id, bool add) = 0;
   virtual void set_collator_node_whitelist_enabled(bool enabled) = 0;
@@ -342,6 +347,7 @@ class ValidatorManagerInterface : public td::actor::Actor {
   virtual void run_ext_query(td::BufferSlice data, td::Promise<td::BufferSlice> promise) = 0;
   virtual void prepare_stats(td::Promise<std::vector<std::pair<std::string, std::string>>> promise) = 0;
   virtual void prepare_actor_stats(td::Promise<std::string> promise) = 0;
+  virtual void prepare_actor_stats_prometheus(td::Promise<std::string> promise) = 0;
 
   virtual void prepare_perf_timer_stats(td::Promise<std::vector<PerfTimerStats>> promise) = 0;
   virtual void add_perf_timer_stat(std::string name, double duration) = 0;